@@ -146,6 +146,9 @@ const std::unordered_map<std::wstring, int> ACCELERATOR_MAPPINGS = {
 	{L"sort_by_media_publisher", IDM_SORTBY_MEDIA_PUBLISHER},
 	{L"sort_by_media_writer", IDM_SORTBY_MEDIA_WRITER},
 	{L"sort_by_media_year", IDM_SORTBY_MEDIA_YEAR},
+	{L"sort_by_crc32c", IDM_SORTBY_CRC32C},
+	{L"sort_by_xxhash64", IDM_SORTBY_XXHASH64},
+	{L"sort_by_sha256", IDM_SORTBY_SHA256},
 
 	{L"group_by_name", IDM_GROUPBY_NAME},
 	{L"group_by_size", IDM_GROUPBY_SIZE},
@@ -209,6 +212,9 @@ const std::unordered_map<std::wstring, int> ACCELERATOR_MAPPINGS = {
 	{L"group_by_media_publisher", IDM_GROUPBY_MEDIA_PUBLISHER},
 	{L"group_by_media_writer", IDM_GROUPBY_MEDIA_WRITER},
 	{L"group_by_media_year", IDM_GROUPBY_MEDIA_YEAR},
+	{L"group_by_crc32c", IDM_GROUPBY_CRC32C},
+	{L"group_by_xxhash64", IDM_GROUPBY_XXHASH64},
+	{L"group_by_sha256", IDM_GROUPBY_SHA256},
 
 	{L"select_columns", IDM_VIEW_SELECTCOLUMNS},
 	{L"autosize_columns", IDM_VIEW_AUTOSIZECOLUMNS},
@@ -242,6 +248,8 @@ const std::unordered_map<std::wstring, int> ACCELERATOR_MAPPINGS = {
 	{L"manage_bookmarks", IDM_BOOKMARKS_MANAGEBOOKMARKS},
 
 	{L"search", IDM_TOOLS_SEARCH},
+	{L"find_duplicate_files", IDM_TOOLS_FINDDUPLICATEFILES},
+	{L"compare_folders", IDM_TOOLS_COMPAREFOLDERS},
 	{L"customize_colors", IDM_TOOLS_CUSTOMIZECOLORS},
 	{L"run_script", IDM_TOOLS_RUNSCRIPT},
 	{L"options", IDM_TOOLS_OPTIONS},
@@ -16,14 +16,16 @@ UINT BookmarkClipboard::GetClipboardFormat()
 BookmarkItems BookmarkClipboard::ReadBookmarks()
 {
 	Clipboard clipboard;
-	auto data = clipboard.ReadCustomData(GetClipboardFormat());
+
+	// The items are read directly from the clipboard's copy of the data.
+	HGLOBAL data = clipboard.GetCustomDataHandle(GetClipboardFormat());
 
 	if (!data)
 	{
 		return {};
 	}
 
-	return BookmarkDataExchange::DeserializeBookmarkItems(*data);
+	return BookmarkDataExchange::DeserializeBookmarkItemsFromGlobal(data);
 }
 
 bool BookmarkClipboard::WriteBookmarks(const OwnedRefBookmarkItems &bookmarkItems)
@@ -46,6 +48,6 @@ bool BookmarkClipboard::WriteBookmarks(const OwnedRefBookmarkItems &bookmarkItem
 	std::wstring text = boost::algorithm::join(lines, L"\n");
 	clipboardWriter.WriteText(text);
 
-	std::string data = BookmarkDataExchange::SerializeBookmarkItems(bookmarkItems);
-	return clipboardWriter.WriteCustomData(GetClipboardFormat(), data);
+	auto global = BookmarkDataExchange::SerializeBookmarkItemsToGlobal(bookmarkItems);
+	return clipboardWriter.WriteCustomData(GetClipboardFormat(), std::move(global));
 }
@@ -8,8 +8,278 @@
 #include "../Helper/DataExchangeHelper.h"
 #include "../Helper/DataObjectImpl.h"
 #include "../Helper/DragDropHelper.h"
-#include <cereal/archives/binary.hpp>
-#include <cereal/types/memory.hpp>
+#include <array>
+
+namespace
+{
+
+constexpr std::array<char, 4> PAYLOAD_SIGNATURE = { 'E', 'B', 'M', 'P' };
+
+// This should be incremented whenever the layout of the payload changes.
+constexpr uint32_t PAYLOAD_VERSION = 1;
+
+struct PayloadHeader
+{
+	std::array<char, 4> signature;
+	uint32_t version;
+
+	// The total number of items (including descendants) and the number of items that were
+	// passed in directly. The top-level items are always stored first.
+	uint32_t numItems;
+	uint32_t numTopLevelItems;
+
+	// The offset (in bytes) of the string table and its length (in characters). The item records
+	// start immediately after this header.
+	uint32_t stringsOffset;
+	uint32_t stringsLength;
+};
+
+static_assert(sizeof(PayloadHeader) == 24);
+
+// Identifies a string within the string table. Both values are in characters.
+struct StringReference
+{
+	uint32_t offset;
+	uint32_t length;
+};
+
+// Items are stored in breadth-first order, so the children of each folder are contiguous.
+struct PayloadItem
+{
+	uint32_t type;
+	uint32_t firstChild;
+	uint32_t numChildren;
+	StringReference guid;
+	StringReference name;
+	StringReference location;
+};
+
+static_assert(sizeof(PayloadItem) == 36);
+
+// Determines the position of every item in the payload, which allows the total size to be
+// calculated before anything is written. The data can then be written directly to its final
+// destination.
+class PayloadLayout
+{
+public:
+	explicit PayloadLayout(const OwnedRefBookmarkItems &bookmarkItems)
+	{
+		for (const auto &bookmarkItem : bookmarkItems)
+		{
+			m_items.push_back(bookmarkItem.get().get());
+		}
+
+		m_numTopLevelItems = m_items.size();
+
+		// Note that the list grows as items are processed, with the children of each folder
+		// being appended as a contiguous block.
+		for (size_t i = 0; i < m_items.size(); i++)
+		{
+			const BookmarkItem *bookmarkItem = m_items[i];
+
+			m_stringsLength += bookmarkItem->GetGUID().size() + bookmarkItem->GetName().size()
+				+ bookmarkItem->GetLocation().size();
+
+			for (const auto &child : bookmarkItem->GetChildren())
+			{
+				m_items.push_back(child.get());
+			}
+		}
+	}
+
+	size_t GetStringsOffset() const
+	{
+		return sizeof(PayloadHeader) + m_items.size() * sizeof(PayloadItem);
+	}
+
+	size_t GetSize() const
+	{
+		return GetStringsOffset() + m_stringsLength * sizeof(wchar_t);
+	}
+
+	bool IsTooLarge() const
+	{
+		return GetSize() > UINT32_MAX;
+	}
+
+	// The output buffer needs to be at least GetSize() bytes in size.
+	void Write(BYTE *output) const
+	{
+		PayloadHeader header;
+		header.signature = PAYLOAD_SIGNATURE;
+		header.version = PAYLOAD_VERSION;
+		header.numItems = static_cast<uint32_t>(m_items.size());
+		header.numTopLevelItems = static_cast<uint32_t>(m_numTopLevelItems);
+		header.stringsOffset = static_cast<uint32_t>(GetStringsOffset());
+		header.stringsLength = static_cast<uint32_t>(m_stringsLength);
+		memcpy(output, &header, sizeof(header));
+
+		BYTE *currentItem = output + sizeof(header);
+		BYTE *strings = output + header.stringsOffset;
+		uint32_t stringsPosition = 0;
+		auto nextChild = static_cast<uint32_t>(m_numTopLevelItems);
+
+		auto writeString = [strings, &stringsPosition](const std::wstring &str)
+		{
+			StringReference reference = { stringsPosition, static_cast<uint32_t>(str.size()) };
+			memcpy(strings + stringsPosition * sizeof(wchar_t), str.data(),
+				str.size() * sizeof(wchar_t));
+			stringsPosition += reference.length;
+			return reference;
+		};
+
+		for (const BookmarkItem *bookmarkItem : m_items)
+		{
+			PayloadItem item;
+			item.type = static_cast<uint32_t>(bookmarkItem->GetType());
+			item.firstChild = nextChild;
+			item.numChildren = static_cast<uint32_t>(bookmarkItem->GetChildren().size());
+			item.guid = writeString(bookmarkItem->GetGUID());
+			item.name = writeString(bookmarkItem->GetName());
+			item.location = writeString(bookmarkItem->GetLocation());
+			memcpy(currentItem, &item, sizeof(item));
+
+			nextChild += item.numChildren;
+			currentItem += sizeof(item);
+		}
+	}
+
+private:
+	std::vector<const BookmarkItem *> m_items;
+	size_t m_numTopLevelItems = 0;
+	size_t m_stringsLength = 0;
+};
+
+}
+
+// Reads bookmark items directly from a payload, without copying it. Each item is constructed from
+// its record, with the strings read in place from the string table.
+class BookmarkPayloadReader
+{
+public:
+	BookmarkPayloadReader(const BYTE *data, size_t size) : m_data(data), m_size(size), m_header()
+	{
+	}
+
+	BookmarkItems Read()
+	{
+		if (!Validate())
+		{
+			return {};
+		}
+
+		// Every item appears after its parent, so building the items in reverse order means
+		// that each folder's children will already exist by the time the folder is reached.
+		std::vector<std::unique_ptr<BookmarkItem>> items(m_header.numItems);
+
+		for (uint32_t i = m_header.numItems; i-- > 0;)
+		{
+			PayloadItem item = GetItem(i);
+
+			if (item.type == static_cast<uint32_t>(BookmarkItem::Type::Folder))
+			{
+				BookmarkItems children;
+				children.reserve(item.numChildren);
+
+				for (uint32_t j = 0; j < item.numChildren; j++)
+				{
+					children.push_back(std::move(items[item.firstChild + j]));
+				}
+
+				items[i] = std::unique_ptr<BookmarkItem>(new BookmarkItem(GetString(item.guid),
+					GetString(item.name), std::move(children)));
+			}
+			else
+			{
+				items[i] = std::unique_ptr<BookmarkItem>(new BookmarkItem(GetString(item.guid),
+					GetString(item.name), std::wstring(GetString(item.location)), true));
+			}
+		}
+
+		items.resize(m_header.numTopLevelItems);
+		return items;
+	}
+
+private:
+	bool Validate()
+	{
+		// The strings are read in place, so they need to be suitably aligned.
+		if (m_size < sizeof(PayloadHeader)
+			|| (reinterpret_cast<uintptr_t>(m_data) % alignof(wchar_t)) != 0)
+		{
+			return false;
+		}
+
+		memcpy(&m_header, m_data, sizeof(m_header));
+
+		uint64_t itemsEnd = sizeof(PayloadHeader)
+			+ static_cast<uint64_t>(m_header.numItems) * sizeof(PayloadItem);
+
+		if (m_header.signature != PAYLOAD_SIGNATURE || m_header.version != PAYLOAD_VERSION
+			|| m_header.numTopLevelItems > m_header.numItems || itemsEnd > m_size
+			|| (m_header.stringsOffset % sizeof(wchar_t)) != 0
+			|| static_cast<uint64_t>(m_header.stringsOffset)
+					+ static_cast<uint64_t>(m_header.stringsLength) * sizeof(wchar_t)
+				> m_size)
+		{
+			return false;
+		}
+
+		// Each folder's children should start immediately after those of the previous folder and
+		// after the folder itself. Together, that ensures every item other than the top-level
+		// items has exactly one parent, which precedes it.
+		uint64_t nextChild = m_header.numTopLevelItems;
+
+		for (uint32_t i = 0; i < m_header.numItems; i++)
+		{
+			PayloadItem item = GetItem(i);
+
+			bool isFolder = (item.type == static_cast<uint32_t>(BookmarkItem::Type::Folder));
+			bool isBookmark = (item.type == static_cast<uint32_t>(BookmarkItem::Type::Bookmark));
+
+			if ((!isFolder && !isBookmark) || (isBookmark && item.numChildren != 0)
+				|| item.firstChild != nextChild || (item.numChildren > 0 && item.firstChild <= i)
+				|| !IsValidString(item.guid)
+				|| !IsValidString(item.name) || !IsValidString(item.location))
+			{
+				return false;
+			}
+
+			nextChild += item.numChildren;
+
+			if (nextChild > m_header.numItems)
+			{
+				return false;
+			}
+		}
+
+		return nextChild == m_header.numItems;
+	}
+
+	PayloadItem GetItem(uint32_t index) const
+	{
+		PayloadItem item;
+		memcpy(&item, m_data + sizeof(PayloadHeader) + static_cast<size_t>(index) * sizeof(item),
+			sizeof(item));
+		return item;
+	}
+
+	std::wstring_view GetString(const StringReference &reference) const
+	{
+		auto *strings = reinterpret_cast<const wchar_t *>(m_data + m_header.stringsOffset);
+		return std::wstring_view(strings + reference.offset, reference.length);
+	}
+
+	bool IsValidString(const StringReference &reference) const
+	{
+		return static_cast<uint64_t>(reference.offset) + reference.length
+			<= m_header.stringsLength;
+	}
+
+	const BYTE *const m_data;
+	const size_t m_size;
+	PayloadHeader m_header;
+};
 
 FORMATETC BookmarkDataExchange::GetFormatEtc()
 {
@@ -23,8 +293,7 @@ winrt::com_ptr<IDataObject> BookmarkDataExchange::CreateDataObject(
 {
 	FORMATETC formatEtc = GetFormatEtc();
 
-	std::string data = SerializeBookmarkItems(bookmarkItems);
-	auto global = WriteBinaryDataToGlobal(data);
+	auto global = SerializeBookmarkItemsToGlobal(bookmarkItems);
 	STGMEDIUM stgMedium = GetStgMediumForGlobal(global.get());
 
 	auto dataObject = winrt::make_self<DataObjectImpl>(&formatEtc, &stgMedium, 1);
@@ -40,46 +309,64 @@ winrt::com_ptr<IDataObject> BookmarkDataExchange::CreateDataObject(
 
 std::string BookmarkDataExchange::SerializeBookmarkItems(const OwnedRefBookmarkItems &bookmarkItems)
 {
-	std::vector<std::string> serializedBookmarkItems;
+	PayloadLayout layout(bookmarkItems);
 
-	for (auto &bookmarkItem : bookmarkItems)
+	if (layout.IsTooLarge())
 	{
-		std::stringstream stringstream;
-		cereal::BinaryOutputArchive outputArchive(stringstream);
+		return {};
+	}
 
-		outputArchive(bookmarkItem.get());
+	std::string data(layout.GetSize(), '\0');
+	layout.Write(reinterpret_cast<BYTE *>(data.data()));
+	return data;
+}
+
+wil::unique_hglobal BookmarkDataExchange::SerializeBookmarkItemsToGlobal(
+	const OwnedRefBookmarkItems &bookmarkItems)
+{
+	PayloadLayout layout(bookmarkItems);
 
-		serializedBookmarkItems.push_back(stringstream.str());
+	if (layout.IsTooLarge())
+	{
+		return nullptr;
 	}
 
-	std::stringstream mainStringstream;
-	cereal::BinaryOutputArchive mainOutputArchive(mainStringstream);
+	wil::unique_hglobal global(GlobalAlloc(GMEM_MOVEABLE, layout.GetSize()));
 
-	mainOutputArchive(serializedBookmarkItems);
+	if (!global)
+	{
+		return nullptr;
+	}
 
-	return mainStringstream.str();
-}
+	{
+		wil::unique_hglobal_locked mem(global.get());
 
-BookmarkItems BookmarkDataExchange::DeserializeBookmarkItems(const std::string &data)
-{
-	std::stringstream mainStringstream(data);
-	cereal::BinaryInputArchive mainInputArchive(mainStringstream);
+		if (!mem)
+		{
+			return nullptr;
+		}
 
-	std::vector<std::string> serializedBookmarkItems;
-	mainInputArchive(serializedBookmarkItems);
+		layout.Write(static_cast<BYTE *>(mem.get()));
+	}
 
-	BookmarkItems bookmarkItems;
+	return global;
+}
 
-	for (auto &serializedBookmarkItem : serializedBookmarkItems)
-	{
-		std::stringstream stringstream(serializedBookmarkItem);
-		cereal::BinaryInputArchive inputArchive(stringstream);
+BookmarkItems BookmarkDataExchange::DeserializeBookmarkItems(std::string_view data)
+{
+	BookmarkPayloadReader reader(reinterpret_cast<const BYTE *>(data.data()), data.size());
+	return reader.Read();
+}
 
-		std::unique_ptr<BookmarkItem> bookmarkItem;
-		inputArchive(bookmarkItem);
+BookmarkItems BookmarkDataExchange::DeserializeBookmarkItemsFromGlobal(HGLOBAL global)
+{
+	wil::unique_hglobal_locked mem(global);
 
-		bookmarkItems.push_back(std::move(bookmarkItem));
+	if (!mem)
+	{
+		return {};
 	}
 
-	return bookmarkItems;
+	BookmarkPayloadReader reader(static_cast<const BYTE *>(mem.get()), GlobalSize(global));
+	return reader.Read();
 }
@@ -6,14 +6,17 @@
 
 #include "Bookmarks/BookmarkItem.h"
 #include "../Helper/WinRTBaseWrapper.h"
+#include <wil/resource.h>
 #include <functional>
+#include <string>
+#include <string_view>
 
 // This type is used when serializing multiple independent bookmark items and is
 // needed for the following reasons:
 //
-// - cereal doesn't serialize raw pointers at all (it explicitly forbids them).
-//   This means it's not possible to pass a list of BookmarkItem pointers to
-//   serialize.
+// - Items were originally serialized using cereal, which doesn't serialize raw
+//   pointers at all (it explicitly forbids them). This meant it wasn't possible
+//   to pass a list of BookmarkItem pointers to serialize.
 // - It's not possible to pass a list of unique_ptr<BookmarkItem>, because
 //   unique_ptr's express unique ownership and the BookmarkItem's will likely be
 //   owned by their parents.
@@ -40,7 +43,17 @@ namespace BookmarkDataExchange
 
 FORMATETC GetFormatEtc();
 winrt::com_ptr<IDataObject> CreateDataObject(const OwnedRefBookmarkItems &bookmarkItems);
+
+// The items (along with all of their descendants) are written out in a single pass, as a flat
+// array of fixed-size records followed by a table of the strings they reference. That allows the
+// data to be read back in place (e.g. directly from the clipboard's memory), without having to be
+// copied or parsed first. SerializeBookmarkItemsToGlobal() writes the data directly into a newly
+// allocated global memory block.
 std::string SerializeBookmarkItems(const OwnedRefBookmarkItems &bookmarkItems);
-BookmarkItems DeserializeBookmarkItems(const std::string &data);
+wil::unique_hglobal SerializeBookmarkItemsToGlobal(const OwnedRefBookmarkItems &bookmarkItems);
+
+// Returns an empty list if the data isn't valid.
+BookmarkItems DeserializeBookmarkItems(std::string_view data);
+BookmarkItems DeserializeBookmarkItemsFromGlobal(HGLOBAL global);
 
 }
@@ -188,14 +188,7 @@ BookmarkItems BookmarkDropper::ExtractBookmarkItemsFromCustomFormat()
 		return {};
 	}
 
-	auto data = ReadBinaryDataFromGlobal(stgMedium.hGlobal);
-
-	if (!data)
-	{
-		return {};
-	}
-
-	return BookmarkDataExchange::DeserializeBookmarkItems(*data);
+	return BookmarkDataExchange::DeserializeBookmarkItemsFromGlobal(stgMedium.hGlobal);
 }
 
 BookmarkItems BookmarkDropper::MaybeExtractBookmarkItemsFromShellItems()
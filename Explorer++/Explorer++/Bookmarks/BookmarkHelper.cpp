@@ -27,8 +27,6 @@ int CALLBACK SortByDateModified(const BookmarkItem *firstItem, const BookmarkIte
 void OpenBookmarkWithDisposition(const BookmarkItem *bookmarkItem,
 	OpenFolderDisposition disposition, const std::wstring &currentDirectory, Navigator *navigator);
 
-BookmarkItem *GetBookmarkItemByIdResursive(BookmarkItem *bookmarkItem, std::wstring_view guid);
-
 bool BookmarkHelper::IsFolder(const std::unique_ptr<BookmarkItem> &bookmarkItem)
 {
 	return bookmarkItem->IsFolder();
@@ -342,32 +340,7 @@ void BookmarkHelper::PasteBookmarkItems(BookmarkTree *bookmarkTree, BookmarkItem
 BookmarkItem *BookmarkHelper::GetBookmarkItemById(BookmarkTree *bookmarkTree,
 	std::wstring_view guid)
 {
-	return GetBookmarkItemByIdResursive(bookmarkTree->GetRoot(), guid);
-}
-
-BookmarkItem *GetBookmarkItemByIdResursive(BookmarkItem *bookmarkItem, std::wstring_view guid)
-{
-	if (bookmarkItem->GetGUID() == guid)
-	{
-		return bookmarkItem;
-	}
-
-	if (!bookmarkItem->IsFolder())
-	{
-		return nullptr;
-	}
-
-	for (auto &child : bookmarkItem->GetChildren())
-	{
-		BookmarkItem *result = GetBookmarkItemByIdResursive(child.get(), guid);
-
-		if (result)
-		{
-			return result;
-		}
-	}
-
-	return nullptr;
+	return bookmarkTree->GetBookmarkItemById(std::wstring(guid));
 }
 
 bool BookmarkHelper::IsAncestor(const BookmarkItem *bookmarkItem,
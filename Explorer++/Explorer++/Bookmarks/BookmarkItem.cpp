@@ -37,6 +37,8 @@ BookmarkItem::BookmarkItem(std::wstring_view originalGuid, std::wstring_view nam
 	{
 		child->m_parent = this;
 	}
+
+	UpdateChildIndexes(0);
 }
 
 FILETIME BookmarkItem::GetCurrentDate()
@@ -87,6 +89,11 @@ void BookmarkItem::ClearOriginalGUID()
 	m_originalGuid.reset();
 }
 
+void BookmarkItem::RegenerateGUID()
+{
+	m_guid = CreateGUID();
+}
+
 std::wstring BookmarkItem::GetName() const
 {
 	return m_name;
@@ -156,6 +163,7 @@ BookmarkItem *BookmarkItem::AddChild(std::unique_ptr<BookmarkItem> bookmarkItem,
 	BookmarkItem *rawBookmarkItem = bookmarkItem.get();
 	m_children.insert(m_children.begin() + index, std::move(bookmarkItem));
 
+	UpdateChildIndexes(index);
 	UpdateModificationTime();
 
 	return rawBookmarkItem;
@@ -176,6 +184,7 @@ std::unique_ptr<BookmarkItem> BookmarkItem::RemoveChild(size_t index)
 
 	m_children.erase(m_children.begin() + index);
 
+	UpdateChildIndexes(index);
 	UpdateModificationTime();
 
 	return erasedItem;
@@ -185,37 +194,20 @@ size_t BookmarkItem::GetChildIndex(const BookmarkItem *bookmarkItem) const
 {
 	assert(m_type == Type::Folder);
 
-	auto itr = std::find_if(m_children.begin(), m_children.end(),
-		[bookmarkItem](const auto &item)
-		{
-			return item.get() == bookmarkItem;
-		});
-
-	if (itr == m_children.end())
+	if (bookmarkItem->m_parent != this)
 	{
 		throw std::invalid_argument("BookmarkItem not found");
 	}
 
-	return itr - m_children.begin();
+	assert(m_children[bookmarkItem->m_indexInParent].get() == bookmarkItem);
+
+	return bookmarkItem->m_indexInParent;
 }
 
 const std::unique_ptr<BookmarkItem> &BookmarkItem::GetChildOwnedPtr(
 	const BookmarkItem *bookmarkItem) const
 {
-	assert(m_type == Type::Folder);
-
-	auto itr = std::find_if(m_children.begin(), m_children.end(),
-		[bookmarkItem](const auto &item)
-		{
-			return item.get() == bookmarkItem;
-		});
-
-	if (itr == m_children.end())
-	{
-		throw std::invalid_argument("BookmarkItem not found");
-	}
-
-	return *itr;
+	return m_children[GetChildIndex(bookmarkItem)];
 }
 
 bool BookmarkItem::HasChildFolder() const
@@ -243,6 +235,17 @@ void BookmarkItem::UpdateModificationTime()
 	GetSystemTimeAsFileTime(&m_dateModified);
 }
 
+// Only the children at or after the specified index will have changed position, so there's no
+// need to update the indexes of the items before that point. In particular, appending an item is
+// a constant-time operation.
+void BookmarkItem::UpdateChildIndexes(size_t startIndex)
+{
+	for (size_t i = startIndex; i < m_children.size(); i++)
+	{
+		m_children[i]->m_indexInParent = i;
+	}
+}
+
 void BookmarkItem::VisitRecursively(std::function<void(BookmarkItem *currentItem)> callback)
 {
 	callback(this);
@@ -7,8 +7,6 @@
 #include "SignalWrapper.h"
 #include "../Helper/Helper.h"
 #include "../Helper/Macros.h"
-#include <cereal/types/string.hpp>
-#include <cereal/types/vector.hpp>
 #include <optional>
 #include <vector>
 
@@ -35,34 +33,11 @@ public:
 		DateModified
 	};
 
-	friend class cereal::access;
+	// Needs access to the deserialization constructors below.
+	friend class BookmarkPayloadReader;
 
-	template <class Archive>
-	void serialize(Archive &archive)
-	{
-		archive(m_guid, m_type, m_name, m_location, m_children);
-	}
-
-	template <class Archive>
-	static void load_and_construct(Archive &archive, cereal::construct<BookmarkItem> &construct)
-	{
-		std::wstring originalGuid;
-		Type type;
-		std::wstring name;
-		std::wstring location;
-		BookmarkItems children;
-
-		archive(originalGuid, type, name, location, children);
-
-		if (type == Type::Bookmark)
-		{
-			construct(originalGuid, name, location, true);
-		}
-		else
-		{
-			construct(originalGuid, name, std::move(children));
-		}
-	}
+	// Needs to be able to replace a GUID that's already in use by another item in the tree.
+	friend class BookmarkTree;
 
 	BookmarkItem(std::optional<std::wstring> guid, std::wstring_view name,
 		std::optional<std::wstring> location);
@@ -123,7 +98,10 @@ private:
 
 	static FILETIME GetCurrentDate();
 
+	void RegenerateGUID();
+
 	void UpdateModificationTime();
+	void UpdateChildIndexes(size_t startIndex);
 
 	const Type m_type;
 	std::wstring m_guid = CreateGUID();
@@ -135,6 +113,11 @@ private:
 
 	BookmarkItem *m_parent = nullptr;
 
+	// The position of this item within its parent. This is kept up to date by the parent, so that
+	// the index of a child can be retrieved without having to search through the parent's list of
+	// children.
+	size_t m_indexInParent = 0;
+
 	std::wstring m_name;
 
 	std::wstring m_location;
@@ -0,0 +1,1097 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Bookmarks/BookmarkJournal.h"
+#include "Bookmarks/BookmarkTree.h"
+#include "../Helper/AtomicFileWriter.h"
+#include "../Helper/Helper.h"
+#include <unordered_set>
+
+namespace
+{
+
+// Incremented whenever the format of the records changes. A journal with a different version is
+// discarded.
+const uint32_t JOURNAL_VERSION = 1;
+
+enum class RecordType : uint32_t
+{
+	JournalHeader = 0,
+	ItemAdded = 1,
+	ItemUpdated = 2,
+	ItemMoved = 3,
+	ItemRemoved = 4
+};
+
+// Each record in the journal consists of this header, followed by the payload. The payload starts
+// with the record type and the remaining fields depend on that type.
+struct RecordHeader
+{
+	uint32_t payloadSize;
+
+	// Covers both the sequence number and the payload.
+	uint32_t checksum;
+
+	uint64_t sequenceNumber;
+};
+
+static_assert(sizeof(RecordHeader) == 16);
+
+// The checksum is only used to detect records that were partially written (e.g. because the
+// process was terminated while a record was being appended), so a simple FNV-1a hash is
+// sufficient.
+uint32_t CalculateChecksum(uint64_t sequenceNumber, const BYTE *payload, size_t payloadSize)
+{
+	uint32_t hash = 2166136261u;
+
+	auto update = [&hash](const BYTE *data, size_t size)
+	{
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= data[i];
+			hash *= 16777619u;
+		}
+	};
+
+	update(reinterpret_cast<const BYTE *>(&sequenceNumber), sizeof(sequenceNumber));
+	update(payload, payloadSize);
+
+	return hash;
+}
+
+std::vector<BYTE> BuildRecord(uint64_t sequenceNumber, const std::vector<BYTE> &payload)
+{
+	RecordHeader header;
+	header.payloadSize = static_cast<uint32_t>(payload.size());
+	header.sequenceNumber = sequenceNumber;
+	header.checksum = CalculateChecksum(header.sequenceNumber, payload.data(), payload.size());
+
+	std::vector<BYTE> record(sizeof(header) + payload.size());
+	memcpy(record.data(), &header, sizeof(header));
+	memcpy(record.data() + sizeof(header), payload.data(), payload.size());
+
+	return record;
+}
+
+struct JournalHeader
+{
+	std::wstring journalId;
+	std::wstring baseJournalId;
+};
+
+class RecordWriter
+{
+public:
+	explicit RecordWriter(RecordType type)
+	{
+		WriteUint32(static_cast<uint32_t>(type));
+	}
+
+	void WriteUint32(uint32_t value)
+	{
+		WriteBytes(&value, sizeof(value));
+	}
+
+	void WriteUint64(uint64_t value)
+	{
+		WriteBytes(&value, sizeof(value));
+	}
+
+	void WriteFileTime(const FILETIME &fileTime)
+	{
+		ULARGE_INTEGER value;
+		value.LowPart = fileTime.dwLowDateTime;
+		value.HighPart = fileTime.dwHighDateTime;
+		WriteUint64(value.QuadPart);
+	}
+
+	void WriteString(const std::wstring &str)
+	{
+		WriteUint32(static_cast<uint32_t>(str.size()));
+		WriteBytes(str.data(), str.size() * sizeof(wchar_t));
+	}
+
+	const std::vector<BYTE> &GetData() const
+	{
+		return m_data;
+	}
+
+private:
+	void WriteBytes(const void *data, size_t size)
+	{
+		auto *bytes = static_cast<const BYTE *>(data);
+		m_data.insert(m_data.end(), bytes, bytes + size);
+	}
+
+	std::vector<BYTE> m_data;
+};
+
+// Reads the fields of a record payload. Each method returns false if there isn't enough data
+// remaining, which will be the case if the record is malformed.
+class RecordReader
+{
+public:
+	RecordReader(const BYTE *data, size_t size) : m_data(data), m_size(size)
+	{
+	}
+
+	bool ReadUint32(uint32_t &value)
+	{
+		return ReadBytes(&value, sizeof(value));
+	}
+
+	bool ReadUint64(uint64_t &value)
+	{
+		return ReadBytes(&value, sizeof(value));
+	}
+
+	bool ReadFileTime(FILETIME &fileTime)
+	{
+		ULARGE_INTEGER value;
+
+		if (!ReadUint64(value.QuadPart))
+		{
+			return false;
+		}
+
+		fileTime.dwLowDateTime = value.LowPart;
+		fileTime.dwHighDateTime = value.HighPart;
+		return true;
+	}
+
+	bool ReadString(std::wstring &str)
+	{
+		uint32_t length;
+
+		if (!ReadUint32(length) || length > (m_size - m_offset) / sizeof(wchar_t))
+		{
+			return false;
+		}
+
+		str.resize(length);
+		return ReadBytes(str.data(), length * sizeof(wchar_t));
+	}
+
+	bool IsAtEnd() const
+	{
+		return m_offset == m_size;
+	}
+
+private:
+	bool ReadBytes(void *output, size_t size)
+	{
+		if (size > m_size - m_offset)
+		{
+			return false;
+		}
+
+		memcpy(output, m_data + m_offset, size);
+		m_offset += size;
+		return true;
+	}
+
+	const BYTE *const m_data;
+	const size_t m_size;
+	size_t m_offset = 0;
+};
+
+// Writes out an item and all of its descendants, in pre-order. Each item is followed directly by
+// its children, so storing the number of children is enough to reconstruct the hierarchy.
+void WriteSubtree(RecordWriter &writer, const BookmarkItem *bookmarkItem)
+{
+	std::vector<const BookmarkItem *> stack = { bookmarkItem };
+
+	while (!stack.empty())
+	{
+		const BookmarkItem *currentItem = stack.back();
+		stack.pop_back();
+
+		writer.WriteUint32(static_cast<uint32_t>(currentItem->GetType()));
+		writer.WriteString(currentItem->GetGUID());
+		writer.WriteString(currentItem->GetName());
+		writer.WriteString(currentItem->GetLocation());
+		writer.WriteFileTime(currentItem->GetDateCreated());
+		writer.WriteFileTime(currentItem->GetDateModified());
+
+		const auto &children = currentItem->GetChildren();
+		writer.WriteUint32(static_cast<uint32_t>(children.size()));
+
+		for (auto itr = children.rbegin(); itr != children.rend(); ++itr)
+		{
+			stack.push_back(itr->get());
+		}
+	}
+}
+
+std::unique_ptr<BookmarkItem> ReadSubtree(RecordReader &reader)
+{
+	struct PendingFolder
+	{
+		BookmarkItem *folder;
+		uint32_t numRemainingChildren;
+	};
+
+	struct ItemDates
+	{
+		BookmarkItem *bookmarkItem;
+		FILETIME dateCreated;
+		FILETIME dateModified;
+	};
+
+	std::unique_ptr<BookmarkItem> rootItem;
+	std::vector<PendingFolder> pendingFolders;
+	std::vector<ItemDates> itemDates;
+
+	do
+	{
+		uint32_t type;
+		std::wstring guid;
+		std::wstring name;
+		std::wstring location;
+		FILETIME dateCreated;
+		FILETIME dateModified;
+		uint32_t numChildren;
+
+		if (!reader.ReadUint32(type) || !reader.ReadString(guid) || !reader.ReadString(name)
+			|| !reader.ReadString(location) || !reader.ReadFileTime(dateCreated)
+			|| !reader.ReadFileTime(dateModified) || !reader.ReadUint32(numChildren))
+		{
+			return nullptr;
+		}
+
+		std::unique_ptr<BookmarkItem> bookmarkItem;
+
+		if (type == static_cast<uint32_t>(BookmarkItem::Type::Folder))
+		{
+			bookmarkItem = std::make_unique<BookmarkItem>(guid, name, std::nullopt);
+		}
+		else if (type == static_cast<uint32_t>(BookmarkItem::Type::Bookmark) && numChildren == 0)
+		{
+			bookmarkItem = std::make_unique<BookmarkItem>(guid, name, location);
+		}
+		else
+		{
+			return nullptr;
+		}
+
+		BookmarkItem *rawBookmarkItem;
+
+		if (!rootItem)
+		{
+			rootItem = std::move(bookmarkItem);
+			rawBookmarkItem = rootItem.get();
+		}
+		else
+		{
+			auto &parent = pendingFolders.back();
+			rawBookmarkItem = parent.folder->AddChild(std::move(bookmarkItem));
+			parent.numRemainingChildren--;
+		}
+
+		itemDates.push_back({ rawBookmarkItem, dateCreated, dateModified });
+
+		if (numChildren > 0)
+		{
+			pendingFolders.push_back({ rawBookmarkItem, numChildren });
+		}
+
+		while (!pendingFolders.empty() && pendingFolders.back().numRemainingChildren == 0)
+		{
+			pendingFolders.pop_back();
+		}
+	} while (!pendingFolders.empty());
+
+	// Adding a child to a folder updates the folder's modification date, so the dates can only
+	// be set once all the items have been added.
+	for (const auto &dates : itemDates)
+	{
+		dates.bookmarkItem->SetDateCreated(dates.dateCreated);
+		dates.bookmarkItem->SetDateModified(dates.dateModified);
+	}
+
+	return rootItem;
+}
+
+bool AreGuidsUnique(const BookmarkTree *bookmarkTree, BookmarkItem *bookmarkItem)
+{
+	std::unordered_set<std::wstring> guids;
+	bool unique = true;
+
+	bookmarkItem->VisitRecursively(
+		[bookmarkTree, &guids, &unique](BookmarkItem *currentItem)
+		{
+			auto guid = currentItem->GetGUID();
+
+			if (bookmarkTree->GetBookmarkItemById(guid) || !guids.insert(guid).second)
+			{
+				unique = false;
+			}
+		});
+
+	return unique;
+}
+
+bool IsSelfOrDescendant(const BookmarkItem *bookmarkItem, const BookmarkItem *potentialAncestor)
+{
+	for (auto *currentItem = bookmarkItem; currentItem; currentItem = currentItem->GetParent())
+	{
+		if (currentItem == potentialAncestor)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool CanAddChildrenTo(const BookmarkTree *bookmarkTree, const BookmarkItem *bookmarkItem)
+{
+	return bookmarkItem && bookmarkItem->IsFolder() && bookmarkTree->CanAddChildren(bookmarkItem);
+}
+
+// Each of the functions below fully validates a record before making any changes to the tree, so
+// a record that can't be applied leaves the tree as it was.
+bool ApplyItemAdded(BookmarkTree *bookmarkTree, RecordReader &reader)
+{
+	std::wstring parentGuid;
+	uint32_t index;
+	FILETIME parentDateModified;
+
+	if (!reader.ReadString(parentGuid) || !reader.ReadUint32(index)
+		|| !reader.ReadFileTime(parentDateModified))
+	{
+		return false;
+	}
+
+	auto bookmarkItem = ReadSubtree(reader);
+
+	if (!bookmarkItem || !reader.IsAtEnd())
+	{
+		return false;
+	}
+
+	BookmarkItem *parent = bookmarkTree->GetBookmarkItemById(parentGuid);
+
+	if (!CanAddChildrenTo(bookmarkTree, parent) || index > parent->GetChildren().size()
+		|| !AreGuidsUnique(bookmarkTree, bookmarkItem.get()))
+	{
+		return false;
+	}
+
+	bookmarkTree->AddBookmarkItem(parent, std::move(bookmarkItem), index);
+	parent->SetDateModified(parentDateModified);
+
+	return true;
+}
+
+bool ApplyItemUpdated(BookmarkTree *bookmarkTree, RecordReader &reader)
+{
+	std::wstring guid;
+	uint32_t rawPropertyType;
+
+	if (!reader.ReadString(guid) || !reader.ReadUint32(rawPropertyType))
+	{
+		return false;
+	}
+
+	auto propertyType = static_cast<BookmarkItem::PropertyType>(rawPropertyType);
+	std::wstring value;
+	FILETIME date;
+
+	switch (propertyType)
+	{
+	case BookmarkItem::PropertyType::Name:
+	case BookmarkItem::PropertyType::Location:
+		// The new value is followed by the resulting modification date.
+		if (!reader.ReadString(value) || !reader.ReadFileTime(date))
+		{
+			return false;
+		}
+		break;
+
+	case BookmarkItem::PropertyType::DateCreated:
+	case BookmarkItem::PropertyType::DateModified:
+		if (!reader.ReadFileTime(date))
+		{
+			return false;
+		}
+		break;
+
+	default:
+		return false;
+	}
+
+	BookmarkItem *bookmarkItem = bookmarkTree->GetBookmarkItemById(guid);
+
+	if (!reader.IsAtEnd() || !bookmarkItem
+		|| (propertyType == BookmarkItem::PropertyType::Location && !bookmarkItem->IsBookmark()))
+	{
+		return false;
+	}
+
+	switch (propertyType)
+	{
+	case BookmarkItem::PropertyType::Name:
+		bookmarkItem->SetName(value);
+		bookmarkItem->SetDateModified(date);
+		break;
+
+	case BookmarkItem::PropertyType::Location:
+		bookmarkItem->SetLocation(value);
+		bookmarkItem->SetDateModified(date);
+		break;
+
+	case BookmarkItem::PropertyType::DateCreated:
+		bookmarkItem->SetDateCreated(date);
+		break;
+
+	case BookmarkItem::PropertyType::DateModified:
+		bookmarkItem->SetDateModified(date);
+		break;
+	}
+
+	return true;
+}
+
+bool ApplyItemMoved(BookmarkTree *bookmarkTree, RecordReader &reader)
+{
+	std::wstring guid;
+	std::wstring oldParentGuid;
+	FILETIME oldParentDateModified;
+	std::wstring newParentGuid;
+	uint32_t newIndex;
+	FILETIME newParentDateModified;
+
+	if (!reader.ReadString(guid) || !reader.ReadString(oldParentGuid)
+		|| !reader.ReadFileTime(oldParentDateModified) || !reader.ReadString(newParentGuid)
+		|| !reader.ReadUint32(newIndex) || !reader.ReadFileTime(newParentDateModified)
+		|| !reader.IsAtEnd())
+	{
+		return false;
+	}
+
+	BookmarkItem *bookmarkItem = bookmarkTree->GetBookmarkItemById(guid);
+	BookmarkItem *newParent = bookmarkTree->GetBookmarkItemById(newParentGuid);
+
+	if (!bookmarkItem || bookmarkTree->IsPermanentNode(bookmarkItem)
+		|| bookmarkItem->GetParent()->GetGUID() != oldParentGuid
+		|| !CanAddChildrenTo(bookmarkTree, newParent)
+		|| IsSelfOrDescendant(newParent, bookmarkItem))
+	{
+		return false;
+	}
+
+	BookmarkItem *oldParent = bookmarkItem->GetParent();
+
+	// The index stored is the final position of the item. When moving an item to a later position
+	// within the same folder, MoveBookmarkItem() expects the index as it was before the item was
+	// removed, so that needs to be adjusted for.
+	size_t index = newIndex;
+
+	if (oldParent == newParent)
+	{
+		size_t oldIndex = oldParent->GetChildIndex(bookmarkItem);
+
+		if (index >= oldParent->GetChildren().size() || index == oldIndex)
+		{
+			return false;
+		}
+
+		if (index > oldIndex)
+		{
+			index++;
+		}
+	}
+	else if (index > newParent->GetChildren().size())
+	{
+		return false;
+	}
+
+	bookmarkTree->MoveBookmarkItem(bookmarkItem, newParent, index);
+	oldParent->SetDateModified(oldParentDateModified);
+	newParent->SetDateModified(newParentDateModified);
+
+	return true;
+}
+
+bool ApplyItemRemoved(BookmarkTree *bookmarkTree, RecordReader &reader)
+{
+	std::wstring guid;
+	std::wstring parentGuid;
+	FILETIME parentDateModified;
+
+	if (!reader.ReadString(guid) || !reader.ReadString(parentGuid)
+		|| !reader.ReadFileTime(parentDateModified) || !reader.IsAtEnd())
+	{
+		return false;
+	}
+
+	BookmarkItem *bookmarkItem = bookmarkTree->GetBookmarkItemById(guid);
+
+	if (!bookmarkItem || bookmarkTree->IsPermanentNode(bookmarkItem)
+		|| bookmarkItem->GetParent()->GetGUID() != parentGuid)
+	{
+		return false;
+	}
+
+	BookmarkItem *parent = bookmarkItem->GetParent();
+	bookmarkTree->RemoveBookmarkItem(bookmarkItem);
+	parent->SetDateModified(parentDateModified);
+
+	return true;
+}
+
+bool ApplyRecord(BookmarkTree *bookmarkTree, const BYTE *payload, size_t payloadSize)
+{
+	RecordReader reader(payload, payloadSize);
+	uint32_t type;
+
+	if (!reader.ReadUint32(type))
+	{
+		return false;
+	}
+
+	switch (static_cast<RecordType>(type))
+	{
+	case RecordType::ItemAdded:
+		return ApplyItemAdded(bookmarkTree, reader);
+
+	case RecordType::ItemUpdated:
+		return ApplyItemUpdated(bookmarkTree, reader);
+
+	case RecordType::ItemMoved:
+		return ApplyItemMoved(bookmarkTree, reader);
+
+	case RecordType::ItemRemoved:
+		return ApplyItemRemoved(bookmarkTree, reader);
+	}
+
+	return false;
+}
+
+// Returns the contents of the journal file. If the file doesn't exist, the returned data will be
+// empty. Returns std::nullopt if the file exists, but couldn't be opened (e.g. because another
+// instance of the application is using it).
+std::optional<std::vector<BYTE>> ReadJournalFile(const std::wstring &path)
+{
+	wil::unique_hfile file(CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+
+	if (!file)
+	{
+		DWORD error = GetLastError();
+
+		if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND)
+		{
+			return std::vector<BYTE>();
+		}
+
+		return std::nullopt;
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(file.get(), &fileSize))
+	{
+		return std::nullopt;
+	}
+
+	std::vector<BYTE> data(static_cast<size_t>(fileSize.QuadPart));
+	size_t offset = 0;
+
+	while (offset < data.size())
+	{
+		DWORD numBytesToRead = static_cast<DWORD>(std::min<size_t>(data.size() - offset, MAXDWORD));
+		DWORD numBytesRead;
+
+		if (!ReadFile(file.get(), data.data() + offset, numBytesToRead, &numBytesRead, nullptr)
+			|| numBytesRead == 0)
+		{
+			break;
+		}
+
+		offset += numBytesRead;
+	}
+
+	// If the file couldn't be read in full, whatever was read can still be replayed.
+	data.resize(offset);
+
+	return data;
+}
+
+// Returns the header of the record that starts at the specified offset, provided the record is
+// complete and its checksum is valid.
+std::optional<RecordHeader> ReadRecordHeader(const std::vector<BYTE> &data, size_t offset)
+{
+	if (offset > data.size() || data.size() - offset < sizeof(RecordHeader))
+	{
+		return std::nullopt;
+	}
+
+	RecordHeader header;
+	memcpy(&header, data.data() + offset, sizeof(header));
+
+	const BYTE *payload = data.data() + offset + sizeof(header);
+
+	if (header.payloadSize > data.size() - offset - sizeof(header)
+		|| header.checksum != CalculateChecksum(header.sequenceNumber, payload, header.payloadSize))
+	{
+		return std::nullopt;
+	}
+
+	return header;
+}
+
+std::vector<BYTE> BuildJournalHeader(const JournalHeader &journalHeader)
+{
+	RecordWriter writer(RecordType::JournalHeader);
+	writer.WriteUint32(JOURNAL_VERSION);
+	writer.WriteString(journalHeader.journalId);
+	writer.WriteString(journalHeader.baseJournalId);
+	return writer.GetData();
+}
+
+// The journal header is stored as the first record in the file, with a sequence number of 0.
+// Returns the header, along with the offset of the first record that follows it.
+std::optional<std::pair<JournalHeader, size_t>> ReadJournalHeader(const std::vector<BYTE> &data)
+{
+	auto recordHeader = ReadRecordHeader(data, 0);
+
+	if (!recordHeader || recordHeader->sequenceNumber != 0)
+	{
+		return std::nullopt;
+	}
+
+	RecordReader reader(data.data() + sizeof(RecordHeader), recordHeader->payloadSize);
+	uint32_t type;
+	uint32_t version;
+	JournalHeader journalHeader;
+
+	if (!reader.ReadUint32(type) || type != static_cast<uint32_t>(RecordType::JournalHeader)
+		|| !reader.ReadUint32(version) || version != JOURNAL_VERSION
+		|| !reader.ReadString(journalHeader.journalId)
+		|| !reader.ReadString(journalHeader.baseJournalId) || !reader.IsAtEnd()
+		|| journalHeader.journalId.empty())
+	{
+		return std::nullopt;
+	}
+
+	return std::make_pair(journalHeader, sizeof(RecordHeader) + recordHeader->payloadSize);
+}
+
+// A journal can be replayed on top of the settings that were saved from it, or on top of the
+// settings it was started from. In the second case, the base ID will be empty if there was no
+// position saved in those settings.
+bool IsJournalForSnapshot(const JournalHeader &journalHeader,
+	const std::optional<BookmarkJournalPosition> &snapshotPosition)
+{
+	std::wstring snapshotJournalId = snapshotPosition ? snapshotPosition->journalId : L"";
+	return snapshotJournalId == journalHeader.journalId
+		|| snapshotJournalId == journalHeader.baseJournalId;
+}
+
+}
+
+BookmarkJournal::BookmarkJournal(BookmarkTree *bookmarkTree, const std::wstring &path,
+	CompactionCallback compactionCallback, uint64_t compactionThreshold) :
+	m_bookmarkTree(bookmarkTree),
+	m_path(path),
+	m_compactionCallback(compactionCallback),
+	m_compactionThreshold(compactionThreshold)
+{
+}
+
+bool BookmarkJournal::Load(const std::optional<BookmarkJournalPosition> &snapshotPosition)
+{
+	auto data = ReadJournalFile(m_path);
+
+	// If the journal exists, but can't be read, it's left as-is, so that the changes it contains
+	// aren't lost.
+	if (!data)
+	{
+		return false;
+	}
+
+	uint64_t snapshotSequenceNumber = snapshotPosition ? snapshotPosition->sequenceNumber : 0;
+	auto journalHeader = ReadJournalHeader(*data);
+	bool replayed = false;
+
+	if (journalHeader && IsJournalForSnapshot(journalHeader->first, snapshotPosition))
+	{
+		m_journalId = journalHeader->first.journalId;
+		m_baseJournalId = journalHeader->first.baseJournalId;
+
+		replayed = ReplayJournal(*data, journalHeader->second, snapshotSequenceNumber);
+	}
+
+	bool opened;
+
+	if (replayed)
+	{
+		std::scoped_lock lock(m_journalMutex);
+		opened = OpenJournal();
+	}
+	else
+	{
+		// Either there's no journal yet, or the existing journal doesn't apply to the settings
+		// that were loaded. In both cases, a new journal is started.
+		opened = ResetJournal(snapshotPosition);
+	}
+
+	if (!opened)
+	{
+		m_journalId.clear();
+		return false;
+	}
+
+	m_connections.push_back(m_bookmarkTree->bookmarkItemAddedSignal.AddObserver(
+		std::bind_front(&BookmarkJournal::OnBookmarkItemAdded, this)));
+	m_connections.push_back(m_bookmarkTree->bookmarkItemUpdatedSignal.AddObserver(
+		std::bind_front(&BookmarkJournal::OnBookmarkItemUpdated, this)));
+	m_connections.push_back(m_bookmarkTree->bookmarkItemMovedSignal.AddObserver(
+		std::bind_front(&BookmarkJournal::OnBookmarkItemMoved, this)));
+	m_connections.push_back(m_bookmarkTree->bookmarkItemPreRemovalSignal.AddObserver(
+		std::bind_front(&BookmarkJournal::OnBookmarkItemPreRemoval, this)));
+	m_connections.push_back(m_bookmarkTree->bookmarkItemRemovedSignal.AddObserver(
+		std::bind_front(&BookmarkJournal::OnBookmarkItemRemoved, this)));
+
+	return true;
+}
+
+// Returns false if the records in the journal don't carry on from the snapshot, in which case
+// none of them are applied.
+bool BookmarkJournal::ReplayJournal(const std::vector<BYTE> &data, size_t offset,
+	uint64_t snapshotSequenceNumber)
+{
+	uint64_t previousSequenceNumber = 0;
+	uint64_t oldestSequenceNumber = 0;
+
+	while (auto header = ReadRecordHeader(data, offset))
+	{
+		if (header->sequenceNumber <= previousSequenceNumber)
+		{
+			break;
+		}
+
+		// Records up to and including the one with the snapshot's sequence number are already
+		// reflected in the snapshot. They may still be present if the process was interrupted
+		// after the settings were saved, but before the journal was trimmed.
+		if (header->sequenceNumber > snapshotSequenceNumber)
+		{
+			// Records have to follow on directly from the snapshot. If the first record after the
+			// snapshot doesn't, the snapshot is older than the journal (e.g. because the config
+			// file was restored from a backup). If a later record doesn't, a record that came
+			// before it couldn't be written, so it may not apply.
+			if (header->sequenceNumber
+				!= std::max(previousSequenceNumber, snapshotSequenceNumber) + 1)
+			{
+				if (previousSequenceNumber <= snapshotSequenceNumber)
+				{
+					return false;
+				}
+
+				break;
+			}
+
+			if (!ApplyRecord(m_bookmarkTree, data.data() + offset + sizeof(RecordHeader),
+					header->payloadSize))
+			{
+				break;
+			}
+		}
+
+		if (oldestSequenceNumber == 0)
+		{
+			oldestSequenceNumber = header->sequenceNumber;
+		}
+
+		previousSequenceNumber = header->sequenceNumber;
+		offset += sizeof(RecordHeader) + header->payloadSize;
+	}
+
+	m_nextSequenceNumber = std::max(previousSequenceNumber, snapshotSequenceNumber) + 1;
+
+	// Anything after the last valid record is discarded when the journal is opened.
+	std::scoped_lock lock(m_journalMutex);
+	m_journalSize = offset;
+	m_oldestSequenceNumber = oldestSequenceNumber;
+
+	return true;
+}
+
+bool BookmarkJournal::ResetJournal(const std::optional<BookmarkJournalPosition> &snapshotPosition)
+{
+	m_journalId = CreateGUID();
+	m_baseJournalId = snapshotPosition ? snapshotPosition->journalId : L"";
+	m_nextSequenceNumber = (snapshotPosition ? snapshotPosition->sequenceNumber : 0) + 1;
+
+	std::scoped_lock lock(m_journalMutex);
+	m_journalSize = 0;
+	m_oldestSequenceNumber = 0;
+
+	return OpenJournal()
+		&& WriteRecord(0, BuildJournalHeader({ m_journalId, m_baseJournalId }));
+}
+
+// Must be called with the journal mutex held.
+bool BookmarkJournal::OpenJournal()
+{
+	// Any existing handle needs to be closed first, since the file isn't opened for shared
+	// writing.
+	m_journalFile.reset();
+	m_journalFile.reset(CreateFile(m_path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+		OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr));
+
+	if (!m_journalFile)
+	{
+		return false;
+	}
+
+	// Positions the file at the end of the last valid record and removes anything after that.
+	LARGE_INTEGER journalSize;
+	journalSize.QuadPart = m_journalSize;
+
+	if (!SetFilePointerEx(m_journalFile.get(), journalSize, nullptr, FILE_BEGIN)
+		|| !SetEndOfFile(m_journalFile.get()))
+	{
+		m_journalFile.reset();
+		return false;
+	}
+
+	return true;
+}
+
+// Must be called with the journal mutex held.
+bool BookmarkJournal::WriteRecord(uint64_t sequenceNumber, const std::vector<BYTE> &payload)
+{
+	if (!m_journalFile)
+	{
+		return false;
+	}
+
+	// The header and payload are written together, so that each change results in a single
+	// write.
+	auto record = BuildRecord(sequenceNumber, payload);
+
+	DWORD numBytesWritten;
+	BOOL res = WriteFile(m_journalFile.get(), record.data(), static_cast<DWORD>(record.size()),
+		&numBytesWritten, nullptr);
+
+	if (!res || numBytesWritten != record.size())
+	{
+		// Any partially written data needs to be removed, since nothing after it would be
+		// replayed. If that's not possible, the journal is closed until it's next trimmed.
+		OpenJournal();
+		return false;
+	}
+
+	m_journalSize += record.size();
+
+	if (m_oldestSequenceNumber == 0 && sequenceNumber != 0)
+	{
+		m_oldestSequenceNumber = sequenceNumber;
+	}
+
+	return true;
+}
+
+void BookmarkJournal::AppendRecord(const std::vector<BYTE> &payload)
+{
+	bool written;
+	bool thresholdReached;
+
+	{
+		std::scoped_lock lock(m_journalMutex);
+		written = WriteRecord(m_nextSequenceNumber, payload);
+		thresholdReached = (m_journalSize >= m_compactionThreshold);
+	}
+
+	// The sequence number is used even if the record couldn't be written. The records after it
+	// then won't be replayed, since they may depend on the change that's missing.
+	m_nextSequenceNumber++;
+
+	// If the change couldn't be recorded, the only way to persist it is to save the settings.
+	if (!written || (thresholdReached && !m_compactionRequested.exchange(true)))
+	{
+		m_compactionCallback();
+	}
+}
+
+std::optional<BookmarkJournalPosition> BookmarkJournal::GetCurrentPosition() const
+{
+	if (m_journalId.empty())
+	{
+		return std::nullopt;
+	}
+
+	return BookmarkJournalPosition{ m_journalId, m_nextSequenceNumber - 1 };
+}
+
+void BookmarkJournal::OnSnapshotSaved(const BookmarkJournalPosition &position)
+{
+	std::scoped_lock lock(m_journalMutex);
+
+	if (m_journalId.empty() || position.journalId != m_journalId)
+	{
+		return;
+	}
+
+	m_compactionRequested = false;
+
+	// Once the settings have been saved from this journal, it no longer needs to apply to the
+	// settings it was started from, so the header is updated as well.
+	bool recordsCovered =
+		m_oldestSequenceNumber != 0 && m_oldestSequenceNumber <= position.sequenceNumber;
+
+	if (!recordsCovered && m_baseJournalId == m_journalId)
+	{
+		return;
+	}
+
+	// The journal file can't be replaced while it's open.
+	m_journalFile.reset();
+
+	auto data = ReadJournalFile(m_path);
+	std::optional<std::pair<JournalHeader, size_t>> journalHeader;
+
+	if (data && data->size() >= m_journalSize)
+	{
+		journalHeader = ReadJournalHeader(*data);
+	}
+
+	if (journalHeader)
+	{
+		// Finds the first record that isn't reflected in the settings. Records appended while
+		// the settings were being written are retained.
+		size_t offset = journalHeader->second;
+		uint64_t oldestSequenceNumber = 0;
+
+		while (offset < m_journalSize)
+		{
+			auto header = ReadRecordHeader(*data, offset);
+
+			if (!header)
+			{
+				break;
+			}
+
+			if (header->sequenceNumber > position.sequenceNumber)
+			{
+				oldestSequenceNumber = header->sequenceNumber;
+				break;
+			}
+
+			offset += sizeof(RecordHeader) + header->payloadSize;
+		}
+
+		auto newData = BuildRecord(0, BuildJournalHeader({ m_journalId, m_journalId }));
+		newData.insert(newData.end(), data->begin() + offset,
+			data->begin() + static_cast<size_t>(m_journalSize));
+
+		AtomicFileWriter atomicWriter(m_path);
+		DWORD numBytesWritten;
+
+		// If the journal couldn't be replaced, it will still contain the records covered by
+		// the settings. That's fine, since they'll be skipped when the journal is replayed.
+		if (atomicWriter.GetHandle() != INVALID_HANDLE_VALUE
+			&& WriteFile(atomicWriter.GetHandle(), newData.data(),
+				static_cast<DWORD>(newData.size()), &numBytesWritten, nullptr)
+			&& numBytesWritten == newData.size() && atomicWriter.Commit())
+		{
+			m_journalSize = newData.size();
+			m_oldestSequenceNumber = oldestSequenceNumber;
+			m_baseJournalId = m_journalId;
+		}
+	}
+
+	OpenJournal();
+}
+
+uint64_t BookmarkJournal::GetJournalSize() const
+{
+	std::scoped_lock lock(m_journalMutex);
+	return m_journalSize;
+}
+
+void BookmarkJournal::OnBookmarkItemAdded(BookmarkItem &bookmarkItem, size_t index)
+{
+	const BookmarkItem *parent = bookmarkItem.GetParent();
+
+	RecordWriter writer(RecordType::ItemAdded);
+	writer.WriteString(parent->GetGUID());
+	writer.WriteUint32(static_cast<uint32_t>(index));
+	writer.WriteFileTime(parent->GetDateModified());
+	WriteSubtree(writer, &bookmarkItem);
+	AppendRecord(writer.GetData());
+}
+
+void BookmarkJournal::OnBookmarkItemUpdated(BookmarkItem &bookmarkItem,
+	BookmarkItem::PropertyType propertyType)
+{
+	RecordWriter writer(RecordType::ItemUpdated);
+	writer.WriteString(bookmarkItem.GetGUID());
+	writer.WriteUint32(static_cast<uint32_t>(propertyType));
+
+	// Changing the name or location also updates the modification date, without a separate
+	// notification being sent, so the resulting date is included as well.
+	switch (propertyType)
+	{
+	case BookmarkItem::PropertyType::Name:
+		writer.WriteString(bookmarkItem.GetName());
+		writer.WriteFileTime(bookmarkItem.GetDateModified());
+		break;
+
+	case BookmarkItem::PropertyType::Location:
+		writer.WriteString(bookmarkItem.GetLocation());
+		writer.WriteFileTime(bookmarkItem.GetDateModified());
+		break;
+
+	case BookmarkItem::PropertyType::DateCreated:
+		writer.WriteFileTime(bookmarkItem.GetDateCreated());
+		break;
+
+	case BookmarkItem::PropertyType::DateModified:
+		writer.WriteFileTime(bookmarkItem.GetDateModified());
+		break;
+	}
+
+	AppendRecord(writer.GetData());
+}
+
+void BookmarkJournal::OnBookmarkItemMoved(BookmarkItem *bookmarkItem,
+	const BookmarkItem *oldParent, size_t oldIndex, const BookmarkItem *newParent,
+	size_t newIndex)
+{
+	UNREFERENCED_PARAMETER(oldIndex);
+
+	RecordWriter writer(RecordType::ItemMoved);
+	writer.WriteString(bookmarkItem->GetGUID());
+	writer.WriteString(oldParent->GetGUID());
+	writer.WriteFileTime(oldParent->GetDateModified());
+	writer.WriteString(newParent->GetGUID());
+	writer.WriteUint32(static_cast<uint32_t>(newIndex));
+	writer.WriteFileTime(newParent->GetDateModified());
+	AppendRecord(writer.GetData());
+}
+
+void BookmarkJournal::OnBookmarkItemPreRemoval(BookmarkItem &bookmarkItem)
+{
+	// The parent's modification date is only updated once the item has actually been removed, so
+	// the record is written in OnBookmarkItemRemoved().
+	m_removedItemParent = bookmarkItem.GetParent();
+}
+
+void BookmarkJournal::OnBookmarkItemRemoved(const std::wstring &guid)
+{
+	assert(m_removedItemParent);
+
+	RecordWriter writer(RecordType::ItemRemoved);
+	writer.WriteString(guid);
+	writer.WriteString(m_removedItemParent->GetGUID());
+	writer.WriteFileTime(m_removedItemParent->GetDateModified());
+	AppendRecord(writer.GetData());
+
+	m_removedItemParent = nullptr;
+}
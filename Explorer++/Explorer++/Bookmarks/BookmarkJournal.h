@@ -0,0 +1,121 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "Bookmarks/BookmarkItem.h"
+#include <boost/signals2.hpp>
+#include <wil/resource.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+class BookmarkTree;
+
+// Identifies the last journal record that's reflected in a snapshot of the bookmarks. The snapshot
+// is the full set of bookmarks saved along with the rest of the settings (to either the config
+// file or the registry), so this is saved with it.
+struct BookmarkJournalPosition
+{
+	std::wstring journalId;
+	uint64_t sequenceNumber;
+};
+
+// Records each change made to a bookmark tree as a small, self-contained record appended to a
+// journal file. That means editing a single bookmark results in a single small write, regardless
+// of the number of bookmarks, and an edit isn't lost if the process exits before the settings are
+// next saved.
+//
+// Each record carries a sequence number. When the bookmarks are saved as part of the settings, the
+// current position in the journal is saved with them. Once that save has been written, the records
+// it covers are dropped from the journal. When loading, only the records after the saved position
+// are replayed. Because of that, the bookmarks are consistent no matter where the process is
+// interrupted. A record that was only partially written is detected (via its checksum) and
+// discarded, along with anything after it.
+//
+// The journal starts with a header that contains an ID, which is saved with the settings as part of
+// the position. A journal is only replayed on top of settings that were saved from it (or on top of
+// the settings it was started from), so the journal is ignored if the config file is replaced with
+// one from elsewhere.
+class BookmarkJournal
+{
+public:
+	static constexpr uint64_t DEFAULT_COMPACTION_THRESHOLD = 256 * 1024;
+
+	// Invoked on the UI thread once the journal has grown beyond the compaction threshold. The
+	// callback should arrange for the settings to be saved, at which point the journal will be
+	// trimmed.
+	using CompactionCallback = std::function<void()>;
+
+	BookmarkJournal(BookmarkTree *bookmarkTree, const std::wstring &path,
+		CompactionCallback compactionCallback,
+		uint64_t compactionThreshold = DEFAULT_COMPACTION_THRESHOLD);
+
+	BookmarkJournal(const BookmarkJournal &) = delete;
+	BookmarkJournal &operator=(const BookmarkJournal &) = delete;
+
+	// Replays any changes recorded after the bookmarks were last saved and then starts recording
+	// changes made to the tree. This should be called once, right after the bookmarks have been
+	// loaded. snapshotPosition is the position that was loaded along with the bookmarks (if any).
+	// Returns false if the journal couldn't be opened. In that case, changes won't be recorded.
+	bool Load(const std::optional<BookmarkJournalPosition> &snapshotPosition);
+
+	// Returns the position to save along with the bookmarks. This should be retrieved at the same
+	// time as the bookmarks are being saved. Returns std::nullopt if the journal isn't in use.
+	std::optional<BookmarkJournalPosition> GetCurrentPosition() const;
+
+	// Should be called once the settings containing the specified position have been written. The
+	// records covered by the position are then dropped from the journal. This can be called from
+	// any thread.
+	void OnSnapshotSaved(const BookmarkJournalPosition &position);
+
+	uint64_t GetJournalSize() const;
+
+private:
+	bool ReplayJournal(const std::vector<BYTE> &data, size_t offset,
+		uint64_t snapshotSequenceNumber);
+	bool ResetJournal(const std::optional<BookmarkJournalPosition> &snapshotPosition);
+	bool OpenJournal();
+	bool WriteRecord(uint64_t sequenceNumber, const std::vector<BYTE> &payload);
+	void AppendRecord(const std::vector<BYTE> &payload);
+
+	void OnBookmarkItemAdded(BookmarkItem &bookmarkItem, size_t index);
+	void OnBookmarkItemUpdated(BookmarkItem &bookmarkItem, BookmarkItem::PropertyType propertyType);
+	void OnBookmarkItemMoved(BookmarkItem *bookmarkItem, const BookmarkItem *oldParent,
+		size_t oldIndex, const BookmarkItem *newParent, size_t newIndex);
+	void OnBookmarkItemPreRemoval(BookmarkItem &bookmarkItem);
+	void OnBookmarkItemRemoved(const std::wstring &guid);
+
+	BookmarkTree *const m_bookmarkTree;
+	const std::wstring m_path;
+	const CompactionCallback m_compactionCallback;
+	const uint64_t m_compactionThreshold;
+
+	// Guards the journal file, which is appended to on the UI thread and rewritten on whichever
+	// thread the settings are saved on.
+	mutable std::mutex m_journalMutex;
+	wil::unique_hfile m_journalFile;
+	uint64_t m_journalSize = 0;
+
+	// The sequence number of the first record in the journal, or 0 if the journal is empty.
+	uint64_t m_oldestSequenceNumber = 0;
+
+	// The ID of this journal and the ID of the journal the settings were loaded from, when this
+	// journal was started. The second is empty if the settings didn't contain a position. Both are
+	// set when the journal is loaded. The base ID is then only updated (with the mutex held) once
+	// the settings have been saved from this journal.
+	std::wstring m_journalId;
+	std::wstring m_baseJournalId;
+
+	// Set once a compaction has been requested and cleared once the settings have been saved.
+	std::atomic<bool> m_compactionRequested = false;
+
+	// Only accessed on the UI thread.
+	uint64_t m_nextSequenceNumber = 1;
+	const BookmarkItem *m_removedItemParent = nullptr;
+	std::vector<boost::signals2::scoped_connection> m_connections;
+};
@@ -15,6 +15,7 @@ namespace V2
 const TCHAR bookmarksKeyPath[] = _T("Bookmarksv2");
 
 void Load(HKEY parentKey, BookmarkTree *bookmarkTree);
+std::optional<BookmarkJournalPosition> LoadJournalPosition(HKEY parentKey);
 void LoadPermanentFolder(HKEY parentKey, BookmarkTree *bookmarkTree, BookmarkItem *bookmarkItem,
 	const std::wstring &name);
 void LoadBookmarkChildren(HKEY parentKey, BookmarkTree *bookmarkTree,
@@ -22,6 +23,7 @@ void LoadBookmarkChildren(HKEY parentKey, BookmarkTree *bookmarkTree,
 std::unique_ptr<BookmarkItem> LoadBookmarkItem(HKEY key, BookmarkTree *bookmarkTree);
 
 void Save(HKEY parentKey, BookmarkTree *bookmarkTree);
+void SaveJournalPosition(HKEY parentKey, const BookmarkJournalPosition &journalPosition);
 void SavePermanentFolder(HKEY parentKey, const BookmarkItem *bookmarkItem,
 	const std::wstring &name);
 void SaveBookmarkChildren(HKEY parentKey, const BookmarkItem *parentBookmarkItem);
@@ -45,8 +47,8 @@ std::unique_ptr<BookmarkItem> LoadBookmarkItem(HKEY key, BookmarkTree *bookmarkT
 std::wstring BuildFullKeyPath(const std::wstring &applicationKeyPath,
 	const std::wstring &relativeKeyPath);
 
-void BookmarkRegistryStorage::Load(const std::wstring &applicationKeyPath,
-	BookmarkTree *bookmarkTree)
+std::optional<BookmarkJournalPosition> BookmarkRegistryStorage::Load(
+	const std::wstring &applicationKeyPath, BookmarkTree *bookmarkTree)
 {
 	// The V2 key always takes precedence (i.e. it will be used even if the V1
 	// key exists).
@@ -57,7 +59,7 @@ void BookmarkRegistryStorage::Load(const std::wstring &applicationKeyPath,
 	if (res == ERROR_SUCCESS)
 	{
 		V2::Load(bookmarksKey.get(), bookmarkTree);
-		return;
+		return V2::LoadJournalPosition(bookmarksKey.get());
 	}
 
 	std::wstring v1KeyPath = BuildFullKeyPath(applicationKeyPath, V1::bookmarksKeyPath);
@@ -66,8 +68,9 @@ void BookmarkRegistryStorage::Load(const std::wstring &applicationKeyPath,
 	if (res == ERROR_SUCCESS)
 	{
 		V1::Load(bookmarksKey.get(), bookmarkTree);
-		return;
 	}
+
+	return std::nullopt;
 }
 
 void V2::Load(HKEY parentKey, BookmarkTree *bookmarkTree)
@@ -80,6 +83,21 @@ void V2::Load(HKEY parentKey, BookmarkTree *bookmarkTree)
 		BookmarkStorage::OTHER_BOOKMARKS_NODE_NAME);
 }
 
+std::optional<BookmarkJournalPosition> V2::LoadJournalPosition(HKEY parentKey)
+{
+	std::wstring journalId;
+	std::wstring sequenceNumber;
+
+	if (RegistrySettings::ReadString(parentKey, _T("JournalId"), journalId) != ERROR_SUCCESS
+		|| RegistrySettings::ReadString(parentKey, _T("JournalSequenceNumber"), sequenceNumber)
+			!= ERROR_SUCCESS)
+	{
+		return std::nullopt;
+	}
+
+	return BookmarkJournalPosition{ journalId, _wcstoui64(sequenceNumber.c_str(), nullptr, 10) };
+}
+
 void V2::LoadPermanentFolder(HKEY parentKey, BookmarkTree *bookmarkTree, BookmarkItem *bookmarkItem,
 	const std::wstring &name)
 {
@@ -258,7 +276,7 @@ std::unique_ptr<BookmarkItem> V1::LoadBookmarkItem(HKEY key, BookmarkTree *bookm
 }
 
 void BookmarkRegistryStorage::Save(const std::wstring &applicationKeyPath,
-	BookmarkTree *bookmarkTree)
+	BookmarkTree *bookmarkTree, const std::optional<BookmarkJournalPosition> &journalPosition)
 {
 	std::wstring v2KeyPath = BuildFullKeyPath(applicationKeyPath, V2::bookmarksKeyPath);
 	SHDeleteKey(HKEY_CURRENT_USER, v2KeyPath.c_str());
@@ -270,6 +288,13 @@ void BookmarkRegistryStorage::Save(const std::wstring &applicationKeyPath,
 	if (res == ERROR_SUCCESS)
 	{
 		V2::Save(bookmarksKey.get(), bookmarkTree);
+
+		// The position is written last, so that it's only present if all the bookmarks were
+		// saved.
+		if (journalPosition)
+		{
+			V2::SaveJournalPosition(bookmarksKey.get(), *journalPosition);
+		}
 	}
 }
 
@@ -283,6 +308,13 @@ void V2::Save(HKEY parentKey, BookmarkTree *bookmarkTree)
 		BookmarkStorage::OTHER_BOOKMARKS_NODE_NAME);
 }
 
+void V2::SaveJournalPosition(HKEY parentKey, const BookmarkJournalPosition &journalPosition)
+{
+	RegistrySettings::SaveString(parentKey, _T("JournalId"), journalPosition.journalId);
+	RegistrySettings::SaveString(parentKey, _T("JournalSequenceNumber"),
+		std::to_wstring(journalPosition.sequenceNumber));
+}
+
 void V2::SavePermanentFolder(HKEY parentKey, const BookmarkItem *bookmarkItem,
 	const std::wstring &name)
 {
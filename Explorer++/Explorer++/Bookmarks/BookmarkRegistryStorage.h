@@ -4,12 +4,17 @@
 
 #pragma once
 
+#include "Bookmarks/BookmarkJournal.h"
+#include <optional>
 #include <string>
 
 class BookmarkTree;
 
 namespace BookmarkRegistryStorage
 {
-void Load(const std::wstring &applicationKeyPath, BookmarkTree *bookmarkTree);
-void Save(const std::wstring &applicationKeyPath, BookmarkTree *bookmarkTree);
+// Returns the journal position that was saved along with the bookmarks, if there is one.
+std::optional<BookmarkJournalPosition> Load(const std::wstring &applicationKeyPath,
+	BookmarkTree *bookmarkTree);
+void Save(const std::wstring &applicationKeyPath, BookmarkTree *bookmarkTree,
+	const std::optional<BookmarkJournalPosition> &journalPosition = std::nullopt);
 }
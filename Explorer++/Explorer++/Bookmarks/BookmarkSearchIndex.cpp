@@ -0,0 +1,285 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Bookmarks/BookmarkSearchIndex.h"
+#include "Bookmarks/BookmarkTree.h"
+#include <algorithm>
+
+BookmarkSearchIndex::BookmarkSearchIndex(BookmarkTree *bookmarkTree) : m_bookmarkTree(bookmarkTree)
+{
+	for (auto &child : m_bookmarkTree->GetRoot()->GetChildren())
+	{
+		child->VisitRecursively(
+			[this](BookmarkItem *currentItem)
+			{
+				AddItem(currentItem);
+			});
+	}
+
+	m_connections.push_back(m_bookmarkTree->bookmarkItemAddedSignal.AddObserver(
+		std::bind_front(&BookmarkSearchIndex::OnBookmarkItemAdded, this)));
+	m_connections.push_back(m_bookmarkTree->bookmarkItemUpdatedSignal.AddObserver(
+		std::bind_front(&BookmarkSearchIndex::OnBookmarkItemUpdated, this)));
+	m_connections.push_back(m_bookmarkTree->bookmarkItemPreRemovalSignal.AddObserver(
+		std::bind_front(&BookmarkSearchIndex::OnBookmarkItemPreRemoval, this)));
+
+	// Note that moving an item doesn't change its name or location, so there's no need to observe
+	// the moved signal.
+}
+
+std::vector<BookmarkItem *> BookmarkSearchIndex::Search(std::wstring_view query,
+	size_t maxResults) const
+{
+	auto terms = Tokenize(query);
+
+	if (terms.empty() || maxResults == 0)
+	{
+		return {};
+	}
+
+	std::unordered_map<BookmarkItem *, int> scores;
+
+	for (size_t i = 0; i < terms.size(); i++)
+	{
+		auto termScores = MatchTerm(terms[i]);
+
+		if (i == 0)
+		{
+			scores = std::move(termScores);
+		}
+		else
+		{
+			// Only items that match every term are returned.
+			for (auto itr = scores.begin(); itr != scores.end();)
+			{
+				auto termItr = termScores.find(itr->first);
+
+				if (termItr == termScores.end())
+				{
+					itr = scores.erase(itr);
+					continue;
+				}
+
+				itr->second += termItr->second;
+				++itr;
+			}
+		}
+
+		if (scores.empty())
+		{
+			return {};
+		}
+	}
+
+	std::vector<Candidate> candidates;
+	candidates.reserve(scores.size());
+
+	for (const auto &[bookmarkItem, score] : scores)
+	{
+		candidates.push_back({ bookmarkItem, score });
+	}
+
+	// Only the top results need to be placed in order.
+	size_t numResults = std::min<size_t>(maxResults, candidates.size());
+	std::partial_sort(candidates.begin(), candidates.begin() + numResults, candidates.end(),
+		&BookmarkSearchIndex::IsBetterCandidate);
+
+	std::vector<BookmarkItem *> results;
+	results.reserve(numResults);
+
+	for (size_t i = 0; i < numResults; i++)
+	{
+		results.push_back(candidates[i].bookmarkItem);
+	}
+
+	return results;
+}
+
+std::unordered_map<BookmarkItem *, int> BookmarkSearchIndex::MatchTerm(
+	const std::wstring &term) const
+{
+	std::unordered_map<BookmarkItem *, int> scores;
+
+	for (auto itr = m_postings.lower_bound(term);
+		 itr != m_postings.end() && itr->first.starts_with(term); ++itr)
+	{
+		bool exactMatch = (itr->first.size() == term.size());
+
+		for (const auto &[bookmarkItem, fields] : itr->second)
+		{
+			int &score = scores[bookmarkItem];
+			score = std::max<int>(score, GetMatchScore(fields, exactMatch));
+		}
+	}
+
+	return scores;
+}
+
+int BookmarkSearchIndex::GetMatchScore(unsigned char fields, bool exactMatch)
+{
+	if (WI_IsFlagSet(fields, FIELD_NAME))
+	{
+		return exactMatch ? 4 : 3;
+	}
+
+	return exactMatch ? 2 : 1;
+}
+
+bool BookmarkSearchIndex::IsBetterCandidate(const Candidate &first, const Candidate &second)
+{
+	if (first.score != second.score)
+	{
+		return first.score > second.score;
+	}
+
+	FILETIME firstDateModified = first.bookmarkItem->GetDateModified();
+	FILETIME secondDateModified = second.bookmarkItem->GetDateModified();
+	LONG dateComparison = CompareFileTime(&firstDateModified, &secondDateModified);
+
+	if (dateComparison != 0)
+	{
+		return dateComparison > 0;
+	}
+
+	// Ensures that the order of the results is stable.
+	return first.bookmarkItem->GetGUID() < second.bookmarkItem->GetGUID();
+}
+
+std::vector<std::wstring> BookmarkSearchIndex::Tokenize(std::wstring_view text)
+{
+	if (text.empty())
+	{
+		return {};
+	}
+
+	std::wstring lowercaseText(text.size(), '\0');
+	int res = LCMapStringEx(LOCALE_NAME_INVARIANT, LCMAP_LOWERCASE, text.data(),
+		static_cast<int>(text.size()), lowercaseText.data(),
+		static_cast<int>(lowercaseText.size()), nullptr, nullptr, 0);
+
+	if (res == 0)
+	{
+		return {};
+	}
+
+	lowercaseText.resize(res);
+
+	std::vector<std::wstring> tokens;
+	std::wstring currentToken;
+
+	for (wchar_t c : lowercaseText)
+	{
+		if (IsCharAlphaNumeric(c))
+		{
+			currentToken.push_back(c);
+		}
+		else if (!currentToken.empty())
+		{
+			tokens.push_back(std::move(currentToken));
+			currentToken.clear();
+		}
+	}
+
+	if (!currentToken.empty())
+	{
+		tokens.push_back(std::move(currentToken));
+	}
+
+	return tokens;
+}
+
+void BookmarkSearchIndex::AddItem(BookmarkItem *bookmarkItem)
+{
+	auto nameTokens = Tokenize(bookmarkItem->GetName());
+	AddTokens(bookmarkItem, nameTokens, FIELD_NAME);
+
+	auto locationTokens = Tokenize(bookmarkItem->GetLocation());
+	AddTokens(bookmarkItem, locationTokens, FIELD_LOCATION);
+
+	auto &itemTokens = m_itemTokens[bookmarkItem];
+	itemTokens = std::move(nameTokens);
+	itemTokens.insert(itemTokens.end(), std::make_move_iterator(locationTokens.begin()),
+		std::make_move_iterator(locationTokens.end()));
+	std::sort(itemTokens.begin(), itemTokens.end());
+	itemTokens.erase(std::unique(itemTokens.begin(), itemTokens.end()), itemTokens.end());
+}
+
+void BookmarkSearchIndex::RemoveItem(BookmarkItem *bookmarkItem)
+{
+	auto itr = m_itemTokens.find(bookmarkItem);
+
+	if (itr == m_itemTokens.end())
+	{
+		return;
+	}
+
+	RemoveTokens(bookmarkItem, itr->second);
+	m_itemTokens.erase(itr);
+}
+
+void BookmarkSearchIndex::AddTokens(BookmarkItem *bookmarkItem,
+	const std::vector<std::wstring> &tokens, FieldFlags field)
+{
+	for (const auto &token : tokens)
+	{
+		m_postings[token][bookmarkItem] |= field;
+	}
+}
+
+void BookmarkSearchIndex::RemoveTokens(BookmarkItem *bookmarkItem,
+	const std::vector<std::wstring> &tokens)
+{
+	for (const auto &token : tokens)
+	{
+		auto itr = m_postings.find(token);
+
+		if (itr == m_postings.end())
+		{
+			continue;
+		}
+
+		itr->second.erase(bookmarkItem);
+
+		if (itr->second.empty())
+		{
+			m_postings.erase(itr);
+		}
+	}
+}
+
+void BookmarkSearchIndex::OnBookmarkItemAdded(BookmarkItem &bookmarkItem, size_t index)
+{
+	UNREFERENCED_PARAMETER(index);
+
+	bookmarkItem.VisitRecursively(
+		[this](BookmarkItem *currentItem)
+		{
+			AddItem(currentItem);
+		});
+}
+
+void BookmarkSearchIndex::OnBookmarkItemUpdated(BookmarkItem &bookmarkItem,
+	BookmarkItem::PropertyType propertyType)
+{
+	// The modification date is read directly from each item when ranking results, so only changes
+	// to the indexed text need to be handled here.
+	if (propertyType != BookmarkItem::PropertyType::Name
+		&& propertyType != BookmarkItem::PropertyType::Location)
+	{
+		return;
+	}
+
+	RemoveItem(&bookmarkItem);
+	AddItem(&bookmarkItem);
+}
+
+void BookmarkSearchIndex::OnBookmarkItemPreRemoval(BookmarkItem &bookmarkItem)
+{
+	bookmarkItem.VisitRecursively(
+		[this](BookmarkItem *currentItem)
+		{
+			RemoveItem(currentItem);
+		});
+}
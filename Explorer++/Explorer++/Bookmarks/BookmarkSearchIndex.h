@@ -0,0 +1,78 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "Bookmarks/BookmarkItem.h"
+#include <boost/signals2.hpp>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class BookmarkTree;
+
+// Maintains an inverted index over the names and locations of the items in a bookmark tree, so
+// that the tree can be searched without having to visit every item. The index is kept up to date
+// as items are added, updated and removed, rather than being rebuilt.
+class BookmarkSearchIndex
+{
+public:
+	explicit BookmarkSearchIndex(BookmarkTree *bookmarkTree);
+
+	// Returns the items that match every word in the query, with the best matches first. Each word
+	// in the query matches any word in an item's name or location that starts with it, so partial
+	// queries (e.g. those entered while the user is still typing) will return results.
+	// Matches in the name rank above matches in the location and whole word matches rank above
+	// prefix matches. Items with an equal score are ordered so that the most recently modified
+	// item comes first.
+	std::vector<BookmarkItem *> Search(std::wstring_view query, size_t maxResults) const;
+
+	// Splits the text into lowercase words. Any character that isn't alphanumeric is treated as a
+	// separator.
+	static std::vector<std::wstring> Tokenize(std::wstring_view text);
+
+private:
+	// Identifies the fields of an item that a particular word appears in.
+	enum FieldFlags : unsigned char
+	{
+		FIELD_NAME = 1 << 0,
+		FIELD_LOCATION = 1 << 1
+	};
+
+	struct Candidate
+	{
+		BookmarkItem *bookmarkItem;
+		int score;
+	};
+
+	using Postings = std::unordered_map<BookmarkItem *, unsigned char>;
+
+	void AddItem(BookmarkItem *bookmarkItem);
+	void RemoveItem(BookmarkItem *bookmarkItem);
+
+	void AddTokens(BookmarkItem *bookmarkItem, const std::vector<std::wstring> &tokens,
+		FieldFlags field);
+	void RemoveTokens(BookmarkItem *bookmarkItem, const std::vector<std::wstring> &tokens);
+
+	std::unordered_map<BookmarkItem *, int> MatchTerm(const std::wstring &term) const;
+	static int GetMatchScore(unsigned char fields, bool exactMatch);
+	static bool IsBetterCandidate(const Candidate &first, const Candidate &second);
+
+	void OnBookmarkItemAdded(BookmarkItem &bookmarkItem, size_t index);
+	void OnBookmarkItemUpdated(BookmarkItem &bookmarkItem, BookmarkItem::PropertyType propertyType);
+	void OnBookmarkItemPreRemoval(BookmarkItem &bookmarkItem);
+
+	BookmarkTree *m_bookmarkTree;
+
+	// Maps each word to the items containing it. This is ordered, so that all of the words
+	// starting with a particular prefix form a contiguous range.
+	std::map<std::wstring, Postings, std::less<>> m_postings;
+
+	// The words that have been indexed for each item. Needed so that an item's entries can be
+	// removed when the item is updated or removed.
+	std::unordered_map<BookmarkItem *, std::vector<std::wstring>> m_itemTokens;
+
+	std::vector<boost::signals2::scoped_connection> m_connections;
+};
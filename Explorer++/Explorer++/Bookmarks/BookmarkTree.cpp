@@ -30,6 +30,11 @@ BookmarkTree::BookmarkTree() :
 		std::nullopt);
 	m_otherBookmarks = otherBookmarksFolder.get();
 	m_root.AddChild(std::move(otherBookmarksFolder));
+
+	AddToIndex(&m_root);
+	AddToIndex(m_bookmarksToolbar);
+	AddToIndex(m_bookmarksMenu);
+	AddToIndex(m_otherBookmarks);
 }
 
 BookmarkItem *BookmarkTree::GetRoot()
@@ -87,6 +92,8 @@ BookmarkItem *BookmarkTree::AddBookmarkItem(BookmarkItem *parent,
 			currentItem->updatedSignal.AddObserver(
 				std::bind_front(&BookmarkTree::OnBookmarkItemUpdated, this),
 				boost::signals2::at_front);
+
+			AddToIndex(currentItem);
 		});
 
 	if (index > parent->GetChildren().size())
@@ -148,11 +155,65 @@ void BookmarkTree::RemoveBookmarkItem(BookmarkItem *bookmarkItem)
 
 	std::wstring guid = bookmarkItem->GetGUID();
 
+	bookmarkItem->VisitRecursively(
+		[this](BookmarkItem *currentItem)
+		{
+			m_bookmarkItemsByGuid.erase(currentItem->GetGUID());
+		});
+
 	size_t childIndex = parent->GetChildIndex(bookmarkItem);
 	parent->RemoveChild(childIndex);
 	bookmarkItemRemovedSignal.m_signal(guid);
 }
 
+BookmarkItem *BookmarkTree::GetBookmarkItemById(const std::wstring &guid)
+{
+	auto itr = m_bookmarkItemsByGuid.find(guid);
+
+	if (itr == m_bookmarkItemsByGuid.end())
+	{
+		return nullptr;
+	}
+
+	return itr->second;
+}
+
+const BookmarkItem *BookmarkTree::GetBookmarkItemById(const std::wstring &guid) const
+{
+	auto itr = m_bookmarkItemsByGuid.find(guid);
+
+	if (itr == m_bookmarkItemsByGuid.end())
+	{
+		return nullptr;
+	}
+
+	return itr->second;
+}
+
+void BookmarkTree::AddToIndex(BookmarkItem *bookmarkItem)
+{
+	// Each item in the tree needs a unique GUID. GUIDs are read from the config file or registry
+	// when loading, so they can be missing or duplicated (e.g. if the config file was edited by
+	// hand). In that case, the item is given a new GUID. This happens before the item is added to
+	// its parent, so nothing can be depending on the original GUID yet.
+	if (bookmarkItem->GetGUID().empty())
+	{
+		bookmarkItem->RegenerateGUID();
+	}
+
+	auto [itr, inserted] = m_bookmarkItemsByGuid.try_emplace(bookmarkItem->GetGUID(), bookmarkItem);
+
+	// When loading, the children of a folder are added before the folder itself, so the children
+	// will already be in the index by the time the folder is added.
+	if (inserted || itr->second == bookmarkItem)
+	{
+		return;
+	}
+
+	bookmarkItem->RegenerateGUID();
+	m_bookmarkItemsByGuid.emplace(bookmarkItem->GetGUID(), bookmarkItem);
+}
+
 void BookmarkTree::OnBookmarkItemUpdated(BookmarkItem &bookmarkItem,
 	BookmarkItem::PropertyType propertyType)
 {
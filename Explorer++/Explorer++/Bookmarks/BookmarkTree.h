@@ -7,6 +7,7 @@
 #include "Bookmarks/BookmarkItem.h"
 #include "SignalWrapper.h"
 #include <tchar.h>
+#include <unordered_map>
 
 class BookmarkTree
 {
@@ -21,6 +22,11 @@ public:
 	BookmarkItem *GetOtherBookmarksFolder();
 	const BookmarkItem *GetOtherBookmarksFolder() const;
 
+	// Returns the bookmark item with the specified GUID, or nullptr if there is no such item in
+	// the tree.
+	BookmarkItem *GetBookmarkItemById(const std::wstring &guid);
+	const BookmarkItem *GetBookmarkItemById(const std::wstring &guid) const;
+
 	bool CanAddChildren(const BookmarkItem *bookmarkItem) const;
 	bool IsPermanentNode(const BookmarkItem *bookmarkItem) const;
 
@@ -50,10 +56,16 @@ private:
 	static inline const TCHAR *MENU_FOLDER_GUID = _T("00000000-0000-0000-0000-000000000003");
 	static inline const TCHAR *OTHER_FOLDER_GUID = _T("00000000-0000-0000-0000-000000000004");
 
+	void AddToIndex(BookmarkItem *bookmarkItem);
 	void OnBookmarkItemUpdated(BookmarkItem &bookmarkItem, BookmarkItem::PropertyType propertyType);
 
 	BookmarkItem m_root;
 	BookmarkItem *m_bookmarksToolbar;
 	BookmarkItem *m_bookmarksMenu;
 	BookmarkItem *m_otherBookmarks;
+
+	// Maps the GUID of every item in the tree (including the permanent folders) to the item
+	// itself. GUIDs can't be changed once an item has been created, so this only needs to be
+	// updated when items are added or removed.
+	std::unordered_map<std::wstring, BookmarkItem *> m_bookmarkItemsByGuid;
 };
@@ -8,21 +8,26 @@
 #include "Bookmarks/BookmarkStorage.h"
 #include "Bookmarks/BookmarkTree.h"
 #include "../Helper/XMLSettings.h"
+#include "../Helper/XmlPullParser.h"
 #include <wil/com.h>
 
 namespace V2
 {
 const TCHAR bookmarksKeyNodeName[] = _T("Bookmarksv2");
+const char bookmarksElementName[] = "Bookmarksv2";
 
-void Load(IXMLDOMNode *parentNode, BookmarkTree *bookmarkTree);
-void LoadPermanentFolder(IXMLDOMNode *parentNode, BookmarkTree *bookmarkTree,
-	BookmarkItem *bookmarkItem, const std::wstring &name);
-void LoadBookmarkChildren(IXMLDOMNode *parentNode, BookmarkTree *bookmarkTree,
+void Load(XmlPullParser &parser, BookmarkTree *bookmarkTree);
+std::optional<BookmarkJournalPosition> LoadJournalPosition(const XmlPullParser &parser);
+void LoadPermanentFolder(XmlPullParser &parser, BookmarkTree *bookmarkTree,
+	BookmarkItem *bookmarkItem);
+void LoadBookmarkChildren(XmlPullParser &parser, BookmarkTree *bookmarkTree,
 	BookmarkItem *parentBookmarkItem);
-std::unique_ptr<BookmarkItem> LoadBookmarkItem(IXMLDOMNode *parentNode, BookmarkTree *bookmarkTree);
+std::unique_ptr<BookmarkItem> LoadBookmarkItem(XmlPullParser &parser, BookmarkTree *bookmarkTree);
 
 void Save(IXMLDOMDocument *xmlDocument, IXMLDOMElement *parentNode, BookmarkTree *bookmarkTree,
 	int indent);
+void SaveJournalPosition(IXMLDOMDocument *xmlDocument, IXMLDOMElement *bookmarksNode,
+	const BookmarkJournalPosition &journalPosition);
 void SavePermanentFolder(IXMLDOMDocument *xmlDocument, IXMLDOMElement *parentNode,
 	const BookmarkItem *bookmarkItem, const std::wstring &name, int indent);
 void SaveBookmarkChildren(IXMLDOMDocument *xmlDocument, IXMLDOMElement *parentNode,
@@ -33,162 +38,153 @@ void SaveBookmarkItem(IXMLDOMDocument *xmlDocument, IXMLDOMElement *parentNode,
 
 namespace V1
 {
-const TCHAR bookmarksKeyNodeName[] = _T("Bookmarks");
+const char bookmarksElementName[] = "Bookmarks";
 
-void Load(IXMLDOMNode *parentNode, BookmarkTree *bookmarkTree);
-void LoadBookmarkChildren(IXMLDOMNode *parentNode, BookmarkTree *bookmarkTree,
+void Load(XmlPullParser &parser, BookmarkTree *bookmarkTree);
+void LoadBookmarkChildren(XmlPullParser &parser, BookmarkTree *bookmarkTree,
 	BookmarkItem *parentBookmarkItem);
-std::unique_ptr<BookmarkItem> LoadBookmarkItem(IXMLDOMNode *parentNode, BookmarkTree *bookmarkTree,
+std::unique_ptr<BookmarkItem> LoadBookmarkItem(XmlPullParser &parser, BookmarkTree *bookmarkTree,
 	bool &showOnToolbarOutput);
 }
 
-void BookmarkXmlStorage::Load(IXMLDOMDocument *xmlDocument, BookmarkTree *bookmarkTree)
+std::optional<BookmarkJournalPosition> BookmarkXmlStorage::Load(std::string_view xmlData,
+	BookmarkTree *bookmarkTree)
 {
-	wil::com_ptr_nothrow<IXMLDOMNode> bookmarksNode;
-	auto queryString = wil::make_bstr_nothrow(
-		(std::wstring(L"/ExplorerPlusPlus/") + std::wstring(V2::bookmarksKeyNodeName)).c_str());
-	HRESULT hr = xmlDocument->selectSingleNode(queryString.get(), &bookmarksNode);
+	auto parser = XmlPullParser::OpenTopLevelElement(xmlData, V2::bookmarksElementName);
 
-	if (hr == S_OK)
+	if (parser)
 	{
-		V2::Load(bookmarksNode.get(), bookmarkTree);
-		return;
+		// The attributes need to be read before the parser moves on to the child elements.
+		auto journalPosition = V2::LoadJournalPosition(*parser);
+		V2::Load(*parser, bookmarkTree);
+		return journalPosition;
 	}
 
-	queryString = wil::make_bstr_nothrow(
-		(std::wstring(L"/ExplorerPlusPlus/") + std::wstring(V1::bookmarksKeyNodeName)).c_str());
-	hr = xmlDocument->selectSingleNode(queryString.get(), &bookmarksNode);
+	parser = XmlPullParser::OpenTopLevelElement(xmlData, V1::bookmarksElementName);
 
-	if (hr == S_OK)
+	if (parser)
 	{
-		V1::Load(bookmarksNode.get(), bookmarkTree);
-		return;
+		V1::Load(*parser, bookmarkTree);
 	}
+
+	return std::nullopt;
 }
 
-void V2::Load(IXMLDOMNode *parentNode, BookmarkTree *bookmarkTree)
+void V2::Load(XmlPullParser &parser, BookmarkTree *bookmarkTree)
 {
-	LoadPermanentFolder(parentNode, bookmarkTree, bookmarkTree->GetBookmarksToolbarFolder(),
-		BookmarkStorage::BOOKMARKS_TOOLBAR_NODE_NAME);
-	LoadPermanentFolder(parentNode, bookmarkTree, bookmarkTree->GetBookmarksMenuFolder(),
-		BookmarkStorage::BOOKMARKS_MENU_NODE_NAME);
-	LoadPermanentFolder(parentNode, bookmarkTree, bookmarkTree->GetOtherBookmarksFolder(),
-		BookmarkStorage::OTHER_BOOKMARKS_NODE_NAME);
+	size_t bookmarksDepth = parser.GetDepth();
+
+	while (parser.FindChildElement(bookmarksDepth, "PermanentItem"))
+	{
+		auto name = parser.GetAttribute("name");
+
+		if (!name)
+		{
+			continue;
+		}
+
+		if (*name == BookmarkStorage::BOOKMARKS_TOOLBAR_NODE_NAME)
+		{
+			LoadPermanentFolder(parser, bookmarkTree, bookmarkTree->GetBookmarksToolbarFolder());
+		}
+		else if (*name == BookmarkStorage::BOOKMARKS_MENU_NODE_NAME)
+		{
+			LoadPermanentFolder(parser, bookmarkTree, bookmarkTree->GetBookmarksMenuFolder());
+		}
+		else if (*name == BookmarkStorage::OTHER_BOOKMARKS_NODE_NAME)
+		{
+			LoadPermanentFolder(parser, bookmarkTree, bookmarkTree->GetOtherBookmarksFolder());
+		}
+	}
 }
 
-void V2::LoadPermanentFolder(IXMLDOMNode *parentNode, BookmarkTree *bookmarkTree,
-	BookmarkItem *bookmarkItem, const std::wstring &name)
+std::optional<BookmarkJournalPosition> V2::LoadJournalPosition(const XmlPullParser &parser)
 {
-	wil::com_ptr_nothrow<IXMLDOMNode> childNode;
-	auto queryString = wil::make_bstr_nothrow((L"./PermanentItem[@name='" + name + L"']").c_str());
-	HRESULT hr = parentNode->selectSingleNode(queryString.get(), &childNode);
+	auto journalId = parser.GetAttribute("JournalId");
+	auto sequenceNumber = parser.GetAttribute("JournalSequenceNumber");
 
-	if (hr == S_OK)
+	if (!journalId || !sequenceNumber)
 	{
-		wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> attributeMap;
-		childNode->get_attributes(&attributeMap);
+		return std::nullopt;
+	}
 
-		FILETIME dateCreated;
-		NXMLSettings::ReadDateTime(attributeMap.get(), _T("DateCreated"), dateCreated);
-		bookmarkItem->SetDateCreated(dateCreated);
+	return BookmarkJournalPosition{ *journalId, _wcstoui64(sequenceNumber->c_str(), nullptr, 10) };
+}
 
-		FILETIME dateModified;
-		NXMLSettings::ReadDateTime(attributeMap.get(), _T("DateModified"), dateModified);
-		bookmarkItem->SetDateModified(dateModified);
+void V2::LoadPermanentFolder(XmlPullParser &parser, BookmarkTree *bookmarkTree,
+	BookmarkItem *bookmarkItem)
+{
+	FILETIME dateCreated;
+	NXMLSettings::ReadDateTime(parser, "DateCreated", dateCreated);
+	bookmarkItem->SetDateCreated(dateCreated);
 
-		LoadBookmarkChildren(childNode.get(), bookmarkTree, bookmarkItem);
-	}
+	FILETIME dateModified;
+	NXMLSettings::ReadDateTime(parser, "DateModified", dateModified);
+	bookmarkItem->SetDateModified(dateModified);
+
+	LoadBookmarkChildren(parser, bookmarkTree, bookmarkItem);
 }
 
-void V2::LoadBookmarkChildren(IXMLDOMNode *parentNode, BookmarkTree *bookmarkTree,
+// Items are always saved in order, so each child is simply appended to its parent.
+void V2::LoadBookmarkChildren(XmlPullParser &parser, BookmarkTree *bookmarkTree,
 	BookmarkItem *parentBookmarkItem)
 {
-	auto makeQueryString = [](int index)
-	{
-		return wil::make_bstr_nothrow(
-			(L"./Bookmark[@name='" + std::to_wstring(index) + L"']").c_str());
-	};
+	size_t parentDepth = parser.GetDepth();
 
-	wil::com_ptr_nothrow<IXMLDOMNode> childNode;
-	int index = 0;
-	auto queryString = makeQueryString(index);
-
-	while (parentNode->selectSingleNode(queryString.get(), &childNode) == S_OK)
+	while (parser.FindChildElement(parentDepth, "Bookmark"))
 	{
-		auto childBookmarkItem = LoadBookmarkItem(childNode.get(), bookmarkTree);
-		bookmarkTree->AddBookmarkItem(parentBookmarkItem, std::move(childBookmarkItem), index);
-
-		index++;
-		queryString = makeQueryString(index);
+		auto childBookmarkItem = LoadBookmarkItem(parser, bookmarkTree);
+		bookmarkTree->AddBookmarkItem(parentBookmarkItem, std::move(childBookmarkItem),
+			parentBookmarkItem->GetChildren().size());
 	}
 }
 
-std::unique_ptr<BookmarkItem> V2::LoadBookmarkItem(IXMLDOMNode *parentNode,
+std::unique_ptr<BookmarkItem> V2::LoadBookmarkItem(XmlPullParser &parser,
 	BookmarkTree *bookmarkTree)
 {
-	wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> attributeMap;
-	parentNode->get_attributes(&attributeMap);
-
-	int type;
-	NXMLSettings::GetIntFromMap(attributeMap.get(), L"Type", type);
-
-	std::wstring guid;
-	NXMLSettings::GetStringFromMap(attributeMap.get(), L"GUID", guid);
-
-	std::wstring name;
-	NXMLSettings::GetStringFromMap(attributeMap.get(), L"ItemName", name);
+	int type = NXMLSettings::DecodeIntValue(parser.GetAttribute("Type").value_or(L"").c_str());
+	std::wstring guid = parser.GetAttribute("GUID").value_or(L"");
+	std::wstring name = parser.GetAttribute("ItemName").value_or(L"");
 
 	std::optional<std::wstring> locationOptional;
 
 	if (type == static_cast<int>(BookmarkItem::Type::Bookmark))
 	{
-		std::wstring location;
-		NXMLSettings::GetStringFromMap(attributeMap.get(), L"Location", location);
-
-		locationOptional = location;
+		locationOptional = parser.GetAttribute("Location").value_or(L"");
 	}
 
 	auto bookmarkItem = std::make_unique<BookmarkItem>(guid, name, locationOptional);
 
 	FILETIME dateCreated;
-	NXMLSettings::ReadDateTime(attributeMap.get(), _T("DateCreated"), dateCreated);
+	NXMLSettings::ReadDateTime(parser, "DateCreated", dateCreated);
 	bookmarkItem->SetDateCreated(dateCreated);
 
 	FILETIME dateModified;
-	NXMLSettings::ReadDateTime(attributeMap.get(), _T("DateModified"), dateModified);
+	NXMLSettings::ReadDateTime(parser, "DateModified", dateModified);
 	bookmarkItem->SetDateModified(dateModified);
 
 	if (type == static_cast<int>(BookmarkItem::Type::Folder))
 	{
-		LoadBookmarkChildren(parentNode, bookmarkTree, bookmarkItem.get());
+		LoadBookmarkChildren(parser, bookmarkTree, bookmarkItem.get());
 	}
 
 	return bookmarkItem;
 }
 
-void V1::Load(IXMLDOMNode *parentNode, BookmarkTree *bookmarkTree)
+void V1::Load(XmlPullParser &parser, BookmarkTree *bookmarkTree)
 {
-	LoadBookmarkChildren(parentNode, bookmarkTree, nullptr);
+	LoadBookmarkChildren(parser, bookmarkTree, nullptr);
 }
 
-void V1::LoadBookmarkChildren(IXMLDOMNode *parentNode, BookmarkTree *bookmarkTree,
+void V1::LoadBookmarkChildren(XmlPullParser &parser, BookmarkTree *bookmarkTree,
 	BookmarkItem *parentBookmarkItem)
 {
-	wil::com_ptr_nothrow<IXMLDOMNodeList> children;
-	auto queryString = wil::make_bstr_nothrow(L"./Bookmark");
-	HRESULT hr = parentNode->selectNodes(queryString.get(), &children);
+	size_t parentDepth = parser.GetDepth();
 
-	if (hr != S_OK)
-	{
-		return;
-	}
-
-	wil::com_ptr_nothrow<IXMLDOMNode> childNode;
-
-	while (children->nextNode(&childNode) == S_OK)
+	while (parser.FindChildElement(parentDepth, "Bookmark"))
 	{
 		bool showOnToolbar;
-		auto childBookmarkItem = LoadBookmarkItem(childNode.get(), bookmarkTree, showOnToolbar);
+		auto childBookmarkItem = LoadBookmarkItem(parser, bookmarkTree, showOnToolbar);
 
 		if (!parentBookmarkItem)
 		{
@@ -213,20 +209,12 @@ void V1::LoadBookmarkChildren(IXMLDOMNode *parentNode, BookmarkTree *bookmarkTre
 	}
 }
 
-std::unique_ptr<BookmarkItem> V1::LoadBookmarkItem(IXMLDOMNode *parentNode,
+std::unique_ptr<BookmarkItem> V1::LoadBookmarkItem(XmlPullParser &parser,
 	BookmarkTree *bookmarkTree, bool &showOnToolbarOutput)
 {
-	wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> attributeMap;
-	parentNode->get_attributes(&attributeMap);
-
-	int type;
-	NXMLSettings::GetIntFromMap(attributeMap.get(), L"Type", type);
-
-	std::wstring name;
-	NXMLSettings::GetStringFromMap(attributeMap.get(), L"name", name);
-
-	std::wstring showOnToolbar;
-	NXMLSettings::GetStringFromMap(attributeMap.get(), L"ShowOnBookmarksToolbar", showOnToolbar);
+	int type = NXMLSettings::DecodeIntValue(parser.GetAttribute("Type").value_or(L"").c_str());
+	std::wstring name = parser.GetAttribute("name").value_or(L"");
+	std::wstring showOnToolbar = parser.GetAttribute("ShowOnBookmarksToolbar").value_or(L"");
 
 	showOnToolbarOutput = NXMLSettings::DecodeBoolValue(showOnToolbar.c_str());
 
@@ -234,23 +222,18 @@ std::unique_ptr<BookmarkItem> V1::LoadBookmarkItem(IXMLDOMNode *parentNode,
 
 	if (type == static_cast<int>(BookmarkStorage::BookmarkTypeV1::Bookmark))
 	{
-		std::wstring location;
-		NXMLSettings::GetStringFromMap(attributeMap.get(), L"Location", location);
-
-		locationOptional = location;
+		locationOptional = parser.GetAttribute("Location").value_or(L"");
 	}
 
 	auto bookmarkItem = std::make_unique<BookmarkItem>(std::nullopt, name, locationOptional);
 
 	if (type == static_cast<int>(BookmarkStorage::BookmarkTypeV1::Folder))
 	{
-		wil::com_ptr_nothrow<IXMLDOMNode> bookmarksNode;
-		auto queryString = wil::make_bstr_nothrow(L"./Bookmarks");
-		HRESULT hr = parentNode->selectSingleNode(queryString.get(), &bookmarksNode);
+		size_t folderDepth = parser.GetDepth();
 
-		if (hr == S_OK)
+		if (parser.FindChildElement(folderDepth, "Bookmarks"))
 		{
-			LoadBookmarkChildren(bookmarksNode.get(), bookmarkTree, bookmarkItem.get());
+			LoadBookmarkChildren(parser, bookmarkTree, bookmarkItem.get());
 		}
 	}
 
@@ -258,7 +241,8 @@ std::unique_ptr<BookmarkItem> V1::LoadBookmarkItem(IXMLDOMNode *parentNode,
 }
 
 void BookmarkXmlStorage::Save(IXMLDOMDocument *xmlDocument, IXMLDOMElement *parentNode,
-	BookmarkTree *bookmarkTree, int indent)
+	BookmarkTree *bookmarkTree, int indent,
+	const std::optional<BookmarkJournalPosition> &journalPosition)
 {
 	auto newline =
 		wil::make_bstr_nothrow((std::wstring(L"\n") + std::wstring(indent, '\t')).c_str());
@@ -270,6 +254,11 @@ void BookmarkXmlStorage::Save(IXMLDOMDocument *xmlDocument, IXMLDOMElement *pare
 
 	if (hr == S_OK)
 	{
+		if (journalPosition)
+		{
+			V2::SaveJournalPosition(xmlDocument, bookmarksNode.get(), *journalPosition);
+		}
+
 		V2::Save(xmlDocument, bookmarksNode.get(), bookmarkTree, indent + 1);
 
 		NXMLSettings::AddWhiteSpaceToNode(xmlDocument, newline.get(), bookmarksNode.get());
@@ -288,6 +277,15 @@ void V2::Save(IXMLDOMDocument *xmlDocument, IXMLDOMElement *parentNode, Bookmark
 		BookmarkStorage::OTHER_BOOKMARKS_NODE_NAME, indent);
 }
 
+void V2::SaveJournalPosition(IXMLDOMDocument *xmlDocument, IXMLDOMElement *bookmarksNode,
+	const BookmarkJournalPosition &journalPosition)
+{
+	NXMLSettings::AddAttributeToNode(xmlDocument, bookmarksNode, L"JournalId",
+		journalPosition.journalId.c_str());
+	NXMLSettings::AddAttributeToNode(xmlDocument, bookmarksNode, L"JournalSequenceNumber",
+		std::to_wstring(journalPosition.sequenceNumber).c_str());
+}
+
 void V2::SavePermanentFolder(IXMLDOMDocument *xmlDocument, IXMLDOMElement *parentNode,
 	const BookmarkItem *bookmarkItem, const std::wstring &name, int indent)
 {
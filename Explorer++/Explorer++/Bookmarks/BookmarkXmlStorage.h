@@ -4,13 +4,17 @@
 
 #pragma once
 
+#include "Bookmarks/BookmarkJournal.h"
 #include <MsXml2.h>
+#include <optional>
+#include <string_view>
 
 class BookmarkTree;
 
 namespace BookmarkXmlStorage
 {
-void Load(IXMLDOMDocument *xmlDocument, BookmarkTree *bookmarkTree);
+// Returns the journal position that was saved along with the bookmarks, if there is one.
+std::optional<BookmarkJournalPosition> Load(std::string_view xmlData, BookmarkTree *bookmarkTree);
 void Save(IXMLDOMDocument *xmlDocument, IXMLDOMElement *parentNode, BookmarkTree *bookmarkTree,
-	int indent);
+	int indent, const std::optional<BookmarkJournalPosition> &journalPosition = std::nullopt);
 }
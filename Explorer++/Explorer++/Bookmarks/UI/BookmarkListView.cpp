@@ -35,6 +35,7 @@ BookmarkListView::BookmarkListView(HWND hListView, HMODULE resourceModule,
 	m_coreInterface(coreInterface),
 	m_navigator(navigator),
 	m_columns(initialColumns),
+	m_showingSearchResults(false),
 	m_sortColumn(BookmarkHelper::ColumnType::Default),
 	m_sortAscending(true),
 	m_bookmarkContextMenu(bookmarkTree, resourceModule, coreInterface, navigator)
@@ -300,6 +301,7 @@ void BookmarkListView::NavigateToBookmarkFolder(BookmarkItem *bookmarkFolder, bo
 	assert(bookmarkFolder->IsFolder());
 
 	m_currentBookmarkFolder = bookmarkFolder;
+	m_showingSearchResults = false;
 
 	ListView_DeleteAllItems(m_hListView);
 
@@ -322,6 +324,27 @@ boost::signals2::connection BookmarkListView::AddNavigationCompletedObserver(
 	return m_navigationCompletedSignal.connect(observer, position);
 }
 
+void BookmarkListView::ShowSearchResults(const std::vector<BookmarkItem *> &bookmarkItems)
+{
+	m_showingSearchResults = true;
+
+	ListView_DeleteAllItems(m_hListView);
+
+	int position = 0;
+
+	for (auto bookmarkItem : bookmarkItems)
+	{
+		InsertBookmarkItemIntoListView(bookmarkItem, position);
+
+		position++;
+	}
+}
+
+bool BookmarkListView::IsShowingSearchResults() const
+{
+	return m_showingSearchResults;
+}
+
 int BookmarkListView::InsertBookmarkItemIntoListView(BookmarkItem *bookmarkItem, int position)
 {
 	assert(position >= 0 && position <= ListView_GetItemCount(m_hListView));
@@ -357,7 +380,36 @@ int BookmarkListView::InsertBookmarkItemIntoListView(BookmarkItem *bookmarkItem,
 
 void BookmarkListView::OnBookmarkIconAvailable(std::wstring_view guid, int iconIndex)
 {
-	auto index = GetBookmarkItemIndexUsingGuid(guid);
+	// The icon is retrieved asynchronously, so the item may have been removed, or the current
+	// folder may have changed, in the meantime.
+	const BookmarkItem *bookmarkItem = m_bookmarkTree->GetBookmarkItemById(std::wstring(guid));
+
+	if (!bookmarkItem
+		|| (!m_showingSearchResults && bookmarkItem->GetParent() != m_currentBookmarkFolder))
+	{
+		return;
+	}
+
+	std::optional<int> index;
+
+	// When the items in a folder are displayed in their default order, the position of the item
+	// in the listview is the same as its position within the folder, which avoids having to
+	// search for it.
+	if (!m_showingSearchResults && m_sortColumn == BookmarkHelper::ColumnType::Default)
+	{
+		int childIndex = static_cast<int>(m_currentBookmarkFolder->GetChildIndex(bookmarkItem));
+
+		if (childIndex < ListView_GetItemCount(m_hListView)
+			&& GetBookmarkItemFromListView(childIndex) == bookmarkItem)
+		{
+			index = childIndex;
+		}
+	}
+
+	if (!index)
+	{
+		index = GetBookmarkItemIndex(bookmarkItem);
+	}
 
 	if (!index)
 	{
@@ -580,13 +632,39 @@ void BookmarkListView::OnShowContextMenu(const POINT &ptScreen)
 			ClientToScreen(m_hListView, &finalPoint);
 		}
 
-		m_bookmarkContextMenu.ShowMenu(m_hListView, m_currentBookmarkFolder, rawBookmarkItems,
-			finalPoint);
+		BookmarkItem *parentFolder = m_currentBookmarkFolder;
+
+		if (m_showingSearchResults)
+		{
+			// The context menu operates on items within a single folder, so it can only be shown
+			// if all the selected results come from the same folder.
+			parentFolder = rawBookmarkItems[0]->GetParent();
+
+			bool sameParent = std::all_of(rawBookmarkItems.begin(), rawBookmarkItems.end(),
+				[parentFolder](const BookmarkItem *bookmarkItem)
+				{
+					return bookmarkItem->GetParent() == parentFolder;
+				});
+
+			if (!sameParent)
+			{
+				return;
+			}
+		}
+
+		m_bookmarkContextMenu.ShowMenu(m_hListView, parentFolder, rawBookmarkItems, finalPoint);
 	}
 }
 
 void BookmarkListView::ShowBackgroundContextMenu(const POINT &ptScreen)
 {
+	// The items in the background menu are added to the current folder, which isn't what's being
+	// displayed when showing search results.
+	if (m_showingSearchResults)
+	{
+		return;
+	}
+
 	wil::unique_hmenu parentMenu(
 		LoadMenu(m_resourceModule, MAKEINTRESOURCE(IDR_BOOKMARK_LISTVIEW_CONTEXT_MENU)));
 
@@ -1042,6 +1120,11 @@ void BookmarkListView::ToggleColumn(BookmarkHelper::ColumnType columnType)
 
 void BookmarkListView::OnBookmarkItemAdded(BookmarkItem &bookmarkItem, size_t index)
 {
+	if (m_showingSearchResults)
+	{
+		return;
+	}
+
 	if (bookmarkItem.GetParent() == m_currentBookmarkFolder)
 	{
 		InsertBookmarkItemIntoListView(&bookmarkItem, static_cast<int>(index));
@@ -1051,13 +1134,19 @@ void BookmarkListView::OnBookmarkItemAdded(BookmarkItem &bookmarkItem, size_t in
 void BookmarkListView::OnBookmarkItemUpdated(BookmarkItem &bookmarkItem,
 	BookmarkItem::PropertyType propertyType)
 {
-	if (bookmarkItem.GetParent() != m_currentBookmarkFolder)
+	if (!m_showingSearchResults && bookmarkItem.GetParent() != m_currentBookmarkFolder)
 	{
 		return;
 	}
 
 	auto index = GetBookmarkItemIndex(&bookmarkItem);
-	assert(index);
+
+	if (!index)
+	{
+		// The item isn't one of the search results currently being displayed.
+		assert(m_showingSearchResults);
+		return;
+	}
 
 	BookmarkHelper::ColumnType columnType = MapPropertyTypeToColumnType(propertyType);
 	Column &column = GetColumnByType(columnType);
@@ -1077,6 +1166,13 @@ void BookmarkListView::OnBookmarkItemMoved(BookmarkItem *bookmarkItem,
 {
 	UNREFERENCED_PARAMETER(oldIndex);
 
+	// Search results are shown regardless of which folder they're in, so moving an item has no
+	// effect on the results.
+	if (m_showingSearchResults)
+	{
+		return;
+	}
+
 	if (oldParent == m_currentBookmarkFolder)
 	{
 		RemoveBookmarkItem(bookmarkItem);
@@ -1090,6 +1186,22 @@ void BookmarkListView::OnBookmarkItemMoved(BookmarkItem *bookmarkItem,
 
 void BookmarkListView::OnBookmarkItemPreRemoval(BookmarkItem &bookmarkItem)
 {
+	if (m_showingSearchResults)
+	{
+		// The item (or any of its descendants) may be displayed, and all of those items are about
+		// to be destroyed.
+		bookmarkItem.VisitRecursively(
+			[this](BookmarkItem *currentItem)
+			{
+				if (GetBookmarkItemIndex(currentItem))
+				{
+					RemoveBookmarkItem(currentItem);
+				}
+			});
+
+		return;
+	}
+
 	if (bookmarkItem.GetParent() == m_currentBookmarkFolder)
 	{
 		RemoveBookmarkItem(&bookmarkItem);
@@ -1119,23 +1231,6 @@ std::optional<int> BookmarkListView::GetBookmarkItemIndex(const BookmarkItem *bo
 	return index;
 }
 
-std::optional<int> BookmarkListView::GetBookmarkItemIndexUsingGuid(std::wstring_view guid) const
-{
-	int numItems = ListView_GetItemCount(m_hListView);
-
-	for (int i = 0; i < numItems; i++)
-	{
-		const BookmarkItem *bookmarkItem = GetBookmarkItemFromListView(i);
-
-		if (bookmarkItem->GetGUID() == guid)
-		{
-			return i;
-		}
-	}
-
-	return std::nullopt;
-}
-
 BookmarkHelper::ColumnType BookmarkListView::MapPropertyTypeToColumnType(
 	BookmarkItem::PropertyType propertyType) const
 {
@@ -1225,6 +1320,13 @@ int BookmarkListView::GetColumnIndexByType(BookmarkHelper::ColumnType columnType
 
 BookmarkListView::DropLocation BookmarkListView::GetDropLocation(const POINT &pt)
 {
+	// Items can't be dropped into the list of search results. The root folder can't contain any
+	// items, so using it as the target means that the drop will be rejected.
+	if (m_showingSearchResults)
+	{
+		return { m_bookmarkTree->GetRoot(), 0, false };
+	}
+
 	POINT ptClient = pt;
 	ScreenToClient(m_hListView, &ptClient);
 
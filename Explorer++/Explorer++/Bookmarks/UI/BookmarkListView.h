@@ -40,6 +40,11 @@ public:
 		const BookmarkNavigationCompletedSignal::slot_type &observer,
 		boost::signals2::connect_position position = boost::signals2::at_back) override;
 
+	// Replaces the contents of the listview with the specified items, which can come from any
+	// folder. The items will remain displayed until the next navigation.
+	void ShowSearchResults(const std::vector<BookmarkItem *> &bookmarkItems);
+	bool IsShowingSearchResults() const;
+
 	std::optional<int> GetLastSelectedItemIndex() const;
 	RawBookmarkItems GetSelectedBookmarkItems();
 	void SelectItem(const BookmarkItem *bookmarkItem);
@@ -117,7 +122,6 @@ private:
 
 	void RemoveBookmarkItem(const BookmarkItem *bookmarkItem);
 	std::optional<int> GetBookmarkItemIndex(const BookmarkItem *bookmarkItem) const;
-	std::optional<int> GetBookmarkItemIndexUsingGuid(std::wstring_view guid) const;
 	BookmarkHelper::ColumnType MapPropertyTypeToColumnType(
 		BookmarkItem::PropertyType propertyType) const;
 	Column &GetColumnByType(BookmarkHelper::ColumnType columnType);
@@ -140,6 +144,7 @@ private:
 
 	BookmarkTree *m_bookmarkTree;
 	BookmarkItem *m_currentBookmarkFolder;
+	bool m_showingSearchResults;
 	BookmarkHelper::ColumnType m_sortColumn;
 	bool m_sortAscending;
 	std::optional<BookmarkHelper::ColumnType> m_previousSortColumn;
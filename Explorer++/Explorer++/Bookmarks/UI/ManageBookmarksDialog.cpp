@@ -7,6 +7,7 @@
 #include "Bookmarks/BookmarkHelper.h"
 #include "Bookmarks/BookmarkIconManager.h"
 #include "Bookmarks/BookmarkNavigationController.h"
+#include "Bookmarks/BookmarkSearchIndex.h"
 #include "Bookmarks/BookmarkTree.h"
 #include "Bookmarks/UI/BookmarkTreeView.h"
 #include "CoreInterface.h"
@@ -19,18 +20,20 @@
 #include "../Helper/ListViewHelper.h"
 #include "../Helper/Macros.h"
 #include "../Helper/MenuHelper.h"
+#include "../Helper/WindowHelper.h"
 #include "../Helper/WindowSubclassWrapper.h"
 
 const TCHAR ManageBookmarksDialogPersistentSettings::SETTINGS_KEY[] = _T("ManageBookmarks");
 
 ManageBookmarksDialog::ManageBookmarksDialog(HINSTANCE hInstance, HWND hParent,
 	CoreInterface *coreInterface, Navigator *navigator, IconFetcher *iconFetcher,
-	BookmarkTree *bookmarkTree) :
+	BookmarkTree *bookmarkTree, BookmarkSearchIndex *bookmarkSearchIndex) :
 	DarkModeDialogBase(hInstance, IDD_MANAGE_BOOKMARKS, hParent, true),
 	m_coreInterface(coreInterface),
 	m_navigator(navigator),
 	m_iconFetcher(iconFetcher),
-	m_bookmarkTree(bookmarkTree)
+	m_bookmarkTree(bookmarkTree),
+	m_bookmarkSearchIndex(bookmarkSearchIndex)
 {
 	m_persistentSettings = &ManageBookmarksDialogPersistentSettings::GetInstance();
 
@@ -51,6 +54,7 @@ INT_PTR ManageBookmarksDialog::OnInitDialog()
 	SetupToolbar();
 	SetupTreeView();
 	SetupListView();
+	SetupSearchEdit();
 
 	m_navigationController =
 		std::make_unique<BookmarkNavigationController>(m_bookmarkTree, m_bookmarkListView);
@@ -80,6 +84,11 @@ void ManageBookmarksDialog::GetResizableControlInformation(BaseDialog::DialogSiz
 	control.Constraint = ResizableDialog::ControlConstraint::None;
 	controlList.push_back(control);
 
+	control.iID = IDC_MANAGEBOOKMARKS_SEARCH;
+	control.Type = ResizableDialog::ControlType::Move;
+	control.Constraint = ResizableDialog::ControlConstraint::X;
+	controlList.push_back(control);
+
 	control.iID = IDOK;
 	control.Type = ResizableDialog::ControlType::Move;
 	control.Constraint = ResizableDialog::ControlConstraint::None;
@@ -166,16 +175,17 @@ void ManageBookmarksDialog::SetupToolbar()
 	GetWindowRect(GetDlgItem(m_hDlg, IDC_MANAGEBOOKMARKS_TREEVIEW), &rcTreeView);
 	MapWindowPoints(HWND_DESKTOP, m_hDlg, reinterpret_cast<LPPOINT>(&rcTreeView), 2);
 
-	RECT rcListView;
-	GetWindowRect(GetDlgItem(m_hDlg, IDC_MANAGEBOOKMARKS_LISTVIEW), &rcListView);
-	MapWindowPoints(HWND_DESKTOP, m_hDlg, reinterpret_cast<LPPOINT>(&rcListView), 2);
+	// The toolbar sits to the left of the search box.
+	RECT rcSearch;
+	GetWindowRect(GetDlgItem(m_hDlg, IDC_MANAGEBOOKMARKS_SEARCH), &rcSearch);
+	MapWindowPoints(HWND_DESKTOP, m_hDlg, reinterpret_cast<LPPOINT>(&rcSearch), 2);
 
 	auto dwButtonSize = static_cast<DWORD>(SendMessage(m_hToolbar, TB_GETBUTTONSIZE, 0, 0));
 
 	SetWindowPos(m_toolbarParent, nullptr, rcTreeView.left,
-		(rcTreeView.top - HIWORD(dwButtonSize)) / 2, rcListView.right - rcTreeView.left,
+		(rcTreeView.top - HIWORD(dwButtonSize)) / 2, rcSearch.left - rcTreeView.left,
 		HIWORD(dwButtonSize), 0);
-	SetWindowPos(m_hToolbar, nullptr, 0, 0, rcListView.right - rcTreeView.left,
+	SetWindowPos(m_hToolbar, nullptr, 0, 0, rcSearch.left - rcTreeView.left,
 		HIWORD(dwButtonSize), 0);
 }
 
@@ -201,6 +211,14 @@ void ManageBookmarksDialog::SetupListView()
 		std::bind_front(&ManageBookmarksDialog::OnListViewNavigation, this)));
 }
 
+void ManageBookmarksDialog::SetupSearchEdit()
+{
+	std::wstring cueBanner =
+		ResourceHelper::LoadString(GetInstance(), IDS_MANAGE_BOOKMARKS_SEARCH_CUE_BANNER);
+	SendDlgItemMessage(m_hDlg, IDC_MANAGEBOOKMARKS_SEARCH, EM_SETCUEBANNER, TRUE,
+		reinterpret_cast<LPARAM>(cueBanner.c_str()));
+}
+
 LRESULT CALLBACK ManageBookmarksDialog::ParentWndProc(HWND hwnd, UINT msg, WPARAM wParam,
 	LPARAM lParam)
 {
@@ -305,6 +323,12 @@ INT_PTR ManageBookmarksDialog::OnCommand(WPARAM wParam, LPARAM lParam)
 		return HandleMenuOrAccelerator(wParam);
 	}
 
+	if (HIWORD(wParam) == EN_CHANGE && LOWORD(wParam) == IDC_MANAGEBOOKMARKS_SEARCH)
+	{
+		OnSearchTextChanged();
+		return 0;
+	}
+
 	return 1;
 }
 
@@ -624,6 +648,10 @@ void ManageBookmarksDialog::OnOrganizeMenuItemSelected(int menuItemId)
 
 void ManageBookmarksDialog::OnNewBookmark()
 {
+	// New items are always added to the current folder, so the contents of that folder need to
+	// be shown.
+	ClearSearch();
+
 	HWND focus = GetFocus();
 	HWND listView = GetDlgItem(m_hDlg, IDC_MANAGEBOOKMARKS_LISTVIEW);
 	HWND treeView = GetDlgItem(m_hDlg, IDC_MANAGEBOOKMARKS_TREEVIEW);
@@ -662,6 +690,8 @@ void ManageBookmarksDialog::OnNewBookmark()
 
 void ManageBookmarksDialog::OnNewFolder()
 {
+	ClearSearch();
+
 	HWND focus = GetFocus();
 
 	if (focus == GetDlgItem(m_hDlg, IDC_MANAGEBOOKMARKS_LISTVIEW))
@@ -700,6 +730,8 @@ void ManageBookmarksDialog::OnCopy(bool cut)
 
 void ManageBookmarksDialog::OnPaste()
 {
+	ClearSearch();
+
 	HWND focus = GetFocus();
 	size_t targetIndex;
 
@@ -766,6 +798,9 @@ void ManageBookmarksDialog::OnListViewNavigation(BookmarkItem *bookmarkFolder, b
 	m_currentBookmarkFolder = bookmarkFolder;
 	m_bookmarkTreeView->SelectFolder(bookmarkFolder->GetGUID());
 
+	// Navigating to a folder (e.g. by opening a folder from the search results) ends the search.
+	ClearSearch();
+
 	UpdateToolbarState();
 }
 
@@ -776,6 +811,37 @@ void ManageBookmarksDialog::UpdateToolbarState()
 		m_navigationController->CanGoForward());
 }
 
+void ManageBookmarksDialog::OnSearchTextChanged()
+{
+	std::wstring query = GetDlgItemString(m_hDlg, IDC_MANAGEBOOKMARKS_SEARCH);
+
+	if (query.empty())
+	{
+		if (m_bookmarkListView->IsShowingSearchResults())
+		{
+			m_bookmarkListView->NavigateToBookmarkFolder(m_currentBookmarkFolder, false);
+		}
+
+		return;
+	}
+
+	m_bookmarkListView->ShowSearchResults(m_bookmarkSearchIndex->Search(query, MAX_SEARCH_RESULTS));
+}
+
+void ManageBookmarksDialog::ClearSearch()
+{
+	HWND searchEdit = GetDlgItem(m_hDlg, IDC_MANAGEBOOKMARKS_SEARCH);
+
+	if (GetWindowTextLength(searchEdit) == 0)
+	{
+		return;
+	}
+
+	// This will result in an EN_CHANGE notification, which will cause the contents of the
+	// current folder to be shown again.
+	SetWindowText(searchEdit, L"");
+}
+
 void ManageBookmarksDialog::OnOk()
 {
 	DestroyWindow(m_hDlg);
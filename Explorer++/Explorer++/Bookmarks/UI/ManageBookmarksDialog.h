@@ -13,6 +13,7 @@
 #include <unordered_set>
 
 class BookmarkNavigationController;
+class BookmarkSearchIndex;
 class BookmarkTree;
 class BookmarkTreeView;
 class CoreInterface;
@@ -50,7 +51,8 @@ class ManageBookmarksDialog : public DarkModeDialogBase
 {
 public:
 	ManageBookmarksDialog(HINSTANCE hInstance, HWND hParent, CoreInterface *coreInterface,
-		Navigator *navigator, IconFetcher *iconFetcher, BookmarkTree *bookmarkTree);
+		Navigator *navigator, IconFetcher *iconFetcher, BookmarkTree *bookmarkTree,
+		BookmarkSearchIndex *bookmarkSearchIndex);
 	~ManageBookmarksDialog();
 
 protected:
@@ -71,6 +73,8 @@ private:
 	static const int TOOLBAR_ID_ORGANIZE = 10002;
 	static const int TOOLBAR_ID_VIEWS = 10003;
 
+	static const int MAX_SEARCH_RESULTS = 1000;
+
 	ManageBookmarksDialog &operator=(const ManageBookmarksDialog &mbd);
 
 	void GetResizableControlInformation(BaseDialog::DialogSizeConstraint &dsc,
@@ -79,6 +83,7 @@ private:
 	void SetupToolbar();
 	void SetupTreeView();
 	void SetupListView();
+	void SetupSearchEdit();
 
 	LRESULT CALLBACK ParentWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 	std::optional<LRESULT> OnToolbarCustomDraw(NMTBCUSTOMDRAW *customDraw);
@@ -88,6 +93,9 @@ private:
 
 	void UpdateToolbarState();
 
+	void OnSearchTextChanged();
+	void ClearSearch();
+
 	LRESULT HandleMenuOrAccelerator(WPARAM wParam);
 
 	void OnTbnDropDown(NMTOOLBAR *nmtb);
@@ -121,6 +129,7 @@ private:
 	IconFetcher *m_iconFetcher;
 
 	BookmarkTree *m_bookmarkTree;
+	BookmarkSearchIndex *m_bookmarkSearchIndex;
 
 	BookmarkItem *m_currentBookmarkFolder;
 
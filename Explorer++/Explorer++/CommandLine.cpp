@@ -9,6 +9,7 @@
 #include "MainResource.h"
 #include "ResourceHelper.h"
 #include "../Helper/SetDefaultFileManager.h"
+#include "../Helper/TraceRecorder.h"
 #include "../Helper/WindowHelper.h"
 #include <boost/log/core.hpp>
 #include <CLI/App.hpp>
@@ -144,6 +145,11 @@ std::variant<CommandLine::Settings, CommandLine::ExitInfo> CommandLine::ProcessC
 		   "path will be opened in a separate tab.")
 		->allow_extra_args(false);
 
+	app.add_option("--trace-file", settings.traceFile,
+		"Record the time taken by startup and navigation and, on exit, write the results to the "
+		"specified file. The file uses the Chrome trace event format and can be viewed in "
+		"chrome://tracing or https://ui.perfetto.dev.");
+
 	app.add_option("directories", settings.directories, "Directories to open");
 
 	int numArgs;
@@ -261,6 +267,11 @@ std::optional<CommandLine::ExitInfo> ProcessCommandLineFlags(const CLI::App &app
 		boost::log::core::get()->set_logging_enabled(true);
 	}
 
+	if (!settings.traceFile.empty())
+	{
+		TraceRecorder::GetInstance().SetEnabled(true);
+	}
+
 	if (immediatelyHandledOptions.removeAsDefault)
 	{
 		OnUpdateReplaceExplorerSetting(ReplaceExplorerMode::None);
@@ -17,6 +17,7 @@ struct Settings
 	bool createJumplistTab;
 	std::vector<std::wstring> filesToSelect;
 	std::vector<std::wstring> directories;
+	std::wstring traceFile;
 };
 
 struct ExitInfo
@@ -0,0 +1,587 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "CompareFoldersDialog.h"
+#include "CoreInterface.h"
+#include "IconResourceLoader.h"
+#include "MainResource.h"
+#include "Navigator.h"
+#include "ResourceHelper.h"
+#include "../Helper/DpiCompatibility.h"
+#include "../Helper/Helper.h"
+#include "../Helper/ShellHelper.h"
+#include "../Helper/StringHelper.h"
+#include "../Helper/WindowHelper.h"
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+
+const int WM_APP_COMPARE_FINISHED = WM_APP + 1;
+
+enum class ColumnType
+{
+	Name,
+	Result,
+	LeftSize,
+	LeftModified,
+	RightSize,
+	RightModified
+};
+
+struct ColumnInfo
+{
+	ColumnType type;
+	UINT stringId;
+	double widthFraction;
+};
+
+const ColumnInfo COLUMNS[] = { { ColumnType::Name, IDS_COMPAREFOLDERS_COLUMN_NAME, 0.3 },
+	{ ColumnType::Result, IDS_COMPAREFOLDERS_COLUMN_RESULT, 0.14 },
+	{ ColumnType::LeftSize, IDS_COMPAREFOLDERS_COLUMN_LEFT_SIZE, 0.1 },
+	{ ColumnType::LeftModified, IDS_COMPAREFOLDERS_COLUMN_LEFT_MODIFIED, 0.17 },
+	{ ColumnType::RightSize, IDS_COMPAREFOLDERS_COLUMN_RIGHT_SIZE, 0.1 },
+	{ ColumnType::RightModified, IDS_COMPAREFOLDERS_COLUMN_RIGHT_MODIFIED, 0.17 } };
+
+UINT GetDifferenceStringId(FolderComparer::Difference difference)
+{
+	switch (difference)
+	{
+	case FolderComparer::Difference::LeftOnly:
+		return IDS_COMPAREFOLDERS_LEFT_ONLY;
+
+	case FolderComparer::Difference::RightOnly:
+		return IDS_COMPAREFOLDERS_RIGHT_ONLY;
+
+	case FolderComparer::Difference::LeftNewer:
+		return IDS_COMPAREFOLDERS_LEFT_NEWER;
+
+	case FolderComparer::Difference::RightNewer:
+		return IDS_COMPAREFOLDERS_RIGHT_NEWER;
+
+	case FolderComparer::Difference::ContentsDiffer:
+		return IDS_COMPAREFOLDERS_CONTENTS_DIFFER;
+
+	case FolderComparer::Difference::TypeDiffers:
+		return IDS_COMPAREFOLDERS_TYPE_DIFFERS;
+
+	case FolderComparer::Difference::Unknown:
+		return IDS_COMPAREFOLDERS_UNKNOWN;
+
+	case FolderComparer::Difference::Same:
+		return IDS_COMPAREFOLDERS_SAME;
+	}
+
+	assert(false);
+	return IDS_COMPAREFOLDERS_SAME;
+}
+
+int CALLBACK BrowseCallbackProc(HWND hwnd, UINT uMsg, LPARAM lParam, LPARAM lpData)
+{
+	UNREFERENCED_PARAMETER(lParam);
+
+	switch (uMsg)
+	{
+	case BFFM_INITIALIZED:
+		SendMessage(hwnd, BFFM_SETSELECTION, TRUE, lpData);
+		break;
+	}
+
+	return 0;
+}
+
+}
+
+CompareFoldersDialog::CompareFoldersDialog(HINSTANCE hInstance, HWND hParent,
+	std::wstring_view leftDirectory, bool showFriendlyDates, CoreInterface *coreInterface,
+	Navigator *navigator) :
+	DarkModeDialogBase(hInstance, IDD_COMPAREFOLDERS, hParent, true),
+	m_leftDirectory(leftDirectory),
+	m_showFriendlyDates(showFriendlyDates),
+	m_coreInterface(coreInterface),
+	m_navigator(navigator)
+{
+}
+
+CompareFoldersDialog::~CompareFoldersDialog()
+{
+	if (m_compareThread.joinable())
+	{
+		m_comparer->Cancel();
+		m_compareThread.join();
+	}
+}
+
+INT_PTR CompareFoldersDialog::OnInitDialog()
+{
+	UINT dpi = DpiCompatibility::GetInstance().GetDpiForWindow(m_hDlg);
+	m_directoryIcon =
+		m_coreInterface->GetIconResourceLoader()->LoadIconFromPNGForDpi(Icon::Folder, 16, 16, dpi);
+
+	for (int browseId : { IDC_COMPAREFOLDERS_LEFT_BROWSE, IDC_COMPAREFOLDERS_RIGHT_BROWSE })
+	{
+		SendDlgItemMessage(m_hDlg, browseId, BM_SETIMAGE, IMAGE_ICON,
+			reinterpret_cast<LPARAM>(m_directoryIcon.get()));
+	}
+
+	HWND listView = GetDlgItem(m_hDlg, IDC_COMPAREFOLDERS_LISTVIEW);
+
+	ListView_SetExtendedListViewStyleEx(listView,
+		LVS_EX_GRIDLINES | LVS_EX_DOUBLEBUFFER | LVS_EX_FULLROWSELECT,
+		LVS_EX_GRIDLINES | LVS_EX_DOUBLEBUFFER | LVS_EX_FULLROWSELECT);
+
+	SetWindowTheme(listView, L"Explorer", nullptr);
+
+	RECT rc;
+	GetClientRect(listView, &rc);
+
+	int index = 0;
+
+	for (const auto &column : COLUMNS)
+	{
+		std::wstring text = ResourceHelper::LoadString(GetInstance(), column.stringId);
+
+		LVCOLUMN lvColumn;
+		lvColumn.mask = LVCF_TEXT | LVCF_WIDTH;
+		lvColumn.pszText = text.data();
+		lvColumn.cx = static_cast<int>(column.widthFraction * GetRectWidth(&rc));
+		ListView_InsertColumn(listView, index++, &lvColumn);
+	}
+
+	SetDlgItemText(m_hDlg, IDC_COMPAREFOLDERS_LEFT, m_leftDirectory.c_str());
+	m_compareButtonText = GetWindowString(GetDlgItem(m_hDlg, IDC_COMPAREFOLDERS_COMPARE));
+
+	SetFocus(GetDlgItem(m_hDlg, IDC_COMPAREFOLDERS_RIGHT));
+
+	AllowDarkModeForControls({ IDC_COMPAREFOLDERS_LEFT_BROWSE, IDC_COMPAREFOLDERS_RIGHT_BROWSE,
+		IDC_COMPAREFOLDERS_COMPARE, IDCANCEL });
+	AllowDarkModeForCheckboxes({ IDC_COMPAREFOLDERS_CONTENTS });
+	AllowDarkModeForListView(IDC_COMPAREFOLDERS_LISTVIEW);
+
+	return FALSE;
+}
+
+wil::unique_hicon CompareFoldersDialog::GetDialogIcon(int iconWidth, int iconHeight) const
+{
+	return m_coreInterface->GetIconResourceLoader()->LoadIconFromPNGAndScale(Icon::Folder,
+		iconWidth, iconHeight);
+}
+
+void CompareFoldersDialog::GetResizableControlInformation(BaseDialog::DialogSizeConstraint &dsc,
+	std::list<ResizableDialog::Control> &ControlList)
+{
+	dsc = BaseDialog::DialogSizeConstraint::None;
+
+	ResizableDialog::Control control;
+
+	for (int editId : { IDC_COMPAREFOLDERS_LEFT, IDC_COMPAREFOLDERS_RIGHT })
+	{
+		control.iID = editId;
+		control.Type = ResizableDialog::ControlType::Resize;
+		control.Constraint = ResizableDialog::ControlConstraint::X;
+		ControlList.push_back(control);
+	}
+
+	for (int browseId : { IDC_COMPAREFOLDERS_LEFT_BROWSE, IDC_COMPAREFOLDERS_RIGHT_BROWSE })
+	{
+		control.iID = browseId;
+		control.Type = ResizableDialog::ControlType::Move;
+		control.Constraint = ResizableDialog::ControlConstraint::X;
+		ControlList.push_back(control);
+	}
+
+	control.iID = IDC_COMPAREFOLDERS_LISTVIEW;
+	control.Type = ResizableDialog::ControlType::Resize;
+	control.Constraint = ResizableDialog::ControlConstraint::None;
+	ControlList.push_back(control);
+
+	for (int footerId : { IDC_COMPAREFOLDERS_STATUS, IDC_COMPAREFOLDERS_ETCHEDHORZ })
+	{
+		control.iID = footerId;
+		control.Type = ResizableDialog::ControlType::Move;
+		control.Constraint = ResizableDialog::ControlConstraint::Y;
+		ControlList.push_back(control);
+
+		control.iID = footerId;
+		control.Type = ResizableDialog::ControlType::Resize;
+		control.Constraint = ResizableDialog::ControlConstraint::X;
+		ControlList.push_back(control);
+	}
+
+	control.iID = IDC_COMPAREFOLDERS_COMPARE;
+	control.Type = ResizableDialog::ControlType::Move;
+	control.Constraint = ResizableDialog::ControlConstraint::None;
+	ControlList.push_back(control);
+
+	control.iID = IDCANCEL;
+	control.Type = ResizableDialog::ControlType::Move;
+	control.Constraint = ResizableDialog::ControlConstraint::None;
+	ControlList.push_back(control);
+}
+
+INT_PTR CompareFoldersDialog::OnCommand(WPARAM wParam, LPARAM lParam)
+{
+	UNREFERENCED_PARAMETER(lParam);
+
+	switch (LOWORD(wParam))
+	{
+	case IDC_COMPAREFOLDERS_COMPARE:
+		OnCompare();
+		break;
+
+	case IDC_COMPAREFOLDERS_LEFT_BROWSE:
+		OnBrowse(IDC_COMPAREFOLDERS_LEFT);
+		break;
+
+	case IDC_COMPAREFOLDERS_RIGHT_BROWSE:
+		OnBrowse(IDC_COMPAREFOLDERS_RIGHT);
+		break;
+
+	case IDCANCEL:
+		DestroyWindow(m_hDlg);
+		break;
+	}
+
+	return 0;
+}
+
+void CompareFoldersDialog::OnCompare()
+{
+	if (!m_comparing)
+	{
+		StartComparing();
+	}
+	else
+	{
+		StopComparing();
+	}
+}
+
+void CompareFoldersDialog::StartComparing()
+{
+	std::wstring leftText = GetWindowString(GetDlgItem(m_hDlg, IDC_COMPAREFOLDERS_LEFT));
+	std::wstring rightText = GetWindowString(GetDlgItem(m_hDlg, IDC_COMPAREFOLDERS_RIGHT));
+	boost::trim(leftText);
+	boost::trim(rightText);
+
+	std::error_code error;
+
+	if (leftText.empty() || rightText.empty()
+		|| !std::filesystem::is_directory(std::filesystem::path(leftText), error)
+		|| !std::filesystem::is_directory(std::filesystem::path(rightText), error))
+	{
+		SetDlgItemText(m_hDlg, IDC_COMPAREFOLDERS_STATUS,
+			ResourceHelper::LoadString(GetInstance(), IDS_COMPAREFOLDERS_INVALID_FOLDER).c_str());
+		return;
+	}
+
+	m_leftRoot = leftText;
+	m_rightRoot = rightText;
+
+	m_items.clear();
+	ListView_SetItemCount(GetDlgItem(m_hDlg, IDC_COMPAREFOLDERS_LISTVIEW), 0);
+
+	FolderComparer::Options options;
+	options.compareContents =
+		IsDlgButtonChecked(m_hDlg, IDC_COMPAREFOLDERS_CONTENTS) == BST_CHECKED;
+
+	m_comparer = std::make_unique<FolderComparer>(options);
+	m_comparing = true;
+	m_stopping = false;
+
+	m_compareThread = std::thread(
+		[this, hDlg = m_hDlg]()
+		{
+			m_comparer->Compare(m_leftRoot, m_rightRoot,
+				[this](std::vector<FolderComparer::Item> &&items)
+				{
+					std::scoped_lock lock(m_pendingItemsMutex);
+
+					// Only the differences are shown.
+					for (auto &item : items)
+					{
+						if (item.difference != FolderComparer::Difference::Same)
+						{
+							m_pendingItems.push_back(std::move(item));
+						}
+					}
+				});
+
+			PostMessage(hDlg, WM_APP_COMPARE_FINISHED, 0, 0);
+		});
+
+	SetDlgItemText(m_hDlg, IDC_COMPAREFOLDERS_COMPARE,
+		ResourceHelper::LoadString(GetInstance(), IDS_STOP).c_str());
+
+	UpdateProgress();
+	SetTimer(m_hDlg, PROGRESS_TIMER_ID, PROGRESS_TIMER_ELAPSED, nullptr);
+}
+
+void CompareFoldersDialog::StopComparing()
+{
+	m_stopping = true;
+	m_comparer->Cancel();
+}
+
+INT_PTR CompareFoldersDialog::OnTimer(int iTimerID)
+{
+	if (iTimerID == PROGRESS_TIMER_ID)
+	{
+		AddPendingItems();
+		UpdateProgress();
+	}
+
+	return 0;
+}
+
+// Items are added to the end of the list, so the items that are already visible don't move.
+void CompareFoldersDialog::AddPendingItems()
+{
+	std::vector<FolderComparer::Item> pendingItems;
+
+	{
+		std::scoped_lock lock(m_pendingItemsMutex);
+		pendingItems = std::move(m_pendingItems);
+		m_pendingItems.clear();
+	}
+
+	if (pendingItems.empty())
+	{
+		return;
+	}
+
+	std::move(pendingItems.begin(), pendingItems.end(), std::back_inserter(m_items));
+	ListView_SetItemCountEx(GetDlgItem(m_hDlg, IDC_COMPAREFOLDERS_LISTVIEW),
+		static_cast<int>(m_items.size()), LVSICF_NOINVALIDATEALL | LVSICF_NOSCROLL);
+}
+
+void CompareFoldersDialog::UpdateProgress()
+{
+	std::wstring statusTemplate =
+		ResourceHelper::LoadString(GetInstance(), IDS_COMPAREFOLDERS_COMPARING);
+	std::wstring status =
+		(boost::wformat(statusTemplate) % m_comparer->GetProgress().itemsCompared).str();
+	SetDlgItemText(m_hDlg, IDC_COMPAREFOLDERS_STATUS, status.c_str());
+}
+
+INT_PTR CompareFoldersDialog::OnPrivateMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+	UNREFERENCED_PARAMETER(wParam);
+	UNREFERENCED_PARAMETER(lParam);
+
+	switch (uMsg)
+	{
+	case WM_APP_COMPARE_FINISHED:
+		OnCompareFinished();
+		break;
+	}
+
+	return 0;
+}
+
+void CompareFoldersDialog::OnCompareFinished()
+{
+	m_compareThread.join();
+	KillTimer(m_hDlg, PROGRESS_TIMER_ID);
+
+	AddPendingItems();
+
+	// Now that every item is available, the items are shown in the order they appear in the
+	// tree.
+	std::sort(m_items.begin(), m_items.end(),
+		[](const FolderComparer::Item &item1, const FolderComparer::Item &item2)
+		{
+			return item1.path < item2.path;
+		});
+
+	HWND listView = GetDlgItem(m_hDlg, IDC_COMPAREFOLDERS_LISTVIEW);
+	ListView_SetItemCountEx(listView, static_cast<int>(m_items.size()), 0);
+	InvalidateRect(listView, nullptr, FALSE);
+
+	std::wstring status;
+
+	if (m_stopping)
+	{
+		status = ResourceHelper::LoadString(GetInstance(), IDS_COMPAREFOLDERS_CANCELLED);
+	}
+	else
+	{
+		std::wstring statusTemplate =
+			ResourceHelper::LoadString(GetInstance(), IDS_COMPAREFOLDERS_FINISHED);
+		status = (boost::wformat(statusTemplate) % m_comparer->GetProgress().itemsCompared
+			% m_items.size())
+					 .str();
+
+		if (auto numErrors = m_comparer->GetNumErrors(); numErrors > 0)
+		{
+			std::wstring errorsTemplate =
+				ResourceHelper::LoadString(GetInstance(), IDS_COMPAREFOLDERS_ERRORS);
+			status += L" " + (boost::wformat(errorsTemplate) % numErrors).str();
+		}
+	}
+
+	SetDlgItemText(m_hDlg, IDC_COMPAREFOLDERS_STATUS, status.c_str());
+	SetDlgItemText(m_hDlg, IDC_COMPAREFOLDERS_COMPARE, m_compareButtonText.c_str());
+
+	m_comparing = false;
+	m_stopping = false;
+}
+
+void CompareFoldersDialog::OnBrowse(int editId)
+{
+	std::wstring title =
+		ResourceHelper::LoadString(GetInstance(), IDS_COMPAREFOLDERS_BROWSE_TITLE);
+	std::wstring initialDirectory = GetWindowString(GetDlgItem(m_hDlg, editId));
+
+	TCHAR displayName[MAX_PATH];
+
+	BROWSEINFO bi;
+	bi.hwndOwner = m_hDlg;
+	bi.pidlRoot = nullptr;
+	bi.pszDisplayName = displayName;
+	bi.lpszTitle = title.c_str();
+	bi.ulFlags = BIF_RETURNONLYFSDIRS | BIF_NEWDIALOGSTYLE;
+	bi.lpfn = BrowseCallbackProc;
+	bi.lParam = reinterpret_cast<LPARAM>(initialDirectory.c_str());
+	unique_pidl_absolute pidl(SHBrowseForFolder(&bi));
+
+	if (pidl != nullptr)
+	{
+		std::wstring parsingPath;
+		GetDisplayName(pidl.get(), SHGDN_FORPARSING, parsingPath);
+		SetDlgItemText(m_hDlg, editId, parsingPath.c_str());
+	}
+}
+
+INT_PTR CompareFoldersDialog::OnNotify(NMHDR *pnmhdr)
+{
+	if (pnmhdr->idFrom != IDC_COMPAREFOLDERS_LISTVIEW)
+	{
+		return 0;
+	}
+
+	switch (pnmhdr->code)
+	{
+	case LVN_GETDISPINFO:
+		OnGetDispInfo(reinterpret_cast<NMLVDISPINFO *>(pnmhdr));
+		break;
+
+	case NM_DBLCLK:
+		OnOpenItem(reinterpret_cast<NMITEMACTIVATE *>(pnmhdr)->iItem);
+		break;
+	}
+
+	return 0;
+}
+
+void CompareFoldersDialog::OnGetDispInfo(NMLVDISPINFO *dispInfo)
+{
+	if (WI_IsFlagClear(dispInfo->item.mask, LVIF_TEXT) || dispInfo->item.iItem < 0
+		|| static_cast<size_t>(dispInfo->item.iItem) >= m_items.size()
+		|| dispInfo->item.iSubItem >= static_cast<int>(std::size(COLUMNS)))
+	{
+		return;
+	}
+
+	const auto &item = m_items[dispInfo->item.iItem];
+	std::wstring text;
+
+	switch (COLUMNS[dispInfo->item.iSubItem].type)
+	{
+	case ColumnType::Name:
+		text = item.path.wstring();
+		break;
+
+	case ColumnType::Result:
+		text = ResourceHelper::LoadString(GetInstance(), GetDifferenceStringId(item.difference));
+		break;
+
+	case ColumnType::LeftSize:
+		text = FormatItemInfo(item.left, false);
+		break;
+
+	case ColumnType::LeftModified:
+		text = FormatItemInfo(item.left, true);
+		break;
+
+	case ColumnType::RightSize:
+		text = FormatItemInfo(item.right, false);
+		break;
+
+	case ColumnType::RightModified:
+		text = FormatItemInfo(item.right, true);
+		break;
+	}
+
+	StringCchCopy(dispInfo->item.pszText, dispInfo->item.cchTextMax, text.c_str());
+}
+
+// Directories, and items that don't exist on one side, have no size or modification time shown.
+std::wstring CompareFoldersDialog::FormatItemInfo(
+	const std::optional<FolderComparer::ItemInfo> &info, bool modificationTime) const
+{
+	if (!info || info->isDirectory)
+	{
+		return {};
+	}
+
+	if (!modificationTime)
+	{
+		ULARGE_INTEGER size;
+		size.QuadPart = info->size;
+
+		TCHAR sizeText[32];
+		FormatSizeString(size, sizeText, SIZEOF_ARRAY(sizeText));
+		return sizeText;
+	}
+
+	// file_time_type counts 100 nanosecond intervals since 1601, the same as FILETIME does.
+	ULARGE_INTEGER time;
+	time.QuadPart = info->modificationTime.time_since_epoch().count();
+
+	FILETIME fileTime;
+	fileTime.dwLowDateTime = time.LowPart;
+	fileTime.dwHighDateTime = time.HighPart;
+
+	TCHAR timeText[64];
+	CreateFileTimeString(&fileTime, timeText, SIZEOF_ARRAY(timeText), m_showFriendlyDates);
+	return timeText;
+}
+
+void CompareFoldersDialog::OnOpenItem(int index)
+{
+	if (index < 0 || static_cast<size_t>(index) >= m_items.size())
+	{
+		return;
+	}
+
+	// Items are opened from the left side, unless they only exist on the right.
+	const auto &item = m_items[index];
+	auto path = (item.left ? m_leftRoot : m_rightRoot) / item.path;
+
+	unique_pidl_absolute pidl;
+	HRESULT hr = SHParseDisplayName(path.c_str(), nullptr, wil::out_param(pidl), 0, nullptr);
+
+	if (hr == S_OK)
+	{
+		m_navigator->OpenItem(pidl.get());
+	}
+}
+
+INT_PTR CompareFoldersDialog::OnClose()
+{
+	DestroyWindow(m_hDlg);
+	return 0;
+}
+
+INT_PTR CompareFoldersDialog::OnNcDestroy()
+{
+	delete this;
+
+	return 0;
+}
@@ -0,0 +1,79 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "DarkModeDialogBase.h"
+#include "../Helper/FolderComparer.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class CoreInterface;
+class Navigator;
+
+// Compares two folders and lists the items that differ between them. Each row shows the item on
+// both sides, so that the list can be read as a preview of what a sync would need to do. Items are
+// added to the list as each directory is compared, with the list being sorted once the comparison
+// is complete.
+class CompareFoldersDialog : public DarkModeDialogBase
+{
+public:
+	CompareFoldersDialog(HINSTANCE hInstance, HWND hParent, std::wstring_view leftDirectory,
+		bool showFriendlyDates, CoreInterface *coreInterface, Navigator *navigator);
+	~CompareFoldersDialog();
+
+protected:
+	INT_PTR OnInitDialog() override;
+	INT_PTR OnTimer(int iTimerID) override;
+	INT_PTR OnCommand(WPARAM wParam, LPARAM lParam) override;
+	INT_PTR OnNotify(NMHDR *pnmhdr) override;
+	INT_PTR OnClose() override;
+	INT_PTR OnNcDestroy() override;
+
+	INT_PTR OnPrivateMessage(UINT uMsg, WPARAM wParam, LPARAM lParam) override;
+
+	wil::unique_hicon GetDialogIcon(int iconWidth, int iconHeight) const override;
+
+private:
+	static const int PROGRESS_TIMER_ID = 0;
+	static const int PROGRESS_TIMER_ELAPSED = 200;
+
+	void GetResizableControlInformation(BaseDialog::DialogSizeConstraint &dsc,
+		std::list<ResizableDialog::Control> &ControlList) override;
+
+	void OnCompare();
+	void StartComparing();
+	void StopComparing();
+	void OnCompareFinished();
+	void OnBrowse(int editId);
+	void OnGetDispInfo(NMLVDISPINFO *dispInfo);
+	void OnOpenItem(int index);
+	void AddPendingItems();
+	void UpdateProgress();
+	std::wstring FormatItemInfo(const std::optional<FolderComparer::ItemInfo> &info,
+		bool modificationTime) const;
+
+	std::wstring m_leftDirectory;
+	const bool m_showFriendlyDates;
+	CoreInterface *m_coreInterface;
+	Navigator *m_navigator;
+	wil::unique_hicon m_directoryIcon;
+	std::wstring m_compareButtonText;
+
+	std::unique_ptr<FolderComparer> m_comparer;
+	std::thread m_compareThread;
+	bool m_comparing = false;
+	bool m_stopping = false;
+	std::filesystem::path m_leftRoot;
+	std::filesystem::path m_rightRoot;
+
+	// Items are added here by the comparer's threads and moved into the list by the timer.
+	std::mutex m_pendingItemsMutex;
+	std::vector<FolderComparer::Item> m_pendingItems;
+
+	std::vector<FolderComparer::Item> m_items;
+};
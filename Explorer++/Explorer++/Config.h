@@ -75,6 +75,7 @@ struct Config
 		displayWindowVertical = FALSE;
 		treeViewWidth = DEFAULT_TREEVIEW_WIDTH;
 		checkPinnedToNamespaceTreeProperty = false;
+		useBuiltInFileTransfer = false;
 		shellChangeNotificationType = ShellChangeNotificationType::Disabled;
 
 		replaceExplorerMode = DefaultFileManager::ReplaceExplorerMode::None;
@@ -91,6 +92,8 @@ struct Config
 		extendTabControl.set(FALSE);
 		forceSameTabWidth.set(FALSE);
 		openTabsInForeground = false;
+		hibernateTabsAfterMinutes = DEFAULT_HIBERNATE_TABS_AFTER_MINUTES;
+		maxLoadedTabs = 0;
 
 		displayWindowSurroundColor = Gdiplus::Color(0, 94, 138);
 		displayWindowCentreColor = Gdiplus::Color(255, 255, 255);
@@ -146,6 +149,8 @@ struct Config
 
 	static const UINT DEFAULT_TREEVIEW_WIDTH = 208;
 
+	static const UINT DEFAULT_HIBERNATE_TABS_AFTER_MINUTES = 30;
+
 	DWORD language;
 	IconTheme iconTheme;
 	bool enableDarkMode;
@@ -182,6 +187,11 @@ struct Config
 	BOOL displayWindowVertical;
 	unsigned int treeViewWidth;
 	bool checkPinnedToNamespaceTreeProperty;
+
+	// If set, items copied or moved with the "Copy To Folder" and "Move To Folder" commands will
+	// be transferred by FileTransferEngine, rather than the shell.
+	bool useBuiltInFileTransfer;
+
 	ShellChangeNotificationType shellChangeNotificationType;
 
 	DefaultFileManager::ReplaceExplorerMode replaceExplorerMode;
@@ -201,6 +211,12 @@ struct Config
 	ValueWrapper<BOOL> forceSameTabWidth;
 	bool openTabsInForeground;
 
+	// Background tabs that haven't been used for this number of minutes will be hibernated. If
+	// more than maxLoadedTabs tabs are loaded, the least recently used tabs will be hibernated as
+	// well. A value of 0 disables the corresponding limit.
+	unsigned int hibernateTabsAfterMinutes;
+	unsigned int maxLoadedTabs;
+
 	// Display window
 	Gdiplus::Color displayWindowCentreColor;
 	Gdiplus::Color displayWindowSurroundColor;
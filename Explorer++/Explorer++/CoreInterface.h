@@ -30,9 +30,10 @@ using FocusChangedSignal = boost::signals2::signal<void(WindowFocusSource window
 using ApplicationShuttingDownSignal = boost::signals2::signal<void()>;
 
 class CachedIcons;
+class ChecksumService;
 struct Config;
+class DirectoryWatchRegistry;
 class IconResourceLoader;
-__interface IDirectoryMonitor;
 class ShellBrowser;
 class StatusBar;
 class TabContainer;
@@ -57,10 +58,11 @@ public:
 
 	virtual TabContainer *GetTabContainer() const = 0;
 	virtual TabRestorer *GetTabRestorer() const = 0;
-	virtual IDirectoryMonitor *GetDirectoryMonitor() const = 0;
+	virtual DirectoryWatchRegistry *GetDirectoryWatchRegistry() const = 0;
 
 	virtual IconResourceLoader *GetIconResourceLoader() const = 0;
 	virtual CachedIcons *GetCachedIcons() = 0;
+	virtual ChecksumService *GetChecksumService() = 0;
 
 	virtual HWND GetTreeView() const = 0;
 
@@ -60,7 +60,10 @@ static const Column_t REAL_FOLDER_DEFAULT_COLUMNS[] ={
 	{ColumnType::MediaProducer, FALSE, DEFAULT_COLUMN_WIDTH},
 	{ColumnType::MediaPublisher, FALSE, DEFAULT_COLUMN_WIDTH},
 	{ColumnType::MediaWriter, FALSE, DEFAULT_COLUMN_WIDTH},
-	{ColumnType::MediaYear, FALSE, DEFAULT_COLUMN_WIDTH}
+	{ColumnType::MediaYear, FALSE, DEFAULT_COLUMN_WIDTH},
+	{ColumnType::Crc32c, FALSE, DEFAULT_COLUMN_WIDTH},
+	{ColumnType::XxHash64, FALSE, DEFAULT_COLUMN_WIDTH},
+	{ColumnType::Sha256, FALSE, DEFAULT_COLUMN_WIDTH}
 };
 
 static const Column_t MY_COMPUTER_DEFAULT_COLUMNS[] = {
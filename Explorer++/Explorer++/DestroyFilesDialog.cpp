@@ -6,12 +6,20 @@
 #include "DestroyFilesDialog.h"
 #include "Explorer++_internal.h"
 #include "MainResource.h"
+#include "ResourceHelper.h"
 #include "../Helper/Helper.h"
 #include "../Helper/Macros.h"
 #include "../Helper/RegistrySettings.h"
 #include "../Helper/StringHelper.h"
 #include "../Helper/XMLSettings.h"
 
+namespace
+{
+
+const int WM_APP_DESTROY_FINISHED = WM_APP + 1;
+
+}
+
 const TCHAR DestroyFilesDialogPersistentSettings::SETTINGS_KEY[] = _T("DestroyFiles");
 
 const TCHAR DestroyFilesDialogPersistentSettings::SETTING_OVERWRITE_METHOD[] =
@@ -27,6 +35,15 @@ DestroyFilesDialog::DestroyFilesDialog(HINSTANCE hInstance, HWND hParent,
 	m_pdfdps = &DestroyFilesDialogPersistentSettings::GetInstance();
 }
 
+DestroyFilesDialog::~DestroyFilesDialog()
+{
+	if (m_shredThread.joinable())
+	{
+		m_shredder->Cancel();
+		m_shredThread.join();
+	}
+}
+
 INT_PTR DestroyFilesDialog::OnInitDialog()
 {
 	m_icon.reset(LoadIcon(GetModuleHandle(nullptr), MAKEINTRESOURCE(IDI_MAIN)));
@@ -75,7 +92,6 @@ INT_PTR DestroyFilesDialog::OnInitDialog()
 
 		StringCchCopy(szFullFilename, SIZEOF_ARRAY(szFullFilename), strFullFilename.c_str());
 
-		/* TODO: Perform in background thread. */
 		SHFILEINFO shfi;
 		SHGetFileInfo(szFullFilename, 0, &shfi, sizeof(shfi), SHGFI_SYSICONINDEX | SHGFI_TYPENAME);
 
@@ -173,6 +189,16 @@ void DestroyFilesDialog::GetResizableControlInformation(BaseDialog::DialogSizeCo
 	control.Constraint = ResizableDialog::ControlConstraint::X;
 	ControlList.push_back(control);
 
+	control.iID = IDC_DESTROYFILES_PROGRESS;
+	control.Type = ResizableDialog::ControlType::Move;
+	control.Constraint = ResizableDialog::ControlConstraint::Y;
+	ControlList.push_back(control);
+
+	control.iID = IDC_DESTROYFILES_PROGRESS;
+	control.Type = ResizableDialog::ControlType::Resize;
+	control.Constraint = ResizableDialog::ControlConstraint::X;
+	ControlList.push_back(control);
+
 	control.iID = IDOK;
 	control.Type = ResizableDialog::ControlType::Move;
 	control.Constraint = ResizableDialog::ControlConstraint::None;
@@ -216,7 +242,31 @@ INT_PTR DestroyFilesDialog::OnCommand(WPARAM wParam, LPARAM lParam)
 
 INT_PTR DestroyFilesDialog::OnClose()
 {
-	EndDialog(m_hDlg, 0);
+	OnCancel();
+	return 0;
+}
+
+INT_PTR DestroyFilesDialog::OnTimer(int iTimerID)
+{
+	if (iTimerID == PROGRESS_TIMER_ID)
+	{
+		UpdateProgress();
+	}
+
+	return 0;
+}
+
+INT_PTR DestroyFilesDialog::OnPrivateMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+	UNREFERENCED_PARAMETER(lParam);
+
+	switch (uMsg)
+	{
+	case WM_APP_DESTROY_FINISHED:
+		OnDestroyFinished(static_cast<bool>(wParam));
+		break;
+	}
+
 	return 0;
 }
 
@@ -238,6 +288,11 @@ void DestroyFilesDialog::SaveState()
 
 void DestroyFilesDialog::OnOk()
 {
+	if (m_destroying)
+	{
+		return;
+	}
+
 	TCHAR szConfirmation[128];
 	LoadString(GetInstance(), IDS_DESTROY_FILES_CONFIRMATION, szConfirmation,
 		SIZEOF_ARRAY(szConfirmation));
@@ -261,6 +316,15 @@ void DestroyFilesDialog::OnOk()
 
 void DestroyFilesDialog::OnCancel()
 {
+	// Any file that's currently being overwritten will be left in place. The dialog will then be
+	// closed once the background thread has stopped.
+	if (m_destroying)
+	{
+		m_shredder->Cancel();
+		EnableWindow(GetDlgItem(m_hDlg, IDCANCEL), FALSE);
+		return;
+	}
+
 	EndDialog(m_hDlg, 0);
 }
 
@@ -277,13 +341,68 @@ void DestroyFilesDialog::OnConfirmDestroy()
 		overwriteMethod = NFileOperations::OverwriteMethod::ThreePass;
 	}
 
-	/* TODO: Perform in background thread. */
-	for (const auto &strFullFilename : m_FullFilenameList)
+	FileShredder::Options options;
+	options.overwriteMethod = overwriteMethod;
+
+	std::vector<std::wstring> paths(m_FullFilenameList.begin(), m_FullFilenameList.end());
+
+	m_shredder = std::make_unique<FileShredder>(options);
+	m_destroying = true;
+
+	for (int id : { IDOK, IDC_DESTROYFILES_RADIO_ONEPASS, IDC_DESTROYFILES_RADIO_THREEPASS })
+	{
+		EnableWindow(GetDlgItem(m_hDlg, id), FALSE);
+	}
+
+	SendDlgItemMessage(m_hDlg, IDC_DESTROYFILES_PROGRESS, PBM_SETRANGE32, 0, PROGRESS_RANGE);
+	SendDlgItemMessage(m_hDlg, IDC_DESTROYFILES_PROGRESS, PBM_SETPOS, 0, 0);
+
+	m_shredThread = std::thread(
+		[this, hDlg = m_hDlg, paths = std::move(paths)]()
+		{
+			bool res = m_shredder->ShredItems(paths,
+				[this](const FileShredder::Progress &progress)
+				{
+					m_bytesWritten = progress.bytesWritten;
+					m_totalBytes = progress.totalBytes;
+				});
+
+			PostMessage(hDlg, WM_APP_DESTROY_FINISHED, res, 0);
+		});
+
+	SetTimer(m_hDlg, PROGRESS_TIMER_ID, PROGRESS_TIMER_ELAPSED, nullptr);
+}
+
+void DestroyFilesDialog::UpdateProgress()
+{
+	ULONGLONG totalBytes = m_totalBytes;
+	int position = 0;
+
+	if (totalBytes > 0)
+	{
+		position = static_cast<int>(m_bytesWritten * PROGRESS_RANGE / totalBytes);
+	}
+
+	SendDlgItemMessage(m_hDlg, IDC_DESTROYFILES_PROGRESS, PBM_SETPOS, position, 0);
+}
+
+void DestroyFilesDialog::OnDestroyFinished(bool succeeded)
+{
+	m_shredThread.join();
+	KillTimer(m_hDlg, PROGRESS_TIMER_ID);
+
+	m_destroying = false;
+
+	if (!succeeded && !m_shredder->IsCancelled())
 	{
-		DeleteFileSecurely(strFullFilename, overwriteMethod);
+		UpdateProgress();
+
+		std::wstring message = ResourceHelper::LoadString(GetInstance(), IDS_DESTROY_FILES_ERROR);
+		MessageBox(m_hDlg, message.c_str(), NExplorerplusplus::APP_NAME,
+			MB_ICONWARNING | MB_SETFOREGROUND | MB_OK);
 	}
 
-	EndDialog(m_hDlg, 1);
+	EndDialog(m_hDlg, succeeded ? 1 : 0);
 }
 
 DestroyFilesDialogPersistentSettings::DestroyFilesDialogPersistentSettings() :
@@ -7,8 +7,12 @@
 #include "DarkModeDialogBase.h"
 #include "../Helper/DialogSettings.h"
 #include "../Helper/FileOperations.h"
+#include "../Helper/FileShredder.h"
 #include "../Helper/ResizableDialog.h"
 #include <wil/resource.h>
+#include <atomic>
+#include <memory>
+#include <thread>
 
 class DestroyFilesDialog;
 
@@ -43,14 +47,22 @@ class DestroyFilesDialog : public DarkModeDialogBase
 public:
 	DestroyFilesDialog(HINSTANCE hInstance, HWND hParent,
 		const std::list<std::wstring> &FullFilenameList, BOOL bShowFriendlyDates);
+	~DestroyFilesDialog();
 
 protected:
 	INT_PTR OnInitDialog() override;
+	INT_PTR OnTimer(int iTimerID) override;
 	INT_PTR OnCtlColorStaticExtra(HWND hwnd, HDC hdc) override;
 	INT_PTR OnCommand(WPARAM wParam, LPARAM lParam) override;
 	INT_PTR OnClose() override;
 
+	INT_PTR OnPrivateMessage(UINT uMsg, WPARAM wParam, LPARAM lParam) override;
+
 private:
+	static const int PROGRESS_TIMER_ID = 0;
+	static const int PROGRESS_TIMER_ELAPSED = 200;
+	static const int PROGRESS_RANGE = 1000;
+
 	void GetResizableControlInformation(BaseDialog::DialogSizeConstraint &dsc,
 		std::list<ResizableDialog::Control> &ControlList) override;
 	void SaveState() override;
@@ -58,6 +70,8 @@ private:
 	void OnOk();
 	void OnCancel();
 	void OnConfirmDestroy();
+	void OnDestroyFinished(bool succeeded);
+	void UpdateProgress();
 
 	std::list<std::wstring> m_FullFilenameList;
 
@@ -66,4 +80,12 @@ private:
 	DestroyFilesDialogPersistentSettings *m_pdfdps;
 
 	BOOL m_bShowFriendlyDates;
+
+	// The items are destroyed on a background thread, with the progress it reports being shown by
+	// the timer.
+	std::unique_ptr<FileShredder> m_shredder;
+	std::thread m_shredThread;
+	bool m_destroying = false;
+	std::atomic<ULONGLONG> m_bytesWritten = 0;
+	std::atomic<ULONGLONG> m_totalBytes = 0;
 };
@@ -0,0 +1,504 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "DuplicateFilesDialog.h"
+#include "CoreInterface.h"
+#include "IconResourceLoader.h"
+#include "MainResource.h"
+#include "Navigator.h"
+#include "ResourceHelper.h"
+#include "../Helper/DpiCompatibility.h"
+#include "../Helper/Helper.h"
+#include "../Helper/ShellHelper.h"
+#include "../Helper/StringHelper.h"
+#include "../Helper/WindowHelper.h"
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+
+namespace
+{
+
+const int WM_APP_FIND_FINISHED = WM_APP + 1;
+
+const int NUM_COLUMNS = 4;
+
+struct ColumnInfo
+{
+	UINT stringId;
+	double widthFraction;
+};
+
+const ColumnInfo COLUMNS[NUM_COLUMNS] = { { IDS_DUPLICATEFILES_COLUMN_NAME, 0.25 },
+	{ IDS_DUPLICATEFILES_COLUMN_FOLDER, 0.45 }, { IDS_DUPLICATEFILES_COLUMN_SIZE, 0.15 },
+	{ IDS_DUPLICATEFILES_COLUMN_GROUP, 0.1 } };
+
+std::wstring FormatSize(std::uintmax_t size)
+{
+	ULARGE_INTEGER largeSize;
+	largeSize.QuadPart = size;
+
+	TCHAR sizeText[32];
+	FormatSizeString(largeSize, sizeText, SIZEOF_ARRAY(sizeText));
+
+	return sizeText;
+}
+
+int CALLBACK BrowseCallbackProc(HWND hwnd, UINT uMsg, LPARAM lParam, LPARAM lpData)
+{
+	UNREFERENCED_PARAMETER(lParam);
+
+	switch (uMsg)
+	{
+	case BFFM_INITIALIZED:
+		SendMessage(hwnd, BFFM_SETSELECTION, TRUE, lpData);
+		break;
+	}
+
+	return 0;
+}
+
+}
+
+DuplicateFilesDialog::DuplicateFilesDialog(HINSTANCE hInstance, HWND hParent,
+	std::wstring_view searchDirectory, CoreInterface *coreInterface, Navigator *navigator) :
+	DarkModeDialogBase(hInstance, IDD_DUPLICATEFILES, hParent, true),
+	m_searchDirectory(searchDirectory),
+	m_coreInterface(coreInterface),
+	m_navigator(navigator)
+{
+}
+
+DuplicateFilesDialog::~DuplicateFilesDialog()
+{
+	if (m_findThread.joinable())
+	{
+		m_finder->Cancel();
+		m_findThread.join();
+	}
+}
+
+INT_PTR DuplicateFilesDialog::OnInitDialog()
+{
+	UINT dpi = DpiCompatibility::GetInstance().GetDpiForWindow(m_hDlg);
+	m_directoryIcon =
+		m_coreInterface->GetIconResourceLoader()->LoadIconFromPNGForDpi(Icon::Folder, 16, 16, dpi);
+	SendDlgItemMessage(m_hDlg, IDC_DUPLICATEFILES_BROWSE, BM_SETIMAGE, IMAGE_ICON,
+		reinterpret_cast<LPARAM>(m_directoryIcon.get()));
+
+	HWND listView = GetDlgItem(m_hDlg, IDC_DUPLICATEFILES_LISTVIEW);
+
+	ListView_SetExtendedListViewStyleEx(listView,
+		LVS_EX_GRIDLINES | LVS_EX_DOUBLEBUFFER | LVS_EX_FULLROWSELECT,
+		LVS_EX_GRIDLINES | LVS_EX_DOUBLEBUFFER | LVS_EX_FULLROWSELECT);
+
+	SetWindowTheme(listView, L"Explorer", nullptr);
+
+	RECT rc;
+	GetClientRect(listView, &rc);
+
+	for (int i = 0; i < NUM_COLUMNS; i++)
+	{
+		std::wstring text = ResourceHelper::LoadString(GetInstance(), COLUMNS[i].stringId);
+
+		LVCOLUMN lvColumn;
+		lvColumn.mask = LVCF_TEXT | LVCF_WIDTH;
+		lvColumn.pszText = text.data();
+		lvColumn.cx = static_cast<int>(COLUMNS[i].widthFraction * GetRectWidth(&rc));
+		ListView_InsertColumn(listView, i, &lvColumn);
+	}
+
+	SetDlgItemText(m_hDlg, IDC_DUPLICATEFILES_FOLDERS, m_searchDirectory.c_str());
+	m_findButtonText = GetWindowString(GetDlgItem(m_hDlg, IDC_DUPLICATEFILES_FIND));
+
+	SetFocus(GetDlgItem(m_hDlg, IDC_DUPLICATEFILES_FOLDERS));
+
+	AllowDarkModeForControls({ IDC_DUPLICATEFILES_BROWSE, IDC_DUPLICATEFILES_FIND, IDCANCEL });
+	AllowDarkModeForListView(IDC_DUPLICATEFILES_LISTVIEW);
+
+	return FALSE;
+}
+
+wil::unique_hicon DuplicateFilesDialog::GetDialogIcon(int iconWidth, int iconHeight) const
+{
+	return m_coreInterface->GetIconResourceLoader()->LoadIconFromPNGAndScale(Icon::Search,
+		iconWidth, iconHeight);
+}
+
+void DuplicateFilesDialog::GetResizableControlInformation(BaseDialog::DialogSizeConstraint &dsc,
+	std::list<ResizableDialog::Control> &ControlList)
+{
+	dsc = BaseDialog::DialogSizeConstraint::None;
+
+	ResizableDialog::Control control;
+
+	control.iID = IDC_DUPLICATEFILES_FOLDERS;
+	control.Type = ResizableDialog::ControlType::Resize;
+	control.Constraint = ResizableDialog::ControlConstraint::X;
+	ControlList.push_back(control);
+
+	control.iID = IDC_DUPLICATEFILES_BROWSE;
+	control.Type = ResizableDialog::ControlType::Move;
+	control.Constraint = ResizableDialog::ControlConstraint::X;
+	ControlList.push_back(control);
+
+	control.iID = IDC_DUPLICATEFILES_LISTVIEW;
+	control.Type = ResizableDialog::ControlType::Resize;
+	control.Constraint = ResizableDialog::ControlConstraint::None;
+	ControlList.push_back(control);
+
+	control.iID = IDC_DUPLICATEFILES_STATUS;
+	control.Type = ResizableDialog::ControlType::Move;
+	control.Constraint = ResizableDialog::ControlConstraint::Y;
+	ControlList.push_back(control);
+
+	control.iID = IDC_DUPLICATEFILES_STATUS;
+	control.Type = ResizableDialog::ControlType::Resize;
+	control.Constraint = ResizableDialog::ControlConstraint::X;
+	ControlList.push_back(control);
+
+	control.iID = IDC_DUPLICATEFILES_ETCHEDHORZ;
+	control.Type = ResizableDialog::ControlType::Move;
+	control.Constraint = ResizableDialog::ControlConstraint::Y;
+	ControlList.push_back(control);
+
+	control.iID = IDC_DUPLICATEFILES_ETCHEDHORZ;
+	control.Type = ResizableDialog::ControlType::Resize;
+	control.Constraint = ResizableDialog::ControlConstraint::X;
+	ControlList.push_back(control);
+
+	control.iID = IDC_DUPLICATEFILES_FIND;
+	control.Type = ResizableDialog::ControlType::Move;
+	control.Constraint = ResizableDialog::ControlConstraint::None;
+	ControlList.push_back(control);
+
+	control.iID = IDCANCEL;
+	control.Type = ResizableDialog::ControlType::Move;
+	control.Constraint = ResizableDialog::ControlConstraint::None;
+	ControlList.push_back(control);
+}
+
+INT_PTR DuplicateFilesDialog::OnCommand(WPARAM wParam, LPARAM lParam)
+{
+	UNREFERENCED_PARAMETER(lParam);
+
+	switch (LOWORD(wParam))
+	{
+	case IDC_DUPLICATEFILES_FIND:
+		OnFind();
+		break;
+
+	case IDC_DUPLICATEFILES_BROWSE:
+		OnBrowse();
+		break;
+
+	case IDCANCEL:
+		DestroyWindow(m_hDlg);
+		break;
+	}
+
+	return 0;
+}
+
+void DuplicateFilesDialog::OnFind()
+{
+	if (!m_finding)
+	{
+		StartFinding();
+	}
+	else
+	{
+		StopFinding();
+	}
+}
+
+void DuplicateFilesDialog::StartFinding()
+{
+	auto directories = GetDirectories();
+
+	if (directories.empty())
+	{
+		return;
+	}
+
+	m_groups.clear();
+	m_rows.clear();
+	ListView_SetItemCount(GetDlgItem(m_hDlg, IDC_DUPLICATEFILES_LISTVIEW), 0);
+
+	m_finder = std::make_unique<DuplicateFinder>(DuplicateFinder::Options{});
+	m_finding = true;
+	m_stopping = false;
+
+	m_findThread = std::thread(
+		[this, directories = std::move(directories), hDlg = m_hDlg]()
+		{
+			m_foundGroups = m_finder->Find(directories);
+			PostMessage(hDlg, WM_APP_FIND_FINISHED, 0, 0);
+		});
+
+	SetDlgItemText(m_hDlg, IDC_DUPLICATEFILES_FIND,
+		ResourceHelper::LoadString(GetInstance(), IDS_STOP).c_str());
+
+	UpdateProgress();
+	SetTimer(m_hDlg, PROGRESS_TIMER_ID, PROGRESS_TIMER_ELAPSED, nullptr);
+}
+
+void DuplicateFilesDialog::StopFinding()
+{
+	m_stopping = true;
+	m_finder->Cancel();
+}
+
+// Multiple folders can be entered, separated by semicolons.
+std::vector<std::filesystem::path> DuplicateFilesDialog::GetDirectories() const
+{
+	std::wstring text = GetWindowString(GetDlgItem(m_hDlg, IDC_DUPLICATEFILES_FOLDERS));
+
+	std::vector<std::wstring> parts;
+	boost::split(parts, text, boost::is_any_of(L";"));
+
+	std::vector<std::filesystem::path> directories;
+
+	for (auto &part : parts)
+	{
+		boost::trim(part);
+
+		if (!part.empty())
+		{
+			directories.emplace_back(part);
+		}
+	}
+
+	return directories;
+}
+
+INT_PTR DuplicateFilesDialog::OnTimer(int iTimerID)
+{
+	if (iTimerID == PROGRESS_TIMER_ID)
+	{
+		UpdateProgress();
+	}
+
+	return 0;
+}
+
+void DuplicateFilesDialog::UpdateProgress()
+{
+	auto progress = m_finder->GetProgress();
+	std::wstring status;
+
+	switch (progress.stage)
+	{
+	case DuplicateFinder::Stage::Scanning:
+	{
+		std::wstring statusTemplate =
+			ResourceHelper::LoadString(GetInstance(), IDS_DUPLICATEFILES_SCANNING);
+		status = (boost::wformat(statusTemplate) % progress.filesFound).str();
+	}
+	break;
+
+	case DuplicateFinder::Stage::HashingSamples:
+	case DuplicateFinder::Stage::HashingContents:
+	{
+		std::wstring statusTemplate = ResourceHelper::LoadString(GetInstance(),
+			progress.stage == DuplicateFinder::Stage::HashingSamples
+				? IDS_DUPLICATEFILES_HASHING_SAMPLES
+				: IDS_DUPLICATEFILES_HASHING_CONTENTS);
+		status =
+			(boost::wformat(statusTemplate) % progress.filesHashed % progress.filesToHash).str();
+	}
+	break;
+
+	case DuplicateFinder::Stage::Complete:
+		return;
+	}
+
+	SetDlgItemText(m_hDlg, IDC_DUPLICATEFILES_STATUS, status.c_str());
+}
+
+INT_PTR DuplicateFilesDialog::OnPrivateMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+	UNREFERENCED_PARAMETER(wParam);
+	UNREFERENCED_PARAMETER(lParam);
+
+	switch (uMsg)
+	{
+	case WM_APP_FIND_FINISHED:
+		OnFindFinished();
+		break;
+	}
+
+	return 0;
+}
+
+void DuplicateFilesDialog::OnFindFinished()
+{
+	m_findThread.join();
+	KillTimer(m_hDlg, PROGRESS_TIMER_ID);
+
+	m_groups = std::move(m_foundGroups);
+	m_foundGroups.clear();
+
+	std::uintmax_t wastedSpace = 0;
+	size_t numFiles = 0;
+
+	for (size_t i = 0; i < m_groups.size(); i++)
+	{
+		const auto &group = m_groups[i];
+
+		for (auto file : group.files)
+		{
+			m_rows.push_back({ i, file });
+		}
+
+		wastedSpace += group.size * (group.files.size() - 1);
+		numFiles += group.files.size();
+	}
+
+	// The listview only requests the text for the rows that are actually visible.
+	ListView_SetItemCountEx(GetDlgItem(m_hDlg, IDC_DUPLICATEFILES_LISTVIEW),
+		static_cast<int>(m_rows.size()), 0);
+
+	std::wstring status;
+
+	if (m_stopping)
+	{
+		status = ResourceHelper::LoadString(GetInstance(), IDS_DUPLICATEFILES_CANCELLED);
+	}
+	else
+	{
+		std::wstring statusTemplate =
+			ResourceHelper::LoadString(GetInstance(), IDS_DUPLICATEFILES_FINISHED);
+		status = (boost::wformat(statusTemplate) % numFiles % m_groups.size()
+			% FormatSize(wastedSpace))
+					 .str();
+
+		if (auto numErrors = m_finder->GetNumErrors(); numErrors > 0)
+		{
+			std::wstring errorsTemplate =
+				ResourceHelper::LoadString(GetInstance(), IDS_DUPLICATEFILES_ERRORS);
+			status += L" " + (boost::wformat(errorsTemplate) % numErrors).str();
+		}
+	}
+
+	SetDlgItemText(m_hDlg, IDC_DUPLICATEFILES_STATUS, status.c_str());
+	SetDlgItemText(m_hDlg, IDC_DUPLICATEFILES_FIND, m_findButtonText.c_str());
+
+	m_finding = false;
+	m_stopping = false;
+}
+
+void DuplicateFilesDialog::OnBrowse()
+{
+	std::wstring title =
+		ResourceHelper::LoadString(GetInstance(), IDS_DUPLICATEFILES_BROWSE_TITLE);
+
+	// If multiple folders have been entered, the first one is initially selected.
+	auto directories = GetDirectories();
+	std::wstring initialDirectory = directories.empty() ? L"" : directories[0].wstring();
+
+	TCHAR displayName[MAX_PATH];
+
+	BROWSEINFO bi;
+	bi.hwndOwner = m_hDlg;
+	bi.pidlRoot = nullptr;
+	bi.pszDisplayName = displayName;
+	bi.lpszTitle = title.c_str();
+	bi.ulFlags = BIF_RETURNONLYFSDIRS | BIF_NEWDIALOGSTYLE;
+	bi.lpfn = BrowseCallbackProc;
+	bi.lParam = reinterpret_cast<LPARAM>(initialDirectory.c_str());
+	unique_pidl_absolute pidl(SHBrowseForFolder(&bi));
+
+	if (pidl != nullptr)
+	{
+		std::wstring parsingPath;
+		GetDisplayName(pidl.get(), SHGDN_FORPARSING, parsingPath);
+		SetDlgItemText(m_hDlg, IDC_DUPLICATEFILES_FOLDERS, parsingPath.c_str());
+	}
+}
+
+INT_PTR DuplicateFilesDialog::OnNotify(NMHDR *pnmhdr)
+{
+	if (pnmhdr->idFrom != IDC_DUPLICATEFILES_LISTVIEW)
+	{
+		return 0;
+	}
+
+	switch (pnmhdr->code)
+	{
+	case LVN_GETDISPINFO:
+		OnGetDispInfo(reinterpret_cast<NMLVDISPINFO *>(pnmhdr));
+		break;
+
+	case NM_DBLCLK:
+		OnOpenItem(reinterpret_cast<NMITEMACTIVATE *>(pnmhdr)->iItem);
+		break;
+	}
+
+	return 0;
+}
+
+void DuplicateFilesDialog::OnGetDispInfo(NMLVDISPINFO *dispInfo)
+{
+	if (WI_IsFlagClear(dispInfo->item.mask, LVIF_TEXT) || dispInfo->item.iItem < 0
+		|| static_cast<size_t>(dispInfo->item.iItem) >= m_rows.size())
+	{
+		return;
+	}
+
+	const auto &row = m_rows[dispInfo->item.iItem];
+	std::wstring text;
+
+	switch (dispInfo->item.iSubItem)
+	{
+	case 0:
+		text = m_finder->GetPath(row.file).filename().wstring();
+		break;
+
+	case 1:
+		text = m_finder->GetPath(row.file).parent_path().wstring();
+		break;
+
+	case 2:
+		text = FormatSize(m_finder->GetSize(row.file));
+		break;
+
+	case 3:
+		text = std::to_wstring(row.groupIndex + 1);
+		break;
+	}
+
+	StringCchCopy(dispInfo->item.pszText, dispInfo->item.cchTextMax, text.c_str());
+}
+
+void DuplicateFilesDialog::OnOpenItem(int index)
+{
+	if (index < 0 || static_cast<size_t>(index) >= m_rows.size())
+	{
+		return;
+	}
+
+	auto path = m_finder->GetPath(m_rows[index].file);
+
+	unique_pidl_absolute pidl;
+	HRESULT hr = SHParseDisplayName(path.c_str(), nullptr, wil::out_param(pidl), 0, nullptr);
+
+	if (hr == S_OK)
+	{
+		m_navigator->OpenItem(pidl.get());
+	}
+}
+
+INT_PTR DuplicateFilesDialog::OnClose()
+{
+	DestroyWindow(m_hDlg);
+	return 0;
+}
+
+INT_PTR DuplicateFilesDialog::OnNcDestroy()
+{
+	delete this;
+
+	return 0;
+}
@@ -0,0 +1,82 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "DarkModeDialogBase.h"
+#include "../Helper/DuplicateFinder.h"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class CoreInterface;
+class Navigator;
+
+// Searches a set of folders for files with identical contents. The search runs on a background
+// thread, with the results shown in a virtual listview. Since the listview only requests the
+// items that are visible, very large result sets can be shown without copying each path into the
+// control.
+class DuplicateFilesDialog : public DarkModeDialogBase
+{
+public:
+	DuplicateFilesDialog(HINSTANCE hInstance, HWND hParent, std::wstring_view searchDirectory,
+		CoreInterface *coreInterface, Navigator *navigator);
+	~DuplicateFilesDialog();
+
+protected:
+	INT_PTR OnInitDialog() override;
+	INT_PTR OnTimer(int iTimerID) override;
+	INT_PTR OnCommand(WPARAM wParam, LPARAM lParam) override;
+	INT_PTR OnNotify(NMHDR *pnmhdr) override;
+	INT_PTR OnClose() override;
+	INT_PTR OnNcDestroy() override;
+
+	INT_PTR OnPrivateMessage(UINT uMsg, WPARAM wParam, LPARAM lParam) override;
+
+	wil::unique_hicon GetDialogIcon(int iconWidth, int iconHeight) const override;
+
+private:
+	static const int PROGRESS_TIMER_ID = 0;
+	static const int PROGRESS_TIMER_ELAPSED = 200;
+
+	// Each row in the listview refers to a single file within one of the groups.
+	struct Row
+	{
+		size_t groupIndex;
+		DuplicateFinder::FileId file;
+	};
+
+	void GetResizableControlInformation(BaseDialog::DialogSizeConstraint &dsc,
+		std::list<ResizableDialog::Control> &ControlList) override;
+
+	void OnFind();
+	void StartFinding();
+	void StopFinding();
+	void OnFindFinished();
+	void OnBrowse();
+	void OnGetDispInfo(NMLVDISPINFO *dispInfo);
+	void OnOpenItem(int index);
+	void UpdateProgress();
+	std::vector<std::filesystem::path> GetDirectories() const;
+
+	std::wstring m_searchDirectory;
+	CoreInterface *m_coreInterface;
+	Navigator *m_navigator;
+	wil::unique_hicon m_directoryIcon;
+	std::wstring m_findButtonText;
+
+	// The finder is kept once the search has finished, since it's used to retrieve the path of
+	// each file.
+	std::unique_ptr<DuplicateFinder> m_finder;
+	std::thread m_findThread;
+	bool m_finding = false;
+	bool m_stopping = false;
+
+	// Written by the background thread and only read once that thread has finished.
+	std::vector<DuplicateFinder::Group> m_foundGroups;
+
+	std::vector<DuplicateFinder::Group> m_groups;
+	std::vector<Row> m_rows;
+};
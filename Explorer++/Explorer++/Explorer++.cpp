@@ -12,8 +12,11 @@
 #include "Explorer++_internal.h"
 #include "MenuRanges.h"
 #include "Plugins/PluginManager.h"
+#include "TabHibernator.h"
 #include "TabRestorerUI.h"
 #include "UiTheming.h"
+#include "../Helper/DirectoryListingExporter.h"
+#include "../Helper/FileTransferEngine.h"
 #include "../Helper/WindowSubclassWrapper.h"
 #include "../Helper/iDirectoryMonitor.h"
 
@@ -34,9 +37,11 @@ Explorerplusplus::Explorerplusplus(HWND hwnd, CommandLine::Settings *commandLine
 	m_hContainer(hwnd),
 	m_commandLineSettings(*commandLineSettings),
 	m_cachedIcons(MAX_CACHED_ICONS),
+	m_checksumService(NUM_CHECKSUM_THREADS, MAX_CACHED_CHECKSUMS),
 	m_pluginMenuManager(hwnd, MENU_PLUGIN_STARTID, MENU_PLUGIN_ENDID),
 	m_acceleratorUpdater(&g_hAccl),
 	m_pluginCommandManager(&g_hAccl, ACCELERATOR_PLUGIN_STARTID, ACCELERATOR_PLUGIN_ENDID),
+	m_bookmarkSearchIndex(&m_bookmarkTree),
 	m_bookmarkIconFetcher(hwnd, &m_cachedIcons),
 	m_tabBarBackgroundBrush(CreateSolidBrush(TAB_BAR_DARK_MODE_BACKGROUND_COLOR))
 {
@@ -70,5 +75,28 @@ Explorerplusplus::Explorerplusplus(HWND hwnd, CommandLine::Settings *commandLine
 
 Explorerplusplus::~Explorerplusplus()
 {
+	// Once a save has been written, the bookmark journal is trimmed, so any save that's still
+	// pending has to finish while the journal exists.
+	m_xmlSettingsSaver.reset();
+
+	if (m_fileTransferThread.joinable())
+	{
+		m_fileTransferEngine->Cancel();
+		m_fileTransferThread.join();
+		EndFileTransfer();
+	}
+
+	if (m_directoryListingThread.joinable())
+	{
+		m_directoryListingExporter->Cancel();
+		m_directoryListingThread.join();
+	}
+
+	// Notifications are delivered on the directory monitor's worker thread, which is stopped when
+	// the monitor is released. Releasing the monitor first means that a notification can't arrive
+	// once the registry has been destroyed. The remaining watches go away along with the monitor,
+	// so the registry doesn't need to stop them individually.
 	m_pDirMon->Release();
+	m_pDirMon = nullptr;
+	m_directoryWatchRegistry.reset();
 }
@@ -6,6 +6,8 @@
 
 #include "AcceleratorUpdater.h"
 #include "ApplicationModel.h"
+#include "Bookmarks/BookmarkJournal.h"
+#include "Bookmarks/BookmarkSearchIndex.h"
 #include "Bookmarks/BookmarkTree.h"
 #include "CommandLine.h"
 #include "CoreInterface.h"
@@ -18,7 +20,10 @@
 #include "Tab.h"
 #include "TabNavigationInterface.h"
 #include "ValueWrapper.h"
+#include "../Helper/BackgroundFileSaver.h"
 #include "../Helper/CachedIcons.h"
+#include "../Helper/ChecksumService.h"
+#include "../Helper/DirectoryWatchRegistry.h"
 #include "../Helper/DropHandler.h"
 #include "../Helper/FileActionHandler.h"
 #include "../Helper/FileContextMenuManager.h"
@@ -26,10 +31,20 @@
 #include <boost/signals2.hpp>
 #include <wil/resource.h>
 #include <optional>
+#include <thread>
 
 /* Sent when a folder size calculation has finished. */
 #define WM_APP_FOLDERSIZECOMPLETED WM_APP + 3
 
+/* Sent when a built-in file transfer has finished. */
+#define WM_APP_FILETRANSFERCOMPLETED WM_APP + 4
+
+/* Sent when the plan for a built-in file transfer has been built. */
+#define WM_APP_FILETRANSFERPLANNED WM_APP + 5
+
+/* Sent when a directory listing has been saved. */
+#define WM_APP_DIRECTORYLISTINGSAVED WM_APP + 6
+
 /* Private definitions. */
 #define FROM_LISTVIEW 0
 #define FROM_TREEVIEW 1
@@ -40,7 +55,10 @@ class BookmarksMainMenu;
 class BookmarksToolbar;
 struct ColumnWidth;
 struct Config;
+class DirectoryListingExporter;
 class DrivesToolbar;
+class FileTransferEngine;
+struct FileTransferPlan;
 class IconResourceLoader;
 __interface IDirectoryMonitor;
 class ILoadSave;
@@ -51,12 +69,13 @@ class MainWindow;
 class ShellBrowser;
 class ShellTreeView;
 class TabContainer;
+class TabHibernator;
 class TabRestorer;
 class TabRestorerUI;
-struct TabSettings;
 class TaskbarThumbnails;
 class UiTheming;
 class WindowSubclassWrapper;
+class XmlPullParser;
 
 namespace Applications
 {
@@ -123,10 +142,27 @@ private:
 	static const UINT_PTR LISTVIEW_ITEM_CHANGED_TIMER_ID = 100001;
 	static const UINT LISTVIEW_ITEM_CHANGED_TIMEOUT = 50;
 
+	// Changes to settings often arrive in bursts (e.g. each page in the options dialog requests a
+	// save when the dialog is closed), so saves are delayed slightly, with each request restarting
+	// the delay.
+	static const UINT_PTR SAVE_SETTINGS_TIMER_ID = 100002;
+	static const UINT SAVE_SETTINGS_DELAY = 1000;
+
+	static const UINT_PTR HIBERNATE_TABS_TIMER_ID = 100003;
+	static const UINT HIBERNATE_TABS_INTERVAL = 60000;
+
+	static const UINT_PTR FILE_TRANSFER_PROGRESS_TIMER_ID = 100004;
+	static const UINT FILE_TRANSFER_PROGRESS_INTERVAL = 500;
+
 	// Represents the maximum number of icons that can be cached. This cache is
 	// shared between various components in the application.
 	static const int MAX_CACHED_ICONS = 1000;
 
+	// Checksums are calculated by a single service that's shared between tabs, so that a
+	// checksum calculated in one tab can be reused by any other.
+	static const int NUM_CHECKSUM_THREADS = 4;
+	static const int MAX_CACHED_CHECKSUMS = 10000;
+
 	static inline constexpr COLORREF TAB_BAR_DARK_MODE_BACKGROUND_COLOR = RGB(25, 25, 25);
 
 	static inline const int CLOSE_TOOLBAR_WIDTH = 24;
@@ -137,11 +173,12 @@ private:
 		UINT uFrom;
 	};
 
-	struct DirectoryAltered
+	// Passed to the directory monitor for each watch started on behalf of the directory watch
+	// registry. Freed by the directory monitor once the watch has been stopped.
+	struct DirectoryWatchContext
 	{
-		int iIndex;
-		int iFolderIndex;
-		void *pData;
+		DirectoryWatchRegistry *registry;
+		int watchId;
 	};
 
 	struct DWFolderSizeCompletion
@@ -200,7 +237,8 @@ private:
 	/* Main menu handlers. */
 	void OnNewTab();
 	bool OnCloseTab();
-	void OnSaveDirectoryListing() const;
+	void OnSaveDirectoryListing();
+	void OnDirectoryListingSaved();
 	void OnCloneWindow();
 	void OnCopyItemPath() const;
 	void OnCopyUniversalPaths() const;
@@ -227,6 +265,8 @@ private:
 	void OnSplitFile();
 	void OnDestroyFiles();
 	void OnSearch();
+	void OnFindDuplicateFiles();
+	void OnCompareFolders();
 	void OnCustomizeColors();
 	void OnRunScript();
 	void OnShowOptions();
@@ -343,7 +383,11 @@ private:
 
 	/* Settings. */
 	void SaveAllSettings() override;
+	void SaveAllSettingsNow();
+	BackgroundFileSaver *GetXmlSettingsSaver();
 	void LoadAllSettings(ILoadSave **pLoadSave);
+	void LoadBookmarkJournal(const std::optional<BookmarkJournalPosition> &snapshotPosition);
+	std::wstring GetBookmarkJournalPath() const;
 	void ValidateLoadedSettings();
 	void ValidateColumns(FolderColumns &folderColumns);
 	void ValidateSingleColumnSet(int iColumnSet, std::vector<Column_t> &columns);
@@ -374,31 +418,29 @@ private:
 	void LoadDialogStatesFromRegistry();
 
 	/* XML Settings. */
-	void LoadGenericSettingsFromXML(IXMLDOMDocument *pXMLDom);
+	void LoadGenericSettingsFromXML(std::string_view xmlData);
 	void SaveGenericSettingsToXML(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pRoot);
-	int LoadTabSettingsFromXML(IXMLDOMDocument *pXMLDom);
+	int LoadTabSettingsFromXML(std::string_view xmlData);
 	void SaveTabSettingsToXML(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pRoot);
 	void SaveTabSettingsToXMLnternal(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pe);
-	int LoadColumnFromXML(IXMLDOMNode *pNode, std::vector<Column_t> &outputColumns);
 	void SaveColumnToXML(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pColumnsNode,
 		const std::vector<Column_t> &columns, const TCHAR *szColumnSet, int iIndent);
-	void LoadBookmarksFromXML(IXMLDOMDocument *pXMLDom);
-	void SaveBookmarksToXML(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pRoot);
-	void LoadDefaultColumnsFromXML(IXMLDOMDocument *pXMLDom);
+	void LoadBookmarksFromXML(std::string_view xmlData);
+	std::optional<BookmarkJournalPosition> SaveBookmarksToXML(IXMLDOMDocument *pXMLDom,
+		IXMLDOMElement *pRoot);
+	void LoadDefaultColumnsFromXML(std::string_view xmlData);
 	void SaveDefaultColumnsToXML(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pRoot);
 	void SaveDefaultColumnsToXMLInternal(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pColumnsNode);
 	void SaveWindowPositionToXML(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pRoot);
 	void SaveWindowPositionToXMLInternal(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pWndPosNode);
 	void LoadApplicationToolbarFromXML(IXMLDOMDocument *pXMLDom);
 	void SaveApplicationToolbarToXML(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pRoot);
-	void LoadToolbarInformationFromXML(IXMLDOMDocument *pXMLDom);
+	void LoadToolbarInformationFromXML(std::string_view xmlData);
 	void SaveToolbarInformationToXML(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pRoot);
 	void SaveToolbarInformationToXMLnternal(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pe);
 	void LoadDialogStatesFromXML(IXMLDOMDocument *pXMLDom);
 	void SaveDialogStatesToXML(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pRoot);
-	void MapAttributeToValue(IXMLDOMNode *pNode, WCHAR *wszName, WCHAR *wszValue);
-	void MapTabAttributeValue(WCHAR *wszName, WCHAR *wszValue, TabSettings &tabSettings,
-		FolderSettings &folderSettings);
+	void MapAttributeToValue(XmlPullParser &parser, std::string_view settingName);
 
 	/* Window state update. */
 	void UpdateWindowStates(const Tab &tab);
@@ -426,6 +468,12 @@ private:
 
 	/* File operations. */
 	void CopyToFolder(bool move);
+	bool TransferItemsToFolder(const std::wstring &title, std::vector<PCIDLIST_ABSOLUTE> &pidls,
+		bool move);
+	void OnFileTransferPlanned();
+	void UpdateFileTransferProgress();
+	void OnFileTransferCompleted();
+	void EndFileTransfer();
 	void OpenAllSelectedItems(
 		OpenFolderDisposition openFolderDisposition = OpenFolderDisposition::CurrentTab);
 	void OpenListViewItem(int index,
@@ -497,9 +545,10 @@ private:
 	TabContainer *GetTabContainer() const override;
 	TabRestorer *GetTabRestorer() const override;
 	HWND GetTreeView() const override;
-	IDirectoryMonitor *GetDirectoryMonitor() const override;
+	DirectoryWatchRegistry *GetDirectoryWatchRegistry() const override;
 	IconResourceLoader *GetIconResourceLoader() const override;
 	CachedIcons *GetCachedIcons() override;
+	ChecksumService *GetChecksumService() override;
 	BOOL GetSavePreferencesToXmlFile() const override;
 	void SetSavePreferencesToXmlFile(BOOL savePreferencesToXmlFile) override;
 	void FocusChanged(WindowFocusSource windowFocusSource) override;
@@ -528,11 +577,13 @@ private:
 
 	/* Miscellaneous. */
 	void InitializeDisplayWindow();
+	void RecoverInterruptedRenames();
 	void ShowMainRebarBand(HWND hwnd, BOOL bShow);
 	BOOL OnMouseWheel(MousewheelSource mousewheelSource, WPARAM wParam, LPARAM lParam) override;
 	StatusBar *GetStatusBar() override;
 	void StartDirectoryMonitoringForTab(const Tab &tab);
 	void StopDirectoryMonitoringForTab(const Tab &tab);
+	void OnDirectoryAltered(int tabId, int folderId, const std::wstring &fileName, DWORD action);
 	int DetermineListViewObjectIndex(HWND hListView);
 
 	static void FolderSizeCallbackStub(int nFolders, int nFiles, PULARGE_INTEGER lTotalFolderSize,
@@ -553,6 +604,7 @@ private:
 	HWND m_hTabBacking;
 
 	IDirectoryMonitor *m_pDirMon;
+	std::unique_ptr<DirectoryWatchRegistry> m_directoryWatchRegistry;
 	ShellTreeView *m_shellTreeView;
 	StatusBar *m_pStatusBar;
 
@@ -577,6 +629,7 @@ private:
 	std::unique_ptr<IconResourceLoader> m_iconResourceLoader;
 
 	CachedIcons m_cachedIcons;
+	ChecksumService m_checksumService;
 
 	MainMenuPreShowSignal m_mainMenuPreShowSignal;
 	FocusChangedSignal m_focusChangedSignal;
@@ -587,6 +640,23 @@ private:
 	wil::unique_hbrush m_tabBarBackgroundBrush;
 	std::unique_ptr<TabRestorer> m_tabRestorer;
 	std::unique_ptr<TabRestorerUI> m_tabRestorerUI;
+	std::unique_ptr<TabHibernator> m_tabHibernator;
+
+	// Transfers started with the built-in engine run on a background thread. Only a single
+	// transfer is run at a time. The plan is built first, so that the user can be asked how any
+	// existing files should be handled before anything is transferred.
+	std::unique_ptr<FileTransferEngine> m_fileTransferEngine;
+	std::thread m_fileTransferThread;
+	std::unique_ptr<FileTransferPlan> m_fileTransferPlan;
+	size_t m_fileTransferNumConflicts = 0;
+	bool m_fileTransferMove = false;
+	wil::com_ptr_nothrow<IProgressDialog> m_fileTransferProgressDialog;
+
+	// A recursive listing of a large directory tree can take a while to save, so listings are
+	// saved on a background thread. Only a single listing is saved at a time.
+	std::unique_ptr<DirectoryListingExporter> m_directoryListingExporter;
+	std::thread m_directoryListingThread;
+	bool m_directoryListingSaved = false;
 	TabsInitializedSignal m_tabsInitializedSignal;
 
 	ToolbarContextMenuSignal m_toolbarContextMenuSignal;
@@ -608,6 +678,10 @@ private:
 	std::shared_ptr<Config> m_config;
 	BOOL m_bSavePreferencesToXMLFile;
 
+	// Writes the XML configuration file in the background. Created the first time settings are
+	// saved to the file.
+	std::unique_ptr<BackgroundFileSaver> m_xmlSettingsSaver;
+
 	TaskbarThumbnails *m_taskbarThumbnails;
 
 	std::vector<std::unique_ptr<WindowSubclassWrapper>> m_windowSubclasses;
@@ -615,6 +689,16 @@ private:
 
 	/* Bookmarks. */
 	BookmarkTree m_bookmarkTree;
+
+	// This is kept up to date as bookmarks are loaded and modified, so that it's immediately
+	// available whenever the manage bookmarks dialog is opened.
+	BookmarkSearchIndex m_bookmarkSearchIndex;
+
+	// Records each change made to the bookmarks as it's made, so that changes aren't lost if the
+	// application exits before the settings are next saved. Created once the bookmarks have been
+	// loaded.
+	std::unique_ptr<BookmarkJournal> m_bookmarkJournal;
+
 	std::unique_ptr<BookmarksMainMenu> m_bookmarksMainMenu;
 	BookmarksToolbar *m_bookmarksToolbar;
 
@@ -40,6 +40,11 @@ static const TCHAR SHELL_DEFAULT_INTERNAL_COMMAND_NAME[] = _T("openinexplorer++"
 
 #define WM_APP_ASSOCCHANGED (WM_APP + 54)
 
+/* Sent to the main window when a plugin has posted
+tasks that need to run on the UI thread. The wParam
+contains the ID of the plugin. */
+#define WM_APP_PLUGINUITASKS (WM_APP + 55)
+
 /* Rebar menu id's. */
 #define ID_REBAR_MENU_BACK_START 2000
 #define ID_REBAR_MENU_BACK_END 2999
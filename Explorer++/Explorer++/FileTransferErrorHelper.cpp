@@ -0,0 +1,71 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FileTransferErrorHelper.h"
+#include "Explorer++_internal.h"
+#include "MainResource.h"
+#include "ResourceHelper.h"
+#include <boost/format.hpp>
+
+namespace
+{
+
+// As with rename errors, only the first few items are listed individually.
+const size_t MAX_LISTED_ITEMS = 10;
+
+UINT GetFileTransferErrorStringId(const std::error_code &error)
+{
+	if (error == std::errc::file_exists)
+	{
+		return IDS_FILE_TRANSFER_ERROR_EXISTS;
+	}
+	else if (error == std::errc::operation_not_supported)
+	{
+		// This is the error recorded for links to directories, which aren't followed.
+		return IDS_FILE_TRANSFER_ERROR_LINK;
+	}
+
+	return IDS_FILE_TRANSFER_ERROR_FAILED;
+}
+
+}
+
+void ShowFileTransferErrors(HWND parent, HINSTANCE resourceInstance,
+	const std::vector<FileTransferError> &errors)
+{
+	if (errors.empty())
+	{
+		return;
+	}
+
+	std::wstring message = ResourceHelper::LoadString(resourceInstance, IDS_FILE_TRANSFER_FAILED);
+	std::wstring itemTemplate =
+		ResourceHelper::LoadString(resourceInstance, IDS_FILE_TRANSFER_ERROR_ITEM);
+	size_t numListedItems = 0;
+
+	for (const auto &error : errors)
+	{
+		if (numListedItems == MAX_LISTED_ITEMS)
+		{
+			break;
+		}
+
+		std::wstring reason = ResourceHelper::LoadString(resourceInstance,
+			GetFileTransferErrorStringId(error.error));
+		message += L"\n" + (boost::wformat(itemTemplate) % error.path.wstring() % reason).str();
+
+		numListedItems++;
+	}
+
+	if (errors.size() > numListedItems)
+	{
+		std::wstring moreTemplate =
+			ResourceHelper::LoadString(resourceInstance, IDS_FILE_TRANSFER_ERRORS_MORE);
+		message +=
+			L"\n\n" + (boost::wformat(moreTemplate) % (errors.size() - numListedItems)).str();
+	}
+
+	MessageBox(parent, message.c_str(), NExplorerplusplus::APP_NAME, MB_ICONWARNING | MB_OK);
+}
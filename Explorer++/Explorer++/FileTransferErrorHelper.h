@@ -0,0 +1,13 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/FileTransferEngine.h"
+#include <vector>
+
+// Shows a single message listing each of the items that couldn't be transferred, along with the
+// reason. Does nothing if the list is empty.
+void ShowFileTransferErrors(HWND parent, HINSTANCE resourceInstance,
+	const std::vector<FileTransferError> &errors);
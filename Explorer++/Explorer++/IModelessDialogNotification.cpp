@@ -44,5 +44,13 @@ void ModelessDialogNotification::OnModelessDialogDestroy(int iResource)
 	case IDD_MANAGE_BOOKMARKS:
 		g_hwndManageBookmarks = nullptr;
 		break;
+
+	case IDD_DUPLICATEFILES:
+		g_hwndDuplicateFiles = nullptr;
+		break;
+
+	case IDD_COMPAREFOLDERS:
+		g_hwndCompareFolders = nullptr;
+		break;
 	}
 }
@@ -24,7 +24,12 @@
 #include "UiTheming.h"
 #include "ViewModeHelper.h"
 #include "../Helper/CustomGripper.h"
+#include "../Helper/Logging.h"
+#include "../Helper/Macros.h"
+#include "../Helper/ProcessHelper.h"
+#include "../Helper/TraceRecorder.h"
 #include "../Helper/iDirectoryMonitor.h"
+#include <chrono>
 
 /*
  * Main window creation.
@@ -33,12 +38,29 @@
  */
 void Explorerplusplus::OnCreate()
 {
+	TRACE_FUNCTION();
+
+	auto phaseStartTime = std::chrono::steady_clock::now();
+
+	// Logs the amount of time taken by each phase of startup, so that slow startups can be
+	// diagnosed.
+	auto logPhaseDuration = [&phaseStartTime](const std::wstring &phase)
+	{
+		auto now = std::chrono::steady_clock::now();
+		auto duration =
+			std::chrono::duration_cast<std::chrono::milliseconds>(now - phaseStartTime);
+		LOG(info) << L"Startup phase \"" << phase << L"\" took " << duration.count() << L" ms";
+		phaseStartTime = now;
+	};
+
 	InitializeMainToolbars();
 
 	ILoadSave *pLoadSave = nullptr;
 	LoadAllSettings(&pLoadSave);
 	ApplyToolbarSettings();
 
+	logPhaseDuration(L"Load settings");
+
 	m_config->shellChangeNotificationType = m_commandLineSettings.shellChangeNotificationType;
 
 	m_iconResourceLoader = std::make_unique<IconResourceLoader>(m_config->iconTheme);
@@ -59,6 +81,34 @@ void Explorerplusplus::OnCreate()
 
 	CreateDirectoryMonitor(&m_pDirMon);
 
+	m_directoryWatchRegistry = std::make_unique<DirectoryWatchRegistry>(
+		[this](int watchId, const std::wstring &path, uint32_t watchFlags, bool watchSubtree)
+		{
+			auto *context =
+				static_cast<DirectoryWatchContext *>(malloc(sizeof(DirectoryWatchContext)));
+			context->registry = m_directoryWatchRegistry.get();
+			context->watchId = watchId;
+
+			auto monitorId = m_pDirMon->WatchDirectory(path.c_str(), watchFlags,
+				DirectoryAlteredCallback, watchSubtree, context);
+
+			// The monitor only takes ownership of the context if the watch was started.
+			if (!monitorId)
+			{
+				free(context);
+			}
+
+			return monitorId;
+		},
+		[this](int monitorId)
+		{
+			// The monitor will already have been released if the registry is being destroyed.
+			if (m_pDirMon)
+			{
+				m_pDirMon->StopDirectoryMonitor(monitorId);
+			}
+		});
+
 	CreateStatusBar();
 	CreateMainControls();
 	InitializeDisplayWindow();
@@ -75,12 +125,21 @@ void Explorerplusplus::OnCreate()
 	size initially. */
 	ResizeWindows();
 
+	TCHAR processDirectory[MAX_PATH];
+	GetProcessImageName(GetCurrentProcessId(), processDirectory, SIZEOF_ARRAY(processDirectory));
+	PathRemoveFileSpec(processDirectory);
+	m_FileActionHandler.SetRenameJournalDirectory(processDirectory);
+
 	m_taskbarThumbnails =
 		TaskbarThumbnails::Create(this, m_tabContainer, m_resourceModule, m_config);
 
+	logPhaseDuration(L"Create windows");
+
 	RestoreTabs(pLoadSave);
 	delete pLoadSave;
 
+	logPhaseDuration(L"Restore tabs (" + std::to_wstring(m_tabContainer->GetNumTabs()) + L" tabs)");
+
 	// Register for any shell changes. This should be done after the tabs have
 	// been created.
 	SHChangeNotifyEntry shcne;
@@ -109,12 +168,46 @@ void Explorerplusplus::OnCreate()
 	InitializePlugins();
 
 	SetTimer(m_hContainer, AUTOSAVE_TIMER_ID, AUTOSAVE_TIMEOUT, nullptr);
+	SetTimer(m_hContainer, HIBERNATE_TABS_TIMER_ID, HIBERNATE_TABS_INTERVAL, nullptr);
+
+	logPhaseDuration(L"Initialize plugins and remaining components");
 
 	m_InitializationFinished.set(true);
+
+	RecoverInterruptedRenames();
+}
+
+// If a previous instance exited while renaming a set of files, some of the files may have been
+// left with their new names and some with their old names. In that case, the user is given the
+// option of restoring the original names.
+void Explorerplusplus::RecoverInterruptedRenames()
+{
+	for (const auto &journalPath : m_FileActionHandler.FindInterruptedRenameJournals())
+	{
+		std::wstring message =
+			ResourceHelper::LoadString(m_resourceModule, IDS_RENAME_RECOVERY_PROMPT);
+		int response = MessageBox(m_hContainer, message.c_str(), NExplorerplusplus::APP_NAME,
+			MB_ICONINFORMATION | MB_YESNO);
+
+		if (response == IDYES)
+		{
+			if (!FileActionHandler::RollBackInterruptedRename(journalPath))
+			{
+				LOG(warning) << L"Failed to restore all items listed in rename journal "
+							 << journalPath;
+			}
+		}
+		else
+		{
+			DeleteFile(journalPath.c_str());
+		}
+	}
 }
 
 void Explorerplusplus::InitializeDisplayWindow()
 {
+	TRACE_FUNCTION();
+
 	DWInitialSettings_t initialSettings;
 	initialSettings.CentreColor = m_config->displayWindowCentreColor;
 	initialSettings.SurroundColor = m_config->displayWindowSurroundColor;
@@ -167,6 +260,8 @@ void Explorerplusplus::AddViewModesToMenu(HMENU menu, UINT startPosition, BOOL b
 
 void Explorerplusplus::SetUpDarkMode()
 {
+	TRACE_FUNCTION();
+
 	auto &darkModeHelper = DarkModeHelper::GetInstance();
 	darkModeHelper.EnableForApp();
 
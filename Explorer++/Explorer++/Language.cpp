@@ -9,6 +9,7 @@
 #include "MainResource.h"
 #include "ResourceHelper.h"
 #include "../Helper/ProcessHelper.h"
+#include "../Helper/TraceRecorder.h"
 
 /*
  * Selects which language resource DLL based on user preferences and system language. The default
@@ -16,6 +17,8 @@
  */
 void Explorerplusplus::SetLanguageModule()
 {
+	TRACE_FUNCTION();
+
 	HANDLE hFindFile;
 	WIN32_FIND_DATA wfd;
 	LANGID languageId;
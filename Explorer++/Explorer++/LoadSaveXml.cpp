@@ -8,8 +8,10 @@
 // clang-format off
 #include "Explorer++.h"
 // clang-format on
-#include "Explorer++_internal.h"
-#include "../Helper/ProcessHelper.h"
+#include "XMLSettings.h"
+#include "../Helper/BackgroundFileSaver.h"
+#include "../Helper/MappedXmlFile.h"
+#include "../Helper/StringHelper.h"
 #include "../Helper/XMLSettings.h"
 #include <wil/com.h>
 #include <wil/resource.h>
@@ -41,26 +43,43 @@ LoadSaveXML::~LoadSaveXML()
 
 void LoadSaveXML::InitializeLoadEnvironment()
 {
+	m_configFile = OpenXmlConfigFile();
+}
+
+/* The application toolbar, color rules and dialog states are still
+loaded via the DOM, so the document is only loaded the first time
+one of those is requested. */
+IXMLDOMDocument *LoadSaveXML::GetLoadDocument()
+{
+	if (m_loadDocumentInitialized)
+	{
+		return m_pXMLDom.get();
+	}
+
+	m_loadDocumentInitialized = true;
+
 	m_pXMLDom.attach(NXMLSettings::DomFromCOM());
 
 	if (!m_pXMLDom)
 	{
-		return;
+		return nullptr;
 	}
 
-	TCHAR szConfigFile[MAX_PATH];
-	GetProcessImageName(GetCurrentProcessId(), szConfigFile, SIZEOF_ARRAY(szConfigFile));
-	PathRemoveFileSpec(szConfigFile);
-	PathAppend(szConfigFile, NExplorerplusplus::XML_FILENAME);
-
-	wil::unique_variant var(NXMLSettings::VariantString(NExplorerplusplus::XML_FILENAME));
+	wil::unique_variant var(NXMLSettings::VariantString(GetXmlConfigFilePath().c_str()));
 	VARIANT_BOOL status;
 	m_pXMLDom->load(var, &status);
 
-	if (status != VARIANT_TRUE)
+	return m_pXMLDom.get();
+}
+
+std::string_view LoadSaveXML::GetConfigData() const
+{
+	if (!m_configFile)
 	{
-		return;
+		return {};
 	}
+
+	return m_configFile->GetData();
 }
 
 void LoadSaveXML::InitializeSaveEnvironment()
@@ -102,62 +121,75 @@ void LoadSaveXML::ReleaseSaveEnvironment()
 	NXMLSettings::AddWhiteSpaceToNode(m_pXMLDom.get(), bstr_wsn.get(), m_pRoot.get());
 
 	wil::unique_bstr bstr;
-	m_pXMLDom->get_xml(&bstr);
+	HRESULT hr = m_pXMLDom->get_xml(&bstr);
 
-	/* To ensure the configuration file is saved to the same directory
-	as the executable, determine the fully qualified path of the executable,
-	then save the configuration file in that directory. */
-	TCHAR szConfigFile[MAX_PATH];
-	DWORD dwProcessId = GetCurrentProcessId();
-	wil::unique_process_handle process(
-		OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, dwProcessId));
-	GetModuleFileNameEx(process.get(), nullptr, szConfigFile, SIZEOF_ARRAY(szConfigFile));
-
-	PathRemoveFileSpec(szConfigFile);
-	PathAppend(szConfigFile, NExplorerplusplus::XML_FILENAME);
+	if (FAILED(hr) || !bstr)
+	{
+		return;
+	}
 
-	wil::unique_variant var(NXMLSettings::VariantString(szConfigFile));
-	m_pXMLDom->save(var);
+	/* The DOM can only be used on this thread, so the document is
+	converted to text here. That text is then encoded and written
+	out (atomically) on a background thread. Building the document
+	and calling get_xml() are the parts of a save that remain on
+	this thread. Their cost is logged by SaveAllSettingsNow() and
+	measured in BookmarkXmlStorageTest. */
+	std::wstring xml(bstr.get(), SysStringLen(bstr.get()));
+
+	m_pContainer->GetXmlSettingsSaver()->Save(
+		[xml = std::move(xml)]() -> std::optional<std::string>
+		{
+			return wstrToUtf8Str(xml);
+		},
+		[bookmarkJournal = m_pContainer->m_bookmarkJournal.get(),
+			journalPosition = m_bookmarkJournalPosition](
+			const BackgroundFileSaver::SaveResult &result)
+		{
+			if (result.succeeded && journalPosition)
+			{
+				bookmarkJournal->OnSnapshotSaved(*journalPosition);
+			}
+		});
 }
 
 void LoadSaveXML::LoadGenericSettings()
 {
-	m_pContainer->LoadGenericSettingsFromXML(m_pXMLDom.get());
+	m_pContainer->LoadGenericSettingsFromXML(GetConfigData());
 }
 
 void LoadSaveXML::LoadBookmarks()
 {
-	m_pContainer->LoadBookmarksFromXML(m_pXMLDom.get());
+	m_pContainer->LoadBookmarksFromXML(GetConfigData());
 }
 
 int LoadSaveXML::LoadPreviousTabs()
 {
-	return m_pContainer->LoadTabSettingsFromXML(m_pXMLDom.get());
+	return m_pContainer->LoadTabSettingsFromXML(GetConfigData());
 }
 
 void LoadSaveXML::LoadDefaultColumns()
 {
-	m_pContainer->LoadDefaultColumnsFromXML(m_pXMLDom.get());
+	m_pContainer->LoadDefaultColumnsFromXML(GetConfigData());
 }
 
 void LoadSaveXML::LoadApplicationToolbar()
 {
-	m_pContainer->LoadApplicationToolbarFromXML(m_pXMLDom.get());
+	m_pContainer->LoadApplicationToolbarFromXML(GetLoadDocument());
 }
 
 void LoadSaveXML::LoadToolbarInformation()
 {
-	m_pContainer->LoadToolbarInformationFromXML(m_pXMLDom.get());
+	m_pContainer->LoadToolbarInformationFromXML(GetConfigData());
 }
 
 void LoadSaveXML::LoadColorRules()
 {
-	NColorRuleHelper::LoadColorRulesFromXML(m_pXMLDom.get(), m_pContainer->m_ColorRules);
+	NColorRuleHelper::LoadColorRulesFromXML(GetLoadDocument(), m_pContainer->m_ColorRules);
 }
 
 void LoadSaveXML::LoadDialogStates()
 {
-	m_pContainer->LoadDialogStatesFromXML(m_pXMLDom.get());
+	m_pContainer->LoadDialogStatesFromXML(GetLoadDocument());
 }
 
 void LoadSaveXML::SaveGenericSettings()
@@ -167,7 +199,7 @@ void LoadSaveXML::SaveGenericSettings()
 
 void LoadSaveXML::SaveBookmarks()
 {
-	m_pContainer->SaveBookmarksToXML(m_pXMLDom.get(), m_pRoot.get());
+	m_bookmarkJournalPosition = m_pContainer->SaveBookmarksToXML(m_pXMLDom.get(), m_pRoot.get());
 }
 
 void LoadSaveXML::SaveTabs()
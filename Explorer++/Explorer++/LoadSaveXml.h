@@ -5,11 +5,16 @@
 #pragma once
 
 #include "LoadSaveInterface.h"
+#include "Bookmarks/BookmarkJournal.h"
 #include <wil/com.h>
 #include <MsXml2.h>
 #include <objbase.h>
+#include <memory>
+#include <optional>
+#include <string_view>
 
 class Explorerplusplus;
+class MappedXmlFile;
 
 class LoadSaveXML : public ILoadSave
 {
@@ -39,6 +44,8 @@ public:
 
 private:
 	void InitializeLoadEnvironment();
+	IXMLDOMDocument *GetLoadDocument();
+	std::string_view GetConfigData() const;
 	void ReleaseLoadEnvironment();
 	void InitializeSaveEnvironment();
 	void ReleaseSaveEnvironment();
@@ -46,9 +53,19 @@ private:
 	Explorerplusplus *m_pContainer;
 	BOOL m_bLoad;
 
-	/* Used for saving + loading. */
+	/* Used for loading. Most settings are read directly from the
+	file, using XmlPullParser. */
+	std::unique_ptr<MappedXmlFile> m_configFile;
+
+	/* Used for saving + loading. When loading, this is only created
+	for the settings that are still read via the DOM. */
 	wil::com_ptr_nothrow<IXMLDOMDocument> m_pXMLDom;
+	bool m_loadDocumentInitialized = false;
 
 	/* Used exclusively for saving. */
 	wil::com_ptr_nothrow<IXMLDOMElement> m_pRoot;
+
+	/* The bookmark journal position saved in the file. The journal
+	is trimmed once the file has been written. */
+	std::optional<BookmarkJournalPosition> m_bookmarkJournalPosition;
 };
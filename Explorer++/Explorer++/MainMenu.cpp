@@ -9,6 +9,7 @@
 #include "ResourceHelper.h"
 #include "../Helper/DpiCompatibility.h"
 #include "../Helper/ShellHelper.h"
+#include "../Helper/TraceRecorder.h"
 #include <wil/resource.h>
 #include <map>
 
@@ -55,6 +56,8 @@ const std::map<UINT, Icon> MAIN_MENU_IMAGE_MAPPINGS = {
 
 void Explorerplusplus::InitializeMainMenu()
 {
+	TRACE_FUNCTION();
+
 	// These need to occur after the language module has been initialized, but
 	// before the tabs are restored.
 	HMENU mainMenu = LoadMenu(m_resourceModule, MAKEINTRESOURCE(IDR_MAINMENU));
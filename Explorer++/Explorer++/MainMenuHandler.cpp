@@ -5,10 +5,12 @@
 #include "stdafx.h"
 #include "Explorer++.h"
 #include "AboutDialog.h"
+#include "CompareFoldersDialog.h"
 #include "Config.h"
 #include "CustomizeColorsDialog.h"
 #include "DestroyFilesDialog.h"
 #include "DisplayColoursDialog.h"
+#include "DuplicateFilesDialog.h"
 #include "Explorer++_internal.h"
 #include "FileProgressSink.h"
 #include "FilterDialog.h"
@@ -18,6 +20,7 @@
 #include "MergeFilesDialog.h"
 #include "ModelessDialogs.h"
 #include "OptionsDialog.h"
+#include "ResourceHelper.h"
 #include "ScriptingDialog.h"
 #include "SearchDialog.h"
 #include "ShellBrowser/ShellBrowser.h"
@@ -26,11 +29,17 @@
 #include "TabContainer.h"
 #include "UpdateCheckDialog.h"
 #include "WildcardSelectDialog.h"
+#include "../Helper/DirectoryListingExporter.h"
 #include "../Helper/ListViewHelper.h"
 #include "../Helper/ProcessHelper.h"
 #include "../Helper/ShellHelper.h"
 #include <wil/com.h>
 
+namespace
+{
+const DWORD SAVE_DIRECTORY_LISTING_INCLUDE_SUBFOLDERS_ID = 1;
+}
+
 void Explorerplusplus::OnChangeDisplayColors()
 {
 	DisplayColoursDialog displayColoursDialog(m_resourceModule, m_hContainer, m_hDisplayWindow,
@@ -115,6 +124,42 @@ void Explorerplusplus::OnSearch()
 	}
 }
 
+void Explorerplusplus::OnFindDuplicateFiles()
+{
+	if (g_hwndDuplicateFiles == nullptr)
+	{
+		Tab &selectedTab = m_tabContainer->GetSelectedTab();
+		std::wstring currentDirectory = selectedTab.GetShellBrowser()->GetDirectory();
+
+		auto *duplicateFilesDialog = new DuplicateFilesDialog(m_resourceModule, m_hContainer,
+			currentDirectory, this, this);
+		g_hwndDuplicateFiles =
+			duplicateFilesDialog->ShowModelessDialog(new ModelessDialogNotification());
+	}
+	else
+	{
+		SetFocus(g_hwndDuplicateFiles);
+	}
+}
+
+void Explorerplusplus::OnCompareFolders()
+{
+	if (g_hwndCompareFolders == nullptr)
+	{
+		Tab &selectedTab = m_tabContainer->GetSelectedTab();
+		std::wstring currentDirectory = selectedTab.GetShellBrowser()->GetDirectory();
+
+		auto *compareFoldersDialog = new CompareFoldersDialog(m_resourceModule, m_hContainer,
+			currentDirectory, m_config->globalFolderSettings.showFriendlyDates, this, this);
+		g_hwndCompareFolders =
+			compareFoldersDialog->ShowModelessDialog(new ModelessDialogNotification());
+	}
+	else
+	{
+		SetFocus(g_hwndCompareFolders);
+	}
+}
+
 void Explorerplusplus::OnCustomizeColors()
 {
 	CustomizeColorsDialog customizeColorsDialog(m_resourceModule, m_hContainer, this,
@@ -194,21 +239,129 @@ void Explorerplusplus::OnAbout()
 	aboutDialog.ShowModalDialog();
 }
 
-void Explorerplusplus::OnSaveDirectoryListing() const
+void Explorerplusplus::OnSaveDirectoryListing()
 {
-	TCHAR fileName[MAX_PATH];
-	LoadString(m_resourceModule, IDS_GENERAL_DIRECTORY_LISTING_FILENAME, fileName,
-		SIZEOF_ARRAY(fileName));
-	StringCchCat(fileName, SIZEOF_ARRAY(fileName), _T(".txt"));
+	if (m_directoryListingThread.joinable())
+	{
+		std::wstring message = ResourceHelper::LoadString(m_resourceModule,
+			IDS_SAVE_DIRECTORY_LISTING_IN_PROGRESS);
+		MessageBox(m_hContainer, message.c_str(), NExplorerplusplus::APP_NAME,
+			MB_ICONINFORMATION | MB_OK);
+		return;
+	}
+
+	wil::com_ptr_nothrow<IFileSaveDialog> fileSaveDialog;
+	HRESULT hr = CoCreateInstance(CLSID_FileSaveDialog, nullptr, CLSCTX_INPROC_SERVER,
+		IID_PPV_ARGS(&fileSaveDialog));
+
+	if (FAILED(hr))
+	{
+		return;
+	}
+
+	std::wstring textFileType =
+		ResourceHelper::LoadString(m_resourceModule, IDS_SAVE_DIRECTORY_LISTING_FILE_TYPE_TEXT);
+	std::wstring csvFileType =
+		ResourceHelper::LoadString(m_resourceModule, IDS_SAVE_DIRECTORY_LISTING_FILE_TYPE_CSV);
+	std::wstring jsonFileType =
+		ResourceHelper::LoadString(m_resourceModule, IDS_SAVE_DIRECTORY_LISTING_FILE_TYPE_JSON);
+
+	// The order of these items needs to match the order of the DirectoryListingExporter::Format
+	// values, since the index of the selected type is used to determine the output format.
+	const COMDLG_FILTERSPEC fileTypes[] = { { textFileType.c_str(), L"*.txt" },
+		{ csvFileType.c_str(), L"*.csv" }, { jsonFileType.c_str(), L"*.json" } };
+	fileSaveDialog->SetFileTypes(SIZEOF_ARRAY(fileTypes), fileTypes);
+	fileSaveDialog->SetDefaultExtension(L"txt");
+
+	std::wstring fileName =
+		ResourceHelper::LoadString(m_resourceModule, IDS_GENERAL_DIRECTORY_LISTING_FILENAME);
+	fileSaveDialog->SetFileName(fileName.c_str());
 
 	std::wstring directory = m_pActiveShellBrowser->GetDirectory();
 
-	BOOL bSaveNameRetrieved =
-		GetFileNameFromUser(m_hContainer, fileName, SIZEOF_ARRAY(fileName), directory.c_str());
+	wil::com_ptr_nothrow<IShellItem> directoryItem;
+	hr = SHCreateItemFromParsingName(directory.c_str(), nullptr, IID_PPV_ARGS(&directoryItem));
+
+	if (SUCCEEDED(hr))
+	{
+		fileSaveDialog->SetFolder(directoryItem.get());
+	}
+
+	auto fileDialogCustomize = fileSaveDialog.try_query<IFileDialogCustomize>();
+
+	if (fileDialogCustomize)
+	{
+		std::wstring includeSubfoldersText = ResourceHelper::LoadString(m_resourceModule,
+			IDS_SAVE_DIRECTORY_LISTING_INCLUDE_SUBFOLDERS);
+		fileDialogCustomize->AddCheckButton(SAVE_DIRECTORY_LISTING_INCLUDE_SUBFOLDERS_ID,
+			includeSubfoldersText.c_str(), FALSE);
+	}
+
+	hr = fileSaveDialog->Show(m_hContainer);
+
+	if (FAILED(hr))
+	{
+		return;
+	}
+
+	wil::com_ptr_nothrow<IShellItem> outputItem;
+	hr = fileSaveDialog->GetResult(&outputItem);
+
+	if (FAILED(hr))
+	{
+		return;
+	}
+
+	wil::unique_cotaskmem_string outputPath;
+	hr = outputItem->GetDisplayName(SIGDN_FILESYSPATH, &outputPath);
+
+	if (FAILED(hr))
+	{
+		return;
+	}
+
+	DirectoryListingExporter::Options options;
+
+	UINT fileTypeIndex;
+	hr = fileSaveDialog->GetFileTypeIndex(&fileTypeIndex);
+
+	// The returned index is 1-based.
+	if (SUCCEEDED(hr) && fileTypeIndex >= 1 && fileTypeIndex <= SIZEOF_ARRAY(fileTypes))
+	{
+		options.format = static_cast<DirectoryListingExporter::Format>(fileTypeIndex - 1);
+	}
+
+	BOOL includeSubfolders = FALSE;
+
+	if (fileDialogCustomize)
+	{
+		fileDialogCustomize->GetCheckButtonState(SAVE_DIRECTORY_LISTING_INCLUDE_SUBFOLDERS_ID,
+			&includeSubfolders);
+	}
+
+	options.recursive = includeSubfolders;
+
+	m_directoryListingExporter = std::make_unique<DirectoryListingExporter>(directory, options);
+
+	m_directoryListingThread = std::thread(
+		[this, outputPath = std::wstring(outputPath.get())]
+		{
+			m_directoryListingSaved = m_directoryListingExporter->Export(outputPath);
+			PostMessage(m_hContainer, WM_APP_DIRECTORYLISTINGSAVED, 0, 0);
+		});
+}
+
+void Explorerplusplus::OnDirectoryListingSaved()
+{
+	m_directoryListingThread.join();
+	m_directoryListingExporter.reset();
 
-	if (bSaveNameRetrieved)
+	if (!m_directoryListingSaved)
 	{
-		NFileOperations::SaveDirectoryListing(directory, fileName);
+		std::wstring message =
+			ResourceHelper::LoadString(m_resourceModule, IDS_SAVE_DIRECTORY_LISTING_FAILED);
+		MessageBox(m_hContainer, message.c_str(), NExplorerplusplus::APP_NAME,
+			MB_ICONWARNING | MB_OK);
 	}
 }
 
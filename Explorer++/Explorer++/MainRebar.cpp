@@ -24,6 +24,7 @@
 #include "TabContainer.h"
 #include "../Helper/Controls.h"
 #include "../Helper/MenuHelper.h"
+#include "../Helper/TraceRecorder.h"
 #include "../Helper/WindowHelper.h"
 
 LRESULT CALLBACK RebarSubclassStub(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam,
@@ -34,6 +35,8 @@ DWORD RebarStyles = WS_CHILD | WS_VISIBLE | WS_CLIPCHILDREN | WS_CLIPSIBLINGS |
 
 void Explorerplusplus::InitializeMainToolbars()
 {
+	TRACE_FUNCTION();
+
 	/* Initialize the main toolbar styles and settings here. The visibility and gripper
 	styles will be set after the settings have been loaded (needed to keep compatibility
 	with versions older than 0.9.5.4). */
@@ -95,6 +98,8 @@ void Explorerplusplus::InitializeMainToolbars()
 
 void Explorerplusplus::CreateMainControls()
 {
+	TRACE_FUNCTION();
+
 	SIZE sz;
 	RECT rc;
 	DWORD toolbarSize;
@@ -18,6 +18,7 @@
 #include "../Helper/ImageHelper.h"
 #include "../Helper/Macros.h"
 #include "../Helper/XMLSettings.h"
+#include "../Helper/XmlPullParser.h"
 #include <boost/bimap.hpp>
 
 // Enable C4062: enumerator 'identifier' in switch of enum 'enumeration' is not handled
@@ -1018,25 +1019,17 @@ MainToolbarPersistentSettings &MainToolbarPersistentSettings::GetInstance()
 	return persistentSettings;
 }
 
-void MainToolbarPersistentSettings::LoadXMLSettings(IXMLDOMNode *pNode)
+void MainToolbarPersistentSettings::LoadXMLSettings(const XmlPullParser &parser)
 {
 	std::vector<MainToolbarButton> toolbarButtons;
 
-	wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> am;
-	pNode->get_attributes(&am);
+	const auto &attributes = parser.GetAttributes();
 
-	long lChildNodes;
-	am->get_length(&lChildNodes);
-
-	for (long j = 1; j < lChildNodes; j++)
+	// The first attribute is the name of the setting, which can be ignored.
+	for (size_t j = 1; j < attributes.size(); j++)
 	{
-		wil::com_ptr_nothrow<IXMLDOMNode> pChildNode;
-		am->get_item(j, &pChildNode);
-
-		wil::unique_bstr bstrValue;
-		pChildNode->get_text(&bstrValue);
-
-		auto itr = TOOLBAR_BUTTON_XML_NAME_MAPPINGS.right.find(bstrValue.get());
+		auto itr = TOOLBAR_BUTTON_XML_NAME_MAPPINGS.right.find(
+			DecodeXmlAttributeValue(attributes[j].rawValue));
 
 		if (itr == TOOLBAR_BUTTON_XML_NAME_MAPPINGS.right.end())
 		{
@@ -17,13 +17,14 @@
 
 struct Config;
 class MainToolbar;
+class XmlPullParser;
 
 class MainToolbarPersistentSettings
 {
 public:
 	static MainToolbarPersistentSettings &GetInstance();
 
-	void LoadXMLSettings(IXMLDOMNode *pNode);
+	void LoadXMLSettings(const XmlPullParser &parser);
 	void SaveXMLSettings(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pe);
 
 private:
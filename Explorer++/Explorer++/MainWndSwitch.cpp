@@ -30,6 +30,7 @@
 #include "ShellBrowser/ViewModes.h"
 #include "TabBacking.h"
 #include "TabContainer.h"
+#include "TabHibernator.h"
 #include "TabRestorerUI.h"
 #include "../Helper/BulkClipboardWriter.h"
 #include "../Helper/Controls.h"
@@ -117,9 +118,9 @@ LRESULT CALLBACK Explorerplusplus::WindowProcedure(HWND hwnd, UINT Msg, WPARAM w
 		break;
 
 	case WM_TIMER:
-		if (wParam == AUTOSAVE_TIMER_ID)
+		if (wParam == AUTOSAVE_TIMER_ID || wParam == SAVE_SETTINGS_TIMER_ID)
 		{
-			SaveAllSettings();
+			SaveAllSettingsNow();
 		}
 		else if (wParam == LISTVIEW_ITEM_CHANGED_TIMER_ID)
 		{
@@ -131,6 +132,14 @@ LRESULT CALLBACK Explorerplusplus::WindowProcedure(HWND hwnd, UINT Msg, WPARAM w
 
 			KillTimer(m_hContainer, LISTVIEW_ITEM_CHANGED_TIMER_ID);
 		}
+		else if (wParam == HIBERNATE_TABS_TIMER_ID)
+		{
+			m_tabHibernator->HibernateIdleTabs();
+		}
+		else if (wParam == FILE_TRANSFER_PROGRESS_TIMER_ID)
+		{
+			UpdateFileTransferProgress();
+		}
 		break;
 
 	case WM_USER_UPDATEWINDOWS:
@@ -169,6 +178,18 @@ LRESULT CALLBACK Explorerplusplus::WindowProcedure(HWND hwnd, UINT Msg, WPARAM w
 	}
 	break;
 
+	case WM_APP_FILETRANSFERPLANNED:
+		OnFileTransferPlanned();
+		break;
+
+	case WM_APP_FILETRANSFERCOMPLETED:
+		OnFileTransferCompleted();
+		break;
+
+	case WM_APP_DIRECTORYLISTINGSAVED:
+		OnDirectoryListingSaved();
+		break;
+
 	case WM_APP_FOLDERSIZECOMPLETED:
 	{
 		DWFolderSizeCompletion *pDWFolderSizeCompletion = nullptr;
@@ -817,6 +838,18 @@ LRESULT Explorerplusplus::HandleMenuOrToolbarButtonOrAccelerator(HWND hwnd, int
 		OnSortBy(SortMode::MediaYear);
 		break;
 
+	case IDM_SORTBY_CRC32C:
+		OnSortBy(SortMode::Crc32c);
+		break;
+
+	case IDM_SORTBY_XXHASH64:
+		OnSortBy(SortMode::XxHash64);
+		break;
+
+	case IDM_SORTBY_SHA256:
+		OnSortBy(SortMode::Sha256);
+		break;
+
 	case IDM_GROUPBY_NAME:
 		OnGroupBy(SortMode::Name);
 		break;
@@ -1065,6 +1098,18 @@ LRESULT Explorerplusplus::HandleMenuOrToolbarButtonOrAccelerator(HWND hwnd, int
 		OnGroupBy(SortMode::MediaYear);
 		break;
 
+	case IDM_GROUPBY_CRC32C:
+		OnGroupBy(SortMode::Crc32c);
+		break;
+
+	case IDM_GROUPBY_XXHASH64:
+		OnGroupBy(SortMode::XxHash64);
+		break;
+
+	case IDM_GROUPBY_SHA256:
+		OnGroupBy(SortMode::Sha256);
+		break;
+
 	case IDM_SORT_ASCENDING:
 		OnSortByAscending(TRUE);
 		break;
@@ -1256,7 +1301,7 @@ LRESULT Explorerplusplus::HandleMenuOrToolbarButtonOrAccelerator(HWND hwnd, int
 		if (g_hwndManageBookmarks == nullptr)
 		{
 			auto *pManageBookmarksDialog = new ManageBookmarksDialog(m_resourceModule, hwnd, this,
-				this, &m_bookmarkIconFetcher, &m_bookmarkTree);
+				this, &m_bookmarkIconFetcher, &m_bookmarkTree, &m_bookmarkSearchIndex);
 			g_hwndManageBookmarks =
 				pManageBookmarksDialog->ShowModelessDialog(new ModelessDialogNotification());
 		}
@@ -1271,6 +1316,14 @@ LRESULT Explorerplusplus::HandleMenuOrToolbarButtonOrAccelerator(HWND hwnd, int
 		OnSearch();
 		break;
 
+	case IDM_TOOLS_FINDDUPLICATEFILES:
+		OnFindDuplicateFiles();
+		break;
+
+	case IDM_TOOLS_COMPAREFOLDERS:
+		OnCompareFolders();
+		break;
+
 	case IDM_TOOLS_CUSTOMIZECOLORS:
 		OnCustomizeColors();
 		break;
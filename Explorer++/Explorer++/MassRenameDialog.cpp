@@ -11,6 +11,9 @@
  * /E	- Extension
  * /L	- Lowercase filename
  * /U	- Uppercase filename
+ * /D	- Modification date
+ * /R{}	- Regular expression, with /1 to /9 used to insert capture groups
+ * See RenameTemplate.h for full details.
  */
 
 #include "stdafx.h"
@@ -18,15 +21,14 @@
 #include "DarkModeHelper.h"
 #include "IconResourceLoader.h"
 #include "MainResource.h"
+#include "RenameErrorHelper.h"
 #include "ResourceHelper.h"
 #include "../Helper/DpiCompatibility.h"
 #include "../Helper/Macros.h"
 #include "../Helper/RegistrySettings.h"
+#include "../Helper/TimeHelper.h"
 #include "../Helper/XMLSettings.h"
-#include <boost/locale.hpp>
-#include <iomanip>
 #include <list>
-#include <regex>
 
 const TCHAR MassRenameDialogPersistentSettings::SETTINGS_KEY[] = _T("MassRename");
 
@@ -37,11 +39,23 @@ MassRenameDialog::MassRenameDialog(HINSTANCE hInstance, HWND hParent,
 	const std::list<std::wstring> &FullFilenameList, IconResourceLoader *iconResourceLoader,
 	FileActionHandler *pFileActionHandler) :
 	DarkModeDialogBase(hInstance, IDD_MASSRENAME, hParent, true),
-	m_FullFilenameList(FullFilenameList),
 	m_iconResourceLoader(iconResourceLoader),
 	m_pFileActionHandler(pFileActionHandler)
 {
 	m_persistentSettings = &MassRenameDialogPersistentSettings::GetInstance();
+
+	m_items.reserve(FullFilenameList.size());
+
+	/* The filenames are extracted once here, rather than each time the
+	preview is updated. */
+	for (const auto &fullFilename : FullFilenameList)
+	{
+		TCHAR szFilename[MAX_PATH];
+		StringCchCopy(szFilename, SIZEOF_ARRAY(szFilename), fullFilename.c_str());
+		PathStripPath(szFilename);
+
+		m_items.push_back({ fullFilename, szFilename });
+	}
 }
 
 INT_PTR MassRenameDialog::OnInitDialog()
@@ -81,29 +95,24 @@ INT_PTR MassRenameDialog::OnInitDialog()
 
 	LVITEM lvItem;
 	SHFILEINFO shfi;
-	TCHAR szFilename[MAX_PATH];
 	int iItem = 0;
 
-	/* Add each file to the listview, along with its icon. */
-	for (const auto &strFilename : m_FullFilenameList)
+	/* Add each file to the listview, along with its icon. The preview
+	name is only generated when an item is displayed (see OnGetDispInfo()),
+	so that changing the pattern doesn't require every item to be
+	updated. */
+	for (auto &item : m_items)
 	{
-		SHGetFileInfo(strFilename.c_str(), 0, &shfi, sizeof(SHFILEINFO), SHGFI_SYSICONINDEX);
-
-		StringCchCopy(szFilename, SIZEOF_ARRAY(szFilename), strFilename.c_str());
-		PathStripPath(szFilename);
+		SHGetFileInfo(item.fullPath.c_str(), 0, &shfi, sizeof(SHFILEINFO), SHGFI_SYSICONINDEX);
 
 		lvItem.mask = LVIF_TEXT | LVIF_IMAGE;
 		lvItem.iItem = iItem;
 		lvItem.iSubItem = 0;
 		lvItem.iImage = shfi.iIcon;
-		lvItem.pszText = szFilename;
+		lvItem.pszText = item.fileName.data();
 		ListView_InsertItem(hListView, &lvItem);
 
-		lvItem.mask = LVIF_TEXT;
-		lvItem.iItem = iItem;
-		lvItem.iSubItem = 1;
-		lvItem.pszText = szFilename;
-		ListView_SetItem(hListView, &lvItem);
+		ListView_SetItemText(hListView, iItem, 1, LPSTR_TEXTCALLBACK);
 
 		iItem++;
 	}
@@ -167,37 +176,8 @@ INT_PTR MassRenameDialog::OnCommand(WPARAM wParam, LPARAM lParam)
 		switch (HIWORD(wParam))
 		{
 		case EN_CHANGE:
-		{
-			TCHAR szNamePattern[MAX_PATH];
-			GetDlgItemText(m_hDlg, IDC_MASSRENAME_EDIT, szNamePattern, SIZEOF_ARRAY(szNamePattern));
-
-			HWND hListView = GetDlgItem(m_hDlg, IDC_MASSRENAME_FILELISTVIEW);
-
-			LVITEM lvItem;
-			std::wstring strNewFilename;
-			TCHAR szFilename[MAX_PATH];
-			TCHAR szNewFilename[MAX_PATH];
-			int iItem = 0;
-
-			for (const auto &strFilename : m_FullFilenameList)
-			{
-				StringCchCopy(szFilename, SIZEOF_ARRAY(szFilename), strFilename.c_str());
-				PathStripPath(szFilename);
-
-				ProcessFileName(szNamePattern, szFilename, iItem, strNewFilename);
-
-				StringCchCopy(szNewFilename, SIZEOF_ARRAY(szNewFilename), strNewFilename.c_str());
-
-				lvItem.mask = LVIF_TEXT;
-				lvItem.iItem = iItem;
-				lvItem.iSubItem = 1;
-				lvItem.pszText = szNewFilename;
-				ListView_SetItem(hListView, &lvItem);
-
-				iItem++;
-			}
-		}
-		break;
+			OnNamePatternChanged();
+			break;
 		}
 	}
 	else
@@ -246,6 +226,11 @@ INT_PTR MassRenameDialog::OnCommand(WPARAM wParam, LPARAM lParam)
 				SendDlgItemMessage(m_hDlg, IDC_MASSRENAME_EDIT, EM_REPLACESEL, TRUE,
 					reinterpret_cast<LPARAM>(_T("/U")));
 				break;
+
+			case IDM_MASSRENAME_DATE:
+				SendDlgItemMessage(m_hDlg, IDC_MASSRENAME_EDIT, EM_REPLACESEL, TRUE,
+					reinterpret_cast<LPARAM>(_T("/D")));
+				break;
 			}
 		}
 		break;
@@ -263,49 +248,126 @@ INT_PTR MassRenameDialog::OnCommand(WPARAM wParam, LPARAM lParam)
 	return 0;
 }
 
+INT_PTR MassRenameDialog::OnNotify(NMHDR *pnmhdr)
+{
+	switch (pnmhdr->code)
+	{
+	case LVN_GETDISPINFO:
+		if (pnmhdr->idFrom == IDC_MASSRENAME_FILELISTVIEW)
+		{
+			OnGetDispInfo(reinterpret_cast<NMLVDISPINFO *>(pnmhdr));
+		}
+		break;
+	}
+
+	return 0;
+}
+
 INT_PTR MassRenameDialog::OnClose()
 {
 	EndDialog(m_hDlg, 0);
 	return 0;
 }
 
-void MassRenameDialog::OnOk()
+/* The pattern is only parsed once each time it changes. The listview is
+then simply invalidated, so that only the items that are actually visible
+have their new names generated. */
+void MassRenameDialog::OnNamePatternChanged()
+{
+	m_renameTemplate = RenameTemplate::Parse(GetNamePattern());
+
+	EnableWindow(GetDlgItem(m_hDlg, IDOK), m_renameTemplate.has_value());
+
+	InvalidateRect(GetDlgItem(m_hDlg, IDC_MASSRENAME_FILELISTVIEW), nullptr, FALSE);
+}
+
+void MassRenameDialog::OnGetDispInfo(NMLVDISPINFO *dispInfo)
+{
+	if (dispInfo->item.iSubItem != 1 || WI_IsFlagClear(dispInfo->item.mask, LVIF_TEXT))
+	{
+		return;
+	}
+
+	/* If the pattern is invalid, there's no preview to show. */
+	if (!m_renameTemplate)
+	{
+		StringCchCopy(dispInfo->item.pszText, dispInfo->item.cchTextMax, L"");
+		return;
+	}
+
+	m_renameTemplate->Evaluate(GetFileInfo(dispInfo->item.iItem), m_previewName);
+	StringCchCopy(dispInfo->item.pszText, dispInfo->item.cchTextMax, m_previewName.c_str());
+}
+
+std::wstring MassRenameDialog::GetNamePattern() const
+{
+	HWND hEdit = GetDlgItem(m_hDlg, IDC_MASSRENAME_EDIT);
+
+	std::wstring namePattern;
+	namePattern.resize(GetWindowTextLength(hEdit) + 1);
+	GetWindowText(hEdit, namePattern.data(), static_cast<int>(namePattern.size()));
+	namePattern.resize(namePattern.size() - 1);
+
+	return namePattern;
+}
+
+RenameTemplate::FileInfo MassRenameDialog::GetFileInfo(int index)
 {
-	TCHAR szNamePattern[MAX_PATH];
+	RenameItem &item = m_items[index];
+
+	if (m_renameTemplate->UsesDate() && !item.modificationDateLoaded)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA attributeData;
+		SYSTEMTIME localTime;
+
+		if (GetFileAttributesEx(item.fullPath.c_str(), GetFileExInfoStandard, &attributeData)
+			&& FileTimeToLocalSystemTime(&attributeData.ftLastWriteTime, &localTime))
+		{
+			item.modificationDate = RenameTemplate::DateTime{ localTime.wYear, localTime.wMonth,
+				localTime.wDay, localTime.wHour, localTime.wMinute, localTime.wSecond };
+		}
+
+		item.modificationDateLoaded = true;
+	}
 
-	GetDlgItemText(m_hDlg, IDC_MASSRENAME_EDIT, szNamePattern, SIZEOF_ARRAY(szNamePattern));
+	return { item.fileName, index, item.modificationDate };
+}
 
-	if (lstrlen(szNamePattern) == 0)
+void MassRenameDialog::OnOk()
+{
+	if (GetWindowTextLength(GetDlgItem(m_hDlg, IDC_MASSRENAME_EDIT)) == 0)
 	{
 		EndDialog(m_hDlg, 1);
 		return;
 	}
 
+	if (!m_renameTemplate)
+	{
+		return;
+	}
+
 	std::list<FileActionHandler::RenamedItem_t> renamedItemList;
-	int iItem = 0;
+	std::wstring strNewFilename;
 
-	for (const auto &strOldFilename : m_FullFilenameList)
+	for (int iItem = 0; iItem < static_cast<int>(m_items.size()); iItem++)
 	{
-		TCHAR szFilename[MAX_PATH];
-		StringCchCopy(szFilename, SIZEOF_ARRAY(szFilename), strOldFilename.c_str());
-		PathStripPath(szFilename);
+		const std::wstring &strOldFilename = m_items[iItem].fullPath;
 
-		std::wstring strNewFilename;
-		ProcessFileName(szNamePattern, szFilename, iItem, strNewFilename);
+		m_renameTemplate->Evaluate(GetFileInfo(iItem), strNewFilename);
 
-		StringCchCopy(szFilename, SIZEOF_ARRAY(szFilename), strOldFilename.c_str());
-		PathRemoveFileSpec(szFilename);
-		strNewFilename = szFilename + std::wstring(_T("\\")) + strNewFilename;
+		TCHAR szDirectory[MAX_PATH];
+		StringCchCopy(szDirectory, SIZEOF_ARRAY(szDirectory), strOldFilename.c_str());
+		PathRemoveFileSpec(szDirectory);
 
 		FileActionHandler::RenamedItem_t renamedItem;
 		renamedItem.strOldFilename = strOldFilename;
-		renamedItem.strNewFilename = strNewFilename;
+		renamedItem.strNewFilename = szDirectory + std::wstring(_T("\\")) + strNewFilename;
 		renamedItemList.push_back(renamedItem);
-
-		iItem++;
 	}
 
-	m_pFileActionHandler->RenameFiles(renamedItemList);
+	FileActionHandler::FailedRenames_t failedItems;
+	m_pFileActionHandler->RenameFiles(renamedItemList, &failedItems);
+	ShowRenameErrors(m_hDlg, GetInstance(), failedItems);
 
 	EndDialog(m_hDlg, 1);
 }
@@ -326,73 +388,6 @@ void MassRenameDialog::SaveState()
 	m_persistentSettings->m_bStateSaved = TRUE;
 }
 
-void MassRenameDialog::ProcessFileName(const std::wstring &strTarget,
-	const std::wstring &strFilename, int iFileIndex, std::wstring &strOutput)
-{
-	TCHAR szBaseName[MAX_PATH];
-	StringCchCopy(szBaseName, SIZEOF_ARRAY(szBaseName), strFilename.c_str());
-	PathRemoveExtension(szBaseName);
-
-	TCHAR *pExt = PathFindExtension(strFilename.c_str());
-
-	size_t iPos;
-
-	strOutput = strTarget;
-
-	std::wregex rxPattern;
-	rxPattern.assign(_T("/[0]*N"));
-
-	bool bStop = false;
-
-	while (!bStop)
-	{
-		std::match_results<std::wstring::const_iterator> mr;
-		std::wstring::const_iterator itrStart = strOutput.begin();
-		std::wstring::const_iterator itrEnd = strOutput.end();
-
-		if (std::regex_search(itrStart, itrEnd, mr, rxPattern))
-		{
-			std::wstringstream ss;
-
-			/* The minimum length is the number of zeros present plus one. */
-			ss << std::setfill(_T('0')) << std::setw((mr.length() - 2) + 1) << iFileIndex;
-
-			strOutput.replace(mr.position(), mr.length(), ss.str());
-		}
-		else
-		{
-			bStop = true;
-		}
-	}
-
-	while ((iPos = strOutput.find(_T("/F"))) != std::wstring::npos)
-	{
-		strOutput.replace(iPos, 2, strFilename);
-	}
-
-	while ((iPos = strOutput.find(_T("/B"))) != std::wstring::npos)
-	{
-		strOutput.replace(iPos, 2, szBaseName);
-	}
-
-	while ((iPos = strOutput.find(_T("/E"))) != std::wstring::npos)
-	{
-		strOutput.replace(iPos, 2, pExt);
-	}
-
-	while ((iPos = strOutput.find(_T("/L"))) != std::wstring::npos)
-	{
-		strOutput.replace(iPos, 2, strFilename);
-		strOutput = boost::locale::to_lower(strOutput);
-	}
-
-	while ((iPos = strOutput.find(_T("/U"))) != std::wstring::npos)
-	{
-		strOutput.replace(iPos, 2, strFilename);
-		strOutput = boost::locale::to_upper(strOutput);
-	}
-}
-
 MassRenameDialogPersistentSettings::MassRenameDialogPersistentSettings() :
 	DialogSettings(SETTINGS_KEY)
 {
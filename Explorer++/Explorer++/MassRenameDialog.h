@@ -7,7 +7,10 @@
 #include "DarkModeDialogBase.h"
 #include "../Helper/DialogSettings.h"
 #include "../Helper/FileActionHandler.h"
+#include "../Helper/RenameTemplate.h"
 #include "../Helper/ResizableDialog.h"
+#include <optional>
+#include <vector>
 
 class IconResourceLoader;
 class MassRenameDialog;
@@ -52,11 +55,22 @@ public:
 protected:
 	INT_PTR OnInitDialog() override;
 	INT_PTR OnCommand(WPARAM wParam, LPARAM lParam) override;
+	INT_PTR OnNotify(NMHDR *pnmhdr) override;
 	INT_PTR OnClose() override;
 
 	virtual wil::unique_hicon GetDialogIcon(int iconWidth, int iconHeight) const override;
 
 private:
+	struct RenameItem
+	{
+		std::wstring fullPath;
+		std::wstring fileName;
+
+		// The modification date is only retrieved if the rename template actually uses it.
+		bool modificationDateLoaded = false;
+		std::optional<RenameTemplate::DateTime> modificationDate;
+	};
+
 	void GetResizableControlInformation(BaseDialog::DialogSizeConstraint &dsc,
 		std::list<ResizableDialog::Control> &ControlList) override;
 	void SaveState() override;
@@ -64,10 +78,14 @@ private:
 	void OnOk();
 	void OnCancel();
 
-	void ProcessFileName(const std::wstring &strTarget, const std::wstring &strFilename,
-		int iFileIndex, std::wstring &strOutput);
+	void OnNamePatternChanged();
+	void OnGetDispInfo(NMLVDISPINFO *dispInfo);
+	std::wstring GetNamePattern() const;
+	RenameTemplate::FileInfo GetFileInfo(int index);
 
-	std::list<std::wstring> m_FullFilenameList;
+	std::vector<RenameItem> m_items;
+	std::optional<RenameTemplate> m_renameTemplate;
+	std::wstring m_previewName;
 	wil::unique_hicon m_moreIcon;
 	IconResourceLoader *m_iconResourceLoader;
 	FileActionHandler *m_pFileActionHandler;
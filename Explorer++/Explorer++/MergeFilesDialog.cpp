@@ -9,28 +9,39 @@
 #include "IconResourceLoader.h"
 #include "MainResource.h"
 #include "ResourceHelper.h"
+#include "../Helper/ChecksumManifest.h"
 #include "../Helper/FileOperations.h"
 #include "../Helper/Helper.h"
 #include "../Helper/ListViewHelper.h"
 #include "../Helper/Macros.h"
+#include "../Helper/RegistrySettings.h"
 #include "../Helper/ShellHelper.h"
 #include "../Helper/StringHelper.h"
 #include "../Helper/WindowHelper.h"
+#include "../Helper/XMLSettings.h"
+#include <boost/format.hpp>
 #include <wil/resource.h>
 #include <regex>
 
 namespace NMergeFilesDialog
 {
-const int WM_APP_SETTOTALMERGECOUNT = WM_APP + 1;
-const int WM_APP_SETCURRENTMERGECOUNT = WM_APP + 2;
-const int WM_APP_MERGINGFINISHED = WM_APP + 3;
-const int WM_APP_OUTPUTFILEINVALID = WM_APP + 4;
+// wParam contains the progress bar position.
+const int WM_APP_MERGEPROGRESS = WM_APP + 1;
+
+// wParam contains the FileMerger::Result value, lParam contains the index of the input file that
+// caused the merge to fail (if any).
+const int WM_APP_MERGINGFINISHED = WM_APP + 2;
+
+// The progress bar tracks the number of bytes processed, scaled to this range.
+const int PROGRESS_RANGE = 1000;
 
 DWORD WINAPI MergeFilesThread(LPVOID pParam);
 }
 
 const TCHAR MergeFilesDialogPersistentSettings::SETTINGS_KEY[] = _T("MergeFiles");
 
+const TCHAR MergeFilesDialogPersistentSettings::SETTING_VERIFY_CHECKSUMS[] = _T("VerifyChecksums");
+
 bool CompareFilenames(const std::wstring &strFirst, const std::wstring &strSecond);
 
 MergeFilesDialog::MergeFilesDialog(HINSTANCE hInstance, HWND hParent, CoreInterface *coreInterface,
@@ -182,6 +193,9 @@ INT_PTR MergeFilesDialog::OnInitDialog()
 	ListView_SetColumnWidth(hListView, 2, LVSCW_AUTOSIZE_USEHEADER);
 	ListView_SetColumnWidth(hListView, 3, LVSCW_AUTOSIZE_USEHEADER);
 
+	CheckDlgButton(m_hDlg, IDC_MERGE_CHECK_VERIFY_CHECKSUMS,
+		m_persistentSettings->m_verifyChecksums ? BST_CHECKED : BST_UNCHECKED);
+
 	SendMessage(GetDlgItem(m_hDlg, IDC_MERGE_EDIT_FILENAME), EM_SETSEL, 0, -1);
 	SetFocus(GetDlgItem(m_hDlg, IDC_MERGE_EDIT_FILENAME));
 
@@ -242,6 +256,11 @@ void MergeFilesDialog::GetResizableControlInformation(BaseDialog::DialogSizeCons
 	control.Constraint = ResizableDialog::ControlConstraint::None;
 	ControlList.push_back(control);
 
+	control.iID = IDC_MERGE_CHECK_VERIFY_CHECKSUMS;
+	control.Type = ResizableDialog::ControlType::Move;
+	control.Constraint = ResizableDialog::ControlConstraint::Y;
+	ControlList.push_back(control);
+
 	control.iID = IDC_MERGE_PROGRESS;
 	control.Type = ResizableDialog::ControlType::Move;
 	control.Constraint = ResizableDialog::ControlConstraint::Y;
@@ -311,39 +330,15 @@ INT_PTR MergeFilesDialog::OnClose()
 
 INT_PTR MergeFilesDialog::OnPrivateMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
-	UNREFERENCED_PARAMETER(lParam);
-
 	switch (uMsg)
 	{
-	case NMergeFilesDialog::WM_APP_SETTOTALMERGECOUNT:
-		SendDlgItemMessage(m_hDlg, IDC_MERGE_PROGRESS, PBM_SETRANGE32, 0, wParam);
-		break;
-
-	case NMergeFilesDialog::WM_APP_SETCURRENTMERGECOUNT:
+	case NMergeFilesDialog::WM_APP_MERGEPROGRESS:
 		SendDlgItemMessage(m_hDlg, IDC_MERGE_PROGRESS, PBM_SETPOS, wParam, 0);
 		break;
 
 	case NMergeFilesDialog::WM_APP_MERGINGFINISHED:
-		OnFinished();
+		OnFinished(static_cast<FileMerger::Result>(wParam), static_cast<size_t>(lParam));
 		break;
-
-	case NMergeFilesDialog::WM_APP_OUTPUTFILEINVALID:
-	{
-		TCHAR szTemp[64];
-		LoadString(GetInstance(), IDS_MERGE_FILES_OUTPUTFILEINVALID, szTemp, SIZEOF_ARRAY(szTemp));
-		MessageBox(m_hDlg, szTemp, NExplorerplusplus::APP_NAME, MB_ICONWARNING | MB_OK);
-
-		assert(m_pMergeFiles != nullptr);
-
-		m_pMergeFiles->Release();
-		m_pMergeFiles = nullptr;
-
-		m_bMergingFiles = false;
-		m_bStopMerging = false;
-
-		SetDlgItemText(m_hDlg, IDOK, m_szOk);
-	}
-	break;
 	}
 
 	return 0;
@@ -352,6 +347,10 @@ INT_PTR MergeFilesDialog::OnPrivateMessage(UINT uMsg, WPARAM wParam, LPARAM lPar
 void MergeFilesDialog::SaveState()
 {
 	m_persistentSettings->SaveDialogPosition(m_hDlg);
+
+	m_persistentSettings->m_verifyChecksums =
+		(IsDlgButtonChecked(m_hDlg, IDC_MERGE_CHECK_VERIFY_CHECKSUMS) == BST_CHECKED);
+
 	m_persistentSettings->m_bStateSaved = TRUE;
 }
 
@@ -372,8 +371,22 @@ void MergeFilesDialog::OnOk()
 
 		std::wstring outputFileName = GetWindowString(hOutputFileName);
 
-		m_pMergeFiles = new MergeFiles(m_hDlg, outputFileName, m_FullFilenameList);
+		FileMerger::Options options;
+
+		if (IsDlgButtonChecked(m_hDlg, IDC_MERGE_CHECK_VERIFY_CHECKSUMS) == BST_CHECKED)
+		{
+			std::wstring manifestPath = GetManifestPath(outputFileName);
+
+			if (PathFileExists(manifestPath.c_str()))
+			{
+				options.manifestPath = manifestPath;
+			}
+		}
+
+		m_pMergeFiles = new MergeFiles(m_hDlg, outputFileName, m_FullFilenameList, options);
 
+		SendDlgItemMessage(m_hDlg, IDC_MERGE_PROGRESS, PBM_SETRANGE32, 0,
+			NMergeFilesDialog::PROGRESS_RANGE);
 		SendDlgItemMessage(m_hDlg, IDC_MERGE_PROGRESS, PBM_SETPOS, 0, 0);
 
 		GetDlgItemText(m_hDlg, IDOK, m_szOk, SIZEOF_ARRAY(m_szOk));
@@ -384,6 +397,10 @@ void MergeFilesDialog::OnOk()
 
 		m_bMergingFiles = true;
 
+		// The background thread holds its own reference, since the dialog may be closed before the
+		// merge has finished.
+		m_pMergeFiles->AddRef();
+
 		HANDLE hThread = CreateThread(nullptr, 0, NMergeFilesDialog::MergeFilesThread,
 			reinterpret_cast<LPVOID>(m_pMergeFiles), 0, nullptr);
 		SetThreadPriority(hThread, THREAD_PRIORITY_LOWEST);
@@ -405,6 +422,11 @@ void MergeFilesDialog::OnCancel()
 	if (m_bMergingFiles)
 	{
 		m_bStopMerging = true;
+
+		if (m_pMergeFiles != nullptr)
+		{
+			m_pMergeFiles->StopMerging();
+		}
 	}
 	else
 	{
@@ -476,7 +498,7 @@ void MergeFilesDialog::OnMove(bool bUp)
 	}
 }
 
-void MergeFilesDialog::OnFinished()
+void MergeFilesDialog::OnFinished(FileMerger::Result result, size_t failedFileIndex)
 {
 	assert(m_pMergeFiles != nullptr);
 
@@ -486,12 +508,60 @@ void MergeFilesDialog::OnFinished()
 	m_bMergingFiles = false;
 	m_bStopMerging = false;
 
-	/* Set the progress bar position to the end. */
-	int iHighLimit =
-		static_cast<int>(SendDlgItemMessage(m_hDlg, IDC_MERGE_PROGRESS, PBM_GETRANGE, FALSE, 0));
-	SendDlgItemMessage(m_hDlg, IDC_MERGE_PROGRESS, PBM_SETPOS, iHighLimit, 0);
-
 	SetDlgItemText(m_hDlg, IDOK, m_szOk);
+
+	std::wstring failedFilename;
+
+	if (failedFileIndex < m_FullFilenameList.size())
+	{
+		failedFilename = *std::next(m_FullFilenameList.begin(), failedFileIndex);
+	}
+
+	std::wstring message;
+
+	switch (result)
+	{
+	case FileMerger::Result::Succeeded:
+		/* Set the progress bar position to the end. */
+		SendDlgItemMessage(m_hDlg, IDC_MERGE_PROGRESS, PBM_SETPOS,
+			NMergeFilesDialog::PROGRESS_RANGE, 0);
+		return;
+
+	case FileMerger::Result::Cancelled:
+		return;
+
+	case FileMerger::Result::InputFileError:
+		message = ResourceHelper::LoadString(GetInstance(), IDS_MERGE_FILES_INPUTFILEINVALID);
+		message = (boost::wformat(message) % failedFilename).str();
+		break;
+
+	case FileMerger::Result::OutputFileError:
+		message = ResourceHelper::LoadString(GetInstance(), IDS_MERGE_FILES_OUTPUTFILEINVALID);
+		break;
+
+	case FileMerger::Result::ManifestError:
+		message = ResourceHelper::LoadString(GetInstance(), IDS_MERGE_FILES_CHECKSUMFILEINVALID);
+		break;
+
+	case FileMerger::Result::VerificationFailed:
+		message = ResourceHelper::LoadString(GetInstance(), IDS_MERGE_FILES_VERIFICATIONFAILED);
+		message = (boost::wformat(message) % failedFilename).str();
+		break;
+	}
+
+	SendDlgItemMessage(m_hDlg, IDC_MERGE_PROGRESS, PBM_SETPOS, 0, 0);
+	MessageBox(m_hDlg, message.c_str(), NExplorerplusplus::APP_NAME, MB_ICONWARNING | MB_OK);
+}
+
+// Split writes the checksum file alongside the parts, named after the original file.
+std::wstring MergeFilesDialog::GetManifestPath(const std::wstring &outputFilename) const
+{
+	TCHAR szManifestPath[MAX_PATH];
+	StringCchCopy(szManifestPath, SIZEOF_ARRAY(szManifestPath), m_FullFilenameList.front().c_str());
+	PathRemoveFileSpec(szManifestPath);
+
+	return std::wstring(szManifestPath) + _T("\\") + PathFindFileName(outputFilename.c_str())
+		+ ChecksumManifest::FILE_EXTENSION;
 }
 
 DWORD WINAPI NMergeFilesDialog::MergeFilesThread(LPVOID pParam)
@@ -500,101 +570,52 @@ DWORD WINAPI NMergeFilesDialog::MergeFilesThread(LPVOID pParam)
 
 	auto *pMergeFiles = reinterpret_cast<MergeFiles *>(pParam);
 	pMergeFiles->StartMerging();
+	pMergeFiles->Release();
 
 	return 0;
 }
 
 MergeFiles::MergeFiles(HWND hDlg, const std::wstring &strOutputFilename,
-	const std::list<std::wstring> &FullFilenameList)
+	const std::list<std::wstring> &FullFilenameList, const FileMerger::Options &options) :
+	m_hDlg(hDlg),
+	m_fileMerger(std::vector<std::wstring>(FullFilenameList.begin(), FullFilenameList.end()),
+		strOutputFilename, options)
 {
-	m_hDlg = hDlg;
-	m_strOutputFilename = strOutputFilename;
-	m_FullFilenameList = FullFilenameList;
-
-	m_bstopMerging = false;
-
-	InitializeCriticalSection(&m_csStop);
-}
-
-MergeFiles::~MergeFiles()
-{
-	DeleteCriticalSection(&m_csStop);
 }
 
 void MergeFiles::StartMerging()
 {
-	LARGE_INTEGER lMergeFileSize;
-	int nFilesMerged = 1;
-	bool bStop = false;
-
-	HANDLE hOutputFile = CreateFile(m_strOutputFilename.c_str(), GENERIC_WRITE, 0, nullptr,
-		CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
-
-	if (hOutputFile == INVALID_HANDLE_VALUE)
-	{
-		PostMessage(m_hDlg, NMergeFilesDialog::WM_APP_OUTPUTFILEINVALID, 0, 0);
-		return;
-	}
-
-	PostMessage(m_hDlg, NMergeFilesDialog::WM_APP_SETTOTALMERGECOUNT,
-		static_cast<WPARAM>(m_FullFilenameList.size()), 0);
-
-	for (const auto &strFullFilename : m_FullFilenameList)
-	{
-		if (bStop)
+	auto result = m_fileMerger.Merge(
+		[this](const FileMerger::Progress &progress)
 		{
-			break;
-		}
-
-		HANDLE hInputFile = CreateFile(strFullFilename.c_str(), GENERIC_READ, FILE_SHARE_READ,
-			nullptr, OPEN_EXISTING, 0, nullptr);
+			OnProgress(progress);
+		});
 
-		if (hInputFile != INVALID_HANDLE_VALUE)
-		{
-			GetFileSizeEx(hInputFile, &lMergeFileSize);
-
-			if (lMergeFileSize.QuadPart != 0)
-			{
-				auto buffer = std::make_unique<char[]>(lMergeFileSize.LowPart);
-
-				DWORD dwNumberOfBytesRead;
-				ReadFile(hInputFile, reinterpret_cast<LPVOID>(buffer.get()),
-					static_cast<DWORD>(lMergeFileSize.LowPart), &dwNumberOfBytesRead, nullptr);
-
-				DWORD dwNumberOfBytesWritten;
-				WriteFile(hOutputFile, reinterpret_cast<LPCVOID>(buffer.get()), dwNumberOfBytesRead,
-					&dwNumberOfBytesWritten, nullptr);
-			}
-
-			CloseHandle(hInputFile);
-
-			PostMessage(m_hDlg, NMergeFilesDialog::WM_APP_SETCURRENTMERGECOUNT, nFilesMerged, 0);
+	SendMessage(m_hDlg, NMergeFilesDialog::WM_APP_MERGINGFINISHED, static_cast<WPARAM>(result),
+		static_cast<LPARAM>(m_fileMerger.GetFailedFileIndex()));
+}
 
-			nFilesMerged++;
+void MergeFiles::OnProgress(const FileMerger::Progress &progress)
+{
+	int position = 0;
 
-			EnterCriticalSection(&m_csStop);
-			if (m_bstopMerging)
-			{
-				bStop = true;
-			}
-			LeaveCriticalSection(&m_csStop);
-		}
+	if (progress.totalBytes > 0)
+	{
+		position = static_cast<int>(
+			progress.bytesProcessed * NMergeFilesDialog::PROGRESS_RANGE / progress.totalBytes);
 	}
 
-	CloseHandle(hOutputFile);
-
-	SendMessage(m_hDlg, NMergeFilesDialog::WM_APP_MERGINGFINISHED, 0, 0);
+	PostMessage(m_hDlg, NMergeFilesDialog::WM_APP_MERGEPROGRESS, position, 0);
 }
 
 void MergeFiles::StopMerging()
 {
-	EnterCriticalSection(&m_csStop);
-	m_bstopMerging = true;
-	LeaveCriticalSection(&m_csStop);
+	m_fileMerger.Cancel();
 }
 
 MergeFilesDialogPersistentSettings::MergeFilesDialogPersistentSettings() :
-	DialogSettings(SETTINGS_KEY)
+	DialogSettings(SETTINGS_KEY),
+	m_verifyChecksums(true)
 {
 }
 
@@ -603,3 +624,29 @@ MergeFilesDialogPersistentSettings &MergeFilesDialogPersistentSettings::GetInsta
 	static MergeFilesDialogPersistentSettings mfdps;
 	return mfdps;
 }
+
+void MergeFilesDialogPersistentSettings::SaveExtraRegistrySettings(HKEY hKey)
+{
+	RegistrySettings::SaveDword(hKey, SETTING_VERIFY_CHECKSUMS, m_verifyChecksums);
+}
+
+void MergeFilesDialogPersistentSettings::LoadExtraRegistrySettings(HKEY hKey)
+{
+	RegistrySettings::Read32BitValueFromRegistry(hKey, SETTING_VERIFY_CHECKSUMS,
+		m_verifyChecksums);
+}
+
+void MergeFilesDialogPersistentSettings::SaveExtraXMLSettings(IXMLDOMDocument *pXMLDom,
+	IXMLDOMElement *pParentNode)
+{
+	NXMLSettings::AddAttributeToNode(pXMLDom, pParentNode, SETTING_VERIFY_CHECKSUMS,
+		NXMLSettings::EncodeBoolValue(m_verifyChecksums));
+}
+
+void MergeFilesDialogPersistentSettings::LoadExtraXMLSettings(BSTR bstrName, BSTR bstrValue)
+{
+	if (lstrcmpi(bstrName, SETTING_VERIFY_CHECKSUMS) == 0)
+	{
+		m_verifyChecksums = NXMLSettings::DecodeBoolValue(bstrValue);
+	}
+}
@@ -6,6 +6,7 @@
 
 #include "DarkModeDialogBase.h"
 #include "../Helper/DialogSettings.h"
+#include "../Helper/FileMerger.h"
 #include "../Helper/ReferenceCount.h"
 #include "../Helper/ResizableDialog.h"
 
@@ -22,30 +23,37 @@ private:
 
 	static const TCHAR SETTINGS_KEY[];
 
+	static const TCHAR SETTING_VERIFY_CHECKSUMS[];
+
 	MergeFilesDialogPersistentSettings();
 
 	MergeFilesDialogPersistentSettings(const MergeFilesDialogPersistentSettings &);
 	MergeFilesDialogPersistentSettings &operator=(const MergeFilesDialogPersistentSettings &);
+
+	void SaveExtraRegistrySettings(HKEY hKey) override;
+	void LoadExtraRegistrySettings(HKEY hKey) override;
+
+	void SaveExtraXMLSettings(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pParentNode) override;
+	void LoadExtraXMLSettings(BSTR bstrName, BSTR bstrValue) override;
+
+	bool m_verifyChecksums;
 };
 
 class MergeFiles : public ReferenceCount
 {
 public:
 	MergeFiles(HWND hDlg, const std::wstring &strOutputFilename,
-		const std::list<std::wstring> &FullFilenameList);
-	~MergeFiles();
+		const std::list<std::wstring> &FullFilenameList, const FileMerger::Options &options);
 
 	void StartMerging();
 	void StopMerging();
 
 private:
-	HWND m_hDlg;
+	void OnProgress(const FileMerger::Progress &progress);
 
-	std::wstring m_strOutputFilename;
-	std::list<std::wstring> m_FullFilenameList;
+	HWND m_hDlg;
 
-	CRITICAL_SECTION m_csStop;
-	bool m_bstopMerging;
+	FileMerger m_fileMerger;
 };
 
 class MergeFilesDialog : public DarkModeDialogBase
@@ -74,7 +82,8 @@ private:
 	void OnCancel();
 	void OnChangeOutputDirectory();
 	void OnMove(bool bUp);
-	void OnFinished();
+	void OnFinished(FileMerger::Result result, size_t failedFileIndex);
+	std::wstring GetManifestPath(const std::wstring &outputFilename) const;
 
 	CoreInterface *m_coreInterface;
 
@@ -7,17 +7,74 @@
 #include "Config.h"
 #include "DisplayWindow/DisplayWindow.h"
 #include "Explorer++_internal.h"
+#include "FileTransferErrorHelper.h"
 #include "MainResource.h"
+#include "ResourceHelper.h"
 #include "SelectColumnsDialog.h"
 #include "ShellBrowser/ShellBrowser.h"
 #include "ShellTreeView/ShellTreeView.h"
 #include "TabContainer.h"
 #include "../Helper/Controls.h"
 #include "../Helper/FileOperations.h"
+#include "../Helper/FileTransferEngine.h"
 #include "../Helper/Logging.h"
 #include "../Helper/Macros.h"
+#include "../Helper/StringHelper.h"
 #include "../Helper/WindowHelper.h"
+#include <boost/format.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <wil/com.h>
+#include <filesystem>
+
+namespace
+{
+
+const int RESUME_BUTTON_ID = 100;
+const int REPLACE_BUTTON_ID = 101;
+const int SKIP_BUTTON_ID = 102;
+
+// Asks how files that already exist in the destination should be handled. Returns the ID of the
+// button that was clicked (which will be IDCANCEL if the transfer shouldn't go ahead).
+int PromptForFileTransferConflictAction(HWND parent, HINSTANCE resourceInstance,
+	size_t numConflicts)
+{
+	std::wstring instructionTemplate =
+		ResourceHelper::LoadString(resourceInstance, IDS_FILE_TRANSFER_CONFLICTS);
+	std::wstring instruction = (boost::wformat(instructionTemplate) % numConflicts).str();
+	std::wstring resumeText =
+		ResourceHelper::LoadString(resourceInstance, IDS_FILE_TRANSFER_CONFLICT_RESUME);
+	std::wstring replaceText =
+		ResourceHelper::LoadString(resourceInstance, IDS_FILE_TRANSFER_CONFLICT_REPLACE);
+	std::wstring skipText =
+		ResourceHelper::LoadString(resourceInstance, IDS_FILE_TRANSFER_CONFLICT_SKIP);
+
+	TASKDIALOG_BUTTON buttons[] = { { RESUME_BUTTON_ID, resumeText.c_str() },
+		{ REPLACE_BUTTON_ID, replaceText.c_str() }, { SKIP_BUTTON_ID, skipText.c_str() } };
+
+	TASKDIALOGCONFIG dialogConfig = { 0 };
+	dialogConfig.cbSize = sizeof(dialogConfig);
+	dialogConfig.hwndParent = parent;
+	dialogConfig.dwFlags = TDF_ALLOW_DIALOG_CANCELLATION | TDF_USE_COMMAND_LINKS;
+	dialogConfig.dwCommonButtons = TDCBF_CANCEL_BUTTON;
+	dialogConfig.pszWindowTitle = NExplorerplusplus::APP_NAME;
+	dialogConfig.pszMainIcon = TD_WARNING_ICON;
+	dialogConfig.pszMainInstruction = instruction.c_str();
+	dialogConfig.cButtons = static_cast<UINT>(std::size(buttons));
+	dialogConfig.pButtons = buttons;
+	dialogConfig.nDefaultButton = RESUME_BUTTON_ID;
+
+	int button;
+	HRESULT hr = TaskDialogIndirect(&dialogConfig, &button, nullptr, nullptr);
+
+	if (FAILED(hr))
+	{
+		return IDCANCEL;
+	}
+
+	return button;
+}
+
+}
 
 void Explorerplusplus::ValidateLoadedSettings()
 {
@@ -273,9 +330,252 @@ void Explorerplusplus::CopyToFolder(bool move)
 
 	TCHAR szTemp[128];
 	LoadString(m_resourceModule, IDS_GENERAL_COPY_TO_FOLDER_TITLE, szTemp, SIZEOF_ARRAY(szTemp));
+
+	if (m_config->useBuiltInFileTransfer && TransferItemsToFolder(szTemp, pidls, move))
+	{
+		return;
+	}
+
 	NFileOperations::CopyFilesToFolder(m_hContainer, szTemp, pidls, move);
 }
 
+// Prompts for a destination folder and then transfers the items using FileTransferEngine. Returns
+// false if the items can't be transferred that way, in which case the shell should be used
+// instead.
+bool Explorerplusplus::TransferItemsToFolder(const std::wstring &title,
+	std::vector<PCIDLIST_ABSOLUTE> &pidls, bool move)
+{
+	if (m_fileTransferEngine)
+	{
+		return false;
+	}
+
+	std::vector<std::filesystem::path> sources;
+
+	for (auto pidl : pidls)
+	{
+		TCHAR path[MAX_PATH];
+
+		// Items outside the filesystem (e.g. items within a zip file) can only be transferred
+		// by the shell.
+		if (!SHGetPathFromIDList(pidl, path))
+		{
+			return false;
+		}
+
+		sources.emplace_back(path);
+	}
+
+	unique_pidl_absolute destinationPidl;
+
+	if (!NFileOperations::CreateBrowseDialog(m_hContainer, title, wil::out_param(destinationPidl)))
+	{
+		return true;
+	}
+
+	TCHAR destination[MAX_PATH];
+
+	if (!SHGetPathFromIDList(destinationPidl.get(), destination))
+	{
+		wil::com_ptr_nothrow<IShellItem> destinationFolder;
+		HRESULT hr =
+			SHCreateItemFromIDList(destinationPidl.get(), IID_PPV_ARGS(&destinationFolder));
+
+		if (SUCCEEDED(hr))
+		{
+			NFileOperations::CopyFiles(m_hContainer, destinationFolder.get(), pidls, move);
+		}
+
+		return true;
+	}
+
+	// Building the plan doesn't depend on how existing files will be handled, so a default set
+	// of options can be used here. The engine that runs the transfer is created once the plan
+	// has been built.
+	m_fileTransferMove = move;
+	m_fileTransferEngine = std::make_unique<FileTransferEngine>(FileTransferEngine::Options{});
+
+	m_fileTransferThread = std::thread(
+		[this, sources, destinationDirectory = std::filesystem::path(destination)]
+		{
+			auto plan = m_fileTransferEngine->BuildPlan(sources, destinationDirectory);
+
+			if (plan)
+			{
+				m_fileTransferNumConflicts = m_fileTransferEngine->CountConflicts(*plan);
+				m_fileTransferPlan = std::make_unique<FileTransferPlan>(std::move(*plan));
+			}
+
+			PostMessage(m_hContainer, WM_APP_FILETRANSFERPLANNED, 0, 0);
+		});
+
+	return true;
+}
+
+void Explorerplusplus::OnFileTransferPlanned()
+{
+	m_fileTransferThread.join();
+
+	if (!m_fileTransferPlan)
+	{
+		EndFileTransfer();
+
+		std::wstring message = ResourceHelper::LoadString(m_resourceModule,
+			IDS_FILE_TRANSFER_DESTINATION_WITHIN_SOURCE);
+		MessageBox(m_hContainer, message.c_str(), NExplorerplusplus::APP_NAME,
+			MB_ICONWARNING | MB_OK);
+		return;
+	}
+
+	FileTransferEngine::Options options;
+	options.operation = m_fileTransferMove ? FileTransferEngine::Operation::Move
+										   : FileTransferEngine::Operation::Copy;
+
+	if (m_fileTransferNumConflicts > 0)
+	{
+		int button = PromptForFileTransferConflictAction(m_hContainer, m_resourceModule,
+			m_fileTransferNumConflicts);
+
+		switch (button)
+		{
+		case RESUME_BUTTON_ID:
+			options.resume = true;
+			break;
+
+		case REPLACE_BUTTON_ID:
+			options.conflictAction = FileTransferEngine::ConflictAction::Overwrite;
+			break;
+
+		case SKIP_BUTTON_ID:
+			options.conflictAction = FileTransferEngine::ConflictAction::Skip;
+			break;
+
+		default:
+			EndFileTransfer();
+			return;
+		}
+	}
+
+	m_fileTransferEngine = std::make_unique<FileTransferEngine>(options);
+
+	// The shell's progress dialog is modeless and runs on its own thread, so it doesn't block
+	// the rest of the application. It's only used to show progress and allow the transfer to be
+	// cancelled. If it can't be created, the transfer will simply run without it.
+	HRESULT hr = CoCreateInstance(CLSID_ProgressDialog, nullptr, CLSCTX_INPROC_SERVER,
+		IID_PPV_ARGS(&m_fileTransferProgressDialog));
+
+	if (SUCCEEDED(hr))
+	{
+		std::wstring title = ResourceHelper::LoadString(m_resourceModule,
+			m_fileTransferMove ? IDS_FILE_TRANSFER_MOVING : IDS_FILE_TRANSFER_COPYING);
+		m_fileTransferProgressDialog->SetTitle(title.c_str());
+		m_fileTransferProgressDialog->StartProgressDialog(m_hContainer, nullptr,
+			PROGDLG_NORMAL | PROGDLG_NOMINIMIZE, nullptr);
+	}
+
+	m_fileTransferThread = std::thread(
+		[this]
+		{
+			m_fileTransferEngine->Run(*m_fileTransferPlan);
+			PostMessage(m_hContainer, WM_APP_FILETRANSFERCOMPLETED, 0, 0);
+		});
+
+	SetTimer(m_hContainer, FILE_TRANSFER_PROGRESS_TIMER_ID, FILE_TRANSFER_PROGRESS_INTERVAL,
+		nullptr);
+}
+
+// While a transfer is running, its progress is shown in the last part of the status bar.
+void Explorerplusplus::UpdateFileTransferProgress()
+{
+	if (!m_fileTransferEngine)
+	{
+		return;
+	}
+
+	if (m_fileTransferProgressDialog && m_fileTransferProgressDialog->HasUserCancelled())
+	{
+		m_fileTransferEngine->Cancel();
+	}
+
+	auto progress = m_fileTransferEngine->GetProgress();
+	int percentage = 0;
+
+	if (progress.totalBytes > 0)
+	{
+		percentage = static_cast<int>(progress.transferredBytes * 100 / progress.totalBytes);
+	}
+
+	TCHAR szProgress[128];
+
+	if (progress.bytesPerSecond && progress.estimatedTimeRemaining)
+	{
+		ULARGE_INTEGER bytesPerSecond;
+		bytesPerSecond.QuadPart = static_cast<ULONGLONG>(*progress.bytesPerSecond);
+
+		TCHAR szRate[32];
+		FormatSizeString(bytesPerSecond, szRate, SIZEOF_ARRAY(szRate));
+
+		auto secondsRemaining = progress.estimatedTimeRemaining->count();
+		std::wstring format =
+			ResourceHelper::LoadString(m_resourceModule, IDS_FILE_TRANSFER_PROGRESS_WITH_RATE);
+		StringCchPrintf(szProgress, SIZEOF_ARRAY(szProgress), format.c_str(), percentage,
+			szRate, secondsRemaining / 60, secondsRemaining % 60);
+	}
+	else
+	{
+		std::wstring format =
+			ResourceHelper::LoadString(m_resourceModule, IDS_FILE_TRANSFER_PROGRESS);
+		StringCchPrintf(szProgress, SIZEOF_ARRAY(szProgress), format.c_str(), percentage);
+	}
+
+	SendMessage(m_hStatusBar, SB_SETTEXT, 2 | 0, reinterpret_cast<LPARAM>(szProgress));
+
+	if (m_fileTransferProgressDialog)
+	{
+		m_fileTransferProgressDialog->SetProgress64(progress.transferredBytes,
+			progress.totalBytes);
+		m_fileTransferProgressDialog->SetLine(1, szProgress, FALSE, nullptr);
+	}
+}
+
+void Explorerplusplus::OnFileTransferCompleted()
+{
+	KillTimer(m_hContainer, FILE_TRANSFER_PROGRESS_TIMER_ID);
+
+	m_fileTransferThread.join();
+
+	// Items that couldn't be read while building the plan were left out of the transfer, so
+	// they're reported alongside any items that failed during the transfer itself. If the
+	// transfer was cancelled, there may be no errors to report.
+	auto errors = m_fileTransferPlan->errors;
+	auto transferErrors = m_fileTransferEngine->GetErrors();
+	errors.insert(errors.end(), transferErrors.begin(), transferErrors.end());
+
+	for (const auto &error : errors)
+	{
+		LOG(warning) << L"Couldn't transfer \"" << error.path.wstring() << L"\"";
+	}
+
+	EndFileTransfer();
+
+	UpdateStatusBarText(m_tabContainer->GetSelectedTab());
+
+	ShowFileTransferErrors(m_hContainer, m_resourceModule, errors);
+}
+
+void Explorerplusplus::EndFileTransfer()
+{
+	if (m_fileTransferProgressDialog)
+	{
+		m_fileTransferProgressDialog->StopProgressDialog();
+		m_fileTransferProgressDialog.reset();
+	}
+
+	m_fileTransferEngine.reset();
+	m_fileTransferPlan.reset();
+	m_fileTransferNumConflicts = 0;
+}
+
 LRESULT Explorerplusplus::OnDeviceChange(WPARAM wParam, LPARAM lParam)
 {
 	/* Forward this notification out to all tabs (if a
@@ -308,29 +608,32 @@ Possible bugs:
    If this runs after the tab is freed, the tab existence
    check will fail, and the shell browser function won't be called.
 */
-void Explorerplusplus::DirectoryAlteredCallback(const TCHAR *szFileName, DWORD dwAction,
-	void *pData)
+void Explorerplusplus::OnDirectoryAltered(int tabId, int folderId, const std::wstring &fileName,
+	DWORD action)
 {
-	DirectoryAltered *pDirectoryAltered = nullptr;
-	Explorerplusplus *pContainer = nullptr;
-
-	pDirectoryAltered = (DirectoryAltered *) pData;
-	pContainer = (Explorerplusplus *) pDirectoryAltered->pData;
-
-	Tab *tab = pContainer->m_tabContainer->GetTabOptional(pDirectoryAltered->iIndex);
+	Tab *tab = m_tabContainer->GetTabOptional(tabId);
 
 	if (tab)
 	{
 		std::wstring directory = tab->GetShellBrowser()->GetDirectory();
 		LOG(debug) << _T("Directory change notification received for \"") << directory
-				   << _T("\", Action = ") << dwAction << _T(", Filename = \"") << szFileName
+				   << _T("\", Action = ") << action << _T(", Filename = \"") << fileName
 				   << _T("\"");
 
-		tab->GetShellBrowser()->FilesModified(dwAction, szFileName, pDirectoryAltered->iIndex,
-			pDirectoryAltered->iFolderIndex);
+		tab->GetShellBrowser()->FilesModified(action, fileName.c_str(), tabId, folderId);
 	}
 }
 
+/* RUNS IN CONTEXT OF DIRECTORY MOINTORING WORKER THREAD.
+Passes the notification on to the directory watch registry,
+which will then forward it to each of the watch's subscribers. */
+void Explorerplusplus::DirectoryAlteredCallback(const TCHAR *szFileName, DWORD dwAction,
+	void *pData)
+{
+	auto *context = reinterpret_cast<DirectoryWatchContext *>(pData);
+	context->registry->OnNotification(context->watchId, szFileName, dwAction);
+}
+
 void Explorerplusplus::FolderSizeCallbackStub(int nFolders, int nFiles,
 	PULARGE_INTEGER lTotalFolderSize, LPVOID pData)
 {
@@ -20,6 +20,7 @@
 #include "ShellBrowser/ViewModes.h"
 #include "ShellTreeView/ShellTreeView.h"
 #include "TabContainer.h"
+#include "XMLSettings.h"
 #include "../Helper/BulkClipboardWriter.h"
 #include "../Helper/Controls.h"
 #include "../Helper/DpiCompatibility.h"
@@ -27,14 +28,14 @@
 #include "../Helper/Logging.h"
 #include "../Helper/Macros.h"
 #include "../Helper/MenuHelper.h"
-#include "../Helper/ProcessHelper.h"
 #include "../Helper/RegistrySettings.h"
 #include "../Helper/ShellHelper.h"
+#include "../Helper/TraceRecorder.h"
 #include "../Helper/WindowHelper.h"
-#include "../Helper/iDirectoryMonitor.h"
 #include <boost/range/adaptor/map.hpp>
 #include <wil/resource.h>
 #include <algorithm>
+#include <chrono>
 
 /* The treeview is offset by a small
 amount on the left. */
@@ -47,6 +48,8 @@ static const int TREEVIEW_HOLDER_CLEARANCE = 4;
 const int CLOSE_TOOLBAR_X_OFFSET = 4;
 const int CLOSE_TOOLBAR_Y_OFFSET = 1;
 
+const WCHAR BOOKMARK_JOURNAL_FILENAME[] = L"bookmarks.journal";
+
 void Explorerplusplus::TestConfigFile()
 {
 	m_bLoadSettingsFromXML = TestConfigFileInternal();
@@ -55,19 +58,10 @@ void Explorerplusplus::TestConfigFile()
 BOOL TestConfigFileInternal()
 {
 	HANDLE hConfigFile;
-	TCHAR szConfigFile[MAX_PATH];
 	BOOL bLoadSettingsFromXML = FALSE;
 
-	/* To ensure the configuration file is loaded from the same directory
-	as the executable, determine the fully qualified path of the executable,
-	then save the configuration file in that directory. */
-	GetProcessImageName(GetCurrentProcessId(), szConfigFile, SIZEOF_ARRAY(szConfigFile));
-
-	PathRemoveFileSpec(szConfigFile);
-	PathAppend(szConfigFile, NExplorerplusplus::XML_FILENAME);
-
-	hConfigFile =
-		CreateFile(szConfigFile, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, nullptr);
+	hConfigFile = CreateFile(GetXmlConfigFilePath().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, 0, nullptr);
 
 	if (hConfigFile != INVALID_HANDLE_VALUE)
 	{
@@ -81,6 +75,8 @@ BOOL TestConfigFileInternal()
 
 void Explorerplusplus::LoadAllSettings(ILoadSave **pLoadSave)
 {
+	TRACE_FUNCTION();
+
 	/* Tests for the existence of the configuration
 	file. If the file is present, a flag is set
 	indicating that the config file should be used
@@ -115,6 +111,51 @@ void Explorerplusplus::LoadAllSettings(ILoadSave **pLoadSave)
 	ValidateLoadedSettings();
 }
 
+void Explorerplusplus::LoadBookmarkJournal(
+	const std::optional<BookmarkJournalPosition> &snapshotPosition)
+{
+	// Once the journal has grown large enough, saving the settings writes out the full set of
+	// bookmarks, after which the journal is trimmed.
+	m_bookmarkJournal = std::make_unique<BookmarkJournal>(&m_bookmarkTree,
+		GetBookmarkJournalPath(), [this] { SaveAllSettings(); });
+
+	if (!m_bookmarkJournal->Load(snapshotPosition))
+	{
+		LOG(warning) << L"Couldn't open the bookmark journal. Bookmark changes will only be saved "
+						L"along with the other settings.";
+	}
+}
+
+/* When settings are loaded from the config file, the journal is
+stored alongside it, so that the application remains portable.
+Otherwise, it's stored in the user's local application data
+folder. */
+std::wstring Explorerplusplus::GetBookmarkJournalPath() const
+{
+	if (m_bLoadSettingsFromXML)
+	{
+		std::filesystem::path journalPath(GetXmlConfigFilePath());
+		journalPath.replace_filename(BOOKMARK_JOURNAL_FILENAME);
+		return journalPath.wstring();
+	}
+
+	wil::unique_cotaskmem_string localAppDataPath;
+	HRESULT hr = SHGetKnownFolderPath(FOLDERID_LocalAppData, KF_FLAG_CREATE, nullptr,
+		&localAppDataPath);
+
+	if (FAILED(hr))
+	{
+		return {};
+	}
+
+	std::filesystem::path journalPath(localAppDataPath.get());
+	journalPath /= NExplorerplusplus::APP_NAME;
+	CreateDirectory(journalPath.c_str(), nullptr);
+	journalPath /= BOOKMARK_JOURNAL_FILENAME;
+
+	return journalPath.wstring();
+}
+
 void Explorerplusplus::OpenItem(const std::wstring &itemPath,
 	OpenFolderDisposition openFolderDisposition)
 {
@@ -694,7 +735,10 @@ int Explorerplusplus::CloseApplication()
 
 	KillTimer(m_hContainer, AUTOSAVE_TIMER_ID);
 
-	SaveAllSettings();
+	SaveAllSettingsNow();
+
+	// Waits for the configuration file to be written.
+	m_xmlSettingsSaver.reset();
 
 	DestroyWindow(m_hContainer);
 
@@ -713,22 +757,25 @@ void Explorerplusplus::StartDirectoryMonitoringForTab(const Tab &tab)
 		return;
 	}
 
-	DirectoryAltered *directoryAltered = (DirectoryAltered *) malloc(sizeof(DirectoryAltered));
-
-	directoryAltered->iIndex = tab.GetId();
-	directoryAltered->iFolderIndex = tab.GetShellBrowser()->GetUniqueFolderId();
-	directoryAltered->pData = this;
+	int tabId = tab.GetId();
+	int folderId = tab.GetShellBrowser()->GetUniqueFolderId();
 
 	std::wstring directoryToWatch = tab.GetShellBrowser()->GetDirectory();
 
-	/* Start monitoring the directory that was opened. */
+	/* Start monitoring the directory that was opened. If another
+	tab is already showing the same directory, the existing watch
+	will be shared. */
 	LOG(debug) << _T("Starting directory monitoring for \"") << directoryToWatch << _T("\"");
-	auto dirMonitorId = m_pDirMon->WatchDirectory(directoryToWatch.c_str(),
+	auto dirMonitorId = m_directoryWatchRegistry->Subscribe(directoryToWatch,
 		FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_DIR_NAME
 			| FILE_NOTIFY_CHANGE_ATTRIBUTES | FILE_NOTIFY_CHANGE_LAST_WRITE
 			| FILE_NOTIFY_CHANGE_LAST_ACCESS | FILE_NOTIFY_CHANGE_CREATION
 			| FILE_NOTIFY_CHANGE_SECURITY,
-		DirectoryAlteredCallback, FALSE, (void *) directoryAltered);
+		false,
+		[this, tabId, folderId](const std::wstring &fileName, uint32_t action)
+		{
+			OnDirectoryAltered(tabId, folderId, fileName, action);
+		});
 
 	if (!dirMonitorId)
 	{
@@ -747,7 +794,7 @@ void Explorerplusplus::StopDirectoryMonitoringForTab(const Tab &tab)
 		return;
 	}
 
-	m_pDirMon->StopDirectoryMonitor(*dirMonitorId);
+	m_directoryWatchRegistry->Unsubscribe(*dirMonitorId);
 	tab.GetShellBrowser()->ClearDirMonitorId();
 }
 
@@ -966,7 +1013,7 @@ void Explorerplusplus::OnAppCommand(UINT cmd)
 void Explorerplusplus::OnRefresh()
 {
 	Tab &tab = m_tabContainer->GetSelectedTab();
-	tab.GetShellBrowser()->GetNavigationController()->Refresh();
+	tab.GetShellBrowser()->RefreshChangedItems();
 }
 
 void Explorerplusplus::CopyColumnInfoToClipboard()
@@ -1287,6 +1334,19 @@ void Explorerplusplus::OnGroupBy(SortMode sortMode)
 
 void Explorerplusplus::SaveAllSettings()
 {
+	SetTimer(m_hContainer, SAVE_SETTINGS_TIMER_ID, SAVE_SETTINGS_DELAY, nullptr);
+}
+
+/* When saving to the XML file, this only builds the document. The
+file itself is written on a background thread. Building the document
+(and saving registry settings) still happens on this thread, so the
+time taken is logged. */
+void Explorerplusplus::SaveAllSettingsNow()
+{
+	KillTimer(m_hContainer, SAVE_SETTINGS_TIMER_ID);
+
+	auto startTime = std::chrono::steady_clock::now();
+
 	m_iLastSelectedTab = m_tabContainer->GetSelectedTabIndex();
 
 	ILoadSave *pLoadSave = nullptr;
@@ -1306,6 +1366,32 @@ void Explorerplusplus::SaveAllSettings()
 	pLoadSave->SaveDialogStates();
 
 	delete pLoadSave;
+
+	auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - startTime);
+	LOG(info) << L"Settings save took " << duration.count() << L" ms on the UI thread";
+}
+
+BackgroundFileSaver *Explorerplusplus::GetXmlSettingsSaver()
+{
+	if (!m_xmlSettingsSaver)
+	{
+		m_xmlSettingsSaver = std::make_unique<BackgroundFileSaver>(GetXmlConfigFilePath(),
+			[](const BackgroundFileSaver::SaveResult &result)
+			{
+				if (result.succeeded)
+				{
+					LOG(info) << L"Saved settings (" << result.size << L" bytes) in "
+							  << result.duration.count() << L" ms";
+				}
+				else
+				{
+					LOG(warning) << L"Couldn't save settings to the configuration file";
+				}
+			});
+	}
+
+	return m_xmlSettingsSaver.get();
 }
 
 const Config *Explorerplusplus::GetConfig() const
@@ -1358,9 +1444,9 @@ HWND Explorerplusplus::GetTreeView() const
 	return m_shellTreeView->GetHWND();
 }
 
-IDirectoryMonitor *Explorerplusplus::GetDirectoryMonitor() const
+DirectoryWatchRegistry *Explorerplusplus::GetDirectoryWatchRegistry() const
 {
-	return m_pDirMon;
+	return m_directoryWatchRegistry.get();
 }
 
 IconResourceLoader *Explorerplusplus::GetIconResourceLoader() const
@@ -1373,6 +1459,11 @@ CachedIcons *Explorerplusplus::GetCachedIcons()
 	return &m_cachedIcons;
 }
 
+ChecksumService *Explorerplusplus::GetChecksumService()
+{
+	return &m_checksumService;
+}
+
 BOOL Explorerplusplus::GetSavePreferencesToXmlFile() const
 {
 	return m_bSavePreferencesToXMLFile;
@@ -1802,6 +1802,14 @@ std::vector<OptionsDialog::AdvancedOption> OptionsDialog::InitializeAdvancedOpti
 		IDS_ADVANCED_OPTION_OPEN_TABS_IN_FOREGROUND_DESCRIPTION);
 	advancedOptions.push_back(option);
 
+	option.id = AdvancedOptionId::UseBuiltInFileTransfer;
+	option.name =
+		ResourceHelper::LoadString(m_instance, IDS_ADVANCED_OPTION_USE_BUILT_IN_FILE_TRANSFER_NAME);
+	option.type = AdvancedOptionType::Boolean;
+	option.description = ResourceHelper::LoadString(m_instance,
+		IDS_ADVANCED_OPTION_USE_BUILT_IN_FILE_TRANSFER_DESCRIPTION);
+	advancedOptions.push_back(option);
+
 	return advancedOptions;
 }
 
@@ -1850,6 +1858,9 @@ bool OptionsDialog::GetBooleanConfigValue(OptionsDialog::AdvancedOptionId id)
 	case AdvancedOptionId::OpenTabsInForeground:
 		return m_config->openTabsInForeground;
 
+	case AdvancedOptionId::UseBuiltInFileTransfer:
+		return m_config->useBuiltInFileTransfer;
+
 	default:
 		assert(false);
 		break;
@@ -1874,6 +1885,10 @@ void OptionsDialog::SetBooleanConfigValue(OptionsDialog::AdvancedOptionId id, bo
 		m_config->openTabsInForeground = value;
 		break;
 
+	case AdvancedOptionId::UseBuiltInFileTransfer:
+		m_config->useBuiltInFileTransfer = value;
+		break;
+
 	default:
 		assert(false);
 		break;
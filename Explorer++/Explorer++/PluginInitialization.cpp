@@ -8,12 +8,15 @@
 #include "MenuHelper.h"
 #include "Plugins/PluginManager.h"
 #include "../Helper/ProcessHelper.h"
+#include "../Helper/TraceRecorder.h"
 #include <filesystem>
 
 static const std::wstring PLUGIN_FOLDER_NAME = L"plugins";
 
 void Explorerplusplus::InitializePlugins()
 {
+	TRACE_FUNCTION();
+
 	if (!m_commandLineSettings.enablePlugins)
 	{
 		return;
@@ -19,11 +19,13 @@
 #include "UiTheming.h"
 #include <sol/sol.hpp>
 
-void BindTabsAPI(sol::state &state, CoreInterface *coreInterface, TabContainer *tabContainer);
-void BindMenuApi(sol::state &state, Plugins::PluginMenuManager *pluginMenuManager);
-void BindUiApi(sol::state &state, UiTheming *uiTheming);
+void BindTabsAPI(sol::state &state, CoreInterface *coreInterface, TabContainer *tabContainer,
+	Plugins::PluginBridge *bridge);
+void BindMenuApi(sol::state &state, Plugins::PluginMenuManager *pluginMenuManager,
+	Plugins::PluginBridge *bridge);
+void BindUiApi(sol::state &state, UiTheming *uiTheming, Plugins::PluginBridge *bridge);
 void BindCommandApi(int pluginId, sol::state &state,
-	Plugins::PluginCommandManager *pluginCommandManager);
+	Plugins::PluginCommandManager *pluginCommandManager, Plugins::PluginBridge *bridge);
 template <typename T>
 void BindObserverMethods(sol::state &state, sol::table &parentTable,
 	const std::string &observerTableName, const std::shared_ptr<T> &object);
@@ -32,18 +34,21 @@ void AddEnum(sol::state &state, sol::table &parentTable, const std::string &name
 sol::table MarkTableReadOnly(sol::state &state, sol::table &table);
 int deny(lua_State *state);
 
-void Plugins::BindAllApiMethods(int pluginId, sol::state &state, PluginInterface *pluginInterface)
+void Plugins::BindAllApiMethods(int pluginId, sol::state &state, PluginInterface *pluginInterface,
+	PluginBridge *bridge)
 {
-	BindTabsAPI(state, pluginInterface->GetCoreInterface(), pluginInterface->GetTabContainer());
-	BindMenuApi(state, pluginInterface->GetPluginMenuManager());
-	BindUiApi(state, pluginInterface->GetUiTheming());
-	BindCommandApi(pluginId, state, pluginInterface->GetPluginCommandManager());
+	BindTabsAPI(state, pluginInterface->GetCoreInterface(), pluginInterface->GetTabContainer(),
+		bridge);
+	BindMenuApi(state, pluginInterface->GetPluginMenuManager(), bridge);
+	BindUiApi(state, pluginInterface->GetUiTheming(), bridge);
+	BindCommandApi(pluginId, state, pluginInterface->GetPluginCommandManager(), bridge);
 }
 
-void BindTabsAPI(sol::state &state, CoreInterface *coreInterface, TabContainer *tabContainer)
+void BindTabsAPI(sol::state &state, CoreInterface *coreInterface, TabContainer *tabContainer,
+	Plugins::PluginBridge *bridge)
 {
 	std::shared_ptr<Plugins::TabsApi> tabsApi =
-		std::make_shared<Plugins::TabsApi>(coreInterface, tabContainer);
+		std::make_shared<Plugins::TabsApi>(coreInterface, tabContainer, bridge);
 
 	sol::table tabsTable = state.create_named_table("tabs");
 	sol::table tabsMetaTable = MarkTableReadOnly(state, tabsTable);
@@ -57,18 +62,19 @@ void BindTabsAPI(sol::state &state, CoreInterface *coreInterface, TabContainer *
 	tabsMetaTable.set_function("close", &Plugins::TabsApi::close, tabsApi);
 
 	std::shared_ptr<Plugins::TabCreated> tabCreated =
-		std::make_shared<Plugins::TabCreated>(tabContainer);
+		std::make_shared<Plugins::TabCreated>(tabContainer, bridge);
 	BindObserverMethods(state, tabsMetaTable, "onCreated", tabCreated);
 
-	std::shared_ptr<Plugins::TabMoved> tabMoved = std::make_shared<Plugins::TabMoved>(tabContainer);
+	std::shared_ptr<Plugins::TabMoved> tabMoved =
+		std::make_shared<Plugins::TabMoved>(tabContainer, bridge);
 	BindObserverMethods(state, tabsMetaTable, "onMoved", tabMoved);
 
 	std::shared_ptr<Plugins::TabUpdated> tabUpdated =
-		std::make_shared<Plugins::TabUpdated>(tabContainer);
+		std::make_shared<Plugins::TabUpdated>(tabContainer, bridge);
 	BindObserverMethods(state, tabsMetaTable, "onUpdated", tabUpdated);
 
 	std::shared_ptr<Plugins::TabRemoved> tabRemoved =
-		std::make_shared<Plugins::TabRemoved>(tabContainer);
+		std::make_shared<Plugins::TabRemoved>(tabContainer, bridge);
 	BindObserverMethods(state, tabsMetaTable, "onRemoved", tabRemoved);
 
 	// clang-format off
@@ -90,10 +96,11 @@ void BindTabsAPI(sol::state &state, CoreInterface *coreInterface, TabContainer *
 	AddEnum<SortMode>(state, tabsMetaTable, "SortMode");
 }
 
-void BindMenuApi(sol::state &state, Plugins::PluginMenuManager *pluginMenuManager)
+void BindMenuApi(sol::state &state, Plugins::PluginMenuManager *pluginMenuManager,
+	Plugins::PluginBridge *bridge)
 {
 	std::shared_ptr<Plugins::MenuApi> menuApi =
-		std::make_shared<Plugins::MenuApi>(pluginMenuManager);
+		std::make_shared<Plugins::MenuApi>(pluginMenuManager, bridge);
 
 	sol::table menuTable = state.create_named_table("menu");
 	sol::table metaTable = MarkTableReadOnly(state, menuTable);
@@ -102,9 +109,9 @@ void BindMenuApi(sol::state &state, Plugins::PluginMenuManager *pluginMenuManage
 	metaTable.set_function("remove", &Plugins::MenuApi::remove, menuApi);
 }
 
-void BindUiApi(sol::state &state, UiTheming *uiTheming)
+void BindUiApi(sol::state &state, UiTheming *uiTheming, Plugins::PluginBridge *bridge)
 {
-	std::shared_ptr<Plugins::UiApi> uiApi = std::make_shared<Plugins::UiApi>(uiTheming);
+	std::shared_ptr<Plugins::UiApi> uiApi = std::make_shared<Plugins::UiApi>(uiTheming, bridge);
 
 	sol::table uiTable = state.create_named_table("ui");
 	sol::table metaTable = MarkTableReadOnly(state, uiTable);
@@ -114,13 +121,13 @@ void BindUiApi(sol::state &state, UiTheming *uiTheming)
 }
 
 void BindCommandApi(int pluginId, sol::state &state,
-	Plugins::PluginCommandManager *pluginCommandManager)
+	Plugins::PluginCommandManager *pluginCommandManager, Plugins::PluginBridge *bridge)
 {
 	sol::table commandsTable = state.create_named_table("commands");
 	sol::table commandsMetaTable = MarkTableReadOnly(state, commandsTable);
 
 	std::shared_ptr<Plugins::CommandInvoked> commandInvoked =
-		std::make_shared<Plugins::CommandInvoked>(pluginCommandManager, pluginId);
+		std::make_shared<Plugins::CommandInvoked>(pluginCommandManager, pluginId, bridge);
 	BindObserverMethods(state, commandsMetaTable, "onCommand", commandInvoked);
 }
 
@@ -9,5 +9,8 @@
 
 namespace Plugins
 {
-void BindAllApiMethods(int pluginId, sol::state &state, PluginInterface *pluginInterface);
+class PluginBridge;
+
+void BindAllApiMethods(int pluginId, sol::state &state, PluginInterface *pluginInterface,
+	PluginBridge *bridge);
 }
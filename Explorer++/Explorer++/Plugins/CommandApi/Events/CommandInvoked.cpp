@@ -6,31 +6,29 @@
 #include "Plugins/CommandApi/Events/CommandInvoked.h"
 #include <sol/sol.hpp>
 
-Plugins::CommandInvoked::CommandInvoked(PluginCommandManager *pluginCommandManager, int pluginId) :
+Plugins::CommandInvoked::CommandInvoked(PluginCommandManager *pluginCommandManager, int pluginId,
+	PluginBridge *bridge) :
+	Event("commands.onCommand", bridge),
 	m_pluginCommandManager(pluginCommandManager),
 	m_pluginId(pluginId)
 {
 }
 
 boost::signals2::connection Plugins::CommandInvoked::connectObserver(
-	sol::protected_function observer, sol::this_state state)
+	ObserverInvoker invokeObserver)
 {
-	UNREFERENCED_PARAMETER(state);
-
 	return m_pluginCommandManager->AddCommandInvokedObserver(
-		[this, observer](int pluginId, const std::wstring &name)
+		[ownPluginId = m_pluginId, invokeObserver](int pluginId, const std::wstring &name)
 		{
-			onCommandInvoked(pluginId, name, observer);
-		});
-}
+			if (pluginId != ownPluginId)
+			{
+				return;
+			}
 
-void Plugins::CommandInvoked::onCommandInvoked(int pluginId, const std::wstring &name,
-	sol::protected_function observer)
-{
-	if (pluginId != m_pluginId)
-	{
-		return;
-	}
-
-	observer(name);
+			invokeObserver(
+				[name](sol::protected_function &observer)
+				{
+					observer(name);
+				});
+		});
 }
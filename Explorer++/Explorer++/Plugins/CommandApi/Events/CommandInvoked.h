@@ -12,15 +12,12 @@ namespace Plugins
 class CommandInvoked : public Event
 {
 public:
-	CommandInvoked(PluginCommandManager *pluginCommandManager, int pluginId);
+	CommandInvoked(PluginCommandManager *pluginCommandManager, int pluginId, PluginBridge *bridge);
 
 protected:
-	boost::signals2::connection connectObserver(sol::protected_function observer,
-		sol::this_state state) override;
+	boost::signals2::connection connectObserver(ObserverInvoker invokeObserver) override;
 
 private:
-	void onCommandInvoked(int pluginId, const std::wstring &name, sol::protected_function observer);
-
 	PluginCommandManager *m_pluginCommandManager;
 	int m_pluginId;
 };
@@ -4,9 +4,13 @@
 
 #include "stdafx.h"
 #include "Plugins/Event.h"
+#include "Plugins/PluginBridge.h"
 #include <sol/sol.hpp>
 
-Plugins::Event::Event() : m_connectionIdCounter(1)
+Plugins::Event::Event(const std::string &name, PluginBridge *bridge) :
+	m_name(name),
+	m_bridge(bridge),
+	m_connectionIdCounter(1)
 {
 }
 
@@ -18,16 +22,33 @@ Plugins::Event::~Event()
 	}
 }
 
-int Plugins::Event::addObserver(sol::protected_function observer, sol::this_state state)
+int Plugins::Event::addObserver(sol::protected_function observer)
 {
 	if (!observer)
 	{
 		return -1;
 	}
 
-	auto connection = connectObserver(observer, state);
-
 	int id = m_connectionIdCounter++;
+
+	// The event may be garbage collected while a call is pending, so
+	// only a weak reference is passed to the plugin thread.
+	auto connection = connectObserver(
+		[bridge = m_bridge, name = m_name, weakSelf = weak_from_this(), id](ObserverCall call)
+		{
+			bridge->PostToPlugin(name,
+				[weakSelf, id, call = std::move(call)]
+				{
+					auto self = weakSelf.lock();
+
+					if (self)
+					{
+						self->invokeObserver(id, call);
+					}
+				});
+		});
+
+	m_observers.insert(std::make_pair(id, observer));
 	m_connections.insert(std::make_pair(id, connection));
 
 	return id;
@@ -45,4 +66,20 @@ void Plugins::Event::removeObserver(int id)
 	itr->second.disconnect();
 
 	m_connections.erase(itr);
+	m_observers.erase(id);
+}
+
+void Plugins::Event::invokeObserver(int id, const ObserverCall &call)
+{
+	auto itr = m_observers.find(id);
+
+	// The observer may have been removed after the event was raised.
+	if (itr == m_observers.end())
+	{
+		return;
+	}
+
+	// A copy is used, since the observer may remove itself.
+	sol::protected_function observer = itr->second;
+	call(observer);
 }
@@ -6,25 +6,50 @@
 
 #include <boost/signals2.hpp>
 #include <sol/forward.hpp>
+#include <functional>
+#include <memory>
+#include <string>
 #include <unordered_map>
 
 namespace Plugins
 {
-class Event
+class PluginBridge;
+
+// Events are raised on the UI thread, while observers are invoked on
+// the plugin thread. The data for each event is captured when the
+// event is raised, since the UI may have changed by the time the
+// observer runs.
+class Event : public std::enable_shared_from_this<Event>
 {
 public:
-	Event();
+	Event(const std::string &name, PluginBridge *bridge);
 	virtual ~Event();
 
-	int addObserver(sol::protected_function observer, sol::this_state state);
+	int addObserver(sol::protected_function observer);
 	void removeObserver(int id);
 
 protected:
-	virtual boost::signals2::connection connectObserver(sol::protected_function observer,
-		sol::this_state state) = 0;
+	// Called on the plugin thread, with the observer that should be
+	// invoked.
+	using ObserverCall = std::function<void(sol::protected_function &observer)>;
+
+	// Called on the UI thread when the event is raised. The call
+	// will be run on the plugin thread.
+	using ObserverInvoker = std::function<void(ObserverCall call)>;
+
+	virtual boost::signals2::connection connectObserver(ObserverInvoker invokeObserver) = 0;
 
 private:
+	void invokeObserver(int id, const ObserverCall &call);
+
+	const std::string m_name;
+	PluginBridge *const m_bridge;
 	int m_connectionIdCounter;
 	std::unordered_map<int, boost::signals2::connection> m_connections;
+
+	// The observers are held here, rather than being captured by the
+	// signal connections, so that they're only ever copied and
+	// destroyed on the plugin thread.
+	std::unordered_map<int, sol::protected_function> m_observers;
 };
 }
@@ -4,7 +4,9 @@
 
 #include "stdafx.h"
 #include "Plugins/LuaPlugin.h"
+#include "CoreInterface.h"
 #include "Plugins/ApiBinding.h"
+#include "../Helper/Logging.h"
 #include <sol/sol.hpp>
 
 int Plugins::LuaPlugin::idCounter = 1;
@@ -12,13 +14,36 @@ int Plugins::LuaPlugin::idCounter = 1;
 inline int onPanic(lua_State *L);
 
 Plugins::LuaPlugin::LuaPlugin(const std::wstring &directory, const Manifest &manifest,
-	PluginInterface *pluginInterface) :
+	PluginInterface *pluginInterface, PluginBridge::ThreadingModel threadingModel) :
 	m_directory(directory),
 	m_manifest(manifest),
-	m_lua(onPanic),
-	m_id(idCounter++)
+	m_id(idCounter++),
+	m_bridge(std::make_unique<PluginBridge>(m_id, manifest.name,
+		pluginInterface->GetCoreInterface()->GetMainWindow(), threadingModel)),
+	m_lua(onPanic)
 {
-	BindAllApiMethods(m_id, m_lua, pluginInterface);
+	BindAllApiMethods(m_id, m_lua, pluginInterface, m_bridge.get());
+}
+
+Plugins::LuaPlugin::~LuaPlugin()
+{
+	auto statistics = m_bridge->GetStatistics();
+
+	if (statistics)
+	{
+		auto totalTime =
+			std::chrono::duration_cast<std::chrono::milliseconds>(statistics->totalTime);
+		auto maxTime = std::chrono::duration_cast<std::chrono::milliseconds>(statistics->maxTime);
+
+		LOG(info) << L"Plugin \"" << m_manifest.name << L"\" ran " << statistics->tasksRun
+				  << L" callbacks in " << totalTime.count() << L" ms ("
+				  << statistics->tasksOverBudget << L" over budget, longest " << maxTime.count()
+				  << L" ms)";
+	}
+
+	// The plugin thread has to be stopped before the Lua state is
+	// destroyed.
+	m_bridge->Stop();
 }
 
 int Plugins::LuaPlugin::GetId() const
@@ -41,6 +66,11 @@ sol::state &Plugins::LuaPlugin::GetLuaState()
 	return m_lua;
 }
 
+Plugins::PluginBridge *Plugins::LuaPlugin::GetBridge()
+{
+	return m_bridge.get();
+}
+
 inline int onPanic(lua_State *L)
 {
 	UNREFERENCED_PARAMETER(L);
@@ -6,31 +6,38 @@
 
 #include "PluginInterface.h"
 #include "Plugins/Manifest.h"
+#include "Plugins/PluginBridge.h"
 #include <sol/forward.hpp>
 
 namespace Plugins
 {
 // Wraps a Lua state object and binds in all plugin API methods
-// during construction.
+// during construction. The Lua state should only be used on the
+// thread given by the threading model (see PluginBridge).
 class LuaPlugin
 {
 public:
 	LuaPlugin(const std::wstring &directory, const Manifest &manifest,
-		PluginInterface *pluginInterface);
+		PluginInterface *pluginInterface, PluginBridge::ThreadingModel threadingModel);
+	~LuaPlugin();
 
 	int GetId() const;
 	std::wstring GetDirectory() const;
 	Plugins::Manifest GetManifest() const;
 	sol::state &GetLuaState();
+	PluginBridge *GetBridge();
 
 private:
 	static int idCounter;
 
 	std::wstring m_directory;
 	Manifest m_manifest;
+	const int m_id;
 
+	// The API objects bound into the Lua state refer to the bridge, so
+	// the bridge needs to be destroyed after the state.
+	std::unique_ptr<PluginBridge> m_bridge;
 	sol::state m_lua;
-	const int m_id;
 };
 
 class LuaPanicException : public std::runtime_error
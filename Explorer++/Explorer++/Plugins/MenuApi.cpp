@@ -4,33 +4,63 @@
 
 #include "stdafx.h"
 #include "Plugins/MenuApi.h"
+#include "Plugins/PluginBridge.h"
 #include <sol/sol.hpp>
 
-Plugins::MenuApi::MenuApi(PluginMenuManager *pluginMenuManager) :
-	m_pluginMenuManager(pluginMenuManager)
+Plugins::MenuApi::MenuApi(PluginMenuManager *pluginMenuManager, PluginBridge *bridge) :
+	m_pluginMenuManager(pluginMenuManager),
+	m_bridge(bridge)
 {
-	m_connections.emplace_back(m_pluginMenuManager->AddMenuClickedObserver(
-		std::bind_front(&Plugins::MenuApi::onMenuItemClicked, this)));
 }
 
 Plugins::MenuApi::~MenuApi()
 {
 	for (const auto &item : m_pluginMenuItems)
 	{
-		m_pluginMenuManager->RemoveItemFromMainMenu(item.first);
+		m_bridge->PostToUi(
+			[pluginMenuManager = m_pluginMenuManager, menuItemId = item.first]
+			{
+				pluginMenuManager->RemoveItemFromMainMenu(menuItemId);
+			});
 	}
 }
 
 std::optional<int> Plugins::MenuApi::create(const std::wstring &text,
 	sol::protected_function callback)
 {
-	auto menuItemId = m_pluginMenuManager->AddItemToMainMenu(text);
+	auto menuItemId = m_bridge->InvokeOnUi(
+		[this, &text]
+		{
+			return m_pluginMenuManager->AddItemToMainMenu(text);
+		});
 
 	if (!menuItemId)
 	{
 		return menuItemId;
 	}
 
+	// Clicks are passed to the plugin thread with a weak reference,
+	// since this object can be garbage collected while a click is
+	// pending. That reference isn't available during construction,
+	// which is why the observer is only added here.
+	if (m_connections.empty())
+	{
+		m_connections.emplace_back(m_pluginMenuManager->AddMenuClickedObserver(
+			[bridge = m_bridge, weakSelf = weak_from_this()](int clickedMenuItemId)
+			{
+				bridge->PostToPlugin("menu.onClick",
+					[weakSelf, clickedMenuItemId]
+					{
+						auto self = weakSelf.lock();
+
+						if (self)
+						{
+							self->onMenuItemClicked(clickedMenuItemId);
+						}
+					});
+			}));
+	}
+
 	m_pluginMenuItems.insert(std::make_pair(*menuItemId, callback));
 
 	return menuItemId;
@@ -45,7 +75,11 @@ void Plugins::MenuApi::remove(int menuItemId)
 		return;
 	}
 
-	m_pluginMenuManager->RemoveItemFromMainMenu(menuItemId);
+	m_bridge->PostToUi(
+		[pluginMenuManager = m_pluginMenuManager, menuItemId]
+		{
+			pluginMenuManager->RemoveItemFromMainMenu(menuItemId);
+		});
 
 	m_pluginMenuItems.erase(itr);
 }
@@ -59,5 +93,7 @@ void Plugins::MenuApi::onMenuItemClicked(int menuItemId)
 		return;
 	}
 
-	itr->second();
+	// A copy is used, since the callback may remove the menu item.
+	sol::protected_function callback = itr->second;
+	callback();
 }
@@ -6,16 +6,19 @@
 
 #include "Plugins/PluginMenuManager.h"
 #include <boost/signals2.hpp>
+#include <memory>
 #include <optional>
 #include <sol/forward.hpp>
 #include <unordered_map>
 
 namespace Plugins
 {
-class MenuApi
+class PluginBridge;
+
+class MenuApi : public std::enable_shared_from_this<MenuApi>
 {
 public:
-	MenuApi(PluginMenuManager *pluginMenuManager);
+	MenuApi(PluginMenuManager *pluginMenuManager, PluginBridge *bridge);
 	~MenuApi();
 
 	std::optional<int> create(const std::wstring &text, sol::protected_function callback);
@@ -25,6 +28,7 @@ private:
 	void onMenuItemClicked(int menuItemId);
 
 	PluginMenuManager *m_pluginMenuManager;
+	PluginBridge *m_bridge;
 
 	std::vector<boost::signals2::scoped_connection> m_connections;
 
@@ -0,0 +1,182 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Plugins/PluginBridge.h"
+#include "Explorer++_internal.h"
+#include "Plugins/LuaPlugin.h"
+#include "../Helper/Logging.h"
+#include "../Helper/StringHelper.h"
+
+Plugins::PluginBridge::PluginBridge(int pluginId, const std::wstring &pluginName,
+	HWND mainWindow, ThreadingModel threadingModel) :
+	m_pluginId(pluginId),
+	m_pluginName(pluginName),
+	m_mainWindow(mainWindow),
+	m_threadingModel(threadingModel),
+	m_uiThreadId(std::this_thread::get_id()),
+	m_uiTasks(
+		[this]
+		{
+			PostMessage(m_mainWindow, WM_APP_PLUGINUITASKS, m_pluginId, 0);
+		})
+{
+	if (threadingModel == ThreadingModel::UiThread)
+	{
+		return;
+	}
+
+	m_mainWindowSubclass = std::make_unique<WindowSubclassWrapper>(m_mainWindow,
+		std::bind_front(&PluginBridge::MainWindowProc, this));
+	m_pluginTaskRunner = std::make_unique<SerialTaskRunner>(CALLBACK_TIME_BUDGET,
+		std::bind_front(&PluginBridge::OnCallbackOverBudget, this));
+}
+
+Plugins::PluginBridge::~PluginBridge()
+{
+	Stop();
+}
+
+void Plugins::PluginBridge::PostToPlugin(std::string label, std::function<void()> task)
+{
+	if (m_threadingModel == ThreadingModel::UiThread)
+	{
+		RunPluginTask(task);
+		return;
+	}
+
+	if (!m_pluginTaskRunner)
+	{
+		// The bridge has been stopped.
+		return;
+	}
+
+	m_pluginTaskRunner->Post(std::move(label),
+		[this, task = std::move(task)]
+		{
+			RunPluginTask(task);
+		});
+}
+
+bool Plugins::PluginBridge::RunOnPluginAndWait(std::string label, std::function<void()> task)
+{
+	if (m_threadingModel == ThreadingModel::UiThread)
+	{
+		RunPluginTask(task);
+		return !m_failed;
+	}
+
+	if (!m_pluginTaskRunner)
+	{
+		return false;
+	}
+
+	// This is only ever accessed on the UI thread, since it's set by a UI task.
+	auto finished = std::make_shared<bool>(false);
+
+	m_pluginTaskRunner->Post(std::move(label),
+		[this, task = std::move(task), finished]
+		{
+			RunPluginTask(task);
+
+			m_uiTasks.Post(
+				[finished]
+				{
+					*finished = true;
+				});
+		});
+
+	while (!*finished && m_uiTasks.WaitForTasks())
+	{
+		m_uiTasks.RunPendingTasks();
+	}
+
+	return *finished && !m_failed;
+}
+
+void Plugins::PluginBridge::PostToUi(std::function<void()> task)
+{
+	if (IsUiThread())
+	{
+		task();
+		return;
+	}
+
+	m_uiTasks.Post(std::move(task));
+}
+
+void Plugins::PluginBridge::Stop()
+{
+	// The plugin thread may be waiting on a UI task, so the UI tasks need to be released before the
+	// thread can be stopped.
+	m_uiTasks.Close();
+	m_pluginTaskRunner.reset();
+	m_mainWindowSubclass.reset();
+}
+
+bool Plugins::PluginBridge::HasFailed() const
+{
+	return m_failed;
+}
+
+std::optional<SerialTaskRunner::Statistics> Plugins::PluginBridge::GetStatistics() const
+{
+	if (!m_pluginTaskRunner)
+	{
+		return std::nullopt;
+	}
+
+	return m_pluginTaskRunner->GetStatistics();
+}
+
+bool Plugins::PluginBridge::IsUiThread() const
+{
+	return std::this_thread::get_id() == m_uiThreadId;
+}
+
+void Plugins::PluginBridge::RunPluginTask(const std::function<void()> &task)
+{
+	if (m_failed)
+	{
+		return;
+	}
+
+	try
+	{
+		task();
+	}
+	catch (const LuaPanicException &)
+	{
+		// After a panic, the Lua state is irretrievably broken, so it's not safe to run any further
+		// tasks.
+		m_failed = true;
+
+		LOG(warning) << L"Plugin \"" << m_pluginName << L"\" stopped after a Lua panic";
+	}
+}
+
+void Plugins::PluginBridge::OnCallbackOverBudget(const std::string &label,
+	std::chrono::microseconds duration)
+{
+	LOG(warning) << L"Plugin \"" << m_pluginName << L"\" took "
+				 << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()
+				 << L" ms to run " << utf8StrToWstr(label);
+}
+
+LRESULT Plugins::PluginBridge::MainWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	switch (msg)
+	{
+	case WM_APP_PLUGINUITASKS:
+		// Each plugin has its own bridge, all of which are notified through the main window.
+		if (static_cast<int>(wParam) == m_pluginId)
+		{
+			m_uiTasks.RunPendingTasks();
+			return 0;
+		}
+		break;
+	}
+
+	return DefSubclassProc(hwnd, msg, wParam, lParam);
+}
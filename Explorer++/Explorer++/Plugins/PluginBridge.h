@@ -0,0 +1,119 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/BatchedTaskQueue.h"
+#include "../Helper/SerialTaskRunner.h"
+#include "../Helper/WindowSubclassWrapper.h"
+#include <atomic>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace Plugins
+{
+// Passes messages between a plugin and the UI thread. Each plugin's Lua code runs on a thread of
+// its own, so that a slow callback doesn't block the UI. Events are delivered by posting a task to
+// the plugin thread that captures a snapshot of the relevant data. API calls that need to access
+// the UI are posted back to the UI thread, where they're run in batches, with the main window
+// being notified once per batch.
+//
+// A bridge can also be created without a plugin thread, in which case everything runs directly on
+// the UI thread. That's used by the scripting dialog, which shows the result of each command as
+// soon as the command has run.
+class PluginBridge
+{
+public:
+	enum class ThreadingModel
+	{
+		PluginThread,
+		UiThread
+	};
+
+	// Should be constructed on the UI thread. The name is only used when logging.
+	PluginBridge(int pluginId, const std::wstring &pluginName, HWND mainWindow,
+		ThreadingModel threadingModel);
+	~PluginBridge();
+
+	PluginBridge(const PluginBridge &) = delete;
+	PluginBridge &operator=(const PluginBridge &) = delete;
+
+	// Runs the task on the plugin thread, without waiting for it. The label identifies the task
+	// if it runs over the time budget. Should be called on the UI thread.
+	void PostToPlugin(std::string label, std::function<void()> task);
+
+	// Runs the task on the plugin thread and waits for it to finish. UI tasks that are posted in
+	// the meantime will still be run, so the task can use the plugin API. Returns false if the
+	// plugin has failed. Should be called on the UI thread.
+	bool RunOnPluginAndWait(std::string label, std::function<void()> task);
+
+	// Runs the task on the UI thread, without waiting for it.
+	void PostToUi(std::function<void()> task);
+
+	// Runs the function on the UI thread and returns its result, blocking the plugin thread until
+	// then. If the bridge is stopped before the function has run, std::future_error will be
+	// thrown.
+	template <typename Function>
+	auto InvokeOnUi(Function function) -> std::invoke_result_t<Function>
+	{
+		if (IsUiThread())
+		{
+			return function();
+		}
+
+		using ResultType = std::invoke_result_t<Function>;
+
+		// BatchedTaskQueue stores std::function instances, which need to be copyable. The queue
+		// holds the only reference to the task, so that if the task is discarded, the promise will
+		// be broken.
+		auto task = std::make_shared<std::packaged_task<ResultType()>>(std::move(function));
+		auto result = task->get_future();
+
+		m_uiTasks.Post(
+			[task = std::move(task)]
+			{
+				(*task)();
+			});
+
+		return result.get();
+	}
+
+	// Stops the plugin thread. Pending plugin tasks are discarded and any UI tasks that the plugin
+	// thread is waiting on are released. Should be called on the UI thread, before the plugin's Lua
+	// state is destroyed.
+	void Stop();
+
+	// Returns true if a Lua panic has occurred. Once that happens, no further plugin tasks are run.
+	bool HasFailed() const;
+
+	// Returns the timings for the tasks run on the plugin thread, if there is one.
+	std::optional<SerialTaskRunner::Statistics> GetStatistics() const;
+
+private:
+	// Callbacks that take longer than this are counted and logged.
+	static constexpr std::chrono::milliseconds CALLBACK_TIME_BUDGET = std::chrono::milliseconds(50);
+
+	bool IsUiThread() const;
+	void RunPluginTask(const std::function<void()> &task);
+	void OnCallbackOverBudget(const std::string &label, std::chrono::microseconds duration);
+	LRESULT MainWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+
+	const int m_pluginId;
+	const std::wstring m_pluginName;
+	const HWND m_mainWindow;
+	const ThreadingModel m_threadingModel;
+	const std::thread::id m_uiThreadId;
+	std::atomic<bool> m_failed = false;
+
+	BatchedTaskQueue m_uiTasks;
+	std::unique_ptr<WindowSubclassWrapper> m_mainWindowSubclass;
+
+	// Only set when using a plugin thread, until the bridge is stopped.
+	std::unique_ptr<SerialTaskRunner> m_pluginTaskRunner;
+};
+}
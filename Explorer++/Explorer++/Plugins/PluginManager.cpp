@@ -57,7 +57,8 @@ bool Plugins::PluginManager::attemptToLoadPlugin(const std::filesystem::path &di
 bool Plugins::PluginManager::registerPlugin(const std::filesystem::path &directory,
 	const Manifest &manifest)
 {
-	auto plugin = std::make_unique<LuaPlugin>(directory.wstring(), manifest, m_pluginInterface);
+	auto plugin = std::make_unique<LuaPlugin>(directory.wstring(), manifest, m_pluginInterface,
+		PluginBridge::ThreadingModel::PluginThread);
 
 	for (auto library : manifest.libraries)
 	{
@@ -82,25 +83,33 @@ bool Plugins::PluginManager::registerPlugin(const std::filesystem::path &directo
 		return false;
 	}
 
-	try
-	{
-		plugin->GetLuaState().safe_script_file(pluginFile.string());
-	}
-	catch (const sol::error &)
-	{
-		// Ignore the error. An exception can be thrown for something
-		// simple like a Lua script trying to use a variable that
-		// doesn't exist. That definitely shouldn't result in the
-		// application being terminated because of an uncaught
-		// exception.
-		// The assumption here is that since the panic handler wasn't
-		// called, the Lua state is still usable. Loading the plugin
-		// even if there's an error can be potentially useful for users,
-		// as it means that the plugin might still offer some of its
-		// functionality (if that functionality was set up before the
-		// error occurred).
-	}
-	catch (const LuaPanicException &)
+	// The script runs on the plugin thread. Any API calls it makes
+	// while loading will still be run, since the bridge continues to
+	// run UI tasks while waiting.
+	bool loaded = plugin->GetBridge()->RunOnPluginAndWait("load",
+		[&plugin, &pluginFile]
+		{
+			try
+			{
+				plugin->GetLuaState().safe_script_file(pluginFile.string());
+			}
+			catch (const sol::error &)
+			{
+				// Ignore the error. An exception can be thrown for
+				// something simple like a Lua script trying to use a
+				// variable that doesn't exist. That definitely shouldn't
+				// result in the application being terminated because of
+				// an uncaught exception.
+				// The assumption here is that since the panic handler
+				// wasn't called, the Lua state is still usable. Loading
+				// the plugin even if there's an error can be potentially
+				// useful for users, as it means that the plugin might
+				// still offer some of its functionality (if that
+				// functionality was set up before the error occurred).
+			}
+		});
+
+	if (!loaded)
 	{
 		// If a panic has occurred, the Lua state is irretrievably
 		// broken. It's not safe to attempt to continue to use it.
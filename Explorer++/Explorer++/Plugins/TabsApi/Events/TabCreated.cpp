@@ -8,28 +8,25 @@
 #include "TabContainer.h"
 #include <sol/sol.hpp>
 
-Plugins::TabCreated::TabCreated(TabContainer *tabContainer) : m_tabContainer(tabContainer)
+Plugins::TabCreated::TabCreated(TabContainer *tabContainer, PluginBridge *bridge) :
+	Event("tabs.onCreated", bridge),
+	m_tabContainer(tabContainer)
 {
 }
 
-boost::signals2::connection Plugins::TabCreated::connectObserver(sol::protected_function observer,
-	sol::this_state state)
+boost::signals2::connection Plugins::TabCreated::connectObserver(ObserverInvoker invokeObserver)
 {
-	UNREFERENCED_PARAMETER(state);
-
 	return m_tabContainer->tabCreatedSignal.AddObserver(
-		[this, observer](int tabId, BOOL switchToNewTab)
+		[tabContainer = m_tabContainer, invokeObserver](int tabId, BOOL switchToNewTab)
 		{
 			UNREFERENCED_PARAMETER(switchToNewTab);
 
-			onTabCreated(tabId, observer);
-		});
-}
-
-void Plugins::TabCreated::onTabCreated(int tabId, sol::protected_function observer)
-{
-	const Tab &tabInternal = m_tabContainer->GetTab(tabId);
+			TabsApi::Tab tab(tabContainer->GetTab(tabId));
 
-	TabsApi::Tab tab(tabInternal);
-	observer(tab);
+			invokeObserver(
+				[tab](sol::protected_function &observer)
+				{
+					observer(tab);
+				});
+		});
 }
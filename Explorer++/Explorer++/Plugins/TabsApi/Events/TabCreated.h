@@ -13,15 +13,12 @@ namespace Plugins
 class TabCreated : public Event
 {
 public:
-	TabCreated(TabContainer *tabContainer);
+	TabCreated(TabContainer *tabContainer, PluginBridge *bridge);
 
 protected:
-	boost::signals2::connection connectObserver(sol::protected_function observer,
-		sol::this_state state) override;
+	boost::signals2::connection connectObserver(ObserverInvoker invokeObserver) override;
 
 private:
-	void onTabCreated(int tabId, sol::protected_function observer);
-
 	TabContainer *m_tabContainer;
 };
 }
@@ -7,18 +7,21 @@
 #include "TabContainer.h"
 #include <sol/sol.hpp>
 
-Plugins::TabMoved::TabMoved(TabContainer *tabContainer) : m_tabContainer(tabContainer)
+Plugins::TabMoved::TabMoved(TabContainer *tabContainer, PluginBridge *bridge) :
+	Event("tabs.onMoved", bridge),
+	m_tabContainer(tabContainer)
 {
 }
 
-boost::signals2::connection Plugins::TabMoved::connectObserver(sol::protected_function observer,
-	sol::this_state state)
+boost::signals2::connection Plugins::TabMoved::connectObserver(ObserverInvoker invokeObserver)
 {
-	UNREFERENCED_PARAMETER(state);
-
 	return m_tabContainer->tabMovedSignal.AddObserver(
-		[observer](const Tab &tab, int fromIndex, int toIndex)
+		[invokeObserver](const Tab &tab, int fromIndex, int toIndex)
 		{
-			observer(tab.GetId(), fromIndex, toIndex);
+			invokeObserver(
+				[tabId = tab.GetId(), fromIndex, toIndex](sol::protected_function &observer)
+				{
+					observer(tabId, fromIndex, toIndex);
+				});
 		});
 }
@@ -13,11 +13,10 @@ namespace Plugins
 class TabMoved : public Event
 {
 public:
-	TabMoved(TabContainer *tabContainer);
+	TabMoved(TabContainer *tabContainer, PluginBridge *bridge);
 
 protected:
-	boost::signals2::connection connectObserver(sol::protected_function observer,
-		sol::this_state state) override;
+	boost::signals2::connection connectObserver(ObserverInvoker invokeObserver) override;
 
 private:
 	TabContainer *m_tabContainer;
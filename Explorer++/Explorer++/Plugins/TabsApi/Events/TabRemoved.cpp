@@ -7,14 +7,21 @@
 #include "TabContainer.h"
 #include <sol/sol.hpp>
 
-Plugins::TabRemoved::TabRemoved(TabContainer *tabContainer) : m_tabContainer(tabContainer)
+Plugins::TabRemoved::TabRemoved(TabContainer *tabContainer, PluginBridge *bridge) :
+	Event("tabs.onRemoved", bridge),
+	m_tabContainer(tabContainer)
 {
 }
 
-boost::signals2::connection Plugins::TabRemoved::connectObserver(sol::protected_function observer,
-	sol::this_state state)
+boost::signals2::connection Plugins::TabRemoved::connectObserver(ObserverInvoker invokeObserver)
 {
-	UNREFERENCED_PARAMETER(state);
-
-	return m_tabContainer->tabRemovedSignal.AddObserver(observer);
+	return m_tabContainer->tabRemovedSignal.AddObserver(
+		[invokeObserver](int tabId)
+		{
+			invokeObserver(
+				[tabId](sol::protected_function &observer)
+				{
+					observer(tabId);
+				});
+		});
 }
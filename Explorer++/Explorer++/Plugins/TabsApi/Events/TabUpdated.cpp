@@ -8,39 +8,44 @@
 #include "TabContainer.h"
 #include <sol/sol.hpp>
 
-Plugins::TabUpdated::TabUpdated(TabContainer *tabContainer) : m_tabContainer(tabContainer)
+Plugins::TabUpdated::TabUpdated(TabContainer *tabContainer, PluginBridge *bridge) :
+	Event("tabs.onUpdated", bridge),
+	m_tabContainer(tabContainer)
 {
 }
 
-boost::signals2::connection Plugins::TabUpdated::connectObserver(sol::protected_function observer,
-	sol::this_state state)
+boost::signals2::connection Plugins::TabUpdated::connectObserver(ObserverInvoker invokeObserver)
 {
 	return m_tabContainer->tabUpdatedSignal.AddObserver(
-		[this, observer, state](const Tab &tab, Tab::PropertyType propertyType)
+		[invokeObserver](const Tab &tab, Tab::PropertyType propertyType)
 		{
-			onTabUpdated(observer, state, tab, propertyType);
+			onTabUpdated(tab, propertyType, invokeObserver);
 		});
 }
 
-void Plugins::TabUpdated::onTabUpdated(sol::protected_function observer, sol::this_state state,
-	const Tab &tab, Tab::PropertyType propertyType)
+void Plugins::TabUpdated::onTabUpdated(const Tab &tab, Tab::PropertyType propertyType,
+	const ObserverInvoker &invokeObserver)
 {
-	sol::state_view existingState = state;
+	TabsApi::Tab tabData(tab);
 
-	sol::table changeInfo = existingState.create_table();
+	invokeObserver(
+		[tabData, propertyType, lockState = tab.GetLockState()](sol::protected_function &observer)
+		{
+			sol::state_view existingState(observer.lua_state());
 
-	switch (propertyType)
-	{
-	case Tab::PropertyType::Name:
-		changeInfo["name"] = tab.GetName();
-		break;
+			sol::table changeInfo = existingState.create_table();
 
-	case Tab::PropertyType::LockState:
-		changeInfo["lockState"] = tab.GetLockState();
-		break;
-	}
+			switch (propertyType)
+			{
+			case Tab::PropertyType::Name:
+				changeInfo["name"] = tabData.name;
+				break;
 
-	TabsApi::Tab tabData(tab);
+			case Tab::PropertyType::LockState:
+				changeInfo["lockState"] = lockState;
+				break;
+			}
 
-	observer(tab.GetId(), changeInfo, tabData);
+			observer(tabData.id, changeInfo, tabData);
+		});
 }
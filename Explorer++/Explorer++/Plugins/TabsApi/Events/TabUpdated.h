@@ -14,15 +14,14 @@ namespace Plugins
 class TabUpdated : public Event
 {
 public:
-	TabUpdated(TabContainer *tabContainer);
+	TabUpdated(TabContainer *tabContainer, PluginBridge *bridge);
 
 protected:
-	boost::signals2::connection connectObserver(sol::protected_function observer,
-		sol::this_state state) override;
+	boost::signals2::connection connectObserver(ObserverInvoker invokeObserver) override;
 
 private:
-	void onTabUpdated(sol::protected_function observer, sol::this_state state, const Tab &tab,
-		Tab::PropertyType propertyType);
+	static void onTabUpdated(const Tab &tab, Tab::PropertyType propertyType,
+		const ObserverInvoker &invokeObserver);
 
 	TabContainer *m_tabContainer;
 };
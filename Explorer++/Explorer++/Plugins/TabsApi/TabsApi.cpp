@@ -6,6 +6,7 @@
 #include "Plugins/TabsApi/TabsApi.h"
 #include "Config.h"
 #include "CoreInterface.h"
+#include "Plugins/PluginBridge.h"
 #include "Plugins/TabsApi/TabProperties.h"
 #include "ShellBrowser/FolderSettings.h"
 #include "ShellBrowser/ShellBrowser.h"
@@ -13,6 +14,7 @@
 #include "ShellBrowser/SortModes.h"
 #include "TabContainer.h"
 #include <sol/sol.hpp>
+#include <algorithm>
 
 Plugins::TabsApi::FolderSettings::FolderSettings(const ShellBrowser &shellBrowser)
 {
@@ -58,37 +60,47 @@ std::wstring Plugins::TabsApi::Tab::toString()
 	// clang-format on
 }
 
-Plugins::TabsApi::TabsApi(CoreInterface *coreInterface, TabContainer *tabContainer) :
+Plugins::TabsApi::TabsApi(CoreInterface *coreInterface, TabContainer *tabContainer,
+	PluginBridge *bridge) :
 	m_coreInterface(coreInterface),
-	m_tabContainer(tabContainer)
+	m_tabContainer(tabContainer),
+	m_bridge(bridge)
 {
 }
 
 std::vector<Plugins::TabsApi::Tab> Plugins::TabsApi::getAll()
 {
-	std::vector<Tab> tabs;
+	return m_bridge->InvokeOnUi(
+		[this]
+		{
+			std::vector<Tab> tabs;
 
-	for (auto &item : m_tabContainer->GetAllTabs())
-	{
-		Tab tab(*item.second);
-		tabs.push_back(tab);
-	}
+			for (auto &item : m_tabContainer->GetAllTabs())
+			{
+				Tab tab(*item.second);
+				tabs.push_back(tab);
+			}
 
-	return tabs;
+			return tabs;
+		});
 }
 
 std::optional<Plugins::TabsApi::Tab> Plugins::TabsApi::get(int tabId)
 {
-	auto tabInternal = m_tabContainer->GetTabOptional(tabId);
+	return m_bridge->InvokeOnUi(
+		[this, tabId]() -> std::optional<Tab>
+		{
+			auto tabInternal = m_tabContainer->GetTabOptional(tabId);
 
-	if (!tabInternal)
-	{
-		return std::nullopt;
-	}
+			if (!tabInternal)
+			{
+				return std::nullopt;
+			}
 
-	Tab tab(*tabInternal);
+			Tab tab(*tabInternal);
 
-	return tab;
+			return tab;
+		});
 }
 
 int Plugins::TabsApi::create(sol::table createProperties)
@@ -103,16 +115,11 @@ int Plugins::TabsApi::create(sol::table createProperties)
 	TabSettings tabSettings;
 	extractTabPropertiesForCreation(createProperties, tabSettings);
 
-	unique_pidl_absolute pidlDirectory;
-	HRESULT hr =
-		SHParseDisplayName(location->c_str(), nullptr, wil::out_param(pidlDirectory), 0, nullptr);
-
-	if (FAILED(hr))
-	{
-		return -1;
-	}
-
-	::FolderSettings folderSettings = m_coreInterface->GetConfig()->defaultFolderSettings;
+	::FolderSettings folderSettings = m_bridge->InvokeOnUi(
+		[this]
+		{
+			return m_coreInterface->GetConfig()->defaultFolderSettings;
+		});
 
 	sol::optional<sol::table> folderSettingsTable = createProperties[TabConstants::FOLDER_SETTINGS];
 
@@ -121,9 +128,28 @@ int Plugins::TabsApi::create(sol::table createProperties)
 		extractFolderSettingsForCreation(*folderSettingsTable, folderSettings);
 	}
 
-	auto &newTab = m_tabContainer->CreateNewTab(pidlDirectory.get(), tabSettings, &folderSettings);
+	return m_bridge->InvokeOnUi(
+		[this, &location, &tabSettings, &folderSettings]
+		{
+			unique_pidl_absolute pidlDirectory;
+			HRESULT hr = SHParseDisplayName(location->c_str(), nullptr,
+				wil::out_param(pidlDirectory), 0, nullptr);
+
+			if (FAILED(hr))
+			{
+				return -1;
+			}
 
-	return newTab.GetId();
+			if (tabSettings.index)
+			{
+				tabSettings.index = std::clamp(*tabSettings.index, 0, m_tabContainer->GetNumTabs());
+			}
+
+			auto &newTab =
+				m_tabContainer->CreateNewTab(pidlDirectory.get(), tabSettings, &folderSettings);
+
+			return newTab.GetId();
+		});
 }
 
 void Plugins::TabsApi::extractTabPropertiesForCreation(sol::table createProperties,
@@ -138,21 +164,11 @@ void Plugins::TabsApi::extractTabPropertiesForCreation(sol::table createProperti
 
 	sol::optional<int> index = createProperties[TabConstants::INDEX];
 
+	// The index is clamped to the number of tabs once the tab is
+	// created on the UI thread.
 	if (index)
 	{
-		int finalIndex = *index;
-		int numTabs = m_tabContainer->GetNumTabs();
-
-		if (finalIndex < 0)
-		{
-			finalIndex = 0;
-		}
-		else if (finalIndex > numTabs)
-		{
-			finalIndex = numTabs;
-		}
-
-		tabSettings.index = finalIndex;
+		tabSettings.index = *index;
 	}
 
 	sol::optional<bool> active = createProperties[TabConstants::ACTIVE];
@@ -218,89 +234,109 @@ void Plugins::TabsApi::extractFolderSettingsForCreation(sol::table folderSetting
 	}
 }
 
+// Nothing is returned, so the update is applied without waiting for
+// it, as part of the next batch of UI tasks. The tab container is
+// captured directly, since this object could be garbage collected
+// before the task runs.
 void Plugins::TabsApi::update(int tabId, sol::table properties)
 {
-	auto tabInternal = m_tabContainer->GetTabOptional(tabId);
-
-	if (!tabInternal)
-	{
-		return;
-	}
-
 	sol::optional<std::wstring> location = properties[TabConstants::LOCATION];
-
-	if (location && !location->empty())
-	{
-		tabInternal->GetShellBrowser()->GetNavigationController()->BrowseFolder(*location);
-	}
-
 	sol::optional<std::wstring> name = properties[TabConstants::NAME];
-
-	if (name)
-	{
-		if (name->empty())
-		{
-			tabInternal->ClearCustomName();
-		}
-		else
-		{
-			tabInternal->SetCustomName(*name);
-		}
-	}
-
 	sol::optional<int> lockState = properties[TabConstants::LOCK_STATE];
-
-	// TODO: Verify that lockState has a valid value.
-	if (lockState)
-	{
-		tabInternal->SetLockState(static_cast<::Tab::LockState>(*lockState));
-	}
-
 	sol::optional<bool> active = properties[TabConstants::ACTIVE];
 
-	if (active && *active)
-	{
-		m_tabContainer->SelectTab(*tabInternal);
-	}
+	m_bridge->PostToUi(
+		[tabContainer = m_tabContainer, tabId, location, name, lockState, active]
+		{
+			auto tabInternal = tabContainer->GetTabOptional(tabId);
+
+			if (!tabInternal)
+			{
+				return;
+			}
+
+			if (location && !location->empty())
+			{
+				tabInternal->GetShellBrowser()->GetNavigationController()->BrowseFolder(
+					*location);
+			}
+
+			if (name)
+			{
+				if (name->empty())
+				{
+					tabInternal->ClearCustomName();
+				}
+				else
+				{
+					tabInternal->SetCustomName(*name);
+				}
+			}
+
+			// TODO: Verify that lockState has a valid value.
+			if (lockState)
+			{
+				tabInternal->SetLockState(static_cast<::Tab::LockState>(*lockState));
+			}
+
+			if (active && *active)
+			{
+				tabContainer->SelectTab(*tabInternal);
+			}
+		});
 }
 
 void Plugins::TabsApi::refresh(int tabId)
 {
-	auto tabInternal = m_tabContainer->GetTabOptional(tabId);
+	m_bridge->PostToUi(
+		[tabContainer = m_tabContainer, tabId]
+		{
+			auto tabInternal = tabContainer->GetTabOptional(tabId);
 
-	if (!tabInternal)
-	{
-		return;
-	}
+			if (!tabInternal)
+			{
+				return;
+			}
 
-	tabInternal->GetShellBrowser()->GetNavigationController()->Refresh();
+			tabInternal->GetShellBrowser()->RefreshChangedItems();
+		});
 }
 
 int Plugins::TabsApi::move(int tabId, int newIndex)
 {
-	auto tabInternal = m_tabContainer->GetTabOptional(tabId);
+	return m_bridge->InvokeOnUi(
+		[this, tabId, newIndex]
+		{
+			auto tabInternal = m_tabContainer->GetTabOptional(tabId);
 
-	if (!tabInternal)
-	{
-		return -1;
-	}
+			if (!tabInternal)
+			{
+				return -1;
+			}
 
-	if (newIndex < 0)
-	{
-		newIndex = m_tabContainer->GetNumTabs();
-	}
+			int finalIndex = newIndex;
+
+			if (finalIndex < 0)
+			{
+				finalIndex = m_tabContainer->GetNumTabs();
+			}
 
-	return m_tabContainer->MoveTab(*tabInternal, newIndex);
+			return m_tabContainer->MoveTab(*tabInternal, finalIndex);
+		});
 }
 
 bool Plugins::TabsApi::close(int tabId)
 {
-	auto tabInternal = m_tabContainer->GetTabOptional(tabId);
+	return m_bridge->InvokeOnUi(
+		[this, tabId]
+		{
+			auto tabInternal = m_tabContainer->GetTabOptional(tabId);
 
-	if (!tabInternal)
-	{
-		return false;
-	}
+			if (!tabInternal)
+			{
+				return false;
+			}
 
-	return m_tabContainer->CloseTab(*tabInternal);
+			return m_tabContainer->CloseTab(*tabInternal);
+		});
 }
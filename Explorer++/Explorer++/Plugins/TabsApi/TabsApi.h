@@ -17,6 +17,10 @@ struct TabSettings;
 
 namespace Plugins
 {
+class PluginBridge;
+
+// Lua tables are read on the plugin thread, with the resulting
+// changes then being applied on the UI thread.
 class TabsApi
 {
 public:
@@ -49,7 +53,7 @@ public:
 		std::wstring toString();
 	};
 
-	TabsApi(CoreInterface *coreInterface, TabContainer *tabContainer);
+	TabsApi(CoreInterface *coreInterface, TabContainer *tabContainer, PluginBridge *bridge);
 
 	std::vector<Tab> getAll();
 	std::optional<Tab> get(int tabId);
@@ -66,5 +70,6 @@ private:
 
 	CoreInterface *m_coreInterface;
 	TabContainer *m_tabContainer;
+	PluginBridge *m_bridge;
 };
 }
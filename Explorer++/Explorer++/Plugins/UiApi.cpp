@@ -4,10 +4,13 @@
 
 #include "stdafx.h"
 #include "Plugins/UiApi.h"
+#include "Plugins/PluginBridge.h"
 #include "UiTheming.h"
 #include "../Helper/Rgb.h"
 
-Plugins::UiApi::UiApi(UiTheming *uiTheming) : m_uiTheming(uiTheming)
+Plugins::UiApi::UiApi(UiTheming *uiTheming, PluginBridge *bridge) :
+	m_uiTheming(uiTheming),
+	m_bridge(bridge)
 {
 }
 
@@ -22,9 +25,11 @@ bool Plugins::UiApi::setListViewColors(const std::wstring &backgroundColorString
 		return false;
 	}
 
-	bool res = m_uiTheming->SetListViewColors(*backgroundColor, *textColor);
-
-	return res;
+	return m_bridge->InvokeOnUi(
+		[this, backgroundColor, textColor]
+		{
+			return m_uiTheming->SetListViewColors(*backgroundColor, *textColor);
+		});
 }
 
 bool Plugins::UiApi::setTreeViewColors(const std::wstring &backgroundColorString,
@@ -38,7 +43,13 @@ bool Plugins::UiApi::setTreeViewColors(const std::wstring &backgroundColorString
 		return false;
 	}
 
-	m_uiTheming->SetTreeViewColors(*backgroundColor, *textColor);
+	// The colors have already been validated, so there's no need to wait
+	// for them to be applied.
+	m_bridge->PostToUi(
+		[uiTheming = m_uiTheming, backgroundColor, textColor]
+		{
+			uiTheming->SetTreeViewColors(*backgroundColor, *textColor);
+		});
 
 	return true;
 }
@@ -8,10 +8,12 @@ class UiTheming;
 
 namespace Plugins
 {
+class PluginBridge;
+
 class UiApi
 {
 public:
-	UiApi(UiTheming *uiTheming);
+	UiApi(UiTheming *uiTheming, PluginBridge *bridge);
 
 	bool setListViewColors(const std::wstring &backgroundColorString,
 		const std::wstring &textColorString);
@@ -20,5 +22,6 @@ public:
 
 private:
 	UiTheming *m_uiTheming;
+	PluginBridge *m_bridge;
 };
 }
@@ -175,6 +175,8 @@ LONG Explorerplusplus::SaveGenericSettingsToRegistry()
 		RegistrySettings::SaveDword(hSettingsKey, _T("CheckPinnedToNamespaceTreeProperty"),
 			m_config->checkPinnedToNamespaceTreeProperty);
 		RegistrySettings::SaveDword(hSettingsKey, _T("EnableDarkMode"), m_config->enableDarkMode);
+		RegistrySettings::SaveDword(hSettingsKey, _T("UseBuiltInFileTransfer"),
+			m_config->useBuiltInFileTransfer);
 
 		RegistrySettings::SaveString(hSettingsKey, _T("NewTabDirectory"),
 			m_config->defaultTabDirectory);
@@ -183,6 +185,9 @@ LONG Explorerplusplus::SaveGenericSettingsToRegistry()
 		RegistrySettings::SaveDword(hSettingsKey, _T("Language"), m_config->language);
 		RegistrySettings::SaveDword(hSettingsKey, _T("OpenTabsInForeground"),
 			m_config->openTabsInForeground);
+		RegistrySettings::SaveDword(hSettingsKey, _T("HibernateTabsAfterMinutes"),
+			m_config->hibernateTabsAfterMinutes);
+		RegistrySettings::SaveDword(hSettingsKey, _T("MaxLoadedTabs"), m_config->maxLoadedTabs);
 
 		RegistrySettings::SaveDword(hSettingsKey, _T("DisplayMixedFilesAndFolders"),
 			m_config->globalFolderSettings.displayMixedFilesAndFolders);
@@ -428,6 +433,8 @@ LONG Explorerplusplus::LoadGenericSettingsFromRegistry()
 			_T("CheckPinnedToNamespaceTreeProperty"), m_config->checkPinnedToNamespaceTreeProperty);
 		RegistrySettings::Read32BitValueFromRegistry(hSettingsKey, _T("EnableDarkMode"),
 			m_config->enableDarkMode);
+		RegistrySettings::Read32BitValueFromRegistry(hSettingsKey, _T("UseBuiltInFileTransfer"),
+			m_config->useBuiltInFileTransfer);
 
 		RegistrySettings::ReadString(hSettingsKey, _T("NewTabDirectory"),
 			m_config->defaultTabDirectory);
@@ -447,6 +454,10 @@ LONG Explorerplusplus::LoadGenericSettingsFromRegistry()
 
 		RegistrySettings::Read32BitValueFromRegistry(hSettingsKey, _T("OpenTabsInForeground"),
 			m_config->openTabsInForeground);
+		RegistrySettings::Read32BitValueFromRegistry(hSettingsKey,
+			_T("HibernateTabsAfterMinutes"), m_config->hibernateTabsAfterMinutes);
+		RegistrySettings::Read32BitValueFromRegistry(hSettingsKey, _T("MaxLoadedTabs"),
+			m_config->maxLoadedTabs);
 
 		RegistrySettings::Read32BitValueFromRegistry(hSettingsKey,
 			_T("DisplayMixedFilesAndFolders"),
@@ -548,12 +559,22 @@ LONG Explorerplusplus::LoadGenericSettingsFromRegistry()
 
 void Explorerplusplus::SaveBookmarksToRegistry()
 {
-	BookmarkRegistryStorage::Save(NExplorerplusplus::REG_MAIN_KEY, &m_bookmarkTree);
+	auto journalPosition = m_bookmarkJournal->GetCurrentPosition();
+	BookmarkRegistryStorage::Save(NExplorerplusplus::REG_MAIN_KEY, &m_bookmarkTree,
+		journalPosition);
+
+	// The registry is written to directly, so the journal can be trimmed straight away.
+	if (journalPosition)
+	{
+		m_bookmarkJournal->OnSnapshotSaved(*journalPosition);
+	}
 }
 
 void Explorerplusplus::LoadBookmarksFromRegistry()
 {
-	BookmarkRegistryStorage::Load(NExplorerplusplus::REG_MAIN_KEY, &m_bookmarkTree);
+	auto journalPosition =
+		BookmarkRegistryStorage::Load(NExplorerplusplus::REG_MAIN_KEY, &m_bookmarkTree);
+	LoadBookmarkJournal(journalPosition);
 }
 
 void Explorerplusplus::SaveTabSettingsToRegistry()
@@ -818,7 +839,8 @@ int Explorerplusplus::LoadTabSettingsFromRegistry()
 			TabSettings tabSettings;
 
 			tabSettings.index = i;
-			tabSettings.selected = true;
+			tabSettings.selected = (i == m_iLastSelectedTab);
+			tabSettings.deferEnumeration = true;
 
 			RegistrySettings::ReadDword(hTabKey, _T("Locked"),
 				[&tabSettings](DWORD value)
@@ -0,0 +1,77 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "RenameErrorHelper.h"
+#include "Explorer++_internal.h"
+#include "MainResource.h"
+#include "ResourceHelper.h"
+#include <boost/format.hpp>
+
+namespace
+{
+
+// The number of items listed individually. Any remaining failures are summarized in a single
+// line, so that the message box stays a reasonable size.
+const size_t MAX_LISTED_ITEMS = 10;
+
+UINT GetRenameErrorStringId(FileActionHandler::RenameError error)
+{
+	switch (error)
+	{
+	case FileActionHandler::RenameError::DuplicateName:
+		return IDS_RENAME_ERROR_DUPLICATE_NAME;
+
+	case FileActionHandler::RenameError::NameExists:
+		return IDS_RENAME_ERROR_NAME_EXISTS;
+
+	case FileActionHandler::RenameError::InvalidName:
+		return IDS_RENAME_ERROR_INVALID_NAME;
+
+	case FileActionHandler::RenameError::Failed:
+	default:
+		return IDS_RENAME_ERROR_FAILED;
+	}
+}
+
+}
+
+void ShowRenameErrors(HWND parent, HINSTANCE resourceInstance,
+	const FileActionHandler::FailedRenames_t &failedItems)
+{
+	if (failedItems.empty())
+	{
+		return;
+	}
+
+	std::wstring message = ResourceHelper::LoadString(resourceInstance, IDS_RENAME_ERRORS);
+	std::wstring itemTemplate = ResourceHelper::LoadString(resourceInstance, IDS_RENAME_ERROR_ITEM);
+	size_t numListedItems = 0;
+
+	for (const auto &failedItem : failedItems)
+	{
+		if (numListedItems == MAX_LISTED_ITEMS)
+		{
+			break;
+		}
+
+		std::wstring oldName = PathFindFileName(failedItem.item.strOldFilename.c_str());
+		std::wstring newName = PathFindFileName(failedItem.item.strNewFilename.c_str());
+		std::wstring reason = ResourceHelper::LoadString(resourceInstance,
+			GetRenameErrorStringId(failedItem.error));
+		message += L"\n" + (boost::wformat(itemTemplate) % oldName % newName % reason).str();
+
+		numListedItems++;
+	}
+
+	if (failedItems.size() > numListedItems)
+	{
+		std::wstring moreTemplate =
+			ResourceHelper::LoadString(resourceInstance, IDS_RENAME_ERRORS_MORE);
+		message += L"\n\n"
+			+ (boost::wformat(moreTemplate) % (failedItems.size() - numListedItems)).str();
+	}
+
+	MessageBox(parent, message.c_str(), NExplorerplusplus::APP_NAME, MB_ICONWARNING | MB_OK);
+}
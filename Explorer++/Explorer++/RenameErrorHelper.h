@@ -0,0 +1,12 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/FileActionHandler.h"
+
+// Shows a single message listing each of the items that couldn't be renamed, along with the
+// reason. Does nothing if the list is empty.
+void ShowRenameErrors(HWND parent, HINSTANCE resourceInstance,
+	const FileActionHandler::FailedRenames_t &failedItems);
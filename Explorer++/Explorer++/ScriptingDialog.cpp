@@ -13,7 +13,8 @@
 ScriptingDialog::ScriptingDialog(HINSTANCE hInstance, HWND hParent,
 	PluginInterface *pluginInterface) :
 	DarkModeDialogBase(hInstance, IDD_SCRIPTING, hParent, true),
-	m_luaPlugin(L"", Plugins::Manifest(), pluginInterface)
+	m_luaPlugin(L"", Plugins::Manifest(), pluginInterface,
+		Plugins::PluginBridge::ThreadingModel::UiThread)
 {
 	m_luaPlugin.GetLuaState().open_libraries(sol::lib::base);
 }
@@ -9,6 +9,7 @@
 #include "HistoryEntry.h"
 #include "ItemData.h"
 #include "MainResource.h"
+#include "PreservedFolderState.h"
 #include "ShellNavigationController.h"
 #include "ShellView.h"
 #include "ViewModes.h"
@@ -17,6 +18,7 @@
 #include "../Helper/ListViewHelper.h"
 #include "../Helper/Macros.h"
 #include "../Helper/ShellHelper.h"
+#include "../Helper/TraceRecorder.h"
 #include "../Helper/WinRTBaseWrapper.h"
 #include <wil/com.h>
 #include <propkey.h>
@@ -25,12 +27,27 @@
 
 HRESULT ShellBrowser::BrowseFolder(const HistoryEntry &entry)
 {
+	std::unique_ptr<PreservedFolderState> hibernatedState;
+
+	// If the tab was hibernated, the scroll position only needs to be restored if the same folder
+	// is being reloaded.
+	if (m_hibernatedState
+		&& ArePidlsEquivalent(entry.GetPidl().get(), m_directoryState.pidlDirectory.get()))
+	{
+		hibernatedState = std::move(m_hibernatedState);
+	}
+
 	HRESULT hr = BrowseFolder(entry.GetPidl().get(), false);
 
 	if (SUCCEEDED(hr))
 	{
 		auto selectedItems = entry.GetSelectedItems();
 		SelectItems(ShallowCopyPidls(selectedItems));
+
+		if (hibernatedState)
+		{
+			ListViewHelper::SetScrollPosition(m_hListView, hibernatedState->scrollPosition);
+		}
 	}
 
 	return hr;
@@ -38,6 +55,16 @@ HRESULT ShellBrowser::BrowseFolder(const HistoryEntry &entry)
 
 HRESULT ShellBrowser::BrowseFolder(PCIDLIST_ABSOLUTE pidlDirectory, bool addHistoryEntry)
 {
+	TRACE_FUNCTION();
+
+	m_hibernatedState.reset();
+
+	if (m_deferNextEnumeration)
+	{
+		m_deferNextEnumeration = false;
+		return BrowseFolderDeferred(pidlDirectory, addHistoryEntry);
+	}
+
 	SetCursor(LoadCursor(nullptr, IDC_WAIT));
 
 	auto resetCursor = wil::scope_exit(
@@ -62,6 +89,62 @@ HRESULT ShellBrowser::BrowseFolder(PCIDLIST_ABSOLUTE pidlDirectory, bool addHist
 	return hr;
 }
 
+HRESULT ShellBrowser::BrowseFolderDeferred(PCIDLIST_ABSOLUTE pidlDirectory, bool addHistoryEntry)
+{
+	m_navigationStartedSignal(pidlDirectory);
+
+	std::wstring parsingPath;
+	bool virtualFolder;
+	HRESULT hr = GetFolderDetails(pidlDirectory, parsingPath, virtualFolder);
+
+	if (FAILED(hr))
+	{
+		m_navigationFailedSignal();
+		return hr;
+	}
+
+	CommitNavigation(pidlDirectory, parsingPath, virtualFolder, addHistoryEntry, true);
+
+	return hr;
+}
+
+void ShellBrowser::DeferNextEnumeration()
+{
+	m_deferNextEnumeration = true;
+}
+
+bool ShellBrowser::IsEnumerationDeferred() const
+{
+	return m_enumerationDeferred;
+}
+
+void ShellBrowser::Hibernate()
+{
+	if (m_enumerationDeferred || !m_directoryState.pidlDirectory)
+	{
+		return;
+	}
+
+	auto hibernatedState = std::make_unique<PreservedFolderState>(this);
+
+	// The details of the current folder are reset below, but need to be retained, since the tab
+	// remains in the folder.
+	unique_pidl_absolute pidlDirectory(ILCloneFull(m_directoryState.pidlDirectory.get()));
+	std::wstring directory = m_directoryState.directory;
+	bool virtualFolder = m_directoryState.virtualFolder;
+
+	// This will save the current selection, stop any pending work and remove all items.
+	PrepareToChangeFolders();
+
+	m_directoryState.pidlDirectory = std::move(pidlDirectory);
+	m_directoryState.directory = directory;
+	m_directoryState.virtualFolder = virtualFolder;
+	m_uniqueFolderId++;
+
+	m_enumerationDeferred = true;
+	m_hibernatedState = std::move(hibernatedState);
+}
+
 void ShellBrowser::PrepareToChangeFolders()
 {
 	if (m_bFolderVisited)
@@ -82,7 +165,12 @@ void ShellBrowser::PrepareToChangeFolders()
 	m_FileSelectionList.clear();
 	LeaveCriticalSection(&m_csDirectoryAltered);
 
-	StoreCurrentlySelectedItems();
+	// If the folder was never loaded, there's no selection to save (and the selection previously
+	// saved should be retained).
+	if (!m_enumerationDeferred)
+	{
+		StoreCurrentlySelectedItems();
+	}
 
 	ListView_DeleteAllItems(m_hListView);
 
@@ -95,6 +183,7 @@ void ShellBrowser::PrepareToChangeFolders()
 void ShellBrowser::ClearPendingResults()
 {
 	m_columnThreadPool.clear_queue();
+	m_checksumService->CancelGroup(m_ID);
 	m_columnResults.clear();
 
 	m_iconFetcher->ClearQueue();
@@ -127,12 +216,10 @@ void ShellBrowser::ResetFolderState()
 	m_directoryState = DirectoryState();
 
 	EnterCriticalSection(&m_csDirectoryAltered);
-	m_AlteredList.clear();
+	m_directoryChanges.Clear();
 	LeaveCriticalSection(&m_csDirectoryAltered);
 
 	m_itemInfoMap.clear();
-
-	m_renamedItemOldPidl.reset();
 }
 
 void ShellBrowser::StoreCurrentlySelectedItems()
@@ -148,8 +235,8 @@ void ShellBrowser::StoreCurrentlySelectedItems()
 	entry->SetSelectedItems(selectedItems);
 }
 
-HRESULT ShellBrowser::EnumerateFolder(PCIDLIST_ABSOLUTE pidlDirectory, bool addHistoryEntry,
-	std::vector<ShellBrowser::ItemInfo_t> &items)
+HRESULT ShellBrowser::GetFolderDetails(PCIDLIST_ABSOLUTE pidlDirectory, std::wstring &parsingPath,
+	bool &virtualFolder)
 {
 	wil::com_ptr_nothrow<IShellFolder> parent;
 	PCITEMID_CHILD child;
@@ -168,7 +255,6 @@ HRESULT ShellBrowser::EnumerateFolder(PCIDLIST_ABSOLUTE pidlDirectory, bool addH
 		return hr;
 	}
 
-	std::wstring parsingPath;
 	hr = GetDisplayName(parent.get(), child, SHGDN_FORPARSING, parsingPath);
 
 	if (FAILED(hr))
@@ -176,6 +262,55 @@ HRESULT ShellBrowser::EnumerateFolder(PCIDLIST_ABSOLUTE pidlDirectory, bool addH
 		return hr;
 	}
 
+	virtualFolder = WI_IsFlagClear(attr, SFGAO_FILESYSTEM);
+
+	return hr;
+}
+
+void ShellBrowser::CommitNavigation(PCIDLIST_ABSOLUTE pidlDirectory,
+	const std::wstring &parsingPath, bool virtualFolder, bool addHistoryEntry,
+	bool enumerationDeferred)
+{
+	PrepareToChangeFolders();
+
+	// Observers of the navigation committed signal can check this to determine whether the folder
+	// will actually be loaded.
+	m_enumerationDeferred = enumerationDeferred;
+
+	m_directoryState.pidlDirectory.reset(ILCloneFull(pidlDirectory));
+	m_directoryState.directory = parsingPath;
+	m_directoryState.virtualFolder = virtualFolder;
+	m_uniqueFolderId++;
+
+	SetActiveColumnSet();
+	VerifySortMode();
+	SetViewModeInternal(m_folderSettings.viewMode);
+
+	// It makes sense to trigger this here, rather than on navigation completion, since
+	// otherwise requests could still come in for the previous directory. The shell window is only
+	// registered once the folder has actually been loaded, however.
+	if (!m_enumerationDeferred)
+	{
+		NotifyShellOfNavigation(pidlDirectory);
+	}
+
+	m_navigationCommittedSignal(pidlDirectory, addHistoryEntry);
+}
+
+HRESULT ShellBrowser::EnumerateFolder(PCIDLIST_ABSOLUTE pidlDirectory, bool addHistoryEntry,
+	std::vector<ShellBrowser::ItemInfo_t> &items)
+{
+	TRACE_FUNCTION();
+
+	std::wstring parsingPath;
+	bool virtualFolder;
+	HRESULT hr = GetFolderDetails(pidlDirectory, parsingPath, virtualFolder);
+
+	if (FAILED(hr))
+	{
+		return hr;
+	}
+
 	wil::com_ptr_nothrow<IShellFolder> shellFolder;
 	hr = BindToIdl(pidlDirectory, IID_PPV_ARGS(&shellFolder));
 
@@ -199,22 +334,7 @@ HRESULT ShellBrowser::EnumerateFolder(PCIDLIST_ABSOLUTE pidlDirectory, bool addH
 		return hr;
 	}
 
-	PrepareToChangeFolders();
-
-	m_directoryState.pidlDirectory.reset(ILCloneFull(pidlDirectory));
-	m_directoryState.directory = parsingPath;
-	m_directoryState.virtualFolder = WI_IsFlagClear(attr, SFGAO_FILESYSTEM);
-	m_uniqueFolderId++;
-
-	SetActiveColumnSet();
-	VerifySortMode();
-	SetViewModeInternal(m_folderSettings.viewMode);
-
-	// It makes sense to trigger this here, rather than on navigation completion, since
-	// otherwise requests could still come in for the previous directory.
-	NotifyShellOfNavigation(pidlDirectory);
-
-	m_navigationCommittedSignal(pidlDirectory, addHistoryEntry);
+	CommitNavigation(pidlDirectory, parsingPath, virtualFolder, addHistoryEntry, false);
 
 	ULONG numFetched = 1;
 	unique_pidl_child pidlItem;
@@ -555,6 +675,8 @@ HRESULT ShellBrowser::ExtractFindDataUsingPropertyStore(IShellFolder *shellFolde
 
 void ShellBrowser::OnEnumerationCompleted(std::vector<ShellBrowser::ItemInfo_t> &&items)
 {
+	TRACE_FUNCTION();
+
 	for (auto &item : items)
 	{
 		AddItemInternal(-1, std::move(item), FALSE);
@@ -626,6 +748,13 @@ void ShellBrowser::InsertAwaitingItems(BOOL bInsertIntoGroup)
 	int nAdded = 0;
 	std::optional<int> itemToRename;
 
+	const GroupingContext *groupingContext = nullptr;
+
+	if (bInsertIntoGroup)
+	{
+		groupingContext = &GetGroupingContext();
+	}
+
 	for (const auto &awaitingItem : m_directoryState.awaitingAddList)
 	{
 		const auto &itemInfo = m_itemInfoMap.at(awaitingItem.iItemInternal);
@@ -644,7 +773,7 @@ void ShellBrowser::InsertAwaitingItems(BOOL bInsertIntoGroup)
 
 		if (bInsertIntoGroup)
 		{
-			int groupId = DetermineItemGroup(awaitingItem.iItemInternal);
+			int groupId = DetermineItemGroup(awaitingItem.iItemInternal, *groupingContext);
 
 			lv.mask |= LVIF_GROUPID;
 			lv.iGroupId = groupId;
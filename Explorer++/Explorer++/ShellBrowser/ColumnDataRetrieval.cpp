@@ -1030,3 +1030,42 @@ BOOL GetDriveSpaceColumnRawData(const BasicItemInfo_t &itemInfo, bool TotalSize,
 
 	return res;
 }
+
+std::optional<ChecksumAlgorithm> GetChecksumColumnAlgorithm(ColumnType columnType)
+{
+	switch (columnType)
+	{
+	case ColumnType::Crc32c:
+		return ChecksumAlgorithm::Crc32c;
+
+	case ColumnType::XxHash64:
+		return ChecksumAlgorithm::XxHash64;
+
+	case ColumnType::Sha256:
+		return ChecksumAlgorithm::Sha256;
+
+	default:
+		break;
+	}
+
+	return std::nullopt;
+}
+
+// Checksums are only shown for files. The size and modification time are taken from the data
+// retrieved when the item was enumerated and identify the version of the file that the cached
+// checksum (if any) belongs to.
+std::optional<ChecksumService::File> GetChecksumColumnFile(const BasicItemInfo_t &itemInfo)
+{
+	if (!itemInfo.isFindDataValid
+		|| WI_IsFlagSet(itemInfo.wfd.dwFileAttributes, FILE_ATTRIBUTE_DIRECTORY))
+	{
+		return std::nullopt;
+	}
+
+	ULARGE_INTEGER size = { { itemInfo.wfd.nFileSizeLow, itemInfo.wfd.nFileSizeHigh } };
+	ULARGE_INTEGER modificationTime = { { itemInfo.wfd.ftLastWriteTime.dwLowDateTime,
+		itemInfo.wfd.ftLastWriteTime.dwHighDateTime } };
+
+	return ChecksumService::File{ itemInfo.getFullPath(), size.QuadPart,
+		static_cast<std::int64_t>(modificationTime.QuadPart) };
+}
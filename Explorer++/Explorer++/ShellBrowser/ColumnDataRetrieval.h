@@ -5,6 +5,8 @@
 #pragma once
 
 #include "Columns.h"
+#include "../Helper/ChecksumService.h"
+#include <optional>
 #include <string>
 
 struct BasicItemInfo_t;
@@ -106,3 +108,5 @@ std::wstring GetSizeColumnText(const BasicItemInfo_t &itemInfo,
 	const GlobalFolderSettings &globalFolderSettings);
 std::wstring GetFolderSizeColumnText(const BasicItemInfo_t &itemInfo,
 	const GlobalFolderSettings &globalFolderSettings);
+std::optional<ChecksumAlgorithm> GetChecksumColumnAlgorithm(ColumnType columnType);
+std::optional<ChecksumService::File> GetChecksumColumnFile(const BasicItemInfo_t &itemInfo);
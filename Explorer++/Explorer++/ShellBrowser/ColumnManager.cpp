@@ -12,16 +12,25 @@
 #include "ResourceHelper.h"
 #include "SortModes.h"
 #include "ViewModes.h"
+#include "../Helper/TraceRecorder.h"
 #include <cassert>
 #include <list>
 
 void ShellBrowser::QueueColumnTask(int itemInternalIndex, ColumnType columnType)
 {
+	if (auto checksumAlgorithm = GetChecksumColumnAlgorithm(columnType))
+	{
+		QueueChecksumColumnTask(itemInternalIndex, columnType, *checksumAlgorithm);
+		return;
+	}
+
 	int columnResultID = m_columnResultIDCounter++;
 
 	BasicItemInfo_t basicItemInfo = getBasicItemInfo(itemInternalIndex);
 	GlobalFolderSettings globalFolderSettings = m_config->globalFolderSettings;
 
+	StartThreadPoolIfNecessary(m_columnThreadPool);
+
 	auto result = m_columnThreadPool.push(
 		[listView = m_hListView, columnResultID, columnType, itemInternalIndex, basicItemInfo,
 			globalFolderSettings](int id)
@@ -39,10 +48,59 @@ void ShellBrowser::QueueColumnTask(int itemInternalIndex, ColumnType columnType)
 	m_columnResults.insert({ columnResultID, std::move(result) });
 }
 
+// Hashing a file can take much longer than retrieving the other column values, so checksums are
+// calculated by the checksum service, rather than on the column thread pool. That way, a large
+// file won't hold up the other columns. The result is delivered in the same way as other column
+// results.
+void ShellBrowser::QueueChecksumColumnTask(int itemInternalIndex, ColumnType columnType,
+	ChecksumAlgorithm algorithm)
+{
+	int columnResultID = m_columnResultIDCounter++;
+
+	auto promise = std::make_shared<std::promise<ColumnResult_t>>();
+	m_columnResults.insert({ columnResultID, promise->get_future() });
+
+	auto onChecksumCalculated =
+		[listView = m_hListView, columnResultID, columnType, itemInternalIndex, promise](
+			const std::optional<std::string> &checksum)
+	{
+		ColumnResult_t result;
+		result.itemInternalIndex = itemInternalIndex;
+		result.columnType = columnType;
+
+		if (checksum)
+		{
+			result.columnText = std::wstring(checksum->begin(), checksum->end());
+		}
+
+		promise->set_value(result);
+
+		PostMessage(listView, WM_APP_COLUMN_RESULT_READY, columnResultID, 0);
+	};
+
+	auto file = GetChecksumColumnFile(getBasicItemInfo(itemInternalIndex));
+
+	if (!file)
+	{
+		onChecksumCalculated(std::nullopt);
+		return;
+	}
+
+	if (auto checksum = m_checksumService->GetCachedChecksum(*file, algorithm))
+	{
+		onChecksumCalculated(checksum);
+		return;
+	}
+
+	m_checksumService->QueueChecksum(*file, algorithm, m_ID, onChecksumCalculated);
+}
+
 ShellBrowser::ColumnResult_t ShellBrowser::GetColumnTextAsync(HWND listView, int columnResultId,
 	ColumnType columnType, int internalIndex, const BasicItemInfo_t &basicItemInfo,
 	const GlobalFolderSettings &globalFolderSettings)
 {
+	TRACE_FUNCTION();
+
 	std::wstring columnText = GetColumnText(columnType, basicItemInfo, globalFolderSettings);
 
 	// This message may be delivered before this function has returned.
@@ -457,6 +515,15 @@ SortMode ShellBrowser::DetermineColumnSortMode(ColumnType columnType)
 	case ColumnType::MediaYear:
 		return SortMode::MediaYear;
 
+	case ColumnType::Crc32c:
+		return SortMode::Crc32c;
+
+	case ColumnType::XxHash64:
+		return SortMode::XxHash64;
+
+	case ColumnType::Sha256:
+		return SortMode::Sha256;
+
 	default:
 		assert(false);
 		break;
@@ -658,6 +725,15 @@ int ShellBrowser::LookupColumnNameStringIndex(ColumnType columnType)
 	case ColumnType::MediaYear:
 		return IDS_COLUMN_NAME_YEAR;
 
+	case ColumnType::Crc32c:
+		return IDS_COLUMN_NAME_CRC32C;
+
+	case ColumnType::XxHash64:
+		return IDS_COLUMN_NAME_XXHASH64;
+
+	case ColumnType::Sha256:
+		return IDS_COLUMN_NAME_SHA256;
+
 	default:
 		assert(false);
 		break;
@@ -778,6 +854,15 @@ int ShellBrowser::LookupColumnDescriptionStringIndex(ColumnType columnType)
 	case ColumnType::MediaBitrate:
 		return IDS_COLUMN_DESCRIPTION_BITRATE;
 
+	case ColumnType::Crc32c:
+		return IDS_COLUMN_DESCRIPTION_CRC32C;
+
+	case ColumnType::XxHash64:
+		return IDS_COLUMN_DESCRIPTION_XXHASH64;
+
+	case ColumnType::Sha256:
+		return IDS_COLUMN_DESCRIPTION_SHA256;
+
 	default:
 		assert(false);
 		break;
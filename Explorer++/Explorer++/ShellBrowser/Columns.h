@@ -89,7 +89,12 @@ enum class ColumnType
 	MediaYear = 63,
 
 	/* Printer columns. */
-	PrinterModel = 64
+	PrinterModel = 64,
+
+	/* Checksum columns. */
+	Crc32c = 65,
+	XxHash64 = 66,
+	Sha256 = 67
 };
 
 struct Column_t
@@ -0,0 +1,111 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "DateGroupBuckets.h"
+#include <boost/date_time/gregorian/gregorian.hpp>
+
+namespace
+{
+std::optional<ULONGLONG> LocalMidnightToUtc(const boost::gregorian::date &localDate,
+	const TIME_ZONE_INFORMATION *timeZone)
+{
+	SYSTEMTIME localTime = {};
+	localTime.wYear = localDate.year();
+	localTime.wMonth = localDate.month();
+	localTime.wDay = localDate.day();
+	localTime.wDayOfWeek = localDate.day_of_week();
+
+	// Note that the conversion here takes into account the daylight saving rules in effect on the
+	// date itself, so that each boundary falls on the correct local midnight.
+	SYSTEMTIME utcTime;
+	BOOL res = TzSpecificLocalTimeToSystemTime(timeZone, &localTime, &utcTime);
+
+	if (!res)
+	{
+		return std::nullopt;
+	}
+
+	FILETIME utcFileTime;
+	res = SystemTimeToFileTime(&utcTime, &utcFileTime);
+
+	if (!res)
+	{
+		return std::nullopt;
+	}
+
+	ULARGE_INTEGER time;
+	time.LowPart = utcFileTime.dwLowDateTime;
+	time.HighPart = utcFileTime.dwHighDateTime;
+	return time.QuadPart;
+}
+}
+
+std::optional<DateGroupBuckets> DateGroupBuckets::Create(const SYSTEMTIME &localTime,
+	const TIME_ZONE_INFORMATION *timeZone)
+{
+	using namespace boost::gregorian;
+
+	date today;
+
+	try
+	{
+		today = date(localTime.wYear, localTime.wMonth, localTime.wDay);
+	}
+	catch (const std::out_of_range &)
+	{
+		return std::nullopt;
+	}
+
+	// Note that this assumes that Sunday is the first day of the week.
+	date startOfWeek = today - days(today.day_of_week().as_number());
+	date startOfMonth = date(today.year(), today.month(), 1);
+	date startOfYear = date(today.year(), 1, 1);
+
+	// These need to be in the same order as the buckets themselves. Each time is placed into the
+	// first bucket whose lower bound it reaches. Because of that, the bounds don't need to be
+	// strictly decreasing (e.g. the start of this week may be earlier than the start of this
+	// month).
+	const date lowerBoundDates[] = { today + days(1), today, today - days(1), startOfWeek,
+		startOfWeek - weeks(1), startOfMonth, startOfMonth - months(1), startOfYear,
+		startOfYear - years(1) };
+	static_assert(std::size(lowerBoundDates) == NUM_BUCKETS - 1);
+
+	LowerBounds lowerBounds;
+
+	for (size_t i = 0; i < lowerBounds.size(); i++)
+	{
+		auto lowerBound = LocalMidnightToUtc(lowerBoundDates[i], timeZone);
+
+		if (!lowerBound)
+		{
+			return std::nullopt;
+		}
+
+		lowerBounds[i] = *lowerBound;
+	}
+
+	return DateGroupBuckets(lowerBounds);
+}
+
+DateGroupBuckets::DateGroupBuckets(const LowerBounds &lowerBounds) : m_lowerBounds(lowerBounds)
+{
+}
+
+DateGroupBuckets::Bucket DateGroupBuckets::Classify(const FILETIME &utcTime) const
+{
+	ULARGE_INTEGER time;
+	time.LowPart = utcTime.dwLowDateTime;
+	time.HighPart = utcTime.dwHighDateTime;
+
+	for (size_t i = 0; i < m_lowerBounds.size(); i++)
+	{
+		if (time.QuadPart >= m_lowerBounds[i])
+		{
+			return static_cast<Bucket>(i);
+		}
+	}
+
+	return Bucket::LongAgo;
+}
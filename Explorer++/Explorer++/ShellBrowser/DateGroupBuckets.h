@@ -0,0 +1,47 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <array>
+#include <optional>
+
+// Sorts times into the relative date ranges ("Today", "Last week", etc.) that are used when
+// grouping items by date. The boundaries between the ranges are calculated once, as UTC FILETIME
+// values, so classifying a time only requires a handful of integer comparisons.
+class DateGroupBuckets
+{
+public:
+	// These are ordered from the most recent range to the least recent range.
+	enum class Bucket
+	{
+		Future,
+		Today,
+		Yesterday,
+		ThisWeek,
+		LastWeek,
+		ThisMonth,
+		LastMonth,
+		ThisYear,
+		LastYear,
+		LongAgo
+	};
+
+	static constexpr size_t NUM_BUCKETS = static_cast<size_t>(Bucket::LongAgo) + 1;
+
+	// The ranges are calculated relative to the day containing the specified local time. If no
+	// time zone is provided, the current time zone will be used.
+	static std::optional<DateGroupBuckets> Create(const SYSTEMTIME &localTime,
+		const TIME_ZONE_INFORMATION *timeZone = nullptr);
+
+	Bucket Classify(const FILETIME &utcTime) const;
+
+private:
+	// The inclusive lower bound of each bucket, other than the last (which has no lower bound).
+	using LowerBounds = std::array<ULONGLONG, NUM_BUCKETS - 1>;
+
+	explicit DateGroupBuckets(const LowerBounds &lowerBounds);
+
+	LowerBounds m_lowerBounds;
+};
@@ -8,12 +8,54 @@
 #include "ItemData.h"
 #include "ShellNavigationController.h"
 #include "ViewModes.h"
+#include "../Helper/DirectorySnapshot.h"
 #include "../Helper/ListViewHelper.h"
 #include "../Helper/Logging.h"
 #include "../Helper/Macros.h"
 #include "../Helper/ShellHelper.h"
+#include "../Helper/iDirectoryMonitor.h"
+#include <boost/range/adaptor/map.hpp>
+#include <algorithm>
 #include <list>
 
+namespace
+{
+
+std::optional<DirectoryChangeCoalescer::Event> GetDirectoryChangeEvent(DWORD action)
+{
+	switch (action)
+	{
+	case FILE_ACTION_ADDED:
+		return DirectoryChangeCoalescer::Event::Added;
+
+	case FILE_ACTION_REMOVED:
+		return DirectoryChangeCoalescer::Event::Removed;
+
+	case FILE_ACTION_MODIFIED:
+		return DirectoryChangeCoalescer::Event::Modified;
+
+	case FILE_ACTION_RENAMED_OLD_NAME:
+		return DirectoryChangeCoalescer::Event::RenamedOldName;
+
+	case FILE_ACTION_RENAMED_NEW_NAME:
+		return DirectoryChangeCoalescer::Event::RenamedNewName;
+	}
+
+	return std::nullopt;
+}
+
+DirectorySnapshotEntry BuildSnapshotEntry(const WIN32_FIND_DATA &findData)
+{
+	ULARGE_INTEGER size = { findData.nFileSizeLow, findData.nFileSizeHigh };
+	ULARGE_INTEGER lastWriteTime = { findData.ftLastWriteTime.dwLowDateTime,
+		findData.ftLastWriteTime.dwHighDateTime };
+
+	return { findData.cFileName, size.QuadPart, lastWriteTime.QuadPart,
+		findData.dwFileAttributes };
+}
+
+}
+
 void ShellBrowser::StartDirectoryMonitoring(PCIDLIST_ABSOLUTE pidl)
 {
 	// Shouldn't be monitoring the same directory with both directory modification notifications and
@@ -118,7 +160,7 @@ void ShellBrowser::ProcessShellChangeNotification(const ShellChangeNotification
 	case SHCNE_UPDATEDIR:
 		if (ArePidlsEquivalent(m_directoryState.pidlDirectory.get(), change.pidl1.get()))
 		{
-			m_navigationController->Refresh();
+			RefreshChangedItems();
 		}
 		break;
 
@@ -140,63 +182,22 @@ void ShellBrowser::DirectoryAltered()
 {
 	EnterCriticalSection(&m_csDirectoryAltered);
 
+	auto batch = m_directoryChanges.TakeBatch();
+
 	SendMessage(m_hListView, WM_SETREDRAW, FALSE, NULL);
 
-	// Note that directory change notifications are received asynchronously. That means that, in
-	// each of the cases below, it's not reasonable to assume that the file being referenced
-	// actually exists (since it may have been renamed or deleted since the original notification
-	// was sent).
-	for (const auto &af : m_AlteredList)
+	// Only undertake the modifications if the unique folder index on the modified items and
+	// current folder match up (i.e. ensure the directory has not changed since these files were
+	// modified).
+	if (m_directoryChangesFolderId == m_uniqueFolderId)
 	{
-		// Only undertake the modification if the unique folder index on the modified item and
-		// current folder match up (i.e. ensure the directory has not changed since these files were
-		// modified).
-		if (af.iFolderIndex != m_uniqueFolderId)
-		{
-			continue;
-		}
-
-		wil::com_ptr_nothrow<IShellFolder> parent;
-		HRESULT hr = SHBindToObject(nullptr, m_directoryState.pidlDirectory.get(), nullptr,
-			IID_PPV_ARGS(&parent));
-
-		if (FAILED(hr))
+		if (batch.rescanRequired)
 		{
-			continue;
+			RescanDirectory();
 		}
-
-		unique_pidl_absolute simplePidl;
-		hr = CreateSimplePidl(af.szFileName, wil::out_param(simplePidl), parent.get());
-
-		if (FAILED(hr))
+		else
 		{
-			continue;
-		}
-
-		switch (af.dwAction)
-		{
-		case FILE_ACTION_ADDED:
-			OnItemAdded(simplePidl.get());
-			break;
-
-		case FILE_ACTION_RENAMED_OLD_NAME:
-			assert(!m_renamedItemOldPidl);
-			m_renamedItemOldPidl.reset(ILCloneFull(simplePidl.get()));
-			break;
-
-		case FILE_ACTION_RENAMED_NEW_NAME:
-			OnItemRenamed(m_renamedItemOldPidl.get(), simplePidl.get());
-
-			m_renamedItemOldPidl.reset();
-			break;
-
-		case FILE_ACTION_MODIFIED:
-			OnItemModified(simplePidl.get());
-			break;
-
-		case FILE_ACTION_REMOVED:
-			OnItemRemoved(simplePidl.get());
-			break;
+			ApplyDirectoryChanges(batch.changes);
 		}
 	}
 
@@ -215,8 +216,6 @@ void ShellBrowser::DirectoryAltered()
 
 	directoryModified.m_signal();
 
-	m_AlteredList.clear();
-
 	BOOL bFocusSet = FALSE;
 	int iIndex;
 
@@ -264,19 +263,220 @@ void ShellBrowser::FilesModified(DWORD Action, const TCHAR *FileName, int EventI
 {
 	EnterCriticalSection(&m_csDirectoryAltered);
 
-	SetTimer(m_hOwner, EventId, 200, TimerProc);
+	// Changes for a previous folder are no longer relevant.
+	if (iFolderIndex != m_directoryChangesFolderId)
+	{
+		m_directoryChanges.Clear();
+		m_directoryChangesFolderId = iFolderIndex;
+	}
+
+	// The timer is only started when the first change in a batch is received, so that the changes
+	// are still applied periodically if the directory is being continuously modified.
+	if (!m_directoryChanges.HasPendingChanges())
+	{
+		SetTimer(m_hOwner, EventId, DIRECTORY_CHANGES_TIMEOUT, TimerProc);
+	}
+
+	if (Action == DIRECTORY_MONITOR_ACTION_OVERFLOW)
+	{
+		m_directoryChanges.OnOverflow();
+	}
+	else if (auto event = GetDirectoryChangeEvent(Action))
+	{
+		m_directoryChanges.AddEvent(*event, FileName);
+	}
+
+	LeaveCriticalSection(&m_csDirectoryAltered);
+}
+
+// Note that directory change notifications are received asynchronously. That means that, in each
+// of the cases below, it's not reasonable to assume that the file being referenced actually exists
+// (since it may have been renamed or deleted since the original notification was sent).
+void ShellBrowser::ApplyDirectoryChanges(
+	const std::vector<DirectoryChangeCoalescer::Change> &changes)
+{
+	if (changes.empty())
+	{
+		return;
+	}
+
+	wil::com_ptr_nothrow<IShellFolder> parent;
+	HRESULT hr = SHBindToObject(nullptr, m_directoryState.pidlDirectory.get(), nullptr,
+		IID_PPV_ARGS(&parent));
+
+	if (FAILED(hr))
+	{
+		return;
+	}
+
+	for (const auto &change : changes)
+	{
+		unique_pidl_absolute simplePidl;
+		hr = CreateSimplePidl(change.name, wil::out_param(simplePidl), parent.get());
+
+		if (FAILED(hr))
+		{
+			continue;
+		}
+
+		switch (change.type)
+		{
+		case DirectoryChangeCoalescer::ChangeType::Added:
+			OnItemAdded(simplePidl.get());
+			break;
+
+		case DirectoryChangeCoalescer::ChangeType::Removed:
+			OnItemRemoved(simplePidl.get());
+			break;
+
+		case DirectoryChangeCoalescer::ChangeType::Modified:
+			OnItemModified(simplePidl.get());
+			break;
+
+		case DirectoryChangeCoalescer::ChangeType::Renamed:
+		{
+			unique_pidl_absolute newSimplePidl;
+			hr = CreateSimplePidl(change.newName, wil::out_param(newSimplePidl), parent.get());
+
+			if (SUCCEEDED(hr))
+			{
+				OnItemRenamed(simplePidl.get(), newSimplePidl.get());
+			}
+		}
+		break;
+		}
+	}
+}
+
+void ShellBrowser::RefreshChangedItems()
+{
+	// The items in a virtual folder can't be read directly and a folder whose enumeration was
+	// deferred has no items to compare against, so both require a full refresh.
+	if (m_enumerationDeferred || m_directoryState.virtualFolder)
+	{
+		m_navigationController->Refresh();
+		return;
+	}
+
+	EnterCriticalSection(&m_csDirectoryAltered);
 
-	AlteredFile_t af;
+	// Any pending changes will be picked up when the directory is rescanned.
+	m_directoryChanges.Clear();
 
-	StringCchCopy(af.szFileName, SIZEOF_ARRAY(af.szFileName), FileName);
-	af.dwAction = Action;
-	af.iFolderIndex = iFolderIndex;
+	SendMessage(m_hListView, WM_SETREDRAW, FALSE, NULL);
+	RescanDirectory();
+	SendMessage(m_hListView, WM_SETREDRAW, TRUE, NULL);
 
-	m_AlteredList.push_back(af);
+	directoryModified.m_signal();
 
 	LeaveCriticalSection(&m_csDirectoryAltered);
 }
 
+// Called when the folder is refreshed, or when change notifications have been lost. Rather than
+// reloading the entire folder, the current contents of the directory are compared against the
+// items that are already loaded and only the differences are applied.
+void ShellBrowser::RescanDirectory()
+{
+	std::wstring searchPath = m_directoryState.directory;
+
+	if (!searchPath.ends_with(L"\\"))
+	{
+		searchPath += L"\\";
+	}
+
+	searchPath += L"*";
+
+	WIN32_FIND_DATA findData;
+	wil::unique_hfind findHandle(FindFirstFileEx(searchPath.c_str(), FindExInfoBasic, &findData,
+		FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH));
+
+	if (!findHandle)
+	{
+		m_navigationController->Refresh();
+		return;
+	}
+
+	std::vector<DirectorySnapshotEntry> previousSnapshot;
+	previousSnapshot.reserve(m_itemInfoMap.size());
+
+	// There's no way to tell whether an item without find data has changed, so those items are
+	// left out of the comparison entirely.
+	std::unordered_set<std::wstring> unknownItems;
+
+	// Each item is given the next internal index as it's added, so visiting the items in index
+	// order (rather than in the map's arbitrary order) reproduces the order in which they were
+	// originally enumerated. That allows most of the two snapshots to be compared pairwise.
+	std::vector<int> internalIndexes;
+	internalIndexes.reserve(m_itemInfoMap.size());
+
+	for (int internalIndex : m_itemInfoMap | boost::adaptors::map_keys)
+	{
+		internalIndexes.push_back(internalIndex);
+	}
+
+	std::sort(internalIndexes.begin(), internalIndexes.end());
+
+	for (int internalIndex : internalIndexes)
+	{
+		const auto &itemInfo = m_itemInfoMap.at(internalIndex);
+
+		if (itemInfo.isFindDataValid)
+		{
+			previousSnapshot.push_back(BuildSnapshotEntry(itemInfo.wfd));
+		}
+		else
+		{
+			unknownItems.insert(PathFindFileName(itemInfo.parsingName.c_str()));
+		}
+	}
+
+	std::vector<DirectorySnapshotEntry> currentSnapshot;
+	currentSnapshot.reserve(previousSnapshot.size());
+
+	do
+	{
+		if (lstrcmp(findData.cFileName, L".") == 0 || lstrcmp(findData.cFileName, L"..") == 0)
+		{
+			continue;
+		}
+
+		if (!m_folderSettings.showHidden
+			&& WI_IsFlagSet(findData.dwFileAttributes, FILE_ATTRIBUTE_HIDDEN))
+		{
+			continue;
+		}
+
+		if (!unknownItems.empty() && unknownItems.contains(findData.cFileName))
+		{
+			continue;
+		}
+
+		currentSnapshot.push_back(BuildSnapshotEntry(findData));
+	} while (FindNextFile(findHandle.get(), &findData));
+
+	auto diff = DiffDirectorySnapshots(previousSnapshot, currentSnapshot);
+
+	std::vector<DirectoryChangeCoalescer::Change> changes;
+	changes.reserve(diff.removed.size() + diff.modified.size() + diff.added.size());
+
+	for (auto &name : diff.removed)
+	{
+		changes.push_back({ DirectoryChangeCoalescer::ChangeType::Removed, std::move(name), {} });
+	}
+
+	for (auto &name : diff.modified)
+	{
+		changes.push_back({ DirectoryChangeCoalescer::ChangeType::Modified, std::move(name), {} });
+	}
+
+	for (auto &name : diff.added)
+	{
+		changes.push_back({ DirectoryChangeCoalescer::ChangeType::Added, std::move(name), {} });
+	}
+
+	ApplyDirectoryChanges(changes);
+}
+
 void ShellBrowser::OnItemAdded(PCIDLIST_ABSOLUTE simplePidl)
 {
 	auto existingItemInternalIndex = GetItemInternalIndexForPidl(simplePidl);
@@ -506,7 +706,7 @@ void ShellBrowser::UpdateItem(PCIDLIST_ABSOLUTE pidl, PCIDLIST_ABSOLUTE updatedP
 	}
 
 	// It's not safe to use itemIndex past this point.
-	ListView_SortItems(m_hListView, SortStub, this);
+	SortListViewItems();
 	itemIndex.reset();
 }
 
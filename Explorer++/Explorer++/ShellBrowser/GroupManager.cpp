@@ -12,9 +12,6 @@
 #include "../Helper/Helper.h"
 #include "../Helper/Macros.h"
 #include "../Helper/ShellHelper.h"
-#include "../Helper/TimeHelper.h"
-#include <boost/date_time/gregorian/gregorian.hpp>
-#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/integer_traits.hpp>
 #include <wil/common.h>
 #include <iphlpapi.h>
@@ -26,6 +23,41 @@ namespace
 const uint64_t KBYTE = 1024;
 const uint64_t MBYTE = 1024 * 1024;
 const uint64_t GBYTE = 1024 * 1024 * 1024;
+
+// Indexed by DateGroupBuckets::Bucket.
+const UINT DATE_GROUP_NAME_RESOURCE_IDS[] = { IDS_GROUPBY_DATE_FUTURE, IDS_GROUPBY_DATE_TODAY,
+	IDS_GROUPBY_DATE_YESTERDAY, IDS_GROUPBY_DATE_THIS_WEEK, IDS_GROUPBY_DATE_LAST_WEEK,
+	IDS_GROUPBY_DATE_THIS_MONTH, IDS_GROUPBY_DATE_LAST_MONTH, IDS_GROUPBY_DATE_THIS_YEAR,
+	IDS_GROUPBY_DATE_LAST_YEAR, IDS_GROUPBY_DATE_LONG_AGO };
+static_assert(std::size(DATE_GROUP_NAME_RESOURCE_IDS) == DateGroupBuckets::NUM_BUCKETS);
+
+bool IsSameDay(const SYSTEMTIME &time1, const SYSTEMTIME &time2)
+{
+	return time1.wYear == time2.wYear && time1.wMonth == time2.wMonth && time1.wDay == time2.wDay;
+}
+
+bool IsSameTimeZone(const TIME_ZONE_INFORMATION &timeZone1,
+	const TIME_ZONE_INFORMATION &timeZone2)
+{
+	return timeZone1.Bias == timeZone2.Bias && timeZone1.StandardBias == timeZone2.StandardBias
+		&& timeZone1.DaylightBias == timeZone2.DaylightBias
+		&& std::wstring_view(timeZone1.StandardName) == std::wstring_view(timeZone2.StandardName);
+}
+
+LONG GetCurrentBias(const TIME_ZONE_INFORMATION &timeZone, DWORD timeZoneId)
+{
+	switch (timeZoneId)
+	{
+	case TIME_ZONE_ID_STANDARD:
+		return timeZone.Bias + timeZone.StandardBias;
+
+	case TIME_ZONE_ID_DAYLIGHT:
+		return timeZone.Bias + timeZone.DaylightBias;
+
+	default:
+		return timeZone.Bias;
+	}
+}
 }
 
 BOOL ShellBrowser::GetShowInGroups() const
@@ -142,9 +174,165 @@ const ShellBrowser::ListViewGroup ShellBrowser::GetListViewGroupById(int groupId
 	return *itr;
 }
 
+// Creating a context involves loading several strings and calculating the boundaries between the
+// date groups, which is too expensive to do for each item that's added. So the context is cached,
+// with the cached context only being replaced if the sort mode has changed, or if the date groups
+// could have changed (because the local date or the time zone has changed).
+const ShellBrowser::GroupingContext &ShellBrowser::GetGroupingContext()
+{
+	SYSTEMTIME localTime;
+	GetLocalTime(&localTime);
+
+	TIME_ZONE_INFORMATION timeZone;
+	DWORD timeZoneId = GetTimeZoneInformation(&timeZone);
+
+	if (timeZoneId == TIME_ZONE_ID_INVALID)
+	{
+		timeZone = {};
+	}
+
+	LONG currentBias = GetCurrentBias(timeZone, timeZoneId);
+
+	if (!m_groupingContext || m_groupingContext->sortMode != m_folderSettings.sortMode
+		|| !IsSameDay(m_groupingContext->localTime, localTime)
+		|| !IsSameTimeZone(m_groupingContext->timeZone, timeZone)
+		|| m_groupingContext->currentBias != currentBias)
+	{
+		m_groupingContext = CreateGroupingContext(localTime, timeZone, currentBias);
+	}
+
+	return *m_groupingContext;
+}
+
+ShellBrowser::GroupingContext ShellBrowser::CreateGroupingContext(const SYSTEMTIME &localTime,
+	const TIME_ZONE_INFORMATION &timeZone, LONG currentBias) const
+{
+	GroupingContext context;
+	context.sortMode = m_folderSettings.sortMode;
+	context.localTime = localTime;
+	context.timeZone = timeZone;
+	context.currentBias = currentBias;
+	context.unspecifiedGroupName =
+		ResourceHelper::LoadString(m_hResourceModule, IDS_GROUPBY_UNSPECIFIED);
+
+	switch (m_folderSettings.sortMode)
+	{
+	case SortMode::DateModified:
+		context.dateType = GroupByDateType::Modified;
+		break;
+
+	case SortMode::Created:
+		context.dateType = GroupByDateType::Created;
+		break;
+
+	case SortMode::Accessed:
+		context.dateType = GroupByDateType::Accessed;
+		break;
+
+	default:
+		return context;
+	}
+
+	context.dateBuckets = DateGroupBuckets::Create(localTime);
+
+	for (size_t i = 0; i < DateGroupBuckets::NUM_BUCKETS; i++)
+	{
+		context.dateGroupNames[i] =
+			ResourceHelper::LoadString(m_hResourceModule, DATE_GROUP_NAME_RESOURCE_IDS[i]);
+	}
+
+	return context;
+}
+
 int ShellBrowser::DetermineItemGroup(int iItemInternal)
 {
-	BasicItemInfo_t basicItemInfo = getBasicItemInfo(iItemInternal);
+	return DetermineItemGroup(iItemInternal, GetGroupingContext());
+}
+
+int ShellBrowser::DetermineItemGroup(int iItemInternal, const GroupingContext &context)
+{
+	std::optional<GroupInfo> groupInfo;
+
+	if (context.dateType)
+	{
+		// Only the find data is needed to determine the date group, so there's no need to
+		// retrieve the rest of the item's details here.
+		const auto &itemInfo = m_itemInfoMap.at(iItemInternal);
+		auto bucket = DetermineItemDateBucket(itemInfo.wfd, itemInfo.isFindDataValid, context);
+
+		if (bucket)
+		{
+			groupInfo = GetDateGroupInfo(*bucket, context);
+		}
+	}
+	else
+	{
+		groupInfo = DetermineItemGroupInfo(getBasicItemInfo(iItemInternal), context);
+	}
+
+	if (!groupInfo)
+	{
+		groupInfo = GroupInfo(context.unspecifiedGroupName, INT_MIN);
+	}
+
+	return GetOrCreateListViewGroup(*groupInfo);
+}
+
+std::vector<int> ShellBrowser::DetermineItemGroups(const std::vector<int> &internalIndexes,
+	const GroupingContext &context)
+{
+	std::vector<int> groupIds;
+	groupIds.reserve(internalIndexes.size());
+
+	if (!context.dateType)
+	{
+		for (int internalIndex : internalIndexes)
+		{
+			groupIds.push_back(DetermineItemGroup(internalIndex, context));
+		}
+
+		return groupIds;
+	}
+
+	// When grouping by date, there's only a small, fixed set of possible groups. Each item can be
+	// classified using a few integer comparisons, with the group for each bucket only being
+	// looked up the first time it's needed.
+	std::array<std::optional<int>, DateGroupBuckets::NUM_BUCKETS> bucketGroupIds;
+	std::optional<int> unspecifiedGroupId;
+
+	for (int internalIndex : internalIndexes)
+	{
+		const auto &itemInfo = m_itemInfoMap.at(internalIndex);
+		auto bucket = DetermineItemDateBucket(itemInfo.wfd, itemInfo.isFindDataValid, context);
+
+		if (!bucket)
+		{
+			if (!unspecifiedGroupId)
+			{
+				unspecifiedGroupId = GetOrCreateListViewGroup(
+					GroupInfo(context.unspecifiedGroupName, INT_MIN));
+			}
+
+			groupIds.push_back(*unspecifiedGroupId);
+			continue;
+		}
+
+		auto &bucketGroupId = bucketGroupIds[static_cast<size_t>(*bucket)];
+
+		if (!bucketGroupId)
+		{
+			bucketGroupId = GetOrCreateListViewGroup(GetDateGroupInfo(*bucket, context));
+		}
+
+		groupIds.push_back(*bucketGroupId);
+	}
+
+	return groupIds;
+}
+
+std::optional<ShellBrowser::GroupInfo> ShellBrowser::DetermineItemGroupInfo(
+	const BasicItemInfo_t &basicItemInfo, const GroupingContext &context) const
+{
 	std::optional<GroupInfo> groupInfo;
 
 	switch (m_folderSettings.sortMode)
@@ -162,7 +350,7 @@ int ShellBrowser::DetermineItemGroup(int iItemInternal)
 		break;
 
 	case SortMode::DateModified:
-		groupInfo = DetermineItemDateGroup(basicItemInfo, GroupByDateType::Modified);
+		groupInfo = DetermineItemDateGroup(basicItemInfo, context);
 		break;
 
 	case SortMode::TotalSize:
@@ -224,11 +412,11 @@ int ShellBrowser::DetermineItemGroup(int iItemInternal)
 		break;
 
 	case SortMode::Created:
-		groupInfo = DetermineItemDateGroup(basicItemInfo, GroupByDateType::Created);
+		groupInfo = DetermineItemDateGroup(basicItemInfo, context);
 		break;
 
 	case SortMode::Accessed:
-		groupInfo = DetermineItemDateGroup(basicItemInfo, GroupByDateType::Accessed);
+		groupInfo = DetermineItemDateGroup(basicItemInfo, context);
 		break;
 
 	case SortMode::Title:
@@ -295,18 +483,17 @@ int ShellBrowser::DetermineItemGroup(int iItemInternal)
 		groupInfo = DetermineItemNetworkStatus(basicItemInfo);
 		break;
 
-	default:
-		assert(false);
+	case SortMode::Crc32c:
+	case SortMode::XxHash64:
+	case SortMode::Sha256:
 		break;
-	}
 
-	if (!groupInfo)
-	{
-		groupInfo = GroupInfo(
-			ResourceHelper::LoadString(m_hResourceModule, IDS_GROUPBY_UNSPECIFIED), INT_MIN);
+	// Items in any other column are placed in the unspecified group.
+	default:
+		break;
 	}
 
-	return GetOrCreateListViewGroup(*groupInfo);
+	return groupInfo;
 }
 
 int ShellBrowser::GetOrCreateListViewGroup(const GroupInfo &groupInfo)
@@ -456,146 +643,49 @@ std::optional<ShellBrowser::GroupInfo> ShellBrowser::DetermineItemTypeGroupVirtu
 }
 
 std::optional<ShellBrowser::GroupInfo> ShellBrowser::DetermineItemDateGroup(
-	const BasicItemInfo_t &itemInfo, GroupByDateType dateType) const
+	const BasicItemInfo_t &itemInfo, const GroupingContext &context) const
 {
-	if (!itemInfo.isFindDataValid)
+	auto bucket = DetermineItemDateBucket(itemInfo.wfd, itemInfo.isFindDataValid, context);
+
+	if (!bucket)
 	{
 		return std::nullopt;
 	}
 
-	using namespace boost::gregorian;
-	using namespace boost::posix_time;
+	return GetDateGroupInfo(*bucket, context);
+}
 
-	SYSTEMTIME stFileTime;
-	BOOL ret = FALSE;
+std::optional<DateGroupBuckets::Bucket> ShellBrowser::DetermineItemDateBucket(
+	const WIN32_FIND_DATA &wfd, bool isFindDataValid, const GroupingContext &context) const
+{
+	if (!isFindDataValid || !context.dateType || !context.dateBuckets)
+	{
+		return std::nullopt;
+	}
 
-	switch (dateType)
+	switch (*context.dateType)
 	{
 	case GroupByDateType::Modified:
-		ret = FileTimeToLocalSystemTime(&itemInfo.wfd.ftLastWriteTime, &stFileTime);
-		break;
+		return context.dateBuckets->Classify(wfd.ftLastWriteTime);
 
 	case GroupByDateType::Created:
-		ret = FileTimeToLocalSystemTime(&itemInfo.wfd.ftCreationTime, &stFileTime);
-		break;
+		return context.dateBuckets->Classify(wfd.ftCreationTime);
 
 	case GroupByDateType::Accessed:
-		ret = FileTimeToLocalSystemTime(&itemInfo.wfd.ftLastAccessTime, &stFileTime);
-		break;
+		return context.dateBuckets->Classify(wfd.ftLastAccessTime);
 
 	default:
 		throw std::runtime_error("Incorrect date type");
 	}
+}
 
-	if (!ret)
-	{
-		return std::nullopt;
-	}
-
-	FILETIME localFileTime;
-	ret = SystemTimeToFileTime(&stFileTime, &localFileTime);
-
-	if (!ret)
-	{
-		return std::nullopt;
-	}
-
-	auto filePosixTime = from_ftime<ptime>(localFileTime);
-	date fileDate = filePosixTime.date();
-
-	date today = day_clock::local_day();
-	int relativeSortPosition = 0;
-
-	if (fileDate > today)
-	{
-		return GroupInfo(ResourceHelper::LoadString(m_hResourceModule, IDS_GROUPBY_DATE_FUTURE),
-			relativeSortPosition);
-	}
-
-	relativeSortPosition--;
-
-	if (fileDate == today)
-	{
-		return GroupInfo(ResourceHelper::LoadString(m_hResourceModule, IDS_GROUPBY_DATE_TODAY),
-			relativeSortPosition);
-	}
-
-	date yesterday = today - days(1);
-
-	relativeSortPosition--;
-
-	if (fileDate == yesterday)
-	{
-		return GroupInfo(ResourceHelper::LoadString(m_hResourceModule, IDS_GROUPBY_DATE_YESTERDAY),
-			relativeSortPosition);
-	}
-
-	// Note that this assumes that Sunday is the first day of the week.
-	unsigned short currentWeekday = today.day_of_week().as_number();
-	date startOfWeek = today - days(currentWeekday);
-
-	relativeSortPosition--;
-
-	if (fileDate >= startOfWeek)
-	{
-		return GroupInfo(ResourceHelper::LoadString(m_hResourceModule, IDS_GROUPBY_DATE_THIS_WEEK),
-			relativeSortPosition);
-	}
-
-	date startOfLastWeek = startOfWeek - weeks(1);
-
-	relativeSortPosition--;
-
-	if (fileDate >= startOfLastWeek)
-	{
-		return GroupInfo(ResourceHelper::LoadString(m_hResourceModule, IDS_GROUPBY_DATE_LAST_WEEK),
-			relativeSortPosition);
-	}
-
-	date startOfMonth = date(today.year(), today.month(), 1);
-
-	relativeSortPosition--;
-
-	if (fileDate >= startOfMonth)
-	{
-		return GroupInfo(ResourceHelper::LoadString(m_hResourceModule, IDS_GROUPBY_DATE_THIS_MONTH),
-			relativeSortPosition);
-	}
-
-	date startOfLastMonth = startOfMonth - months(1);
-
-	relativeSortPosition--;
-
-	if (fileDate >= startOfLastMonth)
-	{
-		return GroupInfo(ResourceHelper::LoadString(m_hResourceModule, IDS_GROUPBY_DATE_LAST_MONTH),
-			relativeSortPosition);
-	}
-
-	date startOfYear = date(today.year(), 1, 1);
-
-	relativeSortPosition--;
-
-	if (fileDate >= startOfYear)
-	{
-		return GroupInfo(ResourceHelper::LoadString(m_hResourceModule, IDS_GROUPBY_DATE_THIS_YEAR),
-			relativeSortPosition);
-	}
-
-	date startOfLastYear = startOfYear - years(1);
-
-	relativeSortPosition--;
-
-	if (fileDate >= startOfLastYear)
-	{
-		return GroupInfo(ResourceHelper::LoadString(m_hResourceModule, IDS_GROUPBY_DATE_LAST_YEAR),
-			relativeSortPosition);
-	}
-
-	relativeSortPosition--;
-
-	return GroupInfo(ResourceHelper::LoadString(m_hResourceModule, IDS_GROUPBY_DATE_LONG_AGO),
-		relativeSortPosition);
+ShellBrowser::GroupInfo ShellBrowser::GetDateGroupInfo(DateGroupBuckets::Bucket bucket,
+	const GroupingContext &context) const
+{
+	// The buckets are ordered from most to least recent, with each group being sorted after the
+	// previous one.
+	auto index = static_cast<int>(bucket);
+	return GroupInfo(context.dateGroupNames[index], -index);
 }
 
 std::optional<ShellBrowser::GroupInfo> ShellBrowser::DetermineItemSummaryGroup(
@@ -832,31 +922,63 @@ std::optional<ShellBrowser::GroupInfo> ShellBrowser::DetermineItemNetworkStatus(
 
 void ShellBrowser::MoveItemsIntoGroups()
 {
-	LVITEM item;
-	int nItems;
-	int iGroupId;
-	int i = 0;
-
 	ListView_RemoveAllGroups(m_hListView);
 	ListView_EnableGroupView(m_hListView, TRUE);
 
-	nItems = ListView_GetItemCount(m_hListView);
+	int nItems = ListView_GetItemCount(m_hListView);
 
 	SendMessage(m_hListView, WM_SETREDRAW, FALSE, NULL);
 
 	m_listViewGroups.clear();
 	m_groupIdCounter = 0;
 
-	for (i = 0; i < nItems; i++)
+	std::vector<int> internalIndexes;
+	internalIndexes.reserve(nItems);
+
+	for (int i = 0; i < nItems; i++)
 	{
+		LVITEM item;
 		item.mask = LVIF_PARAM;
 		item.iItem = i;
 		item.iSubItem = 0;
 		ListView_GetItem(m_hListView, &item);
 
-		iGroupId = DetermineItemGroup((int) item.lParam);
+		internalIndexes.push_back(static_cast<int>(item.lParam));
+	}
+
+	std::vector<int> groupIds = DetermineItemGroups(internalIndexes, GetGroupingContext());
+
+	// Since the final size of each group is known at this point, each group can be inserted into
+	// the listview once, with the correct header, rather than having its header updated each time
+	// an item is added.
+	std::vector<int> groupSizes(m_groupIdCounter, 0);
 
-		InsertItemIntoGroup(i, iGroupId);
+	for (int groupId : groupIds)
+	{
+		groupSizes[groupId]++;
+	}
+
+	auto &groupIdIndex = m_listViewGroups.get<0>();
+
+	for (auto itr = groupIdIndex.begin(); itr != groupIdIndex.end(); ++itr)
+	{
+		groupIdIndex.modify(itr,
+			[&groupSizes](ListViewGroup &group)
+			{
+				group.numItems = groupSizes[group.id];
+			});
+
+		InsertGroupIntoListView(*itr);
+	}
+
+	for (int i = 0; i < nItems; i++)
+	{
+		LVITEM item;
+		item.mask = LVIF_GROUPID;
+		item.iItem = i;
+		item.iSubItem = 0;
+		item.iGroupId = groupIds[i];
+		ListView_SetItem(m_hListView, &item);
 	}
 
 	SendMessage(m_hListView, WM_SETREDRAW, TRUE, NULL);
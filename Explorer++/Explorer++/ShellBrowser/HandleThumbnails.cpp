@@ -6,6 +6,7 @@
 #include "ShellBrowser.h"
 #include "ItemData.h"
 #include "ViewModes.h"
+#include "../Helper/TraceRecorder.h"
 #include <wil/com.h>
 #include <thumbcache.h>
 #include <list>
@@ -84,12 +85,16 @@ void ShellBrowser::QueueThumbnailTask(int internalIndex)
 
 	BasicItemInfo_t basicItemInfo = getBasicItemInfo(internalIndex);
 
+	StartThreadPoolIfNecessary(m_thumbnailThreadPool);
+
 	auto result = m_thumbnailThreadPool.push(
 		[this, thumbnailResultID, internalIndex, basicItemInfo](
 			int id) -> std::optional<ThumbnailResult_t>
 		{
 			UNREFERENCED_PARAMETER(id);
 
+			TRACE_SCOPE("ShellBrowser::GetThumbnail");
+
 			auto bitmap = GetThumbnail(basicItemInfo.pidlComplete.get(),
 				WTS_EXTRACT | WTS_SCALETOREQUESTEDSIZE);
 
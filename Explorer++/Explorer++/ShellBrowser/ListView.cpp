@@ -457,6 +457,8 @@ void ShellBrowser::QueueInfoTipTask(int internalIndex, const std::wstring &exist
 	Config configCopy = *m_config;
 	bool virtualFolder = InVirtualFolder();
 
+	StartThreadPoolIfNecessary(m_infoTipsThreadPool);
+
 	auto result = m_infoTipsThreadPool.push(
 		[this, infoTipResultId, internalIndex, basicItemInfo, configCopy, virtualFolder,
 			existingInfoTip](int id)
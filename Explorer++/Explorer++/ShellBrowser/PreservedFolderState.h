@@ -5,6 +5,7 @@
 #pragma once
 
 #include "FolderSettings.h"
+#include "../Helper/ListViewHelper.h"
 #include "../Helper/Macros.h"
 
 class ShellBrowser;
@@ -15,6 +16,7 @@ public:
 	PreservedFolderState(const ShellBrowser *shellBrowser);
 
 	FolderSettings folderSettings;
+	ListViewHelper::ScrollPosition scrollPosition;
 
 private:
 	DISALLOW_COPY_AND_ASSIGN(PreservedFolderState);
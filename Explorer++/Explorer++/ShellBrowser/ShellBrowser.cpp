@@ -71,6 +71,7 @@ ShellBrowser::ShellBrowser(int id, HWND hOwner, CoreInterface *coreInterface,
 	m_acceleratorTable(coreInterface->GetAcceleratorTable()),
 	m_hOwner(hOwner),
 	m_cachedIcons(coreInterface->GetCachedIcons()),
+	m_checksumService(coreInterface->GetChecksumService()),
 	m_iconResourceLoader(coreInterface->GetIconResourceLoader()),
 	m_config(coreInterface->GetConfig()),
 	m_tabNavigation(tabNavigation),
@@ -79,13 +80,13 @@ ShellBrowser::ShellBrowser(int id, HWND hOwner, CoreInterface *coreInterface,
 	m_folderColumns(initialColumns
 			? *initialColumns
 			: coreInterface->GetConfig()->globalFolderSettings.folderColumns),
-	m_columnThreadPool(1, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
+	m_columnThreadPool(0, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
 		CoUninitialize),
 	m_columnResultIDCounter(0),
-	m_thumbnailThreadPool(1, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
+	m_thumbnailThreadPool(0, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
 		CoUninitialize),
 	m_thumbnailResultIDCounter(0),
-	m_infoTipsThreadPool(1, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
+	m_infoTipsThreadPool(0, std::bind(CoInitializeEx, nullptr, COINIT_APARTMENTTHREADED),
 		CoUninitialize),
 	m_infoTipResultIDCounter(0),
 	m_draggedDataObject(nullptr),
@@ -148,6 +149,7 @@ ShellBrowser::~ShellBrowser()
 	DestroyWindow(m_hListView);
 
 	m_columnThreadPool.clear_queue();
+	m_checksumService->CancelGroup(m_ID);
 	m_thumbnailThreadPool.clear_queue();
 	m_infoTipsThreadPool.clear_queue();
 
@@ -361,6 +363,7 @@ void ShellBrowser::SetViewModeInternal(ViewMode viewMode)
 	if (viewMode != +ViewMode::Details)
 	{
 		m_columnThreadPool.clear_queue();
+		m_checksumService->CancelGroup(m_ID);
 		m_columnResults.clear();
 	}
 
@@ -865,7 +868,7 @@ void ShellBrowser::PositionDroppedItems()
 	}
 }
 
-int ShellBrowser::DetermineItemSortedPosition(LPARAM lParam) const
+int ShellBrowser::DetermineItemSortedPosition(LPARAM lParam)
 {
 	LVITEM lvItem;
 	BOOL bItem;
@@ -875,6 +878,8 @@ int ShellBrowser::DetermineItemSortedPosition(LPARAM lParam) const
 
 	nItems = ListView_GetItemCount(m_hListView);
 
+	CaptureSortChecksums();
+
 	while (res > 0 && i < nItems)
 	{
 		lvItem.mask = LVIF_PARAM;
@@ -894,6 +899,8 @@ int ShellBrowser::DetermineItemSortedPosition(LPARAM lParam) const
 		i++;
 	}
 
+	m_sortChecksums.reset();
+
 	/* The item will always be inserted BEFORE
 	the item at position i that we specify here.
 	For example, specifying 0, will place the item
@@ -1264,6 +1271,16 @@ int ShellBrowser::GetUniqueFolderId() const
 	return m_uniqueFolderId;
 }
 
+// The worker threads are only started once there's some work for them to do. That way, tabs that
+// are never shown don't create any threads.
+void ShellBrowser::StartThreadPoolIfNecessary(ctpl::thread_pool &threadPool)
+{
+	if (threadPool.size() == 0)
+	{
+		threadPool.resize(1);
+	}
+}
+
 BasicItemInfo_t ShellBrowser::getBasicItemInfo(int internalIndex) const
 {
 	const ItemInfo_t &itemInfo = m_itemInfoMap.at(internalIndex);
@@ -6,12 +6,14 @@
 
 #include "ColumnDataRetrieval.h"
 #include "Columns.h"
+#include "DateGroupBuckets.h"
 #include "FolderSettings.h"
 #include "NavigatorInterface.h"
 #include "ServiceProvider.h"
 #include "SignalWrapper.h"
 #include "SortModes.h"
 #include "ViewModes.h"
+#include "../Helper/DirectoryChangeCoalescer.h"
 #include "../Helper/Macros.h"
 #include "../Helper/ShellDropTargetWindow.h"
 #include "../Helper/ShellHelper.h"
@@ -24,6 +26,7 @@
 #include <wil/com.h>
 #include <wil/resource.h>
 #include <thumbcache.h>
+#include <array>
 #include <future>
 #include <list>
 #include <optional>
@@ -154,6 +157,24 @@ public:
 	int LocateFileItemIndex(const TCHAR *szFileName) const;
 	bool InVirtualFolder() const;
 	BOOL CanCreate() const;
+
+	// If this is called, the next navigation will be committed without the folder being
+	// enumerated. The enumeration will then only occur when the tab is refreshed. This allows tabs
+	// that aren't initially shown (e.g. tabs restored in the background at startup) to be created
+	// cheaply.
+	void DeferNextEnumeration();
+	bool IsEnumerationDeferred() const;
+
+	// Releases the items loaded for the current folder, leaving the tab in the same state as if
+	// its enumeration had been deferred. The selection and scroll position are restored when the
+	// folder is reloaded.
+	void Hibernate();
+
+	// Rereads the current folder and only updates the items that have been added, removed or
+	// modified, rather than reloading every item. Falls back to a full refresh when the folder
+	// can't be read directly (e.g. when it's a virtual folder).
+	void RefreshChangedItems();
+
 	HRESULT CopySelectedItemsToClipboard(bool copy);
 	void PasteShortcut();
 	void StartRenamingSelectedItems();
@@ -223,13 +244,6 @@ private:
 		}
 	};
 
-	struct AlteredFile_t
-	{
-		TCHAR szFileName[MAX_PATH];
-		DWORD dwAction;
-		int iFolderIndex;
-	};
-
 	struct AwaitingAdd_t
 	{
 		int iItem;
@@ -308,6 +322,27 @@ private:
 		Accessed
 	};
 
+	// Information that's shared between all the items being grouped. This is cached and only
+	// recalculated when one of the values it depends on changes (see GetGroupingContext()).
+	struct GroupingContext
+	{
+		// The sort mode, local time and time zone the context was created for.
+		SortMode sortMode;
+		SYSTEMTIME localTime;
+		TIME_ZONE_INFORMATION timeZone;
+
+		// The bias in effect when the context was created. This changes when daylight saving
+		// time starts or ends, even though the rest of the time zone information doesn't.
+		LONG currentBias;
+
+		std::wstring unspecifiedGroupName;
+
+		// The remaining fields are only set when grouping by one of the date columns.
+		std::optional<GroupByDateType> dateType;
+		std::optional<DateGroupBuckets> dateBuckets;
+		std::array<std::wstring, DateGroupBuckets::NUM_BUCKETS> dateGroupNames;
+	};
+
 	struct DirectoryState
 	{
 		unique_pidl_absolute pidlDirectory;
@@ -369,6 +404,8 @@ private:
 	static const UINT PROCESS_SHELL_CHANGES_TIMER_ID = 1;
 	static const UINT PROCESS_SHELL_CHANGES_TIMEOUT = 100;
 
+	static const UINT DIRECTORY_CHANGES_TIMEOUT = 200;
+
 	ShellBrowser(int id, HWND hOwner, CoreInterface *coreInterface,
 		TabNavigationInterface *tabNavigation, FileActionHandler *fileActionHandler,
 		const std::vector<std::unique_ptr<PreservedHistoryEntry>> &history, int currentEntry,
@@ -388,6 +425,11 @@ private:
 	HRESULT BrowseFolder(PCIDLIST_ABSOLUTE pidlDirectory, bool addHistoryEntry = true) override;
 
 	/* Browsing support. */
+	HRESULT BrowseFolderDeferred(PCIDLIST_ABSOLUTE pidlDirectory, bool addHistoryEntry);
+	HRESULT GetFolderDetails(PCIDLIST_ABSOLUTE pidlDirectory, std::wstring &parsingPath,
+		bool &virtualFolder);
+	void CommitNavigation(PCIDLIST_ABSOLUTE pidlDirectory, const std::wstring &parsingPath,
+		bool virtualFolder, bool addHistoryEntry, bool enumerationDeferred);
 	HRESULT EnumerateFolder(PCIDLIST_ABSOLUTE pidlDirectory, bool addHistoryEntry,
 		std::vector<ItemInfo_t> &items);
 	void PrepareToChangeFolders();
@@ -470,12 +512,17 @@ private:
 
 	/* Sorting. */
 	int CALLBACK Sort(int InternalIndex1, int InternalIndex2) const;
+	void SortListViewItems();
+	void CaptureSortChecksums();
+	const std::string *GetSortChecksum(int internalIndex) const;
 
 	/* Listview column support. */
 	void AddFirstColumn();
 	void SetUpListViewColumns();
 	void DeleteAllColumns();
 	void QueueColumnTask(int itemInternalIndex, ColumnType columnType);
+	void QueueChecksumColumnTask(int itemInternalIndex, ColumnType columnType,
+		ChecksumAlgorithm algorithm);
 	static ColumnResult_t GetColumnTextAsync(HWND listView, int columnResultId,
 		ColumnType columnType, int internalIndex, const BasicItemInfo_t &basicItemInfo,
 		const GlobalFolderSettings &globalFolderSettings);
@@ -506,9 +553,11 @@ private:
 	void OnItemModified(PCIDLIST_ABSOLUTE simplePidl);
 	void UpdateItem(PCIDLIST_ABSOLUTE pidl, PCIDLIST_ABSOLUTE updatedPidl = nullptr);
 	void OnItemRenamed(PCIDLIST_ABSOLUTE simplePidlOld, PCIDLIST_ABSOLUTE simplePidlNew);
+	void ApplyDirectoryChanges(const std::vector<DirectoryChangeCoalescer::Change> &changes);
+	void RescanDirectory();
 	void InvalidateAllColumnsForItem(int itemIndex);
 	void InvalidateIconForItem(int itemIndex);
-	int DetermineItemSortedPosition(LPARAM lParam) const;
+	int DetermineItemSortedPosition(LPARAM lParam);
 
 	/* Filtering support. */
 	void UpdateFiltering();
@@ -526,13 +575,25 @@ private:
 	int GroupNameComparison(const ListViewGroup &group1, const ListViewGroup &group2);
 	int GroupRelativePositionComparison(const ListViewGroup &group1, const ListViewGroup &group2);
 	const ListViewGroup GetListViewGroupById(int groupId);
+	const GroupingContext &GetGroupingContext();
+	GroupingContext CreateGroupingContext(const SYSTEMTIME &localTime,
+		const TIME_ZONE_INFORMATION &timeZone, LONG currentBias) const;
 	int DetermineItemGroup(int iItemInternal);
+	int DetermineItemGroup(int iItemInternal, const GroupingContext &context);
+	std::vector<int> DetermineItemGroups(const std::vector<int> &internalIndexes,
+		const GroupingContext &context);
+	std::optional<GroupInfo> DetermineItemGroupInfo(const BasicItemInfo_t &itemInfo,
+		const GroupingContext &context) const;
 	std::optional<GroupInfo> DetermineItemNameGroup(const BasicItemInfo_t &itemInfo) const;
 	std::optional<GroupInfo> DetermineItemSizeGroup(const BasicItemInfo_t &itemInfo) const;
 	std::optional<GroupInfo> DetermineItemTotalSizeGroup(const BasicItemInfo_t &itemInfo) const;
 	std::optional<GroupInfo> DetermineItemTypeGroupVirtual(const BasicItemInfo_t &itemInfo) const;
 	std::optional<GroupInfo> DetermineItemDateGroup(const BasicItemInfo_t &itemInfo,
-		GroupByDateType dateType) const;
+		const GroupingContext &context) const;
+	std::optional<DateGroupBuckets::Bucket> DetermineItemDateBucket(const WIN32_FIND_DATA &wfd,
+		bool isFindDataValid, const GroupingContext &context) const;
+	GroupInfo GetDateGroupInfo(DateGroupBuckets::Bucket bucket,
+		const GroupingContext &context) const;
 	std::optional<GroupInfo> DetermineItemSummaryGroup(const BasicItemInfo_t &itemInfo,
 		const SHCOLUMNID *pscid, const GlobalFolderSettings &globalFolderSettings) const;
 	std::optional<GroupInfo> DetermineItemFreeSpaceGroup(const BasicItemInfo_t &itemInfo) const;
@@ -637,6 +698,13 @@ private:
 
 	std::unique_ptr<IconFetcher> m_iconFetcher;
 	CachedIcons *m_cachedIcons;
+	ChecksumService *m_checksumService;
+
+	// Only set while items are being sorted by one of the checksum columns. Maps each item's
+	// internal index to the checksum that was cached for it when the sort started, so that the
+	// comparison function doesn't need to query the checksum service and sees the same set of
+	// checksums throughout the sort, even as new checksums are calculated.
+	std::optional<std::unordered_map<int, std::string>> m_sortChecksums;
 
 	IconResourceLoader *m_iconResourceLoader;
 
@@ -648,6 +716,8 @@ private:
 	std::unordered_map<int, std::future<std::optional<InfoTipResult>>> m_infoTipResults;
 	int m_infoTipResultIDCounter;
 
+	static void StartThreadPoolIfNecessary(ctpl::thread_pool &threadPool);
+
 	/* Internal state. */
 	const HINSTANCE m_hResourceModule;
 	HACCEL *m_acceleratorTable;
@@ -663,6 +733,13 @@ private:
 	modification. */
 	int m_uniqueFolderId;
 
+	bool m_deferNextEnumeration = false;
+	bool m_enumerationDeferred = false;
+
+	// Set when the tab is hibernated. Used to restore the scroll position once the folder has been
+	// reloaded.
+	std::unique_ptr<PreservedFolderState> m_hibernatedState;
+
 	const Config *m_config;
 	FolderSettings m_folderSettings;
 
@@ -671,7 +748,6 @@ private:
 
 	/* Directory monitoring. */
 	ULONG m_shChangeNotifyId;
-	unique_pidl_absolute m_renamedItemOldPidl;
 
 	wil::com_ptr_nothrow<IShellFolder> m_desktopFolder;
 	unique_pidl_absolute m_recycleBinPidl;
@@ -680,7 +756,10 @@ private:
 	have been modified (i.e. created, deleted,
 	renamed, etc). */
 	CRITICAL_SECTION m_csDirectoryAltered;
-	std::list<AlteredFile_t> m_AlteredList;
+	DirectoryChangeCoalescer m_directoryChanges;
+
+	// The unique folder id that the pending directory changes refer to.
+	int m_directoryChangesFolderId = -1;
 
 	int m_middleButtonItem;
 
@@ -720,4 +799,5 @@ private:
 
 	ListViewGroupSet m_listViewGroups;
 	int m_groupIdCounter;
+	std::optional<GroupingContext> m_groupingContext;
 };
@@ -369,3 +369,15 @@ int SortByMediaMetadata(const BasicItemInfo_t &itemInfo1, const BasicItemInfo_t
 
 	return StrCmpLogicalW(mediaMetadata1.c_str(), mediaMetadata2.c_str());
 }
+
+// Either checksum can be null, if it hasn't been calculated yet. Those items are placed after the
+// items that have a checksum.
+int SortByChecksum(const std::string *checksum1, const std::string *checksum2)
+{
+	if (!checksum1 || !checksum2)
+	{
+		return static_cast<int>(checksum2 != nullptr) - static_cast<int>(checksum1 != nullptr);
+	}
+
+	return checksum1->compare(*checksum2);
+}
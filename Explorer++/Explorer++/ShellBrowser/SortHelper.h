@@ -44,3 +44,4 @@ int SortByPrinterProperty(const BasicItemInfo_t &itemInfo1, const BasicItemInfo_
 int SortByNetworkAdapterStatus(const BasicItemInfo_t &itemInfo1, const BasicItemInfo_t &itemInfo2);
 int SortByMediaMetadata(const BasicItemInfo_t &itemInfo1, const BasicItemInfo_t &itemInfo2,
 	MediaMetadataType mediaMetadataType);
+int SortByChecksum(const std::string *checksum1, const std::string *checksum2);
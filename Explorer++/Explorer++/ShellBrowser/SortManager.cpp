@@ -12,6 +12,29 @@
 #include <propkey.h>
 #include <cassert>
 
+namespace
+{
+
+std::optional<ChecksumAlgorithm> GetSortModeChecksumAlgorithm(SortMode sortMode)
+{
+	switch (sortMode)
+	{
+	case SortMode::Crc32c:
+		return ChecksumAlgorithm::Crc32c;
+
+	case SortMode::XxHash64:
+		return ChecksumAlgorithm::XxHash64;
+
+	case SortMode::Sha256:
+		return ChecksumAlgorithm::Sha256;
+
+	default:
+		return std::nullopt;
+	}
+}
+
+}
+
 void ShellBrowser::SortFolder(SortMode sortMode)
 {
 	m_folderSettings.sortMode = sortMode;
@@ -25,8 +48,7 @@ void ShellBrowser::SortFolder(SortMode sortMode)
 		SetShowInGroups(TRUE);
 	}
 
-	SendMessage(m_hListView, LVM_SORTITEMS, reinterpret_cast<WPARAM>(this),
-		reinterpret_cast<LPARAM>(SortStub));
+	SortListViewItems();
 
 	/* If in details view, the column sort
 	arrow will need to be changed to reflect
@@ -37,6 +59,73 @@ void ShellBrowser::SortFolder(SortMode sortMode)
 	}
 }
 
+void ShellBrowser::SortListViewItems()
+{
+	CaptureSortChecksums();
+	ListView_SortItems(m_hListView, SortStub, this);
+	m_sortChecksums.reset();
+}
+
+// Files aren't hashed while sorting, as that could block for a considerable amount of time. Only
+// checksums that have already been calculated are used. Those are retrieved up front, so that
+// each comparison is a simple lookup and the order used can't change part way through a sort.
+void ShellBrowser::CaptureSortChecksums()
+{
+	m_sortChecksums.reset();
+
+	auto algorithm = GetSortModeChecksumAlgorithm(m_folderSettings.sortMode);
+
+	if (!algorithm)
+	{
+		return;
+	}
+
+	std::vector<int> internalIndexes;
+	std::vector<ChecksumService::File> files;
+
+	for (const auto &[internalIndex, itemInfo] : m_itemInfoMap)
+	{
+		auto file = GetChecksumColumnFile(getBasicItemInfo(internalIndex));
+
+		if (file)
+		{
+			internalIndexes.push_back(internalIndex);
+			files.push_back(std::move(*file));
+		}
+	}
+
+	auto checksums = m_checksumService->GetCachedChecksums(files, *algorithm);
+
+	m_sortChecksums.emplace();
+
+	for (size_t i = 0; i < checksums.size(); i++)
+	{
+		if (checksums[i])
+		{
+			m_sortChecksums->emplace(internalIndexes[i], std::move(*checksums[i]));
+		}
+	}
+}
+
+const std::string *ShellBrowser::GetSortChecksum(int internalIndex) const
+{
+	assert(m_sortChecksums);
+
+	if (!m_sortChecksums)
+	{
+		return nullptr;
+	}
+
+	auto itr = m_sortChecksums->find(internalIndex);
+
+	if (itr == m_sortChecksums->end())
+	{
+		return nullptr;
+	}
+
+	return &itr->second;
+}
+
 int CALLBACK ShellBrowser::SortStub(LPARAM lParam1, LPARAM lParam2, LPARAM lParamSort)
 {
 	auto *pShellBrowser = reinterpret_cast<ShellBrowser *>(lParamSort);
@@ -364,6 +453,13 @@ int CALLBACK ShellBrowser::Sort(int InternalIndex1, int InternalIndex2) const
 				SortByMediaMetadata(basicItemInfo1, basicItemInfo2, MediaMetadataType::Year);
 			break;
 
+		case SortMode::Crc32c:
+		case SortMode::XxHash64:
+		case SortMode::Sha256:
+			comparisonResult =
+				SortByChecksum(GetSortChecksum(InternalIndex1), GetSortChecksum(InternalIndex2));
+			break;
+
 		default:
 			assert(false);
 			break;
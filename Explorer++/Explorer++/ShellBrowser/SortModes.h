@@ -78,6 +78,9 @@ BETTER_ENUM(SortMode, int,
 	MediaProducer = 61,
 	MediaPublisher = 62,
 	MediaWriter = 63,
-	MediaYear = 64
+	MediaYear = 64,
+	Crc32c = 65,
+	XxHash64 = 66,
+	Sha256 = 67
 )
 // clang-format on
@@ -262,23 +262,18 @@ void ShellTreeView::DirectoryAlteredRenameFile(const TCHAR *szFullFileName)
 	}
 }
 
-void ShellTreeView::DirectoryAlteredCallback(const TCHAR *szFileName, DWORD dwAction, void *pData)
+void ShellTreeView::OnDriveModified(const std::wstring &drive, const std::wstring &fileName,
+	DWORD dwAction)
 {
-	DirectoryAltered_t *pDirectoryAltered = nullptr;
-	ShellTreeView *shellTreeView = nullptr;
 	TCHAR szFullFileName[MAX_PATH];
 
-	pDirectoryAltered = (DirectoryAltered_t *) pData;
-
-	shellTreeView = pDirectoryAltered->shellTreeView;
-
-	StringCchCopy(szFullFileName, SIZEOF_ARRAY(szFullFileName), pDirectoryAltered->szPath);
-	if (!PathAppend(szFullFileName, szFileName))
+	StringCchCopy(szFullFileName, SIZEOF_ARRAY(szFullFileName), drive.c_str());
+	if (!PathAppend(szFullFileName, fileName.c_str()))
 	{
 		return;
 	}
 
-	shellTreeView->DirectoryModified(dwAction, szFullFileName);
+	DirectoryModified(dwAction, szFullFileName);
 }
 
 void ShellTreeView::DirectoryModified(DWORD dwAction, const TCHAR *szFullFileName)
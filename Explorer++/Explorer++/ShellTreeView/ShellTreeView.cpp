@@ -19,10 +19,12 @@
 #include "Config.h"
 #include "CoreInterface.h"
 #include "DarkModeHelper.h"
+#include "RenameErrorHelper.h"
 #include "TabContainer.h"
 #include "../Helper/CachedIcons.h"
 #include "../Helper/ClipboardHelper.h"
 #include "../Helper/Controls.h"
+#include "../Helper/DirectoryWatchRegistry.h"
 #include "../Helper/DragDropHelper.h"
 #include "../Helper/DriveInfo.h"
 #include "../Helper/FileActionHandler.h"
@@ -36,12 +38,14 @@
 int CALLBACK CompareItemsStub(LPARAM lParam1, LPARAM lParam2, LPARAM lParamSort);
 DWORD WINAPI Thread_MonitorAllDrives(LPVOID pParam);
 
-ShellTreeView::ShellTreeView(HWND hParent, CoreInterface *coreInterface, IDirectoryMonitor *pDirMon,
-	TabContainer *tabContainer, FileActionHandler *fileActionHandler, CachedIcons *cachedIcons) :
+ShellTreeView::ShellTreeView(HWND hParent, CoreInterface *coreInterface,
+	DirectoryWatchRegistry *directoryWatchRegistry, TabContainer *tabContainer,
+	FileActionHandler *fileActionHandler, CachedIcons *cachedIcons) :
 	ShellDropTargetWindow(CreateTreeView(hParent)),
 	m_hTreeView(GetHWND()),
 	m_config(coreInterface->GetConfig()),
-	m_pDirMon(pDirMon),
+	m_resourceInstance(coreInterface->GetResourceModule()),
+	m_directoryWatchRegistry(directoryWatchRegistry),
 	m_tabContainer(tabContainer),
 	m_fileActionHandler(fileActionHandler),
 	m_cachedIcons(cachedIcons),
@@ -1421,7 +1425,14 @@ LRESULT CALLBACK ShellTreeView::OnDeviceChange(WPARAM wParam, LPARAM lParam)
 				{
 					if (itr->monitorId)
 					{
-						m_pDirMon->StopDirectoryMonitor(*itr->monitorId);
+						m_directoryWatchRegistry->Unsubscribe(*itr->monitorId);
+						itr->monitorId.reset();
+					}
+
+					if (itr->handleOpen)
+					{
+						CloseHandle(itr->hDrive);
+						itr->handleOpen = false;
 					}
 
 					/* Log the removal. If a device removal failure message
@@ -1573,7 +1584,6 @@ void ShellTreeView::MonitorDrivePublic(const TCHAR *szDrive)
 
 void ShellTreeView::MonitorDrive(const TCHAR *szDrive)
 {
-	DirectoryAltered_t *pDirectoryAltered = nullptr;
 	DEV_BROADCAST_HANDLE dbv;
 	HANDLE hDrive;
 	HDEVNOTIFY hDevNotify;
@@ -1588,14 +1598,15 @@ void ShellTreeView::MonitorDrive(const TCHAR *szDrive)
 
 		if (hDrive != INVALID_HANDLE_VALUE)
 		{
-			pDirectoryAltered = (DirectoryAltered_t *) malloc(sizeof(DirectoryAltered_t));
-
-			StringCchCopy(pDirectoryAltered->szPath, SIZEOF_ARRAY(pDirectoryAltered->szPath),
-				szDrive);
-			pDirectoryAltered->shellTreeView = this;
-
-			auto monitorId = m_pDirMon->WatchDirectory(hDrive, szDrive, FILE_NOTIFY_CHANGE_DIR_NAME,
-				ShellTreeView::DirectoryAlteredCallback, TRUE, (void *) pDirectoryAltered);
+			/* The drive handle is only used to receive hardware
+			events. The watch itself is made through the registry,
+			so that it can be shared. */
+			auto monitorId = m_directoryWatchRegistry->Subscribe(szDrive,
+				FILE_NOTIFY_CHANGE_DIR_NAME, true,
+				[this, drive = std::wstring(szDrive)](const std::wstring &fileName, uint32_t action)
+				{
+					OnDriveModified(drive, fileName, action);
+				});
 
 			dbv.dbch_size = sizeof(dbv);
 			dbv.dbch_devicetype = DBT_DEVTYP_HANDLE;
@@ -1611,10 +1622,15 @@ void ShellTreeView::MonitorDrive(const TCHAR *szDrive)
 			{
 				StringCchCopy(de.szDrive, SIZEOF_ARRAY(de.szDrive), szDrive);
 				de.hDrive = hDrive;
+				de.handleOpen = true;
 				de.monitorId = monitorId;
 
 				m_pDriveList.push_back(de);
 			}
+			else
+			{
+				CloseHandle(hDrive);
+			}
 		}
 	}
 }
@@ -1846,9 +1862,12 @@ bool ShellTreeView::OnEndLabelEdit(const NMTVDISPINFO *dispInfo)
 
 	std::list<FileActionHandler::RenamedItem_t> renamedItemList;
 	renamedItemList.push_back(renamedItem);
-	m_fileActionHandler->RenameFiles(renamedItemList);
+	FileActionHandler::FailedRenames_t failedItems;
+	BOOL res = m_fileActionHandler->RenameFiles(renamedItemList, &failedItems);
+	ShowRenameErrors(m_hTreeView, m_resourceInstance, failedItems);
 
-	return true;
+	// If the rename failed, the original label will be kept.
+	return res == TRUE;
 }
 
 void ShellTreeView::CopySelectedItemToClipboard(bool copy)
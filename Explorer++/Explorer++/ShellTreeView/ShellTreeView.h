@@ -8,7 +8,6 @@
 #include "../Helper/ShellDropTargetWindow.h"
 #include "../Helper/ShellHelper.h"
 #include "../Helper/WindowSubclassWrapper.h"
-#include "../Helper/iDirectoryMonitor.h"
 #include "../ThirdParty/CTPL/cpl_stl.h"
 #include <boost/signals2.hpp>
 #include <wil/com.h>
@@ -17,14 +16,16 @@
 class CachedIcons;
 struct Config;
 class CoreInterface;
+class DirectoryWatchRegistry;
 class FileActionHandler;
 class TabContainer;
 
 class ShellTreeView : public ShellDropTargetWindow<HTREEITEM>
 {
 public:
-	ShellTreeView(HWND hParent, CoreInterface *coreInterface, IDirectoryMonitor *pDirMon,
-		TabContainer *tabContainer, FileActionHandler *fileActionHandler, CachedIcons *cachedIcons);
+	ShellTreeView(HWND hParent, CoreInterface *coreInterface,
+		DirectoryWatchRegistry *directoryWatchRegistry, TabContainer *tabContainer,
+		FileActionHandler *fileActionHandler, CachedIcons *cachedIcons);
 	~ShellTreeView();
 
 	/* User functions. */
@@ -104,16 +105,11 @@ private:
 		bool hasSubfolder;
 	};
 
-	typedef struct
-	{
-		TCHAR szPath[MAX_PATH];
-		ShellTreeView *shellTreeView;
-	} DirectoryAltered_t;
-
 	typedef struct
 	{
 		TCHAR szDrive[MAX_PATH];
 		HANDLE hDrive;
+		bool handleOpen;
 		std::optional<int> monitorId;
 	} DriveEvent_t;
 
@@ -156,7 +152,7 @@ private:
 	void UpdateCurrentClipboardObject(wil::com_ptr_nothrow<IDataObject> clipboardDataObject);
 	void OnClipboardUpdate();
 
-	static void DirectoryAlteredCallback(const TCHAR *szFileName, DWORD dwAction, void *pData);
+	void OnDriveModified(const std::wstring &drive, const std::wstring &fileName, DWORD dwAction);
 
 	unique_pidl_absolute GetSelectedItemPidl() const;
 
@@ -214,11 +210,12 @@ private:
 	void OnApplicationShuttingDown();
 
 	HWND m_hTreeView;
-	IDirectoryMonitor *m_pDirMon;
+	DirectoryWatchRegistry *m_directoryWatchRegistry;
 	BOOL m_bShowHidden;
 	std::vector<std::unique_ptr<WindowSubclassWrapper>> m_windowSubclasses;
 	std::vector<boost::signals2::scoped_connection> m_connections;
 	const Config *m_config;
+	HINSTANCE m_resourceInstance;
 	TabContainer *m_tabContainer;
 	FileActionHandler *m_fileActionHandler;
 
@@ -308,6 +308,15 @@ UINT SortMenuBuilder::GetSortMenuItemStringIndex(UINT uItemId)
 	case IDM_SORTBY_MEDIA_YEAR:
 		return IDS_COLUMN_NAME_YEAR;
 
+	case IDM_SORTBY_CRC32C:
+		return IDS_COLUMN_NAME_CRC32C;
+
+	case IDM_SORTBY_XXHASH64:
+		return IDS_COLUMN_NAME_XXHASH64;
+
+	case IDM_SORTBY_SHA256:
+		return IDS_COLUMN_NAME_SHA256;
+
 	default:
 		assert(false);
 		break;
@@ -506,6 +515,15 @@ int SortMenuBuilder::DetermineSortModeMenuId(SortMode sortMode)
 	case SortMode::MediaYear:
 		return IDM_SORTBY_MEDIA_YEAR;
 
+	case SortMode::Crc32c:
+		return IDM_SORTBY_CRC32C;
+
+	case SortMode::XxHash64:
+		return IDM_SORTBY_XXHASH64;
+
+	case SortMode::Sha256:
+		return IDM_SORTBY_SHA256;
+
 	default:
 		assert(false);
 		break;
@@ -704,6 +722,15 @@ int SortMenuBuilder::DetermineGroupModeMenuId(SortMode sortMode)
 	case SortMode::MediaYear:
 		return IDM_GROUPBY_MEDIA_YEAR;
 
+	case SortMode::Crc32c:
+		return IDM_GROUPBY_CRC32C;
+
+	case SortMode::XxHash64:
+		return IDM_GROUPBY_XXHASH64;
+
+	case SortMode::Sha256:
+		return IDM_GROUPBY_SHA256;
+
 	default:
 		assert(false);
 		break;
@@ -8,6 +8,7 @@
 #include "IconResourceLoader.h"
 #include "MainResource.h"
 #include "ResourceHelper.h"
+#include "../Helper/ChecksumManifest.h"
 #include "../Helper/FileOperations.h"
 #include "../Helper/Macros.h"
 #include "../Helper/RegistrySettings.h"
@@ -21,13 +22,17 @@
 
 namespace NSplitFileDialog
 {
-const int WM_APP_SETTOTALSPLITCOUNT = WM_APP + 1;
-const int WM_APP_SETCURRENTSPLITCOUNT = WM_APP + 2;
-const int WM_APP_SPLITFINISHED = WM_APP + 3;
-const int WM_APP_INPUTFILEINVALID = WM_APP + 4;
+// wParam contains the progress bar position, lParam contains the current speed, in KB/s.
+const int WM_APP_SPLITPROGRESS = WM_APP + 1;
+
+// wParam contains the FileSplitter::Result value.
+const int WM_APP_SPLITFINISHED = WM_APP + 2;
 
 const TCHAR COUNTER_PATTERN[] = _T("/N");
 
+// The progress bar tracks the number of bytes processed, scaled to this range.
+const int PROGRESS_RANGE = 1000;
+
 DWORD WINAPI SplitFileThreadProcStub(LPVOID pParam);
 }
 
@@ -35,6 +40,8 @@ const TCHAR SplitFileDialogPersistentSettings::SETTINGS_KEY[] = _T("SplitFile");
 
 const TCHAR SplitFileDialogPersistentSettings::SETTING_SIZE[] = _T("Size");
 const TCHAR SplitFileDialogPersistentSettings::SETTING_SIZE_GROUP[] = _T("SizeGroup");
+const TCHAR SplitFileDialogPersistentSettings::SETTING_CREATE_CHECKSUM_FILE[] =
+	_T("CreateChecksumFile");
 
 SplitFileDialog::SplitFileDialog(HINSTANCE hInstance, HWND hParent, CoreInterface *coreInterface,
 	const std::wstring &strFullFilename) :
@@ -130,6 +137,9 @@ INT_PTR SplitFileDialog::OnInitDialog()
 	SendMessage(hEditSize, EM_SETSEL, 0, -1);
 	SetFocus(hEditSize);
 
+	CheckDlgButton(m_hDlg, IDC_SPLIT_CHECK_CREATE_CHECKSUM_FILE,
+		m_persistentSettings->m_createChecksumFile ? BST_CHECKED : BST_UNCHECKED);
+
 	TCHAR szOutputFilename[MAX_PATH];
 	StringCchCopy(szOutputFilename, SIZEOF_ARRAY(szOutputFilename), m_strFullFilename.c_str());
 	PathStripPath(szOutputFilename);
@@ -280,48 +290,23 @@ void SplitFileDialog::SaveState()
 	m_persistentSettings->m_strSplitSize = GetWindowString(GetDlgItem(m_hDlg, IDC_SPLIT_EDIT_SIZE));
 	m_persistentSettings->m_strSplitGroup =
 		GetWindowString(GetDlgItem(m_hDlg, IDC_SPLIT_COMBOBOX_SIZES));
+	m_persistentSettings->m_createChecksumFile =
+		(IsDlgButtonChecked(m_hDlg, IDC_SPLIT_CHECK_CREATE_CHECKSUM_FILE) == BST_CHECKED);
 
 	m_persistentSettings->m_bStateSaved = TRUE;
 }
 
 INT_PTR SplitFileDialog::OnPrivateMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
-	UNREFERENCED_PARAMETER(lParam);
-
 	switch (uMsg)
 	{
-	case NSplitFileDialog::WM_APP_SETTOTALSPLITCOUNT:
-		SendDlgItemMessage(m_hDlg, IDC_SPLIT_PROGRESS, PBM_SETRANGE32, 0, wParam);
-		break;
-
-	case NSplitFileDialog::WM_APP_SETCURRENTSPLITCOUNT:
-		SendDlgItemMessage(m_hDlg, IDC_SPLIT_PROGRESS, PBM_SETPOS, wParam, 0);
+	case NSplitFileDialog::WM_APP_SPLITPROGRESS:
+		OnSplitProgress(static_cast<int>(wParam), static_cast<ULONGLONG>(lParam) * KB);
 		break;
 
 	case NSplitFileDialog::WM_APP_SPLITFINISHED:
-		OnSplitFinished();
+		OnSplitFinished(static_cast<FileSplitter::Result>(wParam));
 		break;
-
-	case NSplitFileDialog::WM_APP_INPUTFILEINVALID:
-	{
-		TCHAR szTemp[128];
-		LoadString(GetInstance(), IDS_SPLITFILEDIALOG_INPUTFILEINVALID, szTemp,
-			SIZEOF_ARRAY(szTemp));
-		SetDlgItemText(m_hDlg, IDC_SPLIT_STATIC_MESSAGE, szTemp);
-
-		assert(m_pSplitFile != nullptr);
-
-		m_pSplitFile->Release();
-		m_pSplitFile = nullptr;
-
-		m_bSplittingFile = false;
-		m_bStopSplitting = false;
-
-		KillTimer(m_hDlg, ELPASED_TIMER_ID);
-
-		SetDlgItemText(m_hDlg, IDOK, m_szOk);
-	}
-	break;
 	}
 
 	return 0;
@@ -388,9 +373,9 @@ void SplitFileDialog::OnOk()
 		std::wstring strOutputDirectory = GetWindowString(hEditOutputDirectory);
 
 		BOOL bTranslated;
-		UINT uSplitSize = GetDlgItemInt(m_hDlg, IDC_SPLIT_EDIT_SIZE, &bTranslated, FALSE);
+		ULONGLONG splitSize = GetDlgItemInt(m_hDlg, IDC_SPLIT_EDIT_SIZE, &bTranslated, FALSE);
 
-		if (!bTranslated)
+		if (!bTranslated || splitSize == 0)
 		{
 			TCHAR szTemp[128];
 
@@ -419,21 +404,30 @@ void SplitFileDialog::OnOk()
 				break;
 
 			case SizeType::KB:
-				uSplitSize *= KB;
+				splitSize *= KB;
 				break;
 
 			case SizeType::MB:
-				uSplitSize *= MB;
+				splitSize *= MB;
 				break;
 
 			case SizeType::GB:
-				uSplitSize *= GB;
+				splitSize *= GB;
 				break;
 			}
 		}
 
+		FileSplitter::Options options;
+		options.partSize = splitSize;
+
+		if (IsDlgButtonChecked(m_hDlg, IDC_SPLIT_CHECK_CREATE_CHECKSUM_FILE) == BST_CHECKED)
+		{
+			options.manifestPath = strOutputDirectory + _T("\\")
+				+ PathFindFileName(m_strFullFilename.c_str()) + ChecksumManifest::FILE_EXTENSION;
+		}
+
 		m_pSplitFile = new SplitFile(m_hDlg, m_strFullFilename, strOutputFilename,
-			strOutputDirectory, uSplitSize);
+			strOutputDirectory, options);
 
 		GetDlgItemText(m_hDlg, IDOK, m_szOk, SIZEOF_ARRAY(m_szOk));
 
@@ -446,9 +440,17 @@ void SplitFileDialog::OnOk()
 		m_uElapsedTime = 0;
 		SetTimer(m_hDlg, ELPASED_TIMER_ID, ELPASED_TIMER_TIMEOUT, nullptr);
 
+		SendDlgItemMessage(m_hDlg, IDC_SPLIT_PROGRESS, PBM_SETRANGE32, 0,
+			NSplitFileDialog::PROGRESS_RANGE);
+		SendDlgItemMessage(m_hDlg, IDC_SPLIT_PROGRESS, PBM_SETPOS, 0, 0);
+
 		LoadString(GetInstance(), IDS_SPLITFILEDIALOG_SPLITTING, szTemp, SIZEOF_ARRAY(szTemp));
 		SetDlgItemText(m_hDlg, IDC_SPLIT_STATIC_MESSAGE, szTemp);
 
+		// The background thread holds its own reference, since the dialog may be closed before the
+		// split has finished.
+		m_pSplitFile->AddRef();
+
 		HANDLE hThread = CreateThread(nullptr, 0, NSplitFileDialog::SplitFileThreadProcStub,
 			reinterpret_cast<LPVOID>(m_pSplitFile), 0, nullptr);
 		SetThreadPriority(hThread, THREAD_PRIORITY_LOWEST);
@@ -470,6 +472,11 @@ void SplitFileDialog::OnCancel()
 	if (m_bSplittingFile)
 	{
 		m_bStopSplitting = true;
+
+		if (m_pSplitFile != nullptr)
+		{
+			m_pSplitFile->StopSplitting();
+		}
 	}
 	else
 	{
@@ -501,19 +508,60 @@ void SplitFileDialog::OnChangeOutputDirectory()
 	SetDlgItemText(m_hDlg, IDC_SPLIT_EDIT_OUTPUT, parsingName.c_str());
 }
 
-void SplitFileDialog::OnSplitFinished()
+void SplitFileDialog::OnSplitProgress(int position, ULONGLONG bytesPerSecond)
 {
-	TCHAR szTemp[64];
-
-	if (!m_bStopSplitting)
+	if (!m_bSplittingFile)
 	{
-		LoadString(GetInstance(), IDS_SPLITFILEDIALOG_FINISHED, szTemp, SIZEOF_ARRAY(szTemp));
+		return;
 	}
-	else
+
+	SendDlgItemMessage(m_hDlg, IDC_SPLIT_PROGRESS, PBM_SETPOS, position, 0);
+
+	ULARGE_INTEGER speed;
+	speed.QuadPart = bytesPerSecond;
+
+	TCHAR szSpeed[32];
+	FormatSizeString(speed, szSpeed, SIZEOF_ARRAY(szSpeed));
+
+	TCHAR szTemp[64];
+	LoadString(GetInstance(), IDS_SPLITFILEDIALOG_SPLITTING_SPEED, szTemp, SIZEOF_ARRAY(szTemp));
+
+	TCHAR szMessage[128];
+	StringCchPrintf(szMessage, SIZEOF_ARRAY(szMessage), szTemp, szSpeed);
+	SetDlgItemText(m_hDlg, IDC_SPLIT_STATIC_MESSAGE, szMessage);
+}
+
+void SplitFileDialog::OnSplitFinished(FileSplitter::Result result)
+{
+	UINT messageId;
+
+	switch (result)
 	{
-		LoadString(GetInstance(), IDS_SPLITFILEDIALOG_CANCELLED, szTemp, SIZEOF_ARRAY(szTemp));
+	case FileSplitter::Result::Succeeded:
+		messageId = IDS_SPLITFILEDIALOG_FINISHED;
+		break;
+
+	case FileSplitter::Result::Cancelled:
+		messageId = IDS_SPLITFILEDIALOG_CANCELLED;
+		break;
+
+	case FileSplitter::Result::InputFileError:
+		messageId = IDS_SPLITFILEDIALOG_INPUTFILEINVALID;
+		break;
+
+	case FileSplitter::Result::InputFileEmpty:
+		messageId = IDS_SPLITFILEDIALOG_INPUTFILEEMPTY;
+		break;
+
+	case FileSplitter::Result::OutputFileError:
+	case FileSplitter::Result::ManifestError:
+	default:
+		messageId = IDS_SPLITFILEDIALOG_OUTPUTFILEERROR;
+		break;
 	}
 
+	TCHAR szTemp[128];
+	LoadString(GetInstance(), messageId, szTemp, SIZEOF_ARRAY(szTemp));
 	SetDlgItemText(m_hDlg, IDC_SPLIT_STATIC_MESSAGE, szTemp);
 
 	assert(m_pSplitFile != nullptr);
@@ -526,9 +574,11 @@ void SplitFileDialog::OnSplitFinished()
 
 	KillTimer(m_hDlg, ELPASED_TIMER_ID);
 
-	int iHighLimit =
-		static_cast<int>(SendDlgItemMessage(m_hDlg, IDC_SPLIT_PROGRESS, PBM_GETRANGE, FALSE, 0));
-	SendDlgItemMessage(m_hDlg, IDC_SPLIT_PROGRESS, PBM_SETPOS, iHighLimit, 0);
+	if (result == FileSplitter::Result::Succeeded)
+	{
+		SendDlgItemMessage(m_hDlg, IDC_SPLIT_PROGRESS, PBM_SETPOS, NSplitFileDialog::PROGRESS_RANGE,
+			0);
+	}
 
 	SetDlgItemText(m_hDlg, IDOK, m_szOk);
 }
@@ -539,124 +589,64 @@ DWORD WINAPI NSplitFileDialog::SplitFileThreadProcStub(LPVOID pParam)
 
 	auto *pSplitFile = reinterpret_cast<SplitFile *>(pParam);
 	pSplitFile->Split();
+	pSplitFile->Release();
 
 	return 0;
 }
 
 SplitFile::SplitFile(HWND hDlg, const std::wstring &strFullFilename,
-	const std::wstring &strOutputFilename, const std::wstring &strOutputDirectory, UINT uSplitSize)
-{
-	m_hDlg = hDlg;
-	m_strFullFilename = strFullFilename;
-	m_strOutputFilename = strOutputFilename;
-	m_strOutputDirectory = strOutputDirectory;
-	m_uSplitSize = uSplitSize;
-
-	m_bStopSplitting = false;
-
-	InitializeCriticalSection(&m_csStop);
-}
-
-SplitFile::~SplitFile()
+	const std::wstring &strOutputFilename, const std::wstring &strOutputDirectory,
+	const FileSplitter::Options &options) :
+	m_hDlg(hDlg),
+	m_strOutputFilename(strOutputFilename),
+	m_strOutputDirectory(strOutputDirectory),
+	m_fileSplitter(
+		strFullFilename,
+		[this](ULONGLONG partNumber)
+		{
+			return ProcessFilename(partNumber);
+		},
+		options)
 {
-	DeleteCriticalSection(&m_csStop);
 }
 
 void SplitFile::Split()
 {
-	HANDLE hInputFile = CreateFile(m_strFullFilename.c_str(), GENERIC_READ, FILE_SHARE_READ,
-		nullptr, OPEN_EXISTING, 0, nullptr);
-
-	if (hInputFile == INVALID_HANDLE_VALUE)
-	{
-		PostMessage(m_hDlg, NSplitFileDialog::WM_APP_INPUTFILEINVALID, 0, 0);
-		return;
-	}
-
-	LARGE_INTEGER lFileSize;
-	GetFileSizeEx(hInputFile, &lFileSize);
-
-	LONGLONG nSplits = lFileSize.QuadPart / m_uSplitSize;
-
-	if ((lFileSize.QuadPart % m_uSplitSize) != 0)
-	{
-		nSplits++;
-	}
-
-	PostMessage(m_hDlg, NSplitFileDialog::WM_APP_SETTOTALSPLITCOUNT, static_cast<WPARAM>(nSplits),
-		0);
-
-	SplitInternal(hInputFile, lFileSize);
-
-	CloseHandle(hInputFile);
+	auto result = m_fileSplitter.Split(
+		[this](const FileSplitter::Progress &progress)
+		{
+			OnProgress(progress);
+		});
 
-	SendMessage(m_hDlg, NSplitFileDialog::WM_APP_SPLITFINISHED, 0, 0);
+	SendMessage(m_hDlg, NSplitFileDialog::WM_APP_SPLITFINISHED, static_cast<WPARAM>(result), 0);
 }
 
-void SplitFile::SplitInternal(HANDLE hInputFile, const LARGE_INTEGER &lFileSize)
+void SplitFile::OnProgress(const FileSplitter::Progress &progress)
 {
-	LARGE_INTEGER lRunningSplitSize = { 0 };
-
-	char *pBuffer = new char[m_uSplitSize];
-	bool bStop = false;
-	int nSplitsMade = 1;
+	int position = 0;
 
-	while (lRunningSplitSize.QuadPart < lFileSize.QuadPart && !bStop)
+	if (progress.totalBytes > 0)
 	{
-		DWORD dwNumberOfBytesRead;
-		ReadFile(hInputFile, reinterpret_cast<LPVOID>(pBuffer), m_uSplitSize, &dwNumberOfBytesRead,
-			nullptr);
-
-		std::wstring strOutputFullFilename;
-		ProcessFilename(nSplitsMade, strOutputFullFilename);
-
-		HANDLE hOutputFile = CreateFile(strOutputFullFilename.c_str(), GENERIC_WRITE, 0, nullptr,
-			CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
-
-		if (hOutputFile != INVALID_HANDLE_VALUE)
-		{
-			DWORD dwNumberOfBytesWritten;
-			WriteFile(hOutputFile, reinterpret_cast<LPCVOID>(pBuffer), dwNumberOfBytesRead,
-				&dwNumberOfBytesWritten, nullptr);
-
-			CloseHandle(hOutputFile);
-		}
-
-		/* TODO: Wait for a set period of time before sending message
-		(so as not to block the GUI). */
-		PostMessage(m_hDlg, NSplitFileDialog::WM_APP_SETCURRENTSPLITCOUNT, nSplitsMade, 0);
-
-		lRunningSplitSize.QuadPart += dwNumberOfBytesRead;
-		nSplitsMade++;
-
-		EnterCriticalSection(&m_csStop);
-		if (m_bStopSplitting)
-		{
-			bStop = true;
-		}
-		LeaveCriticalSection(&m_csStop);
+		position = static_cast<int>(
+			progress.bytesProcessed * NSplitFileDialog::PROGRESS_RANGE / progress.totalBytes);
 	}
 
-	delete[] pBuffer;
+	PostMessage(m_hDlg, NSplitFileDialog::WM_APP_SPLITPROGRESS, position,
+		static_cast<LPARAM>(progress.bytesPerSecond / 1024));
 }
 
-void SplitFile::ProcessFilename(int nSplitsMade, std::wstring &strOutputFullFilename)
+std::wstring SplitFile::ProcessFilename(ULONGLONG partNumber) const
 {
 	std::wstring strOutputFilename = m_strOutputFilename;
-
-	std::wstringstream ss;
-	ss << nSplitsMade;
 	strOutputFilename.replace(strOutputFilename.find(NSplitFileDialog::COUNTER_PATTERN), 2,
-		ss.str());
+		std::to_wstring(partNumber));
 
-	strOutputFullFilename = m_strOutputDirectory + _T("\\") + strOutputFilename;
+	return m_strOutputDirectory + _T("\\") + strOutputFilename;
 }
 
 void SplitFile::StopSplitting()
 {
-	EnterCriticalSection(&m_csStop);
-	m_bStopSplitting = true;
-	LeaveCriticalSection(&m_csStop);
+	m_fileSplitter.Cancel();
 }
 
 SplitFileDialogPersistentSettings::SplitFileDialogPersistentSettings() :
@@ -664,6 +654,7 @@ SplitFileDialogPersistentSettings::SplitFileDialogPersistentSettings() :
 {
 	m_strSplitSize = _T("10");
 	m_strSplitGroup = _T("KB");
+	m_createChecksumFile = false;
 }
 
 SplitFileDialogPersistentSettings &SplitFileDialogPersistentSettings::GetInstance()
@@ -676,12 +667,15 @@ void SplitFileDialogPersistentSettings::SaveExtraRegistrySettings(HKEY hKey)
 {
 	RegistrySettings::SaveString(hKey, SETTING_SIZE, m_strSplitSize);
 	RegistrySettings::SaveString(hKey, SETTING_SIZE_GROUP, m_strSplitGroup);
+	RegistrySettings::SaveDword(hKey, SETTING_CREATE_CHECKSUM_FILE, m_createChecksumFile);
 }
 
 void SplitFileDialogPersistentSettings::LoadExtraRegistrySettings(HKEY hKey)
 {
 	RegistrySettings::ReadString(hKey, SETTING_SIZE, m_strSplitSize);
 	RegistrySettings::ReadString(hKey, SETTING_SIZE_GROUP, m_strSplitGroup);
+	RegistrySettings::Read32BitValueFromRegistry(hKey, SETTING_CREATE_CHECKSUM_FILE,
+		m_createChecksumFile);
 }
 
 void SplitFileDialogPersistentSettings::SaveExtraXMLSettings(IXMLDOMDocument *pXMLDom,
@@ -690,6 +684,8 @@ void SplitFileDialogPersistentSettings::SaveExtraXMLSettings(IXMLDOMDocument *pX
 	NXMLSettings::AddAttributeToNode(pXMLDom, pParentNode, SETTING_SIZE, m_strSplitSize.c_str());
 	NXMLSettings::AddAttributeToNode(pXMLDom, pParentNode, SETTING_SIZE_GROUP,
 		m_strSplitGroup.c_str());
+	NXMLSettings::AddAttributeToNode(pXMLDom, pParentNode, SETTING_CREATE_CHECKSUM_FILE,
+		NXMLSettings::EncodeBoolValue(m_createChecksumFile));
 }
 
 void SplitFileDialogPersistentSettings::LoadExtraXMLSettings(BSTR bstrName, BSTR bstrValue)
@@ -702,4 +698,8 @@ void SplitFileDialogPersistentSettings::LoadExtraXMLSettings(BSTR bstrName, BSTR
 	{
 		m_strSplitGroup = _bstr_t(bstrValue);
 	}
+	else if (lstrcmpi(bstrName, SETTING_CREATE_CHECKSUM_FILE) == 0)
+	{
+		m_createChecksumFile = NXMLSettings::DecodeBoolValue(bstrValue);
+	}
 }
@@ -6,6 +6,7 @@
 
 #include "DarkModeDialogBase.h"
 #include "../Helper/DialogSettings.h"
+#include "../Helper/FileSplitter.h"
 #include "../Helper/ReferenceCount.h"
 #include <string>
 #include <unordered_map>
@@ -25,6 +26,7 @@ private:
 
 	static const TCHAR SETTING_SIZE[];
 	static const TCHAR SETTING_SIZE_GROUP[];
+	static const TCHAR SETTING_CREATE_CHECKSUM_FILE[];
 
 	SplitFileDialogPersistentSettings();
 
@@ -39,31 +41,28 @@ private:
 
 	std::wstring m_strSplitSize;
 	std::wstring m_strSplitGroup;
+	bool m_createChecksumFile;
 };
 
 class SplitFile : public ReferenceCount
 {
 public:
 	SplitFile(HWND hDlg, const std::wstring &strFullFilename, const std::wstring &strOutputFilename,
-		const std::wstring &strOutputDirectory, UINT uSplitSize);
-	~SplitFile();
+		const std::wstring &strOutputDirectory, const FileSplitter::Options &options);
 
 	void Split();
 	void StopSplitting();
 
 private:
-	void SplitInternal(HANDLE hInputFile, const LARGE_INTEGER &lFileSize);
-	void ProcessFilename(int nSplitsMade, std::wstring &strOutputFullFilename);
+	std::wstring ProcessFilename(ULONGLONG partNumber) const;
+	void OnProgress(const FileSplitter::Progress &progress);
 
 	HWND m_hDlg;
 
-	std::wstring m_strFullFilename;
 	std::wstring m_strOutputFilename;
 	std::wstring m_strOutputDirectory;
-	UINT m_uSplitSize;
 
-	CRITICAL_SECTION m_csStop;
-	bool m_bStopSplitting;
+	FileSplitter m_fileSplitter;
 };
 
 class SplitFileDialog : public DarkModeDialogBase
@@ -107,9 +106,9 @@ private:
 
 	static const COLORREF HELPER_TEXT_COLOR = RGB(120, 120, 120);
 
-	static const int KB = (1024);
-	static const int MB = (1024 * 1024);
-	static const int GB = (1024 * 1024 * 1024);
+	static const ULONGLONG KB = (1024);
+	static const ULONGLONG MB = (1024 * 1024);
+	static const ULONGLONG GB = (1024 * 1024 * 1024);
 
 	static const UINT_PTR ELPASED_TIMER_ID = 1;
 	static const UINT_PTR ELPASED_TIMER_TIMEOUT = 1000;
@@ -117,7 +116,8 @@ private:
 	void OnOk();
 	void OnCancel();
 	void OnChangeOutputDirectory();
-	void OnSplitFinished();
+	void OnSplitProgress(int position, ULONGLONG bytesPerSecond);
+	void OnSplitFinished(FileSplitter::Result result);
 
 	CoreInterface *m_coreInterface;
 
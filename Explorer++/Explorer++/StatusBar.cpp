@@ -10,10 +10,13 @@
 #include "ShellBrowser/ShellBrowser.h"
 #include "TabContainer.h"
 #include "../Helper/Controls.h"
+#include "../Helper/TraceRecorder.h"
 #include "../Helper/WindowHelper.h"
 
 void Explorerplusplus::CreateStatusBar()
 {
+	TRACE_FUNCTION();
+
 	UINT style = WS_CHILD | WS_CLIPSIBLINGS | SBARS_SIZEGRIP | WS_CLIPCHILDREN;
 
 	if (m_config->showStatusBar)
@@ -20,14 +20,15 @@
 #include "TabRestorer.h"
 #include "../Helper/CachedIcons.h"
 #include "../Helper/Controls.h"
+#include "../Helper/DirectoryWatchRegistry.h"
 #include "../Helper/DpiCompatibility.h"
 #include "../Helper/IconFetcher.h"
 #include "../Helper/ImageHelper.h"
 #include "../Helper/MenuHelper.h"
 #include "../Helper/ShellHelper.h"
 #include "../Helper/TabHelper.h"
+#include "../Helper/TraceRecorder.h"
 #include "../Helper/WindowHelper.h"
-#include "../Helper/iDirectoryMonitor.h"
 #include <boost/algorithm/string.hpp>
 #include <boost/range/adaptor/map.hpp>
 
@@ -530,14 +531,14 @@ void TabContainer::OnOpenParentInNewTab(const Tab &tab)
 
 void TabContainer::OnRefreshTab(Tab &tab)
 {
-	tab.GetShellBrowser()->GetNavigationController()->Refresh();
+	tab.GetShellBrowser()->RefreshChangedItems();
 }
 
 void TabContainer::OnRefreshAllTabs()
 {
 	for (auto &tab : GetAllTabs() | boost::adaptors::map_values)
 	{
-		tab->GetShellBrowser()->GetNavigationController()->Refresh();
+		tab->GetShellBrowser()->RefreshChangedItems();
 	}
 }
 
@@ -756,6 +757,34 @@ void TabContainer::OnTabSelected(const Tab &tab)
 	}
 
 	m_iPreviousTabSelectionId = tab.GetId();
+
+	// Tabs that were created in the background may not have been loaded yet.
+	if (tab.GetShellBrowser()->IsEnumerationDeferred())
+	{
+		HRESULT hr = tab.GetShellBrowser()->GetNavigationController()->Refresh();
+
+		// Only the folder's name is resolved when a tab is created in the background, so the
+		// folder may no longer exist, or may be unavailable (e.g. an offline network share). In
+		// that case, the tab falls back to the default folder, as it would have if it had been
+		// loaded straight away.
+		if (FAILED(hr))
+		{
+			BrowseDefaultFolder(tab, true);
+		}
+	}
+}
+
+void TabContainer::BrowseDefaultFolder(const Tab &tab, bool addHistoryEntry)
+{
+	HRESULT hr = tab.GetShellBrowser()->GetNavigationController()->BrowseFolder(
+		m_config->defaultTabDirectory, addHistoryEntry);
+
+	if (FAILED(hr))
+	{
+		// The computer folder should always exist, so this call shouldn't fail.
+		tab.GetShellBrowser()->GetNavigationController()->BrowseFolder(
+			m_config->defaultTabDirectoryStatic, addHistoryEntry);
+	}
 }
 
 void TabContainer::OnAlwaysShowTabBarUpdated(BOOL newValue)
@@ -957,6 +986,8 @@ Tab &TabContainer::CreateNewTab(const PreservedTab &preservedTab)
 Tab &TabContainer::CreateNewTab(PCIDLIST_ABSOLUTE pidlDirectory, const TabSettings &tabSettings,
 	const FolderSettings *folderSettings, const FolderColumns *initialColumns)
 {
+	TRACE_FUNCTION();
+
 	auto tabTemp = std::make_unique<Tab>(m_coreInterface, m_tabNavigation, m_fileActionHandler,
 		folderSettings, initialColumns);
 	auto item = m_tabs.insert({ tabTemp->GetId(), std::move(tabTemp) });
@@ -1068,20 +1099,17 @@ Tab &TabContainer::SetUpNewTab(Tab &tab, PCIDLIST_ABSOLUTE pidlDirectory,
 			tabColumnsChangedSignal.m_signal(tab);
 		});
 
+	if (!selected && tabSettings.deferEnumeration.value_or(false))
+	{
+		tab.GetShellBrowser()->DeferNextEnumeration();
+	}
+
 	HRESULT hr = tab.GetShellBrowser()->GetNavigationController()->BrowseFolder(pidlDirectory,
 		addHistoryEntry);
 
 	if (FAILED(hr))
 	{
-		hr = tab.GetShellBrowser()->GetNavigationController()->BrowseFolder(
-			m_config->defaultTabDirectory, addHistoryEntry);
-
-		if (FAILED(hr))
-		{
-			// The computer folder should always exist, so this call shouldn't fail.
-			tab.GetShellBrowser()->GetNavigationController()->BrowseFolder(
-				m_config->defaultTabDirectoryStatic, addHistoryEntry);
-		}
+		BrowseDefaultFolder(tab, addHistoryEntry);
 	}
 
 	if (selected)
@@ -1160,7 +1188,7 @@ bool TabContainer::CloseTab(const Tab &tab)
 
 	if (dirMonitorId)
 	{
-		m_coreInterface->GetDirectoryMonitor()->StopDirectoryMonitor(*dirMonitorId);
+		m_coreInterface->GetDirectoryWatchRegistry()->Unsubscribe(*dirMonitorId);
 	}
 
 	// This is needed, as the erase() call below will remove the element
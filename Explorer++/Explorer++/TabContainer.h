@@ -29,6 +29,7 @@ BOOST_PARAMETER_NAME(name)
 BOOST_PARAMETER_NAME(index)
 BOOST_PARAMETER_NAME(selected)
 BOOST_PARAMETER_NAME(lockState)
+BOOST_PARAMETER_NAME(deferEnumeration)
 
 // The use of Boost Parameter here allows values to be set by name
 // during construction. It would be better (and simpler) for this to be
@@ -43,12 +44,17 @@ struct TabSettingsImpl
 		lockState = args[_lockState | std::nullopt];
 		index = args[_index | std::nullopt];
 		selected = args[_selected | std::nullopt];
+		deferEnumeration = args[_deferEnumeration | std::nullopt];
 	}
 
 	std::optional<std::wstring> name;
 	std::optional<Tab::LockState> lockState;
 	std::optional<int> index;
 	std::optional<bool> selected;
+
+	// If set, the folder won't be enumerated until the tab is first selected. Only has an effect
+	// if the tab isn't selected when it's created.
+	std::optional<bool> deferEnumeration;
 };
 
 // Used when creating a tab.
@@ -64,6 +70,7 @@ struct TabSettings : TabSettingsImpl
 			(lockState, (Tab::LockState))
 			(index, (int))
 			(selected, (bool))
+			(deferEnumeration, (bool))
 		)
 	)
 	// clang-format on
@@ -198,6 +205,7 @@ private:
 	void OnTabRemoved(int tabId);
 
 	void OnTabSelected(const Tab &tab);
+	void BrowseDefaultFolder(const Tab &tab, bool addHistoryEntry);
 
 	void OnAlwaysShowTabBarUpdated(BOOL newValue);
 	void OnForceSameTabWidthUpdated(BOOL newValue);
@@ -9,15 +9,19 @@
 #include "MenuRanges.h"
 #include "ShellBrowser/ShellBrowser.h"
 #include "TabContainer.h"
+#include "TabHibernator.h"
 #include "TabRestorerUI.h"
 #include "../Helper/DpiCompatibility.h"
 #include "../Helper/Macros.h"
+#include "../Helper/TraceRecorder.h"
 #include <list>
 
 static const UINT TAB_WINDOW_HEIGHT_96DPI = 24;
 
 void Explorerplusplus::InitializeTabs()
 {
+	TRACE_FUNCTION();
+
 	/* The tab backing will hold the tab window. */
 	CreateTabBacking();
 
@@ -38,6 +42,13 @@ void Explorerplusplus::InitializeTabs()
 		boost::signals2::at_front);
 	m_tabContainer->tabSelectedSignal.AddObserver(
 		std::bind_front(&Explorerplusplus::OnTabSelected, this), boost::signals2::at_front);
+	m_tabContainer->tabRemovedSignal.AddObserver(
+		[this](int tabId)
+		{
+			UNREFERENCED_PARAMETER(tabId);
+
+			SaveAllSettings();
+		});
 
 	m_tabContainer->tabDirectoryModifiedSignal.AddObserver(
 		std::bind_front(&Explorerplusplus::OnDirectoryModified, this), boost::signals2::at_front);
@@ -64,6 +75,8 @@ void Explorerplusplus::InitializeTabs()
 	m_tabRestorerUI = std::make_unique<TabRestorerUI>(m_resourceModule, this, m_tabRestorer.get(),
 		MENU_RECENT_TABS_STARTID, MENU_RECENT_TABS_ENDID);
 
+	m_tabHibernator = std::make_unique<TabHibernator>(this, m_tabContainer);
+
 	m_tabsInitializedSignal();
 }
 
@@ -100,12 +113,24 @@ void Explorerplusplus::OnNavigationCommitted(const Tab &tab, PCIDLIST_ABSOLUTE p
 
 	StopDirectoryMonitoringForTab(tab);
 
-	if (m_config->shellChangeNotificationType == ShellChangeNotificationType::Disabled
-		|| (m_config->shellChangeNotificationType == ShellChangeNotificationType::NonFilesystem
-			&& !tab.GetShellBrowser()->InVirtualFolder()))
+	// There's no need to monitor a folder that hasn't been loaded yet. Monitoring will start once
+	// the tab is selected and the folder is enumerated.
+	if (!tab.GetShellBrowser()->IsEnumerationDeferred()
+		&& (m_config->shellChangeNotificationType == ShellChangeNotificationType::Disabled
+			|| (m_config->shellChangeNotificationType
+					== ShellChangeNotificationType::NonFilesystem
+				&& !tab.GetShellBrowser()->InVirtualFolder())))
 	{
 		StartDirectoryMonitoringForTab(tab);
 	}
+
+	// Saving the set of tabs as they change means they can be restored, even if the application
+	// doesn't exit normally. SaveAllSettings() only restarts the save timer, so a series of
+	// navigations results in a single save.
+	if (m_InitializationFinished.get())
+	{
+		SaveAllSettings();
+	}
 }
 
 /* Creates a new tab. If a folder is selected, that folder is opened in a new
@@ -138,6 +163,8 @@ void Explorerplusplus::OnNewTab()
 
 HRESULT Explorerplusplus::RestoreTabs(ILoadSave *pLoadSave)
 {
+	TRACE_FUNCTION();
+
 	// It's implicitly assumed that this will succeed. Although the documentation states that
 	// GetCurrentDirectory() can fail, I'm not sure under what circumstances it ever would.
 	// Also note that it's important that this is called before creating any tabs, as
@@ -151,10 +178,16 @@ HRESULT Explorerplusplus::RestoreTabs(ILoadSave *pLoadSave)
 		// It's possible that the above call might not have loaded any tabs (e.g. because there are
 		// no saved settings). So, it's important that tab selection is only set when the last
 		// selected tab value is in the appropriate range.
+		// Background tabs are only loaded once they're selected, so a tab always needs to be
+		// explicitly selected here, even if the last selected tab value is invalid.
 		if (m_iLastSelectedTab >= 0 && m_iLastSelectedTab < m_tabContainer->GetNumTabs())
 		{
 			m_tabContainer->SelectTabAtIndex(m_iLastSelectedTab);
 		}
+		else if (m_tabContainer->GetNumTabs() > 0)
+		{
+			m_tabContainer->SelectTabAtIndex(0);
+		}
 	}
 
 	for (const auto &fileToSelect : m_commandLineSettings.filesToSelect)
@@ -0,0 +1,138 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "TabHibernator.h"
+#include "Config.h"
+#include "CoreInterface.h"
+#include "ShellBrowser/ShellBrowser.h"
+#include "Tab.h"
+#include "TabContainer.h"
+#include "../Helper/DirectoryWatchRegistry.h"
+#include "../Helper/Logging.h"
+#include <boost/range/adaptor/map.hpp>
+#include <algorithm>
+
+TabHibernator::TabHibernator(CoreInterface *coreInterface, TabContainer *tabContainer) :
+	m_coreInterface(coreInterface),
+	m_tabContainer(tabContainer)
+{
+	m_connections.push_back(m_tabContainer->tabCreatedSignal.AddObserver(
+		std::bind_front(&TabHibernator::OnTabCreated, this)));
+	m_connections.push_back(m_tabContainer->tabSelectedSignal.AddObserver(
+		std::bind_front(&TabHibernator::OnTabSelected, this)));
+	m_connections.push_back(m_tabContainer->tabRemovedSignal.AddObserver(
+		std::bind_front(&TabHibernator::OnTabRemoved, this)));
+}
+
+void TabHibernator::OnTabCreated(int tabId, BOOL switchToNewTab)
+{
+	UNREFERENCED_PARAMETER(switchToNewTab);
+
+	m_lastActiveTimes[tabId] = Clock::now();
+}
+
+void TabHibernator::OnTabSelected(const Tab &tab)
+{
+	auto now = Clock::now();
+
+	// The previously selected tab is only moved into the background at this point, so that's the
+	// time it was last active.
+	if (m_selectedTabId)
+	{
+		m_lastActiveTimes[*m_selectedTabId] = now;
+	}
+
+	m_lastActiveTimes[tab.GetId()] = now;
+	m_selectedTabId = tab.GetId();
+}
+
+void TabHibernator::OnTabRemoved(int tabId)
+{
+	m_lastActiveTimes.erase(tabId);
+
+	if (m_selectedTabId == tabId)
+	{
+		m_selectedTabId.reset();
+	}
+}
+
+void TabHibernator::HibernateIdleTabs()
+{
+	const Config *config = m_coreInterface->GetConfig();
+
+	if (config->hibernateTabsAfterMinutes == 0 && config->maxLoadedTabs == 0)
+	{
+		return;
+	}
+
+	auto now = Clock::now();
+	size_t numLoadedTabs = 0;
+	std::vector<std::pair<Clock::time_point, const Tab *>> backgroundTabs;
+
+	for (const auto &tab : m_tabContainer->GetAllTabs() | boost::adaptors::map_values)
+	{
+		if (tab->GetShellBrowser()->IsEnumerationDeferred())
+		{
+			continue;
+		}
+
+		numLoadedTabs++;
+
+		if (m_tabContainer->IsTabSelected(*tab))
+		{
+			continue;
+		}
+
+		auto itr = m_lastActiveTimes.find(tab->GetId());
+		backgroundTabs.emplace_back(itr != m_lastActiveTimes.end() ? itr->second : now,
+			tab.get());
+	}
+
+	// Least recently used tabs first.
+	std::sort(backgroundTabs.begin(), backgroundTabs.end(),
+		[](const auto &first, const auto &second)
+		{
+			return first.first < second.first;
+		});
+
+	auto maxIdleTime = std::chrono::minutes(config->hibernateTabsAfterMinutes);
+	int numHibernatedTabs = 0;
+
+	for (const auto &[lastActiveTime, tab] : backgroundTabs)
+	{
+		bool idle = config->hibernateTabsAfterMinutes != 0 && (now - lastActiveTime) >= maxIdleTime;
+		bool overLimit = config->maxLoadedTabs != 0 && numLoadedTabs > config->maxLoadedTabs;
+
+		// The tabs are ordered by last use, so if this tab doesn't need to be hibernated, neither
+		// do any of the tabs that follow it.
+		if (!idle && !overLimit)
+		{
+			break;
+		}
+
+		HibernateTab(*tab);
+
+		numLoadedTabs--;
+		numHibernatedTabs++;
+	}
+
+	if (numHibernatedTabs > 0)
+	{
+		LOG(debug) << L"Hibernated " << numHibernatedTabs << L" idle tabs";
+	}
+}
+
+void TabHibernator::HibernateTab(const Tab &tab)
+{
+	auto dirMonitorId = tab.GetShellBrowser()->GetDirMonitorId();
+
+	if (dirMonitorId)
+	{
+		m_coreInterface->GetDirectoryWatchRegistry()->Unsubscribe(*dirMonitorId);
+		tab.GetShellBrowser()->ClearDirMonitorId();
+	}
+
+	tab.GetShellBrowser()->Hibernate();
+}
@@ -0,0 +1,50 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "../Helper/Macros.h"
+#include <boost/signals2.hpp>
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+class CoreInterface;
+class Tab;
+class TabContainer;
+
+// Hibernates background tabs that haven't been used recently, releasing the items that have been
+// loaded for them. A hibernated tab is reloaded when it's next selected.
+//
+// A tab will be hibernated once it has been in the background for longer than the configured
+// period. Additionally, if more than the configured number of tabs are loaded, the least recently
+// used tabs will be hibernated.
+class TabHibernator
+{
+public:
+	TabHibernator(CoreInterface *coreInterface, TabContainer *tabContainer);
+
+	// This is expected to be called periodically.
+	void HibernateIdleTabs();
+
+private:
+	DISALLOW_COPY_AND_ASSIGN(TabHibernator);
+
+	using Clock = std::chrono::steady_clock;
+
+	void OnTabCreated(int tabId, BOOL switchToNewTab);
+	void OnTabSelected(const Tab &tab);
+	void OnTabRemoved(int tabId);
+
+	void HibernateTab(const Tab &tab);
+
+	CoreInterface *m_coreInterface;
+	TabContainer *m_tabContainer;
+	std::vector<boost::signals2::scoped_connection> m_connections;
+
+	// The last time each tab was in the foreground.
+	std::unordered_map<int, Clock::time_point> m_lastActiveTimes;
+	std::optional<int> m_selectedTabId;
+};
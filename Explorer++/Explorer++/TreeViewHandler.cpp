@@ -21,6 +21,7 @@
 #include "../Helper/Helper.h"
 #include "../Helper/Macros.h"
 #include "../Helper/ShellHelper.h"
+#include "../Helper/TraceRecorder.h"
 
 #define TREEVIEW_FOLDER_OPEN_DELAY 500
 #define FOLDERS_TOOLBAR_CLOSE 6000
@@ -36,6 +37,8 @@ HTREEITEM g_newSelectionItem;
 
 void Explorerplusplus::CreateFolderControls()
 {
+	TRACE_FUNCTION();
+
 	TCHAR szTemp[32];
 	UINT uStyle = WS_CHILD | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
 
@@ -48,8 +51,8 @@ void Explorerplusplus::CreateFolderControls()
 	m_hHolder = CreateHolderWindow(m_hContainer, szTemp, uStyle);
 	SetWindowSubclass(m_hHolder, TreeViewHolderProcStub, 0, (DWORD_PTR) this);
 
-	m_shellTreeView = new ShellTreeView(m_hHolder, this, m_pDirMon, m_tabContainer,
-		&m_FileActionHandler, &m_cachedIcons);
+	m_shellTreeView = new ShellTreeView(m_hHolder, this, m_directoryWatchRegistry.get(),
+		m_tabContainer, &m_FileActionHandler, &m_cachedIcons);
 
 	/* Now, subclass the treeview again. This is needed for messages
 	such as WM_MOUSEWHEEL, which need to be intercepted before they
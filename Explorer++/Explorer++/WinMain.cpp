@@ -20,6 +20,7 @@
 #include "../Helper/Logging.h"
 #include "../Helper/Macros.h"
 #include "../Helper/ProcessHelper.h"
+#include "../Helper/TraceRecorder.h"
 #include "../Helper/WindowHelper.h"
 #include <boost/locale.hpp>
 #include <boost/scope_exit.hpp>
@@ -46,6 +47,8 @@ HWND g_hwndSearch;
 HWND g_hwndRunScript;
 HWND g_hwndOptions;
 HWND g_hwndManageBookmarks;
+HWND g_hwndDuplicateFiles;
+HWND g_hwndCompareFolders;
 
 HACCEL g_hAccl;
 
@@ -377,6 +380,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 	g_hwndRunScript = nullptr;
 	g_hwndOptions = nullptr;
 	g_hwndManageBookmarks = nullptr;
+	g_hwndDuplicateFiles = nullptr;
+	g_hwndCompareFolders = nullptr;
 
 	MSG msg;
 
@@ -388,6 +393,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 		would be taken even when the dialog has focus. */
 		if (!IsDialogMessage(g_hwndSearch, &msg) && !IsDialogMessage(g_hwndManageBookmarks, &msg)
 			&& !IsDialogMessage(g_hwndRunScript, &msg)
+			&& !IsDialogMessage(g_hwndDuplicateFiles, &msg)
+			&& !IsDialogMessage(g_hwndCompareFolders, &msg)
 			&& !PropSheet_IsDialogMessage(g_hwndOptions, &msg))
 		{
 			if (!TranslateAccelerator(hwnd, g_hAccl, &msg))
@@ -404,6 +411,16 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 		}
 	}
 
+	if (!commandLineSettings.traceFile.empty())
+	{
+		bool res = TraceRecorder::GetInstance().WriteChromeTrace(commandLineSettings.traceFile);
+
+		if (!res)
+		{
+			LOG(warning) << L"Failed to write trace file: " << commandLineSettings.traceFile;
+		}
+	}
+
 	return (int) msg.wParam;
 }
 
@@ -25,9 +25,13 @@
 #include "ShellBrowser/Columns.h"
 #include "ShellBrowser/ShellBrowser.h"
 #include "TabContainer.h"
+#include "XMLSettings.h"
 #include "../Helper/Macros.h"
+#include "../Helper/MappedXmlFile.h"
+#include "../Helper/PerfectHashMap.h"
 #include "../Helper/ProcessHelper.h"
 #include "../Helper/XMLSettings.h"
+#include "../Helper/XmlPullParser.h"
 #include <wil/com.h>
 #include <wil/resource.h>
 
@@ -39,271 +43,590 @@
 #define COLUMN_TYPE_NETWORK 5
 #define COLUMN_TYPE_NETWORKPLACES 6
 
-/* These represent the pre-hashed values of attribute
-names. They are used to avoid string comparisons
-on each attribute. If the hash function or any of
-the attribute names change in any way, these values
-will need to be changed correspondingly. */
-#define HASH_ALWAYSOPENINNEWTAB 1123321600
-#define HASH_AUTOARRANGEGLOBAL 151507311
-#define HASH_CONFIRMCLOSETABS 2636757395
-#define HASH_DISPLAYCENTRECOLOR 3404143227
-#define HASH_DISPLAYFONT 362757714
-#define HASH_DISPLAYSURROUNDCOLOR 1807564604
-#define HASH_DISPLAYTEXTCOLOR 4212809823
-#define HASH_DISPLAYWINDOWWIDTH 3332824435
-#define HASH_DISPLAYWINDOWHEIGHT 2017415020
-#define HASH_DISPLAYWINDOWVERTICAL 2262072301
-#define HASH_LANGUAGE 3526403497
-#define HASH_LASTSELECTEDTAB 1712438393
-#define HASH_NEXTTOCURRENT 743165450
-#define HASH_SHOWADDRESSBAR 3302864385
-#define HASH_SHOWBOOKMARKSTOOLBAR 1216493954
-#define HASH_SHOWDRIVESTOOLBAR 899091590
-#define HASH_SHOWDISPLAYWINDOW 351410676
-#define HASH_SHOWEXTENSIONS 3743594966
-#define HASH_SHOWFOLDERS 948345109
-#define HASH_SHOWFOLDERSIZES 3684676528
-#define HASH_SHOWFRIENDLYDATES 467626964
-#define HASH_SHOWFULLTITLEPATH 1871292168
-#define HASH_SHOWGRIDLINESGLOBAL 1707929656
-#define HASH_SHOWHIDDENGLOBAL 558199811
-#define HASH_SHOWSTATUSBAR 3554629247
-#define HASH_SHOWINFOTIPS 3018038962
-#define HASH_SHOWTOOLBAR 1852868921
-#define HASH_SORTASCENDINGGLOBAL 2605638058
-#define HASH_STARTUPMODE 1344265373
-#define HASH_TOOLBARSTATE 3436473849
-#define HASH_TREEVIEWDELAYENABLED 2186637066
-#define HASH_TREEVIEWWIDTH 4257779536
-#define HASH_VIEWMODEGLOBAL 3743629718
-#define HASH_POSITION 3300187802
-#define HASH_LOCKTOOLBARS 3842965076
-#define HASH_NEWTABDIRECTORY 3570078203
-#define HASH_INFOTIPTYPE 3366492864
-#define HASH_SHOWAPPLICATIONTOOLBAR 101571053
-#define HASH_USEFULLROWSELECT 3780943197
-#define HASH_SHOWINGROUPSGLOBAL 4239388334
-#define HASH_EXTENDTABCONTROL 4097866437
-#define HASH_SHOWFILEPREVIEWS 1834921243
-#define HASH_REPLACEEXPLORERMODE 2422294263
-#define HASH_SHOWUSERNAMETITLEBAR 2618183549
-#define HASH_HIDESYSTEMFILESGLOBAL 1667356744
-#define HASH_HIDELINKEXTENSIONGLOBAL 1073100667
-#define HASH_ALLOWMULTIPLEINSTANCES 3463984536
-#define HASH_ONECLICKACTIVATE 1118178238
-#define HASH_ONECLICKACTIVATEHOVERTIME 3023373873
-#define HASH_FORCESAMETABWIDTH 2315576081
-#define HASH_DOUBLECLICKTABCLOSE 1866215987
-#define HASH_HANDLEZIPFILES 1074212343
-#define HASH_INSERTSORTED 1109371947
-#define HASH_SHOWPRIVILEGETITLEBAR 4071561587
-#define HASH_DISABLEFOLDERSIZENETWORKREMOVABLE 2610679594
-#define HASH_ALWAYSSHOWTABBAR 148004675
-#define HASH_CHECKBOXSELECTION 456677010
-#define HASH_FORCESIZE 1918861263
-#define HASH_SIZEDISPLAYFOMRAT 3548127263
-#define HASH_CLOSEMAINWINDOWONTABCLOSE 1151827266
-#define HASH_SHOWTABBARATBOTTOM 4099029340
-#define HASH_SHOWTASKBARTHUMBNAILS 2202555045
-#define HASH_SYNCHRONIZETREEVIEW 1687787660
-#define HASH_TVAUTOEXPAND 1228854897
-#define HASH_OVERWRITEEXISTINGFILESCONFIRMATION 1625342835
-#define HASH_LARGETOOLBARICONS 10895007
-#define HASH_ICON_THEME 3998265761
-#define HASH_CHECK_PINNED_TO_NAMESPACE_TREE_PROPERTY 145831142
-#define HASH_ENABLE_DARK_MODE 1623404723
-#define HASH_DISPLAY_MIXED_FILES_AND_FOLDERS 1168704423
-#define HASH_USE_NATURAL_SORT_ORDER 528323501
-#define HASH_OPEN_TABS_IN_FOREGROUND 2957281235
-
-struct ColumnXMLSaveData
+namespace
 {
-	TCHAR szName[64];
-	ColumnType type;
+
+enum class GenericSetting
+{
+	AllowMultipleInstances,
+	AlwaysOpenInNewTab,
+	AlwaysShowTabBar,
+	AutoArrangeGlobal,
+	CheckBoxSelection,
+	CheckPinnedToNamespaceTreeProperty,
+	CloseMainWindowOnTabClose,
+	ConfirmCloseTabs,
+	DisableFolderSizesNetworkRemovable,
+	DisplayCentreColor,
+	DisplayFont,
+	DisplayMixedFilesAndFolders,
+	DisplaySurroundColor,
+	DisplayTextColor,
+	DisplayWindowHeight,
+	DisplayWindowVertical,
+	DisplayWindowWidth,
+	DoubleClickTabClose,
+	EnableDarkMode,
+	ExtendTabControl,
+	ForceSameTabWidth,
+	ForceSize,
+	HandleZipFiles,
+	HibernateTabsAfterMinutes,
+	HideLinkExtensionGlobal,
+	HideSystemFilesGlobal,
+	IconTheme,
+	InfoTipType,
+	InsertSorted,
+	Language,
+	LargeToolbarIcons,
+	LastSelectedTab,
+	LockToolbars,
+	MaxLoadedTabs,
+	NewTabDirectory,
+	NextToCurrent,
+	OneClickActivate,
+	OneClickActivateHoverTime,
+	OpenTabsInForeground,
+	OverwriteExistingFilesConfirmation,
+	Position,
+	ReplaceExplorerMode,
+	ShowAddressBar,
+	ShowApplicationToolbar,
+	ShowBookmarksToolbar,
+	ShowDisplayWindow,
+	ShowDrivesToolbar,
+	ShowExtensions,
+	ShowFilePreviews,
+	ShowFolders,
+	ShowFolderSizes,
+	ShowFriendlyDates,
+	ShowFullTitlePath,
+	ShowGridlinesGlobal,
+	ShowHiddenGlobal,
+	ShowInfoTips,
+	ShowInGroupsGlobal,
+	ShowPrivilegeLevelInTitleBar,
+	ShowStatusBar,
+	ShowTabBarAtBottom,
+	ShowTaskbarThumbnails,
+	ShowToolbar,
+	ShowUserNameTitleBar,
+	SizeDisplayFormat,
+	SortAscendingGlobal,
+	StartupMode,
+	SynchronizeTreeview,
+	ToolbarState,
+	TreeViewDelayEnabled,
+	TreeViewWidth,
+	TVAutoExpandSelected,
+	UseBuiltInFileTransfer,
+	UseFullRowSelect,
+	UseNaturalSortOrder,
+	ViewModeGlobal
+};
+
+// Maps the name of each setting (as it appears in the config file) to the setting itself. The
+// lookup table is built at compile time, so matching a setting name requires hashing it once and
+// performing a single string comparison.
+// clang-format off
+constexpr auto GENERIC_SETTING_NAMES = MakePerfectHashMap<GenericSetting>({
+	{ "AllowMultipleInstances", GenericSetting::AllowMultipleInstances },
+	{ "AlwaysOpenInNewTab", GenericSetting::AlwaysOpenInNewTab },
+	{ "AlwaysShowTabBar", GenericSetting::AlwaysShowTabBar },
+	{ "AutoArrangeGlobal", GenericSetting::AutoArrangeGlobal },
+	{ "CheckBoxSelection", GenericSetting::CheckBoxSelection },
+	{ "CheckPinnedToNamespaceTreeProperty", GenericSetting::CheckPinnedToNamespaceTreeProperty },
+	{ "CloseMainWindowOnTabClose", GenericSetting::CloseMainWindowOnTabClose },
+	{ "ConfirmCloseTabs", GenericSetting::ConfirmCloseTabs },
+	{ "DisableFolderSizesNetworkRemovable", GenericSetting::DisableFolderSizesNetworkRemovable },
+	{ "DisplayCentreColor", GenericSetting::DisplayCentreColor },
+	{ "DisplayFont", GenericSetting::DisplayFont },
+	{ "DisplayMixedFilesAndFolders", GenericSetting::DisplayMixedFilesAndFolders },
+	{ "DisplaySurroundColor", GenericSetting::DisplaySurroundColor },
+	{ "DisplayTextColor", GenericSetting::DisplayTextColor },
+	{ "DisplayWindowHeight", GenericSetting::DisplayWindowHeight },
+	{ "DisplayWindowVertical", GenericSetting::DisplayWindowVertical },
+	{ "DisplayWindowWidth", GenericSetting::DisplayWindowWidth },
+	{ "DoubleClickTabClose", GenericSetting::DoubleClickTabClose },
+	{ "EnableDarkMode", GenericSetting::EnableDarkMode },
+	{ "ExtendTabControl", GenericSetting::ExtendTabControl },
+	{ "ForceSameTabWidth", GenericSetting::ForceSameTabWidth },
+	{ "ForceSize", GenericSetting::ForceSize },
+	{ "HandleZipFiles", GenericSetting::HandleZipFiles },
+	{ "HibernateTabsAfterMinutes", GenericSetting::HibernateTabsAfterMinutes },
+	{ "HideLinkExtensionGlobal", GenericSetting::HideLinkExtensionGlobal },
+	{ "HideSystemFilesGlobal", GenericSetting::HideSystemFilesGlobal },
+	{ "IconTheme", GenericSetting::IconTheme },
+	{ "InfoTipType", GenericSetting::InfoTipType },
+	{ "InsertSorted", GenericSetting::InsertSorted },
+	{ "Language", GenericSetting::Language },
+	{ "LargeToolbarIcons", GenericSetting::LargeToolbarIcons },
+	{ "LastSelectedTab", GenericSetting::LastSelectedTab },
+	{ "LockToolbars", GenericSetting::LockToolbars },
+	{ "MaxLoadedTabs", GenericSetting::MaxLoadedTabs },
+	{ "NewTabDirectory", GenericSetting::NewTabDirectory },
+	{ "NextToCurrent", GenericSetting::NextToCurrent },
+	{ "OneClickActivate", GenericSetting::OneClickActivate },
+	{ "OneClickActivateHoverTime", GenericSetting::OneClickActivateHoverTime },
+	{ "OpenTabsInForeground", GenericSetting::OpenTabsInForeground },
+	{ "OverwriteExistingFilesConfirmation", GenericSetting::OverwriteExistingFilesConfirmation },
+	{ "Position", GenericSetting::Position },
+	{ "ReplaceExplorerMode", GenericSetting::ReplaceExplorerMode },
+	{ "ShowAddressBar", GenericSetting::ShowAddressBar },
+	{ "ShowApplicationToolbar", GenericSetting::ShowApplicationToolbar },
+	{ "ShowBookmarksToolbar", GenericSetting::ShowBookmarksToolbar },
+	{ "ShowDisplayWindow", GenericSetting::ShowDisplayWindow },
+	{ "ShowDrivesToolbar", GenericSetting::ShowDrivesToolbar },
+	{ "ShowExtensions", GenericSetting::ShowExtensions },
+	{ "ShowFilePreviews", GenericSetting::ShowFilePreviews },
+	{ "ShowFolders", GenericSetting::ShowFolders },
+	{ "ShowFolderSizes", GenericSetting::ShowFolderSizes },
+	{ "ShowFriendlyDates", GenericSetting::ShowFriendlyDates },
+	{ "ShowFullTitlePath", GenericSetting::ShowFullTitlePath },
+	{ "ShowGridlinesGlobal", GenericSetting::ShowGridlinesGlobal },
+	{ "ShowHiddenGlobal", GenericSetting::ShowHiddenGlobal },
+	{ "ShowInfoTips", GenericSetting::ShowInfoTips },
+	{ "ShowInGroupsGlobal", GenericSetting::ShowInGroupsGlobal },
+	{ "ShowPrivilegeLevelInTitleBar", GenericSetting::ShowPrivilegeLevelInTitleBar },
+	{ "ShowStatusBar", GenericSetting::ShowStatusBar },
+	{ "ShowTabBarAtBottom", GenericSetting::ShowTabBarAtBottom },
+	{ "ShowTaskbarThumbnails", GenericSetting::ShowTaskbarThumbnails },
+	{ "ShowToolbar", GenericSetting::ShowToolbar },
+	{ "ShowUserNameTitleBar", GenericSetting::ShowUserNameTitleBar },
+	{ "SizeDisplayFormat", GenericSetting::SizeDisplayFormat },
+	{ "SortAscendingGlobal", GenericSetting::SortAscendingGlobal },
+	{ "StartupMode", GenericSetting::StartupMode },
+	{ "SynchronizeTreeview", GenericSetting::SynchronizeTreeview },
+	{ "ToolbarState", GenericSetting::ToolbarState },
+	{ "TreeViewDelayEnabled", GenericSetting::TreeViewDelayEnabled },
+	{ "TreeViewWidth", GenericSetting::TreeViewWidth },
+	{ "TVAutoExpandSelected", GenericSetting::TVAutoExpandSelected },
+	{ "UseBuiltInFileTransfer", GenericSetting::UseBuiltInFileTransfer },
+	{ "UseFullRowSelect", GenericSetting::UseFullRowSelect },
+	{ "UseNaturalSortOrder", GenericSetting::UseNaturalSortOrder },
+	{ "ViewModeGlobal", GenericSetting::ViewModeGlobal }
+});
+// clang-format on
+
+enum class TabAttribute
+{
+	Directory,
+	ApplyFilter,
+	AutoArrange,
+	Filter,
+	FilterCaseSensitive,
+	ShowHidden,
+	ShowInGroups,
+	SortAscending,
+	SortMode,
+	ViewMode,
+	Locked,
+	AddressLocked,
+	CustomName
 };
 
+// clang-format off
+constexpr auto TAB_ATTRIBUTE_NAMES = MakePerfectHashMap<TabAttribute>({
+	{ "Directory", TabAttribute::Directory },
+	{ "ApplyFilter", TabAttribute::ApplyFilter },
+	{ "AutoArrange", TabAttribute::AutoArrange },
+	{ "Filter", TabAttribute::Filter },
+	{ "FilterCaseSensitive", TabAttribute::FilterCaseSensitive },
+	{ "ShowHidden", TabAttribute::ShowHidden },
+	{ "ShowInGroups", TabAttribute::ShowInGroups },
+	{ "SortAscending", TabAttribute::SortAscending },
+	{ "SortMode", TabAttribute::SortMode },
+	{ "ViewMode", TabAttribute::ViewMode },
+	{ "Locked", TabAttribute::Locked },
+	{ "AddressLocked", TabAttribute::AddressLocked },
+	{ "CustomName", TabAttribute::CustomName }
+});
+// clang-format on
+
+// clang-format off
+constexpr auto COLUMN_SET_NAMES = MakePerfectHashMap<int>({
+	{ "Generic", COLUMN_TYPE_GENERIC },
+	{ "MyComputer", COLUMN_TYPE_MYCOMPUTER },
+	{ "ControlPanel", COLUMN_TYPE_CONTROLPANEL },
+	{ "RecycleBin", COLUMN_TYPE_RECYCLEBIN },
+	{ "Printers", COLUMN_TYPE_PRINTERS },
+	{ "Network", COLUMN_TYPE_NETWORK },
+	{ "NetworkPlaces", COLUMN_TYPE_NETWORKPLACES }
+});
+// clang-format on
+
 /* Maps column save names to id's. */
 // clang-format off
-static ColumnXMLSaveData ColumnData[] = {
-	{ _T("Name"), ColumnType::Name },
-	{ _T("Type"), ColumnType::Type },
-	{ _T("Size"), ColumnType::Size },
-	{ _T("DateModified"), ColumnType::DateModified },
-	{ _T("Attributes"), ColumnType::Attributes },
-	{ _T("SizeOnDisk"), ColumnType::RealSize },
-	{ _T("ShortName"), ColumnType::ShortName },
-	{ _T("Owner"), ColumnType::Owner },
-	{ _T("ProductName"), ColumnType::ProductName },
-	{ _T("Company"), ColumnType::Company },
-	{ _T("Description"), ColumnType::Description },
-	{ _T("FileVersion"), ColumnType::FileVersion },
-	{ _T("ProductVersion"), ColumnType::ProductVersion },
-	{ _T("ShortcutTo"), ColumnType::ShortcutTo },
-	{ _T("HardLinks"), ColumnType::HardLinks },
-	{ _T("Extension"), ColumnType::Extension },
-	{ _T("Created"), ColumnType::Created },
-	{ _T("Accessed"), ColumnType::Accessed },
-	{ _T("Title"), ColumnType::Title },
-	{ _T("Subject"), ColumnType::Subject },
-	{ _T("Author"), ColumnType::Authors },
-	{ _T("Keywords"), ColumnType::Keywords },
-	{ _T("Comment"), ColumnType::Comment },
-	{ _T("CameraModel"), ColumnType::CameraModel },
-	{ _T("DateTaken"), ColumnType::DateTaken },
-	{ _T("Width"), ColumnType::Width },
-	{ _T("Height"), ColumnType::Height },
-	{ _T("VirtualComments"), ColumnType::VirtualComments },
-	{ _T("TotalSize"), ColumnType::TotalSize },
-	{ _T("FreeSpace"), ColumnType::FreeSpace },
-	{ _T("FileSystem"), ColumnType::FileSystem },
-	{ _T("OriginalLocation"), ColumnType::OriginalLocation },
-	{ _T("DateDeleted"), ColumnType::DateDeleted },
-	{ _T("Documents"), ColumnType::PrinterNumDocuments },
-	{ _T("Status"), ColumnType::PrinterStatus },
-	{ _T("PrinterComments"), ColumnType::PrinterComments },
-	{ _T("PrinterLocation"), ColumnType::PrinterLocation },
-	{ _T("NetworkAdaptorStatus"), ColumnType::NetworkAdaptorStatus },
-	{ _T("MediaBitrate"), ColumnType::MediaBitrate },
-	{ _T("MediaCopyright"), ColumnType::MediaCopyright },
-	{ _T("MediaDuration"), ColumnType::MediaDuration },
-	{ _T("MediaProtected"), ColumnType::MediaProtected },
-	{ _T("MediaRating"), ColumnType::MediaRating },
-	{ _T("MediaAlbumArtist"), ColumnType::MediaAlbumArtist },
-	{ _T("MediaAlbum"), ColumnType::MediaAlbum },
-	{ _T("MediaBeatsPerMinute"), ColumnType::MediaBeatsPerMinute },
-	{ _T("MediaComposer"), ColumnType::MediaComposer },
-	{ _T("MediaConductor"), ColumnType::MediaConductor },
-	{ _T("MediaDirector"), ColumnType::MediaDirector },
-	{ _T("MediaGenre"), ColumnType::MediaGenre },
-	{ _T("MediaLanguage"), ColumnType::MediaLanguage },
-	{ _T("MediaBroadcastDate"), ColumnType::MediaBroadcastDate },
-	{ _T("MediaChannel"), ColumnType::MediaChannel },
-	{ _T("MediaStationName"), ColumnType::MediaStationName },
-	{ _T("MediaMood"), ColumnType::MediaMood },
-	{ _T("MediaParentalRating"), ColumnType::MediaParentalRating },
-	{ _T("MediaParentalRatingReason"), ColumnType::MediaParentalRatingReason },
-	{ _T("MediaPeriod"), ColumnType::MediaPeriod },
-	{ _T("MediaProducer"), ColumnType::MediaProducer },
-	{ _T("MediaPublisher"), ColumnType::MediaPublisher },
-	{ _T("MediaWriter"), ColumnType::MediaWriter },
-	{ _T("MediaYear"), ColumnType::MediaYear },
-	{ _T("PrinterModel"), ColumnType::PrinterModel }
+constexpr std::pair<std::string_view, ColumnType> COLUMN_XML_NAMES[] = {
+	{ "Name", ColumnType::Name },
+	{ "Type", ColumnType::Type },
+	{ "Size", ColumnType::Size },
+	{ "DateModified", ColumnType::DateModified },
+	{ "Attributes", ColumnType::Attributes },
+	{ "SizeOnDisk", ColumnType::RealSize },
+	{ "ShortName", ColumnType::ShortName },
+	{ "Owner", ColumnType::Owner },
+	{ "ProductName", ColumnType::ProductName },
+	{ "Company", ColumnType::Company },
+	{ "Description", ColumnType::Description },
+	{ "FileVersion", ColumnType::FileVersion },
+	{ "ProductVersion", ColumnType::ProductVersion },
+	{ "ShortcutTo", ColumnType::ShortcutTo },
+	{ "HardLinks", ColumnType::HardLinks },
+	{ "Extension", ColumnType::Extension },
+	{ "Created", ColumnType::Created },
+	{ "Accessed", ColumnType::Accessed },
+	{ "Title", ColumnType::Title },
+	{ "Subject", ColumnType::Subject },
+	{ "Author", ColumnType::Authors },
+	{ "Keywords", ColumnType::Keywords },
+	{ "Comment", ColumnType::Comment },
+	{ "CameraModel", ColumnType::CameraModel },
+	{ "DateTaken", ColumnType::DateTaken },
+	{ "Width", ColumnType::Width },
+	{ "Height", ColumnType::Height },
+	{ "VirtualComments", ColumnType::VirtualComments },
+	{ "TotalSize", ColumnType::TotalSize },
+	{ "FreeSpace", ColumnType::FreeSpace },
+	{ "FileSystem", ColumnType::FileSystem },
+	{ "OriginalLocation", ColumnType::OriginalLocation },
+	{ "DateDeleted", ColumnType::DateDeleted },
+	{ "Documents", ColumnType::PrinterNumDocuments },
+	{ "Status", ColumnType::PrinterStatus },
+	{ "PrinterComments", ColumnType::PrinterComments },
+	{ "PrinterLocation", ColumnType::PrinterLocation },
+	{ "NetworkAdaptorStatus", ColumnType::NetworkAdaptorStatus },
+	{ "MediaBitrate", ColumnType::MediaBitrate },
+	{ "MediaCopyright", ColumnType::MediaCopyright },
+	{ "MediaDuration", ColumnType::MediaDuration },
+	{ "MediaProtected", ColumnType::MediaProtected },
+	{ "MediaRating", ColumnType::MediaRating },
+	{ "MediaAlbumArtist", ColumnType::MediaAlbumArtist },
+	{ "MediaAlbum", ColumnType::MediaAlbum },
+	{ "MediaBeatsPerMinute", ColumnType::MediaBeatsPerMinute },
+	{ "MediaComposer", ColumnType::MediaComposer },
+	{ "MediaConductor", ColumnType::MediaConductor },
+	{ "MediaDirector", ColumnType::MediaDirector },
+	{ "MediaGenre", ColumnType::MediaGenre },
+	{ "MediaLanguage", ColumnType::MediaLanguage },
+	{ "MediaBroadcastDate", ColumnType::MediaBroadcastDate },
+	{ "MediaChannel", ColumnType::MediaChannel },
+	{ "MediaStationName", ColumnType::MediaStationName },
+	{ "MediaMood", ColumnType::MediaMood },
+	{ "MediaParentalRating", ColumnType::MediaParentalRating },
+	{ "MediaParentalRatingReason", ColumnType::MediaParentalRatingReason },
+	{ "MediaPeriod", ColumnType::MediaPeriod },
+	{ "MediaProducer", ColumnType::MediaProducer },
+	{ "MediaPublisher", ColumnType::MediaPublisher },
+	{ "MediaWriter", ColumnType::MediaWriter },
+	{ "MediaYear", ColumnType::MediaYear },
+	{ "PrinterModel", ColumnType::PrinterModel },
+	{ "Crc32c", ColumnType::Crc32c },
+	{ "XxHash64", ColumnType::XxHash64 },
+	{ "Sha256", ColumnType::Sha256 }
 };
 // clang-format on
 
-unsigned long hash_setting(unsigned char *str);
+constexpr auto COLUMN_XML_NAME_MAP = MakePerfectHashMap(COLUMN_XML_NAMES);
 
-BOOL LoadWindowPositionFromXML(WINDOWPLACEMENT *pwndpl)
+constexpr std::string_view COLUMN_WIDTH_SUFFIX = "_Width";
+
+enum class ToolbarAttribute
 {
-	wil::com_ptr_nothrow<IXMLDOMDocument> pXMLDom;
-	pXMLDom.attach(NXMLSettings::DomFromCOM());
+	Id,
+	Style,
+	Length
+};
+
+constexpr auto TOOLBAR_ATTRIBUTE_NAMES = MakePerfectHashMap<ToolbarAttribute>(
+	{ { "id", ToolbarAttribute::Id }, { "Style", ToolbarAttribute::Style },
+		{ "Length", ToolbarAttribute::Length } });
+
+int DecodeIntAttribute(std::string_view rawValue)
+{
+	return NXMLSettings::DecodeIntValue(DecodeXmlAttributeValue(rawValue).c_str());
+}
 
-	if (!pXMLDom)
+BOOL DecodeBoolAttribute(std::string_view rawValue)
+{
+	return NXMLSettings::DecodeBoolValue(DecodeXmlAttributeValue(rawValue).c_str());
+}
+
+// Each setting is stored in an element of the form <Setting name="...">, with the first
+// attribute holding the name of the setting.
+std::optional<std::string_view> GetSettingName(const XmlPullParser &parser)
+{
+	const auto &attributes = parser.GetAttributes();
+
+	if (attributes.empty())
 	{
-		return FALSE;
+		return std::nullopt;
+	}
+
+	return attributes[0].rawValue;
+}
+
+int LoadColumnFromXML(const XmlPullParser &parser, std::vector<Column_t> &outputColumns)
+{
+	outputColumns.clear();
+
+	int iColumnType = -1;
+
+	for (const auto &attribute : parser.GetAttributes())
+	{
+		if (attribute.name == "name")
+		{
+			iColumnType = COLUMN_SET_NAMES.Find(attribute.rawValue).value_or(-1);
+			continue;
+		}
+
+		std::string_view columnName = attribute.name;
+		bool isWidth = columnName.ends_with(COLUMN_WIDTH_SUFFIX);
+
+		if (isWidth)
+		{
+			columnName.remove_suffix(COLUMN_WIDTH_SUFFIX.size());
+		}
+
+		auto columnType = COLUMN_XML_NAME_MAP.Find(columnName);
+
+		if (!columnType)
+		{
+			continue;
+		}
+
+		if (isWidth)
+		{
+			if (!outputColumns.empty())
+			{
+				outputColumns.back().iWidth = DecodeIntAttribute(attribute.rawValue);
+			}
+		}
+		else
+		{
+			Column_t column;
+			column.type = *columnType;
+			column.bChecked = DecodeBoolAttribute(attribute.rawValue);
+			outputColumns.push_back(column);
+		}
+	}
+
+	return iColumnType;
+}
+
+// Loads a single set of columns (e.g. the columns used for real folders) into the appropriate
+// member of folderColumns.
+void LoadColumnSetFromXML(const XmlPullParser &parser, FolderColumns &folderColumns)
+{
+	std::vector<Column_t> columnSet;
+	int iColumnType = LoadColumnFromXML(parser, columnSet);
+
+	switch (iColumnType)
+	{
+	case COLUMN_TYPE_GENERIC:
+		folderColumns.realFolderColumns = columnSet;
+		break;
+
+	case COLUMN_TYPE_MYCOMPUTER:
+		folderColumns.myComputerColumns = columnSet;
+		break;
+
+	case COLUMN_TYPE_CONTROLPANEL:
+		folderColumns.controlPanelColumns = columnSet;
+		break;
+
+	case COLUMN_TYPE_RECYCLEBIN:
+		folderColumns.recycleBinColumns = columnSet;
+		break;
+
+	case COLUMN_TYPE_PRINTERS:
+		folderColumns.printersColumns = columnSet;
+		break;
+
+	case COLUMN_TYPE_NETWORK:
+		folderColumns.networkConnectionsColumns = columnSet;
+		break;
+
+	case COLUMN_TYPE_NETWORKPLACES:
+		folderColumns.myNetworkPlacesColumns = columnSet;
+		break;
+	}
+}
+
+void MapTabAttributeValue(std::string_view name, const std::wstring &value, XmlTabSettings &tab)
+{
+	auto attribute = TAB_ATTRIBUTE_NAMES.Find(name);
+
+	if (!attribute)
+	{
+		return;
+	}
+
+	const WCHAR *wszValue = value.c_str();
+
+	switch (*attribute)
+	{
+	case TabAttribute::Directory:
+		tab.directory = value;
+		break;
+
+	case TabAttribute::ApplyFilter:
+		tab.folderSettings.applyFilter = NXMLSettings::DecodeBoolValue(wszValue);
+		break;
+
+	case TabAttribute::AutoArrange:
+		tab.folderSettings.autoArrange = NXMLSettings::DecodeBoolValue(wszValue);
+		break;
+
+	case TabAttribute::Filter:
+		tab.folderSettings.filter = value;
+		break;
+
+	case TabAttribute::FilterCaseSensitive:
+		tab.folderSettings.filterCaseSensitive = NXMLSettings::DecodeBoolValue(wszValue);
+		break;
+
+	case TabAttribute::ShowHidden:
+		tab.folderSettings.showHidden = NXMLSettings::DecodeBoolValue(wszValue);
+		break;
+
+	case TabAttribute::ShowInGroups:
+		tab.folderSettings.showInGroups = NXMLSettings::DecodeBoolValue(wszValue);
+		break;
+
+	case TabAttribute::SortAscending:
+		tab.folderSettings.sortAscending = NXMLSettings::DecodeBoolValue(wszValue);
+		break;
+
+	case TabAttribute::SortMode:
+		tab.folderSettings.sortMode =
+			SortMode::_from_integral(NXMLSettings::DecodeIntValue(wszValue));
+		break;
+
+	case TabAttribute::ViewMode:
+		tab.folderSettings.viewMode =
+			ViewMode::_from_integral(NXMLSettings::DecodeIntValue(wszValue));
+		break;
+
+	case TabAttribute::Locked:
+		if (NXMLSettings::DecodeBoolValue(wszValue))
+		{
+			tab.tabSettings.lockState = Tab::LockState::Locked;
+		}
+		break;
+
+	case TabAttribute::AddressLocked:
+		if (NXMLSettings::DecodeBoolValue(wszValue))
+		{
+			tab.tabSettings.lockState = Tab::LockState::AddressLocked;
+		}
+		break;
+
+	case TabAttribute::CustomName:
+		tab.tabSettings.name = value;
+		break;
 	}
+}
 
+}
+
+std::wstring GetXmlConfigFilePath()
+{
 	TCHAR szConfigFile[MAX_PATH];
 	GetProcessImageName(GetCurrentProcessId(), szConfigFile, SIZEOF_ARRAY(szConfigFile));
 	PathRemoveFileSpec(szConfigFile);
 	PathAppend(szConfigFile, NExplorerplusplus::XML_FILENAME);
 
-	wil::unique_variant var(NXMLSettings::VariantString(szConfigFile));
-	VARIANT_BOOL status;
-	pXMLDom->load(var, &status);
+	return szConfigFile;
+}
+
+std::unique_ptr<MappedXmlFile> OpenXmlConfigFile()
+{
+	return MappedXmlFile::Open(GetXmlConfigFilePath());
+}
+
+BOOL LoadWindowPositionFromXML(WINDOWPLACEMENT *pwndpl)
+{
+	auto configFile = OpenXmlConfigFile();
 
-	if (status != VARIANT_TRUE)
+	if (!configFile)
 	{
 		return FALSE;
 	}
 
-	wil::com_ptr_nothrow<IXMLDOMNodeList> pNodes;
-	auto bstr = wil::make_bstr_nothrow(L"//WindowPosition/*");
-	pXMLDom->selectNodes(bstr.get(), &pNodes);
+	auto parser = XmlPullParser::OpenTopLevelElement(configFile->GetData(), "WindowPosition");
 
-	if (!pNodes)
+	if (!parser)
 	{
 		return FALSE;
 	}
 
-	pwndpl->length = sizeof(WINDOWPLACEMENT);
-
-	long length;
-	pNodes->get_length(&length);
+	size_t windowPositionDepth = parser->GetDepth();
 
 	/* There should only be one node
 	under 'WindowPosition'. */
-	if (length != 1)
+	if (!parser->NextChildElement(windowPositionDepth))
 	{
 		return FALSE;
 	}
 
-	wil::com_ptr_nothrow<IXMLDOMNode> pNode;
-	pNodes->get_item(0, &pNode);
+	pwndpl->length = sizeof(WINDOWPLACEMENT);
 
-	wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> am;
-	HRESULT hr = pNode->get_attributes(&am);
+	// The first attribute is the name of the setting, which can be ignored.
+	const auto &attributes = parser->GetAttributes();
 
-	if (SUCCEEDED(hr))
+	for (size_t i = 1; i < attributes.size(); i++)
 	{
-		long nChildNodes;
-		am->get_length(&nChildNodes);
+		std::string_view name = attributes[i].name;
+		int value = DecodeIntAttribute(attributes[i].rawValue);
 
-		for (long i = 1; i < nChildNodes; i++)
+		if (name == "Flags")
 		{
-			wil::com_ptr_nothrow<IXMLDOMNode> pChildNode;
-			am->get_item(i, &pChildNode);
-
-			wil::unique_bstr bstrName;
-			pChildNode->get_nodeName(&bstrName);
-
-			wil::unique_bstr bstrValue;
-			pChildNode->get_text(&bstrValue);
-
-			if (lstrcmp(bstrName.get(), _T("Flags")) == 0)
-			{
-				pwndpl->flags = NXMLSettings::DecodeIntValue(bstrValue.get());
-			}
-			else if (lstrcmp(bstrName.get(), _T("ShowCmd")) == 0)
-			{
-				pwndpl->showCmd = NXMLSettings::DecodeIntValue(bstrValue.get());
-			}
-			else if (lstrcmp(bstrName.get(), _T("MinPositionX")) == 0)
-			{
-				pwndpl->ptMinPosition.x = NXMLSettings::DecodeIntValue(bstrValue.get());
-			}
-			else if (lstrcmp(bstrName.get(), _T("MinPositionY")) == 0)
-			{
-				pwndpl->ptMinPosition.y = NXMLSettings::DecodeIntValue(bstrValue.get());
-			}
-			else if (lstrcmp(bstrName.get(), _T("MaxPositionX")) == 0)
-			{
-				pwndpl->ptMaxPosition.x = NXMLSettings::DecodeIntValue(bstrValue.get());
-			}
-			else if (lstrcmp(bstrName.get(), _T("MaxPositionY")) == 0)
-			{
-				pwndpl->ptMaxPosition.y = NXMLSettings::DecodeIntValue(bstrValue.get());
-			}
-			else if (lstrcmp(bstrName.get(), _T("NormalPositionLeft")) == 0)
-			{
-				pwndpl->rcNormalPosition.left = NXMLSettings::DecodeIntValue(bstrValue.get());
-			}
-			else if (lstrcmp(bstrName.get(), _T("NormalPositionTop")) == 0)
-			{
-				pwndpl->rcNormalPosition.top = NXMLSettings::DecodeIntValue(bstrValue.get());
-			}
-			else if (lstrcmp(bstrName.get(), _T("NormalPositionRight")) == 0)
-			{
-				pwndpl->rcNormalPosition.right = NXMLSettings::DecodeIntValue(bstrValue.get());
-			}
-			else if (lstrcmp(bstrName.get(), _T("NormalPositionBottom")) == 0)
-			{
-				pwndpl->rcNormalPosition.bottom = NXMLSettings::DecodeIntValue(bstrValue.get());
-			}
+			pwndpl->flags = value;
+		}
+		else if (name == "ShowCmd")
+		{
+			pwndpl->showCmd = value;
+		}
+		else if (name == "MinPositionX")
+		{
+			pwndpl->ptMinPosition.x = value;
+		}
+		else if (name == "MinPositionY")
+		{
+			pwndpl->ptMinPosition.y = value;
+		}
+		else if (name == "MaxPositionX")
+		{
+			pwndpl->ptMaxPosition.x = value;
+		}
+		else if (name == "MaxPositionY")
+		{
+			pwndpl->ptMaxPosition.y = value;
+		}
+		else if (name == "NormalPositionLeft")
+		{
+			pwndpl->rcNormalPosition.left = value;
+		}
+		else if (name == "NormalPositionTop")
+		{
+			pwndpl->rcNormalPosition.top = value;
+		}
+		else if (name == "NormalPositionRight")
+		{
+			pwndpl->rcNormalPosition.right = value;
+		}
+		else if (name == "NormalPositionBottom")
+		{
+			pwndpl->rcNormalPosition.bottom = value;
 		}
 	}
 
+	if (parser->NextChildElement(windowPositionDepth))
+	{
+		return FALSE;
+	}
+
 	return TRUE;
 }
 
@@ -311,118 +634,110 @@ BOOL LoadAllowMultipleInstancesFromXML()
 {
 	BOOL bAllowMultipleInstances = TRUE;
 
-	wil::com_ptr_nothrow<IXMLDOMDocument> pXMLDom;
-	pXMLDom.attach(NXMLSettings::DomFromCOM());
+	auto configFile = OpenXmlConfigFile();
 
-	if (!pXMLDom)
+	if (!configFile)
 	{
 		return bAllowMultipleInstances;
 	}
 
-	TCHAR szConfigFile[MAX_PATH];
-	GetProcessImageName(GetCurrentProcessId(), szConfigFile, SIZEOF_ARRAY(szConfigFile));
-	PathRemoveFileSpec(szConfigFile);
-	PathAppend(szConfigFile, NExplorerplusplus::XML_FILENAME);
-
-	VARIANT_BOOL status;
-	wil::unique_variant var(NXMLSettings::VariantString(szConfigFile));
-	pXMLDom->load(var, &status);
+	auto parser = XmlPullParser::OpenTopLevelElement(configFile->GetData(), "Settings");
 
-	if (status != VARIANT_TRUE)
+	if (!parser)
 	{
 		return bAllowMultipleInstances;
 	}
 
-	wil::com_ptr_nothrow<IXMLDOMNodeList> pNodes;
-	auto bstr = wil::make_bstr_nothrow(L"//Settings/*");
-	pXMLDom->selectNodes(bstr.get(), &pNodes);
+	size_t settingsDepth = parser->GetDepth();
 
-	if (!pNodes)
+	while (parser->NextChildElement(settingsDepth))
 	{
-		return bAllowMultipleInstances;
+		if (GetSettingName(*parser) != "AllowMultipleInstances")
+		{
+			continue;
+		}
+
+		auto value = parser->ReadElementText();
+
+		if (value)
+		{
+			bAllowMultipleInstances = NXMLSettings::DecodeBoolValue(value->c_str());
+		}
+
+		break;
 	}
 
-	long length;
-	pNodes->get_length(&length);
+	return bAllowMultipleInstances;
+}
 
-	for (long i = 0; i < length; i++)
+std::vector<XmlTabSettings> ReadTabSettingsFromXML(std::string_view xmlData)
+{
+	std::vector<XmlTabSettings> tabs;
+	auto parser = XmlPullParser::OpenTopLevelElement(xmlData, "Tabs");
+
+	if (!parser)
 	{
-		wil::com_ptr_nothrow<IXMLDOMNode> pNode;
-		pNodes->get_item(i, &pNode);
+		return tabs;
+	}
 
-		wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> am;
-		HRESULT hr = pNode->get_attributes(&am);
+	size_t tabsDepth = parser->GetDepth();
 
-		if (SUCCEEDED(hr))
+	while (parser->NextChildElement(tabsDepth))
+	{
+		XmlTabSettings tab;
+
+		/* For each tab, the first attribute will just be
+		a tab number (0,1,2...). This number can be safely
+		ignored. */
+		const auto &attributes = parser->GetAttributes();
+
+		for (size_t i = 1; i < attributes.size(); i++)
 		{
-			wil::com_ptr_nothrow<IXMLDOMNode> pNodeAttribute;
-			hr = am->get_item(0, &pNodeAttribute);
+			MapTabAttributeValue(attributes[i].name,
+				DecodeXmlAttributeValue(attributes[i].rawValue), tab);
+		}
 
-			if (SUCCEEDED(hr))
-			{
-				wil::unique_bstr bstrName;
-				pNodeAttribute->get_text(&bstrName);
+		size_t tabDepth = parser->GetDepth();
 
-				wil::unique_bstr bstrValue;
-				pNode->get_text(&bstrValue);
+		if (parser->FindChildElement(tabDepth, "Columns"))
+		{
+			size_t columnsDepth = parser->GetDepth();
 
-				if (lstrcmp(bstrName.get(), _T("AllowMultipleInstances")) == 0)
-				{
-					bAllowMultipleInstances = NXMLSettings::DecodeBoolValue(bstrValue.get());
-					break;
-				}
+			while (parser->NextChildElement(columnsDepth))
+			{
+				LoadColumnSetFromXML(*parser, tab.initialColumns);
 			}
 		}
+
+		tabs.push_back(std::move(tab));
 	}
 
-	return bAllowMultipleInstances;
+	return tabs;
 }
 
-void Explorerplusplus::LoadGenericSettingsFromXML(IXMLDOMDocument *pXMLDom)
+void Explorerplusplus::LoadGenericSettingsFromXML(std::string_view xmlData)
 {
-	if (!pXMLDom)
-	{
-		return;
-	}
-
-	wil::com_ptr_nothrow<IXMLDOMNodeList> pNodes;
-	auto bstr = wil::make_bstr_nothrow(L"//Settings/*");
-	pXMLDom->selectNodes(bstr.get(), &pNodes);
+	auto parser = XmlPullParser::OpenTopLevelElement(xmlData, "Settings");
 
-	if (!pNodes)
+	if (!parser)
 	{
 		return;
 	}
 
-	long length;
-	pNodes->get_length(&length);
+	size_t settingsDepth = parser->GetDepth();
 
-	for (long i = 0; i < length; i++)
+	while (parser->NextChildElement(settingsDepth))
 	{
-		wil::com_ptr_nothrow<IXMLDOMNode> pNode;
-		pNodes->get_item(i, &pNode);
+		auto settingName = GetSettingName(*parser);
 
-		wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> am;
-		HRESULT hr = pNode->get_attributes(&am);
-
-		if (SUCCEEDED(hr))
+		if (!settingName)
 		{
-			wil::com_ptr_nothrow<IXMLDOMNode> pNodeAttribute;
-			hr = am->get_item(0, &pNodeAttribute);
-
-			if (SUCCEEDED(hr))
-			{
-				wil::unique_bstr bstrName;
-				pNodeAttribute->get_text(&bstrName);
-
-				wil::unique_bstr bstrValue;
-				pNode->get_text(&bstrValue);
-
-				/* Map the external attribute and value to an
-				internal variable. */
-				MapAttributeToValue(pNode.get(), bstrName.get(), bstrValue.get());
-			}
+			continue;
 		}
+
+		/* Map the external attribute and value to an
+		internal variable. */
+		MapAttributeToValue(*parser, *settingName);
 	}
 }
 
@@ -726,6 +1041,11 @@ void Explorerplusplus::SaveGenericSettingsToXML(IXMLDOMDocument *pXMLDom, IXMLDO
 	NXMLSettings::WriteStandardSetting(pXMLDom, pe.get(), _T("Setting"), _T("EnableDarkMode"),
 		NXMLSettings::EncodeBoolValue(m_config->enableDarkMode));
 
+	NXMLSettings::AddWhiteSpaceToNode(pXMLDom, bstr_wsntt.get(), pe.get());
+	NXMLSettings::WriteStandardSetting(pXMLDom, pe.get(), _T("Setting"),
+		_T("UseBuiltInFileTransfer"),
+		NXMLSettings::EncodeBoolValue(m_config->useBuiltInFileTransfer));
+
 	NXMLSettings::AddWhiteSpaceToNode(pXMLDom, bstr_wsntt.get(), pe.get());
 	NXMLSettings::WriteStandardSetting(pXMLDom, pe.get(), _T("Setting"),
 		_T("DisplayMixedFilesAndFolders"),
@@ -738,6 +1058,15 @@ void Explorerplusplus::SaveGenericSettingsToXML(IXMLDOMDocument *pXMLDom, IXMLDO
 	NXMLSettings::WriteStandardSetting(pXMLDom, pe.get(), _T("Setting"), _T("OpenTabsInForeground"),
 		NXMLSettings::EncodeBoolValue(m_config->openTabsInForeground));
 
+	NXMLSettings::AddWhiteSpaceToNode(pXMLDom, bstr_wsntt.get(), pe.get());
+	_itow_s(m_config->hibernateTabsAfterMinutes, szValue, SIZEOF_ARRAY(szValue), 10);
+	NXMLSettings::WriteStandardSetting(pXMLDom, pe.get(), _T("Setting"),
+		_T("HibernateTabsAfterMinutes"), szValue);
+	NXMLSettings::AddWhiteSpaceToNode(pXMLDom, bstr_wsntt.get(), pe.get());
+	_itow_s(m_config->maxLoadedTabs, szValue, SIZEOF_ARRAY(szValue), 10);
+	NXMLSettings::WriteStandardSetting(pXMLDom, pe.get(), _T("Setting"), _T("MaxLoadedTabs"),
+		szValue);
+
 	auto bstr_wsnt = wil::make_bstr_nothrow(L"\n\t");
 	NXMLSettings::AddWhiteSpaceToNode(pXMLDom, bstr_wsnt.get(), pe.get());
 
@@ -746,159 +1075,21 @@ void Explorerplusplus::SaveGenericSettingsToXML(IXMLDOMDocument *pXMLDom, IXMLDO
 	SaveWindowPositionToXML(pXMLDom, pRoot);
 }
 
-int Explorerplusplus::LoadTabSettingsFromXML(IXMLDOMDocument *pXMLDom)
+int Explorerplusplus::LoadTabSettingsFromXML(std::string_view xmlData)
 {
-	if (!pXMLDom)
-	{
-		return 0;
-	}
-
-	wil::com_ptr_nothrow<IXMLDOMNodeList> pNodes;
-	auto bstr = wil::make_bstr_nothrow(L"//Tabs/*");
-	pXMLDom->selectNodes(bstr.get(), &pNodes);
-
-	if (!pNodes)
-	{
-		return 0;
-	}
-
+	auto tabs = ReadTabSettingsFromXML(xmlData);
 	int nTabsCreated = 0;
 
-	long length;
-	pNodes->get_length(&length);
-
-	for (long i = 0; i < length; i++)
+	for (auto &tab : tabs)
 	{
-		/* This should never fail, as the number
-		of nodes has already been counted (so
-		they must exist). */
-		wil::com_ptr_nothrow<IXMLDOMNode> pNode;
-		HRESULT hr = pNodes->get_item(i, &pNode);
-
-		TCHAR szDirectory[MAX_PATH];
-		TabSettings tabSettings;
-		FolderSettings folderSettings;
-		FolderColumns initialColumns;
-
-		if (SUCCEEDED(hr))
-		{
-			wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> am;
-			hr = pNode->get_attributes(&am);
+		tab.tabSettings.index = nTabsCreated;
+		tab.tabSettings.selected = (nTabsCreated == m_iLastSelectedTab);
+		tab.tabSettings.deferEnumeration = true;
 
-			if (SUCCEEDED(hr))
-			{
-				tabSettings.index = i;
-				tabSettings.selected = true;
-
-				long lChildNodes;
-				am->get_length(&lChildNodes);
-
-				/* For each tab, the first attribute will just be
-				a tab number (0,1,2...). This number can be safely
-				ignored. */
-				for (long j = 1; j < lChildNodes; j++)
-				{
-					wil::com_ptr_nothrow<IXMLDOMNode> pChildNode;
-					am->get_item(j, &pChildNode);
-
-					wil::unique_bstr bstrName;
-					pChildNode->get_nodeName(&bstrName);
-
-					wil::unique_bstr bstrValue;
-					pChildNode->get_text(&bstrValue);
-
-					if (lstrcmp(bstrName.get(), L"Directory") == 0)
-					{
-						StringCchCopy(szDirectory, SIZEOF_ARRAY(szDirectory), bstrValue.get());
-					}
-					else
-					{
-						MapTabAttributeValue(bstrName.get(), bstrValue.get(), tabSettings,
-							folderSettings);
-					}
-				}
-
-				wil::com_ptr_nothrow<IXMLDOMNode> firstNode;
-				hr = pNode->get_firstChild(&firstNode);
-
-				if (hr == S_OK)
-				{
-					wil::com_ptr_nothrow<IXMLDOMNode> pColumnsNode;
-					hr = firstNode->get_nextSibling(&pColumnsNode);
-
-					if (hr == S_OK)
-					{
-						wil::com_ptr_nothrow<IXMLDOMNode> firstInnerNode;
-						hr = pColumnsNode->get_firstChild(&firstInnerNode);
-
-						if (hr == S_OK)
-						{
-							wil::com_ptr_nothrow<IXMLDOMNode> pColumnNode;
-							firstInnerNode->get_nextSibling(&pColumnNode);
-
-							std::vector<Column_t> column;
-							int iColumnType;
-
-							while (pColumnNode != nullptr)
-							{
-								iColumnType = LoadColumnFromXML(pColumnNode.get(), column);
-
-								switch (iColumnType)
-								{
-								case COLUMN_TYPE_GENERIC:
-									initialColumns.realFolderColumns = column;
-									break;
-
-								case COLUMN_TYPE_MYCOMPUTER:
-									initialColumns.myComputerColumns = column;
-									break;
-
-								case COLUMN_TYPE_CONTROLPANEL:
-									initialColumns.controlPanelColumns = column;
-									break;
-
-								case COLUMN_TYPE_RECYCLEBIN:
-									initialColumns.recycleBinColumns = column;
-									break;
-
-								case COLUMN_TYPE_PRINTERS:
-									initialColumns.printersColumns = column;
-									break;
-
-								case COLUMN_TYPE_NETWORK:
-									initialColumns.networkConnectionsColumns = column;
-									break;
-
-								case COLUMN_TYPE_NETWORKPLACES:
-									initialColumns.myNetworkPlacesColumns = column;
-									break;
-								}
-
-								wil::com_ptr_nothrow<IXMLDOMNode> nextSibling;
-								pColumnNode->get_nextSibling(&nextSibling);
-								nextSibling->get_nextSibling(&pColumnNode);
-							}
-						}
-					}
-				}
-
-				ValidateSingleColumnSet(VALIDATE_REALFOLDER_COLUMNS,
-					initialColumns.realFolderColumns);
-				ValidateSingleColumnSet(VALIDATE_CONTROLPANEL_COLUMNS,
-					initialColumns.controlPanelColumns);
-				ValidateSingleColumnSet(VALIDATE_MYCOMPUTER_COLUMNS,
-					initialColumns.myComputerColumns);
-				ValidateSingleColumnSet(VALIDATE_RECYCLEBIN_COLUMNS,
-					initialColumns.recycleBinColumns);
-				ValidateSingleColumnSet(VALIDATE_PRINTERS_COLUMNS, initialColumns.printersColumns);
-				ValidateSingleColumnSet(VALIDATE_NETWORKCONNECTIONS_COLUMNS,
-					initialColumns.networkConnectionsColumns);
-				ValidateSingleColumnSet(VALIDATE_MYNETWORKPLACES_COLUMNS,
-					initialColumns.myNetworkPlacesColumns);
-			}
-		}
+		ValidateColumns(tab.initialColumns);
 
-		m_tabContainer->CreateNewTab(szDirectory, tabSettings, &folderSettings, &initialColumns);
+		m_tabContainer->CreateNewTab(tab.directory, tab.tabSettings, &tab.folderSettings,
+			&tab.initialColumns);
 
 		nTabsCreated++;
 	}
@@ -1022,154 +1213,38 @@ void Explorerplusplus::SaveTabSettingsToXMLnternal(IXMLDOMDocument *pXMLDom, IXM
 	}
 }
 
-int Explorerplusplus::LoadColumnFromXML(IXMLDOMNode *pNode, std::vector<Column_t> &outputColumns)
-{
-	outputColumns.clear();
-
-	wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> am;
-	HRESULT hr = pNode->get_attributes(&am);
-
-	if (FAILED(hr))
-	{
-		return -1;
-	}
-
-	int iColumnType = -1;
-
-	long nAttributeNodes;
-	am->get_length(&nAttributeNodes);
-
-	for (long i = 0; i < nAttributeNodes; i++)
-	{
-		wil::com_ptr_nothrow<IXMLDOMNode> pAttributeNode;
-		am->get_item(i, &pAttributeNode);
-
-		wil::unique_bstr bstrName;
-		pAttributeNode->get_nodeName(&bstrName);
-
-		wil::unique_bstr bstrValue;
-		pAttributeNode->get_text(&bstrValue);
-
-		if (lstrcmp(bstrName.get(), _T("name")) == 0)
-		{
-			if (lstrcmp(bstrValue.get(), _T("Generic")) == 0)
-				iColumnType = COLUMN_TYPE_GENERIC;
-			else if (lstrcmp(bstrValue.get(), _T("MyComputer")) == 0)
-				iColumnType = COLUMN_TYPE_MYCOMPUTER;
-			else if (lstrcmp(bstrValue.get(), _T("ControlPanel")) == 0)
-				iColumnType = COLUMN_TYPE_CONTROLPANEL;
-			else if (lstrcmp(bstrValue.get(), _T("RecycleBin")) == 0)
-				iColumnType = COLUMN_TYPE_RECYCLEBIN;
-			else if (lstrcmp(bstrValue.get(), _T("Printers")) == 0)
-				iColumnType = COLUMN_TYPE_PRINTERS;
-			else if (lstrcmp(bstrValue.get(), _T("Network")) == 0)
-				iColumnType = COLUMN_TYPE_NETWORK;
-			else if (lstrcmp(bstrValue.get(), _T("NetworkPlaces")) == 0)
-				iColumnType = COLUMN_TYPE_NETWORKPLACES;
-		}
-		else
-		{
-			int j = 0;
-
-			for (j = 0; j < sizeof(ColumnData) / sizeof(ColumnData[0]); j++)
-			{
-				TCHAR szWidth[32];
-				StringCchPrintf(szWidth, SIZEOF_ARRAY(szWidth), _T("%s_Width"),
-					ColumnData[j].szName);
-
-				if (lstrcmp(bstrName.get(), ColumnData[j].szName) == 0)
-				{
-					Column_t column;
-					column.type = ColumnData[j].type;
-					column.bChecked = NXMLSettings::DecodeBoolValue(bstrValue.get());
-					outputColumns.push_back(column);
-					break;
-				}
-				else if (lstrcmp(bstrName.get(), szWidth) == 0)
-				{
-					if (!outputColumns.empty())
-					{
-						outputColumns.back().iWidth = NXMLSettings::DecodeIntValue(bstrValue.get());
-					}
-
-					break;
-				}
-			}
-		}
-	}
-
-	return iColumnType;
-}
-
-void Explorerplusplus::LoadBookmarksFromXML(IXMLDOMDocument *pXMLDom)
+void Explorerplusplus::LoadBookmarksFromXML(std::string_view xmlData)
 {
-	BookmarkXmlStorage::Load(pXMLDom, &m_bookmarkTree);
+	auto journalPosition = BookmarkXmlStorage::Load(xmlData, &m_bookmarkTree);
+	LoadBookmarkJournal(journalPosition);
 }
 
-void Explorerplusplus::SaveBookmarksToXML(IXMLDOMDocument *pXMLDom, IXMLDOMElement *pRoot)
+// Returns the journal position that was saved. The journal can only be trimmed once the file has
+// actually been written.
+std::optional<BookmarkJournalPosition> Explorerplusplus::SaveBookmarksToXML(
+	IXMLDOMDocument *pXMLDom, IXMLDOMElement *pRoot)
 {
-	BookmarkXmlStorage::Save(pXMLDom, pRoot, &m_bookmarkTree, 1);
+	auto journalPosition = m_bookmarkJournal->GetCurrentPosition();
+	BookmarkXmlStorage::Save(pXMLDom, pRoot, &m_bookmarkTree, 1, journalPosition);
+	return journalPosition;
 }
 
-void Explorerplusplus::LoadDefaultColumnsFromXML(IXMLDOMDocument *pXMLDom)
+void Explorerplusplus::LoadDefaultColumnsFromXML(std::string_view xmlData)
 {
-	if (!pXMLDom)
-	{
-		return;
-	}
+	auto parser = XmlPullParser::OpenTopLevelElement(xmlData, "DefaultColumns");
 
-	wil::com_ptr_nothrow<IXMLDOMNodeList> pNodes;
-	auto bstr = wil::make_bstr_nothrow(L"//DefaultColumns/*");
-	pXMLDom->selectNodes(bstr.get(), &pNodes);
-
-	if (!pNodes)
+	if (!parser)
 	{
 		return;
 	}
 
-	long length;
-	pNodes->get_length(&length);
+	size_t defaultColumnsDepth = parser->GetDepth();
 
 	auto &folderColumns = m_config->globalFolderSettings.folderColumns;
 
-	for (long i = 0; i < length; i++)
+	while (parser->NextChildElement(defaultColumnsDepth))
 	{
-		wil::com_ptr_nothrow<IXMLDOMNode> pNode;
-		pNodes->get_item(i, &pNode);
-
-		std::vector<Column_t> columnSet;
-		int iColumnType = LoadColumnFromXML(pNode.get(), columnSet);
-
-		switch (iColumnType)
-		{
-		case COLUMN_TYPE_GENERIC:
-			folderColumns.realFolderColumns = columnSet;
-			break;
-
-		case COLUMN_TYPE_MYCOMPUTER:
-			folderColumns.myComputerColumns = columnSet;
-			break;
-
-		case COLUMN_TYPE_CONTROLPANEL:
-			folderColumns.controlPanelColumns = columnSet;
-			break;
-
-		case COLUMN_TYPE_RECYCLEBIN:
-			folderColumns.recycleBinColumns = columnSet;
-			break;
-
-		case COLUMN_TYPE_PRINTERS:
-			folderColumns.printersColumns = columnSet;
-			break;
-
-		case COLUMN_TYPE_NETWORK:
-			folderColumns.networkConnectionsColumns = columnSet;
-			break;
-
-		case COLUMN_TYPE_NETWORKPLACES:
-			folderColumns.myNetworkPlacesColumns = columnSet;
-			break;
-		}
+		LoadColumnSetFromXML(*parser, folderColumns);
 	}
 }
 
@@ -1230,23 +1305,19 @@ void Explorerplusplus::SaveColumnToXML(IXMLDOMDocument *pXMLDom, IXMLDOMElement
 
 	for (auto itr = columns.begin(); itr != columns.end(); itr++)
 	{
-		const TCHAR *pszColumnSaveName = nullptr;
+		auto columnSaveName = std::find_if(std::begin(COLUMN_XML_NAMES),
+			std::end(COLUMN_XML_NAMES),
+			[&itr](const auto &entry) { return entry.second == itr->type; });
 
-		for (int i = 0; i < sizeof(ColumnData) / sizeof(ColumnData[0]); i++)
-		{
-			if (ColumnData[i].type == itr->type)
-			{
-				pszColumnSaveName = ColumnData[i].szName;
-				break;
-			}
-		}
+		// Column names are plain ASCII, so they can be widened directly.
+		std::wstring columnName(columnSaveName->first.begin(), columnSaveName->first.end());
 
-		NXMLSettings::AddAttributeToNode(pXMLDom, pColumnNode.get(), pszColumnSaveName,
+		NXMLSettings::AddAttributeToNode(pXMLDom, pColumnNode.get(), columnName.c_str(),
 			NXMLSettings::EncodeBoolValue(itr->bChecked));
 
-		TCHAR szWidth[32];
-		StringCchPrintf(szWidth, SIZEOF_ARRAY(szWidth), _T("%s_Width"), pszColumnSaveName);
-		NXMLSettings::AddAttributeToNode(pXMLDom, pColumnNode.get(), szWidth,
+		std::wstring widthAttributeName =
+			columnName + std::wstring(COLUMN_WIDTH_SUFFIX.begin(), COLUMN_WIDTH_SUFFIX.end());
+		NXMLSettings::AddAttributeToNode(pXMLDom, pColumnNode.get(), widthAttributeName.c_str(),
 			NXMLSettings::EncodeIntValue(itr->iWidth));
 	}
 }
@@ -1301,81 +1372,61 @@ void Explorerplusplus::SaveWindowPositionToXMLInternal(IXMLDOMDocument *pXMLDom,
 		NXMLSettings::EncodeIntValue(wndpl.rcNormalPosition.bottom));
 }
 
-void Explorerplusplus::LoadToolbarInformationFromXML(IXMLDOMDocument *pXMLDom)
+void Explorerplusplus::LoadToolbarInformationFromXML(std::string_view xmlData)
 {
-	if (!pXMLDom)
+	auto parser = XmlPullParser::OpenTopLevelElement(xmlData, "Toolbars");
+
+	if (!parser)
 	{
 		return;
 	}
 
-	wil::com_ptr_nothrow<IXMLDOMNodeList> pNodes;
-	auto bstr = wil::make_bstr_nothrow(L"//Toolbars/*");
-	pXMLDom->selectNodes(bstr.get(), &pNodes);
+	size_t toolbarsDepth = parser->GetDepth();
+	size_t i = 0;
 
-	if (!pNodes)
+	while (parser->NextChildElement(toolbarsDepth) && i < SIZEOF_ARRAY(m_ToolbarInformation))
 	{
-		return;
-	}
+		BOOL bUseChevron = FALSE;
 
-	long length;
-	pNodes->get_length(&length);
+		if (m_ToolbarInformation[i].fStyle & RBBS_USECHEVRON)
+			bUseChevron = TRUE;
 
-	for (long i = 0; i < length; i++)
-	{
-		/* This should never fail, as the number
-		of nodes has already been counted (so
-		they must exist). */
-		wil::com_ptr_nothrow<IXMLDOMNode> pNode;
-		HRESULT hr = pNodes->get_item(i, &pNode);
+		/* For each tab, the first attribute will just be
+		a toolbar number (0,1,2...). This number can be safely
+		ignored. */
+		const auto &attributes = parser->GetAttributes();
 
-		if (SUCCEEDED(hr))
+		for (size_t j = 1; j < attributes.size(); j++)
 		{
-			wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> am;
-			hr = pNode->get_attributes(&am);
+			auto attribute = TOOLBAR_ATTRIBUTE_NAMES.Find(attributes[j].name);
 
-			if (SUCCEEDED(hr))
+			if (!attribute)
 			{
-				BOOL bUseChevron = FALSE;
-
-				if (m_ToolbarInformation[i].fStyle & RBBS_USECHEVRON)
-					bUseChevron = TRUE;
-
-				long lChildNodes;
-				am->get_length(&lChildNodes);
-
-				/* For each tab, the first attribute will just be
-				a toolbar number (0,1,2...). This number can be safely
-				ignored. */
-				for (long j = 1; j < lChildNodes; j++)
-				{
-					wil::com_ptr_nothrow<IXMLDOMNode> pChildNode;
-					am->get_item(j, &pChildNode);
-
-					wil::unique_bstr bstrName;
-					pChildNode->get_nodeName(&bstrName);
-
-					wil::unique_bstr bstrValue;
-					pChildNode->get_text(&bstrValue);
-
-					if (lstrcmp(bstrName.get(), L"id") == 0)
-					{
-						m_ToolbarInformation[i].wID = NXMLSettings::DecodeIntValue(bstrValue.get());
-					}
-					else if (lstrcmp(bstrName.get(), L"Style") == 0)
-					{
-						m_ToolbarInformation[i].fStyle =
-							NXMLSettings::DecodeIntValue(bstrValue.get());
-					}
-					else if (lstrcmp(bstrName.get(), L"Length") == 0)
-					{
-						m_ToolbarInformation[i].cx = NXMLSettings::DecodeIntValue(bstrValue.get());
-					}
-				}
-
-				if (bUseChevron)
-					m_ToolbarInformation[i].fStyle |= RBBS_USECHEVRON;
+				continue;
+			}
+
+			int value = DecodeIntAttribute(attributes[j].rawValue);
+
+			switch (*attribute)
+			{
+			case ToolbarAttribute::Id:
+				m_ToolbarInformation[i].wID = value;
+				break;
+
+			case ToolbarAttribute::Style:
+				m_ToolbarInformation[i].fStyle = value;
+				break;
+
+			case ToolbarAttribute::Length:
+				m_ToolbarInformation[i].cx = value;
+				break;
 			}
 		}
+
+		if (bUseChevron)
+			m_ToolbarInformation[i].fStyle |= RBBS_USECHEVRON;
+
+		i++;
 	}
 }
 
@@ -1434,441 +1485,383 @@ void Explorerplusplus::SaveApplicationToolbarToXML(IXMLDOMDocument *pXMLDom, IXM
 	Applications::ApplicationToolbarXmlStorage::Save(pXMLDom, pRoot, &m_applicationModel);
 }
 
-unsigned long hash_setting(unsigned char *str)
+/* Maps attribute name to their corresponding internal variable. */
+void Explorerplusplus::MapAttributeToValue(XmlPullParser &parser, std::string_view settingName)
 {
-	unsigned long hash = 5381;
-	int c;
+	auto setting = GENERIC_SETTING_NAMES.Find(settingName);
 
-	while ((c = *str++) != '\0')
+	if (!setting)
 	{
-		hash = ((hash << 5) + hash) + c;
+		return;
 	}
 
-	return hash;
-}
+	// The following settings are stored in the attributes of the setting element, rather than
+	// in its text.
+	switch (*setting)
+	{
+	case GenericSetting::DisplayCentreColor:
+		m_config->displayWindowCentreColor = NXMLSettings::ReadXMLColorData2(parser);
+		return;
 
-/* Maps attribute name to their corresponding internal variable. */
-void Explorerplusplus::MapAttributeToValue(IXMLDOMNode *pNode, WCHAR *wszName, WCHAR *wszValue)
-{
-	unsigned char szName[512];
-	unsigned long uNameHash;
+	case GenericSetting::DisplayFont:
+		m_config->displayWindowFont = NXMLSettings::ReadXMLFontData(parser);
+		return;
+
+	case GenericSetting::DisplaySurroundColor:
+		m_config->displayWindowSurroundColor = NXMLSettings::ReadXMLColorData2(parser);
+		return;
 
-	WideCharToMultiByte(CP_ACP, 0, wszName, -1, (LPSTR) szName, SIZEOF_ARRAY(szName), nullptr,
-		nullptr);
+	case GenericSetting::DisplayTextColor:
+		m_config->displayWindowTextColor = NXMLSettings::ReadXMLColorData(parser);
+		return;
 
-	uNameHash = hash_setting(szName);
+	case GenericSetting::ToolbarState:
+		MainToolbarPersistentSettings::GetInstance().LoadXMLSettings(parser);
+		return;
 
-	switch (uNameHash)
+	case GenericSetting::Position:
 	{
-	case HASH_ALLOWMULTIPLEINSTANCES:
+		WINDOWPLACEMENT wndpl;
+		BOOL bMaximized = FALSE;
+
+		const auto &attributes = parser.GetAttributes();
+
+		for (size_t j = 1; j < attributes.size(); j++)
+		{
+			std::string_view name = attributes[j].name;
+
+			if (name == "Left")
+			{
+				wndpl.rcNormalPosition.left = DecodeIntAttribute(attributes[j].rawValue);
+			}
+			else if (name == "Top")
+			{
+				wndpl.rcNormalPosition.top = DecodeIntAttribute(attributes[j].rawValue);
+			}
+			else if (name == "Right")
+			{
+				wndpl.rcNormalPosition.right = DecodeIntAttribute(attributes[j].rawValue);
+			}
+			else if (name == "Bottom")
+			{
+				wndpl.rcNormalPosition.bottom = DecodeIntAttribute(attributes[j].rawValue);
+			}
+			else if (name == "Maximized")
+			{
+				bMaximized = DecodeBoolAttribute(attributes[j].rawValue);
+			}
+		}
+
+		wndpl.length = sizeof(WINDOWPLACEMENT);
+		wndpl.showCmd = SW_HIDE;
+
+		if (bMaximized)
+		{
+			wndpl.showCmd |= SW_MAXIMIZE;
+		}
+
+		SetWindowPlacement(m_hContainer, &wndpl);
+	}
+		return;
+
+	default:
+		break;
+	}
+
+	auto value = parser.ReadElementText();
+
+	if (!value)
+	{
+		return;
+	}
+
+	const WCHAR *wszValue = value->c_str();
+
+	switch (*setting)
+	{
+	case GenericSetting::AllowMultipleInstances:
 		m_config->allowMultipleInstances = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_ALWAYSOPENINNEWTAB:
+	case GenericSetting::AlwaysOpenInNewTab:
 		m_config->alwaysOpenNewTab = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_ALWAYSSHOWTABBAR:
+	case GenericSetting::AlwaysShowTabBar:
 		m_config->alwaysShowTabBar.set(NXMLSettings::DecodeBoolValue(wszValue));
 		break;
 
-	case HASH_AUTOARRANGEGLOBAL:
+	case GenericSetting::AutoArrangeGlobal:
 		m_config->defaultFolderSettings.autoArrange = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_CHECKBOXSELECTION:
+	case GenericSetting::CheckBoxSelection:
 		m_config->checkBoxSelection = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_CLOSEMAINWINDOWONTABCLOSE:
+	case GenericSetting::CloseMainWindowOnTabClose:
 		m_config->closeMainWindowOnTabClose = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_CONFIRMCLOSETABS:
+	case GenericSetting::ConfirmCloseTabs:
 		m_config->confirmCloseTabs = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_DISABLEFOLDERSIZENETWORKREMOVABLE:
+	case GenericSetting::DisableFolderSizesNetworkRemovable:
 		m_config->globalFolderSettings.disableFolderSizesNetworkRemovable =
 			NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_DISPLAYCENTRECOLOR:
-		m_config->displayWindowCentreColor = NXMLSettings::ReadXMLColorData2(pNode);
-		break;
-
-	case HASH_DISPLAYFONT:
-		m_config->displayWindowFont = NXMLSettings::ReadXMLFontData(pNode);
-		break;
-
-	case HASH_DISPLAYSURROUNDCOLOR:
-		m_config->displayWindowSurroundColor = NXMLSettings::ReadXMLColorData2(pNode);
-		break;
-
-	case HASH_DISPLAYTEXTCOLOR:
-		m_config->displayWindowTextColor = NXMLSettings::ReadXMLColorData(pNode);
-		break;
-
-	case HASH_DISPLAYWINDOWWIDTH:
+	case GenericSetting::DisplayWindowWidth:
 		m_config->displayWindowWidth = NXMLSettings::DecodeIntValue(wszValue);
 		break;
 
-	case HASH_DISPLAYWINDOWHEIGHT:
+	case GenericSetting::DisplayWindowHeight:
 		m_config->displayWindowHeight = NXMLSettings::DecodeIntValue(wszValue);
 		break;
 
-	case HASH_DISPLAYWINDOWVERTICAL:
+	case GenericSetting::DisplayWindowVertical:
 		m_config->displayWindowVertical = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_DOUBLECLICKTABCLOSE:
+	case GenericSetting::DoubleClickTabClose:
 		m_config->doubleClickTabClose = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_EXTENDTABCONTROL:
+	case GenericSetting::ExtendTabControl:
 		m_config->extendTabControl.set(NXMLSettings::DecodeBoolValue(wszValue));
 		break;
 
-	case HASH_FORCESAMETABWIDTH:
+	case GenericSetting::ForceSameTabWidth:
 		m_config->forceSameTabWidth.set(NXMLSettings::DecodeBoolValue(wszValue));
 		break;
 
-	case HASH_FORCESIZE:
+	case GenericSetting::ForceSize:
 		m_config->globalFolderSettings.forceSize = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_HANDLEZIPFILES:
+	case GenericSetting::HandleZipFiles:
 		m_config->handleZipFiles = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_HIDELINKEXTENSIONGLOBAL:
+	case GenericSetting::HideLinkExtensionGlobal:
 		m_config->globalFolderSettings.hideLinkExtension = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_HIDESYSTEMFILESGLOBAL:
+	case GenericSetting::HideSystemFilesGlobal:
 		m_config->globalFolderSettings.hideSystemFiles = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_INSERTSORTED:
+	case GenericSetting::InsertSorted:
 		m_config->globalFolderSettings.insertSorted = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_LANGUAGE:
+	case GenericSetting::Language:
 		m_config->language = NXMLSettings::DecodeIntValue(wszValue);
 		m_bLanguageLoaded = true;
 		break;
 
-	case HASH_LARGETOOLBARICONS:
+	case GenericSetting::LargeToolbarIcons:
 		m_config->useLargeToolbarIcons.set(NXMLSettings::DecodeBoolValue(wszValue));
 		break;
 
-	case HASH_LASTSELECTEDTAB:
+	case GenericSetting::LastSelectedTab:
 		m_iLastSelectedTab = NXMLSettings::DecodeIntValue(wszValue);
 		break;
 
-	case HASH_LOCKTOOLBARS:
+	case GenericSetting::LockToolbars:
 		m_config->lockToolbars = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_NEXTTOCURRENT:
+	case GenericSetting::NextToCurrent:
 		m_config->openNewTabNextToCurrent = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_ONECLICKACTIVATE:
+	case GenericSetting::OneClickActivate:
 		m_config->globalFolderSettings.oneClickActivate = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_ONECLICKACTIVATEHOVERTIME:
+	case GenericSetting::OneClickActivateHoverTime:
 		m_config->globalFolderSettings.oneClickActivateHoverTime =
 			NXMLSettings::DecodeIntValue(wszValue);
 		break;
 
-	case HASH_OVERWRITEEXISTINGFILESCONFIRMATION:
+	case GenericSetting::OverwriteExistingFilesConfirmation:
 		m_config->overwriteExistingFilesConfirmation = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_REPLACEEXPLORERMODE:
+	case GenericSetting::ReplaceExplorerMode:
 		m_config->replaceExplorerMode = static_cast<DefaultFileManager::ReplaceExplorerMode>(
 			NXMLSettings::DecodeIntValue(wszValue));
 		break;
 
-	case HASH_SHOWADDRESSBAR:
+	case GenericSetting::ShowAddressBar:
 		m_config->showAddressBar = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWAPPLICATIONTOOLBAR:
+	case GenericSetting::ShowApplicationToolbar:
 		m_config->showApplicationToolbar = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWBOOKMARKSTOOLBAR:
+	case GenericSetting::ShowBookmarksToolbar:
 		m_config->showBookmarksToolbar = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWDRIVESTOOLBAR:
+	case GenericSetting::ShowDrivesToolbar:
 		m_config->showDrivesToolbar = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWDISPLAYWINDOW:
+	case GenericSetting::ShowDisplayWindow:
 		m_config->showDisplayWindow = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWEXTENSIONS:
+	case GenericSetting::ShowExtensions:
 		m_config->globalFolderSettings.showExtensions = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWFILEPREVIEWS:
+	case GenericSetting::ShowFilePreviews:
 		m_config->showFilePreviews = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWFOLDERS:
+	case GenericSetting::ShowFolders:
 		m_config->showFolders = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWFOLDERSIZES:
+	case GenericSetting::ShowFolderSizes:
 		m_config->globalFolderSettings.showFolderSizes = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWFRIENDLYDATES:
+	case GenericSetting::ShowFriendlyDates:
 		m_config->globalFolderSettings.showFriendlyDates = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWFULLTITLEPATH:
+	case GenericSetting::ShowFullTitlePath:
 		m_config->showFullTitlePath.set(NXMLSettings::DecodeBoolValue(wszValue));
 		break;
 
-	case HASH_SHOWGRIDLINESGLOBAL:
+	case GenericSetting::ShowGridlinesGlobal:
 		m_config->globalFolderSettings.showGridlines = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWHIDDENGLOBAL:
+	case GenericSetting::ShowHiddenGlobal:
 		m_config->defaultFolderSettings.showHidden = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWINFOTIPS:
+	case GenericSetting::ShowInfoTips:
 		m_config->showInfoTips = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWINGROUPSGLOBAL:
+	case GenericSetting::ShowInGroupsGlobal:
 		m_config->defaultFolderSettings.showInGroups = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWPRIVILEGETITLEBAR:
+	case GenericSetting::ShowPrivilegeLevelInTitleBar:
 		m_config->showPrivilegeLevelInTitleBar.set(NXMLSettings::DecodeBoolValue(wszValue));
 		break;
 
-	case HASH_SHOWSTATUSBAR:
+	case GenericSetting::ShowStatusBar:
 		m_config->showStatusBar = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWTABBARATBOTTOM:
+	case GenericSetting::ShowTabBarAtBottom:
 		m_config->showTabBarAtBottom.set(NXMLSettings::DecodeBoolValue(wszValue));
 		break;
 
-	case HASH_SHOWTASKBARTHUMBNAILS:
+	case GenericSetting::ShowTaskbarThumbnails:
 		m_config->showTaskbarThumbnails = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWTOOLBAR:
+	case GenericSetting::ShowToolbar:
 		m_config->showMainToolbar = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_SHOWUSERNAMETITLEBAR:
+	case GenericSetting::ShowUserNameTitleBar:
 		m_config->showUserNameInTitleBar.set(NXMLSettings::DecodeBoolValue(wszValue));
 		break;
 
-	case HASH_SIZEDISPLAYFOMRAT:
+	case GenericSetting::SizeDisplayFormat:
 		m_config->globalFolderSettings.sizeDisplayFormat =
 			static_cast<SizeDisplayFormat>(NXMLSettings::DecodeIntValue(wszValue));
 		break;
 
-	case HASH_SORTASCENDINGGLOBAL:
+	case GenericSetting::SortAscendingGlobal:
 		m_config->defaultFolderSettings.sortAscending = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_STARTUPMODE:
+	case GenericSetting::StartupMode:
 		m_config->startupMode = static_cast<StartupMode>(NXMLSettings::DecodeIntValue(wszValue));
 		break;
 
-	case HASH_SYNCHRONIZETREEVIEW:
+	case GenericSetting::SynchronizeTreeview:
 		m_config->synchronizeTreeview = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_TVAUTOEXPAND:
+	case GenericSetting::TVAutoExpandSelected:
 		m_config->treeViewAutoExpandSelected = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_USEFULLROWSELECT:
+	case GenericSetting::UseFullRowSelect:
 		m_config->useFullRowSelect = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_TOOLBARSTATE:
-		MainToolbarPersistentSettings::GetInstance().LoadXMLSettings(pNode);
-		break;
-
-	case HASH_TREEVIEWDELAYENABLED:
+	case GenericSetting::TreeViewDelayEnabled:
 		m_config->treeViewDelayEnabled = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_TREEVIEWWIDTH:
+	case GenericSetting::TreeViewWidth:
 		m_config->treeViewWidth = NXMLSettings::DecodeIntValue(wszValue);
 		break;
 
-	case HASH_VIEWMODEGLOBAL:
+	case GenericSetting::ViewModeGlobal:
 		m_config->defaultFolderSettings.viewMode =
 			ViewMode::_from_integral(NXMLSettings::DecodeIntValue(wszValue));
 		break;
 
-	case HASH_POSITION:
-	{
-		wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> am;
-		pNode->get_attributes(&am);
-
-		WINDOWPLACEMENT wndpl;
-		BOOL bMaximized = FALSE;
-
-		long lChildNodes;
-		am->get_length(&lChildNodes);
-
-		for (long j = 1; j < lChildNodes; j++)
-		{
-			wil::com_ptr_nothrow<IXMLDOMNode> pChildNode;
-			am->get_item(j, &pChildNode);
-
-			wil::unique_bstr bstrName;
-			pChildNode->get_nodeName(&bstrName);
-
-			wil::unique_bstr bstrValue;
-			pChildNode->get_text(&bstrValue);
-
-			if (lstrcmp(bstrName.get(), L"Left") == 0)
-			{
-				wndpl.rcNormalPosition.left = NXMLSettings::DecodeIntValue(bstrValue.get());
-			}
-			else if (lstrcmp(bstrName.get(), L"Top") == 0)
-			{
-				wndpl.rcNormalPosition.top = NXMLSettings::DecodeIntValue(bstrValue.get());
-			}
-			else if (lstrcmp(bstrName.get(), L"Right") == 0)
-			{
-				wndpl.rcNormalPosition.right = NXMLSettings::DecodeIntValue(bstrValue.get());
-			}
-			else if (lstrcmp(bstrName.get(), L"Bottom") == 0)
-			{
-				wndpl.rcNormalPosition.bottom = NXMLSettings::DecodeIntValue(bstrValue.get());
-			}
-			else if (lstrcmp(bstrName.get(), L"Maximized") == 0)
-			{
-				bMaximized = NXMLSettings::DecodeBoolValue(bstrValue.get());
-			}
-		}
-
-		wndpl.length = sizeof(WINDOWPLACEMENT);
-		wndpl.showCmd = SW_HIDE;
-
-		if (bMaximized)
-		{
-			wndpl.showCmd |= SW_MAXIMIZE;
-		}
-
-		SetWindowPlacement(m_hContainer, &wndpl);
-	}
-	break;
-
-	case HASH_NEWTABDIRECTORY:
+	case GenericSetting::NewTabDirectory:
 		m_config->defaultTabDirectory = wszValue;
 		break;
 
-	case HASH_INFOTIPTYPE:
+	case GenericSetting::InfoTipType:
 		m_config->infoTipType = static_cast<InfoTipType>(NXMLSettings::DecodeIntValue(wszValue));
 		break;
 
-	case HASH_ICON_THEME:
+	case GenericSetting::IconTheme:
 		m_config->iconTheme = IconTheme::_from_integral(NXMLSettings::DecodeIntValue(wszValue));
 		break;
 
-	case HASH_CHECK_PINNED_TO_NAMESPACE_TREE_PROPERTY:
+	case GenericSetting::CheckPinnedToNamespaceTreeProperty:
 		m_config->checkPinnedToNamespaceTreeProperty = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_ENABLE_DARK_MODE:
+	case GenericSetting::EnableDarkMode:
 		m_config->enableDarkMode = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_DISPLAY_MIXED_FILES_AND_FOLDERS:
+	case GenericSetting::UseBuiltInFileTransfer:
+		m_config->useBuiltInFileTransfer = NXMLSettings::DecodeBoolValue(wszValue);
+		break;
+
+	case GenericSetting::DisplayMixedFilesAndFolders:
 		m_config->globalFolderSettings.displayMixedFilesAndFolders =
 			NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_USE_NATURAL_SORT_ORDER:
+	case GenericSetting::UseNaturalSortOrder:
 		m_config->globalFolderSettings.useNaturalSortOrder =
 			NXMLSettings::DecodeBoolValue(wszValue);
 		break;
 
-	case HASH_OPEN_TABS_IN_FOREGROUND:
+	case GenericSetting::OpenTabsInForeground:
 		m_config->openTabsInForeground = NXMLSettings::DecodeBoolValue(wszValue);
 		break;
-	}
-}
 
-void Explorerplusplus::MapTabAttributeValue(WCHAR *wszName, WCHAR *wszValue,
-	TabSettings &tabSettings, FolderSettings &folderSettings)
-{
-	if (lstrcmp(wszName, L"ApplyFilter") == 0)
-	{
-		folderSettings.applyFilter = NXMLSettings::DecodeBoolValue(wszValue);
-	}
-	else if (lstrcmp(wszName, L"AutoArrange") == 0)
-	{
-		folderSettings.autoArrange = NXMLSettings::DecodeBoolValue(wszValue);
-	}
-	else if (lstrcmp(wszName, L"Filter") == 0)
-	{
-		folderSettings.filter = wszValue;
-	}
-	else if (lstrcmp(wszName, L"FilterCaseSensitive") == 0)
-	{
-		folderSettings.filterCaseSensitive = NXMLSettings::DecodeBoolValue(wszValue);
-	}
-	else if (lstrcmp(wszName, L"ShowHidden") == 0)
-	{
-		folderSettings.showHidden = NXMLSettings::DecodeBoolValue(wszValue);
-	}
-	else if (lstrcmp(wszName, L"ShowInGroups") == 0)
-	{
-		folderSettings.showInGroups = NXMLSettings::DecodeBoolValue(wszValue);
-	}
-	else if (lstrcmp(wszName, L"SortAscending") == 0)
-	{
-		folderSettings.sortAscending = NXMLSettings::DecodeBoolValue(wszValue);
-	}
-	else if (lstrcmp(wszName, L"SortMode") == 0)
-	{
-		folderSettings.sortMode = SortMode::_from_integral(NXMLSettings::DecodeIntValue(wszValue));
-	}
-	else if (lstrcmp(wszName, L"ViewMode") == 0)
-	{
-		folderSettings.viewMode = ViewMode::_from_integral(NXMLSettings::DecodeIntValue(wszValue));
-	}
-	else if (lstrcmp(wszName, L"Locked") == 0)
-	{
-		BOOL locked = NXMLSettings::DecodeBoolValue(wszValue);
-
-		if (locked)
-		{
-			tabSettings.lockState = Tab::LockState::Locked;
-		}
-	}
-	else if (lstrcmp(wszName, L"AddressLocked") == 0)
-	{
-		BOOL addressLocked = NXMLSettings::DecodeBoolValue(wszValue);
+	case GenericSetting::HibernateTabsAfterMinutes:
+		m_config->hibernateTabsAfterMinutes = NXMLSettings::DecodeIntValue(wszValue);
+		break;
 
-		if (addressLocked)
-		{
-			tabSettings.lockState = Tab::LockState::AddressLocked;
-		}
-	}
-	else if (lstrcmp(wszName, L"CustomName") == 0)
-	{
-		tabSettings.name = wszValue;
+	case GenericSetting::MaxLoadedTabs:
+		m_config->maxLoadedTabs = NXMLSettings::DecodeIntValue(wszValue);
+		break;
 	}
 }
+
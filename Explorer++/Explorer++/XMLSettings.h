@@ -4,7 +4,35 @@
 
 #pragma once
 
+#include "TabContainer.h"
+#include "ShellBrowser/FolderSettings.h"
 #include <Windows.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class MappedXmlFile;
+
+// The configuration file is stored in the same directory as the executable.
+std::wstring GetXmlConfigFilePath();
+
+// Opens the XML configuration file stored alongside the executable. Returns nullptr if the file
+// doesn't exist or can't be read.
+std::unique_ptr<MappedXmlFile> OpenXmlConfigFile();
 
 BOOL LoadWindowPositionFromXML(WINDOWPLACEMENT *pwndpl);
 BOOL LoadAllowMultipleInstancesFromXML(void);
+
+// The settings for a single tab, as saved in the configuration file.
+struct XmlTabSettings
+{
+	std::wstring directory;
+	TabSettings tabSettings;
+	FolderSettings folderSettings;
+	FolderColumns initialColumns;
+};
+
+// Reads the tabs saved in the configuration file. The columns aren't validated and the index and
+// selection state of each tab aren't set.
+std::vector<XmlTabSettings> ReadTabSettingsFromXML(std::string_view xmlData);
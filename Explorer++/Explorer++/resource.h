@@ -183,6 +183,8 @@
 #define IDS_BACKGROUND_CONTEXT_MENU_SORT_BY 366
 #define IDS_BACKGROUND_CONTEXT_MENU_GROUP_BY 367
 #define IDS_ABOUT_ARM64_BUILD           368
+#define IDD_DUPLICATEFILES              369
+#define IDD_COMPAREFOLDERS              371
 #define IDC_DEFAULTCOLUMNS_DESCRIPTION  1001
 #define IDC_COLUMNS_DESCRIPTION         1001
 #define IDC_SETTINGS_CHECK_EXTENSIONS   1002
@@ -388,6 +390,25 @@
 #define IDC_ADVANCED_OPTION_DESCRIPTION 1346
 #define IDC_DISPLAY_MIXED_FILES_AND_FOLDERS 1347
 #define IDC_USE_NATURAL_SORT_ORDER      1348
+#define IDC_SPLIT_CHECK_CREATE_CHECKSUM_FILE 1350
+#define IDC_MERGE_CHECK_VERIFY_CHECKSUMS 1352
+#define IDC_MANAGEBOOKMARKS_SEARCH      1354
+#define IDC_DUPLICATEFILES_FOLDERS      1356
+#define IDC_DUPLICATEFILES_BROWSE       1358
+#define IDC_DUPLICATEFILES_LISTVIEW     1360
+#define IDC_DUPLICATEFILES_STATUS       1362
+#define IDC_DUPLICATEFILES_ETCHEDHORZ   1364
+#define IDC_DUPLICATEFILES_FIND         1366
+#define IDC_COMPAREFOLDERS_LEFT         1368
+#define IDC_COMPAREFOLDERS_LEFT_BROWSE  1370
+#define IDC_COMPAREFOLDERS_RIGHT        1372
+#define IDC_COMPAREFOLDERS_RIGHT_BROWSE 1374
+#define IDC_COMPAREFOLDERS_CONTENTS     1376
+#define IDC_COMPAREFOLDERS_LISTVIEW     1378
+#define IDC_COMPAREFOLDERS_STATUS       1380
+#define IDC_COMPAREFOLDERS_ETCHEDHORZ   1382
+#define IDC_COMPAREFOLDERS_COMPARE      1384
+#define IDC_DESTROYFILES_PROGRESS       1386
 #define IDS_COLUMN_DESCRIPTION_NAME     2000
 #define IDS_COLUMN_DESCRIPTION_TYPE     2001
 #define IDS_COLUMN_DESCRIPTION_SIZE     2002
@@ -626,6 +647,82 @@
 #define IDS_GENERAL_TOTALFILESIZE       8215
 #define IDS_GENERAL_CALCULATING         8216
 #define IDS_TAB_CLOSE_TIP               8217
+#define IDS_SPLITFILEDIALOG_SPLITTING_SPEED 8218
+#define IDS_SPLITFILEDIALOG_OUTPUTFILEERROR 8219
+#define IDS_MERGE_FILES_INPUTFILEINVALID 8220
+#define IDS_MERGE_FILES_CHECKSUMFILEINVALID 8221
+#define IDS_MERGE_FILES_VERIFICATIONFAILED 8222
+#define IDS_SAVE_DIRECTORY_LISTING_FILE_TYPE_TEXT 8223
+#define IDS_SAVE_DIRECTORY_LISTING_FILE_TYPE_CSV 8224
+#define IDS_SAVE_DIRECTORY_LISTING_FILE_TYPE_JSON 8225
+#define IDS_SAVE_DIRECTORY_LISTING_INCLUDE_SUBFOLDERS 8226
+#define IDS_SAVE_DIRECTORY_LISTING_FAILED 8227
+#define IDS_MANAGE_BOOKMARKS_SEARCH_CUE_BANNER 8228
+#define IDS_RENAME_RECOVERY_PROMPT      8229
+#define IDS_ADVANCED_OPTION_USE_BUILT_IN_FILE_TRANSFER_NAME 8230
+#define IDS_ADVANCED_OPTION_USE_BUILT_IN_FILE_TRANSFER_DESCRIPTION 8231
+#define IDS_FILE_TRANSFER_PROGRESS      8232
+#define IDS_FILE_TRANSFER_PROGRESS_WITH_RATE 8233
+#define IDS_FILE_TRANSFER_FAILED        8234
+#define IDS_COLUMN_NAME_CRC32C          8235
+#define IDS_COLUMN_NAME_XXHASH64        8236
+#define IDS_COLUMN_NAME_SHA256          8237
+#define IDS_COLUMN_DESCRIPTION_CRC32C   8238
+#define IDS_COLUMN_DESCRIPTION_XXHASH64 8239
+#define IDS_COLUMN_DESCRIPTION_SHA256   8240
+#define IDS_DUPLICATEFILES_COLUMN_NAME  8241
+#define IDS_DUPLICATEFILES_COLUMN_FOLDER 8242
+#define IDS_DUPLICATEFILES_COLUMN_SIZE  8243
+#define IDS_DUPLICATEFILES_COLUMN_GROUP 8244
+#define IDS_DUPLICATEFILES_SCANNING     8245
+#define IDS_DUPLICATEFILES_HASHING_SAMPLES 8246
+#define IDS_DUPLICATEFILES_HASHING_CONTENTS 8247
+#define IDS_DUPLICATEFILES_FINISHED     8248
+#define IDS_DUPLICATEFILES_ERRORS       8249
+#define IDS_DUPLICATEFILES_CANCELLED    8250
+#define IDS_DUPLICATEFILES_BROWSE_TITLE 8251
+#define IDS_COMPAREFOLDERS_COLUMN_NAME  8252
+#define IDS_COMPAREFOLDERS_COLUMN_RESULT 8253
+#define IDS_COMPAREFOLDERS_COLUMN_LEFT_SIZE 8254
+#define IDS_COMPAREFOLDERS_COLUMN_LEFT_MODIFIED 8255
+#define IDS_COMPAREFOLDERS_COLUMN_RIGHT_SIZE 8256
+#define IDS_COMPAREFOLDERS_COLUMN_RIGHT_MODIFIED 8257
+#define IDS_COMPAREFOLDERS_LEFT_ONLY    8258
+#define IDS_COMPAREFOLDERS_RIGHT_ONLY   8259
+#define IDS_COMPAREFOLDERS_LEFT_NEWER   8260
+#define IDS_COMPAREFOLDERS_RIGHT_NEWER  8261
+#define IDS_COMPAREFOLDERS_CONTENTS_DIFFER 8262
+#define IDS_COMPAREFOLDERS_TYPE_DIFFERS 8263
+#define IDS_COMPAREFOLDERS_SAME         8264
+#define IDS_COMPAREFOLDERS_COMPARING    8265
+#define IDS_COMPAREFOLDERS_FINISHED     8266
+#define IDS_COMPAREFOLDERS_ERRORS       8267
+#define IDS_COMPAREFOLDERS_CANCELLED    8268
+#define IDS_COMPAREFOLDERS_INVALID_FOLDER 8269
+#define IDS_COMPAREFOLDERS_BROWSE_TITLE 8270
+#define IDS_DESTROY_FILES_ERROR         8271
+#define IDS_RENAME_ERRORS               8272
+#define IDS_RENAME_ERROR_ITEM           8273
+#define IDS_RENAME_ERROR_DUPLICATE_NAME 8274
+#define IDS_RENAME_ERROR_NAME_EXISTS    8275
+#define IDS_RENAME_ERROR_INVALID_NAME   8276
+#define IDS_RENAME_ERROR_FAILED         8277
+#define IDS_RENAME_ERRORS_MORE          8278
+#define IDS_COMPAREFOLDERS_UNKNOWN      8279
+#define IDS_SPLITFILEDIALOG_INPUTFILEEMPTY 8280
+#define IDS_FILE_TRANSFER_ERROR_ITEM    8281
+#define IDS_FILE_TRANSFER_ERROR_EXISTS  8282
+#define IDS_FILE_TRANSFER_ERROR_LINK    8283
+#define IDS_FILE_TRANSFER_ERROR_FAILED  8284
+#define IDS_FILE_TRANSFER_ERRORS_MORE   8285
+#define IDS_FILE_TRANSFER_DESTINATION_WITHIN_SOURCE 8286
+#define IDS_FILE_TRANSFER_CONFLICTS     8287
+#define IDS_FILE_TRANSFER_CONFLICT_RESUME 8288
+#define IDS_FILE_TRANSFER_CONFLICT_REPLACE 8289
+#define IDS_FILE_TRANSFER_CONFLICT_SKIP 8290
+#define IDS_FILE_TRANSFER_COPYING       8291
+#define IDS_FILE_TRANSFER_MOVING        8292
+#define IDS_SAVE_DIRECTORY_LISTING_IN_PROGRESS 8293
 #define IDM_FILE_NEWTAB                 40056
 #define IDM_FILE_CLOSETAB               40057
 #define IDM_FILE_OPENCOMMANDPROMPT      40059
@@ -817,6 +914,9 @@
 #define IDM_MB_ORGANIZE_PASTE           40541
 #define IDM_DISPLAYWINDOW_VERTICAL      40542
 #define IDM_POPUP_SHOW_COLUMNS          40543
+#define IDM_MASSRENAME_DATE             40544
+#define IDM_TOOLS_FINDDUPLICATEFILES    40546
+#define IDM_TOOLS_COMPAREFOLDERS        40548
 #define IDM_SORTBY_NAME                 50000
 #define IDM_SORTBY_SIZE                 50001
 #define IDM_SORTBY_TYPE                 50002
@@ -879,6 +979,9 @@
 #define IDM_SORTBY_MEDIA_PUBLISHER      50061
 #define IDM_SORTBY_MEDIA_WRITER         50062
 #define IDM_SORTBY_MEDIA_YEAR           50063
+#define IDM_SORTBY_CRC32C               50064
+#define IDM_SORTBY_XXHASH64             50065
+#define IDM_SORTBY_SHA256               50066
 #define IDM_GROUPBY_NAME                50100
 #define IDM_GROUPBY_SIZE                50101
 #define IDM_GROUPBY_TYPE                50102
@@ -941,6 +1044,9 @@
 #define IDM_GROUPBY_MEDIA_PUBLISHER     50161
 #define IDM_GROUPBY_MEDIA_WRITER        50162
 #define IDM_GROUPBY_MEDIA_YEAR          50163
+#define IDM_GROUPBY_CRC32C              50164
+#define IDM_GROUPBY_XXHASH64            50165
+#define IDM_GROUPBY_SHA256              50166
 #define IDM_VIEW_THUMBNAILS             60000
 #define IDM_VIEW_TILES                  60001
 #define IDM_VIEW_ICONS                  60002
@@ -954,9 +1060,9 @@
 // 
 #ifdef APSTUDIO_INVOKED
 #ifndef APSTUDIO_READONLY_SYMBOLS
-#define _APS_NEXT_RESOURCE_VALUE        329
-#define _APS_NEXT_COMMAND_VALUE         40544
-#define _APS_NEXT_CONTROL_VALUE         1349
+#define _APS_NEXT_RESOURCE_VALUE        372
+#define _APS_NEXT_COMMAND_VALUE         40549
+#define _APS_NEXT_CONTROL_VALUE         1387
 #define _APS_NEXT_SYMED_VALUE           101
 #endif
 #endif
@@ -0,0 +1,62 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "AtomicFileWriter.h"
+
+AtomicFileWriter::AtomicFileWriter(const std::wstring &path) :
+	m_path(path),
+	m_tempPath(path + L".tmp"),
+	m_committed(false)
+{
+	// Any temporary file left behind by an earlier failed write will simply be overwritten.
+	m_file.reset(CreateFile(m_tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL, nullptr));
+}
+
+AtomicFileWriter::~AtomicFileWriter()
+{
+	if (m_committed || !m_file)
+	{
+		return;
+	}
+
+	m_file.reset();
+	DeleteFile(m_tempPath.c_str());
+}
+
+HANDLE AtomicFileWriter::GetHandle() const
+{
+	return m_file ? m_file.get() : INVALID_HANDLE_VALUE;
+}
+
+bool AtomicFileWriter::Commit()
+{
+	if (!m_file || m_committed)
+	{
+		return false;
+	}
+
+	// The data needs to reach the disk before the rename does. Otherwise, a crash could leave
+	// the target file pointing at incomplete data.
+	if (!FlushFileBuffers(m_file.get()))
+	{
+		return false;
+	}
+
+	m_file.reset();
+
+	BOOL res = MoveFileEx(m_tempPath.c_str(), m_path.c_str(),
+		MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+
+	if (!res)
+	{
+		DeleteFile(m_tempPath.c_str());
+		return false;
+	}
+
+	m_committed = true;
+
+	return true;
+}
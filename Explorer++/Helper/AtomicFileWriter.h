@@ -0,0 +1,36 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <wil/resource.h>
+#include <string>
+
+// Replaces the contents of a file in a way that ensures the file is never left partially written.
+// The new contents are written to a temporary file alongside the target, which then replaces the
+// target in a single rename once everything has been written. If the writer is destroyed without
+// being committed (e.g. because a write failed), the temporary file is removed and the original
+// file is left untouched.
+class AtomicFileWriter
+{
+public:
+	explicit AtomicFileWriter(const std::wstring &path);
+	~AtomicFileWriter();
+
+	AtomicFileWriter(const AtomicFileWriter &) = delete;
+	AtomicFileWriter &operator=(const AtomicFileWriter &) = delete;
+
+	// Returns INVALID_HANDLE_VALUE if the temporary file couldn't be created.
+	HANDLE GetHandle() const;
+
+	// Flushes the temporary file to disk and moves it over the target file. No further writes
+	// should be made once this has been called.
+	bool Commit();
+
+private:
+	const std::wstring m_path;
+	const std::wstring m_tempPath;
+	wil::unique_hfile m_file;
+	bool m_committed;
+};
@@ -0,0 +1,139 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "BackgroundFileSaver.h"
+#include "AtomicFileWriter.h"
+#include "BufferedFileWriter.h"
+
+BackgroundFileSaver::BackgroundFileSaver(const std::wstring &path,
+	CompletionCallback completionCallback) :
+	m_path(path),
+	m_completionCallback(completionCallback)
+{
+	m_thread = std::thread(&BackgroundFileSaver::ProcessSaves, this);
+}
+
+BackgroundFileSaver::~BackgroundFileSaver()
+{
+	{
+		std::scoped_lock lock(m_mutex);
+		m_stopping = true;
+	}
+
+	m_saveRequestedCondition.notify_one();
+	m_thread.join();
+}
+
+void BackgroundFileSaver::Save(Serializer serializer, CompletionCallback saveCallback)
+{
+	{
+		std::scoped_lock lock(m_mutex);
+		m_pendingSave = std::move(serializer);
+		m_pendingSaveCallback = std::move(saveCallback);
+	}
+
+	m_saveRequestedCondition.notify_one();
+}
+
+void BackgroundFileSaver::Flush()
+{
+	std::unique_lock lock(m_mutex);
+	m_idleCondition.wait(lock,
+		[this]
+		{
+			return !m_pendingSave && !m_saveInProgress;
+		});
+}
+
+const std::wstring &BackgroundFileSaver::GetPath() const
+{
+	return m_path;
+}
+
+void BackgroundFileSaver::ProcessSaves()
+{
+	std::unique_lock lock(m_mutex);
+
+	while (true)
+	{
+		m_saveRequestedCondition.wait(lock,
+			[this]
+			{
+				return m_pendingSave || m_stopping;
+			});
+
+		// A pending save is always written before the thread exits, so that the most recent data
+		// isn't lost when the application closes.
+		if (!m_pendingSave)
+		{
+			break;
+		}
+
+		Serializer serializer = std::move(m_pendingSave);
+		m_pendingSave = nullptr;
+		CompletionCallback saveCallback = std::move(m_pendingSaveCallback);
+		m_pendingSaveCallback = nullptr;
+		m_saveInProgress = true;
+
+		lock.unlock();
+
+		SaveResult result = PerformSave(serializer);
+
+		if (m_completionCallback)
+		{
+			m_completionCallback(result);
+		}
+
+		if (saveCallback)
+		{
+			saveCallback(result);
+		}
+
+		lock.lock();
+
+		m_saveInProgress = false;
+
+		if (!m_pendingSave)
+		{
+			m_idleCondition.notify_all();
+		}
+	}
+}
+
+BackgroundFileSaver::SaveResult BackgroundFileSaver::PerformSave(const Serializer &serializer)
+{
+	auto startTime = std::chrono::steady_clock::now();
+
+	auto getResult = [startTime](bool succeeded, size_t size)
+	{
+		auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - startTime);
+		return SaveResult{ succeeded, duration, size };
+	};
+
+	auto data = serializer();
+
+	if (!data)
+	{
+		return getResult(false, 0);
+	}
+
+	AtomicFileWriter atomicWriter(m_path);
+
+	if (atomicWriter.GetHandle() == INVALID_HANDLE_VALUE)
+	{
+		return getResult(false, data->size());
+	}
+
+	BufferedFileWriter writer(atomicWriter.GetHandle());
+	writer.Write(*data);
+
+	if (!writer.Flush())
+	{
+		return getResult(false, data->size());
+	}
+
+	return getResult(atomicWriter.Commit(), data->size());
+}
@@ -0,0 +1,77 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+// Writes a file on a background thread. Callers capture the data to be saved (typically an
+// immutable copy of some state) within a serializer, which is then run on the background thread to
+// produce the file contents. The file is written with AtomicFileWriter, so it always contains
+// either the previous or the new contents in full, even if the process is terminated mid-write.
+//
+// Saves are coalesced: if several saves are requested while an earlier one is still being written,
+// only the most recent one is written once the earlier one has finished.
+class BackgroundFileSaver
+{
+public:
+	// Returns the contents of the file, or std::nullopt if the data couldn't be serialized (in
+	// which case the file is left untouched).
+	using Serializer = std::function<std::optional<std::string>()>;
+
+	struct SaveResult
+	{
+		bool succeeded;
+
+		// The time taken to serialize and write the data.
+		std::chrono::milliseconds duration;
+
+		size_t size;
+	};
+
+	// Invoked on the background thread once each save has finished.
+	using CompletionCallback = std::function<void(const SaveResult &result)>;
+
+	explicit BackgroundFileSaver(const std::wstring &path,
+		CompletionCallback completionCallback = nullptr);
+
+	// Any save that's pending will be written before this returns.
+	~BackgroundFileSaver();
+
+	BackgroundFileSaver(const BackgroundFileSaver &) = delete;
+	BackgroundFileSaver &operator=(const BackgroundFileSaver &) = delete;
+
+	// Queues a save, replacing any earlier save that hasn't started yet. If provided, the save
+	// callback is invoked on the background thread once this particular save has finished (after
+	// the completion callback). It's not invoked if the save is replaced before it starts.
+	void Save(Serializer serializer, CompletionCallback saveCallback = nullptr);
+
+	// Blocks until all queued saves have been written.
+	void Flush();
+
+	const std::wstring &GetPath() const;
+
+private:
+	void ProcessSaves();
+	SaveResult PerformSave(const Serializer &serializer);
+
+	const std::wstring m_path;
+	const CompletionCallback m_completionCallback;
+
+	std::mutex m_mutex;
+	std::condition_variable m_saveRequestedCondition;
+	std::condition_variable m_idleCondition;
+	Serializer m_pendingSave;
+	CompletionCallback m_pendingSaveCallback;
+	bool m_saveInProgress = false;
+	bool m_stopping = false;
+
+	std::thread m_thread;
+};
@@ -0,0 +1,482 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "BatchRename.h"
+#include "StringHelper.h"
+#include <algorithm>
+#include <atomic>
+#include <cwctype>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+
+const std::string_view JOURNAL_HEADER = "Explorer++ rename journal 1";
+
+enum class ItemState
+{
+	Pending,
+	Unchanged,
+	Conflict
+};
+
+std::wstring BuildKey(const std::wstring &path)
+{
+	std::wstring key = path;
+	std::transform(key.begin(), key.end(), key.begin(),
+		[](wchar_t c)
+		{
+			return static_cast<wchar_t>(std::towlower(c));
+		});
+	return key;
+}
+
+std::wstring GetParentPath(const std::wstring &path)
+{
+	size_t separator = path.find_last_of(L'\\');
+
+	if (separator == std::wstring::npos)
+	{
+		return {};
+	}
+
+	return path.substr(0, separator);
+}
+
+// Finds a name, alongside the specified item, that isn't in use and won't be used by any item in
+// the batch.
+std::wstring GenerateTemporaryName(const std::wstring &source,
+	std::unordered_set<std::wstring> &usedKeys, const PathExistsFunction &pathExists)
+{
+	for (int i = 1;; i++)
+	{
+		std::wstring temporaryName = source + L"~" + std::to_wstring(i);
+
+		if (!usedKeys.contains(BuildKey(temporaryName)) && !pathExists(temporaryName))
+		{
+			usedKeys.insert(BuildKey(temporaryName));
+			return temporaryName;
+		}
+	}
+}
+
+void ExecuteChain(const BatchRenamePlan::Chain &chain, const RenameFunction &rename,
+	std::vector<size_t> &renamedItems)
+{
+	size_t originalNumRenamedItems = renamedItems.size();
+
+	for (size_t i = 0; i < chain.steps.size(); i++)
+	{
+		const auto &step = chain.steps[i];
+
+		if (!rename(step.source, step.destination))
+		{
+			// If an item has been moved to a temporary name, stopping here would leave it with that
+			// name, so everything done so far needs to be undone instead.
+			if (chain.usesTemporaryName)
+			{
+				for (size_t j = i; j-- > 0;)
+				{
+					rename(chain.steps[j].destination, chain.steps[j].source);
+				}
+
+				renamedItems.resize(originalNumRenamedItems);
+			}
+
+			return;
+		}
+
+		if (step.itemIndex)
+		{
+			renamedItems.push_back(*step.itemIndex);
+		}
+	}
+}
+
+}
+
+size_t BatchRenamePlan::GetNumSteps() const
+{
+	size_t numSteps = 0;
+
+	for (const auto &chains : directories)
+	{
+		for (const auto &chain : chains)
+		{
+			numSteps += chain.steps.size();
+		}
+	}
+
+	return numSteps;
+}
+
+std::vector<BatchRenamePlan::Step> BatchRenamePlan::GetSteps() const
+{
+	std::vector<Step> steps;
+	steps.reserve(GetNumSteps());
+
+	for (const auto &chains : directories)
+	{
+		for (const auto &chain : chains)
+		{
+			steps.insert(steps.end(), chain.steps.begin(), chain.steps.end());
+		}
+	}
+
+	return steps;
+}
+
+BatchRenamePlan PlanBatchRename(const std::vector<BatchRenameItem> &items,
+	const PathExistsFunction &pathExists)
+{
+	BatchRenamePlan plan;
+
+	std::vector<ItemState> states(items.size(), ItemState::Pending);
+	std::vector<std::wstring> sourceKeys(items.size());
+	std::vector<std::wstring> destinationKeys(items.size());
+	std::unordered_map<std::wstring, size_t> sourceIndexes;
+	std::unordered_map<std::wstring, std::vector<size_t>> destinationIndexes;
+
+	// Conflicting items will keep their current names, which means that any other item that
+	// was going to use one of those names can't be renamed either.
+	std::vector<size_t> unmovedItems;
+
+	auto addConflict = [&](size_t index, BatchRenameConflictReason reason)
+	{
+		states[index] = ItemState::Conflict;
+		plan.conflicts.push_back({ index, reason });
+
+		if (reason != BatchRenameConflictReason::DuplicateSource)
+		{
+			unmovedItems.push_back(index);
+		}
+	};
+
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		sourceKeys[i] = BuildKey(items[i].source);
+		destinationKeys[i] = BuildKey(items[i].destination);
+
+		if (items[i].source == items[i].destination)
+		{
+			states[i] = ItemState::Unchanged;
+			continue;
+		}
+
+		if (GetParentPath(sourceKeys[i]) != GetParentPath(destinationKeys[i]))
+		{
+			addConflict(i, BatchRenameConflictReason::DifferentDirectory);
+			continue;
+		}
+
+		if (!sourceIndexes.emplace(sourceKeys[i], i).second)
+		{
+			addConflict(i, BatchRenameConflictReason::DuplicateSource);
+			continue;
+		}
+
+		destinationIndexes[destinationKeys[i]].push_back(i);
+	}
+
+	for (const auto &[destinationKey, indexes] : destinationIndexes)
+	{
+		if (indexes.size() > 1)
+		{
+			for (size_t index : indexes)
+			{
+				addConflict(index, BatchRenameConflictReason::DuplicateDestination);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		if (states[i] == ItemState::Pending && !sourceIndexes.contains(destinationKeys[i])
+			&& pathExists(items[i].destination))
+		{
+			addConflict(i, BatchRenameConflictReason::DestinationExists);
+		}
+	}
+
+	while (!unmovedItems.empty())
+	{
+		size_t unmovedItem = unmovedItems.back();
+		unmovedItems.pop_back();
+
+		auto itr = destinationIndexes.find(sourceKeys[unmovedItem]);
+
+		if (itr == destinationIndexes.end())
+		{
+			continue;
+		}
+
+		for (size_t index : itr->second)
+		{
+			if (states[index] == ItemState::Pending)
+			{
+				addConflict(index, BatchRenameConflictReason::DestinationExists);
+			}
+		}
+	}
+
+	std::sort(plan.conflicts.begin(), plan.conflicts.end(),
+		[](const BatchRenameConflict &conflict1, const BatchRenameConflict &conflict2)
+		{
+			return conflict1.itemIndex < conflict2.itemIndex;
+		});
+
+	// Each remaining item can depend on at most one other item (the one currently using its new
+	// name) and, since the new names are unique, each item can have at most one other item
+	// depending on it. The dependencies therefore form a set of simple chains and cycles.
+	std::vector<std::optional<size_t>> dependencies(items.size());
+	std::vector<bool> hasDependent(items.size(), false);
+	std::unordered_set<std::wstring> usedKeys;
+
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		if (states[i] != ItemState::Pending)
+		{
+			continue;
+		}
+
+		usedKeys.insert(sourceKeys[i]);
+		usedKeys.insert(destinationKeys[i]);
+
+		auto itr = sourceIndexes.find(destinationKeys[i]);
+
+		// An item whose name is only changing case doesn't depend on itself.
+		if (itr != sourceIndexes.end() && itr->second != i)
+		{
+			dependencies[i] = itr->second;
+			hasDependent[itr->second] = true;
+		}
+	}
+
+	std::unordered_map<std::wstring, size_t> directoryIndexes;
+	std::vector<bool> planned(items.size(), false);
+
+	auto addChain = [&](size_t index, BatchRenamePlan::Chain chain)
+	{
+		auto [itr, inserted] =
+			directoryIndexes.try_emplace(GetParentPath(sourceKeys[index]), plan.directories.size());
+
+		if (inserted)
+		{
+			plan.directories.emplace_back();
+		}
+
+		plan.directories[itr->second].push_back(std::move(chain));
+	};
+
+	// Chains start with an item that no other item depends on. The last item in the chain is
+	// renamed first, which then frees up the name needed by the previous item, and so on.
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		if (states[i] != ItemState::Pending || hasDependent[i])
+		{
+			continue;
+		}
+
+		std::vector<size_t> chainItems;
+
+		for (std::optional<size_t> current = i; current; current = dependencies[*current])
+		{
+			chainItems.push_back(*current);
+			planned[*current] = true;
+		}
+
+		BatchRenamePlan::Chain chain;
+
+		for (auto itr = chainItems.rbegin(); itr != chainItems.rend(); ++itr)
+		{
+			chain.steps.push_back({ items[*itr].source, items[*itr].destination, *itr });
+		}
+
+		addChain(i, std::move(chain));
+	}
+
+	// Any items left over are part of a cycle. The cycle is broken by moving the first item to a
+	// temporary name, which allows the rest of the items to be renamed as they would be in a
+	// chain. The first item can then be moved to its final name.
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		if (states[i] != ItemState::Pending || planned[i])
+		{
+			continue;
+		}
+
+		std::vector<size_t> cycleItems;
+
+		for (size_t current = *dependencies[i]; current != i; current = *dependencies[current])
+		{
+			cycleItems.push_back(current);
+			planned[current] = true;
+		}
+
+		planned[i] = true;
+
+		std::wstring temporaryName = GenerateTemporaryName(items[i].source, usedKeys, pathExists);
+
+		BatchRenamePlan::Chain chain;
+		chain.usesTemporaryName = true;
+		chain.steps.push_back({ items[i].source, temporaryName, std::nullopt });
+
+		for (auto itr = cycleItems.rbegin(); itr != cycleItems.rend(); ++itr)
+		{
+			chain.steps.push_back({ items[*itr].source, items[*itr].destination, *itr });
+		}
+
+		chain.steps.push_back({ temporaryName, items[i].destination, i });
+
+		addChain(i, std::move(chain));
+	}
+
+	return plan;
+}
+
+std::vector<size_t> ExecuteBatchRename(const BatchRenamePlan &plan, const RenameFunction &rename,
+	int maxConcurrentChains)
+{
+	// Chains are independent, so they're handed out one at a time, regardless of which directory
+	// they're in. That way, a batch consisting of a single directory (which is always the case
+	// for the mass rename dialog) can still be renamed concurrently.
+	std::vector<const BatchRenamePlan::Chain *> chains;
+
+	for (const auto &directoryChains : plan.directories)
+	{
+		for (const auto &chain : directoryChains)
+		{
+			chains.push_back(&chain);
+		}
+	}
+
+	std::vector<size_t> renamedItems;
+	std::mutex renamedItemsMutex;
+	std::atomic<size_t> nextChain = 0;
+
+	auto processChains = [&]()
+	{
+		std::vector<size_t> threadRenamedItems;
+		size_t chainIndex;
+
+		while ((chainIndex = nextChain++) < chains.size())
+		{
+			ExecuteChain(*chains[chainIndex], rename, threadRenamedItems);
+		}
+
+		std::scoped_lock lock(renamedItemsMutex);
+		renamedItems.insert(renamedItems.end(), threadRenamedItems.begin(),
+			threadRenamedItems.end());
+	};
+
+	int numThreads = std::min<int>(std::max<int>(maxConcurrentChains, 1),
+		static_cast<int>(chains.size()));
+
+	// The current thread also processes chains, so one fewer thread needs to be started.
+	std::vector<std::thread> threads;
+
+	for (int i = 1; i < numThreads; i++)
+	{
+		threads.emplace_back(processChains);
+	}
+
+	processChains();
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	std::sort(renamedItems.begin(), renamedItems.end());
+
+	return renamedItems;
+}
+
+std::string SerializeBatchRenameJournal(const BatchRenamePlan &plan)
+{
+	std::string journal(JOURNAL_HEADER);
+	journal += '\n';
+
+	// Tabs and newlines can't appear in filenames, so they can be used as separators.
+	for (const auto &step : plan.GetSteps())
+	{
+		journal += wstrToUtf8Str(step.source);
+		journal += '\t';
+		journal += wstrToUtf8Str(step.destination);
+		journal += '\n';
+	}
+
+	return journal;
+}
+
+std::optional<std::vector<BatchRenamePlan::Step>> ParseBatchRenameJournal(
+	std::string_view journal)
+{
+	size_t headerEnd = journal.find('\n');
+
+	if (headerEnd == std::string_view::npos || journal.substr(0, headerEnd) != JOURNAL_HEADER)
+	{
+		return std::nullopt;
+	}
+
+	std::vector<BatchRenamePlan::Step> steps;
+	size_t lineStart = headerEnd + 1;
+
+	while (lineStart < journal.size())
+	{
+		size_t lineEnd = journal.find('\n', lineStart);
+
+		if (lineEnd == std::string_view::npos)
+		{
+			return std::nullopt;
+		}
+
+		std::string_view line = journal.substr(lineStart, lineEnd - lineStart);
+		size_t separator = line.find('\t');
+
+		if (separator == std::string_view::npos)
+		{
+			return std::nullopt;
+		}
+
+		steps.push_back({ utf8StrToWstr(std::string(line.substr(0, separator))),
+			utf8StrToWstr(std::string(line.substr(separator + 1))), std::nullopt });
+
+		lineStart = lineEnd + 1;
+	}
+
+	return steps;
+}
+
+bool RollBackBatchRename(const std::vector<BatchRenamePlan::Step> &steps,
+	const PathExistsFunction &pathExists, const RenameFunction &rename)
+{
+	bool success = true;
+
+	// Undoing the steps in reverse order means that each step sees the same set of names it did
+	// when it was originally performed. A step was performed if the source no longer exists and
+	// the destination does.
+	for (auto itr = steps.rbegin(); itr != steps.rend(); ++itr)
+	{
+		// If only the case of the name was changed, both names will always appear to exist. In
+		// that case, renaming the item back is harmless, even if the step wasn't performed.
+		bool caseChangeOnly = (BuildKey(itr->source) == BuildKey(itr->destination));
+
+		if (!caseChangeOnly && (pathExists(itr->source) || !pathExists(itr->destination)))
+		{
+			continue;
+		}
+
+		if (!rename(itr->destination, itr->source))
+		{
+			success = false;
+		}
+	}
+
+	return success;
+}
@@ -0,0 +1,114 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Renaming a set of items one by one, in the order given, can fail part way through if one of the
+// new names is still in use by another item in the set (e.g. when swapping the names of two files,
+// or when shifting a numbered sequence up by one). The functions here first work out a safe order
+// in which to perform the renames, so that each name is freed before it's reused, with a temporary
+// name used to break any cycles. Items that can't be renamed (e.g. because two items would end up
+// with the same name) are identified before anything on disk is changed.
+//
+// Paths are compared case-insensitively. Items can only be renamed within their current
+// directory.
+
+struct BatchRenameItem
+{
+	std::wstring source;
+	std::wstring destination;
+};
+
+enum class BatchRenameConflictReason
+{
+	// The source and destination are in different directories.
+	DifferentDirectory,
+
+	// The item appears more than once in the batch.
+	DuplicateSource,
+
+	// Another item in the batch is being renamed to the same name.
+	DuplicateDestination,
+
+	// An item with the new name already exists and isn't itself being renamed.
+	DestinationExists
+};
+
+struct BatchRenameConflict
+{
+	size_t itemIndex;
+	BatchRenameConflictReason reason;
+};
+
+struct BatchRenamePlan
+{
+	struct Step
+	{
+		std::wstring source;
+		std::wstring destination;
+
+		// Set if this step completes the rename of the specified item. That won't be the case for
+		// a step that moves an item to a temporary name.
+		std::optional<size_t> itemIndex;
+	};
+
+	// A sequence of renames that need to be performed in order, since each one frees up the name
+	// used by the next. The steps in different chains are independent of each other (even within
+	// the same directory), so separate chains can be executed concurrently.
+	struct Chain
+	{
+		std::vector<Step> steps;
+
+		// If a temporary name is used, the chain can only be partially completed by undoing the
+		// steps that have already been performed. Otherwise, each step leaves the items in a
+		// consistent state.
+		bool usesTemporaryName = false;
+	};
+
+	// The chains, grouped by directory.
+	std::vector<std::vector<Chain>> directories;
+
+	// Items that won't be renamed. Items that are being renamed to their existing name are
+	// neither listed here nor included in the plan.
+	std::vector<BatchRenameConflict> conflicts;
+
+	size_t GetNumSteps() const;
+	std::vector<Step> GetSteps() const;
+};
+
+using PathExistsFunction = std::function<bool(const std::wstring &path)>;
+
+// Renames the item at source to destination. Should fail if the destination already exists. May
+// be called concurrently from several threads.
+using RenameFunction =
+	std::function<bool(const std::wstring &source, const std::wstring &destination)>;
+
+BatchRenamePlan PlanBatchRename(const std::vector<BatchRenameItem> &items,
+	const PathExistsFunction &pathExists);
+
+// Performs the renames in the plan, with up to maxConcurrentChains chains being executed at once.
+// If a step fails, the remaining steps in that chain are skipped (with any steps already performed
+// being undone, if the chain uses a temporary name). Returns the indexes of the items that were
+// renamed, in ascending order.
+std::vector<size_t> ExecuteBatchRename(const BatchRenamePlan &plan, const RenameFunction &rename,
+	int maxConcurrentChains);
+
+// The journal lists each of the steps in a plan and should be written before the plan is
+// executed. If the process exits before the plan has been fully executed, the journal can then be
+// used to restore the original names.
+std::string SerializeBatchRenameJournal(const BatchRenamePlan &plan);
+std::optional<std::vector<BatchRenamePlan::Step>> ParseBatchRenameJournal(
+	std::string_view journal);
+
+// Undoes any of the steps from a journal that were performed. Which steps were performed is
+// determined by checking which names currently exist. Returns false if any of the steps couldn't
+// be undone.
+bool RollBackBatchRename(const std::vector<BatchRenamePlan::Step> &steps,
+	const PathExistsFunction &pathExists, const RenameFunction &rename);
@@ -0,0 +1,78 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "BatchedTaskQueue.h"
+
+BatchedTaskQueue::BatchedTaskQueue(Notification notification) : m_notification(notification)
+{
+}
+
+bool BatchedTaskQueue::Post(Task task)
+{
+	bool wasEmpty;
+
+	{
+		std::scoped_lock lock(m_mutex);
+
+		if (m_closed)
+		{
+			return false;
+		}
+
+		wasEmpty = m_pendingTasks.empty();
+		m_pendingTasks.push_back(std::move(task));
+	}
+
+	m_taskPostedCondition.notify_all();
+
+	if (wasEmpty && m_notification)
+	{
+		m_notification();
+	}
+
+	return true;
+}
+
+size_t BatchedTaskQueue::RunPendingTasks()
+{
+	std::vector<Task> tasks;
+
+	{
+		std::scoped_lock lock(m_mutex);
+		tasks.swap(m_pendingTasks);
+	}
+
+	for (auto &task : tasks)
+	{
+		task();
+	}
+
+	return tasks.size();
+}
+
+bool BatchedTaskQueue::WaitForTasks()
+{
+	std::unique_lock lock(m_mutex);
+	m_taskPostedCondition.wait(lock,
+		[this]
+		{
+			return !m_pendingTasks.empty() || m_closed;
+		});
+
+	return !m_closed;
+}
+
+void BatchedTaskQueue::Close()
+{
+	std::vector<Task> discardedTasks;
+
+	{
+		std::scoped_lock lock(m_mutex);
+		m_closed = true;
+		discardedTasks.swap(m_pendingTasks);
+	}
+
+	m_taskPostedCondition.notify_all();
+}
@@ -0,0 +1,51 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// A queue of tasks that can be posted from any thread, but are run on the thread that owns the
+// queue. Rather than the owner being notified about each task, it's only notified when a task is
+// added to an empty queue. Every task that has been posted by the time the owner gets around to
+// running them is then run as a single batch.
+class BatchedTaskQueue
+{
+public:
+	using Task = std::function<void()>;
+
+	// Invoked on the posting thread, when a task is added to an empty queue. The owner should then
+	// arrange for RunPendingTasks() to be called on its own thread.
+	using Notification = std::function<void()>;
+
+	explicit BatchedTaskQueue(Notification notification);
+
+	BatchedTaskQueue(const BatchedTaskQueue &) = delete;
+	BatchedTaskQueue &operator=(const BatchedTaskQueue &) = delete;
+
+	// Returns false if the queue has been closed, in which case the task is destroyed without
+	// being run.
+	bool Post(Task task);
+
+	// Runs each pending task, in the order in which they were posted, and returns the number of
+	// tasks that were run. Tasks posted while the batch is running will be run in the next batch.
+	size_t RunPendingTasks();
+
+	// Blocks until there's at least one pending task. Returns false if the queue is closed.
+	bool WaitForTasks();
+
+	// Discards any pending tasks. Once closed, tasks can no longer be posted.
+	void Close();
+
+private:
+	const Notification m_notification;
+
+	std::mutex m_mutex;
+	std::condition_variable m_taskPostedCondition;
+	std::vector<Task> m_pendingTasks;
+	bool m_closed = false;
+};
@@ -0,0 +1,129 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "BufferedFileWriter.h"
+#include <algorithm>
+
+BufferedFileWriter::BufferedFileWriter(HANDLE file, size_t bufferSize) :
+	m_file(file),
+	m_buffer(std::max<size_t>(bufferSize, 1)),
+	m_bufferUsed(0),
+	m_failed(false)
+{
+}
+
+BufferedFileWriter::~BufferedFileWriter()
+{
+	Flush();
+}
+
+void BufferedFileWriter::Write(const void *data, size_t size)
+{
+	if (m_failed)
+	{
+		return;
+	}
+
+	if (size > (m_buffer.size() - m_bufferUsed))
+	{
+		if (!Flush())
+		{
+			return;
+		}
+
+		// There's no benefit in copying data that's at least as large as the buffer, since it
+		// would immediately need to be written out anyway.
+		if (size >= m_buffer.size())
+		{
+			WriteToFile(data, size);
+			return;
+		}
+	}
+
+	std::copy_n(static_cast<const char *>(data), size, m_buffer.data() + m_bufferUsed);
+	m_bufferUsed += size;
+}
+
+void BufferedFileWriter::Write(std::string_view text)
+{
+	Write(text.data(), text.size());
+}
+
+void BufferedFileWriter::WriteUtf8(std::wstring_view text)
+{
+	if (text.empty())
+	{
+		return;
+	}
+
+	// The conversion buffer is reused between calls, so that writing a large number of short
+	// strings doesn't result in an allocation for each one.
+	int sourceLength = static_cast<int>(text.size());
+	int requiredSize =
+		WideCharToMultiByte(CP_UTF8, 0, text.data(), sourceLength, nullptr, 0, nullptr, nullptr);
+
+	if (requiredSize == 0)
+	{
+		m_failed = true;
+		return;
+	}
+
+	if (m_conversionBuffer.size() < static_cast<size_t>(requiredSize))
+	{
+		m_conversionBuffer.resize(requiredSize);
+	}
+
+	WideCharToMultiByte(CP_UTF8, 0, text.data(), sourceLength, m_conversionBuffer.data(),
+		requiredSize, nullptr, nullptr);
+
+	Write(m_conversionBuffer.data(), requiredSize);
+}
+
+bool BufferedFileWriter::Flush()
+{
+	if (m_failed)
+	{
+		return false;
+	}
+
+	if (m_bufferUsed > 0)
+	{
+		size_t bufferUsed = m_bufferUsed;
+		m_bufferUsed = 0;
+
+		return WriteToFile(m_buffer.data(), bufferUsed);
+	}
+
+	return true;
+}
+
+bool BufferedFileWriter::HasFailed() const
+{
+	return m_failed;
+}
+
+bool BufferedFileWriter::WriteToFile(const void *data, size_t size)
+{
+	auto *currentData = static_cast<const BYTE *>(data);
+
+	while (size > 0)
+	{
+		auto chunkSize = static_cast<DWORD>(std::min<size_t>(size, MAXDWORD));
+
+		DWORD numBytesWritten;
+		BOOL res = WriteFile(m_file, currentData, chunkSize, &numBytesWritten, nullptr);
+
+		if (!res || numBytesWritten != chunkSize)
+		{
+			m_failed = true;
+			return false;
+		}
+
+		currentData += chunkSize;
+		size -= chunkSize;
+	}
+
+	return true;
+}
@@ -0,0 +1,46 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Accumulates small writes in a fixed-size buffer, so that data can be written out as it's
+// generated without either holding all of it in memory or issuing a WriteFile call for each
+// piece. Once a write has failed, all further writes are ignored and HasFailed() returns true.
+class BufferedFileWriter
+{
+public:
+	static const size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+	// The file handle isn't owned by this class and needs to remain valid for the lifetime of
+	// the writer.
+	explicit BufferedFileWriter(HANDLE file, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+	~BufferedFileWriter();
+
+	BufferedFileWriter(const BufferedFileWriter &) = delete;
+	BufferedFileWriter &operator=(const BufferedFileWriter &) = delete;
+
+	void Write(const void *data, size_t size);
+	void Write(std::string_view text);
+
+	// Converts the text to UTF-8 before writing it.
+	void WriteUtf8(std::wstring_view text);
+
+	// Writes out any buffered data. Returns false if any write (including earlier writes) failed.
+	bool Flush();
+
+	bool HasFailed() const;
+
+private:
+	bool WriteToFile(const void *data, size_t size);
+
+	const HANDLE m_file;
+	std::vector<char> m_buffer;
+	size_t m_bufferUsed;
+	std::string m_conversionBuffer;
+	bool m_failed;
+};
@@ -19,3 +19,8 @@ bool BulkClipboardWriter::WriteCustomData(UINT format, const std::string &data)
 {
 	return m_clipboard.WriteCustomData(format, data);
 }
+
+bool BulkClipboardWriter::WriteCustomData(UINT format, wil::unique_hglobal global)
+{
+	return m_clipboard.WriteCustomData(format, std::move(global));
+}
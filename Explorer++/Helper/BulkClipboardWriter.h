@@ -21,6 +21,7 @@ public:
 
 	bool WriteText(const std::wstring &str);
 	bool WriteCustomData(UINT format, const std::string &data);
+	bool WriteCustomData(UINT format, wil::unique_hglobal global);
 
 private:
 	Clipboard m_clipboard;
@@ -0,0 +1,89 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "ChecksumManifest.h"
+#include "StringHelper.h"
+#include <fstream>
+
+namespace ChecksumManifest
+{
+
+bool Write(const std::wstring &path, const std::vector<Entry> &entries)
+{
+	std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	for (const auto &entry : entries)
+	{
+		// The asterisk indicates that the checksum was generated in binary mode.
+		stream << entry.checksum << " *" << wstrToUtf8Str(entry.filename) << "\n";
+	}
+
+	stream.flush();
+
+	return stream.good();
+}
+
+std::optional<std::vector<Entry>> Read(const std::wstring &path)
+{
+	std::ifstream stream(path, std::ios::binary);
+
+	if (!stream)
+	{
+		return std::nullopt;
+	}
+
+	std::vector<Entry> entries;
+	std::string line;
+
+	while (std::getline(stream, line))
+	{
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.pop_back();
+		}
+
+		if (line.empty())
+		{
+			continue;
+		}
+
+		auto separator = line.find(' ');
+
+		if (separator == std::string::npos || separator + 1 >= line.size())
+		{
+			return std::nullopt;
+		}
+
+		Entry entry;
+		entry.checksum = line.substr(0, separator);
+
+		// The filename is preceded either by a second space (text mode) or an asterisk (binary
+		// mode). Both are accepted here.
+		size_t filenameStart = separator + 1;
+
+		if (line[filenameStart] == ' ' || line[filenameStart] == '*')
+		{
+			filenameStart++;
+		}
+
+		entry.filename = utf8StrToWstr(line.substr(filenameStart));
+
+		if (entry.checksum.empty() || entry.filename.empty())
+		{
+			return std::nullopt;
+		}
+
+		entries.push_back(entry);
+	}
+
+	return entries;
+}
+
+}
@@ -0,0 +1,28 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+// Reads and writes checksum manifests. The format used is the same as that used by tools like
+// sha256sum (i.e. one "<hex digest> *<filename>" line per file), so a manifest can also be
+// verified externally.
+namespace ChecksumManifest
+{
+
+struct Entry
+{
+	std::wstring filename;
+	std::string checksum;
+};
+
+inline const wchar_t FILE_EXTENSION[] = L".sha256";
+
+bool Write(const std::wstring &path, const std::vector<Entry> &entries);
+std::optional<std::vector<Entry>> Read(const std::wstring &path);
+
+}
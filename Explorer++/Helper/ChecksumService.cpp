@@ -0,0 +1,330 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "ChecksumService.h"
+#include "Crc32cHasher.h"
+#include "Sha256Hasher.h"
+#include "XxHash64Hasher.h"
+#include <fstream>
+#include <type_traits>
+
+namespace
+{
+
+const size_t READ_BUFFER_SIZE = 1024 * 1024;
+
+template <typename Hasher>
+std::optional<std::string> HashStream(Hasher &hasher, std::istream &stream,
+	std::vector<char> &buffer, const std::atomic<bool> *stop)
+{
+	while (stream)
+	{
+		if (stop && *stop)
+		{
+			return std::nullopt;
+		}
+
+		stream.read(buffer.data(), buffer.size());
+		auto amountRead = static_cast<size_t>(stream.gcount());
+
+		if (amountRead == 0)
+		{
+			break;
+		}
+
+		auto *data = reinterpret_cast<const BYTE *>(buffer.data());
+
+		// Unlike the other hashers, the SHA-256 hasher relies on the system's cryptography
+		// provider, which can fail.
+		if constexpr (std::is_same_v<decltype(hasher.Update(data, amountRead)), bool>)
+		{
+			if (!hasher.Update(data, amountRead))
+			{
+				return std::nullopt;
+			}
+		}
+		else
+		{
+			hasher.Update(data, amountRead);
+		}
+	}
+
+	if (stream.bad())
+	{
+		return std::nullopt;
+	}
+
+	return hasher.Finish();
+}
+
+}
+
+std::optional<std::string> CalculateFileChecksum(const std::filesystem::path &path,
+	ChecksumAlgorithm algorithm, std::vector<char> &buffer, const std::atomic<bool> *stop)
+{
+	if (buffer.size() < READ_BUFFER_SIZE)
+	{
+		buffer.resize(READ_BUFFER_SIZE);
+	}
+
+	std::ifstream stream;
+
+	// The data is already being read in large blocks, so there's no need for the stream to buffer
+	// it as well.
+	stream.rdbuf()->pubsetbuf(nullptr, 0);
+	stream.open(path, std::ios::binary);
+
+	if (!stream)
+	{
+		return std::nullopt;
+	}
+
+	switch (algorithm)
+	{
+	case ChecksumAlgorithm::Crc32c:
+	{
+		Crc32cHasher hasher;
+		return HashStream(hasher, stream, buffer, stop);
+	}
+
+	case ChecksumAlgorithm::XxHash64:
+	{
+		XxHash64Hasher hasher;
+		return HashStream(hasher, stream, buffer, stop);
+	}
+
+	case ChecksumAlgorithm::Sha256:
+	{
+		Sha256Hasher hasher;
+		return HashStream(hasher, stream, buffer, stop);
+	}
+	}
+
+	return std::nullopt;
+}
+
+size_t ChecksumService::KeyHash::operator()(const Key &key) const
+{
+	size_t hash = std::hash<std::wstring>()(key.path);
+	hash = hash * 31 + std::hash<std::uintmax_t>()(key.size);
+	hash = hash * 31 + std::hash<std::int64_t>()(key.modificationTime);
+	hash = hash * 31 + static_cast<size_t>(key.algorithm);
+	return hash;
+}
+
+ChecksumService::ChecksumService(int numThreads, size_t maxCachedChecksums) :
+	m_maxCachedChecksums(maxCachedChecksums)
+{
+	for (int i = 0; i < numThreads; i++)
+	{
+		m_threads.emplace_back(&ChecksumService::ProcessRequests, this);
+	}
+}
+
+ChecksumService::~ChecksumService()
+{
+	{
+		std::scoped_lock lock(m_mutex);
+		m_stop = true;
+	}
+
+	m_requestAvailable.notify_all();
+
+	for (auto &thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+ChecksumService::Key ChecksumService::BuildKey(const File &file, ChecksumAlgorithm algorithm)
+{
+	return { file.path.wstring(), file.size, file.modificationTime, algorithm };
+}
+
+std::optional<std::string> ChecksumService::GetCachedChecksum(const File &file,
+	ChecksumAlgorithm algorithm)
+{
+	std::scoped_lock lock(m_mutex);
+
+	auto itr = m_cacheByKey.find(BuildKey(file, algorithm));
+
+	if (itr == m_cacheByKey.end())
+	{
+		return std::nullopt;
+	}
+
+	m_cache.splice(m_cache.begin(), m_cache, itr->second);
+
+	return itr->second->second;
+}
+
+std::vector<std::optional<std::string>> ChecksumService::GetCachedChecksums(
+	const std::vector<File> &files, ChecksumAlgorithm algorithm)
+{
+	std::vector<std::optional<std::string>> checksums;
+	checksums.reserve(files.size());
+
+	std::scoped_lock lock(m_mutex);
+
+	for (const auto &file : files)
+	{
+		auto itr = m_cacheByKey.find(BuildKey(file, algorithm));
+
+		if (itr == m_cacheByKey.end())
+		{
+			checksums.emplace_back();
+			continue;
+		}
+
+		checksums.emplace_back(itr->second->second);
+	}
+
+	return checksums;
+}
+
+void ChecksumService::QueueChecksum(const File &file, ChecksumAlgorithm algorithm, int groupId,
+	Callback callback)
+{
+	auto key = BuildKey(file, algorithm);
+
+	{
+		std::scoped_lock lock(m_mutex);
+
+		auto activeItr = m_activeRequests.find(key);
+
+		if (activeItr != m_activeRequests.end())
+		{
+			activeItr->second.emplace_back(groupId, std::move(callback));
+			return;
+		}
+
+		auto pendingItr = m_pendingRequestsByKey.find(key);
+
+		if (pendingItr != m_pendingRequestsByKey.end())
+		{
+			pendingItr->second->callbacks.emplace_back(groupId, std::move(callback));
+			m_pendingRequests.splice(m_pendingRequests.end(), m_pendingRequests,
+				pendingItr->second);
+			return;
+		}
+
+		GroupCallbacks callbacks;
+		callbacks.emplace_back(groupId, std::move(callback));
+		m_pendingRequests.push_back({ key, std::move(callbacks) });
+		m_pendingRequestsByKey.emplace(key, std::prev(m_pendingRequests.end()));
+	}
+
+	m_requestAvailable.notify_one();
+}
+
+void ChecksumService::CancelGroup(int groupId)
+{
+	std::scoped_lock lock(m_mutex);
+
+	auto isInGroup = [groupId](const auto &groupCallback)
+	{
+		return groupCallback.first == groupId;
+	};
+
+	for (auto itr = m_pendingRequests.begin(); itr != m_pendingRequests.end();)
+	{
+		std::erase_if(itr->callbacks, isInGroup);
+
+		if (itr->callbacks.empty())
+		{
+			m_pendingRequestsByKey.erase(itr->key);
+			itr = m_pendingRequests.erase(itr);
+		}
+		else
+		{
+			++itr;
+		}
+	}
+
+	for (auto &[key, callbacks] : m_activeRequests)
+	{
+		std::erase_if(callbacks, isInGroup);
+	}
+}
+
+void ChecksumService::ProcessRequests()
+{
+	std::vector<char> buffer;
+
+	while (true)
+	{
+		Key key;
+
+		{
+			std::unique_lock lock(m_mutex);
+			m_requestAvailable.wait(lock,
+				[this]
+				{
+					return m_stop || !m_pendingRequests.empty();
+				});
+
+			if (m_stop)
+			{
+				return;
+			}
+
+			auto &request = m_pendingRequests.back();
+			key = request.key;
+			m_activeRequests.emplace(key, std::move(request.callbacks));
+			m_pendingRequestsByKey.erase(key);
+			m_pendingRequests.pop_back();
+		}
+
+		auto checksum = CalculateFileChecksum(key.path, key.algorithm, buffer, &m_stop);
+
+		GroupCallbacks callbacks;
+
+		{
+			std::scoped_lock lock(m_mutex);
+
+			// The checksum will be empty if the calculation was abandoned, so it can't be passed
+			// on to the callbacks.
+			if (m_stop)
+			{
+				return;
+			}
+
+			if (checksum)
+			{
+				AddToCache(key, *checksum);
+			}
+
+			auto itr = m_activeRequests.find(key);
+			callbacks = std::move(itr->second);
+			m_activeRequests.erase(itr);
+		}
+
+		for (auto &[groupId, callback] : callbacks)
+		{
+			callback(checksum);
+		}
+	}
+}
+
+void ChecksumService::AddToCache(const Key &key, const std::string &checksum)
+{
+	auto itr = m_cacheByKey.find(key);
+
+	if (itr != m_cacheByKey.end())
+	{
+		itr->second->second = checksum;
+		m_cache.splice(m_cache.begin(), m_cache, itr->second);
+		return;
+	}
+
+	m_cache.emplace_front(key, checksum);
+	m_cacheByKey.emplace(key, m_cache.begin());
+
+	if (m_cache.size() > m_maxCachedChecksums)
+	{
+		m_cacheByKey.erase(m_cache.back().first);
+		m_cache.pop_back();
+	}
+}
@@ -0,0 +1,134 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+enum class ChecksumAlgorithm
+{
+	Crc32c,
+	XxHash64,
+	Sha256
+};
+
+// Calculates the checksum of a file, reading it sequentially through a large buffer. The buffer is
+// resized as necessary and can be reused across calls, to avoid reallocating it for each file.
+// If a stop flag is provided, it's checked before each block is read and the calculation is
+// abandoned (returning an empty result) once it's set.
+std::optional<std::string> CalculateFileChecksum(const std::filesystem::path &path,
+	ChecksumAlgorithm algorithm, std::vector<char> &buffer,
+	const std::atomic<bool> *stop = nullptr);
+
+// Calculates file checksums on a pool of background threads. Checksums are cached, keyed on each
+// file's path, size and modification time, so that a checksum is only recalculated once the file
+// changes.
+//
+// Pending requests are processed most recent first. Since a checksum is requested when an item is
+// first displayed, this means that the items currently visible are hashed ahead of those that
+// have since been scrolled out of view. Requesting a checksum that's already pending moves it to
+// the front of the queue.
+class ChecksumService
+{
+public:
+	struct File
+	{
+		std::filesystem::path path;
+		std::uintmax_t size;
+		std::int64_t modificationTime;
+	};
+
+	// Invoked on one of the service's threads. The checksum will be empty if the file couldn't be
+	// read.
+	using Callback = std::function<void(const std::optional<std::string> &checksum)>;
+
+	ChecksumService(int numThreads, size_t maxCachedChecksums);
+
+	// Any file that's being hashed is abandoned, without its callbacks being invoked, so that
+	// destroying the service doesn't have to wait on a large file being read.
+	~ChecksumService();
+
+	ChecksumService(const ChecksumService &) = delete;
+	ChecksumService &operator=(const ChecksumService &) = delete;
+
+	std::optional<std::string> GetCachedChecksum(const File &file, ChecksumAlgorithm algorithm);
+
+	// Returns the cached checksum (if any) of each file, in the same order as the files. The cache
+	// is only locked once, so this is suitable for capturing the checksums of an entire folder.
+	// Unlike GetCachedChecksum(), this doesn't count as a use of the checksums when deciding which
+	// to evict from the cache.
+	std::vector<std::optional<std::string>> GetCachedChecksums(const std::vector<File> &files,
+		ChecksumAlgorithm algorithm);
+
+	// Each request is tagged with a group ID, which allows all the requests made by a particular
+	// caller to be cancelled at once.
+	void QueueChecksum(const File &file, ChecksumAlgorithm algorithm, int groupId,
+		Callback callback);
+
+	// Removes the callbacks for every pending request in the group. Files that are already being
+	// hashed will continue to be hashed (and cached), but the callbacks won't be invoked.
+	void CancelGroup(int groupId);
+
+private:
+	struct Key
+	{
+		std::wstring path;
+		std::uintmax_t size;
+		std::int64_t modificationTime;
+		ChecksumAlgorithm algorithm;
+
+		bool operator==(const Key &) const = default;
+	};
+
+	struct KeyHash
+	{
+		size_t operator()(const Key &key) const;
+	};
+
+	using GroupCallbacks = std::vector<std::pair<int, Callback>>;
+
+	struct Request
+	{
+		Key key;
+		GroupCallbacks callbacks;
+	};
+
+	using CacheList = std::list<std::pair<Key, std::string>>;
+
+	static Key BuildKey(const File &file, ChecksumAlgorithm algorithm);
+
+	void ProcessRequests();
+	void AddToCache(const Key &key, const std::string &checksum);
+
+	const size_t m_maxCachedChecksums;
+
+	std::mutex m_mutex;
+	std::condition_variable m_requestAvailable;
+	std::atomic<bool> m_stop = false;
+
+	// The most recent request is at the back of the list.
+	std::list<Request> m_pendingRequests;
+	std::unordered_map<Key, std::list<Request>::iterator, KeyHash> m_pendingRequestsByKey;
+
+	// Maps the files that are currently being hashed to the callbacks waiting on them.
+	std::unordered_map<Key, GroupCallbacks, KeyHash> m_activeRequests;
+
+	// The most recently used checksum is at the front of the list.
+	CacheList m_cache;
+	std::unordered_map<Key, CacheList::iterator, KeyHash> m_cacheByKey;
+
+	std::vector<std::thread> m_threads;
+};
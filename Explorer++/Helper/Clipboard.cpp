@@ -46,6 +46,11 @@ std::optional<std::string> Clipboard::ReadCustomData(UINT format)
 	return ReadBinaryDataFromGlobal(clipboardData);
 }
 
+HGLOBAL Clipboard::GetCustomDataHandle(UINT format)
+{
+	return GetClipboardData(format);
+}
+
 bool Clipboard::WriteText(const std::wstring &str)
 {
 	auto global = WriteStringToGlobal(str);
@@ -70,6 +75,16 @@ bool Clipboard::WriteCustomData(UINT format, const std::string &data)
 	return WriteDataToClipboard(format, std::move(global));
 }
 
+bool Clipboard::WriteCustomData(UINT format, wil::unique_hglobal global)
+{
+	if (!global)
+	{
+		return false;
+	}
+
+	return WriteDataToClipboard(format, std::move(global));
+}
+
 bool Clipboard::WriteDataToClipboard(UINT format, wil::unique_hglobal global)
 {
 	HANDLE clipboardData = SetClipboardData(format, global.get());
@@ -17,8 +17,14 @@ public:
 	std::optional<std::wstring> ReadText();
 	std::optional<std::string> ReadCustomData(UINT format);
 
+	// Returns the clipboard's handle to the data in the specified format, which allows the data to
+	// be read in place, rather than copied. The handle remains owned by the clipboard and is only
+	// valid while this object exists.
+	HGLOBAL GetCustomDataHandle(UINT format);
+
 	bool WriteText(const std::wstring &str);
 	bool WriteCustomData(UINT format, const std::string &data);
+	bool WriteCustomData(UINT format, wil::unique_hglobal global);
 
 	bool Clear();
 
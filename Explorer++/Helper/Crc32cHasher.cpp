@@ -0,0 +1,158 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Crc32cHasher.h"
+#include <array>
+#include <cstring>
+
+#if defined(_M_X64)
+#include <intrin.h>
+#include <nmmintrin.h>
+#endif
+
+namespace
+{
+
+// The reflected form of the Castagnoli polynomial.
+const std::uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+
+using Crc32cTables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+// The first table is the standard byte-at-a-time table. Each subsequent table gives the effect of
+// a byte that's followed by an additional byte of zeroes, which allows 8 bytes to be processed
+// with independent lookups.
+constexpr Crc32cTables BuildTables()
+{
+	Crc32cTables tables = {};
+
+	for (std::uint32_t i = 0; i < 256; i++)
+	{
+		std::uint32_t crc = i;
+
+		for (int j = 0; j < 8; j++)
+		{
+			crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLYNOMIAL : 0);
+		}
+
+		tables[0][i] = crc;
+	}
+
+	for (std::uint32_t i = 0; i < 256; i++)
+	{
+		for (size_t j = 1; j < tables.size(); j++)
+		{
+			std::uint32_t previous = tables[j - 1][i];
+			tables[j][i] = (previous >> 8) ^ tables[0][previous & 0xFF];
+		}
+	}
+
+	return tables;
+}
+
+constexpr Crc32cTables CRC32C_TABLES = BuildTables();
+
+std::uint32_t UpdateCrcUsingTables(std::uint32_t crc, const BYTE *data, size_t size)
+{
+	while (size >= 8)
+	{
+		std::uint32_t low;
+		std::uint32_t high;
+		std::memcpy(&low, data, sizeof(low));
+		std::memcpy(&high, data + 4, sizeof(high));
+		low ^= crc;
+
+		crc = CRC32C_TABLES[7][low & 0xFF] ^ CRC32C_TABLES[6][(low >> 8) & 0xFF]
+			^ CRC32C_TABLES[5][(low >> 16) & 0xFF] ^ CRC32C_TABLES[4][low >> 24]
+			^ CRC32C_TABLES[3][high & 0xFF] ^ CRC32C_TABLES[2][(high >> 8) & 0xFF]
+			^ CRC32C_TABLES[1][(high >> 16) & 0xFF] ^ CRC32C_TABLES[0][high >> 24];
+
+		data += 8;
+		size -= 8;
+	}
+
+	while (size > 0)
+	{
+		crc = (crc >> 8) ^ CRC32C_TABLES[0][(crc ^ *data) & 0xFF];
+
+		data++;
+		size--;
+	}
+
+	return crc;
+}
+
+#if defined(_M_X64)
+
+bool IsCrcInstructionSupported()
+{
+	int info[4];
+	__cpuid(info, 1);
+
+	// SSE4.2 support is indicated by bit 20 of ECX.
+	return (info[2] & (1 << 20)) != 0;
+}
+
+std::uint32_t UpdateCrcUsingInstruction(std::uint32_t crc, const BYTE *data, size_t size)
+{
+	std::uint64_t crc64 = crc;
+
+	while (size >= 8)
+	{
+		std::uint64_t value;
+		std::memcpy(&value, data, sizeof(value));
+		crc64 = _mm_crc32_u64(crc64, value);
+
+		data += 8;
+		size -= 8;
+	}
+
+	crc = static_cast<std::uint32_t>(crc64);
+
+	while (size > 0)
+	{
+		crc = _mm_crc32_u8(crc, *data);
+
+		data++;
+		size--;
+	}
+
+	return crc;
+}
+
+#endif
+
+}
+
+void Crc32cHasher::Update(const BYTE *data, size_t size)
+{
+#if defined(_M_X64)
+	static const bool crcInstructionSupported = IsCrcInstructionSupported();
+
+	if (crcInstructionSupported)
+	{
+		m_crc = UpdateCrcUsingInstruction(m_crc, data, size);
+		return;
+	}
+#endif
+
+	m_crc = UpdateCrcUsingTables(m_crc, data, size);
+}
+
+std::string Crc32cHasher::Finish()
+{
+	std::uint32_t crc = ~m_crc;
+	m_crc = 0xFFFFFFFF;
+
+	static const char hexDigits[] = "0123456789abcdef";
+	std::string hexDigest;
+	hexDigest.reserve(8);
+
+	for (int shift = 28; shift >= 0; shift -= 4)
+	{
+		hexDigest.push_back(hexDigits[(crc >> shift) & 0x0F]);
+	}
+
+	return hexDigest;
+}
@@ -0,0 +1,24 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Incrementally computes a CRC-32C (Castagnoli) checksum. On processors that support SSE4.2, the
+// dedicated CRC32 instruction is used, which processes 8 bytes at a time. Otherwise, a
+// slice-by-8 table implementation is used.
+class Crc32cHasher
+{
+public:
+	void Update(const BYTE *data, size_t size);
+
+	// Returns the checksum as an 8 character lowercase hex string. Once this has been called, the
+	// hasher is reset and can be used to hash a new set of data.
+	std::string Finish();
+
+private:
+	std::uint32_t m_crc = 0xFFFFFFFF;
+};
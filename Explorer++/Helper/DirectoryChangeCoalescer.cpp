@@ -0,0 +1,290 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "DirectoryChangeCoalescer.h"
+
+void DirectoryChangeCoalescer::AddEvent(Event event, std::wstring_view name)
+{
+	if (m_rescanRequired)
+	{
+		// The directory is going to be rescanned anyway, so there's no need to track anything
+		// else.
+		return;
+	}
+
+	std::wstring nameString(name);
+
+	if (event != Event::RenamedNewName && m_pendingRenameOldName)
+	{
+		// The new name for the rename was never received, which would be the case if the item was
+		// moved out of the directory.
+		OnItemRemoved(*m_pendingRenameOldName);
+		m_pendingRenameOldName.reset();
+	}
+
+	switch (event)
+	{
+	case Event::Added:
+		OnItemAdded(nameString);
+		break;
+
+	case Event::Removed:
+		OnItemRemoved(nameString);
+		break;
+
+	case Event::Modified:
+		OnItemModified(nameString);
+		break;
+
+	case Event::RenamedOldName:
+		m_pendingRenameOldName = nameString;
+		break;
+
+	case Event::RenamedNewName:
+		if (m_pendingRenameOldName)
+		{
+			std::wstring oldName = *m_pendingRenameOldName;
+			m_pendingRenameOldName.reset();
+			OnItemRenamed(oldName, nameString);
+		}
+		else
+		{
+			// The item was moved into the directory.
+			OnItemAdded(nameString);
+		}
+		break;
+	}
+}
+
+void DirectoryChangeCoalescer::OnItemAdded(const std::wstring &name)
+{
+	if (auto index = FindByCurrentName(name))
+	{
+		// The item is already known to exist, so the best that can be done is to treat this as an
+		// update.
+		m_items[*index].modified = true;
+		return;
+	}
+
+	if (auto index = FindByOriginalName(name); index && !m_items[*index].currentName)
+	{
+		// An item that existed at the start of the window was removed and another item with the
+		// same name has now been created (which is what happens when some applications save a
+		// file). That can be treated as an update to the original item.
+		Item &item = m_items[*index];
+		item.currentName = name;
+		item.modified = true;
+		m_itemsByCurrentName[name] = *index;
+		return;
+	}
+
+	AddItem(std::nullopt, name);
+}
+
+void DirectoryChangeCoalescer::OnItemRemoved(const std::wstring &name)
+{
+	if (auto index = FindByCurrentName(name))
+	{
+		Item &item = m_items[*index];
+		m_itemsByCurrentName.erase(name);
+		item.currentName.reset();
+		item.modified = false;
+
+		if (!item.originalName)
+		{
+			item.discarded = true;
+		}
+
+		return;
+	}
+
+	if (FindByOriginalName(name))
+	{
+		// An item that existed at the start of the window was renamed or removed and this
+		// notification refers to that original name again, which means that notifications have
+		// been missed.
+		m_rescanRequired = true;
+		return;
+	}
+
+	AddItem(name, std::nullopt);
+}
+
+void DirectoryChangeCoalescer::OnItemModified(const std::wstring &name)
+{
+	if (auto index = FindByCurrentName(name))
+	{
+		m_items[*index].modified = true;
+		return;
+	}
+
+	if (FindByOriginalName(name))
+	{
+		// The item has since been renamed or removed, so there's nothing to update.
+		return;
+	}
+
+	size_t index = AddItem(name, name);
+	m_items[index].modified = true;
+}
+
+void DirectoryChangeCoalescer::OnItemRenamed(const std::wstring &oldName,
+	const std::wstring &newName)
+{
+	auto index = FindByCurrentName(oldName);
+
+	if (!index)
+	{
+		if (FindByOriginalName(oldName))
+		{
+			m_rescanRequired = true;
+			return;
+		}
+
+		index = AddItem(oldName, oldName);
+	}
+
+	if (FindByCurrentName(newName))
+	{
+		// Renaming an item over the top of an existing item should result in a removal
+		// notification for the existing item first. If that hasn't happened, notifications have
+		// been missed.
+		m_rescanRequired = true;
+		return;
+	}
+
+	// Changes are applied in the order in which the items were first seen. If the new name
+	// originally belonged to an item that was seen later, the change for that item would be
+	// applied after this rename, even though it actually happened before. For example:
+	//
+	// A -> B, C -> A
+	//
+	// is fine, but:
+	//
+	// modify A, remove B, A -> B
+	//
+	// isn't, since A would be renamed to B and then the item named B would be removed. Rather
+	// than trying to reorder the changes, the directory is simply rescanned. This should be rare.
+	if (auto originalIndex = FindByOriginalName(newName); originalIndex && *originalIndex > *index)
+	{
+		m_rescanRequired = true;
+		return;
+	}
+
+	Item &item = m_items[*index];
+	m_itemsByCurrentName.erase(oldName);
+	item.currentName = newName;
+	m_itemsByCurrentName[newName] = *index;
+}
+
+void DirectoryChangeCoalescer::OnOverflow()
+{
+	m_rescanRequired = true;
+}
+
+bool DirectoryChangeCoalescer::HasPendingChanges() const
+{
+	return m_rescanRequired || !m_items.empty() || m_pendingRenameOldName.has_value();
+}
+
+DirectoryChangeCoalescer::Batch DirectoryChangeCoalescer::TakeBatch()
+{
+	if (m_pendingRenameOldName && !m_rescanRequired)
+	{
+		OnItemRemoved(*m_pendingRenameOldName);
+		m_pendingRenameOldName.reset();
+	}
+
+	Batch batch;
+	batch.rescanRequired = m_rescanRequired;
+
+	if (!batch.rescanRequired)
+	{
+		for (const auto &item : m_items)
+		{
+			if (item.discarded)
+			{
+				continue;
+			}
+
+			if (!item.originalName)
+			{
+				batch.changes.push_back({ ChangeType::Added, *item.currentName, {} });
+			}
+			else if (!item.currentName)
+			{
+				batch.changes.push_back({ ChangeType::Removed, *item.originalName, {} });
+			}
+			else if (*item.originalName != *item.currentName)
+			{
+				// Renames result in the details of the item being updated, so there's no need to
+				// also include a separate modification.
+				batch.changes.push_back(
+					{ ChangeType::Renamed, *item.originalName, *item.currentName });
+			}
+			else if (item.modified)
+			{
+				batch.changes.push_back({ ChangeType::Modified, *item.currentName, {} });
+			}
+		}
+	}
+
+	Clear();
+
+	return batch;
+}
+
+void DirectoryChangeCoalescer::Clear()
+{
+	m_items.clear();
+	m_itemsByCurrentName.clear();
+	m_itemsByOriginalName.clear();
+	m_pendingRenameOldName.reset();
+	m_rescanRequired = false;
+}
+
+std::optional<size_t> DirectoryChangeCoalescer::FindByCurrentName(const std::wstring &name) const
+{
+	auto itr = m_itemsByCurrentName.find(name);
+
+	if (itr == m_itemsByCurrentName.end())
+	{
+		return std::nullopt;
+	}
+
+	return itr->second;
+}
+
+std::optional<size_t> DirectoryChangeCoalescer::FindByOriginalName(const std::wstring &name) const
+{
+	auto itr = m_itemsByOriginalName.find(name);
+
+	if (itr == m_itemsByOriginalName.end())
+	{
+		return std::nullopt;
+	}
+
+	return itr->second;
+}
+
+size_t DirectoryChangeCoalescer::AddItem(std::optional<std::wstring> originalName,
+	std::optional<std::wstring> currentName)
+{
+	size_t index = m_items.size();
+
+	if (originalName)
+	{
+		m_itemsByOriginalName[*originalName] = index;
+	}
+
+	if (currentName)
+	{
+		m_itemsByCurrentName[*currentName] = index;
+	}
+
+	m_items.push_back({ std::move(originalName), std::move(currentName) });
+
+	return index;
+}
@@ -0,0 +1,112 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Collects the change notifications received for a single directory and reduces them to the net
+// set of changes that need to be applied. Notifications are accumulated until TakeBatch() is
+// called, so the time window that changes are coalesced over is determined by how often the
+// caller takes a batch.
+//
+// Changes are tracked per item. For example, an item that's created, modified and then removed
+// within the same window produces no change at all, while an item that's renamed several times
+// produces a single rename.
+//
+// This class isn't thread-safe. Names are compared exactly, so items whose names only differ in
+// case are treated as separate items.
+class DirectoryChangeCoalescer
+{
+public:
+	// The notifications that can be received. These map directly to the FILE_ACTION_* values
+	// reported by ReadDirectoryChangesW().
+	enum class Event
+	{
+		Added,
+		Removed,
+		Modified,
+		RenamedOldName,
+		RenamedNewName
+	};
+
+	enum class ChangeType
+	{
+		Added,
+		Removed,
+		Modified,
+		Renamed
+	};
+
+	struct Change
+	{
+		ChangeType type;
+		std::wstring name;
+
+		// Only set for renames, in which case name refers to the original name of the item.
+		std::wstring newName;
+
+		bool operator==(const Change &) const = default;
+	};
+
+	struct Batch
+	{
+		// The changes, in the order in which they should be applied.
+		std::vector<Change> changes;
+
+		// Set if notifications were lost, or if the notifications couldn't be reduced reliably.
+		// In that case, changes will be empty and the directory should be rescanned instead.
+		bool rescanRequired = false;
+	};
+
+	void AddEvent(Event event, std::wstring_view name);
+
+	// Should be called when notifications have been lost (e.g. because the notification buffer
+	// overflowed).
+	void OnOverflow();
+
+	bool HasPendingChanges() const;
+	Batch TakeBatch();
+	void Clear();
+
+private:
+	struct Item
+	{
+		// The name of the item at the start of the window. Not set if the item was created within
+		// the window.
+		std::optional<std::wstring> originalName;
+
+		// The name of the item now. Not set if the item has been removed.
+		std::optional<std::wstring> currentName;
+
+		bool modified = false;
+
+		// Set for items that were both created and removed within the window.
+		bool discarded = false;
+	};
+
+	void OnItemAdded(const std::wstring &name);
+	void OnItemRemoved(const std::wstring &name);
+	void OnItemModified(const std::wstring &name);
+	void OnItemRenamed(const std::wstring &oldName, const std::wstring &newName);
+
+	std::optional<size_t> FindByCurrentName(const std::wstring &name) const;
+	std::optional<size_t> FindByOriginalName(const std::wstring &name) const;
+	size_t AddItem(std::optional<std::wstring> originalName,
+		std::optional<std::wstring> currentName);
+
+	std::vector<Item> m_items;
+	std::unordered_map<std::wstring, size_t> m_itemsByCurrentName;
+	std::unordered_map<std::wstring, size_t> m_itemsByOriginalName;
+
+	// Renames are reported as a pair of notifications. This holds the old name until the new name
+	// is received.
+	std::optional<std::wstring> m_pendingRenameOldName;
+
+	bool m_rescanRequired = false;
+};
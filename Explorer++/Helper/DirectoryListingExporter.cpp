@@ -0,0 +1,424 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "DirectoryListingExporter.h"
+#include "BufferedFileWriter.h"
+#include "Helper.h"
+#include "Macros.h"
+#include "StringHelper.h"
+#include <format>
+
+namespace
+{
+const char UTF8_BOM[] = "\xEF\xBB\xBF";
+
+bool IsDotDirectory(const WIN32_FIND_DATA &findData)
+{
+	return lstrcmp(findData.cFileName, L".") == 0 || lstrcmp(findData.cFileName, L"..") == 0;
+}
+
+bool IsFolder(const WIN32_FIND_DATA &findData)
+{
+	return WI_IsFlagSet(findData.dwFileAttributes, FILE_ATTRIBUTE_DIRECTORY);
+}
+
+ULONGLONG GetFileSize(const WIN32_FIND_DATA &findData)
+{
+	ULARGE_INTEGER fileSize;
+	fileSize.LowPart = findData.nFileSizeLow;
+	fileSize.HighPart = findData.nFileSizeHigh;
+	return fileSize.QuadPart;
+}
+
+std::wstring FormatIso8601Time(const FILETIME &utcFileTime)
+{
+	SYSTEMTIME systemTime;
+
+	if (!FileTimeToSystemTime(&utcFileTime, &systemTime))
+	{
+		return {};
+	}
+
+	return std::format(L"{:04}-{:02}-{:02}T{:02}:{:02}:{:02}Z", systemTime.wYear,
+		systemTime.wMonth, systemTime.wDay, systemTime.wHour, systemTime.wMinute,
+		systemTime.wSecond);
+}
+
+std::wstring FormatLocalTime(const FILETIME &utcFileTime)
+{
+	TCHAR timeString[128];
+	BOOL res = CreateFileTimeString(&utcFileTime, timeString, SIZEOF_ARRAY(timeString), FALSE);
+
+	if (!res)
+	{
+		return {};
+	}
+
+	return timeString;
+}
+
+std::wstring FormatAttributes(DWORD attributes)
+{
+	TCHAR attributeString[32];
+	HRESULT hr =
+		BuildFileAttributeString(attributes, attributeString, SIZEOF_ARRAY(attributeString));
+
+	if (FAILED(hr))
+	{
+		return {};
+	}
+
+	return attributeString;
+}
+
+std::wstring FormatSize(ULONGLONG size)
+{
+	ULARGE_INTEGER fileSize;
+	fileSize.QuadPart = size;
+
+	TCHAR sizeString[32];
+	FormatSizeString(fileSize, sizeString, SIZEOF_ARRAY(sizeString));
+
+	return sizeString;
+}
+
+// Fields only need to be quoted if they contain a delimiter, quote or line break. Any quotes
+// within a quoted field are doubled.
+void WriteCsvField(BufferedFileWriter &writer, const std::wstring &field)
+{
+	if (field.find_first_of(L",\"\r\n") == std::wstring::npos)
+	{
+		writer.WriteUtf8(field);
+		return;
+	}
+
+	std::wstring escapedField = L"\"";
+
+	for (wchar_t c : field)
+	{
+		if (c == '"')
+		{
+			escapedField += L"\"\"";
+		}
+		else
+		{
+			escapedField += c;
+		}
+	}
+
+	escapedField += L"\"";
+
+	writer.WriteUtf8(escapedField);
+}
+
+void WriteJsonString(BufferedFileWriter &writer, const std::wstring &text)
+{
+	std::wstring escapedText = L"\"";
+
+	for (wchar_t c : text)
+	{
+		switch (c)
+		{
+		case '"':
+			escapedText += L"\\\"";
+			break;
+
+		case '\\':
+			escapedText += L"\\\\";
+			break;
+
+		case '\b':
+			escapedText += L"\\b";
+			break;
+
+		case '\f':
+			escapedText += L"\\f";
+			break;
+
+		case '\n':
+			escapedText += L"\\n";
+			break;
+
+		case '\r':
+			escapedText += L"\\r";
+			break;
+
+		case '\t':
+			escapedText += L"\\t";
+			break;
+
+		default:
+			if (c < 0x20)
+			{
+				escapedText += std::format(L"\\u{:04x}", static_cast<unsigned int>(c));
+			}
+			else
+			{
+				escapedText += c;
+			}
+			break;
+		}
+	}
+
+	escapedText += L"\"";
+
+	writer.WriteUtf8(escapedText);
+}
+}
+
+DirectoryListingExporter::DirectoryListingExporter(const std::wstring &directory,
+	const Options &options) :
+	m_directory(directory),
+	m_options(options),
+	m_generatedTime{},
+	m_firstEntry(true),
+	m_cancelled(false)
+{
+}
+
+bool DirectoryListingExporter::Export(const std::wstring &outputPath)
+{
+	bool success;
+
+	{
+		wil::unique_hfile outputFile(CreateFile(outputPath.c_str(), GENERIC_WRITE, 0, nullptr,
+			CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+
+		if (!outputFile)
+		{
+			return false;
+		}
+
+		BufferedFileWriter writer(outputFile.get());
+		success = ExportInternal(writer);
+	}
+
+	if (!success)
+	{
+		DeleteFile(outputPath.c_str());
+	}
+
+	return success;
+}
+
+void DirectoryListingExporter::Cancel()
+{
+	m_cancelled = true;
+}
+
+bool DirectoryListingExporter::ExportInternal(BufferedFileWriter &writer)
+{
+	m_statistics = {};
+	m_firstEntry = true;
+	GetSystemTimeAsFileTime(&m_generatedTime);
+
+	WriteHeader(writer);
+
+	// The enumeration is depth-first, with one open find handle per level of the tree. Entries
+	// are written in the order they're returned, with the contents of each subfolder following
+	// the entry for the subfolder itself.
+	std::vector<EnumerationFrame> frames;
+	WIN32_FIND_DATA findData;
+
+	if (!OpenFrame(L"", frames, findData))
+	{
+		if (GetLastError() != ERROR_FILE_NOT_FOUND)
+		{
+			return false;
+		}
+	}
+
+	bool haveEntry = !frames.empty();
+
+	while (!frames.empty())
+	{
+		if (m_cancelled)
+		{
+			return false;
+		}
+
+		if (!haveEntry)
+		{
+			if (!FindNextFile(frames.back().findHandle.get(), &findData))
+			{
+				frames.pop_back();
+				continue;
+			}
+		}
+
+		haveEntry = false;
+
+		if (IsDotDirectory(findData))
+		{
+			continue;
+		}
+
+		std::wstring relativePath = frames.back().relativePath.empty()
+			? findData.cFileName
+			: frames.back().relativePath + L"\\" + findData.cFileName;
+
+		WriteEntry(writer, relativePath, findData);
+
+		if (writer.HasFailed())
+		{
+			return false;
+		}
+
+		if (m_options.recursive && IsFolder(findData)
+			&& WI_IsFlagClear(findData.dwFileAttributes, FILE_ATTRIBUTE_REPARSE_POINT))
+		{
+			// If the subfolder can't be opened (e.g. because access is denied), its contents
+			// will simply be left out of the listing.
+			haveEntry = OpenFrame(relativePath, frames, findData);
+		}
+	}
+
+	WriteFooter(writer);
+
+	return writer.Flush();
+}
+
+bool DirectoryListingExporter::OpenFrame(const std::wstring &relativePath,
+	std::vector<EnumerationFrame> &frames, WIN32_FIND_DATA &findData)
+{
+	std::wstring searchPath = m_directory;
+
+	if (!relativePath.empty())
+	{
+		searchPath += L"\\" + relativePath;
+	}
+
+	searchPath += L"\\*";
+
+	wil::unique_hfind findHandle(FindFirstFileEx(searchPath.c_str(), FindExInfoBasic, &findData,
+		FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH));
+
+	if (!findHandle)
+	{
+		return false;
+	}
+
+	frames.push_back({ std::move(findHandle), relativePath });
+
+	return true;
+}
+
+void DirectoryListingExporter::WriteHeader(BufferedFileWriter &writer)
+{
+	switch (m_options.format)
+	{
+	case Format::Text:
+		writer.Write(UTF8_BOM);
+		writer.WriteUtf8(std::format(L"Directory\r\n---------\r\n{}\r\n\r\n", m_directory));
+		writer.WriteUtf8(
+			std::format(L"Date\r\n----\r\n{}\r\n\r\n", FormatLocalTime(m_generatedTime)));
+		writer.Write("Entries\r\n-------\r\n");
+		break;
+
+	case Format::Csv:
+		// Without a BOM, spreadsheet applications will generally assume the file uses the
+		// system code page.
+		writer.Write(UTF8_BOM);
+		writer.Write("Path,Type,Size,Date Modified,Attributes\r\n");
+		break;
+
+	case Format::Json:
+		writer.Write("{\r\n\"directory\": ");
+		WriteJsonString(writer, m_directory);
+		writer.Write(",\r\n\"generated\": ");
+		WriteJsonString(writer, FormatIso8601Time(m_generatedTime));
+		writer.Write(",\r\n\"entries\": [");
+		break;
+	}
+}
+
+void DirectoryListingExporter::WriteEntry(BufferedFileWriter &writer,
+	const std::wstring &relativePath, const WIN32_FIND_DATA &findData)
+{
+	bool isFolder = IsFolder(findData);
+	ULONGLONG size = isFolder ? 0 : GetFileSize(findData);
+
+	if (isFolder)
+	{
+		m_statistics.numFolders++;
+	}
+	else
+	{
+		m_statistics.numFiles++;
+		m_statistics.totalSize += size;
+	}
+
+	switch (m_options.format)
+	{
+	case Format::Text:
+		writer.WriteUtf8(std::format(L"{:<24} {:<8} {:>12}  {}\r\n",
+			FormatLocalTime(findData.ftLastWriteTime), FormatAttributes(findData.dwFileAttributes),
+			isFolder ? L"<DIR>" : FormatSize(size), relativePath));
+		break;
+
+	case Format::Csv:
+		WriteCsvField(writer, relativePath);
+		writer.Write(isFolder ? ",Folder," : ",File,");
+
+		if (!isFolder)
+		{
+			writer.Write(std::to_string(size));
+		}
+
+		writer.Write(",");
+		writer.WriteUtf8(FormatIso8601Time(findData.ftLastWriteTime));
+		writer.Write(",");
+		writer.WriteUtf8(FormatAttributes(findData.dwFileAttributes));
+		writer.Write("\r\n");
+		break;
+
+	case Format::Json:
+		writer.Write(m_firstEntry ? "\r\n" : ",\r\n");
+		writer.Write("{\"path\": ");
+		WriteJsonString(writer, relativePath);
+		writer.Write(isFolder ? ", \"type\": \"folder\"" : ", \"type\": \"file\"");
+
+		if (!isFolder)
+		{
+			writer.Write(", \"size\": " + std::to_string(size));
+		}
+
+		writer.Write(", \"modified\": ");
+		WriteJsonString(writer, FormatIso8601Time(findData.ftLastWriteTime));
+		writer.Write(", \"attributes\": ");
+		WriteJsonString(writer, FormatAttributes(findData.dwFileAttributes));
+		writer.Write("}");
+		break;
+	}
+
+	m_firstEntry = false;
+}
+
+void DirectoryListingExporter::WriteFooter(BufferedFileWriter &writer)
+{
+	switch (m_options.format)
+	{
+	case Format::Text:
+		writer.WriteUtf8(std::format(L"\r\nStatistics\r\n----------\r\nNumber of folders: {}\r\n"
+									 L"Number of files: {}\r\nTotal size: {}\r\n",
+			m_statistics.numFolders, m_statistics.numFiles, FormatSize(m_statistics.totalSize)));
+		break;
+
+	case Format::Csv:
+		break;
+
+	case Format::Json:
+		writer.Write(m_firstEntry ? "],\r\n" : "\r\n],\r\n");
+		writer.Write(std::format("\"statistics\": {{\"folders\": {}, \"files\": {}, "
+								 "\"totalSize\": {}}}\r\n}}\r\n",
+			m_statistics.numFolders, m_statistics.numFiles, m_statistics.totalSize));
+		break;
+	}
+}
+
+const DirectoryListingExporter::Statistics &DirectoryListingExporter::GetStatistics() const
+{
+	return m_statistics;
+}
@@ -0,0 +1,83 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <wil/resource.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+class BufferedFileWriter;
+
+// Writes a listing of the contents of a directory to a file. Each entry is written out as soon as
+// it's enumerated, so the amount of memory used is independent of the number of entries (and, in
+// recursive mode, only proportional to the depth of the directory tree).
+class DirectoryListingExporter
+{
+public:
+	enum class Format
+	{
+		// Human-readable UTF-8 text.
+		Text,
+
+		// RFC 4180 CSV, with one row per entry.
+		Csv,
+
+		// A single JSON object, containing an array of entries.
+		Json
+	};
+
+	struct Options
+	{
+		Format format = Format::Text;
+
+		// If set, the contents of subfolders will be included as well. Reparse points (e.g.
+		// junctions) aren't followed.
+		bool recursive = false;
+	};
+
+	struct Statistics
+	{
+		ULONGLONG numFolders = 0;
+		ULONGLONG numFiles = 0;
+		ULONGLONG totalSize = 0;
+	};
+
+	DirectoryListingExporter(const std::wstring &directory, const Options &options);
+
+	// The output file will be overwritten if it already exists. If the export fails (or is
+	// cancelled), the partially written file is removed.
+	bool Export(const std::wstring &outputPath);
+
+	// Can be called from any thread.
+	void Cancel();
+
+	const Statistics &GetStatistics() const;
+
+private:
+	struct EnumerationFrame
+	{
+		wil::unique_hfind findHandle;
+
+		// The path of the directory being enumerated, relative to the root directory.
+		std::wstring relativePath;
+	};
+
+	bool ExportInternal(BufferedFileWriter &writer);
+	bool OpenFrame(const std::wstring &relativePath, std::vector<EnumerationFrame> &frames,
+		WIN32_FIND_DATA &findData);
+
+	void WriteHeader(BufferedFileWriter &writer);
+	void WriteEntry(BufferedFileWriter &writer, const std::wstring &relativePath,
+		const WIN32_FIND_DATA &findData);
+	void WriteFooter(BufferedFileWriter &writer);
+
+	const std::wstring m_directory;
+	const Options m_options;
+	Statistics m_statistics;
+	FILETIME m_generatedTime;
+	bool m_firstEntry;
+	std::atomic<bool> m_cancelled;
+};
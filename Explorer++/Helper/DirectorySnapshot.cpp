@@ -0,0 +1,82 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "DirectorySnapshot.h"
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+
+bool DirectorySnapshotDiff::IsEmpty() const
+{
+	return removed.empty() && added.empty() && modified.empty();
+}
+
+DirectorySnapshotDiff DiffDirectorySnapshots(const std::vector<DirectorySnapshotEntry> &previous,
+	const std::vector<DirectorySnapshotEntry> &current)
+{
+	DirectorySnapshotDiff diff;
+
+	size_t commonLength = std::min<size_t>(previous.size(), current.size());
+	size_t start = 0;
+
+	for (; start < commonLength; start++)
+	{
+		if (previous[start].name != current[start].name)
+		{
+			break;
+		}
+
+		if (previous[start] != current[start])
+		{
+			diff.modified.push_back(current[start].name);
+		}
+	}
+
+	if (start == previous.size() && start == current.size())
+	{
+		return diff;
+	}
+
+	// Maps the names of the remaining entries in the previous snapshot to their index. Any entries
+	// that aren't matched against an entry in the current snapshot have been removed.
+	std::unordered_map<std::wstring_view, size_t> remainingEntries;
+	remainingEntries.reserve(previous.size() - start);
+
+	for (size_t i = start; i < previous.size(); i++)
+	{
+		remainingEntries.emplace(previous[i].name, i);
+	}
+
+	std::vector<bool> matched(previous.size() - start, false);
+
+	for (size_t i = start; i < current.size(); i++)
+	{
+		const auto &entry = current[i];
+		auto itr = remainingEntries.find(entry.name);
+
+		if (itr == remainingEntries.end())
+		{
+			diff.added.push_back(entry.name);
+			continue;
+		}
+
+		if (previous[itr->second] != entry)
+		{
+			diff.modified.push_back(entry.name);
+		}
+
+		matched[itr->second - start] = true;
+	}
+
+	for (size_t i = start; i < previous.size(); i++)
+	{
+		if (!matched[i - start])
+		{
+			diff.removed.push_back(previous[i].name);
+		}
+	}
+
+	return diff;
+}
@@ -0,0 +1,44 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The details of a single item, as recorded when a directory was read. Two entries with the same
+// name are considered to refer to the same item and the item is considered to have changed if any
+// of the other details differ.
+struct DirectorySnapshotEntry
+{
+	std::wstring name;
+	uint64_t size = 0;
+	uint64_t lastWriteTime = 0;
+	uint32_t attributes = 0;
+
+	bool operator==(const DirectorySnapshotEntry &) const = default;
+};
+
+struct DirectorySnapshotDiff
+{
+	// Removed items are listed in the order they appear in the previous snapshot. Added and
+	// modified items are listed in the order they appear in the current snapshot.
+	std::vector<std::wstring> removed;
+	std::vector<std::wstring> added;
+	std::vector<std::wstring> modified;
+
+	bool IsEmpty() const;
+};
+
+// Compares two snapshots of the same directory and returns the set of changes needed to turn the
+// first into the second. Names are compared exactly and are expected to be unique within each
+// snapshot.
+//
+// Directories are typically enumerated in the same order each time, so the entries are first
+// compared pairwise and items only need to be looked up by name from the point at which the two
+// snapshots diverge. That means that comparing a large directory in which only a few items have
+// been modified costs little more than a single pass over each snapshot.
+DirectorySnapshotDiff DiffDirectorySnapshots(const std::vector<DirectorySnapshotEntry> &previous,
+	const std::vector<DirectorySnapshotEntry> &current);
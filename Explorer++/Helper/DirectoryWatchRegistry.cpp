@@ -0,0 +1,149 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "DirectoryWatchRegistry.h"
+#include <algorithm>
+#include <cwctype>
+
+DirectoryWatchRegistry::DirectoryWatchRegistry(StartWatchFunction startWatch,
+	StopWatchFunction stopWatch) :
+	m_startWatch(std::move(startWatch)),
+	m_stopWatch(std::move(stopWatch))
+{
+}
+
+DirectoryWatchRegistry::~DirectoryWatchRegistry()
+{
+	for (const auto &[watchId, watch] : m_watches)
+	{
+		m_stopWatch(watch.monitorId);
+	}
+}
+
+std::optional<int> DirectoryWatchRegistry::Subscribe(const std::wstring &path,
+	uint32_t watchFlags, bool watchSubtree, Callback callback)
+{
+	std::wstring key = BuildKey(path, watchFlags, watchSubtree);
+
+	std::scoped_lock lock(m_mutex);
+
+	int watchId;
+	auto itr = m_watchIdsByKey.find(key);
+
+	if (itr != m_watchIdsByKey.end())
+	{
+		watchId = itr->second;
+	}
+	else
+	{
+		watchId = m_nextWatchId;
+
+		auto monitorId = m_startWatch(watchId, path, watchFlags, watchSubtree);
+
+		if (!monitorId)
+		{
+			return std::nullopt;
+		}
+
+		m_nextWatchId++;
+
+		m_watches.emplace(watchId, Watch{ key, *monitorId, {} });
+		m_watchIdsByKey.emplace(std::move(key), watchId);
+	}
+
+	int subscriptionId = m_nextSubscriptionId++;
+	m_watches.at(watchId).subscriptionIds.push_back(subscriptionId);
+	m_subscriptions.emplace(subscriptionId,
+		Subscription{ watchId, std::make_shared<const Callback>(std::move(callback)) });
+
+	return subscriptionId;
+}
+
+void DirectoryWatchRegistry::Unsubscribe(int subscriptionId)
+{
+	std::scoped_lock lock(m_mutex);
+
+	auto subscriptionItr = m_subscriptions.find(subscriptionId);
+
+	if (subscriptionItr == m_subscriptions.end())
+	{
+		return;
+	}
+
+	auto watchItr = m_watches.find(subscriptionItr->second.watchId);
+	m_subscriptions.erase(subscriptionItr);
+
+	auto &subscriptionIds = watchItr->second.subscriptionIds;
+	subscriptionIds.erase(
+		std::find(subscriptionIds.begin(), subscriptionIds.end(), subscriptionId));
+
+	if (!subscriptionIds.empty())
+	{
+		return;
+	}
+
+	m_stopWatch(watchItr->second.monitorId);
+
+	m_watchIdsByKey.erase(watchItr->second.key);
+	m_watches.erase(watchItr);
+}
+
+void DirectoryWatchRegistry::OnNotification(int watchId, const std::wstring &fileName,
+	uint32_t action)
+{
+	std::vector<std::shared_ptr<const Callback>> callbacks;
+
+	{
+		std::scoped_lock lock(m_mutex);
+
+		auto itr = m_watches.find(watchId);
+
+		// The watch may have been stopped while this notification was being delivered.
+		if (itr == m_watches.end())
+		{
+			return;
+		}
+
+		callbacks.reserve(itr->second.subscriptionIds.size());
+
+		for (int subscriptionId : itr->second.subscriptionIds)
+		{
+			callbacks.push_back(m_subscriptions.at(subscriptionId).callback);
+		}
+	}
+
+	for (const auto &callback : callbacks)
+	{
+		(*callback)(fileName, action);
+	}
+}
+
+size_t DirectoryWatchRegistry::GetNumWatches() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_watches.size();
+}
+
+std::wstring DirectoryWatchRegistry::BuildKey(const std::wstring &path, uint32_t watchFlags,
+	bool watchSubtree)
+{
+	std::wstring key = path;
+
+	// C:\Folder and C:\Folder\ refer to the same directory. Root directories are left as-is.
+	if (key.size() > 3 && key.ends_with(L'\\'))
+	{
+		key.pop_back();
+	}
+
+	std::transform(key.begin(), key.end(), key.begin(),
+		[](wchar_t c)
+		{
+			return static_cast<wchar_t>(std::towlower(c));
+		});
+
+	key += L'|' + std::to_wstring(watchFlags) + L'|' + (watchSubtree ? L'1' : L'0');
+
+	return key;
+}
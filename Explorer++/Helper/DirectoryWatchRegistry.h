@@ -0,0 +1,75 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Allows multiple components to watch the same directory, while only a single underlying watch is
+// made. For example, if several tabs are open to the same folder, the folder will only be watched
+// once and each change notification will be passed on to every tab.
+//
+// A watch is shared between all subscribers that use the same path (compared case-insensitively),
+// watch flags and subtree setting. The watch is started when the first subscriber is added and
+// stopped when the last one is removed.
+//
+// This class is thread-safe. Subscriber callbacks are invoked on whichever thread notifications are
+// delivered on. Since the callbacks are invoked without any lock held, a callback may still be
+// invoked briefly after Unsubscribe() has returned.
+class DirectoryWatchRegistry
+{
+public:
+	using Callback = std::function<void(const std::wstring &fileName, uint32_t action)>;
+
+	// Starts a watch on the specified directory, returning an id that can later be passed to the
+	// StopWatchFunction, or std::nullopt on failure. Any notifications for the watch should be
+	// passed to OnNotification(), along with the watchId provided here.
+	using StartWatchFunction = std::function<std::optional<int>(int watchId,
+		const std::wstring &path, uint32_t watchFlags, bool watchSubtree)>;
+	using StopWatchFunction = std::function<void(int monitorId)>;
+
+	DirectoryWatchRegistry(StartWatchFunction startWatch, StopWatchFunction stopWatch);
+	~DirectoryWatchRegistry();
+
+	std::optional<int> Subscribe(const std::wstring &path, uint32_t watchFlags, bool watchSubtree,
+		Callback callback);
+	void Unsubscribe(int subscriptionId);
+
+	void OnNotification(int watchId, const std::wstring &fileName, uint32_t action);
+
+	size_t GetNumWatches() const;
+
+private:
+	struct Watch
+	{
+		std::wstring key;
+		int monitorId;
+		std::vector<int> subscriptionIds;
+	};
+
+	struct Subscription
+	{
+		int watchId;
+		std::shared_ptr<const Callback> callback;
+	};
+
+	static std::wstring BuildKey(const std::wstring &path, uint32_t watchFlags, bool watchSubtree);
+
+	const StartWatchFunction m_startWatch;
+	const StopWatchFunction m_stopWatch;
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<int, Watch> m_watches;
+	std::unordered_map<std::wstring, int> m_watchIdsByKey;
+	std::unordered_map<int, Subscription> m_subscriptions;
+	int m_nextWatchId = 0;
+	int m_nextSubscriptionId = 0;
+};
@@ -0,0 +1,608 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "DuplicateFinder.h"
+#include "FileSystemLinks.h"
+#include "XxHash64Hasher.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <utility>
+
+namespace
+{
+
+const size_t READ_BUFFER_SIZE = 1024 * 1024;
+
+// Hashes the next amount bytes from the stream. Fails if the stream ends early (e.g. because the
+// file was truncated after it was found).
+bool HashStreamData(std::istream &stream, std::uintmax_t amount, XxHash64Hasher &hasher,
+	std::vector<char> &buffer)
+{
+	while (amount > 0)
+	{
+		auto amountToRead = static_cast<size_t>(std::min<std::uintmax_t>(amount, buffer.size()));
+		stream.read(buffer.data(), amountToRead);
+
+		if (static_cast<size_t>(stream.gcount()) != amountToRead)
+		{
+			return false;
+		}
+
+		hasher.Update(reinterpret_cast<const BYTE *>(buffer.data()), amountToRead);
+		amount -= amountToRead;
+	}
+
+	return true;
+}
+
+}
+
+DuplicateFinder::DuplicateFinder(const Options &options) : m_options(options)
+{
+}
+
+std::vector<DuplicateFinder::Group> DuplicateFinder::Find(
+	const std::vector<std::filesystem::path> &directories)
+{
+	Scan(directories);
+
+	auto candidates = GroupBySize();
+
+	m_stage = Stage::HashingSamples;
+	candidates = GroupByHash(candidates, false);
+
+	// Files that are no larger than the sample have already been hashed in full.
+	Candidates remainingCandidates;
+	Candidates duplicates;
+
+	for (auto &candidate : candidates)
+	{
+		if (m_files[candidate[0]].size > 2 * m_options.sampleSize)
+		{
+			remainingCandidates.push_back(std::move(candidate));
+		}
+		else
+		{
+			duplicates.push_back(std::move(candidate));
+		}
+	}
+
+	m_stage = Stage::HashingContents;
+	candidates = GroupByHash(remainingCandidates, true);
+	std::move(candidates.begin(), candidates.end(), std::back_inserter(duplicates));
+
+	if (m_cancelled)
+	{
+		return {};
+	}
+
+	// Each group is stored alongside the path of its first file, which is used to order groups
+	// that take up the same amount of space.
+	std::vector<std::pair<Group, std::filesystem::path>> sortedGroups;
+	sortedGroups.reserve(duplicates.size());
+
+	for (const auto &files : duplicates)
+	{
+		std::vector<std::pair<std::filesystem::path, FileId>> sortedFiles;
+
+		for (auto file : files)
+		{
+			sortedFiles.emplace_back(GetPath(file), file);
+		}
+
+		std::sort(sortedFiles.begin(), sortedFiles.end());
+
+		Group group;
+		group.size = m_files[files[0]].size;
+
+		for (const auto &[path, file] : sortedFiles)
+		{
+			group.files.push_back(file);
+		}
+
+		sortedGroups.emplace_back(std::move(group), sortedFiles[0].first);
+	}
+
+	std::sort(sortedGroups.begin(), sortedGroups.end(),
+		[](const auto &sortedGroup1, const auto &sortedGroup2)
+		{
+			const auto &[group1, firstPath1] = sortedGroup1;
+			const auto &[group2, firstPath2] = sortedGroup2;
+			auto wastedSpace1 = group1.size * (group1.files.size() - 1);
+			auto wastedSpace2 = group2.size * (group2.files.size() - 1);
+
+			if (wastedSpace1 != wastedSpace2)
+			{
+				return wastedSpace1 > wastedSpace2;
+			}
+
+			return firstPath1 < firstPath2;
+		});
+
+	std::vector<Group> groups;
+	groups.reserve(sortedGroups.size());
+
+	for (auto &[group, firstPath] : sortedGroups)
+	{
+		groups.push_back(std::move(group));
+	}
+
+	m_stage = Stage::Complete;
+
+	return groups;
+}
+
+void DuplicateFinder::Scan(const std::vector<std::filesystem::path> &directories)
+{
+	std::vector<std::filesystem::path> canonicalDirectories;
+
+	for (const auto &directory : directories)
+	{
+		std::error_code error;
+		auto canonicalDirectory = std::filesystem::weakly_canonical(directory, error);
+
+		if (error || !std::filesystem::is_directory(canonicalDirectory, error))
+		{
+			m_numErrors++;
+			continue;
+		}
+
+		canonicalDirectories.push_back(canonicalDirectory);
+	}
+
+	// Shorter paths are considered first, so that any directory nested within another will be
+	// found to be a duplicate.
+	std::sort(canonicalDirectories.begin(), canonicalDirectories.end(),
+		[](const auto &directory1, const auto &directory2)
+		{
+			return directory1.native().size() < directory2.native().size();
+		});
+
+	struct PendingDirectory
+	{
+		DirectoryId id;
+		std::filesystem::path path;
+	};
+
+	std::deque<PendingDirectory> pendingDirectories;
+	std::vector<std::filesystem::path> roots;
+
+	for (const auto &directory : canonicalDirectories)
+	{
+		bool nested = std::any_of(roots.begin(), roots.end(),
+			[&directory](const auto &root)
+			{
+				return IsPathSameOrWithin(directory, root);
+			});
+
+		if (nested)
+		{
+			continue;
+		}
+
+		roots.push_back(directory);
+
+		auto id = static_cast<DirectoryId>(m_directories.size());
+		m_directories.push_back({ NO_PARENT, AddName(directory.native()) });
+		pendingDirectories.push_back({ id, directory });
+	}
+
+	// As with FileTransferEngine, directories are handed out one at a time, with the walk being
+	// complete once the queue is empty and no thread is still listing a directory. The contents
+	// of each directory are gathered without holding the lock and then added to the shared
+	// tables in one go.
+	std::mutex mutex;
+	std::condition_variable condition;
+	int numActiveThreads = 0;
+
+	auto walkDirectories = [&]()
+	{
+		std::vector<PathString> subdirectories;
+		std::vector<std::pair<PathString, std::uintmax_t>> files;
+
+		while (true)
+		{
+			std::unique_lock lock(mutex);
+			condition.wait(lock,
+				[&]
+				{
+					return !pendingDirectories.empty() || numActiveThreads == 0;
+				});
+
+			if (pendingDirectories.empty() || m_cancelled)
+			{
+				pendingDirectories.clear();
+				condition.notify_all();
+				return;
+			}
+
+			auto directory = std::move(pendingDirectories.front());
+			pendingDirectories.pop_front();
+			numActiveThreads++;
+			lock.unlock();
+
+			subdirectories.clear();
+			files.clear();
+			size_t numFilesFound = 0;
+
+			std::error_code error;
+			std::filesystem::directory_iterator itr(directory.path, error);
+
+			for (; !error && itr != std::filesystem::directory_iterator(); itr.increment(error))
+			{
+				const auto &entry = *itr;
+				std::error_code entryError;
+
+				if (entry.is_symlink(entryError))
+				{
+					continue;
+				}
+
+				if (entry.is_directory(entryError))
+				{
+					// Junctions and mount points aren't reported as symlinks on Windows, so they
+					// need to be checked for separately.
+					if (IsFileSystemLink(entry.path(), entryError) || entryError)
+					{
+						continue;
+					}
+
+					subdirectories.push_back(entry.path().filename().native());
+					continue;
+				}
+
+				if (!entry.is_regular_file(entryError))
+				{
+					continue;
+				}
+
+				auto size = entry.file_size(entryError);
+
+				if (entryError)
+				{
+					m_numErrors++;
+					continue;
+				}
+
+				numFilesFound++;
+
+				if (size >= m_options.minimumSize)
+				{
+					files.emplace_back(entry.path().filename().native(), size);
+				}
+			}
+
+			if (error)
+			{
+				m_numErrors++;
+			}
+
+			m_filesFound += numFilesFound;
+
+			lock.lock();
+			numActiveThreads--;
+
+			for (const auto &subdirectory : subdirectories)
+			{
+				auto id = static_cast<DirectoryId>(m_directories.size());
+				m_directories.push_back({ directory.id, AddName(subdirectory) });
+				pendingDirectories.push_back({ id, directory.path / subdirectory });
+			}
+
+			for (const auto &[name, size] : files)
+			{
+				m_files.push_back({ size, directory.id, AddName(name) });
+			}
+
+			condition.notify_all();
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	for (int i = 1; i < m_options.numThreads; i++)
+	{
+		threads.emplace_back(walkDirectories);
+	}
+
+	walkDirectories();
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+}
+
+DuplicateFinder::Candidates DuplicateFinder::GroupBySize() const
+{
+	std::vector<FileId> files(m_files.size());
+	std::iota(files.begin(), files.end(), 0);
+	std::sort(files.begin(), files.end(),
+		[this](FileId file1, FileId file2)
+		{
+			return m_files[file1].size < m_files[file2].size;
+		});
+
+	Candidates candidates;
+
+	for (auto itr = files.begin(); itr != files.end();)
+	{
+		auto end = std::find_if(itr, files.end(),
+			[this, size = m_files[*itr].size](FileId file)
+			{
+				return m_files[file].size != size;
+			});
+
+		if (std::distance(itr, end) > 1)
+		{
+			candidates.emplace_back(itr, end);
+		}
+
+		itr = end;
+	}
+
+	return candidates;
+}
+
+// Hashes every candidate file in parallel, then splits each group of candidates into smaller
+// groups of files that share a hash. Files that can't be read are dropped.
+DuplicateFinder::Candidates DuplicateFinder::GroupByHash(const Candidates &candidates,
+	bool hashContents)
+{
+	std::vector<FileId> files;
+
+	for (const auto &candidate : candidates)
+	{
+		files.insert(files.end(), candidate.begin(), candidate.end());
+	}
+
+	m_filesHashed = 0;
+	m_filesToHash = files.size();
+
+	std::vector<std::optional<std::uint64_t>> hashes(files.size());
+
+	// Hard links to the same file will always have the same contents. So that a file isn't
+	// reported as a duplicate of itself, the identity of each file is retrieved alongside its
+	// sample hash.
+	std::vector<std::optional<FileIdentity>> identities(hashContents ? 0 : files.size());
+	std::atomic<size_t> nextIndex = 0;
+
+	auto hashFiles = [&]()
+	{
+		std::vector<char> buffer(READ_BUFFER_SIZE);
+
+		while (!m_cancelled)
+		{
+			size_t index = nextIndex++;
+
+			if (index >= files.size())
+			{
+				return;
+			}
+
+			const auto &file = m_files[files[index]];
+			auto path = GetPath(files[index]);
+			hashes[index] =
+				hashContents ? HashContents(file, path, buffer) : HashSample(file, path, buffer);
+
+			if (!hashes[index])
+			{
+				m_numErrors++;
+			}
+			else if (!hashContents)
+			{
+				identities[index] = GetFileIdentity(path);
+			}
+
+			m_filesHashed++;
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	for (int i = 1; i < m_options.numThreads; i++)
+	{
+		threads.emplace_back(hashFiles);
+	}
+
+	hashFiles();
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	Candidates remainingCandidates;
+	size_t offset = 0;
+
+	for (const auto &candidate : candidates)
+	{
+		// Each file is stored alongside its index in the files vector.
+		std::vector<std::pair<std::uint64_t, size_t>> hashedFiles;
+
+		for (size_t i = offset; i < offset + candidate.size(); i++)
+		{
+			if (hashes[i])
+			{
+				hashedFiles.emplace_back(*hashes[i], i);
+			}
+		}
+
+		offset += candidate.size();
+
+		std::sort(hashedFiles.begin(), hashedFiles.end());
+
+		for (auto itr = hashedFiles.begin(); itr != hashedFiles.end();)
+		{
+			auto end = std::find_if(itr, hashedFiles.end(),
+				[hash = itr->first](const auto &hashedFile)
+				{
+					return hashedFile.first != hash;
+				});
+
+			if (std::distance(itr, end) > 1)
+			{
+				std::vector<FileId> group;
+
+				// Maps each file identity to the position of the file in the group.
+				std::map<FileIdentity, size_t> groupIdentities;
+
+				for (auto hashedFileItr = itr; hashedFileItr != end; ++hashedFileItr)
+				{
+					size_t index = hashedFileItr->second;
+
+					// Files whose identity couldn't be retrieved are always kept. Otherwise, only
+					// the link with the lowest path is kept, so that the results don't depend on
+					// the order in which the files were found.
+					if (!identities.empty() && identities[index])
+					{
+						auto [existingItr, inserted] =
+							groupIdentities.try_emplace(*identities[index], group.size());
+
+						if (!inserted)
+						{
+							auto &existingFile = group[existingItr->second];
+
+							if (GetPath(files[index]) < GetPath(existingFile))
+							{
+								existingFile = files[index];
+							}
+
+							continue;
+						}
+					}
+
+					group.push_back(files[index]);
+				}
+
+				if (group.size() > 1)
+				{
+					remainingCandidates.push_back(std::move(group));
+				}
+			}
+
+			itr = end;
+		}
+	}
+
+	return remainingCandidates;
+}
+
+std::optional<std::uint64_t> DuplicateFinder::HashSample(const File &file,
+	const std::filesystem::path &path, std::vector<char> &buffer) const
+{
+	std::ifstream stream(path, std::ios::binary);
+
+	if (!stream)
+	{
+		return std::nullopt;
+	}
+
+	XxHash64Hasher hasher;
+	auto headSize = std::min<std::uintmax_t>(file.size, m_options.sampleSize);
+
+	if (!HashStreamData(stream, headSize, hasher, buffer))
+	{
+		return std::nullopt;
+	}
+
+	if (file.size > headSize)
+	{
+		auto tailOffset = std::max<std::uintmax_t>(headSize, file.size - m_options.sampleSize);
+		stream.seekg(static_cast<std::streamoff>(tailOffset));
+
+		if (!HashStreamData(stream, file.size - tailOffset, hasher, buffer))
+		{
+			return std::nullopt;
+		}
+	}
+
+	return hasher.FinishAsNumber();
+}
+
+std::optional<std::uint64_t> DuplicateFinder::HashContents(const File &file,
+	const std::filesystem::path &path, std::vector<char> &buffer) const
+{
+	std::ifstream stream;
+
+	// The data is already being read in large blocks, so there's no need for the stream to buffer
+	// it as well.
+	stream.rdbuf()->pubsetbuf(nullptr, 0);
+	stream.open(path, std::ios::binary);
+
+	if (!stream)
+	{
+		return std::nullopt;
+	}
+
+	XxHash64Hasher hasher;
+
+	if (!HashStreamData(stream, file.size, hasher, buffer))
+	{
+		return std::nullopt;
+	}
+
+	return hasher.FinishAsNumber();
+}
+
+std::filesystem::path DuplicateFinder::GetPath(FileId file) const
+{
+	std::vector<DirectoryId> directories;
+
+	for (auto directory = m_files[file].directory; directory != NO_PARENT;
+		 directory = m_directories[directory].parent)
+	{
+		directories.push_back(directory);
+	}
+
+	std::filesystem::path path;
+
+	for (auto itr = directories.rbegin(); itr != directories.rend(); ++itr)
+	{
+		path /= GetName(m_directories[*itr].name);
+	}
+
+	return path / GetName(m_files[file].name);
+}
+
+std::uintmax_t DuplicateFinder::GetSize(FileId file) const
+{
+	return m_files[file].size;
+}
+
+DuplicateFinder::PathString DuplicateFinder::GetName(const Name &name) const
+{
+	return m_names.substr(name.offset, name.length);
+}
+
+DuplicateFinder::Name DuplicateFinder::AddName(const PathString &name)
+{
+	Name addedName = { static_cast<std::uint32_t>(m_names.size()),
+		static_cast<std::uint32_t>(name.size()) };
+	m_names += name;
+	return addedName;
+}
+
+void DuplicateFinder::Cancel()
+{
+	m_cancelled = true;
+}
+
+DuplicateFinder::Progress DuplicateFinder::GetProgress() const
+{
+	return { m_stage, m_filesFound, m_filesHashed, m_filesToHash };
+}
+
+size_t DuplicateFinder::GetNumErrors() const
+{
+	return m_numErrors;
+}
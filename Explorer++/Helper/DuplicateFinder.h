@@ -0,0 +1,143 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+// Finds files with identical contents within a set of directories. The work is done in stages,
+// with each stage only considering the files that remain candidates after the previous one:
+//
+// 1. The directories are walked in parallel and the files are grouped by size.
+// 2. For files that share a size, a sample made up of the first and last blocks of each file is
+//    hashed.
+// 3. For files that share a sample hash, the entire contents are hashed.
+//
+// Most files are eliminated by the first two stages, so only a small fraction of the data
+// typically needs to be read in full. Files that are covered entirely by their sample skip the
+// final stage.
+//
+// To support trees containing millions of files, each file is stored as a small fixed-size record,
+// with names held in a single shared buffer. Full paths are only built when requested.
+class DuplicateFinder
+{
+public:
+	using FileId = std::uint32_t;
+
+	struct Options
+	{
+		int numThreads = 4;
+
+		// Files smaller than this are ignored. Since all empty files are identical, they're
+		// ignored by default.
+		std::uintmax_t minimumSize = 1;
+
+		// The amount of data hashed from each end of a file during the second stage.
+		std::uintmax_t sampleSize = 64 * 1024;
+	};
+
+	enum class Stage
+	{
+		Scanning,
+		HashingSamples,
+		HashingContents,
+		Complete
+	};
+
+	struct Progress
+	{
+		Stage stage;
+		size_t filesFound;
+
+		// The number of files hashed so far, and the total number to hash, in the current stage.
+		size_t filesHashed;
+		size_t filesToHash;
+	};
+
+	struct Group
+	{
+		std::uintmax_t size;
+		std::vector<FileId> files;
+	};
+
+	explicit DuplicateFinder(const Options &options);
+
+	DuplicateFinder(const DuplicateFinder &) = delete;
+	DuplicateFinder &operator=(const DuplicateFinder &) = delete;
+
+	// Returns each set of two or more identical files. Groups are ordered by the amount of space
+	// taken up by the redundant copies (largest first), with the files in each group ordered by
+	// path. Directories that are nested within another of the directories are only searched once.
+	// Links to files and directories aren't followed and hard links to the same file are only
+	// reported once. Should only be called once.
+	std::vector<Group> Find(const std::vector<std::filesystem::path> &directories);
+
+	std::filesystem::path GetPath(FileId file) const;
+	std::uintmax_t GetSize(FileId file) const;
+
+	// Can be called from any thread. Once cancelled, Find() returns an empty set of groups.
+	void Cancel();
+
+	// Can be called from any thread.
+	Progress GetProgress() const;
+
+	// The number of files and directories that couldn't be read. Can be called from any thread.
+	size_t GetNumErrors() const;
+
+private:
+	using DirectoryId = std::uint32_t;
+	using PathString = std::filesystem::path::string_type;
+
+	static constexpr DirectoryId NO_PARENT = UINT32_MAX;
+
+	// Refers to a name in the shared name buffer.
+	struct Name
+	{
+		std::uint32_t offset;
+		std::uint32_t length;
+	};
+
+	// Root directories have no parent and store their full path as their name.
+	struct Directory
+	{
+		DirectoryId parent;
+		Name name;
+	};
+
+	struct File
+	{
+		std::uintmax_t size;
+		DirectoryId directory;
+		Name name;
+	};
+
+	using Candidates = std::vector<std::vector<FileId>>;
+
+	void Scan(const std::vector<std::filesystem::path> &directories);
+	Candidates GroupBySize() const;
+	Candidates GroupByHash(const Candidates &candidates, bool hashContents);
+	std::optional<std::uint64_t> HashSample(const File &file, const std::filesystem::path &path,
+		std::vector<char> &buffer) const;
+	std::optional<std::uint64_t> HashContents(const File &file, const std::filesystem::path &path,
+		std::vector<char> &buffer) const;
+	PathString GetName(const Name &name) const;
+	Name AddName(const PathString &name);
+
+	const Options m_options;
+
+	std::vector<Directory> m_directories;
+	std::vector<File> m_files;
+	PathString m_names;
+
+	std::atomic<bool> m_cancelled = false;
+	std::atomic<Stage> m_stage = Stage::Scanning;
+	std::atomic<size_t> m_filesFound = 0;
+	std::atomic<size_t> m_filesHashed = 0;
+	std::atomic<size_t> m_filesToHash = 0;
+	std::atomic<size_t> m_numErrors = 0;
+};
@@ -9,36 +9,204 @@
 
 #include "stdafx.h"
 #include "FileActionHandler.h"
+#include "../Helper/AtomicFileWriter.h"
+#include "../Helper/BatchRename.h"
+#include "../Helper/BufferedFileWriter.h"
 #include "../Helper/FileOperations.h"
 #include "../Helper/Macros.h"
+#include <wil/com.h>
+#include <wil/resource.h>
+#include <algorithm>
 
-BOOL FileActionHandler::RenameFiles(const RenamedItems_t &itemList)
+namespace
+{
+
+const TCHAR RENAME_JOURNAL_FILENAME_PREFIX[] = _T("RenameJournal-");
+const TCHAR RENAME_JOURNAL_FILENAME_EXTENSION[] = _T(".journal");
+
+// Independent renames are performed concurrently. That helps when renaming items on a network
+// share, where each rename involves a round trip to the server.
+const int MAX_CONCURRENT_RENAMES = 4;
+
+bool PathExists(const std::wstring &path)
+{
+	return GetFileAttributes(path.c_str()) != INVALID_FILE_ATTRIBUTES;
+}
+
+bool MoveItem(const std::wstring &source, const std::wstring &destination)
+{
+	// No flags are passed, so this will fail if the destination already exists.
+	return MoveFileEx(source.c_str(), destination.c_str(), 0);
+}
+
+// Items like drives, libraries and control panel items can only be renamed through the shell.
+bool IsFileSystemItem(const std::wstring &path)
+{
+	return !PathIsRoot(path.c_str()) && PathExists(path);
+}
+
+FileActionHandler::RenameError GetRenameError(BatchRenameConflictReason reason)
+{
+	switch (reason)
+	{
+	case BatchRenameConflictReason::DifferentDirectory:
+		return FileActionHandler::RenameError::InvalidName;
+
+	case BatchRenameConflictReason::DuplicateSource:
+	case BatchRenameConflictReason::DuplicateDestination:
+		return FileActionHandler::RenameError::DuplicateName;
+
+	case BatchRenameConflictReason::DestinationExists:
+		return FileActionHandler::RenameError::NameExists;
+	}
+
+	return FileActionHandler::RenameError::Failed;
+}
+
+// Writes out the journal and then reopens it without any sharing, so that other instances can
+// tell that the operation is still in progress. Returns an empty handle on failure.
+wil::unique_hfile CreateRenameJournal(const std::wstring &journalPath,
+	const BatchRenamePlan &plan)
+{
+	{
+		AtomicFileWriter atomicFileWriter(journalPath);
+
+		if (atomicFileWriter.GetHandle() == INVALID_HANDLE_VALUE)
+		{
+			return {};
+		}
+
+		BufferedFileWriter writer(atomicFileWriter.GetHandle());
+		writer.Write(SerializeBatchRenameJournal(plan));
+
+		if (!writer.Flush() || !atomicFileWriter.Commit())
+		{
+			return {};
+		}
+	}
+
+	return wil::unique_hfile(CreateFile(journalPath.c_str(), GENERIC_READ, 0, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+}
+
+}
+
+void FileActionHandler::SetRenameJournalDirectory(const std::wstring &directory)
+{
+	m_renameJournalDirectory = directory;
+}
+
+BOOL FileActionHandler::RenameFiles(const RenamedItems_t &itemList, FailedRenames_t *failedItems)
 {
 	RenamedItems_t renamedItems;
+	std::vector<BatchRenameItem> batchItems;
+	std::vector<const RenamedItem_t *> batchOriginalItems;
+
+	auto addFailedItem = [failedItems](const RenamedItem_t &item, RenameError error)
+	{
+		if (failedItems)
+		{
+			failedItems->push_back({ item, error });
+		}
+	};
 
 	for (const auto &item : itemList)
 	{
-		/* TODO: This should actually be done by the caller. */
-		IShellItem *shellItem = nullptr;
-		HRESULT hr = SHCreateItemFromParsingName(item.strOldFilename.c_str(), nullptr,
-			IID_PPV_ARGS(&shellItem));
+		/* Only the filename portion of the new name is
+		used, so each item stays within its current directory. */
+		TCHAR newFilename[MAX_PATH];
+		StringCchCopy(newFilename, SIZEOF_ARRAY(newFilename), item.strNewFilename.c_str());
+		PathStripPath(newFilename);
 
-		if (SUCCEEDED(hr))
+		if (!IsFileSystemItem(item.strOldFilename))
 		{
-			TCHAR newFilename[MAX_PATH];
-			StringCchCopy(newFilename, SIZEOF_ARRAY(newFilename), item.strNewFilename.c_str());
-			PathStripPath(newFilename);
+			wil::com_ptr_nothrow<IShellItem> shellItem;
+			HRESULT hr = SHCreateItemFromParsingName(item.strOldFilename.c_str(), nullptr,
+				IID_PPV_ARGS(&shellItem));
 
-			/* TODO: Could rename all files in the list in a single
-			operation, rather than one by one.*/
-			hr = NFileOperations::RenameFile(shellItem, newFilename);
+			if (FAILED(hr))
+			{
+				addFailedItem(item, RenameError::Failed);
+				continue;
+			}
+
+			/* Any error that occurs during the rename itself
+			is shown to the user by the shell. */
+			hr = NFileOperations::RenameFile(shellItem.get(), newFilename);
 
 			if (SUCCEEDED(hr))
 			{
 				renamedItems.push_back(item);
 			}
 
-			shellItem->Release();
+			continue;
+		}
+
+		TCHAR directory[MAX_PATH];
+		StringCchCopy(directory, SIZEOF_ARRAY(directory), item.strOldFilename.c_str());
+		PathRemoveFileSpec(directory);
+
+		TCHAR destination[MAX_PATH];
+
+		if (!PathCombine(destination, directory, newFilename))
+		{
+			addFailedItem(item, RenameError::InvalidName);
+			continue;
+		}
+
+		batchItems.push_back({ item.strOldFilename, destination });
+		batchOriginalItems.push_back(&item);
+	}
+
+	auto plan = PlanBatchRename(batchItems, PathExists);
+
+	for (const auto &conflict : plan.conflicts)
+	{
+		addFailedItem(*batchOriginalItems[conflict.itemIndex], GetRenameError(conflict.reason));
+	}
+
+	if (plan.GetNumSteps() > 0)
+	{
+		wil::unique_hfile journal;
+		std::wstring journalPath;
+
+		/* If the journal can't be written, the renames are still
+		performed, they just can't be recovered after a crash. */
+		if (!m_renameJournalDirectory.empty())
+		{
+			journalPath = m_renameJournalDirectory + L"\\" + RENAME_JOURNAL_FILENAME_PREFIX
+				+ std::to_wstring(GetCurrentProcessId()) + RENAME_JOURNAL_FILENAME_EXTENSION;
+			journal = CreateRenameJournal(journalPath, plan);
+		}
+
+		auto renamedIndexes = ExecuteBatchRename(plan, MoveItem, MAX_CONCURRENT_RENAMES);
+
+		if (journal)
+		{
+			journal.reset();
+			DeleteFile(journalPath.c_str());
+		}
+
+		/* The full destination path is stored, so that the
+		rename can be undone even if only a filename was given. */
+		for (size_t index : renamedIndexes)
+		{
+			RenamedItem_t renamedItem;
+			renamedItem.strOldFilename = batchItems[index].source;
+			renamedItem.strNewFilename = batchItems[index].destination;
+			renamedItems.push_back(renamedItem);
+		}
+
+		/* Any item in the plan that wasn't renamed failed
+		at the point the rename was attempted. */
+		for (const auto &step : plan.GetSteps())
+		{
+			if (step.itemIndex
+				&& !std::binary_search(renamedIndexes.begin(), renamedIndexes.end(),
+					*step.itemIndex))
+			{
+				addFailedItem(*batchOriginalItems[*step.itemIndex], RenameError::Failed);
+			}
 		}
 	}
 
@@ -133,3 +301,94 @@ BOOL FileActionHandler::CanUndo() const
 {
 	return !m_stackFileActions.empty();
 }
+
+std::vector<std::wstring> FileActionHandler::FindInterruptedRenameJournals() const
+{
+	std::vector<std::wstring> journalPaths;
+
+	if (m_renameJournalDirectory.empty())
+	{
+		return journalPaths;
+	}
+
+	std::wstring searchPattern = m_renameJournalDirectory + L"\\"
+		+ RENAME_JOURNAL_FILENAME_PREFIX + L"*" + RENAME_JOURNAL_FILENAME_EXTENSION;
+
+	WIN32_FIND_DATA findData;
+	wil::unique_hfind findHandle(FindFirstFile(searchPattern.c_str(), &findData));
+
+	if (!findHandle)
+	{
+		return journalPaths;
+	}
+
+	do
+	{
+		std::wstring journalPath = m_renameJournalDirectory + L"\\" + findData.cFileName;
+
+		/* A journal that's still held open belongs to an operation
+		that's in progress in another instance. */
+		wil::unique_hfile journal(CreateFile(journalPath.c_str(), GENERIC_READ, 0, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+
+		if (journal)
+		{
+			journalPaths.push_back(journalPath);
+		}
+	} while (FindNextFile(findHandle.get(), &findData));
+
+	return journalPaths;
+}
+
+bool FileActionHandler::RollBackInterruptedRename(const std::wstring &journalPath)
+{
+	std::string contents;
+
+	{
+		wil::unique_hfile journal(CreateFile(journalPath.c_str(), GENERIC_READ, 0, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+
+		if (!journal)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+
+		if (!GetFileSizeEx(journal.get(), &fileSize) || fileSize.HighPart != 0)
+		{
+			return false;
+		}
+
+		contents.resize(fileSize.LowPart);
+		DWORD numBytesRead;
+
+		if (!ReadFile(journal.get(), contents.data(), fileSize.LowPart, &numBytesRead, nullptr)
+			|| numBytesRead != fileSize.LowPart)
+		{
+			return false;
+		}
+	}
+
+	auto steps = ParseBatchRenameJournal(contents);
+
+	/* The journal is written atomically, so an invalid journal
+	can't be the result of an interrupted write. There's nothing
+	that can be done with it, so it's simply removed. */
+	if (!steps)
+	{
+		DeleteFile(journalPath.c_str());
+		return false;
+	}
+
+	bool res = RollBackBatchRename(*steps, PathExists, MoveItem);
+
+	/* If some of the items couldn't be restored, the journal is
+	kept, so that another attempt can be made later. */
+	if (res)
+	{
+		DeleteFile(journalPath.c_str());
+	}
+
+	return res;
+}
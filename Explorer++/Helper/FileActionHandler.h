@@ -6,6 +6,7 @@
 
 #include <list>
 #include <stack>
+#include <string>
 #include <vector>
 
 class FileActionHandler
@@ -20,12 +21,55 @@ public:
 	typedef std::list<RenamedItem_t> RenamedItems_t;
 	typedef std::vector<PCIDLIST_ABSOLUTE> DeletedItems_t;
 
-	BOOL RenameFiles(const RenamedItems_t &itemList);
+	enum class RenameError
+	{
+		// Another item in the set was going to be given the same name.
+		DuplicateName,
+
+		// An item with the new name already exists (or is an item in the set that couldn't be
+		// renamed).
+		NameExists,
+
+		// The new name would have moved the item to a different directory.
+		InvalidName,
+
+		// The rename was attempted, but failed.
+		Failed
+	};
+
+	struct FailedRename_t
+	{
+		RenamedItem_t item;
+		RenameError error;
+	};
+
+	typedef std::list<FailedRename_t> FailedRenames_t;
+
+	// While a set of files is being renamed, a journal is kept in this directory, so that the
+	// original names can be restored if the process exits before the renames have finished. If
+	// no directory is set, no journal is kept.
+	void SetRenameJournalDirectory(const std::wstring &directory);
+
+	// Each item is renamed within its current directory. Items that can't be renamed (for
+	// example, because two items would end up with the same name) are skipped, as are any items
+	// that fail to be renamed. Those items are added to failedItems, if it's provided.
+	//
+	// Items that aren't in the file system (or are the root of a drive, where renaming changes
+	// the volume label) are renamed through the shell, which reports any errors itself.
+	BOOL RenameFiles(const RenamedItems_t &itemList, FailedRenames_t *failedItems = nullptr);
 	HRESULT DeleteFiles(HWND hwnd, DeletedItems_t &deletedItems, bool permanent, bool silent);
 
 	void Undo();
 	BOOL CanUndo() const;
 
+	// Returns the journals left behind by earlier rename operations that were interrupted. The
+	// journals for operations that are still in progress in other instances are excluded.
+	std::vector<std::wstring> FindInterruptedRenameJournals() const;
+
+	// Restores the original names of the items renamed by an interrupted operation. The journal
+	// is removed once it's no longer needed.
+	static bool RollBackInterruptedRename(const std::wstring &journalPath);
+
 private:
 	enum class UndoType
 	{
@@ -47,4 +91,5 @@ private:
 	void UndoDeleteOperation(const DeletedItems_t &deletedItemList);
 
 	std::stack<UndoItem_t> m_stackFileActions;
+	std::wstring m_renameJournalDirectory;
 };
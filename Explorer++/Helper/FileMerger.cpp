@@ -0,0 +1,239 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FileMerger.h"
+#include "ChecksumManifest.h"
+#include "Sha256Hasher.h"
+#include <wil/resource.h>
+#include <algorithm>
+#include <optional>
+
+FileMerger::FileMerger(const std::vector<std::wstring> &inputPaths, const std::wstring &outputPath,
+	const Options &options) :
+	m_inputPaths(inputPaths),
+	m_outputPath(outputPath),
+	m_options(options),
+	m_cancelled(false),
+	m_failedFileIndex(0)
+{
+}
+
+FileMerger::Result FileMerger::Merge(ProgressCallback progressCallback)
+{
+	Result result;
+
+	{
+		wil::unique_hfile outputFile(CreateFile(m_outputPath.c_str(), GENERIC_WRITE, 0, nullptr,
+			CREATE_NEW, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+
+		if (!outputFile)
+		{
+			return Result::OutputFileError;
+		}
+
+		result = MergeInternal(outputFile.get(), progressCallback);
+	}
+
+	if (result != Result::Succeeded)
+	{
+		DeleteFile(m_outputPath.c_str());
+	}
+
+	return result;
+}
+
+FileMerger::Result FileMerger::MergeInternal(HANDLE outputFile, ProgressCallback progressCallback)
+{
+	Progress progress;
+	progress.bytesProcessed = 0;
+	progress.filesCompleted = 0;
+	progress.totalFiles = m_inputPaths.size();
+
+	if (!GetTotalInputSize(progress.totalBytes))
+	{
+		return Result::InputFileError;
+	}
+
+	if (m_options.preallocate && !PreallocateFile(outputFile, progress.totalBytes))
+	{
+		return Result::OutputFileError;
+	}
+
+	// The checksum expected for each input file, in the same order as the input files.
+	std::vector<std::string> expectedChecksums;
+	std::optional<Sha256Hasher> hasher;
+
+	if (!m_options.manifestPath.empty())
+	{
+		auto entries = ChecksumManifest::Read(m_options.manifestPath);
+
+		if (!entries)
+		{
+			return Result::ManifestError;
+		}
+
+		for (size_t i = 0; i < m_inputPaths.size(); i++)
+		{
+			const wchar_t *filename = PathFindFileName(m_inputPaths[i].c_str());
+
+			auto itr = std::find_if(entries->begin(), entries->end(),
+				[filename](const ChecksumManifest::Entry &entry)
+				{
+					return lstrcmpi(entry.filename.c_str(), filename) == 0;
+				});
+
+			if (itr == entries->end())
+			{
+				m_failedFileIndex = i;
+				return Result::VerificationFailed;
+			}
+
+			expectedChecksums.push_back(itr->checksum);
+		}
+
+		hasher.emplace();
+	}
+
+	ULONGLONG lastUpdateTime = GetTickCount64();
+
+	auto updateProgress = [&](bool force)
+	{
+		if (!progressCallback)
+		{
+			return;
+		}
+
+		ULONGLONG currentTime = GetTickCount64();
+
+		if (!force && (currentTime - lastUpdateTime) < PROGRESS_UPDATE_INTERVAL_MS)
+		{
+			return;
+		}
+
+		lastUpdateTime = currentTime;
+		progressCallback(progress);
+	};
+
+	PipelinedFileReader reader(m_inputPaths, m_options.blockSize, m_options.numBuffers);
+	PipelinedFileReader::Block block;
+
+	while (reader.ReadNextBlock(block))
+	{
+		if (m_cancelled)
+		{
+			return Result::Cancelled;
+		}
+
+		if (block.endOfFile)
+		{
+			if (hasher)
+			{
+				auto checksum = hasher->Finish();
+
+				if (!checksum)
+				{
+					return Result::ManifestError;
+				}
+
+				if (_stricmp(checksum->c_str(), expectedChecksums[block.fileIndex].c_str()) != 0)
+				{
+					m_failedFileIndex = block.fileIndex;
+					return Result::VerificationFailed;
+				}
+			}
+
+			progress.filesCompleted++;
+			updateProgress(true);
+
+			continue;
+		}
+
+		DWORD numBytesWritten;
+		BOOL res = WriteFile(outputFile, block.data, block.size, &numBytesWritten, nullptr);
+
+		if (!res || numBytesWritten != block.size)
+		{
+			return Result::OutputFileError;
+		}
+
+		if (hasher && !hasher->Update(block.data, block.size))
+		{
+			return Result::ManifestError;
+		}
+
+		progress.bytesProcessed += block.size;
+		updateProgress(false);
+	}
+
+	if (m_cancelled)
+	{
+		return Result::Cancelled;
+	}
+
+	if (reader.GetState() != PipelinedFileReader::State::Finished)
+	{
+		m_failedFileIndex = reader.GetFailedFileIndex();
+		return Result::InputFileError;
+	}
+
+	// Releases any preallocated space that wasn't used (e.g. because an input file was truncated
+	// after the merge started).
+	if (!SetEndOfFile(outputFile))
+	{
+		return Result::OutputFileError;
+	}
+
+	return Result::Succeeded;
+}
+
+bool FileMerger::GetTotalInputSize(ULONGLONG &totalSizeOut)
+{
+	ULONGLONG totalSize = 0;
+
+	for (size_t i = 0; i < m_inputPaths.size(); i++)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA fileAttributes;
+		BOOL res =
+			GetFileAttributesEx(m_inputPaths[i].c_str(), GetFileExInfoStandard, &fileAttributes);
+
+		if (!res)
+		{
+			m_failedFileIndex = i;
+			return false;
+		}
+
+		ULARGE_INTEGER fileSize;
+		fileSize.LowPart = fileAttributes.nFileSizeLow;
+		fileSize.HighPart = fileAttributes.nFileSizeHigh;
+
+		totalSize += fileSize.QuadPart;
+	}
+
+	totalSizeOut = totalSize;
+
+	return true;
+}
+
+bool FileMerger::PreallocateFile(HANDLE file, ULONGLONG size)
+{
+	// Setting the allocation size reserves the clusters for the file, without changing its
+	// logical size. That means there's no need to zero-fill the file, or to move the file
+	// pointer.
+	FILE_ALLOCATION_INFO allocationInfo;
+	allocationInfo.AllocationSize.QuadPart = static_cast<LONGLONG>(size);
+
+	return SetFileInformationByHandle(file, FileAllocationInfo, &allocationInfo,
+		sizeof(allocationInfo));
+}
+
+void FileMerger::Cancel()
+{
+	m_cancelled = true;
+}
+
+size_t FileMerger::GetFailedFileIndex() const
+{
+	return m_failedFileIndex;
+}
@@ -0,0 +1,81 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "PipelinedFileReader.h"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Concatenates a set of files into a single output file. The input files are read ahead on a
+// background thread, through a small, fixed set of buffers, so the amount of memory used doesn't
+// depend on the size of the files being merged.
+class FileMerger
+{
+public:
+	struct Options
+	{
+		// If set, each input file will be checked against the SHA-256 digest listed for it in
+		// this manifest (e.g. one written when the file was split) as it's merged.
+		std::wstring manifestPath;
+
+		// If set, space for the entire output file will be reserved before any data is written,
+		// reducing fragmentation and ensuring that a lack of disk space is detected up front.
+		bool preallocate = true;
+
+		DWORD blockSize = PipelinedFileReader::DEFAULT_BLOCK_SIZE;
+		int numBuffers = PipelinedFileReader::DEFAULT_NUM_BUFFERS;
+	};
+
+	struct Progress
+	{
+		ULONGLONG bytesProcessed;
+		ULONGLONG totalBytes;
+		size_t filesCompleted;
+		size_t totalFiles;
+	};
+
+	enum class Result
+	{
+		Succeeded,
+		Cancelled,
+		InputFileError,
+		OutputFileError,
+		ManifestError,
+		VerificationFailed
+	};
+
+	// Invoked on the thread that called Merge(). Progress updates are rate limited, though an
+	// update will always be sent as each input file is completed.
+	using ProgressCallback = std::function<void(const Progress &progress)>;
+
+	FileMerger(const std::vector<std::wstring> &inputPaths, const std::wstring &outputPath,
+		const Options &options);
+
+	// The output file must not already exist. If the merge doesn't succeed, the partially written
+	// output file is removed.
+	Result Merge(ProgressCallback progressCallback);
+
+	// Can be called from any thread.
+	void Cancel();
+
+	// If the merge failed because an input file couldn't be read or didn't match its checksum,
+	// returns the index of that file.
+	size_t GetFailedFileIndex() const;
+
+private:
+	static const ULONGLONG PROGRESS_UPDATE_INTERVAL_MS = 100;
+
+	Result MergeInternal(HANDLE outputFile, ProgressCallback progressCallback);
+	bool GetTotalInputSize(ULONGLONG &totalSizeOut);
+	static bool PreallocateFile(HANDLE file, ULONGLONG size);
+
+	const std::vector<std::wstring> m_inputPaths;
+	const std::wstring m_outputPath;
+	const Options m_options;
+	std::atomic<bool> m_cancelled;
+	size_t m_failedFileIndex;
+};
@@ -5,14 +5,13 @@
 #include "stdafx.h"
 #include "FileOperations.h"
 #include "DragDropHelper.h"
-#include "DriveInfo.h"
+#include "FileShredder.h"
 #include "Helper.h"
 #include "Macros.h"
 #include "ShellHelper.h"
 #include "StringHelper.h"
 #include <wil/com.h>
 #include <list>
-#include <sstream>
 
 enum class PasteType
 {
@@ -20,7 +19,6 @@ enum class PasteType
 };
 
 int PasteFilesFromClipboardSpecial(const TCHAR *szDestination, PasteType pasteType);
-BOOL GetFileClusterSize(const std::wstring &strFilename, PLARGE_INTEGER lpRealFileSize);
 
 HRESULT NFileOperations::RenameFile(IShellItem *item, const std::wstring &newName)
 {
@@ -265,137 +263,6 @@ HRESULT NFileOperations::CreateNewFolder(IShellItem *destinationFolder,
 	return hr;
 }
 
-BOOL NFileOperations::SaveDirectoryListing(const std::wstring &strDirectory,
-	const std::wstring &strFilename)
-{
-	std::wstring strContents = _T("Directory\r\n---------\r\n") + strDirectory + _T("\r\n\r\n");
-
-	SYSTEMTIME st;
-	FILETIME ft;
-	FILETIME lft;
-	GetLocalTime(&st);
-	SystemTimeToFileTime(&st, &ft);
-	LocalFileTimeToFileTime(&ft, &lft);
-
-	TCHAR szTime[128];
-	CreateFileTimeString(&lft, szTime, SIZEOF_ARRAY(szTime), FALSE);
-	strContents += _T("Date\r\n----\r\n") + std::wstring(szTime) + _T("\r\n\r\n");
-
-	std::wstring strSearch = strDirectory + _T("\\*");
-
-	WIN32_FIND_DATA wfd;
-	HANDLE hFirstFile = FindFirstFile(strSearch.c_str(), &wfd);
-
-	std::list<std::wstring> folderList;
-	std::list<std::wstring> fileList;
-	ULARGE_INTEGER ulTotalSize;
-
-	ulTotalSize.QuadPart = 0;
-
-	if (hFirstFile != INVALID_HANDLE_VALUE)
-	{
-		ULARGE_INTEGER ulFileSize;
-
-		if (lstrcmpi(wfd.cFileName, _T(".")) != 0 && lstrcmpi(wfd.cFileName, _T("..")) != 0)
-		{
-			if ((wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == FILE_ATTRIBUTE_DIRECTORY)
-			{
-				folderList.emplace_back(wfd.cFileName);
-			}
-			else
-			{
-				fileList.emplace_back(wfd.cFileName);
-
-				ulFileSize.LowPart = wfd.nFileSizeLow;
-				ulFileSize.HighPart = wfd.nFileSizeHigh;
-
-				ulTotalSize.QuadPart += ulFileSize.QuadPart;
-			}
-		}
-
-		while (FindNextFile(hFirstFile, &wfd) != 0)
-		{
-			if (lstrcmpi(wfd.cFileName, _T(".")) != 0 && lstrcmpi(wfd.cFileName, _T("..")) != 0)
-			{
-				if ((wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == FILE_ATTRIBUTE_DIRECTORY)
-				{
-					folderList.emplace_back(wfd.cFileName);
-				}
-				else
-				{
-					fileList.emplace_back(wfd.cFileName);
-
-					ulFileSize.LowPart = wfd.nFileSizeLow;
-					ulFileSize.HighPart = wfd.nFileSizeHigh;
-
-					ulTotalSize.QuadPart += ulFileSize.QuadPart;
-				}
-			}
-		}
-
-		FindClose(hFirstFile);
-	}
-
-	std::wstringstream ss;
-	ss.imbue(std::locale(""));
-	ss.precision(0);
-
-	strContents += _T("Statistics\r\n----------\r\n");
-
-	ss << std::fixed << folderList.size();
-	strContents += _T("Number of folders: ") + ss.str() + std::wstring(_T("\r\n"));
-
-	ss.str(_T(""));
-	ss << std::fixed << fileList.size();
-	strContents += _T("Number of files: ") + ss.str() + std::wstring(_T("\r\n"));
-
-	TCHAR szTotalSize[32];
-	FormatSizeString(ulTotalSize, szTotalSize, SIZEOF_ARRAY(szTotalSize));
-	strContents += _T("Total size (not including subfolders): ") + std::wstring(szTotalSize)
-		+ std::wstring(_T("\r\n"));
-
-	strContents += _T("\r\nFolders\r\n-------\r\n");
-
-	for (const auto &folder : folderList)
-	{
-		strContents += folder + _T("\r\n");
-	}
-
-	strContents += _T("\r\nFiles\r\n-----\r\n");
-
-	for (const auto &file : fileList)
-	{
-		strContents += file + _T("\r\n");
-	}
-
-	/* Remove the trailing newline. */
-	strContents = strContents.substr(0, strContents.size() - 2);
-
-	HANDLE hFile = CreateFile(strFilename.c_str(), FILE_WRITE_DATA, 0, nullptr, CREATE_ALWAYS,
-		FILE_ATTRIBUTE_NORMAL, nullptr);
-
-	if (hFile != INVALID_HANDLE_VALUE)
-	{
-		DWORD nBytesWritten;
-
-		/* Write out the BOM for UTF-16 LE data.
-		See http://en.wikipedia.org/wiki/Byte-order_mark */
-		WriteFile(hFile, reinterpret_cast<LPCVOID>("\xFF\xFE"), 2, &nBytesWritten, nullptr);
-
-		WriteFile(hFile, reinterpret_cast<LPCVOID>(strContents.c_str()),
-			static_cast<DWORD>(strContents.size() * sizeof(WCHAR)), &nBytesWritten, nullptr);
-
-		if (nBytesWritten == strContents.size())
-		{
-			return TRUE;
-		}
-
-		CloseHandle(hFile);
-	}
-
-	return FALSE;
-}
-
 HRESULT CopyFiles(const std::vector<PCIDLIST_ABSOLUTE> &items, IDataObject **dataObjectOut)
 {
 	return CopyFilesToClipboard(items, false, dataObjectOut);
@@ -587,141 +454,12 @@ BOOL NFileOperations::CreateBrowseDialog(HWND hOwner, const std::wstring &strTit
 	return bSuccessful;
 }
 
-BOOL GetFileClusterSize(const std::wstring &strFilename, PLARGE_INTEGER lpRealFileSize)
-{
-	DWORD dwClusterSize;
-
-	LARGE_INTEGER lFileSize;
-	BOOL bRet = GetFileSizeEx(strFilename.c_str(), &lFileSize);
-
-	if (!bRet)
-	{
-		return FALSE;
-	}
-
-	TCHAR szRoot[MAX_PATH];
-	HRESULT hr = StringCchCopy(szRoot, SIZEOF_ARRAY(szRoot), strFilename.c_str());
-
-	if (FAILED(hr))
-	{
-		return FALSE;
-	}
-
-	bRet = PathStripToRoot(szRoot);
-
-	if (!bRet)
-	{
-		return FALSE;
-	}
-
-	bRet = GetClusterSize(szRoot, &dwClusterSize);
-
-	if (!bRet)
-	{
-		return FALSE;
-	}
-
-	if ((lFileSize.QuadPart % dwClusterSize) != 0)
-	{
-		/* The real size is the logical file size rounded up to the end of the
-		nearest cluster. */
-		lFileSize.QuadPart += dwClusterSize - (lFileSize.QuadPart % dwClusterSize);
-	}
-
-	*lpRealFileSize = lFileSize;
-
-	return TRUE;
-}
-
 void NFileOperations::DeleteFileSecurely(const std::wstring &strFilename,
 	OverwriteMethod overwriteMethod)
 {
-	HANDLE hFile;
-	WIN32_FIND_DATA wfd;
-	HANDLE hFindFile;
-	HCRYPTPROV hProv;
-	LARGE_INTEGER lRealFileSize;
-	BYTE pass1Data;
-	BYTE pass2Data;
-	BYTE pass3Data;
-	DWORD nBytesWritten;
-	BOOL bFolder;
-	int i = 0;
-
-	hFindFile = FindFirstFile(strFilename.c_str(), &wfd);
-
-	if (hFindFile == INVALID_HANDLE_VALUE)
-	{
-		return;
-	}
-
-	bFolder = (wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == FILE_ATTRIBUTE_DIRECTORY;
-
-	FindClose(hFindFile);
-
-	if (bFolder)
-	{
-		return;
-	}
-
-	/* Determine the actual size of the file on disk
-	(i.e. how many clusters it is allocated). */
-	GetFileClusterSize(strFilename, &lRealFileSize);
-
-	/* Open the file, block any sharing mode, to stop the file
-	been opened while it is overwritten. */
-	hFile =
-		CreateFile(strFilename.c_str(), FILE_WRITE_DATA, 0, nullptr, OPEN_EXISTING, NULL, nullptr);
-
-	if (hFile == INVALID_HANDLE_VALUE)
-	{
-		return;
-	}
-
-	/* Extend the file out to the end of its last sector. */
-	SetFilePointerEx(hFile, lRealFileSize, nullptr, FILE_BEGIN);
-	SetEndOfFile(hFile);
-
-	/* Start at the beginning of the file, and
-	write in the first-pass data, 0x00 over
-	the length of the whole file. */
-	SetFilePointer(hFile, 0, nullptr, FILE_BEGIN);
-	pass1Data = 0x00;
-
-	for (i = 0; i < lRealFileSize.QuadPart; i++)
-	{
-		WriteFile(hFile, (LPVOID) &pass1Data, 1, &nBytesWritten, nullptr);
-	}
-
-	if (overwriteMethod == OverwriteMethod::ThreePass)
-	{
-		/* Start at the beginning of the file, and
-		write in the second-pass data, 0xFF over
-		the length of the whole file. */
-		SetFilePointer(hFile, 0, nullptr, FILE_BEGIN);
-		pass2Data = 0xFF;
-
-		for (i = 0; i < lRealFileSize.QuadPart; i++)
-		{
-			WriteFile(hFile, (LPVOID) &pass2Data, 1, &nBytesWritten, nullptr);
-		}
-
-		SetFilePointer(hFile, 0, nullptr, FILE_BEGIN);
-
-		CryptAcquireContext(&hProv, _T("SecureDelete"), nullptr, PROV_RSA_AES, CRYPT_NEWKEYSET);
-
-		for (i = 0; i < lRealFileSize.QuadPart; i++)
-		{
-			CryptGenRandom(hProv, 1, (LPBYTE) &pass3Data);
-			WriteFile(hFile, (LPVOID) &pass3Data, 1, &nBytesWritten, nullptr);
-		}
-
-		CryptAcquireContext(&hProv, _T("SecureDelete"), nullptr, PROV_RSA_AES, CRYPT_DELETEKEYSET);
-	}
-
-	FlushFileBuffers(hFile);
-
-	CloseHandle(hFile);
+	FileShredder::Options options;
+	options.overwriteMethod = overwriteMethod;
 
-	DeleteFile(strFilename.c_str());
+	FileShredder shredder(options);
+	shredder.ShredFile(strFilename);
 }
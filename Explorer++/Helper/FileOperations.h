@@ -28,8 +28,6 @@ HRESULT CreateNewFolder(IShellItem *destinationFolder, const std::wstring &newFo
 
 TCHAR *BuildFilenameList(const std::list<std::wstring> &FilenameList);
 
-BOOL SaveDirectoryListing(const std::wstring &strDirectory, const std::wstring &strFilename);
-
 HRESULT CreateLinkToFile(const std::wstring &strTargetFilename, const std::wstring &strLinkFilename,
 	const std::wstring &strLinkDescription);
 HRESULT ResolveLink(HWND hwnd, DWORD fFlags, const TCHAR *szLinkFilename, TCHAR *szResolvedPath,
@@ -0,0 +1,471 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FileShredder.h"
+#include "DriveInfo.h"
+#include "Macros.h"
+#include "../ThirdParty/CTPL/cpl_stl.h"
+#include <wil/resource.h>
+#include <bcrypt.h>
+#include <algorithm>
+
+#pragma comment(lib, "bcrypt.lib")
+
+FileShredder::FileShredder(const Options &options) : m_options(options), m_cancelled(false)
+{
+}
+
+bool FileShredder::ShredItems(const std::vector<std::wstring> &paths,
+	ProgressCallback progressCallback)
+{
+	std::vector<FileEntry> files;
+	std::vector<std::wstring> folders;
+
+	for (const auto &path : paths)
+	{
+		CollectItems(path, files, folders);
+	}
+
+	Progress initialProgress = {};
+	initialProgress.totalFiles = static_cast<int>(files.size());
+
+	for (const auto &file : files)
+	{
+		initialProgress.totalBytes += file.size * GetTotalPassCount();
+	}
+
+	std::atomic<ULONGLONG> bytesWritten = 0;
+	std::atomic<int> filesCompleted = 0;
+	std::atomic<bool> allSucceeded = true;
+
+	auto reportProgress = [&]()
+	{
+		if (!progressCallback)
+		{
+			return;
+		}
+
+		Progress progress = initialProgress;
+		progress.bytesWritten = bytesWritten;
+		progress.filesCompleted = filesCompleted;
+		progressCallback(progress);
+	};
+
+	if (!files.empty())
+	{
+		int numThreads = std::clamp(m_options.maxParallelFiles, 1, static_cast<int>(files.size()));
+
+		// Each worker thread reuses a single buffer for every file it processes.
+		std::vector<std::unique_ptr<AlignedBuffer>> buffers;
+
+		for (int i = 0; i < numThreads; i++)
+		{
+			buffers.push_back(std::make_unique<AlignedBuffer>(m_options.blockSize));
+		}
+
+		ctpl::thread_pool threadPool(numThreads);
+		std::vector<std::future<void>> results;
+
+		for (const auto &file : files)
+		{
+			results.push_back(threadPool.push(
+				[this, &file, &buffers, &bytesWritten, &filesCompleted, &allSucceeded,
+					&reportProgress](int id)
+				{
+					if (IsCancelled())
+					{
+						allSucceeded = false;
+						return;
+					}
+
+					bool res = true;
+
+					if (!file.isLink)
+					{
+						res = OverwriteFile(file.path, *buffers[id],
+							[&bytesWritten, &reportProgress](ULONGLONG written)
+							{
+								bytesWritten += written;
+								reportProgress();
+							});
+					}
+
+					if (!res || !DeleteFile(file.path.c_str()))
+					{
+						allSucceeded = false;
+					}
+
+					filesCompleted++;
+					reportProgress();
+				}));
+		}
+
+		for (auto &result : results)
+		{
+			result.wait();
+		}
+	}
+
+	if (IsCancelled())
+	{
+		return false;
+	}
+
+	// Folders are collected after their contents, so removing them in order will remove the
+	// deepest folders first.
+	for (const auto &folder : folders)
+	{
+		if (!RemoveDirectory(folder.c_str()))
+		{
+			allSucceeded = false;
+		}
+	}
+
+	return allSucceeded;
+}
+
+bool FileShredder::ShredFile(const std::wstring &path)
+{
+	if (IsLink(path))
+	{
+		return DeleteFile(path.c_str());
+	}
+
+	AlignedBuffer buffer(m_options.blockSize);
+
+	if (!OverwriteFile(path, buffer, nullptr))
+	{
+		return false;
+	}
+
+	return DeleteFile(path.c_str());
+}
+
+bool FileShredder::OverwriteFile(const std::wstring &path)
+{
+	AlignedBuffer buffer(m_options.blockSize);
+	return OverwriteFile(path, buffer, nullptr);
+}
+
+bool FileShredder::OverwriteFile(const std::wstring &path, AlignedBuffer &buffer,
+	const std::function<void(ULONGLONG bytesWritten)> &onBytesWritten)
+{
+	WIN32_FILE_ATTRIBUTE_DATA attributeData;
+
+	if (!GetFileAttributesEx(path.c_str(), GetFileExInfoStandard, &attributeData))
+	{
+		return false;
+	}
+
+	if (WI_IsFlagSet(attributeData.dwFileAttributes, FILE_ATTRIBUTE_DIRECTORY))
+	{
+		return false;
+	}
+
+	ULARGE_INTEGER fileSize = { attributeData.nFileSizeLow, attributeData.nFileSizeHigh };
+
+	// The data is written out to the end of the final cluster, so that any data in the slack space
+	// is destroyed as well. If the cluster size can't be determined, only the logical size of the
+	// file can be overwritten, which also means that unbuffered writes can't be used (since
+	// unbuffered writes have to be a multiple of the sector size).
+	ULONGLONG overwriteSize;
+	bool unbuffered = m_options.unbuffered;
+
+	if (!GetAllocatedFileSize(path, fileSize.QuadPart, overwriteSize))
+	{
+		overwriteSize = fileSize.QuadPart;
+		unbuffered = false;
+	}
+
+	// The file is opened with FILE_FLAG_OPEN_REPARSE_POINT, so that if it has been replaced with a
+	// link since the items were collected, the link won't be followed.
+	DWORD flags = FILE_FLAG_SEQUENTIAL_SCAN | FILE_FLAG_OPEN_REPARSE_POINT;
+
+	if (unbuffered)
+	{
+		flags |= FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH;
+	}
+
+	// No sharing is allowed, to stop the file being opened while it's being overwritten.
+	wil::unique_hfile file(
+		CreateFile(path.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, flags, nullptr));
+
+	if (!file)
+	{
+		return false;
+	}
+
+	FILE_ATTRIBUTE_TAG_INFO tagInfo;
+
+	if (!GetFileInformationByHandleEx(file.get(), FileAttributeTagInfo, &tagInfo, sizeof(tagInfo))
+		|| WI_IsFlagSet(tagInfo.FileAttributes, FILE_ATTRIBUTE_REPARSE_POINT))
+	{
+		return false;
+	}
+
+	LARGE_INTEGER endOfFile;
+	endOfFile.QuadPart = overwriteSize;
+
+	if (!SetFilePointerEx(file.get(), endOfFile, nullptr, FILE_BEGIN) || !SetEndOfFile(file.get()))
+	{
+		return false;
+	}
+
+	bool res = OverwriteWithPass(file.get(), overwriteSize, 0x00, false, buffer, onBytesWritten);
+
+	if (!res)
+	{
+		return false;
+	}
+
+	if (m_options.overwriteMethod == NFileOperations::OverwriteMethod::ThreePass)
+	{
+		res = OverwriteWithPass(file.get(), overwriteSize, 0xFF, false, buffer, onBytesWritten);
+
+		if (!res)
+		{
+			return false;
+		}
+
+		res = OverwriteWithPass(file.get(), overwriteSize, 0x00, true, buffer, onBytesWritten);
+
+		if (!res)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FileShredder::OverwriteWithPass(HANDLE file, ULONGLONG size, BYTE fillByte, bool random,
+	AlignedBuffer &buffer, const std::function<void(ULONGLONG bytesWritten)> &onBytesWritten)
+{
+	LARGE_INTEGER start = {};
+
+	if (!SetFilePointerEx(file, start, nullptr, FILE_BEGIN))
+	{
+		return false;
+	}
+
+	if (!random)
+	{
+		// The buffer only needs to be filled once per pass, since its contents are the same for
+		// every block.
+		memset(buffer.Get(), fillByte, buffer.GetSize());
+	}
+
+	ULONGLONG remaining = size;
+
+	while (remaining > 0)
+	{
+		if (IsCancelled())
+		{
+			return false;
+		}
+
+		auto chunkSize = static_cast<DWORD>(std::min<ULONGLONG>(remaining, buffer.GetSize()));
+
+		if (random)
+		{
+			NTSTATUS status = BCryptGenRandom(nullptr, buffer.Get(), chunkSize,
+				BCRYPT_USE_SYSTEM_PREFERRED_RNG);
+
+			if (!BCRYPT_SUCCESS(status))
+			{
+				return false;
+			}
+		}
+
+		DWORD numBytesWritten;
+		BOOL res = WriteFile(file, buffer.Get(), chunkSize, &numBytesWritten, nullptr);
+
+		if (!res || numBytesWritten != chunkSize)
+		{
+			return false;
+		}
+
+		remaining -= chunkSize;
+
+		if (onBytesWritten)
+		{
+			onBytesWritten(chunkSize);
+		}
+	}
+
+	// Ensures the data from this pass actually reaches the disk before the next pass begins.
+	return FlushFileBuffers(file);
+}
+
+ULONGLONG FileShredder::GetTotalPassCount() const
+{
+	return m_options.overwriteMethod == NFileOperations::OverwriteMethod::ThreePass ? 3 : 1;
+}
+
+void FileShredder::Cancel()
+{
+	m_cancelled = true;
+}
+
+bool FileShredder::IsCancelled() const
+{
+	return m_cancelled;
+}
+
+void FileShredder::CollectItems(const std::wstring &path, std::vector<FileEntry> &files,
+	std::vector<std::wstring> &folders)
+{
+	DWORD attributes = GetFileAttributes(path.c_str());
+
+	if (attributes == INVALID_FILE_ATTRIBUTES)
+	{
+		return;
+	}
+
+	if (WI_IsFlagClear(attributes, FILE_ATTRIBUTE_DIRECTORY))
+	{
+		if (WI_IsFlagSet(attributes, FILE_ATTRIBUTE_REPARSE_POINT) && IsLink(path))
+		{
+			files.push_back({ path, 0, true });
+			return;
+		}
+
+		WIN32_FILE_ATTRIBUTE_DATA attributeData;
+
+		if (!GetFileAttributesEx(path.c_str(), GetFileExInfoStandard, &attributeData))
+		{
+			return;
+		}
+
+		ULARGE_INTEGER fileSize = { attributeData.nFileSizeLow, attributeData.nFileSizeHigh };
+		ULONGLONG allocatedSize;
+
+		if (!GetAllocatedFileSize(path, fileSize.QuadPart, allocatedSize))
+		{
+			allocatedSize = fileSize.QuadPart;
+		}
+
+		files.push_back({ path, allocatedSize, false });
+		return;
+	}
+
+	// Junctions and symbolic links to folders are removed, but not followed. Following them would
+	// result in the contents of the target folder being destroyed.
+	if (WI_IsFlagClear(attributes, FILE_ATTRIBUTE_REPARSE_POINT))
+	{
+		std::wstring searchPath = path + L"\\*";
+
+		WIN32_FIND_DATA findData;
+		wil::unique_hfind find(FindFirstFileEx(searchPath.c_str(), FindExInfoBasic, &findData,
+			FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH));
+
+		if (find)
+		{
+			do
+			{
+				if (lstrcmp(findData.cFileName, L".") == 0
+					|| lstrcmp(findData.cFileName, L"..") == 0)
+				{
+					continue;
+				}
+
+				CollectItems(path + L"\\" + findData.cFileName, files, folders);
+			} while (FindNextFile(find.get(), &findData));
+		}
+	}
+
+	folders.push_back(path);
+}
+
+bool FileShredder::GetAllocatedFileSize(const std::wstring &path, ULONGLONG fileSize,
+	ULONGLONG &allocatedSizeOut)
+{
+	TCHAR root[MAX_PATH];
+	HRESULT hr = StringCchCopy(root, SIZEOF_ARRAY(root), path.c_str());
+
+	if (FAILED(hr))
+	{
+		return false;
+	}
+
+	if (!PathStripToRoot(root))
+	{
+		return false;
+	}
+
+	DWORD clusterSize;
+
+	if (!GetClusterSize(root, &clusterSize) || clusterSize == 0)
+	{
+		return false;
+	}
+
+	allocatedSizeOut = fileSize;
+
+	// The allocated size is the logical size rounded up to the end of the final cluster.
+	if ((fileSize % clusterSize) != 0)
+	{
+		allocatedSizeOut += clusterSize - (fileSize % clusterSize);
+	}
+
+	return true;
+}
+
+bool FileShredder::IsLink(const std::wstring &path)
+{
+	wil::unique_hfile item(CreateFile(path.c_str(), FILE_READ_ATTRIBUTES,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+		FILE_FLAG_OPEN_REPARSE_POINT | FILE_FLAG_BACKUP_SEMANTICS, nullptr));
+
+	if (!item)
+	{
+		return false;
+	}
+
+	FILE_ATTRIBUTE_TAG_INFO tagInfo;
+
+	if (!GetFileInformationByHandleEx(item.get(), FileAttributeTagInfo, &tagInfo, sizeof(tagInfo)))
+	{
+		return false;
+	}
+
+	return WI_IsFlagSet(tagInfo.FileAttributes, FILE_ATTRIBUTE_REPARSE_POINT)
+		&& IsReparseTagNameSurrogate(tagInfo.ReparseTag);
+}
+
+FileShredder::AlignedBuffer::AlignedBuffer(SIZE_T size)
+{
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+
+	// Unbuffered writes require the buffer to be aligned on a sector boundary. Since memory
+	// allocated by VirtualAlloc is aligned on a page boundary (which is always a multiple of the
+	// sector size), that requirement will be met. The size is also rounded up, so that it's a
+	// multiple of the page size as well.
+	SIZE_T pageSize = systemInfo.dwPageSize;
+	m_size = std::max<SIZE_T>(((size + pageSize - 1) / pageSize) * pageSize, pageSize);
+	m_data = static_cast<BYTE *>(
+		VirtualAlloc(nullptr, m_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+
+	if (!m_data)
+	{
+		throw std::bad_alloc();
+	}
+}
+
+FileShredder::AlignedBuffer::~AlignedBuffer()
+{
+	VirtualFree(m_data, 0, MEM_RELEASE);
+}
+
+BYTE *FileShredder::AlignedBuffer::Get() const
+{
+	return m_data;
+}
+
+SIZE_T FileShredder::AlignedBuffer::GetSize() const
+{
+	return m_size;
+}
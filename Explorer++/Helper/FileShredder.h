@@ -0,0 +1,110 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "FileOperations.h"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Securely overwrites and then deletes files. Data is written in large blocks from a single
+// reusable buffer, so that the number of write calls is proportional to the size of the file
+// divided by the block size, rather than to the size of the file itself.
+class FileShredder
+{
+public:
+	struct Options
+	{
+		NFileOperations::OverwriteMethod overwriteMethod =
+			NFileOperations::OverwriteMethod::OnePass;
+
+		// If set, files will be opened with FILE_FLAG_NO_BUFFERING and FILE_FLAG_WRITE_THROUGH, so
+		// that each pass goes directly to the device, rather than being combined with the
+		// following pass in the system cache.
+		bool unbuffered = true;
+
+		// The size of each write. This will be rounded up to a multiple of the page size.
+		DWORD blockSize = 1024 * 1024;
+
+		// The maximum number of files that will be overwritten at the same time when shredding a
+		// set of items.
+		int maxParallelFiles = 4;
+	};
+
+	struct Progress
+	{
+		ULONGLONG bytesWritten;
+		ULONGLONG totalBytes;
+		int filesCompleted;
+		int totalFiles;
+	};
+
+	// Note that, when shredding multiple files, this will be invoked from worker threads.
+	using ProgressCallback = std::function<void(const Progress &progress)>;
+
+	explicit FileShredder(const Options &options);
+
+	// Overwrites and deletes each of the specified items. Folders are shredded recursively, with
+	// the folders themselves being removed once all the files within them have been destroyed.
+	// Returns true only if every item was successfully removed.
+	bool ShredItems(const std::vector<std::wstring> &paths, ProgressCallback progressCallback);
+
+	// If the path refers to a symbolic link, the link will be deleted without being overwritten.
+	bool ShredFile(const std::wstring &path);
+
+	// Overwrites the contents of the file (including the slack space at the end of its final
+	// cluster), without deleting it. Fails if the path refers to a reparse point, rather than
+	// writing through it.
+	bool OverwriteFile(const std::wstring &path);
+
+	// May be called from any thread. Any in-progress file will be left in a partially overwritten
+	// state and won't be deleted.
+	void Cancel();
+	bool IsCancelled() const;
+
+private:
+	struct FileEntry
+	{
+		std::wstring path;
+		ULONGLONG size;
+
+		// Symbolic links (and other name surrogates) are deleted without being overwritten, since
+		// overwriting them would destroy the contents of their target.
+		bool isLink;
+	};
+
+	class AlignedBuffer
+	{
+	public:
+		explicit AlignedBuffer(SIZE_T size);
+		~AlignedBuffer();
+
+		AlignedBuffer(const AlignedBuffer &) = delete;
+		AlignedBuffer &operator=(const AlignedBuffer &) = delete;
+
+		BYTE *Get() const;
+		SIZE_T GetSize() const;
+
+	private:
+		BYTE *m_data;
+		SIZE_T m_size;
+	};
+
+	bool OverwriteFile(const std::wstring &path, AlignedBuffer &buffer,
+		const std::function<void(ULONGLONG bytesWritten)> &onBytesWritten);
+	bool OverwriteWithPass(HANDLE file, ULONGLONG size, BYTE fillByte, bool random,
+		AlignedBuffer &buffer, const std::function<void(ULONGLONG bytesWritten)> &onBytesWritten);
+	ULONGLONG GetTotalPassCount() const;
+
+	static void CollectItems(const std::wstring &path, std::vector<FileEntry> &files,
+		std::vector<std::wstring> &folders);
+	static bool GetAllocatedFileSize(const std::wstring &path, ULONGLONG fileSize,
+		ULONGLONG &allocatedSizeOut);
+	static bool IsLink(const std::wstring &path);
+
+	const Options m_options;
+	std::atomic<bool> m_cancelled;
+};
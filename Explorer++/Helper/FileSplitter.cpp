@@ -0,0 +1,238 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FileSplitter.h"
+#include "ChecksumManifest.h"
+#include "Sha256Hasher.h"
+#include <wil/resource.h>
+#include <algorithm>
+#include <optional>
+
+FileSplitter::FileSplitter(const std::wstring &inputPath, PartPathGenerator partPathGenerator,
+	const Options &options) :
+	m_inputPath(inputPath),
+	m_partPathGenerator(partPathGenerator),
+	m_options(options),
+	m_cancelled(false)
+{
+	assert(m_options.partSize > 0);
+}
+
+FileSplitter::Result FileSplitter::Split(ProgressCallback progressCallback)
+{
+	std::vector<std::wstring> createdParts;
+	Result result = SplitIntoParts(progressCallback, createdParts);
+
+	if (result != Result::Succeeded)
+	{
+		for (const auto &part : createdParts)
+		{
+			DeleteFile(part.c_str());
+		}
+	}
+
+	return result;
+}
+
+// Each part is added to createdParts as it's created. Any part that's still open is closed
+// before this function returns, so that the parts can then be deleted.
+FileSplitter::Result FileSplitter::SplitIntoParts(ProgressCallback progressCallback,
+	std::vector<std::wstring> &createdParts)
+{
+	WIN32_FILE_ATTRIBUTE_DATA fileAttributes;
+	BOOL res = GetFileAttributesEx(m_inputPath.c_str(), GetFileExInfoStandard, &fileAttributes);
+
+	if (!res)
+	{
+		return Result::InputFileError;
+	}
+
+	ULARGE_INTEGER fileSize;
+	fileSize.LowPart = fileAttributes.nFileSizeLow;
+	fileSize.HighPart = fileAttributes.nFileSizeHigh;
+
+	if (fileSize.QuadPart == 0)
+	{
+		return Result::InputFileEmpty;
+	}
+
+	Progress progress;
+	progress.bytesProcessed = 0;
+	progress.totalBytes = fileSize.QuadPart;
+	progress.partsCompleted = 0;
+	progress.totalParts = CalculateNumParts(fileSize.QuadPart, m_options.partSize);
+	progress.bytesPerSecond = 0;
+
+	ULONGLONG startTime = GetTickCount64();
+	ULONGLONG lastUpdateTime = 0;
+
+	auto updateProgress = [&](bool force)
+	{
+		if (!progressCallback)
+		{
+			return;
+		}
+
+		ULONGLONG currentTime = GetTickCount64();
+
+		if (!force && (currentTime - lastUpdateTime) < PROGRESS_UPDATE_INTERVAL_MS)
+		{
+			return;
+		}
+
+		ULONGLONG elapsedTime = currentTime - startTime;
+
+		if (elapsedTime > 0)
+		{
+			progress.bytesPerSecond =
+				static_cast<double>(progress.bytesProcessed) * 1000.0 / elapsedTime;
+		}
+
+		lastUpdateTime = currentTime;
+		progressCallback(progress);
+	};
+
+	std::optional<Sha256Hasher> hasher;
+
+	if (!m_options.manifestPath.empty())
+	{
+		hasher.emplace();
+	}
+
+	std::vector<ChecksumManifest::Entry> manifestEntries;
+
+	wil::unique_hfile outputFile;
+	std::wstring outputPath;
+	ULONGLONG partNumber = 0;
+	ULONGLONG bytesInPart = 0;
+
+	auto finishPart = [&]()
+	{
+		outputFile.reset();
+
+		if (hasher)
+		{
+			auto checksum = hasher->Finish();
+
+			if (!checksum)
+			{
+				return false;
+			}
+
+			manifestEntries.push_back({ PathFindFileName(outputPath.c_str()), *checksum });
+		}
+
+		progress.partsCompleted++;
+		updateProgress(true);
+
+		return true;
+	};
+
+	PipelinedFileReader reader({ m_inputPath }, m_options.blockSize, m_options.numBuffers);
+	PipelinedFileReader::Block block;
+
+	while (reader.ReadNextBlock(block))
+	{
+		if (m_cancelled)
+		{
+			return Result::Cancelled;
+		}
+
+		const BYTE *data = block.data;
+		DWORD remaining = block.size;
+
+		while (remaining > 0)
+		{
+			if (!outputFile)
+			{
+				partNumber++;
+				outputPath = m_partPathGenerator(partNumber);
+
+				// Existing files are never overwritten.
+				outputFile.reset(CreateFile(outputPath.c_str(), GENERIC_WRITE, 0, nullptr,
+					CREATE_NEW, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+
+				if (!outputFile)
+				{
+					return Result::OutputFileError;
+				}
+
+				createdParts.push_back(outputPath);
+				bytesInPart = 0;
+			}
+
+			auto numBytesToWrite = static_cast<DWORD>(
+				std::min<ULONGLONG>(remaining, m_options.partSize - bytesInPart));
+
+			DWORD numBytesWritten;
+			res = WriteFile(outputFile.get(), data, numBytesToWrite, &numBytesWritten, nullptr);
+
+			if (!res || numBytesWritten != numBytesToWrite)
+			{
+				return Result::OutputFileError;
+			}
+
+			if (hasher && !hasher->Update(data, numBytesToWrite))
+			{
+				return Result::ManifestError;
+			}
+
+			data += numBytesToWrite;
+			remaining -= numBytesToWrite;
+			bytesInPart += numBytesToWrite;
+			progress.bytesProcessed += numBytesToWrite;
+
+			if (bytesInPart == m_options.partSize && !finishPart())
+			{
+				return Result::ManifestError;
+			}
+		}
+
+		updateProgress(false);
+	}
+
+	if (m_cancelled)
+	{
+		return Result::Cancelled;
+	}
+
+	if (reader.GetState() != PipelinedFileReader::State::Finished)
+	{
+		return Result::InputFileError;
+	}
+
+	// The final part will be smaller than the others if the file size isn't an exact multiple of
+	// the part size.
+	if (outputFile && !finishPart())
+	{
+		return Result::ManifestError;
+	}
+
+	if (hasher && !ChecksumManifest::Write(m_options.manifestPath, manifestEntries))
+	{
+		return Result::ManifestError;
+	}
+
+	updateProgress(true);
+
+	return Result::Succeeded;
+}
+
+void FileSplitter::Cancel()
+{
+	m_cancelled = true;
+}
+
+ULONGLONG FileSplitter::CalculateNumParts(ULONGLONG fileSize, ULONGLONG partSize)
+{
+	ULONGLONG numParts = fileSize / partSize;
+
+	if ((fileSize % partSize) != 0)
+	{
+		numParts++;
+	}
+
+	return numParts;
+}
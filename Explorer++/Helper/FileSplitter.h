@@ -0,0 +1,82 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include "PipelinedFileReader.h"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Splits a file into a set of fixed-size parts. The input is streamed through a small, fixed set
+// of buffers (with the next block being read while the previous block is written out), so the
+// amount of memory used doesn't depend on the size of each part.
+class FileSplitter
+{
+public:
+	struct Options
+	{
+		ULONGLONG partSize = 0;
+
+		// If set, a checksum manifest, listing the SHA-256 digest of each part, will be written to
+		// this path.
+		std::wstring manifestPath;
+
+		DWORD blockSize = PipelinedFileReader::DEFAULT_BLOCK_SIZE;
+		int numBuffers = PipelinedFileReader::DEFAULT_NUM_BUFFERS;
+	};
+
+	struct Progress
+	{
+		ULONGLONG bytesProcessed;
+		ULONGLONG totalBytes;
+		ULONGLONG partsCompleted;
+		ULONGLONG totalParts;
+		double bytesPerSecond;
+	};
+
+	enum class Result
+	{
+		Succeeded,
+		Cancelled,
+		InputFileError,
+
+		// There's nothing to split, so no parts are created.
+		InputFileEmpty,
+
+		OutputFileError,
+		ManifestError
+	};
+
+	// Returns the full path for the specified part. Parts are numbered from 1.
+	using PartPathGenerator = std::function<std::wstring(ULONGLONG partNumber)>;
+
+	// Invoked on the thread that called Split(). Progress updates are rate limited, though an
+	// update will always be sent as each part is completed.
+	using ProgressCallback = std::function<void(const Progress &progress)>;
+
+	FileSplitter(const std::wstring &inputPath, PartPathGenerator partPathGenerator,
+		const Options &options);
+
+	// If the split doesn't succeed, any parts that were created are deleted, so that a partial
+	// set of parts isn't left behind.
+	Result Split(ProgressCallback progressCallback);
+
+	// Can be called from any thread.
+	void Cancel();
+
+	static ULONGLONG CalculateNumParts(ULONGLONG fileSize, ULONGLONG partSize);
+
+private:
+	static const ULONGLONG PROGRESS_UPDATE_INTERVAL_MS = 100;
+
+	Result SplitIntoParts(ProgressCallback progressCallback,
+		std::vector<std::wstring> &createdParts);
+
+	const std::wstring m_inputPath;
+	const PartPathGenerator m_partPathGenerator;
+	const Options m_options;
+	std::atomic<bool> m_cancelled;
+};
@@ -0,0 +1,121 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FileSystemLinks.h"
+
+#ifdef _WIN32
+#include <wil/resource.h>
+#else
+#include <sys/stat.h>
+#endif
+
+bool IsFileSystemLink(const std::filesystem::path &path, std::error_code &error)
+{
+	auto status = std::filesystem::symlink_status(path, error);
+
+	if (error)
+	{
+		return false;
+	}
+
+	if (status.type() == std::filesystem::file_type::symlink)
+	{
+		return true;
+	}
+
+#ifdef _WIN32
+	DWORD attributes = GetFileAttributes(path.c_str());
+
+	if (attributes == INVALID_FILE_ATTRIBUTES
+		|| WI_IsFlagClear(attributes, FILE_ATTRIBUTE_REPARSE_POINT))
+	{
+		return false;
+	}
+
+	// Other types of reparse point (e.g. cloud file placeholders) stand in for the item itself,
+	// rather than pointing somewhere else, so they're not treated as links.
+	WIN32_FIND_DATA findData;
+	wil::unique_hfind findHandle(FindFirstFile(path.c_str(), &findData));
+
+	return !findHandle || IsReparseTagNameSurrogate(findData.dwReserved0);
+#else
+	return false;
+#endif
+}
+
+std::optional<FileIdentity> GetFileIdentity(const std::filesystem::path &path)
+{
+#ifdef _WIN32
+	// Only the attributes are needed, so the file can be opened even if another process has it
+	// open for writing.
+	wil::unique_hfile file(CreateFile(path.c_str(), FILE_READ_ATTRIBUTES,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+		FILE_FLAG_BACKUP_SEMANTICS, nullptr));
+
+	if (!file)
+	{
+		return std::nullopt;
+	}
+
+	BY_HANDLE_FILE_INFORMATION info;
+
+	if (!GetFileInformationByHandle(file.get(), &info))
+	{
+		return std::nullopt;
+	}
+
+	return FileIdentity{ info.dwVolumeSerialNumber,
+		(static_cast<std::uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow };
+#else
+	struct stat info;
+
+	if (stat(path.c_str(), &info) != 0)
+	{
+		return std::nullopt;
+	}
+
+	return FileIdentity{ static_cast<std::uint64_t>(info.st_dev),
+		static_cast<std::uint64_t>(info.st_ino) };
+#endif
+}
+
+bool IsPathSameOrWithin(const std::filesystem::path &path, const std::filesystem::path &parent)
+{
+	auto pathItr = path.begin();
+
+	for (const auto &parentComponent : parent)
+	{
+		// A trailing separator results in an empty final component, which can be ignored.
+		if (parentComponent.empty())
+		{
+			continue;
+		}
+
+		if (pathItr == path.end())
+		{
+			return false;
+		}
+
+		const auto &name1 = pathItr->native();
+		const auto &name2 = parentComponent.native();
+
+#ifdef _WIN32
+		bool namesMatch = CompareStringOrdinal(name1.c_str(), static_cast<int>(name1.size()),
+							  name2.c_str(), static_cast<int>(name2.size()), TRUE)
+			== CSTR_EQUAL;
+#else
+		bool namesMatch = (name1 == name2);
+#endif
+
+		if (!namesMatch)
+		{
+			return false;
+		}
+
+		++pathItr;
+	}
+
+	return true;
+}
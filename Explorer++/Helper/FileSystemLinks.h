@@ -0,0 +1,32 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <system_error>
+
+// Identifies a file independently of the path used to reach it. Two paths that are hard links to
+// the same file will have the same identity.
+struct FileIdentity
+{
+	std::uint64_t volume;
+	std::uint64_t file;
+
+	auto operator<=>(const FileIdentity &) const = default;
+};
+
+// Returns true if the path is a link to another item (a symbolic link or, on Windows, a junction
+// or volume mount point). is_symlink() isn't sufficient on Windows, since it returns false for
+// junctions.
+bool IsFileSystemLink(const std::filesystem::path &path, std::error_code &error);
+
+std::optional<FileIdentity> GetFileIdentity(const std::filesystem::path &path);
+
+// Returns true if path is the same as, or is contained within, parent. Both paths should be
+// canonical. As on Windows, the names of each component are compared case-insensitively.
+bool IsPathSameOrWithin(const std::filesystem::path &path, const std::filesystem::path &parent);
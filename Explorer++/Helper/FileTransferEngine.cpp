@@ -0,0 +1,897 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FileTransferEngine.h"
+#include "FileSystemLinks.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <thread>
+
+#ifdef _WIN32
+#include <wil/resource.h>
+#endif
+
+namespace
+{
+
+// Copies any alternate data streams the file has. On Windows, that includes the Zone.Identifier
+// stream, which records where a downloaded file came from. Only the file's main data stream is
+// copied by the transfer itself.
+bool CopyAlternateStreams([[maybe_unused]] const std::filesystem::path &source,
+	[[maybe_unused]] const std::filesystem::path &destination)
+{
+#ifdef _WIN32
+	WIN32_FIND_STREAM_DATA streamData;
+	wil::unique_hfind findHandle(
+		FindFirstStreamW(source.c_str(), FindStreamInfoStandard, &streamData, 0));
+
+	// This will fail if the file has no streams to enumerate, or the file system doesn't support
+	// streams. Either way, there's nothing to copy.
+	if (!findHandle)
+	{
+		return true;
+	}
+
+	do
+	{
+		// This is the unnamed stream, which holds the file's contents.
+		if (std::wstring_view(streamData.cStreamName) == L"::$DATA")
+		{
+			continue;
+		}
+
+		std::ifstream input(source.native() + streamData.cStreamName, std::ios::binary);
+		std::vector<char> data((std::istreambuf_iterator<char>(input)),
+			std::istreambuf_iterator<char>());
+
+		if (input.bad())
+		{
+			return false;
+		}
+
+		std::ofstream output(destination.native() + streamData.cStreamName,
+			std::ios::binary | std::ios::trunc);
+		output.write(data.data(), data.size());
+		output.close();
+
+		if (!output)
+		{
+			return false;
+		}
+	} while (FindNextStreamW(findHandle.get(), &streamData));
+#endif
+
+	return true;
+}
+
+// Gives the destination the same attributes as the source (on Windows) or the same permissions
+// (elsewhere).
+void CopyAttributes(const std::filesystem::path &source, const std::filesystem::path &destination,
+	std::error_code &error)
+{
+#ifdef _WIN32
+	// Attributes like compression and encryption are determined by the destination directory,
+	// rather than being copied.
+	const DWORD copiedAttributes = FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_HIDDEN
+		| FILE_ATTRIBUTE_SYSTEM | FILE_ATTRIBUTE_ARCHIVE | FILE_ATTRIBUTE_NOT_CONTENT_INDEXED;
+
+	DWORD attributes = GetFileAttributes(source.c_str());
+
+	if (attributes == INVALID_FILE_ATTRIBUTES)
+	{
+		error = std::error_code(GetLastError(), std::system_category());
+		return;
+	}
+
+	attributes &= copiedAttributes;
+
+	if (!SetFileAttributes(destination.c_str(),
+			attributes != 0 ? attributes : FILE_ATTRIBUTE_NORMAL))
+	{
+		error = std::error_code(GetLastError(), std::system_category());
+	}
+#else
+	auto status = std::filesystem::status(source, error);
+
+	if (!error)
+	{
+		std::filesystem::permissions(destination, status.permissions(), error);
+	}
+#endif
+}
+
+// Gives the destination file the same timestamps and attributes as the source file.
+void CopyFileMetadata(const std::filesystem::path &source,
+	const std::filesystem::path &destination, std::error_code &error)
+{
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA sourceData;
+
+	if (!GetFileAttributesEx(source.c_str(), GetFileExInfoStandard, &sourceData))
+	{
+		error = std::error_code(GetLastError(), std::system_category());
+		return;
+	}
+
+	wil::unique_hfile destinationFile(CreateFile(destination.c_str(), FILE_WRITE_ATTRIBUTES,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+		FILE_FLAG_BACKUP_SEMANTICS, nullptr));
+
+	if (!destinationFile
+		|| !SetFileTime(destinationFile.get(), &sourceData.ftCreationTime, nullptr,
+			&sourceData.ftLastWriteTime))
+	{
+		error = std::error_code(GetLastError(), std::system_category());
+		return;
+	}
+#else
+	auto modificationTime = std::filesystem::last_write_time(source, error);
+
+	if (!error)
+	{
+		std::filesystem::last_write_time(destination, modificationTime, error);
+	}
+
+	if (error)
+	{
+		return;
+	}
+#endif
+
+	// The attributes are set last, since the file may be read-only.
+	CopyAttributes(source, destination, error);
+}
+
+struct DirectoryWalkResult
+{
+	std::vector<FileTransferPlan::Directory> directories;
+	std::vector<FileTransferPlan::File> files;
+	std::vector<FileTransferError> errors;
+};
+
+// Lists the contents of a single directory. Subdirectories are returned in the result, so that
+// they can be queued up and walked by any of the planning threads.
+void WalkDirectory(const FileTransferPlan::Directory &directory, DirectoryWalkResult &result)
+{
+	std::error_code error;
+	std::filesystem::directory_iterator itr(directory.source, error);
+
+	for (; !error && itr != std::filesystem::directory_iterator(); itr.increment(error))
+	{
+		const auto &entry = *itr;
+		auto destination = directory.destination / entry.path().filename();
+
+		std::error_code entryError;
+
+		if (entry.is_directory(entryError))
+		{
+			// Links to directories aren't followed, since they could lead outside of (or back
+			// into) the tree being transferred. When moving, following a link would also result
+			// in the contents of the linked directory being deleted.
+			if (IsFileSystemLink(entry.path(), entryError) || entryError)
+			{
+				result.errors.push_back({ entry.path(),
+					entryError ? entryError
+							   : std::make_error_code(std::errc::operation_not_supported) });
+				continue;
+			}
+
+			result.directories.push_back({ entry.path(), destination, directory.rootIndex });
+			continue;
+		}
+
+		auto size = entry.file_size(entryError);
+
+		if (entryError)
+		{
+			result.errors.push_back({ entry.path(), entryError });
+			continue;
+		}
+
+		result.files.push_back({ entry.path(), destination, size, directory.rootIndex });
+	}
+
+	if (error)
+	{
+		result.errors.push_back({ directory.source, error });
+	}
+}
+
+}
+
+FileTransferEngine::FileTransferEngine(const Options &options) : m_options(options)
+{
+}
+
+std::optional<FileTransferPlan> FileTransferEngine::BuildPlan(
+	const std::vector<std::filesystem::path> &sources,
+	const std::filesystem::path &destinationDirectory) const
+{
+	std::error_code error;
+	auto canonicalDestination = std::filesystem::weakly_canonical(destinationDirectory, error);
+
+	if (error)
+	{
+		return std::nullopt;
+	}
+
+	FileTransferPlan plan;
+	std::deque<FileTransferPlan::Directory> pendingDirectories;
+
+	for (const auto &source : sources)
+	{
+		auto canonicalSource = std::filesystem::weakly_canonical(source, error);
+
+		if (error || IsPathSameOrWithin(canonicalDestination, canonicalSource))
+		{
+			return std::nullopt;
+		}
+
+		auto status = std::filesystem::status(source, error);
+
+		if (error)
+		{
+			plan.errors.push_back({ source, error });
+			continue;
+		}
+
+		bool isDirectory = std::filesystem::is_directory(status);
+
+		// As with the items within each directory, a selected link to a directory isn't followed.
+		if (isDirectory && (IsFileSystemLink(source, error) || error))
+		{
+			plan.errors.push_back({ source,
+				error ? error : std::make_error_code(std::errc::operation_not_supported) });
+			continue;
+		}
+
+		size_t rootIndex = plan.roots.size();
+		auto destination = destinationDirectory / canonicalSource.filename();
+		plan.roots.push_back({ source, destination, isDirectory });
+
+		if (isDirectory)
+		{
+			plan.directories.push_back({ source, destination, rootIndex });
+			pendingDirectories.push_back(plan.directories.back());
+		}
+		else
+		{
+			auto size = std::filesystem::file_size(source, error);
+
+			if (error)
+			{
+				plan.errors.push_back({ source, error });
+				plan.roots.pop_back();
+				continue;
+			}
+
+			plan.files.push_back({ source, destination, size, rootIndex });
+		}
+	}
+
+	// Directories are handed out one at a time. Once a directory has been listed, its
+	// subdirectories are added back to the queue. The walk is complete once the queue is empty
+	// and no thread is still listing a directory.
+	std::mutex mutex;
+	std::condition_variable condition;
+	int numActiveThreads = 0;
+
+	auto walkDirectories = [&]()
+	{
+		while (true)
+		{
+			std::unique_lock lock(mutex);
+			condition.wait(lock,
+				[&]
+				{
+					return !pendingDirectories.empty() || numActiveThreads == 0;
+				});
+
+			if (pendingDirectories.empty())
+			{
+				return;
+			}
+
+			auto directory = pendingDirectories.front();
+			pendingDirectories.pop_front();
+			numActiveThreads++;
+			lock.unlock();
+
+			DirectoryWalkResult result;
+			WalkDirectory(directory, result);
+
+			lock.lock();
+			numActiveThreads--;
+
+			for (auto &subdirectory : result.directories)
+			{
+				pendingDirectories.push_back(subdirectory);
+				plan.directories.push_back(std::move(subdirectory));
+			}
+
+			std::move(result.files.begin(), result.files.end(), std::back_inserter(plan.files));
+			std::move(result.errors.begin(), result.errors.end(), std::back_inserter(plan.errors));
+			condition.notify_all();
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	for (int i = 1; i < m_options.numPlanningThreads; i++)
+	{
+		threads.emplace_back(walkDirectories);
+	}
+
+	walkDirectories();
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	std::sort(plan.directories.begin(), plan.directories.end(),
+		[](const auto &directory1, const auto &directory2)
+		{
+			return directory1.destination < directory2.destination;
+		});
+
+	std::sort(plan.files.begin(), plan.files.end(),
+		[](const auto &file1, const auto &file2)
+		{
+			return file1.destination < file2.destination;
+		});
+
+	for (const auto &file : plan.files)
+	{
+		plan.totalBytes += file.size;
+	}
+
+	return plan;
+}
+
+size_t FileTransferEngine::CountConflicts(const FileTransferPlan &plan) const
+{
+	// Nothing within a root can already exist if the root's destination doesn't, which is
+	// typically the case, so most files don't need to be checked individually.
+	std::vector<bool> rootsExist;
+
+	for (const auto &root : plan.roots)
+	{
+		std::error_code error;
+		rootsExist.push_back(std::filesystem::exists(root.destination, error));
+	}
+
+	size_t numConflicts = 0;
+
+	for (const auto &file : plan.files)
+	{
+		std::error_code error;
+
+		if (rootsExist[file.rootIndex] && std::filesystem::exists(file.destination, error))
+		{
+			numConflicts++;
+		}
+	}
+
+	return numConflicts;
+}
+
+bool FileTransferEngine::Run(const FileTransferPlan &plan)
+{
+	{
+		std::scoped_lock lock(m_mutex);
+		m_startTime = std::chrono::steady_clock::now();
+	}
+
+	m_totalBytes = plan.totalBytes;
+	m_totalFiles = plan.files.size();
+
+	std::vector<bool> rootsMoved = TryMoveRoots(plan);
+	CreateDirectories(plan, rootsMoved);
+
+	std::vector<const FileTransferPlan::File *> smallFiles;
+	std::vector<const FileTransferPlan::File *> largeFiles;
+
+	for (const auto &file : plan.files)
+	{
+		if (rootsMoved[file.rootIndex])
+		{
+			m_transferredBytes += file.size;
+			m_skippedBytes += file.size;
+			m_completedFiles++;
+			continue;
+		}
+
+		if (file.size >= m_options.largeFileThreshold)
+		{
+			largeFiles.push_back(&file);
+		}
+		else
+		{
+			smallFiles.push_back(&file);
+		}
+	}
+
+	// Large files are limited by throughput, while small files are limited by the per-file
+	// overhead. Processing both at the same time keeps the disk busy throughout.
+	std::thread largeFileThread(&FileTransferEngine::TransferLargeFiles, this, largeFiles);
+	TransferSmallFiles(smallFiles);
+	largeFileThread.join();
+
+	CopyDirectoryAttributes(plan, rootsMoved);
+
+	if (m_options.operation == Operation::Move)
+	{
+		RemoveSourceDirectories(plan, rootsMoved);
+	}
+
+	std::scoped_lock lock(m_mutex);
+	return !m_cancelled && m_errors.empty();
+}
+
+// When moving items within a single volume, each of the selected items can simply be renamed,
+// without having to touch any of the items within it. If the destination already exists (or is
+// on a different volume), the item's contents will be transferred individually instead.
+std::vector<bool> FileTransferEngine::TryMoveRoots(const FileTransferPlan &plan)
+{
+	std::vector<bool> rootsMoved(plan.roots.size(), false);
+
+	if (m_options.operation != Operation::Move)
+	{
+		return rootsMoved;
+	}
+
+	for (size_t i = 0; i < plan.roots.size(); i++)
+	{
+		const auto &root = plan.roots[i];
+		std::error_code error;
+
+		if (std::filesystem::exists(root.destination, error) || error)
+		{
+			continue;
+		}
+
+		std::filesystem::rename(root.source, root.destination, error);
+		rootsMoved[i] = !error;
+	}
+
+	return rootsMoved;
+}
+
+void FileTransferEngine::CreateDirectories(const FileTransferPlan &plan,
+	const std::vector<bool> &rootsMoved)
+{
+	for (const auto &directory : plan.directories)
+	{
+		if (rootsMoved[directory.rootIndex])
+		{
+			continue;
+		}
+
+		std::error_code error;
+		std::filesystem::create_directory(directory.destination, error);
+
+		// Any files within a directory that couldn't be created will fail individually.
+		if (error)
+		{
+			AddError(directory.destination, error);
+		}
+	}
+}
+
+void FileTransferEngine::TransferSmallFiles(
+	const std::vector<const FileTransferPlan::File *> &files)
+{
+	std::atomic<size_t> nextIndex = 0;
+
+	auto transferFiles = [&]()
+	{
+		// Each thread reuses a single buffer for all the files it processes.
+		std::vector<char> buffer;
+
+		for (size_t index = nextIndex++; index < files.size() && !m_cancelled; index = nextIndex++)
+		{
+			TransferSmallFile(*files[index], buffer);
+		}
+	};
+
+	int numThreads = std::min<int>(m_options.numSmallFileThreads, static_cast<int>(files.size()));
+	std::vector<std::thread> threads;
+
+	for (int i = 1; i < numThreads; i++)
+	{
+		threads.emplace_back(transferFiles);
+	}
+
+	transferFiles();
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+}
+
+void FileTransferEngine::TransferLargeFiles(
+	const std::vector<const FileTransferPlan::File *> &files)
+{
+	if (files.empty())
+	{
+		return;
+	}
+
+	std::vector<char> readBuffer(m_options.largeFileBlockSize);
+	std::vector<char> writeBuffer(m_options.largeFileBlockSize);
+
+	for (const auto *file : files)
+	{
+		if (m_cancelled)
+		{
+			break;
+		}
+
+		TransferLargeFile(*file, readBuffer, writeBuffer);
+	}
+}
+
+bool FileTransferEngine::TransferSmallFile(const FileTransferPlan::File &file,
+	std::vector<char> &buffer)
+{
+	auto destinationState = CheckDestination(file);
+
+	if (destinationState == DestinationState::Conflict)
+	{
+		return false;
+	}
+	else if (destinationState == DestinationState::Skipped)
+	{
+		m_transferredBytes += file.size;
+		m_skippedBytes += file.size;
+		m_completedFiles++;
+		return true;
+	}
+	else if (destinationState == DestinationState::Complete || TryRenameFile(file))
+	{
+		m_transferredBytes += file.size;
+		m_skippedBytes += file.size;
+		return FinishFile(file);
+	}
+
+	buffer.resize(static_cast<size_t>(file.size));
+
+	std::ifstream input(file.source, std::ios::binary);
+	input.read(buffer.data(), buffer.size());
+
+	// The file may have changed size since the plan was built.
+	if (!input || input.peek() != std::ifstream::traits_type::eof())
+	{
+		AddError(file.source, std::make_error_code(std::errc::io_error));
+		return false;
+	}
+
+	std::ofstream output(file.destination, std::ios::binary | std::ios::trunc);
+	output.write(buffer.data(), buffer.size());
+	output.close();
+
+	if (!output || !CopyAlternateStreams(file.source, file.destination))
+	{
+		AddError(file.destination, std::make_error_code(std::errc::io_error));
+		return false;
+	}
+
+	m_transferredBytes += file.size;
+
+	return FinishFile(file);
+}
+
+bool FileTransferEngine::TransferLargeFile(const FileTransferPlan::File &file,
+	std::vector<char> &readBuffer, std::vector<char> &writeBuffer)
+{
+	auto destinationState = CheckDestination(file);
+
+	if (destinationState == DestinationState::Conflict)
+	{
+		return false;
+	}
+	else if (destinationState == DestinationState::Skipped)
+	{
+		m_transferredBytes += file.size;
+		m_skippedBytes += file.size;
+		m_completedFiles++;
+		return true;
+	}
+	else if (destinationState == DestinationState::Complete || TryRenameFile(file))
+	{
+		m_transferredBytes += file.size;
+		m_skippedBytes += file.size;
+		return FinishFile(file);
+	}
+
+	// The streams are unbuffered, since each read and write is already a large block.
+	std::ifstream input;
+	input.rdbuf()->pubsetbuf(nullptr, 0);
+	input.open(file.source, std::ios::binary);
+
+	if (!input)
+	{
+		AddError(file.source, std::make_error_code(std::errc::io_error));
+		return false;
+	}
+
+	std::ofstream output;
+	output.rdbuf()->pubsetbuf(nullptr, 0);
+	output.open(file.destination, std::ios::binary | std::ios::trunc);
+
+	if (m_options.preallocate && output)
+	{
+		std::error_code error;
+		std::filesystem::resize_file(file.destination, file.size, error);
+
+		if (error)
+		{
+			AddError(file.destination, error);
+			return false;
+		}
+	}
+
+	auto readBlock = [&input](std::vector<char> &buffer)
+	{
+		input.read(buffer.data(), buffer.size());
+		return static_cast<size_t>(input.gcount());
+	};
+
+	std::uintmax_t bytesWritten = 0;
+	size_t readSize = readBlock(readBuffer);
+
+	while (readSize > 0 && output && !m_cancelled)
+	{
+		std::swap(readBuffer, writeBuffer);
+		size_t writeSize = readSize;
+
+		// The next block is read while the current one is written.
+		auto nextRead = std::async(std::launch::async, readBlock, std::ref(readBuffer));
+		output.write(writeBuffer.data(), writeSize);
+		readSize = nextRead.get();
+
+		bytesWritten += writeSize;
+		m_transferredBytes += writeSize;
+	}
+
+	output.close();
+
+	if (m_cancelled)
+	{
+		return false;
+	}
+
+	if (!output)
+	{
+		AddError(file.destination, std::make_error_code(std::errc::io_error));
+		return false;
+	}
+
+	if (input.bad() || bytesWritten != file.size)
+	{
+		AddError(file.source, std::make_error_code(std::errc::io_error));
+		return false;
+	}
+
+	if (!CopyAlternateStreams(file.source, file.destination))
+	{
+		AddError(file.destination, std::make_error_code(std::errc::io_error));
+		return false;
+	}
+
+	return FinishFile(file);
+}
+
+FileTransferEngine::DestinationState FileTransferEngine::CheckDestination(
+	const FileTransferPlan::File &file)
+{
+	std::error_code error;
+
+	if (!std::filesystem::exists(file.destination, error) && !error)
+	{
+		return DestinationState::Pending;
+	}
+
+	if (!m_options.resume)
+	{
+		if (m_options.conflictAction == ConflictAction::Skip)
+		{
+			return DestinationState::Skipped;
+		}
+		else if (m_options.conflictAction == ConflictAction::Overwrite)
+		{
+			return DestinationState::Pending;
+		}
+
+		AddError(file.destination, std::make_error_code(std::errc::file_exists));
+		return DestinationState::Conflict;
+	}
+
+	auto destinationSize = std::filesystem::file_size(file.destination, error);
+
+	if (error || destinationSize != file.size)
+	{
+		return DestinationState::Pending;
+	}
+
+	auto sourceTime = std::filesystem::last_write_time(file.source, error);
+
+	if (error)
+	{
+		return DestinationState::Pending;
+	}
+
+	auto destinationTime = std::filesystem::last_write_time(file.destination, error);
+
+	if (error || destinationTime != sourceTime)
+	{
+		return DestinationState::Pending;
+	}
+
+	return DestinationState::Complete;
+}
+
+bool FileTransferEngine::TryRenameFile(const FileTransferPlan::File &file)
+{
+	if (m_options.operation != Operation::Move)
+	{
+		return false;
+	}
+
+	std::error_code error;
+
+	// A partial copy may have been left behind by an earlier transfer. Renaming the file would
+	// replace that, but on some platforms, renaming onto an existing file fails.
+	if (std::filesystem::exists(file.destination, error) || error)
+	{
+		return false;
+	}
+
+	std::filesystem::rename(file.source, file.destination, error);
+	return !error;
+}
+
+bool FileTransferEngine::FinishFile(const FileTransferPlan::File &file)
+{
+	std::error_code error;
+	bool sourceExists = std::filesystem::exists(file.source, error);
+
+	// If the file was moved by renaming it, there's nothing else to do.
+	if (sourceExists)
+	{
+		CopyFileMetadata(file.source, file.destination, error);
+
+		if (error)
+		{
+			AddError(file.destination, error);
+			return false;
+		}
+
+		if (m_options.operation == Operation::Move)
+		{
+			std::filesystem::remove(file.source, error);
+
+			if (error)
+			{
+				AddError(file.source, error);
+				return false;
+			}
+		}
+	}
+
+	m_completedFiles++;
+
+	return true;
+}
+
+// This is done once all the files have been transferred, since the attributes could prevent
+// files from being added to a directory (e.g. a directory without write permission).
+void FileTransferEngine::CopyDirectoryAttributes(const FileTransferPlan &plan,
+	const std::vector<bool> &rootsMoved)
+{
+	if (m_cancelled)
+	{
+		return;
+	}
+
+	for (const auto &directory : plan.directories)
+	{
+		if (rootsMoved[directory.rootIndex])
+		{
+			continue;
+		}
+
+		std::error_code error;
+		CopyAttributes(directory.source, directory.destination, error);
+
+		if (error)
+		{
+			AddError(directory.destination, error);
+		}
+	}
+}
+
+// Once all the files have been moved, the source directories will (ideally) be empty. Any
+// directories that still contain files (because some of the files couldn't be moved) are left in
+// place.
+void FileTransferEngine::RemoveSourceDirectories(const FileTransferPlan &plan,
+	const std::vector<bool> &rootsMoved)
+{
+	if (m_cancelled)
+	{
+		return;
+	}
+
+	// Subdirectories appear after their parents, so iterating in reverse removes each directory's
+	// children before the directory itself.
+	for (auto itr = plan.directories.rbegin(); itr != plan.directories.rend(); ++itr)
+	{
+		if (rootsMoved[itr->rootIndex])
+		{
+			continue;
+		}
+
+		std::error_code error;
+		std::filesystem::remove(itr->source, error);
+	}
+}
+
+void FileTransferEngine::Cancel()
+{
+	m_cancelled = true;
+}
+
+FileTransferEngine::Progress FileTransferEngine::GetProgress() const
+{
+	Progress progress;
+	progress.totalBytes = m_totalBytes;
+	progress.transferredBytes = m_transferredBytes;
+	progress.totalFiles = m_totalFiles;
+	progress.completedFiles = m_completedFiles;
+
+	{
+		std::scoped_lock lock(m_mutex);
+		progress.elapsedTime = m_startTime ? (std::chrono::steady_clock::now() - *m_startTime)
+											: std::chrono::steady_clock::duration::zero();
+	}
+
+	auto elapsedSeconds = std::chrono::duration<double>(progress.elapsedTime).count();
+	auto copiedBytes = progress.transferredBytes
+		- std::min<std::uintmax_t>(m_skippedBytes, progress.transferredBytes);
+
+	if (copiedBytes > 0 && elapsedSeconds > 0)
+	{
+		double bytesPerSecond = static_cast<double>(copiedBytes) / elapsedSeconds;
+		auto remainingBytes = progress.totalBytes
+			- std::min<std::uintmax_t>(progress.transferredBytes, progress.totalBytes);
+
+		auto secondsRemaining = std::ceil(static_cast<double>(remainingBytes) / bytesPerSecond);
+
+		progress.bytesPerSecond = bytesPerSecond;
+		progress.estimatedTimeRemaining =
+			std::chrono::seconds(static_cast<long long>(secondsRemaining));
+	}
+
+	return progress;
+}
+
+std::vector<FileTransferError> FileTransferEngine::GetErrors() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_errors;
+}
+
+void FileTransferEngine::AddError(const std::filesystem::path &path, std::error_code error)
+{
+	std::scoped_lock lock(m_mutex);
+	m_errors.push_back({ path, error });
+}
@@ -0,0 +1,412 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "FolderComparer.h"
+#include "FileSystemLinks.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <cwctype>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+
+const size_t READ_BUFFER_SIZE = 1024 * 1024;
+
+// Compares two names, ignoring case. Returns a negative value if the first name sorts before the
+// second, a positive value if it sorts after and zero if the names match.
+int CompareNames(const std::filesystem::path::string_type &name1,
+	const std::filesystem::path::string_type &name2)
+{
+#ifdef _WIN32
+	// This uses the same case mapping as the file system, so non-ASCII names are matched in the
+	// same way as Windows matches them.
+	int result = CompareStringOrdinal(name1.c_str(), static_cast<int>(name1.size()),
+		name2.c_str(), static_cast<int>(name2.size()), TRUE);
+	return result - CSTR_EQUAL;
+#else
+	size_t length = std::min<size_t>(name1.size(), name2.size());
+
+	for (size_t i = 0; i < length; i++)
+	{
+		auto c1 = std::towupper(static_cast<std::wint_t>(name1[i]));
+		auto c2 = std::towupper(static_cast<std::wint_t>(name2[i]));
+
+		if (c1 != c2)
+		{
+			return c1 < c2 ? -1 : 1;
+		}
+	}
+
+	if (name1.size() == name2.size())
+	{
+		return 0;
+	}
+
+	return name1.size() < name2.size() ? -1 : 1;
+#endif
+}
+
+// Reads up to buffer.size() bytes. Returns the number of bytes read.
+size_t ReadBlock(std::istream &stream, std::vector<char> &buffer)
+{
+	stream.read(buffer.data(), buffer.size());
+	return static_cast<size_t>(stream.gcount());
+}
+
+}
+
+FolderComparer::FolderComparer(const Options &options) : m_options(options)
+{
+}
+
+bool FolderComparer::Compare(const std::filesystem::path &left,
+	const std::filesystem::path &right, Callback callback)
+{
+	std::error_code error;
+
+	if (!std::filesystem::is_directory(left, error) || !std::filesystem::is_directory(right, error))
+	{
+		m_numErrors++;
+		return false;
+	}
+
+	// Each pending directory is a path relative to the roots. As with DuplicateFinder, directories
+	// are handed out one at a time, with the comparison being complete once the queue is empty and
+	// no thread is still comparing a directory. The callback has its own lock, so that reporting
+	// one set of items doesn't hold up the other threads.
+	std::deque<std::filesystem::path> pendingDirectories;
+	pendingDirectories.emplace_back();
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	int numActiveThreads = 0;
+
+	std::mutex callbackMutex;
+
+	auto compareDirectories = [&]()
+	{
+		ReadBuffers buffers;
+		std::vector<std::filesystem::path> subdirectories;
+
+		while (true)
+		{
+			std::unique_lock lock(mutex);
+			condition.wait(lock,
+				[&]
+				{
+					return !pendingDirectories.empty() || numActiveThreads == 0;
+				});
+
+			if (pendingDirectories.empty() || m_cancelled)
+			{
+				pendingDirectories.clear();
+				condition.notify_all();
+				return;
+			}
+
+			auto relativeDirectory = std::move(pendingDirectories.front());
+			pendingDirectories.pop_front();
+			numActiveThreads++;
+			lock.unlock();
+
+			subdirectories.clear();
+
+			auto leftEntries = ListDirectory(left / relativeDirectory);
+			auto rightEntries = ListDirectory(right / relativeDirectory);
+
+			if (leftEntries && rightEntries)
+			{
+				std::vector<Item> items;
+				auto leftItr = leftEntries->begin();
+				auto rightItr = rightEntries->begin();
+
+				// Both listings are sorted by name, so they can be merged in a single pass, with
+				// the entry that sorts first on either side being compared next.
+				while (leftItr != leftEntries->end() || rightItr != rightEntries->end())
+				{
+					const Entry *leftEntry = nullptr;
+					const Entry *rightEntry = nullptr;
+
+					if (leftItr == leftEntries->end())
+					{
+						rightEntry = &*rightItr++;
+					}
+					else if (rightItr == rightEntries->end())
+					{
+						leftEntry = &*leftItr++;
+					}
+					else
+					{
+						int result = CompareNames(leftItr->name, rightItr->name);
+
+						if (result <= 0)
+						{
+							leftEntry = &*leftItr++;
+						}
+
+						if (result >= 0)
+						{
+							rightEntry = &*rightItr++;
+						}
+					}
+
+					if (leftEntry && rightEntry && leftEntry->info.isDirectory
+						&& rightEntry->info.isDirectory)
+					{
+						subdirectories.push_back(relativeDirectory / leftEntry->name);
+						continue;
+					}
+
+					items.push_back(CompareEntries(relativeDirectory, leftEntry, rightEntry, left,
+						right, buffers));
+				}
+
+				m_itemsCompared += items.size();
+				m_directoriesCompared++;
+
+				std::scoped_lock callbackLock(callbackMutex);
+
+				if (!m_cancelled && !items.empty())
+				{
+					callback(std::move(items));
+				}
+			}
+			else
+			{
+				m_numErrors++;
+			}
+
+			lock.lock();
+			numActiveThreads--;
+
+			for (auto &subdirectory : subdirectories)
+			{
+				pendingDirectories.push_back(std::move(subdirectory));
+			}
+
+			condition.notify_all();
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	for (int i = 1; i < m_options.numThreads; i++)
+	{
+		threads.emplace_back(compareDirectories);
+	}
+
+	compareDirectories();
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	return !m_cancelled;
+}
+
+// Returns the entries in the directory, sorted by name. Links aren't followed and are left out,
+// as are any other items that aren't files or directories.
+std::optional<std::vector<FolderComparer::Entry>> FolderComparer::ListDirectory(
+	const std::filesystem::path &directory)
+{
+	std::vector<Entry> entries;
+
+	std::error_code error;
+	std::filesystem::directory_iterator itr(directory, error);
+
+	for (; !error && itr != std::filesystem::directory_iterator(); itr.increment(error))
+	{
+		const auto &entry = *itr;
+		std::error_code entryError;
+
+		if (entry.is_symlink(entryError))
+		{
+			continue;
+		}
+
+		if (entry.is_directory(entryError))
+		{
+			// Junctions and mount points aren't reported as symlinks on Windows, so they need to
+			// be checked for separately.
+			if (IsFileSystemLink(entry.path(), entryError) || entryError)
+			{
+				continue;
+			}
+
+			entries.push_back({ entry.path().filename().native(), { true, 0, {} } });
+			continue;
+		}
+
+		if (!entry.is_regular_file(entryError))
+		{
+			continue;
+		}
+
+		auto size = entry.file_size(entryError);
+		auto modificationTime = entry.last_write_time(entryError);
+
+		if (entryError)
+		{
+			m_numErrors++;
+			continue;
+		}
+
+		entries.push_back({ entry.path().filename().native(), { false, size, modificationTime } });
+	}
+
+	if (error)
+	{
+		return std::nullopt;
+	}
+
+	std::sort(entries.begin(), entries.end(),
+		[](const Entry &entry1, const Entry &entry2)
+		{
+			return CompareNames(entry1.name, entry2.name) < 0;
+		});
+
+	return entries;
+}
+
+// Either entry can be null, though not both.
+FolderComparer::Item FolderComparer::CompareEntries(
+	const std::filesystem::path &relativeDirectory, const Entry *left, const Entry *right,
+	const std::filesystem::path &leftRoot, const std::filesystem::path &rightRoot,
+	ReadBuffers &buffers)
+{
+	Item item;
+	item.path = relativeDirectory / (left ? left->name : right->name);
+
+	if (left)
+	{
+		item.left = left->info;
+	}
+
+	if (right)
+	{
+		item.right = right->info;
+	}
+
+	if (!right)
+	{
+		item.difference = Difference::LeftOnly;
+	}
+	else if (!left)
+	{
+		item.difference = Difference::RightOnly;
+	}
+	else if (left->info.isDirectory != right->info.isDirectory)
+	{
+		item.difference = Difference::TypeDiffers;
+	}
+	else
+	{
+		item.difference = CompareFiles(left->info, right->info, leftRoot / item.path,
+			rightRoot / item.path, buffers);
+	}
+
+	return item;
+}
+
+FolderComparer::Difference FolderComparer::CompareFiles(const ItemInfo &left,
+	const ItemInfo &right, const std::filesystem::path &leftPath,
+	const std::filesystem::path &rightPath, ReadBuffers &buffers)
+{
+	auto timeDifference = left.modificationTime - right.modificationTime;
+
+	if (std::chrono::abs(timeDifference) > m_options.timeTolerance)
+	{
+		return timeDifference.count() > 0 ? Difference::LeftNewer : Difference::RightNewer;
+	}
+
+	if (left.size != right.size)
+	{
+		return Difference::ContentsDiffer;
+	}
+
+	if (!m_options.compareContents)
+	{
+		return Difference::Same;
+	}
+
+	auto contentsMatch = CompareFileContents(leftPath, rightPath, buffers);
+
+	if (!contentsMatch)
+	{
+		// Either the files couldn't be read, or the comparison was cancelled (in which case the
+		// item won't be reported anyway). The files can't be reported as being the same, since
+		// it's not known whether their contents match.
+		if (!m_cancelled)
+		{
+			m_numErrors++;
+		}
+
+		return Difference::Unknown;
+	}
+
+	return *contentsMatch ? Difference::Same : Difference::ContentsDiffer;
+}
+
+// Returns true if both files have the same contents. Reading stops at the first difference.
+std::optional<bool> FolderComparer::CompareFileContents(const std::filesystem::path &leftPath,
+	const std::filesystem::path &rightPath, ReadBuffers &buffers)
+{
+	buffers.left.resize(READ_BUFFER_SIZE);
+	buffers.right.resize(READ_BUFFER_SIZE);
+
+	// The data is only read once, so there's no need for the streams to buffer it.
+	std::ifstream leftStream;
+	leftStream.rdbuf()->pubsetbuf(nullptr, 0);
+	leftStream.open(leftPath, std::ios::binary);
+
+	std::ifstream rightStream;
+	rightStream.rdbuf()->pubsetbuf(nullptr, 0);
+	rightStream.open(rightPath, std::ios::binary);
+
+	if (!leftStream || !rightStream)
+	{
+		return std::nullopt;
+	}
+
+	while (!m_cancelled)
+	{
+		size_t leftAmount = ReadBlock(leftStream, buffers.left);
+		size_t rightAmount = ReadBlock(rightStream, buffers.right);
+
+		if (leftAmount != rightAmount
+			|| std::memcmp(buffers.left.data(), buffers.right.data(), leftAmount) != 0)
+		{
+			return false;
+		}
+
+		if (leftAmount < READ_BUFFER_SIZE)
+		{
+			return true;
+		}
+	}
+
+	return std::nullopt;
+}
+
+void FolderComparer::Cancel()
+{
+	m_cancelled = true;
+}
+
+FolderComparer::Progress FolderComparer::GetProgress() const
+{
+	return { m_directoriesCompared, m_itemsCompared };
+}
+
+size_t FolderComparer::GetNumErrors() const
+{
+	return m_numErrors;
+}
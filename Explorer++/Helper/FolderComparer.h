@@ -0,0 +1,142 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <vector>
+
+// Compares the contents of two directory trees. Each pair of matching directories is listed by
+// one of a pool of threads, with the two listings then being sorted and merged in a single pass.
+// Directories that exist on both sides are compared in turn, while directories that only exist on
+// one side are reported as a single item, without being descended into.
+//
+// Files are considered to be the same if they have the same size and modification time. The
+// contents of those files can optionally be compared as well, which is slower, but will find
+// changes that left the size and modification time untouched. As on Windows, names are matched
+// case-insensitively.
+class FolderComparer
+{
+public:
+	enum class Difference
+	{
+		LeftOnly,
+		RightOnly,
+		LeftNewer,
+		RightNewer,
+
+		// The files have the same modification time, but differ in size or contents.
+		ContentsDiffer,
+
+		// A file on one side has the same name as a directory on the other.
+		TypeDiffers,
+
+		// The files appear to be the same, but their contents were to be compared and one of them
+		// couldn't be read.
+		Unknown,
+
+		Same
+	};
+
+	struct ItemInfo
+	{
+		bool isDirectory;
+
+		// Only set for files.
+		std::uintmax_t size;
+		std::filesystem::file_time_type modificationTime;
+	};
+
+	struct Item
+	{
+		// Relative to the roots being compared.
+		std::filesystem::path path;
+
+		Difference difference;
+		std::optional<ItemInfo> left;
+		std::optional<ItemInfo> right;
+	};
+
+	struct Options
+	{
+		int numThreads = 4;
+
+		// Some filesystems (e.g. FAT) only store modification times to within two seconds, so
+		// times within this amount of each other are considered to be equal.
+		std::chrono::seconds timeTolerance = std::chrono::seconds(2);
+
+		// If set, files that appear to be the same are read in full to check that their contents
+		// match.
+		bool compareContents = false;
+	};
+
+	struct Progress
+	{
+		size_t directoriesCompared;
+		size_t itemsCompared;
+	};
+
+	// Called with the items in each directory, as each directory is compared. Calls are made from
+	// the worker threads, but are never made concurrently. Within each call, items are sorted by
+	// name. Items that are the same on both sides are included.
+	using Callback = std::function<void(std::vector<Item> &&items)>;
+
+	explicit FolderComparer(const Options &options);
+
+	FolderComparer(const FolderComparer &) = delete;
+	FolderComparer &operator=(const FolderComparer &) = delete;
+
+	// Returns false if either of the roots couldn't be read, or the comparison was cancelled.
+	// Should only be called once.
+	bool Compare(const std::filesystem::path &left, const std::filesystem::path &right,
+		Callback callback);
+
+	// Can be called from any thread. Once cancelled, no further items are reported.
+	void Cancel();
+
+	// Can be called from any thread.
+	Progress GetProgress() const;
+
+	// The number of items that couldn't be read. Items within directories that couldn't be listed
+	// aren't reported. Can be called from any thread.
+	size_t GetNumErrors() const;
+
+private:
+	using PathString = std::filesystem::path::string_type;
+
+	struct Entry
+	{
+		PathString name;
+		ItemInfo info;
+	};
+
+	// Used when comparing the contents of files. Each worker thread has its own set of buffers.
+	struct ReadBuffers
+	{
+		std::vector<char> left;
+		std::vector<char> right;
+	};
+
+	std::optional<std::vector<Entry>> ListDirectory(const std::filesystem::path &directory);
+	Item CompareEntries(const std::filesystem::path &relativeDirectory, const Entry *left,
+		const Entry *right, const std::filesystem::path &leftRoot,
+		const std::filesystem::path &rightRoot, ReadBuffers &buffers);
+	Difference CompareFiles(const ItemInfo &left, const ItemInfo &right,
+		const std::filesystem::path &leftPath, const std::filesystem::path &rightPath,
+		ReadBuffers &buffers);
+	std::optional<bool> CompareFileContents(const std::filesystem::path &leftPath,
+		const std::filesystem::path &rightPath, ReadBuffers &buffers);
+
+	const Options m_options;
+
+	std::atomic<bool> m_cancelled = false;
+	std::atomic<size_t> m_directoriesCompared = 0;
+	std::atomic<size_t> m_itemsCompared = 0;
+	std::atomic<size_t> m_numErrors = 0;
+};
@@ -49,10 +49,6 @@ BOOL GetVersionInfoString(const TCHAR *szFullFileName, const TCHAR *szVersionInf
 BOOL CheckGroupMembership(GroupType groupType);
 BOOL FormatUserName(PSID sid, TCHAR *userName, size_t cchMax);
 
-/* User interaction. */
-BOOL GetFileNameFromUser(HWND hwnd, TCHAR *fullFileName, UINT cchMax,
-	const TCHAR *initialDirectory);
-
 /* General helper functions. */
 HINSTANCE StartCommandPrompt(const std::wstring &directory, bool elevated);
 HRESULT GetCPUBrandString(std::wstring &cpuBrand);
@@ -470,4 +470,43 @@ std::optional<int> GetLastSelectedItemIndex(HWND listView)
 	return lastItemIndex;
 }
 
+
+ScrollPosition GetScrollPosition(HWND listView)
+{
+	ScrollPosition scrollPosition = {};
+
+	// ListView_GetOrigin() will fail in the list and details views.
+	if (!ListView_GetOrigin(listView, &scrollPosition.origin))
+	{
+		scrollPosition.origin = {};
+		scrollPosition.topIndex = ListView_GetTopIndex(listView);
+	}
+
+	return scrollPosition;
+}
+
+void SetScrollPosition(HWND listView, const ScrollPosition &scrollPosition)
+{
+	POINT origin;
+
+	if (ListView_GetOrigin(listView, &origin))
+	{
+		ListView_Scroll(listView, scrollPosition.origin.x - origin.x,
+			scrollPosition.origin.y - origin.y);
+		return;
+	}
+
+	int numItems = ListView_GetItemCount(listView);
+
+	if (scrollPosition.topIndex <= 0 || numItems == 0)
+	{
+		return;
+	}
+
+	// Scrolling to the end of the list first means that the item will be positioned at the top of
+	// the view once it's scrolled back into view.
+	ListView_EnsureVisible(listView, numItems - 1, FALSE);
+	ListView_EnsureVisible(listView, min(scrollPosition.topIndex, numItems - 1), FALSE);
+}
+
 }
@@ -9,6 +9,16 @@
 namespace ListViewHelper
 {
 
+// The portion of the list view that's currently scrolled into view.
+struct ScrollPosition
+{
+	// Only used in the icon views.
+	POINT origin;
+
+	// Only used in the list and details views.
+	int topIndex;
+};
+
 void SelectItem(HWND hListView, int iItem, BOOL bSelect);
 void SelectAllItems(HWND hListView, BOOL bSelect);
 int InvertSelection(HWND hListView);
@@ -21,5 +31,7 @@ BOOL SetBackgroundImage(HWND hListView, UINT uImage);
 BOOL SwapItems(HWND hListView, int iItem1, int iItem2, BOOL bSwapLPARAM);
 void PositionInsertMark(HWND hListView, const POINT *ppt);
 std::optional<int> GetLastSelectedItemIndex(HWND listView);
+ScrollPosition GetScrollPosition(HWND listView);
+void SetScrollPosition(HWND listView, const ScrollPosition &scrollPosition);
 
 }
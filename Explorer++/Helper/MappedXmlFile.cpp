@@ -0,0 +1,99 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "MappedXmlFile.h"
+
+namespace
+{
+
+const char UTF16_LE_BOM[] = "\xFF\xFE";
+
+std::string ConvertUtf16ToUtf8(const wchar_t *data, int length)
+{
+	if (length == 0)
+	{
+		return {};
+	}
+
+	int size = WideCharToMultiByte(CP_UTF8, 0, data, length, nullptr, 0, nullptr, nullptr);
+
+	if (size == 0)
+	{
+		return {};
+	}
+
+	std::string output(size, '\0');
+	WideCharToMultiByte(CP_UTF8, 0, data, length, output.data(), size, nullptr, nullptr);
+
+	return output;
+}
+
+}
+
+std::unique_ptr<MappedXmlFile> MappedXmlFile::Open(const std::wstring &path)
+{
+	wil::unique_hfile file(CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+
+	if (!file)
+	{
+		return nullptr;
+	}
+
+	LARGE_INTEGER fileSize;
+
+	// Configuration files are small, so there's no need to support files whose size doesn't fit
+	// in an int (which is what the UTF-16 conversion below requires).
+	if (!GetFileSizeEx(file.get(), &fileSize) || fileSize.QuadPart == 0
+		|| static_cast<ULONGLONG>(fileSize.QuadPart) > static_cast<ULONGLONG>(INT_MAX))
+	{
+		return nullptr;
+	}
+
+	wil::unique_handle mapping(
+		CreateFileMapping(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+
+	if (!mapping)
+	{
+		return nullptr;
+	}
+
+	wil::unique_mapview_ptr<void> view(MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0));
+
+	if (!view)
+	{
+		return nullptr;
+	}
+
+	return std::unique_ptr<MappedXmlFile>(
+		new MappedXmlFile(std::move(view), static_cast<size_t>(fileSize.QuadPart)));
+}
+
+MappedXmlFile::MappedXmlFile(wil::unique_mapview_ptr<void> view, size_t size) :
+	m_view(std::move(view))
+{
+	std::string_view data(static_cast<const char *>(m_view.get()), size);
+
+	if (data.starts_with(UTF16_LE_BOM))
+	{
+		data.remove_prefix(sizeof(UTF16_LE_BOM) - 1);
+
+		m_convertedData = ConvertUtf16ToUtf8(reinterpret_cast<const wchar_t *>(data.data()),
+			static_cast<int>(data.size() / sizeof(wchar_t)));
+		m_data = m_convertedData;
+
+		// The original data is no longer needed.
+		m_view.reset();
+	}
+	else
+	{
+		m_data = data;
+	}
+}
+
+std::string_view MappedXmlFile::GetData() const
+{
+	return m_data;
+}
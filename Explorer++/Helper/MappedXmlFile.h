@@ -0,0 +1,30 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <wil/resource.h>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Provides read-only access to the contents of an XML file, so that it can be read using
+// XmlPullParser. UTF-8 files are mapped into memory and read in place. UTF-16 files (identified by
+// their byte order mark) are converted to UTF-8 up front.
+class MappedXmlFile
+{
+public:
+	// Returns nullptr if the file can't be opened or is empty.
+	static std::unique_ptr<MappedXmlFile> Open(const std::wstring &path);
+
+	// The data remains valid for as long as this object exists.
+	std::string_view GetData() const;
+
+private:
+	MappedXmlFile(wil::unique_mapview_ptr<void> view, size_t size);
+
+	wil::unique_mapview_ptr<void> m_view;
+	std::string m_convertedData;
+	std::string_view m_data;
+};
@@ -0,0 +1,186 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+// A read-only map from strings to values that's built entirely at compile time. The keys are
+// arranged using a perfect hash (built using the "hash and displace" method), so a lookup hashes
+// the key once and then performs at most a single string comparison, regardless of the number of
+// entries.
+//
+// Maps should be created via MakePerfectHashMap(), e.g.
+//
+// constexpr auto map = MakePerfectHashMap<int>({ { "first", 1 }, { "second", 2 } });
+//
+// Duplicate keys can't be placed, so they will cause compilation to fail.
+template <typename Value, size_t N>
+class PerfectHashMap
+{
+public:
+	using Entry = std::pair<std::string_view, Value>;
+
+	consteval explicit PerfectHashMap(const std::array<Entry, N> &entries) : m_entries(entries)
+	{
+		Build();
+	}
+
+	constexpr std::optional<Value> Find(std::string_view key) const
+	{
+		uint64_t hash = Hash(key);
+		uint32_t index = m_slots[GetSlot(hash, m_displacements[GetBucket(hash)])];
+
+		if (index == EMPTY_SLOT || m_entries[index].first != key)
+		{
+			return std::nullopt;
+		}
+
+		return m_entries[index].second;
+	}
+
+	constexpr size_t GetSize() const
+	{
+		return N;
+	}
+
+private:
+	static constexpr size_t NUM_BUCKETS = std::max<size_t>(N, 1);
+
+	// Keeping the table at most half full means that a free slot can always be found quickly.
+	static constexpr size_t NUM_SLOTS = std::bit_ceil(std::max<size_t>(N * 2, 1));
+
+	static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+	static constexpr uint32_t MAX_DISPLACEMENT = static_cast<uint32_t>(NUM_SLOTS * 16);
+
+	static constexpr uint64_t Hash(std::string_view key)
+	{
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ull;
+
+		for (char c : key)
+		{
+			hash ^= static_cast<unsigned char>(c);
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	static constexpr size_t GetBucket(uint64_t hash)
+	{
+		return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ull) >> 32) % NUM_BUCKETS;
+	}
+
+	// The step is always odd and the number of slots is a power of two, so trying successive
+	// displacements will eventually visit every slot.
+	static constexpr size_t GetSlot(uint64_t hash, uint32_t displacement)
+	{
+		uint64_t start = hash >> 32;
+		uint64_t step = (hash & UINT32_MAX) | 1;
+		return static_cast<size_t>((start + displacement * step) & (NUM_SLOTS - 1));
+	}
+
+	consteval void Build()
+	{
+		std::array<uint64_t, N> hashes{};
+		std::array<size_t, NUM_BUCKETS + 1> bucketOffsets{};
+
+		for (size_t i = 0; i < N; i++)
+		{
+			hashes[i] = Hash(m_entries[i].first);
+			bucketOffsets[GetBucket(hashes[i]) + 1]++;
+		}
+
+		size_t maxBucketSize = 0;
+
+		for (size_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+		{
+			maxBucketSize = std::max<size_t>(maxBucketSize, bucketOffsets[bucket + 1]);
+			bucketOffsets[bucket + 1] += bucketOffsets[bucket];
+		}
+
+		// Groups the entries by bucket, so that the entries in each bucket can be visited
+		// directly.
+		std::array<uint32_t, N> bucketEntries{};
+		std::array<size_t, NUM_BUCKETS> bucketPositions{};
+
+		for (size_t i = 0; i < N; i++)
+		{
+			size_t bucket = GetBucket(hashes[i]);
+			bucketEntries[bucketOffsets[bucket] + bucketPositions[bucket]++] =
+				static_cast<uint32_t>(i);
+		}
+
+		m_slots.fill(EMPTY_SLOT);
+
+		// Buckets with more entries are harder to place, so they're handled first.
+		for (size_t size = maxBucketSize; size > 0; size--)
+		{
+			for (size_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+			{
+				size_t start = bucketOffsets[bucket];
+				size_t end = bucketOffsets[bucket + 1];
+
+				if (end - start == size)
+				{
+					PlaceBucket(bucket, start, end, bucketEntries, hashes);
+				}
+			}
+		}
+	}
+
+	consteval void PlaceBucket(size_t bucket, size_t start, size_t end,
+		const std::array<uint32_t, N> &bucketEntries, const std::array<uint64_t, N> &hashes)
+	{
+		for (uint32_t displacement = 0; displacement < MAX_DISPLACEMENT; displacement++)
+		{
+			size_t numPlaced = 0;
+
+			for (size_t i = start; i < end; i++)
+			{
+				size_t slot = GetSlot(hashes[bucketEntries[i]], displacement);
+
+				if (m_slots[slot] != EMPTY_SLOT)
+				{
+					break;
+				}
+
+				m_slots[slot] = bucketEntries[i];
+				numPlaced++;
+			}
+
+			if (numPlaced == end - start)
+			{
+				m_displacements[bucket] = displacement;
+				return;
+			}
+
+			for (size_t i = start; i < start + numPlaced; i++)
+			{
+				m_slots[GetSlot(hashes[bucketEntries[i]], displacement)] = EMPTY_SLOT;
+			}
+		}
+
+		throw std::invalid_argument("Unable to place keys. Are there duplicate keys?");
+	}
+
+	std::array<Entry, N> m_entries;
+	std::array<uint32_t, NUM_BUCKETS> m_displacements{};
+	std::array<uint32_t, NUM_SLOTS> m_slots{};
+};
+
+template <typename Value, size_t N>
+consteval PerfectHashMap<Value, N> MakePerfectHashMap(
+	const std::pair<std::string_view, Value> (&entries)[N])
+{
+	return PerfectHashMap<Value, N>(std::to_array(entries));
+}
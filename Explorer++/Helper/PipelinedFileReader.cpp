@@ -0,0 +1,205 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "PipelinedFileReader.h"
+#include <wil/resource.h>
+#include <algorithm>
+
+PipelinedFileReader::PipelinedFileReader(const std::vector<std::wstring> &paths,
+	DWORD blockSize, int numBuffers) :
+	m_paths(paths),
+	m_blockSize(blockSize),
+	m_currentBuffer(-1),
+	m_state(State::Reading),
+	m_stopRequested(false),
+	m_failedFileIndex(0),
+	m_errorCode(ERROR_SUCCESS)
+{
+	// At least two buffers are needed for reading and processing to overlap.
+	numBuffers = std::max<int>(numBuffers, 2);
+
+	for (int i = 0; i < numBuffers; i++)
+	{
+		Buffer buffer;
+		buffer.data = std::make_unique<BYTE[]>(m_blockSize);
+		buffer.size = 0;
+		buffer.fileIndex = 0;
+		buffer.endOfFile = false;
+		m_buffers.push_back(std::move(buffer));
+
+		m_freeBuffers.push_back(i);
+	}
+
+	m_readerThread = std::thread(&PipelinedFileReader::ReadFiles, this);
+}
+
+PipelinedFileReader::~PipelinedFileReader()
+{
+	Stop();
+	m_readerThread.join();
+}
+
+bool PipelinedFileReader::ReadNextBlock(Block &block)
+{
+	std::unique_lock lock(m_mutex);
+
+	if (m_currentBuffer != -1)
+	{
+		m_freeBuffers.push_back(m_currentBuffer);
+		m_currentBuffer = -1;
+		m_condition.notify_all();
+	}
+
+	m_condition.wait(lock,
+		[this]
+		{
+			return !m_filledBuffers.empty() || m_state != State::Reading || m_stopRequested;
+		});
+
+	// Once reading has finished, any remaining blocks will still be returned. That isn't the case
+	// if reading failed or was stopped, since the caller won't be able to do anything useful with
+	// the partial data.
+	if (m_stopRequested || m_state == State::Failed || m_filledBuffers.empty())
+	{
+		return false;
+	}
+
+	m_currentBuffer = m_filledBuffers.front();
+	m_filledBuffers.pop_front();
+
+	const auto &buffer = m_buffers[m_currentBuffer];
+	block.data = buffer.data.get();
+	block.size = buffer.size;
+	block.fileIndex = buffer.fileIndex;
+	block.endOfFile = buffer.endOfFile;
+
+	return true;
+}
+
+void PipelinedFileReader::Stop()
+{
+	std::scoped_lock lock(m_mutex);
+	m_stopRequested = true;
+	m_condition.notify_all();
+}
+
+PipelinedFileReader::State PipelinedFileReader::GetState() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_state;
+}
+
+size_t PipelinedFileReader::GetFailedFileIndex() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_failedFileIndex;
+}
+
+DWORD PipelinedFileReader::GetErrorCode() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_errorCode;
+}
+
+void PipelinedFileReader::ReadFiles()
+{
+	for (size_t i = 0; i < m_paths.size(); i++)
+	{
+		if (!ReadSingleFile(i))
+		{
+			return;
+		}
+	}
+
+	SetFinalState(State::Finished);
+}
+
+bool PipelinedFileReader::ReadSingleFile(size_t fileIndex)
+{
+	wil::unique_hfile file(CreateFile(m_paths[fileIndex].c_str(), GENERIC_READ, FILE_SHARE_READ,
+		nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+
+	if (!file)
+	{
+		std::scoped_lock lock(m_mutex);
+		m_failedFileIndex = fileIndex;
+		m_errorCode = ::GetLastError();
+		m_state = State::Failed;
+		m_condition.notify_all();
+		return false;
+	}
+
+	while (true)
+	{
+		int bufferIndex = AcquireFreeBuffer();
+
+		if (bufferIndex == -1)
+		{
+			SetFinalState(State::Stopped);
+			return false;
+		}
+
+		auto &buffer = m_buffers[bufferIndex];
+
+		DWORD numBytesRead;
+		BOOL res = ::ReadFile(file.get(), buffer.data.get(), m_blockSize, &numBytesRead, nullptr);
+
+		if (!res)
+		{
+			std::scoped_lock lock(m_mutex);
+			m_freeBuffers.push_back(bufferIndex);
+			m_failedFileIndex = fileIndex;
+			m_errorCode = ::GetLastError();
+			m_state = State::Failed;
+			m_condition.notify_all();
+			return false;
+		}
+
+		buffer.size = numBytesRead;
+		buffer.fileIndex = fileIndex;
+		buffer.endOfFile = (numBytesRead == 0);
+
+		QueueFilledBuffer(bufferIndex);
+
+		if (numBytesRead == 0)
+		{
+			return true;
+		}
+	}
+}
+
+int PipelinedFileReader::AcquireFreeBuffer()
+{
+	std::unique_lock lock(m_mutex);
+	m_condition.wait(lock,
+		[this]
+		{
+			return !m_freeBuffers.empty() || m_stopRequested;
+		});
+
+	if (m_stopRequested)
+	{
+		return -1;
+	}
+
+	int bufferIndex = m_freeBuffers.front();
+	m_freeBuffers.pop_front();
+
+	return bufferIndex;
+}
+
+void PipelinedFileReader::QueueFilledBuffer(int bufferIndex)
+{
+	std::scoped_lock lock(m_mutex);
+	m_filledBuffers.push_back(bufferIndex);
+	m_condition.notify_all();
+}
+
+void PipelinedFileReader::SetFinalState(State state)
+{
+	std::scoped_lock lock(m_mutex);
+	m_state = state;
+	m_condition.notify_all();
+}
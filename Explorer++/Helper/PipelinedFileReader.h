@@ -0,0 +1,101 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Sequentially reads one or more files on a background thread, using a fixed set of buffers. This
+// allows the next block of data to be read while the caller is still processing (e.g. writing out)
+// the previous block. The amount of memory used is constant (blockSize * numBuffers), regardless
+// of the size of the input files.
+class PipelinedFileReader
+{
+public:
+	struct Block
+	{
+		const BYTE *data;
+		DWORD size;
+
+		// The index (within the list of paths passed to the constructor) of the file this block
+		// was read from.
+		size_t fileIndex;
+
+		// After the last block of data from a file has been returned, an empty block with this
+		// flag set is returned. This is returned for every file (including empty files), so that
+		// the caller can always tell where each file ends.
+		bool endOfFile;
+	};
+
+	enum class State
+	{
+		Reading,
+		Finished,
+		Failed,
+		Stopped
+	};
+
+	static const DWORD DEFAULT_BLOCK_SIZE = 1024 * 1024;
+	static const int DEFAULT_NUM_BUFFERS = 4;
+
+	PipelinedFileReader(const std::vector<std::wstring> &paths,
+		DWORD blockSize = DEFAULT_BLOCK_SIZE, int numBuffers = DEFAULT_NUM_BUFFERS);
+	~PipelinedFileReader();
+
+	PipelinedFileReader(const PipelinedFileReader &) = delete;
+	PipelinedFileReader &operator=(const PipelinedFileReader &) = delete;
+
+	// Waits for the next block to become available. The data in the block remains valid until the
+	// next call to this method, at which point the block's buffer is handed back to the reader
+	// thread. Returns false once all the files have been read, or if reading failed or was
+	// stopped.
+	bool ReadNextBlock(Block &block);
+
+	// Stops the reader thread as soon as possible. Can be called from any thread.
+	void Stop();
+
+	State GetState() const;
+
+	// If reading failed, returns the index of the file that couldn't be read, along with the
+	// associated error code.
+	size_t GetFailedFileIndex() const;
+	DWORD GetErrorCode() const;
+
+private:
+	struct Buffer
+	{
+		std::unique_ptr<BYTE[]> data;
+		DWORD size;
+		size_t fileIndex;
+		bool endOfFile;
+	};
+
+	void ReadFiles();
+	bool ReadSingleFile(size_t fileIndex);
+	int AcquireFreeBuffer();
+	void QueueFilledBuffer(int bufferIndex);
+	void SetFinalState(State state);
+
+	const std::vector<std::wstring> m_paths;
+	const DWORD m_blockSize;
+	std::vector<Buffer> m_buffers;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<int> m_freeBuffers;
+	std::deque<int> m_filledBuffers;
+	int m_currentBuffer;
+	State m_state;
+	bool m_stopRequested;
+	size_t m_failedFileIndex;
+	DWORD m_errorCode;
+
+	std::thread m_readerThread;
+};
@@ -0,0 +1,426 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "RenameTemplate.h"
+#include <boost/locale.hpp>
+#include <algorithm>
+
+namespace
+{
+
+const std::wstring_view DEFAULT_DATE_FORMAT = L"%Y-%m-%d";
+
+}
+
+RenameTemplate::RenameTemplate(const std::locale &locale) : m_locale(locale)
+{
+}
+
+std::optional<RenameTemplate> RenameTemplate::Parse(std::wstring_view pattern,
+	const std::locale &locale)
+{
+	RenameTemplate renameTemplate(locale);
+	int maxCaptureGroup = 0;
+	size_t pos = 0;
+
+	while (pos < pattern.size())
+	{
+		if (pattern[pos] != L'/' || (pos + 1) == pattern.size())
+		{
+			renameTemplate.AddLiteral(TokenType::Literal, pattern.substr(pos, 1));
+			pos++;
+			continue;
+		}
+
+		wchar_t tokenChar = pattern[pos + 1];
+
+		switch (tokenChar)
+		{
+		case L'F':
+		case L'L':
+		case L'U':
+			renameTemplate.m_tokens.push_back({ TokenType::FileName });
+
+			// Uppercase conversion takes precedence over lowercase conversion.
+			if (tokenChar == L'U')
+			{
+				renameTemplate.m_caseConversion = CaseConversion::Uppercase;
+			}
+			else if (tokenChar == L'L'
+				&& renameTemplate.m_caseConversion != CaseConversion::Uppercase)
+			{
+				renameTemplate.m_caseConversion = CaseConversion::Lowercase;
+			}
+
+			pos += 2;
+			break;
+
+		case L'B':
+			renameTemplate.m_tokens.push_back({ TokenType::BaseName });
+			pos += 2;
+			break;
+
+		case L'E':
+			renameTemplate.m_tokens.push_back({ TokenType::Extension });
+			pos += 2;
+			break;
+
+		case L'D':
+		{
+			pos += 2;
+
+			std::wstring_view format = DEFAULT_DATE_FORMAT;
+
+			if (pos < pattern.size() && pattern[pos] == L'{')
+			{
+				auto braceContents = ParseBraces(pattern, pos);
+
+				if (!braceContents)
+				{
+					return std::nullopt;
+				}
+
+				format = *braceContents;
+			}
+
+			if (!renameTemplate.ParseDateFormat(format))
+			{
+				return std::nullopt;
+			}
+		}
+		break;
+
+		case L'R':
+		{
+			if ((pos + 2) == pattern.size() || pattern[pos + 2] != L'{')
+			{
+				renameTemplate.AddLiteral(TokenType::Literal, pattern.substr(pos, 1));
+				pos++;
+				break;
+			}
+
+			if (renameTemplate.m_regex)
+			{
+				return std::nullopt;
+			}
+
+			pos += 2;
+
+			auto expression = ParseBraces(pattern, pos);
+
+			if (!expression)
+			{
+				return std::nullopt;
+			}
+
+			try
+			{
+				renameTemplate.m_regex.emplace(expression->begin(), expression->end(),
+					std::regex_constants::ECMAScript | std::regex_constants::icase);
+			}
+			catch (const std::regex_error &)
+			{
+				return std::nullopt;
+			}
+		}
+		break;
+
+		default:
+			if (tokenChar >= L'1' && tokenChar <= L'9')
+			{
+				int captureGroup = tokenChar - L'0';
+				renameTemplate.m_tokens.push_back({ TokenType::CaptureGroup, {}, captureGroup });
+				maxCaptureGroup = std::max<int>(maxCaptureGroup, captureGroup);
+				pos += 2;
+				break;
+			}
+
+			// The counter can contain any number of zeros, which set its minimum width.
+			size_t counterEnd = pattern.find_first_not_of(L'0', pos + 1);
+
+			if (counterEnd != std::wstring_view::npos && pattern[counterEnd] == L'N')
+			{
+				int width = static_cast<int>(counterEnd - (pos + 1)) + 1;
+				renameTemplate.m_tokens.push_back({ TokenType::Counter, {}, width });
+				pos = counterEnd + 1;
+				break;
+			}
+
+			renameTemplate.AddLiteral(TokenType::Literal, pattern.substr(pos, 1));
+			pos++;
+			break;
+		}
+	}
+
+	// Each capture group that's referenced needs to exist within the regular expression.
+	if (maxCaptureGroup > 0
+		&& (!renameTemplate.m_regex
+			|| maxCaptureGroup > static_cast<int>(renameTemplate.m_regex->mark_count())))
+	{
+		return std::nullopt;
+	}
+
+	return renameTemplate;
+}
+
+// Returns the contents of the braces starting at the specified position and moves the position
+// past the closing brace. Nested braces (such as those in a regular expression quantifier) are
+// allowed, as are braces escaped with a backslash.
+std::optional<std::wstring_view> RenameTemplate::ParseBraces(std::wstring_view pattern,
+	size_t &pos)
+{
+	int depth = 0;
+
+	for (size_t i = pos; i < pattern.size(); i++)
+	{
+		switch (pattern[i])
+		{
+		case L'\\':
+			i++;
+			break;
+
+		case L'{':
+			depth++;
+			break;
+
+		case L'}':
+			depth--;
+
+			if (depth == 0)
+			{
+				auto contents = pattern.substr(pos + 1, i - (pos + 1));
+				pos = i + 1;
+				return contents;
+			}
+			break;
+		}
+	}
+
+	return std::nullopt;
+}
+
+bool RenameTemplate::ParseDateFormat(std::wstring_view format)
+{
+	m_usesDate = true;
+
+	size_t dateIndex = m_tokens.size();
+	m_tokens.push_back({ TokenType::Date });
+
+	for (size_t i = 0; i < format.size(); i++)
+	{
+		if (format[i] != L'%')
+		{
+			AddLiteral(TokenType::DateLiteral, format.substr(i, 1));
+			continue;
+		}
+
+		i++;
+
+		if (i == format.size())
+		{
+			return false;
+		}
+
+		switch (format[i])
+		{
+		case L'Y':
+			m_tokens.push_back({ TokenType::Year });
+			break;
+
+		case L'm':
+			m_tokens.push_back({ TokenType::Month });
+			break;
+
+		case L'd':
+			m_tokens.push_back({ TokenType::Day });
+			break;
+
+		case L'H':
+			m_tokens.push_back({ TokenType::Hour });
+			break;
+
+		case L'M':
+			m_tokens.push_back({ TokenType::Minute });
+			break;
+
+		case L'S':
+			m_tokens.push_back({ TokenType::Second });
+			break;
+
+		case L'%':
+			AddLiteral(TokenType::DateLiteral, L"%");
+			break;
+
+		default:
+			return false;
+		}
+	}
+
+	m_tokens[dateIndex].value = static_cast<int>(m_tokens.size() - dateIndex - 1);
+
+	return true;
+}
+
+// Adjacent literals are merged, so that they can be copied to the output in a single step.
+void RenameTemplate::AddLiteral(TokenType type, std::wstring_view text)
+{
+	if (!m_tokens.empty() && m_tokens.back().type == type)
+	{
+		m_tokens.back().text += text;
+		return;
+	}
+
+	m_tokens.push_back({ type, std::wstring(text) });
+}
+
+void RenameTemplate::Evaluate(const FileInfo &fileInfo, std::wstring &output) const
+{
+	output.clear();
+
+	std::wstring_view fileName = fileInfo.fileName;
+	std::wstring_view extension = GetFileNameExtension(fileName);
+	std::wstring_view baseName = fileName.substr(0, fileName.size() - extension.size());
+
+	std::match_results<std::wstring_view::const_iterator> match;
+	bool matched = m_regex && std::regex_search(fileName.begin(), fileName.end(), match, *m_regex);
+
+	const auto &date = fileInfo.modificationDate;
+
+	for (size_t i = 0; i < m_tokens.size(); i++)
+	{
+		const Token &token = m_tokens[i];
+
+		switch (token.type)
+		{
+		case TokenType::Literal:
+		case TokenType::DateLiteral:
+			output += token.text;
+			break;
+
+		case TokenType::Counter:
+			AppendNumber(fileInfo.index, token.value, output);
+			break;
+
+		case TokenType::FileName:
+			output += fileName;
+			break;
+
+		case TokenType::BaseName:
+			output += baseName;
+			break;
+
+		case TokenType::Extension:
+			output += extension;
+			break;
+
+		case TokenType::Date:
+			if (!date)
+			{
+				i += token.value;
+			}
+			break;
+
+		case TokenType::Year:
+			AppendNumber(date->year, 4, output);
+			break;
+
+		case TokenType::Month:
+			AppendNumber(date->month, 2, output);
+			break;
+
+		case TokenType::Day:
+			AppendNumber(date->day, 2, output);
+			break;
+
+		case TokenType::Hour:
+			AppendNumber(date->hour, 2, output);
+			break;
+
+		case TokenType::Minute:
+			AppendNumber(date->minute, 2, output);
+			break;
+
+		case TokenType::Second:
+			AppendNumber(date->second, 2, output);
+			break;
+
+		case TokenType::CaptureGroup:
+			if (matched && match[token.value].matched)
+			{
+				output.append(match[token.value].first, match[token.value].second);
+			}
+			break;
+		}
+	}
+
+	switch (m_caseConversion)
+	{
+	case CaseConversion::Lowercase:
+		output = boost::locale::to_lower(output, m_locale);
+		break;
+
+	case CaseConversion::Uppercase:
+		output = boost::locale::to_upper(output, m_locale);
+		break;
+
+	case CaseConversion::None:
+		break;
+	}
+}
+
+// Appends a non-negative number to the output, padded with leading zeros to the specified width.
+// This avoids the overhead of a stream, since it's called for every file being renamed.
+void RenameTemplate::AppendNumber(int number, int width, std::wstring &output)
+{
+	wchar_t digits[16];
+	int numDigits = 0;
+	auto remaining = static_cast<unsigned int>(number);
+
+	do
+	{
+		digits[numDigits++] = static_cast<wchar_t>(L'0' + (remaining % 10));
+		remaining /= 10;
+	} while (remaining > 0);
+
+	if (width > numDigits)
+	{
+		output.append(width - numDigits, L'0');
+	}
+
+	while (numDigits > 0)
+	{
+		output += digits[--numDigits];
+	}
+}
+
+bool RenameTemplate::UsesDate() const
+{
+	return m_usesDate;
+}
+
+std::wstring_view GetFileNameExtension(std::wstring_view fileName)
+{
+	size_t extensionStart = std::wstring_view::npos;
+
+	// As with PathFindExtension(), a space after the last period means there's no extension.
+	for (size_t i = 0; i < fileName.size(); i++)
+	{
+		if (fileName[i] == L'\\' || fileName[i] == L' ')
+		{
+			extensionStart = std::wstring_view::npos;
+		}
+		else if (fileName[i] == L'.')
+		{
+			extensionStart = i;
+		}
+	}
+
+	if (extensionStart == std::wstring_view::npos)
+	{
+		return {};
+	}
+
+	return fileName.substr(extensionStart);
+}
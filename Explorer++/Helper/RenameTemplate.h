@@ -0,0 +1,124 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <locale>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A mass rename pattern that has been parsed into a sequence of tokens. The pattern only needs to
+// be parsed once, after which it can be cheaply evaluated for each file being renamed.
+//
+// The following tokens are supported:
+//
+// /N         - Counter (the index of the file). Zeros can be placed between the slash and the N
+//              to set a minimum width (e.g. /00N produces 000, 001, etc).
+// /F         - Filename
+// /B         - Basename (filename without extension)
+// /E         - Extension (including the leading period)
+// /L         - Filename, with the entire resulting name converted to lowercase
+// /U         - Filename, with the entire resulting name converted to uppercase
+// /D         - Modification date, in the form YYYY-MM-DD
+// /D{format} - Modification date, in the specified format. Within the format, %Y, %m, %d, %H, %M
+//              and %S are replaced with the year, month, day, hour, minute and second
+//              respectively and %% produces a single %. Any other use of % is invalid.
+// /R{regex}  - Matches the regular expression (case-insensitively) against the filename. Produces
+//              no output itself. Only a single /R token can be used.
+// /1 to /9   - The text matched by the corresponding capture group in the /R expression, or
+//              nothing if the expression didn't match.
+//
+// If both /L and /U are used, the name is converted to uppercase. Any other text is copied to the
+// output as-is.
+class RenameTemplate
+{
+public:
+	struct DateTime
+	{
+		int year;
+		int month;
+		int day;
+		int hour;
+		int minute;
+		int second;
+	};
+
+	struct FileInfo
+	{
+		std::wstring_view fileName;
+		int index = 0;
+
+		// Only needed if the template uses the /D token (see UsesDate()).
+		std::optional<DateTime> modificationDate;
+	};
+
+	// Returns std::nullopt if the pattern is invalid (for example, if it contains a malformed
+	// regular expression or an unterminated brace). The locale is used for any case conversions.
+	static std::optional<RenameTemplate> Parse(std::wstring_view pattern,
+		const std::locale &locale = std::locale());
+
+	// Generates the new name for the specified file. The output string is cleared first, so the
+	// same string can be passed in for each file, allowing its buffer to be reused.
+	void Evaluate(const FileInfo &fileInfo, std::wstring &output) const;
+
+	bool UsesDate() const;
+
+private:
+	enum class TokenType
+	{
+		Literal,
+		Counter,
+		FileName,
+		BaseName,
+		Extension,
+
+		// Marks the start of a date. The value is the number of date tokens that follow, which are
+		// skipped if the file has no date.
+		Date,
+		DateLiteral,
+		Year,
+		Month,
+		Day,
+		Hour,
+		Minute,
+		Second,
+
+		CaptureGroup
+	};
+
+	enum class CaseConversion
+	{
+		None,
+		Lowercase,
+		Uppercase
+	};
+
+	struct Token
+	{
+		TokenType type;
+		std::wstring text;
+		int value = 0;
+	};
+
+	RenameTemplate(const std::locale &locale);
+
+	bool ParseDateFormat(std::wstring_view format);
+	void AddLiteral(TokenType type, std::wstring_view text);
+
+	static std::optional<std::wstring_view> ParseBraces(std::wstring_view pattern, size_t &pos);
+	static void AppendNumber(int number, int width, std::wstring &output);
+
+	std::vector<Token> m_tokens;
+	CaseConversion m_caseConversion = CaseConversion::None;
+	std::optional<std::wregex> m_regex;
+	bool m_usesDate = false;
+	std::locale m_locale;
+};
+
+// Returns the extension of the specified filename (including the leading period), using the same
+// rules as PathFindExtension(). If the filename has no extension, an empty string is returned.
+std::wstring_view GetFileNameExtension(std::wstring_view fileName);
@@ -0,0 +1,117 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "SerialTaskRunner.h"
+#include <algorithm>
+
+SerialTaskRunner::SerialTaskRunner(std::chrono::microseconds timeBudget,
+	OverBudgetCallback overBudgetCallback) :
+	m_timeBudget(timeBudget),
+	m_overBudgetCallback(overBudgetCallback)
+{
+	m_thread = std::thread(&SerialTaskRunner::ProcessTasks, this);
+}
+
+SerialTaskRunner::~SerialTaskRunner()
+{
+	std::deque<PendingTask> discardedTasks;
+
+	{
+		std::scoped_lock lock(m_mutex);
+		m_stopping = true;
+
+		// The tasks are destroyed once the lock has been released, since destroying a task may
+		// release objects that it captured.
+		discardedTasks.swap(m_pendingTasks);
+	}
+
+	m_taskPostedCondition.notify_one();
+	m_idleCondition.notify_all();
+	m_thread.join();
+}
+
+void SerialTaskRunner::Post(std::string label, Task task)
+{
+	{
+		std::scoped_lock lock(m_mutex);
+		m_pendingTasks.push_back({ std::move(label), std::move(task) });
+	}
+
+	m_taskPostedCondition.notify_one();
+}
+
+void SerialTaskRunner::Flush()
+{
+	std::unique_lock lock(m_mutex);
+	m_idleCondition.wait(lock,
+		[this]
+		{
+			return (m_pendingTasks.empty() && !m_taskRunning) || m_stopping;
+		});
+}
+
+bool SerialTaskRunner::IsRunnerThread() const
+{
+	return std::this_thread::get_id() == m_thread.get_id();
+}
+
+SerialTaskRunner::Statistics SerialTaskRunner::GetStatistics() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_statistics;
+}
+
+void SerialTaskRunner::ProcessTasks()
+{
+	std::unique_lock lock(m_mutex);
+
+	while (true)
+	{
+		m_taskPostedCondition.wait(lock,
+			[this]
+			{
+				return !m_pendingTasks.empty() || m_stopping;
+			});
+
+		if (m_stopping)
+		{
+			break;
+		}
+
+		PendingTask pendingTask = std::move(m_pendingTasks.front());
+		m_pendingTasks.pop_front();
+		m_taskRunning = true;
+
+		lock.unlock();
+
+		auto startTime = std::chrono::steady_clock::now();
+		pendingTask.task();
+		auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - startTime);
+
+		bool overBudget = duration > m_timeBudget;
+
+		if (overBudget && m_overBudgetCallback)
+		{
+			m_overBudgetCallback(pendingTask.label, duration);
+		}
+
+		pendingTask = {};
+
+		lock.lock();
+
+		m_statistics.tasksRun++;
+		m_statistics.totalTime += duration;
+		m_statistics.maxTime = std::max<std::chrono::microseconds>(m_statistics.maxTime, duration);
+
+		if (overBudget)
+		{
+			m_statistics.tasksOverBudget++;
+		}
+
+		m_taskRunning = false;
+		m_idleCondition.notify_all();
+	}
+}
@@ -0,0 +1,78 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Runs tasks on a single background thread, one at a time, in the order in which they were posted.
+// Each task is timed and tasks that run for longer than the time budget are counted, which allows
+// a caller that's posting slow tasks to be identified.
+class SerialTaskRunner
+{
+public:
+	// Tasks shouldn't throw.
+	using Task = std::function<void()>;
+
+	struct Statistics
+	{
+		size_t tasksRun;
+		size_t tasksOverBudget;
+		std::chrono::microseconds totalTime;
+		std::chrono::microseconds maxTime;
+	};
+
+	// Invoked on the background thread, once a task that ran over budget has finished. The label
+	// is the one that was supplied when the task was posted.
+	using OverBudgetCallback =
+		std::function<void(const std::string &label, std::chrono::microseconds duration)>;
+
+	explicit SerialTaskRunner(std::chrono::microseconds timeBudget,
+		OverBudgetCallback overBudgetCallback = nullptr);
+
+	// Tasks that haven't started yet are discarded. If a task is running, this will wait for it to
+	// finish.
+	~SerialTaskRunner();
+
+	SerialTaskRunner(const SerialTaskRunner &) = delete;
+	SerialTaskRunner &operator=(const SerialTaskRunner &) = delete;
+
+	void Post(std::string label, Task task);
+
+	// Blocks until every task posted so far has run. Shouldn't be called from within a task.
+	void Flush();
+
+	// Returns true if called from within a task.
+	bool IsRunnerThread() const;
+
+	Statistics GetStatistics() const;
+
+private:
+	struct PendingTask
+	{
+		std::string label;
+		Task task;
+	};
+
+	void ProcessTasks();
+
+	const std::chrono::microseconds m_timeBudget;
+	const OverBudgetCallback m_overBudgetCallback;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_taskPostedCondition;
+	std::condition_variable m_idleCondition;
+	std::deque<PendingTask> m_pendingTasks;
+	bool m_taskRunning = false;
+	bool m_stopping = false;
+	Statistics m_statistics = {};
+
+	std::thread m_thread;
+};
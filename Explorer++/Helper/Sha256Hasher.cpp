@@ -0,0 +1,99 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "Sha256Hasher.h"
+#include <algorithm>
+
+#pragma comment(lib, "bcrypt.lib")
+
+namespace
+{
+
+const size_t SHA256_DIGEST_SIZE = 32;
+
+}
+
+Sha256Hasher::Sha256Hasher()
+{
+	NTSTATUS status =
+		BCryptOpenAlgorithmProvider(wil::out_param(m_algorithm), BCRYPT_SHA256_ALGORITHM, nullptr, 0);
+
+	if (!BCRYPT_SUCCESS(status))
+	{
+		return;
+	}
+
+	Reset();
+}
+
+bool Sha256Hasher::Reset()
+{
+	m_hash.reset();
+
+	if (!m_algorithm)
+	{
+		return false;
+	}
+
+	// Passing a null hash object buffer means the buffer will be allocated and managed internally.
+	NTSTATUS status =
+		BCryptCreateHash(m_algorithm.get(), wil::out_param(m_hash), nullptr, 0, nullptr, 0, 0);
+
+	return BCRYPT_SUCCESS(status);
+}
+
+bool Sha256Hasher::Update(const BYTE *data, size_t size)
+{
+	if (!m_hash)
+	{
+		return false;
+	}
+
+	while (size > 0)
+	{
+		auto chunkSize = static_cast<ULONG>(std::min<size_t>(size, ULONG_MAX));
+		NTSTATUS status = BCryptHashData(m_hash.get(), const_cast<BYTE *>(data), chunkSize, 0);
+
+		if (!BCRYPT_SUCCESS(status))
+		{
+			return false;
+		}
+
+		data += chunkSize;
+		size -= chunkSize;
+	}
+
+	return true;
+}
+
+std::optional<std::string> Sha256Hasher::Finish()
+{
+	if (!m_hash)
+	{
+		return std::nullopt;
+	}
+
+	BYTE digest[SHA256_DIGEST_SIZE];
+	NTSTATUS status = BCryptFinishHash(m_hash.get(), digest, sizeof(digest), 0);
+
+	Reset();
+
+	if (!BCRYPT_SUCCESS(status))
+	{
+		return std::nullopt;
+	}
+
+	static const char hexDigits[] = "0123456789abcdef";
+	std::string hexDigest;
+	hexDigest.reserve(SHA256_DIGEST_SIZE * 2);
+
+	for (BYTE byte : digest)
+	{
+		hexDigest.push_back(hexDigits[byte >> 4]);
+		hexDigest.push_back(hexDigits[byte & 0x0F]);
+	}
+
+	return hexDigest;
+}
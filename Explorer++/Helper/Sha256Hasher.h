@@ -0,0 +1,33 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+// wil only defines the BCrypt wrapper types if bcrypt.h has already been included.
+// clang-format off
+#include <bcrypt.h>
+#include <wil/resource.h>
+// clang-format on
+#include <optional>
+#include <string>
+
+// Incrementally computes a SHA-256 digest, allowing data to be hashed as it's streamed, rather
+// than requiring the entire input to be held in memory.
+class Sha256Hasher
+{
+public:
+	Sha256Hasher();
+
+	bool Update(const BYTE *data, size_t size);
+
+	// Returns the digest as a lowercase hex string. Once this has been called, the hasher is reset
+	// and can be used to hash a new set of data.
+	std::optional<std::string> Finish();
+
+private:
+	bool Reset();
+
+	wil::unique_bcrypt_algorithm m_algorithm;
+	wil::unique_bcrypt_hash m_hash;
+};
@@ -0,0 +1,144 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "TraceRecorder.h"
+#include <format>
+#include <fstream>
+
+namespace
+{
+
+void AppendJsonString(std::string &output, std::string_view text)
+{
+	output += '"';
+
+	for (char c : text)
+	{
+		switch (c)
+		{
+		case '"':
+			output += "\\\"";
+			break;
+
+		case '\\':
+			output += "\\\\";
+			break;
+
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				output += std::format("\\u{:04x}", static_cast<unsigned int>(c));
+			}
+			else
+			{
+				output += c;
+			}
+			break;
+		}
+	}
+
+	output += '"';
+}
+
+}
+
+TraceRecorder::TraceRecorder() : m_creationTime(Clock::now()), m_enabled(false)
+{
+}
+
+TraceRecorder &TraceRecorder::GetInstance()
+{
+	static TraceRecorder traceRecorder;
+	return traceRecorder;
+}
+
+void TraceRecorder::SetEnabled(bool enabled)
+{
+	m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void TraceRecorder::AddEvent(std::string_view name, Clock::time_point start, Clock::time_point end)
+{
+	Event event;
+	event.name = name;
+	event.threadId = GetCurrentThreadId();
+	event.start = std::chrono::duration_cast<std::chrono::microseconds>(start - m_creationTime);
+	event.duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+	std::scoped_lock lock(m_mutex);
+	m_events.push_back(std::move(event));
+}
+
+std::vector<TraceRecorder::Event> TraceRecorder::GetEvents() const
+{
+	std::scoped_lock lock(m_mutex);
+	return m_events;
+}
+
+std::string TraceRecorder::ExportChromeTrace() const
+{
+	auto events = GetEvents();
+	DWORD processId = GetCurrentProcessId();
+
+	std::string output = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	for (size_t i = 0; i < events.size(); i++)
+	{
+		const auto &event = events[i];
+
+		if (i > 0)
+		{
+			output += ',';
+		}
+
+		// Each span is written as a "complete" event, which contains both its start time and
+		// duration.
+		output += "\n{\"name\":";
+		AppendJsonString(output, event.name);
+		output += std::format(R"(,"ph":"X","ts":{},"dur":{},"pid":{},"tid":{}}})",
+			event.start.count(), event.duration.count(), processId, event.threadId);
+	}
+
+	output += "\n]}\n";
+
+	return output;
+}
+
+bool TraceRecorder::WriteChromeTrace(const std::wstring &path) const
+{
+	std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	stream << ExportChromeTrace();
+
+	return static_cast<bool>(stream);
+}
+
+ScopedTraceSpan::ScopedTraceSpan(const char *name) :
+	ScopedTraceSpan(TraceRecorder::GetInstance(), name)
+{
+}
+
+ScopedTraceSpan::ScopedTraceSpan(TraceRecorder &recorder, const char *name) :
+	m_recorder(recorder),
+	m_name(name)
+{
+	if (m_recorder.IsEnabled())
+	{
+		m_startTime = TraceRecorder::Clock::now();
+	}
+}
+
+ScopedTraceSpan::~ScopedTraceSpan()
+{
+	if (m_startTime)
+	{
+		m_recorder.AddEvent(m_name, *m_startTime, TraceRecorder::Clock::now());
+	}
+}
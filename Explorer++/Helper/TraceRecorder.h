@@ -0,0 +1,88 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <boost/preprocessor/cat.hpp>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Records how long individual sections of code take to run, so that the results can be viewed on
+// a timeline. Sections are recorded using the TRACE_SCOPE/TRACE_FUNCTION macros below. Spans that
+// are started while another span is active on the same thread are shown as nested within it.
+//
+// Recording is disabled by default. While disabled, the cost of a span is a single atomic load.
+class TraceRecorder
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Event
+	{
+		std::string name;
+		DWORD threadId;
+
+		// Relative to the time the recorder was created.
+		std::chrono::microseconds start;
+		std::chrono::microseconds duration;
+	};
+
+	TraceRecorder();
+
+	TraceRecorder(const TraceRecorder &) = delete;
+	TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+	// The recorder used by the TRACE_SCOPE/TRACE_FUNCTION macros.
+	static TraceRecorder &GetInstance();
+
+	void SetEnabled(bool enabled);
+
+	bool IsEnabled() const
+	{
+		return m_enabled.load(std::memory_order_relaxed);
+	}
+
+	// Can be called from any thread.
+	void AddEvent(std::string_view name, Clock::time_point start, Clock::time_point end);
+	std::vector<Event> GetEvents() const;
+
+	// Returns the recorded events in the Chrome trace event format. The output can be loaded
+	// in chrome://tracing or https://ui.perfetto.dev.
+	std::string ExportChromeTrace() const;
+	bool WriteChromeTrace(const std::wstring &path) const;
+
+private:
+	const Clock::time_point m_creationTime;
+	std::atomic<bool> m_enabled;
+
+	mutable std::mutex m_mutex;
+	std::vector<Event> m_events;
+};
+
+// Records the time between construction and destruction as a single event. The name is expected
+// to be a string literal (or to otherwise outlive the span), so that nothing needs to be copied
+// unless recording is enabled.
+class ScopedTraceSpan
+{
+public:
+	explicit ScopedTraceSpan(const char *name);
+	ScopedTraceSpan(TraceRecorder &recorder, const char *name);
+	~ScopedTraceSpan();
+
+	ScopedTraceSpan(const ScopedTraceSpan &) = delete;
+	ScopedTraceSpan &operator=(const ScopedTraceSpan &) = delete;
+
+private:
+	TraceRecorder &m_recorder;
+	const char *const m_name;
+	std::optional<TraceRecorder::Clock::time_point> m_startTime;
+};
+
+#define TRACE_SCOPE(name) ScopedTraceSpan BOOST_PP_CAT(traceSpan, __LINE__)(name)
+#define TRACE_FUNCTION() TRACE_SCOPE(__FUNCTION__)
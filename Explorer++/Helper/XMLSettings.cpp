@@ -11,6 +11,7 @@
 #include "XMLSettings.h"
 #include "Helper.h"
 #include "Macros.h"
+#include "XmlPullParser.h"
 #include <wil/com.h>
 #include <wil/resource.h>
 #include <comdef.h>
@@ -18,6 +19,45 @@
 static const TCHAR BOOL_YES[] = _T("yes");
 static const TCHAR BOOL_NO[] = _T("no");
 
+namespace
+{
+
+/* Attribute values should be between 0x00 and 0xFF. Although color values
+have a bound, it does not need to be checked for, as each color value is a
+byte, and can only hold values between 0x00 and 0xFF. */
+void ReadRgbAttributes(const XmlPullParser &parser, BYTE &r, BYTE &g, BYTE &b)
+{
+	r = 0;
+	g = 0;
+	b = 0;
+
+	for (const auto &attribute : parser.GetAttributes())
+	{
+		BYTE *component = nullptr;
+
+		if (attribute.name == "r")
+		{
+			component = &r;
+		}
+		else if (attribute.name == "g")
+		{
+			component = &g;
+		}
+		else if (attribute.name == "b")
+		{
+			component = &b;
+		}
+
+		if (component)
+		{
+			*component = (BYTE) NXMLSettings::DecodeIntValue(
+				DecodeXmlAttributeValue(attribute.rawValue).c_str());
+		}
+	}
+}
+
+}
+
 /* Helper function to create a DOM instance. */
 IXMLDOMDocument *NXMLSettings::DomFromCOM()
 {
@@ -200,153 +240,61 @@ int NXMLSettings::DecodeIntValue(const WCHAR *wszValue)
 	return _wtoi(wszValue);
 }
 
-COLORREF NXMLSettings::ReadXMLColorData(IXMLDOMNode *pNode)
+COLORREF NXMLSettings::ReadXMLColorData(const XmlPullParser &parser)
 {
-	wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> am;
-	pNode->get_attributes(&am);
-
-	long lChildNodes;
-	am->get_length(&lChildNodes);
-
-	/* RGB data requires three attributes (R,G,B). */
-	/*if(lChildNodes != 3)*/
-
-	BYTE r = 0;
-	BYTE g = 0;
-	BYTE b = 0;
-
-	/* Attribute name should be one of: r,g,b
-	Attribute value should be a value between
-	0x00 and 0xFF.
-	Although color values have a bound, it does
-	not need to be checked for, as each color
-	value is a byte, and can only hold values
-	between 0x00 and 0xFF. */
-	for (long i = 1; i < lChildNodes; i++)
-	{
-		wil::com_ptr_nothrow<IXMLDOMNode> pChildNode;
-		am->get_item(i, &pChildNode);
-
-		/* Element name. */
-		wil::unique_bstr bstrName;
-		pChildNode->get_nodeName(&bstrName);
-
-		/* Element value. */
-		wil::unique_bstr bstrValue;
-		pChildNode->get_text(&bstrValue);
-
-		if (lstrcmp(bstrName.get(), L"r") == 0)
-		{
-			r = (BYTE) NXMLSettings::DecodeIntValue(bstrValue.get());
-		}
-		else if (lstrcmp(bstrName.get(), L"g") == 0)
-		{
-			g = (BYTE) NXMLSettings::DecodeIntValue(bstrValue.get());
-		}
-		else if (lstrcmp(bstrName.get(), L"b") == 0)
-		{
-			b = (BYTE) NXMLSettings::DecodeIntValue(bstrValue.get());
-		}
-	}
+	BYTE r;
+	BYTE g;
+	BYTE b;
+	ReadRgbAttributes(parser, r, g, b);
 
 	return RGB(r, g, b);
 }
 
-Gdiplus::Color NXMLSettings::ReadXMLColorData2(IXMLDOMNode *pNode)
+Gdiplus::Color NXMLSettings::ReadXMLColorData2(const XmlPullParser &parser)
 {
-	wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> am;
-	pNode->get_attributes(&am);
-
-	long lChildNodes;
-	am->get_length(&lChildNodes);
-
-	/* RGB data requires three attributes (R,G,B). */
-	/*if(lChildNodes != 3)*/
-
-	BYTE r = 0;
-	BYTE g = 0;
-	BYTE b = 0;
-
-	/* Attribute name should be one of: r,g,b
-	Attribute value should be a value between 0x00 and 0xFF. */
-	for (long i = 1; i < lChildNodes; i++)
-	{
-		wil::com_ptr_nothrow<IXMLDOMNode> pChildNode;
-		am->get_item(i, &pChildNode);
-
-		/* Element name. */
-		wil::unique_bstr bstrName;
-		pChildNode->get_nodeName(&bstrName);
-
-		/* Element value. */
-		wil::unique_bstr bstrValue;
-		pChildNode->get_text(&bstrValue);
-
-		if (lstrcmp(bstrName.get(), L"r") == 0)
-		{
-			r = (BYTE) NXMLSettings::DecodeIntValue(bstrValue.get());
-		}
-		else if (lstrcmp(bstrName.get(), L"g") == 0)
-		{
-			g = (BYTE) NXMLSettings::DecodeIntValue(bstrValue.get());
-		}
-		else if (lstrcmp(bstrName.get(), L"b") == 0)
-		{
-			b = (BYTE) NXMLSettings::DecodeIntValue(bstrValue.get());
-		}
-	}
+	BYTE r;
+	BYTE g;
+	BYTE b;
+	ReadRgbAttributes(parser, r, g, b);
 
 	return Gdiplus::Color(r, g, b);
 }
 
-HFONT NXMLSettings::ReadXMLFontData(IXMLDOMNode *pNode)
+HFONT NXMLSettings::ReadXMLFontData(const XmlPullParser &parser)
 {
-	wil::com_ptr_nothrow<IXMLDOMNamedNodeMap> am;
-	pNode->get_attributes(&am);
-
-	long lChildNodes;
-	am->get_length(&lChildNodes);
+	LOGFONT fontInfo = {};
 
-	LOGFONT fontInfo;
-
-	for (long i = 1; i < lChildNodes; i++)
+	for (const auto &attribute : parser.GetAttributes())
 	{
-		wil::com_ptr_nothrow<IXMLDOMNode> pChildNode;
-		am->get_item(i, &pChildNode);
-
-		wil::unique_bstr bstrName;
-		pChildNode->get_nodeName(&bstrName);
-
-		wil::unique_bstr bstrValue;
-		pChildNode->get_text(&bstrValue);
+		std::wstring value = DecodeXmlAttributeValue(attribute.rawValue);
 
-		if (lstrcmp(bstrName.get(), L"Height") == 0)
+		if (attribute.name == "Height")
 		{
-			fontInfo.lfHeight = NXMLSettings::DecodeIntValue(bstrValue.get());
+			fontInfo.lfHeight = NXMLSettings::DecodeIntValue(value.c_str());
 		}
-		else if (lstrcmp(bstrName.get(), L"Width") == 0)
+		else if (attribute.name == "Width")
 		{
-			fontInfo.lfWidth = NXMLSettings::DecodeIntValue(bstrValue.get());
+			fontInfo.lfWidth = NXMLSettings::DecodeIntValue(value.c_str());
 		}
-		else if (lstrcmp(bstrName.get(), L"Weight") == 0)
+		else if (attribute.name == "Weight")
 		{
-			fontInfo.lfWeight = NXMLSettings::DecodeIntValue(bstrValue.get());
+			fontInfo.lfWeight = NXMLSettings::DecodeIntValue(value.c_str());
 		}
-		else if (lstrcmp(bstrName.get(), L"Italic") == 0)
+		else if (attribute.name == "Italic")
 		{
-			fontInfo.lfItalic = (BYTE) NXMLSettings::DecodeBoolValue(bstrValue.get());
+			fontInfo.lfItalic = (BYTE) NXMLSettings::DecodeBoolValue(value.c_str());
 		}
-		else if (lstrcmp(bstrName.get(), L"Underline") == 0)
+		else if (attribute.name == "Underline")
 		{
-			fontInfo.lfUnderline = (BYTE) NXMLSettings::DecodeBoolValue(bstrValue.get());
+			fontInfo.lfUnderline = (BYTE) NXMLSettings::DecodeBoolValue(value.c_str());
 		}
-		else if (lstrcmp(bstrName.get(), L"Strikeout") == 0)
+		else if (attribute.name == "Strikeout")
 		{
-			fontInfo.lfStrikeOut = (BYTE) NXMLSettings::DecodeBoolValue(bstrValue.get());
+			fontInfo.lfStrikeOut = (BYTE) NXMLSettings::DecodeBoolValue(value.c_str());
 		}
-		else if (lstrcmp(bstrName.get(), L"Font") == 0)
+		else if (attribute.name == "Font")
 		{
-			StringCchCopy(fontInfo.lfFaceName, SIZEOF_ARRAY(fontInfo.lfFaceName), bstrValue.get());
+			StringCchCopy(fontInfo.lfFaceName, SIZEOF_ARRAY(fontInfo.lfFaceName), value.c_str());
 		}
 	}
 
@@ -362,21 +310,19 @@ HFONT NXMLSettings::ReadXMLFontData(IXMLDOMNode *pNode)
 	return CreateFontIndirect(&fontInfo);
 }
 
-bool NXMLSettings::ReadDateTime(IXMLDOMNamedNodeMap *attributeMap, const std::wstring &baseKeyName,
+bool NXMLSettings::ReadDateTime(const XmlPullParser &parser, const std::string &baseKeyName,
 	FILETIME &dateTime)
 {
-	std::wstring lowDateTime;
-	std::wstring highDateTime;
-	HRESULT hr1 = GetStringFromMap(attributeMap, baseKeyName + L"Low", lowDateTime);
-	HRESULT hr2 = GetStringFromMap(attributeMap, baseKeyName + L"High", highDateTime);
+	auto lowDateTime = parser.GetAttribute(baseKeyName + "Low");
+	auto highDateTime = parser.GetAttribute(baseKeyName + "High");
 
-	if (FAILED(hr1) || FAILED(hr2))
+	if (!lowDateTime || !highDateTime)
 	{
 		return false;
 	}
 
-	dateTime.dwLowDateTime = stoul(lowDateTime);
-	dateTime.dwHighDateTime = stoul(highDateTime);
+	dateTime.dwLowDateTime = stoul(*lowDateTime);
+	dateTime.dwHighDateTime = stoul(*highDateTime);
 
 	return true;
 }
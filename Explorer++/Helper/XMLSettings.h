@@ -8,6 +8,9 @@
 #include <gdiplus.h>
 #include <objbase.h>
 #include <list>
+#include <string>
+
+class XmlPullParser;
 
 namespace NXMLSettings
 {
@@ -27,12 +30,13 @@ const TCHAR *EncodeBoolValue(BOOL value);
 BOOL DecodeBoolValue(const TCHAR *value);
 WCHAR *EncodeIntValue(int iValue);
 int DecodeIntValue(const WCHAR *wszValue);
-COLORREF ReadXMLColorData(IXMLDOMNode *pNode);
-Gdiplus::Color ReadXMLColorData2(IXMLDOMNode *pNode);
-HFONT ReadXMLFontData(IXMLDOMNode *pNode);
 
-bool ReadDateTime(IXMLDOMNamedNodeMap *attributeMap, const std::wstring &baseKeyName,
-	FILETIME &dateTime);
+// The following read from the attributes of the element the parser is currently positioned on.
+COLORREF ReadXMLColorData(const XmlPullParser &parser);
+Gdiplus::Color ReadXMLColorData2(const XmlPullParser &parser);
+HFONT ReadXMLFontData(const XmlPullParser &parser);
+bool ReadDateTime(const XmlPullParser &parser, const std::string &baseKeyName, FILETIME &dateTime);
+
 void SaveDateTime(IXMLDOMDocument *xmlDocument, IXMLDOMElement *parentNode,
 	const std::wstring &baseKeyName, const FILETIME &dateTime);
 HRESULT GetIntFromMap(IXMLDOMNamedNodeMap *attributeMap, const std::wstring &name,
@@ -0,0 +1,775 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "XmlPullParser.h"
+#include <algorithm>
+
+namespace
+{
+
+constexpr std::string_view UTF8_BOM = "\xEF\xBB\xBF";
+constexpr char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+bool IsWhitespace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool IsNameDelimiter(char c)
+{
+	return IsWhitespace(c) || c == '/' || c == '>' || c == '<' || c == '=' || c == '\''
+		|| c == '"' || c == '&';
+}
+
+void AppendCodePoint(std::wstring &output, char32_t codePoint)
+{
+	if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+	{
+		codePoint = REPLACEMENT_CHARACTER;
+	}
+
+	if constexpr (sizeof(wchar_t) == 2)
+	{
+		if (codePoint >= 0x10000)
+		{
+			codePoint -= 0x10000;
+			output.push_back(static_cast<wchar_t>(0xD800 + (codePoint >> 10)));
+			output.push_back(static_cast<wchar_t>(0xDC00 + (codePoint & 0x3FF)));
+			return;
+		}
+	}
+
+	output.push_back(static_cast<wchar_t>(codePoint));
+}
+
+// Decodes the UTF-8 sequence at the start of the input, advancing past it.
+char32_t DecodeUtf8CodePoint(std::string_view &input)
+{
+	auto lead = static_cast<unsigned char>(input[0]);
+
+	if (lead < 0x80)
+	{
+		input.remove_prefix(1);
+		return lead;
+	}
+
+	size_t length;
+	char32_t codePoint;
+	char32_t minimum;
+
+	if ((lead & 0xE0) == 0xC0)
+	{
+		length = 2;
+		codePoint = lead & 0x1F;
+		minimum = 0x80;
+	}
+	else if ((lead & 0xF0) == 0xE0)
+	{
+		length = 3;
+		codePoint = lead & 0x0F;
+		minimum = 0x800;
+	}
+	else if ((lead & 0xF8) == 0xF0)
+	{
+		length = 4;
+		codePoint = lead & 0x07;
+		minimum = 0x10000;
+	}
+	else
+	{
+		input.remove_prefix(1);
+		return REPLACEMENT_CHARACTER;
+	}
+
+	if (input.size() < length)
+	{
+		input.remove_prefix(1);
+		return REPLACEMENT_CHARACTER;
+	}
+
+	for (size_t i = 1; i < length; i++)
+	{
+		auto continuation = static_cast<unsigned char>(input[i]);
+
+		if ((continuation & 0xC0) != 0x80)
+		{
+			input.remove_prefix(1);
+			return REPLACEMENT_CHARACTER;
+		}
+
+		codePoint = (codePoint << 6) | (continuation & 0x3F);
+	}
+
+	input.remove_prefix(length);
+
+	// Overlong encodings aren't valid.
+	if (codePoint < minimum)
+	{
+		return REPLACEMENT_CHARACTER;
+	}
+
+	return codePoint;
+}
+
+// Decodes the reference at the start of the input (which begins with '&'). If the reference isn't
+// valid, std::nullopt is returned and the input is left unchanged.
+std::optional<char32_t> DecodeReference(std::string_view &input)
+{
+	// The longest valid reference is a hexadecimal character reference, like "&#x10FFFF;".
+	size_t end = input.find(';');
+
+	if (end == std::string_view::npos || end > 10)
+	{
+		return std::nullopt;
+	}
+
+	std::string_view name = input.substr(1, end - 1);
+	std::optional<char32_t> codePoint;
+
+	if (name == "lt")
+	{
+		codePoint = '<';
+	}
+	else if (name == "gt")
+	{
+		codePoint = '>';
+	}
+	else if (name == "amp")
+	{
+		codePoint = '&';
+	}
+	else if (name == "quot")
+	{
+		codePoint = '"';
+	}
+	else if (name == "apos")
+	{
+		codePoint = '\'';
+	}
+	else if (name.size() > 1 && name[0] == '#')
+	{
+		bool hex = (name[1] == 'x');
+		std::string_view digits = name.substr(hex ? 2 : 1);
+
+		if (digits.empty())
+		{
+			return std::nullopt;
+		}
+
+		char32_t value = 0;
+
+		for (char c : digits)
+		{
+			int digit;
+
+			if (c >= '0' && c <= '9')
+			{
+				digit = c - '0';
+			}
+			else if (hex && c >= 'a' && c <= 'f')
+			{
+				digit = c - 'a' + 10;
+			}
+			else if (hex && c >= 'A' && c <= 'F')
+			{
+				digit = c - 'A' + 10;
+			}
+			else
+			{
+				return std::nullopt;
+			}
+
+			value = value * (hex ? 16 : 10) + digit;
+		}
+
+		codePoint = value;
+	}
+
+	if (codePoint)
+	{
+		input.remove_prefix(end + 1);
+	}
+
+	return codePoint;
+}
+
+enum class DecodeMode
+{
+	AttributeValue,
+	Text,
+	CData
+};
+
+std::wstring Decode(std::string_view input, DecodeMode mode)
+{
+	std::wstring output;
+	output.reserve(input.size());
+
+	while (!input.empty())
+	{
+		char c = input[0];
+
+		if (c == '&' && mode != DecodeMode::CData)
+		{
+			if (auto codePoint = DecodeReference(input))
+			{
+				AppendCodePoint(output, *codePoint);
+				continue;
+			}
+		}
+
+		if (c == '\r' || c == '\n' || c == '\t')
+		{
+			// Line breaks are normalized to a single '\n'. Within attribute values, line breaks
+			// and tabs are also replaced with spaces.
+			input.remove_prefix((c == '\r' && input.size() > 1 && input[1] == '\n') ? 2 : 1);
+
+			if (mode == DecodeMode::AttributeValue)
+			{
+				output.push_back(' ');
+			}
+			else
+			{
+				output.push_back(c == '\t' ? '\t' : '\n');
+			}
+
+			continue;
+		}
+
+		AppendCodePoint(output, DecodeUtf8CodePoint(input));
+	}
+
+	return output;
+}
+
+}
+
+XmlPullParser::XmlPullParser(std::string_view data) : m_data(data)
+{
+	if (m_data.starts_with(UTF8_BOM))
+	{
+		m_position = UTF8_BOM.size();
+	}
+}
+
+std::optional<XmlPullParser> XmlPullParser::OpenTopLevelElement(std::string_view data,
+	std::string_view name)
+{
+	XmlPullParser parser(data);
+
+	if (!parser.NextChildElement(0) || !parser.FindChildElement(1, name))
+	{
+		return std::nullopt;
+	}
+
+	return parser;
+}
+
+XmlPullParser::Event XmlPullParser::Next()
+{
+	if (m_invalid || m_event == Event::EndDocument)
+	{
+		return m_event;
+	}
+
+	if (m_pendingEndElement)
+	{
+		m_pendingEndElement = false;
+		m_name = m_openElements.back();
+		m_openElements.pop_back();
+		return SetEvent(Event::EndElement);
+	}
+
+	while (m_position < m_data.size())
+	{
+		if (m_data[m_position] == '<')
+		{
+			// Comments, processing instructions and the like are skipped, in which case there's
+			// no event to report.
+			if (auto event = ParseMarkup())
+			{
+				return *event;
+			}
+
+			continue;
+		}
+
+		size_t end = m_data.find('<', m_position);
+
+		if (end == std::string_view::npos)
+		{
+			end = m_data.size();
+		}
+
+		std::string_view text = m_data.substr(m_position, end - m_position);
+		m_position = end;
+
+		if (m_openElements.empty())
+		{
+			// Only whitespace can appear outside the root element.
+			if (std::any_of(text.begin(), text.end(), [](char c) { return !IsWhitespace(c); }))
+			{
+				return SetEvent(Event::Error);
+			}
+
+			continue;
+		}
+
+		m_text = text;
+		m_isCData = false;
+		return SetEvent(Event::Text);
+	}
+
+	if (!m_rootElementSeen || !m_openElements.empty())
+	{
+		return SetEvent(Event::Error);
+	}
+
+	return SetEvent(Event::EndDocument);
+}
+
+// Returns std::nullopt if the markup was skipped.
+std::optional<XmlPullParser::Event> XmlPullParser::ParseMarkup()
+{
+	std::string_view remaining = m_data.substr(m_position);
+
+	if (remaining.starts_with("<?"))
+	{
+		m_position += 2;
+
+		if (!SkipUntil("?>"))
+		{
+			return SetEvent(Event::Error);
+		}
+
+		return std::nullopt;
+	}
+	else if (remaining.starts_with("<!--"))
+	{
+		m_position += 4;
+
+		if (!SkipUntil("-->"))
+		{
+			return SetEvent(Event::Error);
+		}
+
+		return std::nullopt;
+	}
+	else if (remaining.starts_with("<![CDATA["))
+	{
+		if (m_openElements.empty())
+		{
+			return SetEvent(Event::Error);
+		}
+
+		m_position += 9;
+		size_t start = m_position;
+
+		if (!SkipUntil("]]>"))
+		{
+			return SetEvent(Event::Error);
+		}
+
+		m_text = m_data.substr(start, m_position - 3 - start);
+		m_isCData = true;
+		return SetEvent(Event::Text);
+	}
+	else if (remaining.starts_with("<!"))
+	{
+		if (m_rootElementSeen)
+		{
+			return SetEvent(Event::Error);
+		}
+
+		m_position += 2;
+
+		if (!SkipDocumentTypeDeclaration())
+		{
+			return SetEvent(Event::Error);
+		}
+
+		return std::nullopt;
+	}
+	else if (remaining.starts_with("</"))
+	{
+		return ParseEndTag();
+	}
+
+	return ParseStartTag();
+}
+
+XmlPullParser::Event XmlPullParser::ParseStartTag()
+{
+	// Only a single root element is allowed.
+	if (m_openElements.empty() && m_rootElementSeen)
+	{
+		return SetEvent(Event::Error);
+	}
+
+	m_position++;
+	std::string_view name = ParseName();
+
+	if (name.empty())
+	{
+		return SetEvent(Event::Error);
+	}
+
+	m_attributes.clear();
+
+	while (true)
+	{
+		size_t whitespaceStart = m_position;
+		SkipWhitespace();
+
+		if (m_position >= m_data.size())
+		{
+			return SetEvent(Event::Error);
+		}
+
+		char c = m_data[m_position];
+
+		if (c == '>' || c == '/')
+		{
+			if (c == '/')
+			{
+				if (m_position + 1 >= m_data.size() || m_data[m_position + 1] != '>')
+				{
+					return SetEvent(Event::Error);
+				}
+
+				m_position++;
+				m_pendingEndElement = true;
+			}
+
+			m_position++;
+			break;
+		}
+
+		// Attributes need to be separated from the element name and from each other.
+		if (m_position == whitespaceStart)
+		{
+			return SetEvent(Event::Error);
+		}
+
+		std::string_view attributeName = ParseName();
+
+		if (attributeName.empty())
+		{
+			return SetEvent(Event::Error);
+		}
+
+		SkipWhitespace();
+
+		if (m_position >= m_data.size() || m_data[m_position] != '=')
+		{
+			return SetEvent(Event::Error);
+		}
+
+		m_position++;
+		SkipWhitespace();
+
+		if (m_position >= m_data.size()
+			|| (m_data[m_position] != '"' && m_data[m_position] != '\''))
+		{
+			return SetEvent(Event::Error);
+		}
+
+		char quote = m_data[m_position];
+		size_t valueStart = m_position + 1;
+		size_t valueEnd = m_data.find(quote, valueStart);
+
+		if (valueEnd == std::string_view::npos)
+		{
+			return SetEvent(Event::Error);
+		}
+
+		std::string_view rawValue = m_data.substr(valueStart, valueEnd - valueStart);
+
+		if (rawValue.find('<') != std::string_view::npos)
+		{
+			return SetEvent(Event::Error);
+		}
+
+		m_attributes.push_back({ attributeName, rawValue });
+		m_position = valueEnd + 1;
+	}
+
+	m_name = name;
+	m_openElements.push_back(name);
+	m_rootElementSeen = true;
+	return SetEvent(Event::StartElement);
+}
+
+XmlPullParser::Event XmlPullParser::ParseEndTag()
+{
+	m_position += 2;
+	std::string_view name = ParseName();
+	SkipWhitespace();
+
+	if (name.empty() || m_position >= m_data.size() || m_data[m_position] != '>')
+	{
+		return SetEvent(Event::Error);
+	}
+
+	m_position++;
+
+	if (m_openElements.empty() || m_openElements.back() != name)
+	{
+		return SetEvent(Event::Error);
+	}
+
+	m_openElements.pop_back();
+	m_name = name;
+	return SetEvent(Event::EndElement);
+}
+
+std::string_view XmlPullParser::ParseName()
+{
+	size_t start = m_position;
+
+	while (m_position < m_data.size() && !IsNameDelimiter(m_data[m_position]))
+	{
+		m_position++;
+	}
+
+	return m_data.substr(start, m_position - start);
+}
+
+bool XmlPullParser::SkipUntil(std::string_view terminator)
+{
+	size_t end = m_data.find(terminator, m_position);
+
+	if (end == std::string_view::npos)
+	{
+		return false;
+	}
+
+	m_position = end + terminator.size();
+	return true;
+}
+
+// A document type declaration can contain an internal subset (enclosed in square brackets), which
+// can itself contain '>' characters.
+bool XmlPullParser::SkipDocumentTypeDeclaration()
+{
+	int bracketDepth = 0;
+	char quote = '\0';
+
+	for (; m_position < m_data.size(); m_position++)
+	{
+		char c = m_data[m_position];
+
+		if (quote != '\0')
+		{
+			if (c == quote)
+			{
+				quote = '\0';
+			}
+		}
+		else if (c == '"' || c == '\'')
+		{
+			quote = c;
+		}
+		else if (c == '[')
+		{
+			bracketDepth++;
+		}
+		else if (c == ']')
+		{
+			bracketDepth--;
+		}
+		else if (c == '>' && bracketDepth <= 0)
+		{
+			m_position++;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void XmlPullParser::SkipWhitespace()
+{
+	while (m_position < m_data.size() && IsWhitespace(m_data[m_position]))
+	{
+		m_position++;
+	}
+}
+
+XmlPullParser::Event XmlPullParser::SetEvent(Event event)
+{
+	m_event = event;
+
+	if (event == Event::Error)
+	{
+		m_invalid = true;
+	}
+
+	return event;
+}
+
+XmlPullParser::Event XmlPullParser::GetEvent() const
+{
+	return m_event;
+}
+
+size_t XmlPullParser::GetDepth() const
+{
+	return m_openElements.size();
+}
+
+std::string_view XmlPullParser::GetName() const
+{
+	return m_name;
+}
+
+const std::vector<XmlPullParser::Attribute> &XmlPullParser::GetAttributes() const
+{
+	return m_attributes;
+}
+
+std::optional<std::string_view> XmlPullParser::GetRawAttribute(std::string_view name) const
+{
+	for (const auto &attribute : m_attributes)
+	{
+		if (attribute.name == name)
+		{
+			return attribute.rawValue;
+		}
+	}
+
+	return std::nullopt;
+}
+
+std::optional<std::wstring> XmlPullParser::GetAttribute(std::string_view name) const
+{
+	auto rawValue = GetRawAttribute(name);
+
+	if (!rawValue)
+	{
+		return std::nullopt;
+	}
+
+	return DecodeXmlAttributeValue(*rawValue);
+}
+
+std::string_view XmlPullParser::GetRawText() const
+{
+	return m_text;
+}
+
+bool XmlPullParser::IsCData() const
+{
+	return m_isCData;
+}
+
+bool XmlPullParser::NextChildElement(size_t parentDepth)
+{
+	while (true)
+	{
+		switch (Next())
+		{
+		case Event::StartElement:
+			if (GetDepth() == parentDepth + 1)
+			{
+				return true;
+			}
+			break;
+
+		case Event::EndElement:
+			if (GetDepth() < parentDepth)
+			{
+				return false;
+			}
+			break;
+
+		case Event::Text:
+			break;
+
+		case Event::EndDocument:
+		case Event::Error:
+			return false;
+		}
+	}
+}
+
+bool XmlPullParser::FindChildElement(size_t parentDepth, std::string_view name)
+{
+	while (NextChildElement(parentDepth))
+	{
+		if (GetName() == name)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+std::optional<std::wstring> XmlPullParser::ReadElementText()
+{
+	size_t depth = GetDepth();
+	std::wstring text;
+
+	while (true)
+	{
+		switch (Next())
+		{
+		case Event::StartElement:
+			break;
+
+		case Event::EndElement:
+			if (GetDepth() < depth)
+			{
+				return text;
+			}
+			break;
+
+		case Event::Text:
+			text += DecodeXmlText(m_text, m_isCData);
+			break;
+
+		case Event::EndDocument:
+		case Event::Error:
+			return std::nullopt;
+		}
+	}
+}
+
+bool XmlPullParser::SkipElement()
+{
+	size_t depth = GetDepth();
+
+	while (true)
+	{
+		switch (Next())
+		{
+		case Event::StartElement:
+		case Event::Text:
+			break;
+
+		case Event::EndElement:
+			if (GetDepth() < depth)
+			{
+				return true;
+			}
+			break;
+
+		case Event::EndDocument:
+		case Event::Error:
+			return false;
+		}
+	}
+}
+
+std::wstring DecodeXmlAttributeValue(std::string_view rawValue)
+{
+	return Decode(rawValue, DecodeMode::AttributeValue);
+}
+
+std::wstring DecodeXmlText(std::string_view rawText, bool isCData)
+{
+	return Decode(rawText, isCData ? DecodeMode::CData : DecodeMode::Text);
+}
@@ -0,0 +1,114 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A minimal, forward-only XML parser. It reads directly from a UTF-8 buffer, without building a
+// tree, and element names, attribute values and text are all returned as views into that buffer.
+// Entity references are only decoded when a value is converted to a string.
+//
+// Only what's needed to read settings files is supported. Document type declarations are skipped
+// and only the predefined and numeric character references are recognized.
+class XmlPullParser
+{
+public:
+	enum class Event
+	{
+		StartElement,
+		EndElement,
+		Text,
+		EndDocument,
+		Error
+	};
+
+	struct Attribute
+	{
+		std::string_view name;
+
+		// The value as it appears in the document, without any references decoded.
+		std::string_view rawValue;
+	};
+
+	explicit XmlPullParser(std::string_view data);
+
+	// Returns a parser positioned on the start tag of the first element with the specified name
+	// that's a direct child of the root element, or std::nullopt if there's no such element.
+	static std::optional<XmlPullParser> OpenTopLevelElement(std::string_view data,
+		std::string_view name);
+
+	Event Next();
+	Event GetEvent() const;
+
+	// The number of elements that are currently open. After a StartElement event, this includes
+	// the element that was just started. After an EndElement event, it doesn't include the
+	// element that was just ended.
+	size_t GetDepth() const;
+
+	// The following are only valid for StartElement and EndElement events.
+	std::string_view GetName() const;
+
+	// The following are only valid for StartElement events.
+	const std::vector<Attribute> &GetAttributes() const;
+	std::optional<std::string_view> GetRawAttribute(std::string_view name) const;
+	std::optional<std::wstring> GetAttribute(std::string_view name) const;
+
+	// The following are only valid for Text events.
+	std::string_view GetRawText() const;
+	bool IsCData() const;
+
+	// Advances to the next element that's a direct child of the element open at the specified
+	// depth. Anything nested within the current element is skipped. Returns false once the parent
+	// element has been closed, or if the document is invalid.
+	bool NextChildElement(size_t parentDepth);
+
+	// Similar to NextChildElement(), except that children with other names are skipped.
+	bool FindChildElement(size_t parentDepth, std::string_view name);
+
+	// Should be called after a StartElement event. Reads all the text within the element and moves
+	// past its end tag.
+	std::optional<std::wstring> ReadElementText();
+
+	// Should be called after a StartElement event. Moves past the end tag of the element.
+	bool SkipElement();
+
+private:
+	std::optional<Event> ParseMarkup();
+	Event ParseStartTag();
+	Event ParseEndTag();
+	std::string_view ParseName();
+	bool SkipUntil(std::string_view terminator);
+	bool SkipDocumentTypeDeclaration();
+	void SkipWhitespace();
+	Event SetEvent(Event event);
+
+	const std::string_view m_data;
+	size_t m_position = 0;
+
+	Event m_event = Event::Error;
+
+	// Once the document has been found to be invalid, parsing stops.
+	bool m_invalid = false;
+
+	std::string_view m_name;
+	std::vector<Attribute> m_attributes;
+	std::string_view m_text;
+	bool m_isCData = false;
+
+	std::vector<std::string_view> m_openElements;
+	bool m_rootElementSeen = false;
+
+	// Set when an empty-element tag (e.g. <element />) is encountered. The end of the element is
+	// then reported by the next call to Next().
+	bool m_pendingEndElement = false;
+};
+
+// Convert raw values returned by the parser to wide strings, decoding any references and
+// normalizing line breaks. Invalid UTF-8 sequences are replaced with U+FFFD.
+std::wstring DecodeXmlAttributeValue(std::string_view rawValue);
+std::wstring DecodeXmlText(std::string_view rawText, bool isCData = false);
@@ -0,0 +1,180 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "stdafx.h"
+#include "XxHash64Hasher.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace
+{
+
+const std::uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+const std::uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+const std::uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+const std::uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+const std::uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+// Input is read in little-endian order, which matches the byte order on Windows.
+std::uint64_t Read64(const BYTE *data)
+{
+	std::uint64_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+std::uint32_t Read32(const BYTE *data)
+{
+	std::uint32_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+std::uint64_t Round(std::uint64_t accumulator, std::uint64_t input)
+{
+	accumulator += input * PRIME64_2;
+	accumulator = std::rotl(accumulator, 31);
+	return accumulator * PRIME64_1;
+}
+
+std::uint64_t MergeRound(std::uint64_t accumulator, std::uint64_t lane)
+{
+	accumulator ^= Round(0, lane);
+	return accumulator * PRIME64_1 + PRIME64_4;
+}
+
+}
+
+XxHash64Hasher::XxHash64Hasher(std::uint64_t seed) : m_seed(seed)
+{
+	Reset();
+}
+
+void XxHash64Hasher::Reset()
+{
+	m_lanes = { m_seed + PRIME64_1 + PRIME64_2, m_seed + PRIME64_2, m_seed, m_seed - PRIME64_1 };
+	m_totalSize = 0;
+	m_pendingSize = 0;
+}
+
+void XxHash64Hasher::ProcessStripe(const BYTE *data)
+{
+	for (size_t i = 0; i < m_lanes.size(); i++)
+	{
+		m_lanes[i] = Round(m_lanes[i], Read64(data + i * 8));
+	}
+}
+
+void XxHash64Hasher::Update(const BYTE *data, size_t size)
+{
+	m_totalSize += size;
+
+	if (m_pendingSize > 0)
+	{
+		size_t amountToCopy = std::min<size_t>(size, STRIPE_SIZE - m_pendingSize);
+		std::memcpy(m_pendingData.data() + m_pendingSize, data, amountToCopy);
+		m_pendingSize += amountToCopy;
+		data += amountToCopy;
+		size -= amountToCopy;
+
+		if (m_pendingSize < STRIPE_SIZE)
+		{
+			return;
+		}
+
+		ProcessStripe(m_pendingData.data());
+		m_pendingSize = 0;
+	}
+
+	while (size >= STRIPE_SIZE)
+	{
+		ProcessStripe(data);
+		data += STRIPE_SIZE;
+		size -= STRIPE_SIZE;
+	}
+
+	std::memcpy(m_pendingData.data(), data, size);
+	m_pendingSize = size;
+}
+
+std::uint64_t XxHash64Hasher::CalculateDigest() const
+{
+	std::uint64_t hash;
+
+	if (m_totalSize >= STRIPE_SIZE)
+	{
+		hash = std::rotl(m_lanes[0], 1) + std::rotl(m_lanes[1], 7) + std::rotl(m_lanes[2], 12)
+			+ std::rotl(m_lanes[3], 18);
+
+		for (auto lane : m_lanes)
+		{
+			hash = MergeRound(hash, lane);
+		}
+	}
+	else
+	{
+		hash = m_seed + PRIME64_5;
+	}
+
+	hash += m_totalSize;
+
+	const BYTE *data = m_pendingData.data();
+	size_t size = m_pendingSize;
+
+	while (size >= 8)
+	{
+		hash ^= Round(0, Read64(data));
+		hash = std::rotl(hash, 27) * PRIME64_1 + PRIME64_4;
+		data += 8;
+		size -= 8;
+	}
+
+	if (size >= 4)
+	{
+		hash ^= static_cast<std::uint64_t>(Read32(data)) * PRIME64_1;
+		hash = std::rotl(hash, 23) * PRIME64_2 + PRIME64_3;
+		data += 4;
+		size -= 4;
+	}
+
+	while (size > 0)
+	{
+		hash ^= *data * PRIME64_5;
+		hash = std::rotl(hash, 11) * PRIME64_1;
+		data++;
+		size--;
+	}
+
+	hash ^= hash >> 33;
+	hash *= PRIME64_2;
+	hash ^= hash >> 29;
+	hash *= PRIME64_3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+
+std::uint64_t XxHash64Hasher::FinishAsNumber()
+{
+	std::uint64_t hash = CalculateDigest();
+	Reset();
+	return hash;
+}
+
+std::string XxHash64Hasher::Finish()
+{
+	std::uint64_t hash = FinishAsNumber();
+
+	static const char hexDigits[] = "0123456789abcdef";
+	std::string hexDigest;
+	hexDigest.reserve(16);
+
+	for (int shift = 60; shift >= 0; shift -= 4)
+	{
+		hexDigest.push_back(hexDigits[(hash >> shift) & 0x0F]);
+	}
+
+	return hexDigest;
+}
@@ -0,0 +1,43 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Incrementally computes an XXH64 hash. XXH64 isn't a cryptographic hash, but it's considerably
+// faster than SHA-256, since it processes 32 bytes at a time using four independent lanes, which
+// the processor can execute in parallel.
+class XxHash64Hasher
+{
+public:
+	explicit XxHash64Hasher(std::uint64_t seed = 0);
+
+	void Update(const BYTE *data, size_t size);
+
+	// Returns the hash as a 16 character lowercase hex string (in the same format used by the
+	// reference xxhsum tool). Once this has been called, the hasher is reset and can be used to
+	// hash a new set of data.
+	std::string Finish();
+
+	// Returns the hash as a number, rather than as a string. As with Finish(), the hasher is reset.
+	std::uint64_t FinishAsNumber();
+
+private:
+	static constexpr size_t STRIPE_SIZE = 32;
+
+	void Reset();
+	void ProcessStripe(const BYTE *data);
+	std::uint64_t CalculateDigest() const;
+
+	const std::uint64_t m_seed;
+	std::array<std::uint64_t, 4> m_lanes;
+	std::uint64_t m_totalSize;
+
+	// Holds any data that doesn't make up a complete stripe.
+	std::array<BYTE, STRIPE_SIZE> m_pendingData;
+	size_t m_pendingSize;
+};
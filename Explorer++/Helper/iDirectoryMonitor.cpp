@@ -5,6 +5,7 @@
 #include "stdafx.h"
 #include "iDirectoryMonitor.h"
 #include "Macros.h"
+#include <algorithm>
 #include <list>
 
 DWORD WINAPI Thread_DirModifiedInternal(LPVOID Container);
@@ -26,7 +27,11 @@ public:
 	BOOL StopDirectoryMonitor(int iStopId) override;
 
 private:
-#define PRIMARY_BUFFER_SIZE 1000 * sizeof(FILE_NOTIFY_INFORMATION)
+	// The notification buffer for each directory starts out small and is grown if it turns out
+	// not to be large enough. Buffers larger than 64KB aren't supported when monitoring
+	// directories over the network.
+	static constexpr DWORD INITIAL_BUFFER_SIZE = 4 * 1024;
+	static constexpr DWORD MAX_BUFFER_SIZE = 64 * 1024;
 
 	/* These function are only ever queued as APC's. */
 	static void CALLBACK WatchAndCreateDirectoryInternal(ULONG_PTR dwParam);
@@ -51,6 +56,8 @@ private:
 
 		DirectoryMonitor *m_pDirectoryMonitor;
 		FILE_NOTIFY_INFORMATION *m_FileNotifyBuffer;
+		DWORD m_BufferSize;
+		DWORD m_AllocatedBufferSize;
 		HANDLE m_hThread;
 		HANDLE m_hDirectory;
 		OVERLAPPED m_Async;
@@ -63,6 +70,8 @@ private:
 		int m_UniqueId;
 	};
 
+	static void GrowBuffer(DirInfo *pDirInfo);
+
 	int m_iRefCount;
 	DWORD m_ThreadId;
 	HANDLE m_hThread;
@@ -198,6 +207,9 @@ std::optional<int> DirectoryMonitor::WatchDirectory(const TCHAR *Directory, UINT
 	pDirInfo.m_pData = pData;
 	pDirInfo.m_bWatchSubTree = bWatchSubTree;
 	pDirInfo.m_bMarkedForDeletion = FALSE;
+	pDirInfo.m_FileNotifyBuffer = nullptr;
+	pDirInfo.m_BufferSize = INITIAL_BUFFER_SIZE;
+	pDirInfo.m_AllocatedBufferSize = 0;
 
 	/* This suppresses crtical error message boxes, such as the one
 	that mey arise from CreateFile() when opening attempting to
@@ -213,7 +225,6 @@ std::optional<int> DirectoryMonitor::WatchDirectory(const TCHAR *Directory, UINT
 
 	if (pDirInfo.m_hDirectory == INVALID_HANDLE_VALUE)
 	{
-		free(pData);
 		return std::nullopt;
 	}
 
@@ -251,6 +262,9 @@ std::optional<int> DirectoryMonitor::WatchDirectory(HANDLE hDirectory, const TCH
 	pDirInfo.m_pData = pData;
 	pDirInfo.m_bWatchSubTree = bWatchSubTree;
 	pDirInfo.m_bMarkedForDeletion = FALSE;
+	pDirInfo.m_FileNotifyBuffer = nullptr;
+	pDirInfo.m_BufferSize = INITIAL_BUFFER_SIZE;
+	pDirInfo.m_AllocatedBufferSize = 0;
 
 	/* This suppresses crtical error message boxes, such as the one
 	that mey arise from CreateFile() when opening attempting to
@@ -302,15 +316,25 @@ void DirectoryMonitor::WatchDirectoryInternal(ULONG_PTR dwParam)
 		return;
 	}
 
-	pDirInfo->m_FileNotifyBuffer = (FILE_NOTIFY_INFORMATION *) malloc(PRIMARY_BUFFER_SIZE);
+	/* The buffer is reused between reads and only
+	reallocated if its size has changed. */
+	if (pDirInfo->m_AllocatedBufferSize != pDirInfo->m_BufferSize)
+	{
+		free(pDirInfo->m_FileNotifyBuffer);
+
+		pDirInfo->m_FileNotifyBuffer = (FILE_NOTIFY_INFORMATION *) malloc(pDirInfo->m_BufferSize);
+		pDirInfo->m_AllocatedBufferSize = pDirInfo->m_BufferSize;
+	}
 
 	pDirInfo->m_bDirMonitored = ReadDirectoryChangesW(pDirInfo->m_hDirectory,
-		pDirInfo->m_FileNotifyBuffer, PRIMARY_BUFFER_SIZE, pDirInfo->m_bWatchSubTree,
+		pDirInfo->m_FileNotifyBuffer, pDirInfo->m_AllocatedBufferSize, pDirInfo->m_bWatchSubTree,
 		pDirInfo->m_WatchFlags, nullptr, &pDirInfo->m_Async, CompletionRoutine);
 
 	if (!pDirInfo->m_bDirMonitored)
 	{
 		free(pDirInfo->m_FileNotifyBuffer);
+		pDirInfo->m_FileNotifyBuffer = nullptr;
+		pDirInfo->m_AllocatedBufferSize = 0;
 		CancelIo(pDirInfo->m_hDirectory);
 		CloseHandle(pDirInfo->m_hDirectory);
 	}
@@ -350,13 +374,36 @@ void CALLBACK DirectoryMonitor::CompletionRoutine(DWORD dwErrorCode, DWORD Numbe
 			i++;
 		} while (pfni->NextEntryOffset != 0);
 
-		free(pDirInfo->m_FileNotifyBuffer);
-
-		pDirInfo->m_FileNotifyBuffer = nullptr;
+		/* If the buffer was close to being filled, a
+		larger burst of changes could cause it to
+		overflow, so grow it pre-emptively. */
+		if (NumberOfBytesTransferred > (pDirInfo->m_AllocatedBufferSize / 4) * 3)
+		{
+			GrowBuffer(pDirInfo);
+		}
 
 		/* Rewatch the directory. */
 		WatchDirectoryInternal((ULONG_PTR) pDirInfo);
 	}
+	else if ((dwErrorCode == ERROR_SUCCESS && NumberOfBytesTransferred == 0)
+		|| dwErrorCode == ERROR_NOTIFY_ENUM_DIR)
+	{
+		/* The buffer overflowed, so the changes that
+		occurred have been lost. */
+		if (lpOverlapped->hEvent == nullptr)
+		{
+			return;
+		}
+
+		pDirInfo = reinterpret_cast<DirInfo *>(lpOverlapped->hEvent);
+
+		pDirInfo->m_OnDirectoryAltered(_T(""), DIRECTORY_MONITOR_ACTION_OVERFLOW,
+			pDirInfo->m_pData);
+
+		GrowBuffer(pDirInfo);
+
+		WatchDirectoryInternal((ULONG_PTR) pDirInfo);
+	}
 	else if (dwErrorCode == ERROR_OPERATION_ABORTED)
 	{
 		pDirInfo = reinterpret_cast<DirInfo *>(lpOverlapped->hEvent);
@@ -367,6 +414,11 @@ void CALLBACK DirectoryMonitor::CompletionRoutine(DWORD dwErrorCode, DWORD Numbe
 	}
 }
 
+void DirectoryMonitor::GrowBuffer(DirInfo *pDirInfo)
+{
+	pDirInfo->m_BufferSize = std::min<DWORD>(pDirInfo->m_BufferSize * 2, MAX_BUFFER_SIZE);
+}
+
 void DirectoryMonitor::DeleteRequest(ULONG_PTR dwParam)
 {
 	DirInfo *pDirInfo = nullptr;
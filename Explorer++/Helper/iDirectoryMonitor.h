@@ -9,7 +9,13 @@
 
 typedef void (*OnDirectoryAltered)(const TCHAR *szFileName, DWORD dwAction, void *pData);
 
-/* Main exported interface. */
+// Passed to the callback (along with an empty file name) when changes have been lost, because more
+// changes occurred than could be stored. The directory will need to be rescanned.
+constexpr DWORD DIRECTORY_MONITOR_ACTION_OVERFLOW = 0xFFFFFFFF;
+
+/* Main exported interface. The data passed to WatchDirectory() must be
+allocated with malloc(). The monitor only takes ownership of it (and frees it
+once the watch is stopped) if the watch is successfully started. */
 __interface IDirectoryMonitor : IUnknown
 {
 	std::optional<int> WatchDirectory(const TCHAR *Directory, UINT WatchFlags,
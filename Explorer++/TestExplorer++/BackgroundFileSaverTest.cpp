@@ -0,0 +1,221 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/BackgroundFileSaver.h"
+#include "TempDirectoryHelper.h"
+#include "../Helper/AtomicFileWriter.h"
+#include <gtest/gtest.h>
+#include <future>
+
+class BackgroundFileSaverTest : public TempDirectoryTest
+{
+protected:
+	void SetUp() override
+	{
+		TempDirectoryTest::SetUp();
+
+		m_path = m_tempDirectory / L"config.xml";
+	}
+
+	static std::vector<BYTE> ToBytes(std::string_view data)
+	{
+		return std::vector<BYTE>(data.begin(), data.end());
+	}
+
+	std::filesystem::path m_path;
+};
+
+TEST_F(BackgroundFileSaverTest, Save)
+{
+	std::vector<BackgroundFileSaver::SaveResult> results;
+
+	BackgroundFileSaver saver(m_path.wstring(),
+		[&results](const BackgroundFileSaver::SaveResult &result)
+		{
+			results.push_back(result);
+		});
+
+	std::string data = "<ExplorerPlusPlus />";
+	saver.Save(
+		[data]()
+		{
+			return std::optional<std::string>(data);
+		});
+	saver.Flush();
+
+	EXPECT_EQ(ReadFileContents(m_path), ToBytes(data));
+
+	ASSERT_EQ(results.size(), 1u);
+	EXPECT_TRUE(results[0].succeeded);
+	EXPECT_EQ(results[0].size, data.size());
+	EXPECT_GE(results[0].duration.count(), 0);
+
+	// The temporary file should have been moved over the target.
+	EXPECT_FALSE(std::filesystem::exists(m_path.wstring() + L".tmp"));
+}
+
+TEST_F(BackgroundFileSaverTest, SaveOnDestruction)
+{
+	auto data = GenerateTestData(256 * 1024);
+
+	{
+		BackgroundFileSaver saver(m_path.wstring());
+		saver.Save(
+			[&data]()
+			{
+				return std::string(data.begin(), data.end());
+			});
+	}
+
+	EXPECT_EQ(ReadFileContents(m_path), data);
+}
+
+TEST_F(BackgroundFileSaverTest, SavesCoalesced)
+{
+	std::promise<void> firstSaveStarted;
+	std::promise<void> firstSaveReleased;
+	auto firstSaveReleasedFuture = firstSaveReleased.get_future();
+	int numSerializations = 0;
+
+	BackgroundFileSaver saver(m_path.wstring());
+
+	saver.Save(
+		[&]()
+		{
+			numSerializations++;
+			firstSaveStarted.set_value();
+			firstSaveReleasedFuture.wait();
+			return std::optional<std::string>("first");
+		});
+
+	firstSaveStarted.get_future().wait();
+
+	// While the first save is in progress, each of these replaces the one before it, so only the
+	// last should be written.
+	for (int i = 0; i < 10; i++)
+	{
+		saver.Save(
+			[&numSerializations, i]()
+			{
+				numSerializations++;
+				return std::optional<std::string>("save " + std::to_string(i));
+			});
+	}
+
+	firstSaveReleased.set_value();
+	saver.Flush();
+
+	EXPECT_EQ(numSerializations, 2);
+	EXPECT_EQ(ReadFileContents(m_path), ToBytes("save 9"));
+}
+
+TEST_F(BackgroundFileSaverTest, SaveCallbacks)
+{
+	std::promise<void> firstSaveStarted;
+	std::promise<void> firstSaveReleased;
+	auto firstSaveReleasedFuture = firstSaveReleased.get_future();
+	std::vector<int> completedSaves;
+
+	BackgroundFileSaver saver(m_path.wstring());
+
+	saver.Save(
+		[&]()
+		{
+			firstSaveStarted.set_value();
+			firstSaveReleasedFuture.wait();
+			return std::optional<std::string>("first");
+		},
+		[&completedSaves](const BackgroundFileSaver::SaveResult &result)
+		{
+			EXPECT_TRUE(result.succeeded);
+			completedSaves.push_back(0);
+		});
+
+	firstSaveStarted.get_future().wait();
+
+	for (int i = 1; i <= 3; i++)
+	{
+		saver.Save(
+			[i]()
+			{
+				return std::optional<std::string>("save " + std::to_string(i));
+			},
+			[&completedSaves, i](const BackgroundFileSaver::SaveResult &result)
+			{
+				EXPECT_TRUE(result.succeeded);
+				completedSaves.push_back(i);
+			});
+	}
+
+	firstSaveReleased.set_value();
+	saver.Flush();
+
+	// The saves that were replaced before they started shouldn't report anything.
+	EXPECT_THAT(completedSaves, testing::ElementsAre(0, 3));
+}
+
+TEST_F(BackgroundFileSaverTest, FailedSerialization)
+{
+	auto originalData = ToBytes("original");
+	CreateTestFile(m_path.filename().wstring(), originalData);
+
+	std::optional<BackgroundFileSaver::SaveResult> saveResult;
+
+	BackgroundFileSaver saver(m_path.wstring(),
+		[&saveResult](const BackgroundFileSaver::SaveResult &result)
+		{
+			saveResult = result;
+		});
+
+	saver.Save(
+		[]()
+		{
+			return std::optional<std::string>();
+		});
+	saver.Flush();
+
+	ASSERT_TRUE(saveResult);
+	EXPECT_FALSE(saveResult->succeeded);
+	EXPECT_EQ(ReadFileContents(m_path), originalData);
+}
+
+// If the process is terminated while a save is in progress, the data written so far only exists in
+// the temporary file. The existing file should remain intact, and a later save should replace both.
+TEST_F(BackgroundFileSaverTest, InterruptedWrite)
+{
+	auto originalData = ToBytes("<ExplorerPlusPlus>original</ExplorerPlusPlus>");
+	CreateTestFile(m_path.filename().wstring(), originalData);
+
+	{
+		AtomicFileWriter atomicWriter(m_path.wstring());
+		ASSERT_NE(atomicWriter.GetHandle(), INVALID_HANDLE_VALUE);
+
+		std::string_view partialData = "<ExplorerPlusPlus>";
+		DWORD numBytesWritten;
+		ASSERT_TRUE(WriteFile(atomicWriter.GetHandle(), partialData.data(),
+			static_cast<DWORD>(partialData.size()), &numBytesWritten, nullptr));
+
+		EXPECT_EQ(ReadFileContents(m_path), originalData);
+	}
+
+	EXPECT_EQ(ReadFileContents(m_path), originalData);
+
+	// A truncated temporary file, as would be left behind if the process were terminated.
+	auto tempPath = CreateTestFile(m_path.filename().wstring() + L".tmp", ToBytes("<Explorer"));
+	EXPECT_EQ(ReadFileContents(m_path), originalData);
+
+	auto updatedData = ToBytes("<ExplorerPlusPlus>updated</ExplorerPlusPlus>");
+
+	BackgroundFileSaver saver(m_path.wstring());
+	saver.Save(
+		[&updatedData]()
+		{
+			return std::string(updatedData.begin(), updatedData.end());
+		});
+	saver.Flush();
+
+	EXPECT_EQ(ReadFileContents(m_path), updatedData);
+	EXPECT_FALSE(std::filesystem::exists(tempPath));
+}
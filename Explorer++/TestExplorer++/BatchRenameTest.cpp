@@ -0,0 +1,365 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/BatchRename.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cwctype>
+#include <map>
+#include <mutex>
+
+using namespace testing;
+
+class BatchRenameTest : public Test
+{
+protected:
+	void AddFiles(const std::vector<std::wstring> &paths)
+	{
+		for (const auto &path : paths)
+		{
+			m_files.emplace(BuildKey(path), path);
+		}
+	}
+
+	bool PathExists(const std::wstring &path)
+	{
+		std::scoped_lock lock(m_mutex);
+		return m_files.contains(BuildKey(path));
+	}
+
+	// Behaves like MoveFile() on a case-insensitive file system.
+	bool Rename(const std::wstring &source, const std::wstring &destination)
+	{
+		std::scoped_lock lock(m_mutex);
+
+		m_numRenames++;
+
+		auto itr = m_files.find(BuildKey(source));
+
+		if (itr == m_files.end() || source == m_failingSource)
+		{
+			return false;
+		}
+
+		if (BuildKey(source) != BuildKey(destination) && m_files.contains(BuildKey(destination)))
+		{
+			return false;
+		}
+
+		m_files.erase(itr);
+		m_files.emplace(BuildKey(destination), destination);
+
+		return true;
+	}
+
+	BatchRenamePlan Plan(const std::vector<BatchRenameItem> &items)
+	{
+		return PlanBatchRename(items,
+			[this](const std::wstring &path)
+			{
+				return PathExists(path);
+			});
+	}
+
+	std::vector<size_t> Execute(const BatchRenamePlan &plan, int maxConcurrentChains = 4)
+	{
+		return ExecuteBatchRename(plan,
+			[this](const std::wstring &source, const std::wstring &destination)
+			{
+				return Rename(source, destination);
+			},
+			maxConcurrentChains);
+	}
+
+	std::vector<std::wstring> GetFiles()
+	{
+		std::vector<std::wstring> files;
+
+		for (const auto &[key, path] : m_files)
+		{
+			files.push_back(path);
+		}
+
+		std::sort(files.begin(), files.end());
+		return files;
+	}
+
+	static std::wstring BuildKey(const std::wstring &path)
+	{
+		std::wstring key = path;
+		std::transform(key.begin(), key.end(), key.begin(),
+			[](wchar_t c)
+			{
+				return static_cast<wchar_t>(std::towlower(c));
+			});
+		return key;
+	}
+
+	std::map<std::wstring, std::wstring> m_files;
+	std::wstring m_failingSource;
+	int m_numRenames = 0;
+	std::mutex m_mutex;
+};
+
+TEST_F(BatchRenameTest, Simple)
+{
+	AddFiles({ L"C:\\a", L"C:\\b" });
+
+	auto plan = Plan({ { L"C:\\a", L"C:\\c" }, { L"C:\\b", L"C:\\d" } });
+	EXPECT_TRUE(plan.conflicts.empty());
+	EXPECT_EQ(plan.GetNumSteps(), 2u);
+
+	EXPECT_EQ(Execute(plan), (std::vector<size_t>{ 0, 1 }));
+	EXPECT_EQ(GetFiles(), (std::vector<std::wstring>{ L"C:\\c", L"C:\\d" }));
+}
+
+TEST_F(BatchRenameTest, Chain)
+{
+	AddFiles({ L"C:\\1", L"C:\\2", L"C:\\3" });
+
+	// Shifting each name up by one only works if the last item is renamed first.
+	auto plan = Plan({ { L"C:\\1", L"C:\\2" }, { L"C:\\2", L"C:\\3" }, { L"C:\\3", L"C:\\4" } });
+	EXPECT_TRUE(plan.conflicts.empty());
+	ASSERT_EQ(plan.directories.size(), 1u);
+	ASSERT_EQ(plan.directories[0].size(), 1u);
+	EXPECT_FALSE(plan.directories[0][0].usesTemporaryName);
+
+	EXPECT_EQ(Execute(plan), (std::vector<size_t>{ 0, 1, 2 }));
+	EXPECT_EQ(GetFiles(), (std::vector<std::wstring>{ L"C:\\2", L"C:\\3", L"C:\\4" }));
+	EXPECT_EQ(m_numRenames, 3);
+}
+
+TEST_F(BatchRenameTest, Cycle)
+{
+	AddFiles({ L"C:\\a", L"C:\\b", L"C:\\c", L"C:\\a~1" });
+
+	auto plan = Plan({ { L"C:\\a", L"C:\\b" }, { L"C:\\b", L"C:\\c" }, { L"C:\\c", L"C:\\a" } });
+	EXPECT_TRUE(plan.conflicts.empty());
+	ASSERT_EQ(plan.directories.size(), 1u);
+	ASSERT_EQ(plan.directories[0].size(), 1u);
+	EXPECT_TRUE(plan.directories[0][0].usesTemporaryName);
+
+	// The temporary name shouldn't clash with an existing file.
+	EXPECT_EQ(plan.directories[0][0].steps[0].destination, L"C:\\a~2");
+
+	EXPECT_EQ(Execute(plan), (std::vector<size_t>{ 0, 1, 2 }));
+	EXPECT_EQ(GetFiles(), (std::vector<std::wstring>{ L"C:\\a", L"C:\\a~1", L"C:\\b", L"C:\\c" }));
+	EXPECT_EQ(m_numRenames, 4);
+}
+
+TEST_F(BatchRenameTest, CaseChange)
+{
+	AddFiles({ L"C:\\file" });
+
+	auto plan = Plan({ { L"C:\\file", L"C:\\FILE" } });
+	EXPECT_TRUE(plan.conflicts.empty());
+
+	EXPECT_EQ(Execute(plan), (std::vector<size_t>{ 0 }));
+	EXPECT_EQ(GetFiles(), (std::vector<std::wstring>{ L"C:\\FILE" }));
+}
+
+TEST_F(BatchRenameTest, Conflicts)
+{
+	AddFiles({ L"C:\\a", L"C:\\b", L"C:\\c", L"C:\\d", L"C:\\e", L"C:\\existing", L"C:\\f",
+		L"C:\\g" });
+
+	auto plan = Plan({ { L"C:\\a", L"C:\\same" }, { L"C:\\b", L"C:\\SAME" },
+		{ L"C:\\c", L"C:\\Existing" }, { L"C:\\d", L"C:\\c" }, { L"C:\\e", L"D:\\e" },
+		{ L"C:\\f", L"C:\\f" }, { L"C:\\g", L"C:\\h" }, { L"C:\\G", L"C:\\i" } });
+
+	std::vector<std::pair<size_t, BatchRenameConflictReason>> conflicts;
+
+	for (const auto &conflict : plan.conflicts)
+	{
+		conflicts.emplace_back(conflict.itemIndex, conflict.reason);
+	}
+
+	// Since c can't be renamed, d can't be renamed either. Items that keep the same name aren't
+	// treated as conflicts.
+	std::vector<std::pair<size_t, BatchRenameConflictReason>> expectedConflicts = {
+		{ 0, BatchRenameConflictReason::DuplicateDestination },
+		{ 1, BatchRenameConflictReason::DuplicateDestination },
+		{ 2, BatchRenameConflictReason::DestinationExists },
+		{ 3, BatchRenameConflictReason::DestinationExists },
+		{ 4, BatchRenameConflictReason::DifferentDirectory },
+		{ 7, BatchRenameConflictReason::DuplicateSource }
+	};
+	EXPECT_EQ(conflicts, expectedConflicts);
+
+	EXPECT_EQ(Execute(plan), (std::vector<size_t>{ 6 }));
+	EXPECT_TRUE(PathExists(L"C:\\h"));
+	EXPECT_TRUE(PathExists(L"C:\\c"));
+}
+
+TEST_F(BatchRenameTest, MultipleDirectories)
+{
+	std::vector<BatchRenameItem> items;
+
+	for (int i = 0; i < 20; i++)
+	{
+		std::wstring directory = L"C:\\dir" + std::to_wstring(i % 5) + L"\\";
+		std::wstring source = directory + std::to_wstring(i);
+		AddFiles({ source });
+		items.push_back({ source, directory + L"new" + std::to_wstring(i) });
+	}
+
+	auto plan = Plan(items);
+	EXPECT_EQ(plan.directories.size(), 5u);
+
+	auto renamedItems = Execute(plan, 3);
+	EXPECT_EQ(renamedItems.size(), 20u);
+	EXPECT_TRUE(std::is_sorted(renamedItems.begin(), renamedItems.end()));
+	EXPECT_TRUE(PathExists(L"C:\\dir3\\new13"));
+}
+
+TEST_F(BatchRenameTest, ConcurrentChainsInDirectory)
+{
+	AddFiles({ L"C:\\dir\\a", L"C:\\dir\\b" });
+
+	auto plan = Plan({ { L"C:\\dir\\a", L"C:\\dir\\c" }, { L"C:\\dir\\b", L"C:\\dir\\d" } });
+	ASSERT_EQ(plan.directories.size(), 1u);
+	ASSERT_EQ(plan.directories[0].size(), 2u);
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	int numStartedRenames = 0;
+	int numActiveRenames = 0;
+	int maxActiveRenames = 0;
+
+	// Each rename waits (for a limited time) for the other to start, so both should be in progress
+	// at the same time if the chains are executed concurrently.
+	auto renamedItems = ExecuteBatchRename(
+		plan,
+		[&](const std::wstring &source, const std::wstring &destination)
+		{
+			{
+				std::unique_lock lock(mutex);
+				numStartedRenames++;
+				numActiveRenames++;
+				maxActiveRenames = std::max<int>(maxActiveRenames, numActiveRenames);
+				condition.notify_all();
+				condition.wait_for(lock, std::chrono::seconds(5),
+					[&numStartedRenames]
+					{
+						return numStartedRenames == 2;
+					});
+			}
+
+			bool res = Rename(source, destination);
+
+			std::scoped_lock lock(mutex);
+			numActiveRenames--;
+			return res;
+		},
+		2);
+
+	EXPECT_EQ(renamedItems, (std::vector<size_t>{ 0, 1 }));
+	EXPECT_EQ(maxActiveRenames, 2);
+	EXPECT_EQ(GetFiles(), (std::vector<std::wstring>{ L"C:\\dir\\c", L"C:\\dir\\d" }));
+}
+
+// Plans the renaming of a large number of items that form a single chain. The time taken to build
+// the plan is recorded in the test output.
+TEST_F(BatchRenameTest, LargeChain)
+{
+	const int numItems = 50000;
+
+	std::vector<BatchRenameItem> items;
+	items.reserve(numItems);
+
+	for (int i = 0; i < numItems; i++)
+	{
+		AddFiles({ L"C:\\dir\\" + std::to_wstring(i) });
+		items.push_back(
+			{ L"C:\\dir\\" + std::to_wstring(i), L"C:\\dir\\" + std::to_wstring(i + 1) });
+	}
+
+	auto startTime = std::chrono::steady_clock::now();
+	auto plan = Plan(items);
+	auto endTime = std::chrono::steady_clock::now();
+	RecordProperty("PlanMicroseconds",
+		static_cast<int>(
+			std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()));
+
+	EXPECT_TRUE(plan.conflicts.empty());
+	ASSERT_EQ(plan.directories.size(), 1u);
+	ASSERT_EQ(plan.directories[0].size(), 1u);
+	EXPECT_EQ(plan.directories[0][0].steps.front().source,
+		L"C:\\dir\\" + std::to_wstring(numItems - 1));
+
+	EXPECT_EQ(Execute(plan).size(), static_cast<size_t>(numItems));
+	EXPECT_FALSE(PathExists(L"C:\\dir\\0"));
+	EXPECT_TRUE(PathExists(L"C:\\dir\\" + std::to_wstring(numItems)));
+}
+
+TEST_F(BatchRenameTest, FailureInCycle)
+{
+	AddFiles({ L"C:\\a", L"C:\\b", L"C:\\c" });
+	m_failingSource = L"C:\\b";
+
+	auto plan = Plan({ { L"C:\\a", L"C:\\b" }, { L"C:\\b", L"C:\\a" }, { L"C:\\c", L"C:\\d" } });
+
+	// The cycle should be undone, leaving the items with their original names.
+	EXPECT_EQ(Execute(plan), (std::vector<size_t>{ 2 }));
+	EXPECT_EQ(GetFiles(), (std::vector<std::wstring>{ L"C:\\a", L"C:\\b", L"C:\\d" }));
+}
+
+TEST_F(BatchRenameTest, RollBack)
+{
+	AddFiles({ L"C:\\1", L"C:\\2", L"C:\\x", L"C:\\y", L"C:\\case" });
+
+	auto plan = Plan({ { L"C:\\1", L"C:\\2" }, { L"C:\\2", L"C:\\3" }, { L"C:\\x", L"C:\\y" },
+		{ L"C:\\y", L"C:\\x" }, { L"C:\\case", L"C:\\CASE" } });
+	ASSERT_TRUE(plan.conflicts.empty());
+
+	auto journal = SerializeBatchRenameJournal(plan);
+	auto steps = ParseBatchRenameJournal(journal);
+	ASSERT_TRUE(steps);
+	ASSERT_EQ(steps->size(), plan.GetNumSteps());
+
+	auto pathExists = [this](const std::wstring &path)
+	{
+		return PathExists(path);
+	};
+	auto rename = [this](const std::wstring &source, const std::wstring &destination)
+	{
+		return Rename(source, destination);
+	};
+
+	// Simulate the process exiting part way through each chain.
+	auto originalFiles = GetFiles();
+
+	for (size_t numCompletedSteps = 0; numCompletedSteps <= steps->size(); numCompletedSteps++)
+	{
+		for (size_t i = 0; i < numCompletedSteps; i++)
+		{
+			ASSERT_TRUE(Rename((*steps)[i].source, (*steps)[i].destination));
+		}
+
+		EXPECT_TRUE(RollBackBatchRename(*steps, pathExists, rename));
+		EXPECT_EQ(GetFiles(), originalFiles);
+	}
+}
+
+TEST(BatchRenameJournalTest, Parse)
+{
+	BatchRenamePlan plan;
+	plan.directories.push_back({ { { { L"C:\\\u00E4", L"C:\\b", 0 } } } });
+
+	auto steps = ParseBatchRenameJournal(SerializeBatchRenameJournal(plan));
+	ASSERT_TRUE(steps);
+	ASSERT_EQ(steps->size(), 1u);
+	EXPECT_EQ((*steps)[0].source, L"C:\\\u00E4");
+	EXPECT_EQ((*steps)[0].destination, L"C:\\b");
+
+	EXPECT_FALSE(ParseBatchRenameJournal(""));
+	EXPECT_FALSE(ParseBatchRenameJournal("Not a journal\n"));
+
+	// A journal that's been truncated shouldn't be used.
+	EXPECT_FALSE(ParseBatchRenameJournal("Explorer++ rename journal 1\nC:\\a\tC:\\b"));
+	EXPECT_FALSE(ParseBatchRenameJournal("Explorer++ rename journal 1\nC:\\a\n"));
+}
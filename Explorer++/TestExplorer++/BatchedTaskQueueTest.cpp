@@ -0,0 +1,141 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/BatchedTaskQueue.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+using namespace testing;
+
+TEST(BatchedTaskQueueTest, Batching)
+{
+	int numNotifications = 0;
+	BatchedTaskQueue queue(
+		[&numNotifications]
+		{
+			numNotifications++;
+		});
+
+	std::vector<int> values;
+
+	for (int i = 0; i < 10; i++)
+	{
+		EXPECT_TRUE(queue.Post(
+			[&values, i]
+			{
+				values.push_back(i);
+			}));
+	}
+
+	// Only the first task should result in a notification.
+	EXPECT_EQ(numNotifications, 1);
+	EXPECT_TRUE(values.empty());
+
+	EXPECT_EQ(queue.RunPendingTasks(), 10U);
+	EXPECT_EQ(values, (std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+
+	EXPECT_EQ(queue.RunPendingTasks(), 0U);
+
+	queue.Post(
+		[]
+		{
+		});
+	EXPECT_EQ(numNotifications, 2);
+}
+
+TEST(BatchedTaskQueueTest, PostFromTask)
+{
+	BatchedTaskQueue queue(nullptr);
+	bool secondTaskRun = false;
+
+	queue.Post(
+		[&queue, &secondTaskRun]
+		{
+			queue.Post(
+				[&secondTaskRun]
+				{
+					secondTaskRun = true;
+				});
+		});
+
+	// The task posted while the first batch is running should be left for the next batch.
+	EXPECT_EQ(queue.RunPendingTasks(), 1U);
+	EXPECT_FALSE(secondTaskRun);
+
+	EXPECT_EQ(queue.RunPendingTasks(), 1U);
+	EXPECT_TRUE(secondTaskRun);
+}
+
+TEST(BatchedTaskQueueTest, Close)
+{
+	BatchedTaskQueue queue(nullptr);
+	bool taskRun = false;
+
+	queue.Post(
+		[&taskRun]
+		{
+			taskRun = true;
+		});
+	queue.Close();
+
+	EXPECT_FALSE(queue.Post(
+		[&taskRun]
+		{
+			taskRun = true;
+		}));
+	EXPECT_EQ(queue.RunPendingTasks(), 0U);
+	EXPECT_FALSE(taskRun);
+	EXPECT_FALSE(queue.WaitForTasks());
+}
+
+TEST(BatchedTaskQueueTest, PostFromOtherThreads)
+{
+	const int NUM_THREADS = 4;
+	const int NUM_TASKS_PER_THREAD = 1000;
+
+	std::atomic<int> numNotifications = 0;
+	BatchedTaskQueue queue(
+		[&numNotifications]
+		{
+			numNotifications++;
+		});
+
+	std::vector<std::thread> threads;
+	int numTasksRun = 0;
+
+	for (int i = 0; i < NUM_THREADS; i++)
+	{
+		threads.emplace_back(
+			[&queue, &numTasksRun]
+			{
+				for (int j = 0; j < NUM_TASKS_PER_THREAD; j++)
+				{
+					queue.Post(
+						[&numTasksRun]
+						{
+							numTasksRun++;
+						});
+				}
+			});
+	}
+
+	while (numTasksRun < NUM_THREADS * NUM_TASKS_PER_THREAD)
+	{
+		ASSERT_TRUE(queue.WaitForTasks());
+		queue.RunPendingTasks();
+	}
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	EXPECT_EQ(numTasksRun, NUM_THREADS * NUM_TASKS_PER_THREAD);
+
+	// Tasks are run in batches, so there should be at most one notification per task.
+	EXPECT_GE(numNotifications, 1);
+	EXPECT_LE(numNotifications, NUM_THREADS * NUM_TASKS_PER_THREAD);
+}
@@ -0,0 +1,238 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "Bookmarks/BookmarkDataExchange.h"
+#include "Bookmarks/BookmarkClipboard.h"
+#include "Bookmarks/BookmarkItem.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace testing;
+
+namespace
+{
+
+std::wstring GenerateRandomString(std::mt19937 &generator)
+{
+	std::uniform_int_distribution<size_t> lengthDistribution(0, 20);
+	std::uniform_int_distribution<int> charDistribution(1, 0xD7FF);
+
+	std::wstring str(lengthDistribution(generator), '\0');
+
+	for (auto &c : str)
+	{
+		c = static_cast<wchar_t>(charDistribution(generator));
+	}
+
+	return str;
+}
+
+std::unique_ptr<BookmarkItem> GenerateRandomItem(std::mt19937 &generator, int depth)
+{
+	std::bernoulli_distribution folderDistribution(depth < 4 ? 0.3 : 0.0);
+
+	if (!folderDistribution(generator))
+	{
+		return std::make_unique<BookmarkItem>(std::nullopt, GenerateRandomString(generator),
+			GenerateRandomString(generator));
+	}
+
+	auto folder =
+		std::make_unique<BookmarkItem>(std::nullopt, GenerateRandomString(generator), std::nullopt);
+
+	std::uniform_int_distribution<int> numChildrenDistribution(0, 5);
+	int numChildren = numChildrenDistribution(generator);
+
+	for (int i = 0; i < numChildren; i++)
+	{
+		folder->AddChild(GenerateRandomItem(generator, depth + 1));
+	}
+
+	return folder;
+}
+
+OwnedRefBookmarkItems GetOwnedRefs(const BookmarkItems &bookmarkItems)
+{
+	OwnedRefBookmarkItems ownedBookmarkItems;
+
+	for (auto &bookmarkItem : bookmarkItems)
+	{
+		ownedBookmarkItems.push_back(bookmarkItem);
+	}
+
+	return ownedBookmarkItems;
+}
+
+void CompareItems(const BookmarkItem *deserializedItem, const BookmarkItem *originalItem)
+{
+	ASSERT_EQ(deserializedItem->GetType(), originalItem->GetType());
+	EXPECT_NE(deserializedItem->GetGUID(), originalItem->GetGUID());
+	EXPECT_EQ(deserializedItem->GetOriginalGUID(), originalItem->GetGUID());
+	EXPECT_EQ(deserializedItem->GetName(), originalItem->GetName());
+	EXPECT_EQ(deserializedItem->GetLocation(), originalItem->GetLocation());
+
+	auto &deserializedChildren = deserializedItem->GetChildren();
+	auto &originalChildren = originalItem->GetChildren();
+	ASSERT_EQ(deserializedChildren.size(), originalChildren.size());
+
+	for (size_t i = 0; i < deserializedChildren.size(); i++)
+	{
+		EXPECT_EQ(deserializedChildren[i]->GetParent(), deserializedItem);
+		CompareItems(deserializedChildren[i].get(), originalChildren[i].get());
+	}
+}
+
+void CompareItemLists(const BookmarkItems &deserializedItems, const BookmarkItems &originalItems)
+{
+	ASSERT_EQ(deserializedItems.size(), originalItems.size());
+
+	for (size_t i = 0; i < deserializedItems.size(); i++)
+	{
+		EXPECT_EQ(deserializedItems[i]->GetParent(), nullptr);
+		CompareItems(deserializedItems[i].get(), originalItems[i].get());
+	}
+}
+
+}
+
+TEST(BookmarkDataExchangeTest, RandomRoundTrip)
+{
+	std::mt19937 generator(1);
+
+	for (int i = 0; i < 100; i++)
+	{
+		std::uniform_int_distribution<int> numItemsDistribution(0, 10);
+		int numItems = numItemsDistribution(generator);
+
+		BookmarkItems bookmarkItems;
+
+		for (int j = 0; j < numItems; j++)
+		{
+			bookmarkItems.push_back(GenerateRandomItem(generator, 0));
+		}
+
+		auto data = BookmarkDataExchange::SerializeBookmarkItems(GetOwnedRefs(bookmarkItems));
+		auto deserializedItems = BookmarkDataExchange::DeserializeBookmarkItems(data);
+		CompareItemLists(deserializedItems, bookmarkItems);
+	}
+}
+
+TEST(BookmarkDataExchangeTest, RoundTripThroughGlobal)
+{
+	std::mt19937 generator(2);
+
+	BookmarkItems bookmarkItems;
+
+	for (int i = 0; i < 10; i++)
+	{
+		bookmarkItems.push_back(GenerateRandomItem(generator, 0));
+	}
+
+	auto global = BookmarkDataExchange::SerializeBookmarkItemsToGlobal(GetOwnedRefs(bookmarkItems));
+	ASSERT_TRUE(global);
+
+	auto deserializedItems = BookmarkDataExchange::DeserializeBookmarkItemsFromGlobal(global.get());
+	CompareItemLists(deserializedItems, bookmarkItems);
+}
+
+TEST(BookmarkDataExchangeTest, InvalidData)
+{
+	EXPECT_TRUE(BookmarkDataExchange::DeserializeBookmarkItems({}).empty());
+	EXPECT_TRUE(BookmarkDataExchange::DeserializeBookmarkItems("invalid data").empty());
+
+	std::mt19937 generator(3);
+
+	BookmarkItems bookmarkItems;
+
+	for (int i = 0; i < 5; i++)
+	{
+		bookmarkItems.push_back(GenerateRandomItem(generator, 0));
+	}
+
+	auto data = BookmarkDataExchange::SerializeBookmarkItems(GetOwnedRefs(bookmarkItems));
+	ASSERT_FALSE(data.empty());
+
+	// Any truncated version of the data should be rejected.
+	for (size_t size = 0; size < data.size(); size++)
+	{
+		EXPECT_TRUE(BookmarkDataExchange::DeserializeBookmarkItems(
+			std::string_view(data.data(), size))
+						.empty());
+	}
+
+	// Randomly corrupting the data shouldn't result in a crash. The data may or may not be
+	// rejected, depending on which bytes are changed, but any items that are returned should
+	// form a valid hierarchy.
+	std::uniform_int_distribution<size_t> positionDistribution(0, data.size() - 1);
+	std::uniform_int_distribution<int> byteDistribution(0, 255);
+
+	for (int i = 0; i < 1000; i++)
+	{
+		auto corruptedData = data;
+		corruptedData[positionDistribution(generator)] =
+			static_cast<char>(byteDistribution(generator));
+
+		auto deserializedItems = BookmarkDataExchange::DeserializeBookmarkItems(corruptedData);
+
+		for (auto &deserializedItem : deserializedItems)
+		{
+			deserializedItem->VisitRecursively(
+				[](BookmarkItem *currentItem)
+				{
+					if (currentItem->IsBookmark())
+					{
+						EXPECT_TRUE(currentItem->GetChildren().empty());
+					}
+				});
+		}
+	}
+}
+
+TEST(BookmarkDataExchangeTest, FolderContainingItself)
+{
+	auto folder = std::make_unique<BookmarkItem>(std::nullopt, L"Folder", std::nullopt);
+	folder->AddChild(std::make_unique<BookmarkItem>(std::nullopt, L"Child", std::nullopt));
+
+	BookmarkItems bookmarkItems;
+	bookmarkItems.push_back(std::move(folder));
+
+	auto data = BookmarkDataExchange::SerializeBookmarkItems(GetOwnedRefs(bookmarkItems));
+	ASSERT_FALSE(data.empty());
+	ASSERT_FALSE(BookmarkDataExchange::DeserializeBookmarkItems(data).empty());
+
+	// The payload consists of a 24 byte header, followed by a 36 byte record for each item. Each
+	// record starts with the item's type, the index of its first child and its number of
+	// children. Here, the top-level folder is changed to be empty and the nested folder is changed
+	// to list itself as its only child. The children are still contiguous, so the only thing
+	// wrong with the data is that the nested folder doesn't precede its child.
+	auto setField = [&data](size_t itemIndex, size_t fieldIndex, uint32_t value)
+	{
+		memcpy(data.data() + 24 + (itemIndex * 36) + (fieldIndex * sizeof(uint32_t)), &value,
+			sizeof(value));
+	};
+
+	setField(0, 2, 0);
+	setField(1, 1, 1);
+	setField(1, 2, 1);
+
+	EXPECT_TRUE(BookmarkDataExchange::DeserializeBookmarkItems(data).empty());
+}
+
+TEST(BookmarkDataExchangeTest, ClipboardManyBookmarks)
+{
+	BookmarkItems bookmarkItems;
+
+	for (int i = 0; i < 10000; i++)
+	{
+		bookmarkItems.push_back(std::make_unique<BookmarkItem>(std::nullopt,
+			L"Bookmark " + std::to_wstring(i), L"C:\\Folder " + std::to_wstring(i)));
+	}
+
+	BookmarkClipboard bookmarkClipboard;
+	ASSERT_TRUE(bookmarkClipboard.WriteBookmarks(GetOwnedRefs(bookmarkItems)));
+
+	auto clipboardItems = bookmarkClipboard.ReadBookmarks();
+	CompareItemLists(clipboardItems, bookmarkItems);
+}
@@ -0,0 +1,431 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "Bookmarks/BookmarkJournal.h"
+#include "BookmarkStorageHelper.h"
+#include "Bookmarks/BookmarkTree.h"
+#include "Bookmarks/BookmarkXmlStorage.h"
+#include "TempDirectoryHelper.h"
+#include "XmlStorageHelper.h"
+#include <gtest/gtest.h>
+#include <objbase.h>
+#include <chrono>
+
+using namespace testing;
+
+class BookmarkJournalTest : public TempDirectoryTest
+{
+protected:
+	// The full set of bookmarks, saved in the same way they are when the settings are saved.
+	struct Snapshot
+	{
+		std::string xmlData;
+		std::optional<BookmarkJournalPosition> journalPosition;
+	};
+
+	void SetUp() override
+	{
+		TempDirectoryTest::SetUp();
+
+		CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+
+		m_journalPath = (m_tempDirectory / L"bookmarks.journal").wstring();
+	}
+
+	void TearDown() override
+	{
+		CoUninitialize();
+
+		TempDirectoryTest::TearDown();
+	}
+
+	std::unique_ptr<BookmarkJournal> LoadBookmarks(BookmarkTree *bookmarkTree,
+		const std::optional<Snapshot> &snapshot = std::nullopt,
+		uint64_t compactionThreshold = BookmarkJournal::DEFAULT_COMPACTION_THRESHOLD)
+	{
+		std::optional<BookmarkJournalPosition> journalPosition;
+
+		if (snapshot)
+		{
+			journalPosition = BookmarkXmlStorage::Load(snapshot->xmlData, bookmarkTree);
+		}
+
+		auto journal = std::make_unique<BookmarkJournal>(bookmarkTree, m_journalPath,
+			[this] { m_numCompactionRequests++; }, compactionThreshold);
+		EXPECT_TRUE(journal->Load(journalPosition));
+
+		return journal;
+	}
+
+	// If trim is false, this simulates the process being interrupted after the settings were
+	// written, but before the journal was trimmed.
+	static Snapshot SaveSnapshot(BookmarkTree *bookmarkTree, BookmarkJournal *journal,
+		bool trim = true)
+	{
+		auto xmlDocumentData = CreateXmlDocument();
+		EXPECT_TRUE(xmlDocumentData);
+
+		Snapshot snapshot;
+		snapshot.journalPosition = journal->GetCurrentPosition();
+		EXPECT_TRUE(snapshot.journalPosition);
+
+		BookmarkXmlStorage::Save(xmlDocumentData->xmlDocument.get(), xmlDocumentData->root.get(),
+			bookmarkTree, 1, snapshot.journalPosition);
+		snapshot.xmlData = SerializeXmlDocument(xmlDocumentData->xmlDocument.get());
+
+		if (trim)
+		{
+			journal->OnSnapshotSaved(*snapshot.journalPosition);
+		}
+
+		return snapshot;
+	}
+
+	// Makes a set of changes that covers each of the record types.
+	static void MakeChanges(BookmarkTree *bookmarkTree)
+	{
+		auto *menuFolder = bookmarkTree->GetBookmarksMenuFolder();
+		auto *toolbarFolder = bookmarkTree->GetBookmarksToolbarFolder();
+
+		auto *bookmark = toolbarFolder->GetChildren()[0].get();
+		bookmark->SetName(L"Updated name");
+		bookmark->SetLocation(L"E:\\");
+
+		FILETIME dateCreated = { 0x11111111, 0x01D70000 };
+		bookmark->SetDateCreated(dateCreated);
+
+		// Moves within the same folder, in both directions.
+		bookmarkTree->MoveBookmarkItem(menuFolder->GetChildren()[0].get(), menuFolder, 3);
+		bookmarkTree->MoveBookmarkItem(menuFolder->GetChildren()[1].get(), menuFolder, 0);
+
+		// Moves between folders.
+		bookmarkTree->MoveBookmarkItem(toolbarFolder->GetChildren()[1].get(),
+			bookmarkTree->GetOtherBookmarksFolder(), 0);
+
+		// Removes a folder that contains other items.
+		bookmarkTree->RemoveBookmarkItem(menuFolder->GetChildren()[2].get());
+
+		// Adds a folder that already contains items.
+		auto folder = std::make_unique<BookmarkItem>(std::nullopt, L"New folder", std::nullopt);
+		folder->AddChild(std::make_unique<BookmarkItem>(std::nullopt, L"Nested", L"F:\\"));
+		folder->AddChild(std::make_unique<BookmarkItem>(std::nullopt, L"Nested folder",
+			std::nullopt));
+		bookmarkTree->AddBookmarkItem(toolbarFolder, std::move(folder), 0);
+	}
+
+	void ExpectLoadedTreeMatches(const BookmarkTree *referenceBookmarkTree,
+		const std::optional<Snapshot> &snapshot = std::nullopt)
+	{
+		BookmarkTree loadedBookmarkTree;
+		auto journal = LoadBookmarks(&loadedBookmarkTree, snapshot);
+
+		CompareBookmarkTrees(&loadedBookmarkTree, referenceBookmarkTree, true);
+	}
+
+	static void ExpectSameDates(const BookmarkItem *firstItem, const BookmarkItem *secondItem)
+	{
+		FILETIME firstDateCreated = firstItem->GetDateCreated();
+		FILETIME secondDateCreated = secondItem->GetDateCreated();
+		EXPECT_EQ(CompareFileTime(&firstDateCreated, &secondDateCreated), 0);
+
+		FILETIME firstDateModified = firstItem->GetDateModified();
+		FILETIME secondDateModified = secondItem->GetDateModified();
+		EXPECT_EQ(CompareFileTime(&firstDateModified, &secondDateModified), 0);
+	}
+
+	std::wstring m_journalPath;
+	int m_numCompactionRequests = 0;
+};
+
+TEST_F(BookmarkJournalTest, ReplayChanges)
+{
+	BookmarkTree referenceBookmarkTree;
+
+	{
+		auto journal = LoadBookmarks(&referenceBookmarkTree);
+
+		BuildV2LoadSaveReferenceTree(&referenceBookmarkTree);
+		MakeChanges(&referenceBookmarkTree);
+
+		EXPECT_GT(journal->GetJournalSize(), 0u);
+	}
+
+	// None of the changes were saved along with the settings, so they should all be restored from
+	// the journal.
+	BookmarkTree loadedBookmarkTree;
+	auto journal = LoadBookmarks(&loadedBookmarkTree);
+
+	CompareBookmarkTrees(&loadedBookmarkTree, &referenceBookmarkTree, true);
+
+	// The dates should also be restored exactly, including those of folders whose contents
+	// changed. The permanent folders are created along with the tree, so only their
+	// modification dates are recorded.
+	for (auto &child : referenceBookmarkTree.GetRoot()->GetChildren())
+	{
+		auto *loadedFolder = loadedBookmarkTree.GetBookmarkItemById(child->GetGUID());
+		ASSERT_NE(loadedFolder, nullptr);
+
+		FILETIME loadedDateModified = loadedFolder->GetDateModified();
+		FILETIME referenceDateModified = child->GetDateModified();
+		EXPECT_EQ(CompareFileTime(&loadedDateModified, &referenceDateModified), 0);
+
+		for (auto &grandchild : child->GetChildren())
+		{
+			grandchild->VisitRecursively(
+				[&loadedBookmarkTree](BookmarkItem *currentItem)
+				{
+					auto *loadedItem =
+						loadedBookmarkTree.GetBookmarkItemById(currentItem->GetGUID());
+					ASSERT_NE(loadedItem, nullptr);
+					ExpectSameDates(loadedItem, currentItem);
+				});
+		}
+	}
+}
+
+TEST_F(BookmarkJournalTest, ChangesAfterReplay)
+{
+	BookmarkTree referenceBookmarkTree;
+
+	{
+		auto journal = LoadBookmarks(&referenceBookmarkTree);
+		BuildV2LoadSaveReferenceTree(&referenceBookmarkTree);
+	}
+
+	{
+		BookmarkTree bookmarkTree;
+		auto journal = LoadBookmarks(&bookmarkTree);
+
+		// Changes made after the journal has been replayed should be appended to it.
+		bookmarkTree.GetOtherBookmarksFolder()->GetChildren()[0]->SetName(L"Renamed");
+		referenceBookmarkTree.GetOtherBookmarksFolder()->GetChildren()[0]->SetName(L"Renamed");
+	}
+
+	ExpectLoadedTreeMatches(&referenceBookmarkTree);
+}
+
+TEST_F(BookmarkJournalTest, ReplayOnTopOfSnapshot)
+{
+	BookmarkTree referenceBookmarkTree;
+	Snapshot snapshot;
+
+	{
+		auto journal = LoadBookmarks(&referenceBookmarkTree);
+		BuildV2LoadSaveReferenceTree(&referenceBookmarkTree);
+
+		auto journalSize = journal->GetJournalSize();
+		snapshot = SaveSnapshot(&referenceBookmarkTree, journal.get());
+
+		// The records are reflected in the saved settings, so they should have been dropped.
+		EXPECT_LT(journal->GetJournalSize(), journalSize);
+
+		MakeChanges(&referenceBookmarkTree);
+	}
+
+	ExpectLoadedTreeMatches(&referenceBookmarkTree, snapshot);
+}
+
+TEST_F(BookmarkJournalTest, RecordsCoveredBySnapshotSkipped)
+{
+	BookmarkTree referenceBookmarkTree;
+	Snapshot snapshot;
+
+	{
+		auto journal = LoadBookmarks(&referenceBookmarkTree);
+		BuildV2LoadSaveReferenceTree(&referenceBookmarkTree);
+		MakeChanges(&referenceBookmarkTree);
+
+		// The records in the journal are already reflected in the settings, so they shouldn't be
+		// applied again.
+		snapshot = SaveSnapshot(&referenceBookmarkTree, journal.get(), false);
+	}
+
+	ExpectLoadedTreeMatches(&referenceBookmarkTree, snapshot);
+
+	// The journal should have been trimmed once the settings were saved again.
+	BookmarkTree bookmarkTree;
+	auto journal = LoadBookmarks(&bookmarkTree, snapshot);
+	auto journalSize = journal->GetJournalSize();
+	SaveSnapshot(&bookmarkTree, journal.get());
+	EXPECT_LT(journal->GetJournalSize(), journalSize);
+}
+
+TEST_F(BookmarkJournalTest, SnapshotFromElsewhereIgnored)
+{
+	BookmarkTree otherBookmarkTree;
+	Snapshot otherSnapshot;
+
+	{
+		// This represents a config file from another computer, which will have its own journal.
+		BookmarkJournal otherJournal(&otherBookmarkTree,
+			(m_tempDirectory / L"other.journal").wstring(), [] {});
+		ASSERT_TRUE(otherJournal.Load(std::nullopt));
+
+		BuildV2LoadSaveReferenceTree(&otherBookmarkTree);
+		otherSnapshot = SaveSnapshot(&otherBookmarkTree, &otherJournal);
+	}
+
+	{
+		BookmarkTree bookmarkTree;
+		auto journal = LoadBookmarks(&bookmarkTree);
+		BuildV2LoadSaveReferenceTree(&bookmarkTree);
+		MakeChanges(&bookmarkTree);
+	}
+
+	{
+		// The existing journal was recorded against different settings, so it shouldn't be
+		// applied to these.
+		BookmarkTree bookmarkTree;
+		auto journal = LoadBookmarks(&bookmarkTree, otherSnapshot);
+		CompareBookmarkTrees(&bookmarkTree, &otherBookmarkTree, true);
+
+		// Changes made from here on are recorded in a new journal, which does apply to these
+		// settings.
+		bookmarkTree.GetOtherBookmarksFolder()->GetChildren()[0]->SetName(L"Renamed");
+		otherBookmarkTree.GetOtherBookmarksFolder()->GetChildren()[0]->SetName(L"Renamed");
+	}
+
+	ExpectLoadedTreeMatches(&otherBookmarkTree, otherSnapshot);
+}
+
+TEST_F(BookmarkJournalTest, OlderSnapshotIgnoresJournal)
+{
+	Snapshot olderSnapshot;
+
+	{
+		BookmarkTree bookmarkTree;
+		auto journal = LoadBookmarks(&bookmarkTree);
+		BuildV2LoadSaveReferenceTree(&bookmarkTree);
+		olderSnapshot = SaveSnapshot(&bookmarkTree, journal.get());
+
+		// Once newer settings have been saved, the journal no longer contains the changes made
+		// since the older settings were saved, so it can't be applied to them (e.g. if the config
+		// file is restored from a backup).
+		MakeChanges(&bookmarkTree);
+		SaveSnapshot(&bookmarkTree, journal.get());
+
+		bookmarkTree.GetOtherBookmarksFolder()->GetChildren()[0]->SetName(L"Renamed");
+	}
+
+	BookmarkTree expectedBookmarkTree;
+	BuildV2LoadSaveReferenceTree(&expectedBookmarkTree);
+
+	ExpectLoadedTreeMatches(&expectedBookmarkTree, olderSnapshot);
+}
+
+TEST_F(BookmarkJournalTest, PartialRecordDiscarded)
+{
+	BookmarkTree referenceBookmarkTree;
+	uint64_t validJournalSize;
+
+	{
+		auto journal = LoadBookmarks(&referenceBookmarkTree);
+
+		BuildV2LoadSaveReferenceTree(&referenceBookmarkTree);
+		validJournalSize = journal->GetJournalSize();
+
+		referenceBookmarkTree.GetOtherBookmarksFolder()->GetChildren()[0]->SetName(L"Lost");
+	}
+
+	// Simulates the last record only being partially written.
+	auto journalContents = ReadFileContents(m_journalPath);
+	ASSERT_GT(journalContents.size(), validJournalSize + 4);
+	journalContents.resize(journalContents.size() - 4);
+	CreateTestFile(std::filesystem::path(m_journalPath).filename(), journalContents);
+
+	BookmarkTree expectedBookmarkTree;
+	BuildV2LoadSaveReferenceTree(&expectedBookmarkTree);
+
+	{
+		BookmarkTree bookmarkTree;
+		auto journal = LoadBookmarks(&bookmarkTree);
+
+		CompareBookmarkTrees(&bookmarkTree, &expectedBookmarkTree, true);
+
+		// The partial record should have been removed, so that anything written from here is
+		// replayed.
+		EXPECT_EQ(journal->GetJournalSize(), validJournalSize);
+
+		bookmarkTree.GetBookmarksMenuFolder()->GetChildren()[0]->SetName(L"Kept");
+		expectedBookmarkTree.GetBookmarksMenuFolder()->GetChildren()[0]->SetName(L"Kept");
+	}
+
+	ExpectLoadedTreeMatches(&expectedBookmarkTree);
+}
+
+TEST_F(BookmarkJournalTest, CompactionRequested)
+{
+	BookmarkTree bookmarkTree;
+
+	// With a threshold this small, every change takes the journal past the threshold.
+	auto journal = LoadBookmarks(&bookmarkTree, std::nullopt, 1);
+	BuildV2LoadSaveReferenceTree(&bookmarkTree);
+
+	// Only a single request should be made until the settings have been saved.
+	EXPECT_EQ(m_numCompactionRequests, 1);
+
+	SaveSnapshot(&bookmarkTree, journal.get());
+	EXPECT_EQ(m_numCompactionRequests, 1);
+
+	bookmarkTree.GetOtherBookmarksFolder()->GetChildren()[0]->SetName(L"Renamed");
+	EXPECT_EQ(m_numCompactionRequests, 2);
+}
+
+// Edits a single bookmark at a time, within a set of 100,000 bookmarks that have been saved along
+// with the settings. The average time taken for each edit (including the write to the journal) is
+// recorded in the test output.
+TEST_F(BookmarkJournalTest, EditLatencyWithManyBookmarks)
+{
+	const size_t NUM_BOOKMARKS = 100000;
+	const size_t NUM_EDITS = 1000;
+
+	BookmarkTree referenceBookmarkTree;
+	auto *otherBookmarksFolder = referenceBookmarkTree.GetOtherBookmarksFolder();
+
+	for (size_t i = 0; i < NUM_BOOKMARKS; i++)
+	{
+		auto bookmark = std::make_unique<BookmarkItem>(std::nullopt,
+			L"Bookmark " + std::to_wstring(i), L"C:\\Folder" + std::to_wstring(i));
+		referenceBookmarkTree.AddBookmarkItem(otherBookmarksFolder, std::move(bookmark), i);
+	}
+
+	Snapshot snapshot;
+
+	{
+		auto journal = LoadBookmarks(&referenceBookmarkTree);
+		snapshot = SaveSnapshot(&referenceBookmarkTree, journal.get());
+	}
+
+	{
+		BookmarkTree bookmarkTree;
+		auto journal = LoadBookmarks(&bookmarkTree, snapshot);
+		const auto &children = bookmarkTree.GetOtherBookmarksFolder()->GetChildren();
+		ASSERT_EQ(children.size(), NUM_BOOKMARKS);
+
+		auto emptyJournalSize = journal->GetJournalSize();
+		auto startTime = std::chrono::steady_clock::now();
+
+		for (size_t i = 0; i < NUM_EDITS; i++)
+		{
+			children[i * (NUM_BOOKMARKS / NUM_EDITS)]->SetName(L"Edited " + std::to_wstring(i));
+		}
+
+		auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - startTime);
+		RecordProperty("EditMicroseconds", static_cast<int>(duration.count() / NUM_EDITS));
+
+		// The size of each record doesn't depend on the number of bookmarks.
+		EXPECT_LT((journal->GetJournalSize() - emptyJournalSize) / NUM_EDITS, 256u);
+
+		for (size_t i = 0; i < NUM_EDITS; i++)
+		{
+			referenceBookmarkTree.GetOtherBookmarksFolder()
+				->GetChildren()[i * (NUM_BOOKMARKS / NUM_EDITS)]
+				->SetName(L"Edited " + std::to_wstring(i));
+		}
+	}
+
+	ExpectLoadedTreeMatches(&referenceBookmarkTree, snapshot);
+}
@@ -0,0 +1,232 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "Bookmarks/BookmarkSearchIndex.h"
+#include "Bookmarks/BookmarkTree.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <chrono>
+
+using namespace testing;
+
+class BookmarkSearchIndexTest : public Test
+{
+protected:
+	BookmarkItem *AddBookmark(BookmarkItem *parent, const std::wstring &name,
+		const std::wstring &location)
+	{
+		auto bookmark = std::make_unique<BookmarkItem>(std::nullopt, name, location);
+		return m_bookmarkTree.AddBookmarkItem(parent, std::move(bookmark),
+			parent->GetChildren().size());
+	}
+
+	BookmarkItem *AddFolder(BookmarkItem *parent, const std::wstring &name)
+	{
+		auto folder = std::make_unique<BookmarkItem>(std::nullopt, name, std::nullopt);
+		return m_bookmarkTree.AddBookmarkItem(parent, std::move(folder),
+			parent->GetChildren().size());
+	}
+
+	static void SetDateModified(BookmarkItem *bookmarkItem, ULONGLONG value)
+	{
+		ULARGE_INTEGER time;
+		time.QuadPart = value;
+
+		FILETIME dateModified;
+		dateModified.dwLowDateTime = time.LowPart;
+		dateModified.dwHighDateTime = time.HighPart;
+		bookmarkItem->SetDateModified(dateModified);
+	}
+
+	BookmarkTree m_bookmarkTree;
+};
+
+TEST(BookmarkSearchIndexTokenizeTest, Tokenize)
+{
+	EXPECT_THAT(BookmarkSearchIndex::Tokenize(L"My Documents (2021)"),
+		ElementsAre(L"my", L"documents", L"2021"));
+	EXPECT_THAT(BookmarkSearchIndex::Tokenize(L"C:\\Users\\Test"),
+		ElementsAre(L"c", L"users", L"test"));
+	EXPECT_THAT(BookmarkSearchIndex::Tokenize(L"  PROJECT-files  "),
+		ElementsAre(L"project", L"files"));
+	EXPECT_THAT(BookmarkSearchIndex::Tokenize(L""), IsEmpty());
+	EXPECT_THAT(BookmarkSearchIndex::Tokenize(L" \\ - "), IsEmpty());
+}
+
+TEST_F(BookmarkSearchIndexTest, ExistingItems)
+{
+	auto folder = AddFolder(m_bookmarkTree.GetBookmarksToolbarFolder(), L"Projects");
+	auto bookmark = AddBookmark(folder, L"Explorer++", L"C:\\Projects\\explorerplusplus");
+
+	// Items that are already in the tree should be indexed when the index is created.
+	BookmarkSearchIndex searchIndex(&m_bookmarkTree);
+
+	EXPECT_THAT(searchIndex.Search(L"explorer", 10), ElementsAre(bookmark));
+	EXPECT_THAT(searchIndex.Search(L"proj", 10), UnorderedElementsAre(folder, bookmark));
+}
+
+TEST_F(BookmarkSearchIndexTest, PrefixAndMultipleTerms)
+{
+	BookmarkSearchIndex searchIndex(&m_bookmarkTree);
+
+	auto bookmark1 =
+		AddBookmark(m_bookmarkTree.GetBookmarksMenuFolder(), L"Holiday photos", L"D:\\Pictures");
+	auto bookmark2 = AddBookmark(m_bookmarkTree.GetBookmarksMenuFolder(), L"Work photos",
+		L"\\\\server\\share\\photos");
+	AddBookmark(m_bookmarkTree.GetOtherBookmarksFolder(), L"Music", L"D:\\Music");
+
+	EXPECT_THAT(searchIndex.Search(L"pho", 10), UnorderedElementsAre(bookmark1, bookmark2));
+	EXPECT_THAT(searchIndex.Search(L"PHOTOS", 10), UnorderedElementsAre(bookmark1, bookmark2));
+
+	// Every term has to match.
+	EXPECT_THAT(searchIndex.Search(L"photos pict", 10), ElementsAre(bookmark1));
+	EXPECT_THAT(searchIndex.Search(L"ser pho", 10), ElementsAre(bookmark2));
+	EXPECT_THAT(searchIndex.Search(L"photos music", 10), IsEmpty());
+
+	EXPECT_THAT(searchIndex.Search(L"xyz", 10), IsEmpty());
+	EXPECT_THAT(searchIndex.Search(L"", 10), IsEmpty());
+	EXPECT_THAT(searchIndex.Search(L"photos", 0), IsEmpty());
+}
+
+TEST_F(BookmarkSearchIndexTest, Ranking)
+{
+	BookmarkSearchIndex searchIndex(&m_bookmarkTree);
+
+	auto locationMatch =
+		AddBookmark(m_bookmarkTree.GetBookmarksMenuFolder(), L"System", L"C:\\Windows");
+	auto namePrefixMatch =
+		AddBookmark(m_bookmarkTree.GetBookmarksMenuFolder(), L"WindowsApps", L"C:\\Apps");
+	auto nameExactMatch =
+		AddBookmark(m_bookmarkTree.GetBookmarksMenuFolder(), L"Windows", L"C:\\Other");
+
+	EXPECT_THAT(searchIndex.Search(L"windows", 10),
+		ElementsAre(nameExactMatch, namePrefixMatch, locationMatch));
+
+	// Only the best results should be returned.
+	EXPECT_THAT(searchIndex.Search(L"windows", 2), ElementsAre(nameExactMatch, namePrefixMatch));
+}
+
+TEST_F(BookmarkSearchIndexTest, RankingByRecency)
+{
+	BookmarkSearchIndex searchIndex(&m_bookmarkTree);
+
+	auto bookmark1 = AddBookmark(m_bookmarkTree.GetBookmarksMenuFolder(), L"Report 1", L"C:\\");
+	auto bookmark2 = AddBookmark(m_bookmarkTree.GetBookmarksMenuFolder(), L"Report 2", L"C:\\");
+	auto bookmark3 = AddBookmark(m_bookmarkTree.GetBookmarksMenuFolder(), L"Report 3", L"C:\\");
+
+	SetDateModified(bookmark1, 300);
+	SetDateModified(bookmark2, 100);
+	SetDateModified(bookmark3, 200);
+
+	// Since all the items match equally well, the most recently modified should come first.
+	EXPECT_THAT(searchIndex.Search(L"report", 10), ElementsAre(bookmark1, bookmark3, bookmark2));
+}
+
+TEST_F(BookmarkSearchIndexTest, IncrementalUpdates)
+{
+	BookmarkSearchIndex searchIndex(&m_bookmarkTree);
+
+	auto folder = AddFolder(m_bookmarkTree.GetBookmarksToolbarFolder(), L"Archive");
+	auto bookmark = AddBookmark(folder, L"Invoices", L"E:\\Finance\\Invoices");
+
+	EXPECT_THAT(searchIndex.Search(L"invoices", 10), ElementsAre(bookmark));
+
+	bookmark->SetName(L"Receipts");
+	EXPECT_THAT(searchIndex.Search(L"receipts", 10), ElementsAre(bookmark));
+
+	// The location still contains the original word.
+	EXPECT_THAT(searchIndex.Search(L"invoices", 10), ElementsAre(bookmark));
+
+	bookmark->SetLocation(L"E:\\Finance\\Receipts");
+	EXPECT_THAT(searchIndex.Search(L"invoices", 10), IsEmpty());
+	EXPECT_THAT(searchIndex.Search(L"finance", 10), ElementsAre(bookmark));
+
+	// Moving an item shouldn't affect whether it's found.
+	m_bookmarkTree.MoveBookmarkItem(bookmark, m_bookmarkTree.GetOtherBookmarksFolder(), 0);
+	EXPECT_THAT(searchIndex.Search(L"receipts", 10), ElementsAre(bookmark));
+
+	m_bookmarkTree.MoveBookmarkItem(bookmark, folder, 0);
+
+	// Removing a folder should remove all the items within it.
+	m_bookmarkTree.RemoveBookmarkItem(folder);
+	EXPECT_THAT(searchIndex.Search(L"archive", 10), IsEmpty());
+	EXPECT_THAT(searchIndex.Search(L"receipts", 10), IsEmpty());
+}
+
+TEST_F(BookmarkSearchIndexTest, NestedItemsAdded)
+{
+	BookmarkSearchIndex searchIndex(&m_bookmarkTree);
+
+	auto folder = std::make_unique<BookmarkItem>(std::nullopt, L"Games", std::nullopt);
+	auto bookmark = std::make_unique<BookmarkItem>(std::nullopt, L"Saves", L"C:\\Games\\Saves");
+	auto rawBookmark = bookmark.get();
+	folder->AddChild(std::move(bookmark));
+
+	auto rawFolder = m_bookmarkTree.AddBookmarkItem(m_bookmarkTree.GetBookmarksMenuFolder(),
+		std::move(folder), 0);
+
+	EXPECT_THAT(searchIndex.Search(L"saves", 10), ElementsAre(rawBookmark));
+	EXPECT_THAT(searchIndex.Search(L"games", 10), ElementsAre(rawFolder, rawBookmark));
+}
+
+// Indexes a tree of 100,000 bookmarks, then runs each of the queries that would be made as a
+// search was typed in. The time taken to build the index and the average time taken by each
+// query are recorded in the test output.
+TEST_F(BookmarkSearchIndexTest, TypeAheadQueries)
+{
+	const int NUM_FOLDERS = 100;
+	const int NUM_BOOKMARKS_PER_FOLDER = 1000;
+	const int EXPECTED_BOOKMARK_ID = 4242;
+
+	BookmarkItem *expectedBookmark = nullptr;
+
+	for (int i = 0; i < NUM_FOLDERS; i++)
+	{
+		auto folder =
+			AddFolder(m_bookmarkTree.GetBookmarksMenuFolder(), L"Folder " + std::to_wstring(i));
+
+		for (int j = 0; j < NUM_BOOKMARKS_PER_FOLDER; j++)
+		{
+			int id = i * NUM_BOOKMARKS_PER_FOLDER + j;
+			auto bookmark = AddBookmark(folder, L"Bookmark " + std::to_wstring(id),
+				L"C:\\Data\\Folder" + std::to_wstring(i) + L"\\Item" + std::to_wstring(id));
+
+			if (id == EXPECTED_BOOKMARK_ID)
+			{
+				expectedBookmark = bookmark;
+			}
+		}
+	}
+
+	auto startTime = std::chrono::steady_clock::now();
+	BookmarkSearchIndex searchIndex(&m_bookmarkTree);
+	auto endTime = std::chrono::steady_clock::now();
+
+	RecordProperty("IndexMilliseconds",
+		static_cast<int>(
+			std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count()));
+
+	std::wstring query = L"bookmark " + std::to_wstring(EXPECTED_BOOKMARK_ID);
+	std::vector<BookmarkItem *> results;
+
+	startTime = std::chrono::steady_clock::now();
+
+	for (size_t i = 1; i <= query.size(); i++)
+	{
+		results = searchIndex.Search(query.substr(0, i), 10);
+	}
+
+	endTime = std::chrono::steady_clock::now();
+
+	RecordProperty("QueryMicroseconds",
+		static_cast<int>(
+			std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()
+			/ query.size()));
+
+	// The name of the expected bookmark matches the full query exactly, while several other
+	// names only start with it.
+	ASSERT_EQ(results.size(), 10U);
+	EXPECT_EQ(results[0], expectedBookmark);
+}
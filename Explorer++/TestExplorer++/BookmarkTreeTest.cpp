@@ -7,6 +7,7 @@
 #include "BookmarkTreeHelper.h"
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <chrono>
 
 using namespace testing;
 
@@ -139,6 +140,187 @@ TEST(BookmarkTreeTest, RemoveChildren)
 	EXPECT_EQ(bookmarkTree.GetOtherBookmarksFolder()->GetChildren().size(), 0);
 }
 
+TEST(BookmarkTreeTest, GetBookmarkItemById)
+{
+	BookmarkTree bookmarkTree;
+
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(bookmarkTree.GetRoot()->GetGUID()),
+		bookmarkTree.GetRoot());
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(bookmarkTree.GetBookmarksToolbarFolder()->GetGUID()),
+		bookmarkTree.GetBookmarksToolbarFolder());
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(bookmarkTree.GetBookmarksMenuFolder()->GetGUID()),
+		bookmarkTree.GetBookmarksMenuFolder());
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(bookmarkTree.GetOtherBookmarksFolder()->GetGUID()),
+		bookmarkTree.GetOtherBookmarksFolder());
+
+	auto folder = std::make_unique<BookmarkItem>(std::nullopt, L"Test folder", std::nullopt);
+	auto rawFolder = folder.get();
+
+	auto bookmark = std::make_unique<BookmarkItem>(std::nullopt, L"Test bookmark", L"C:\\");
+	auto rawBookmark = bookmark.get();
+	folder->AddChild(std::move(bookmark));
+
+	bookmarkTree.AddBookmarkItem(bookmarkTree.GetBookmarksMenuFolder(), std::move(folder), 0);
+
+	// Items nested within the item being added should also be retrievable.
+	std::wstring folderGuid = rawFolder->GetGUID();
+	std::wstring bookmarkGuid = rawBookmark->GetGUID();
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(folderGuid), rawFolder);
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(bookmarkGuid), rawBookmark);
+
+	// Moving an item shouldn't affect the lookup.
+	bookmarkTree.MoveBookmarkItem(rawBookmark, bookmarkTree.GetOtherBookmarksFolder(), 0);
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(bookmarkGuid), rawBookmark);
+
+	bookmarkTree.MoveBookmarkItem(rawBookmark, rawFolder, 0);
+	bookmarkTree.RemoveBookmarkItem(rawFolder);
+
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(folderGuid), nullptr);
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(bookmarkGuid), nullptr);
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(L"invalid-guid"), nullptr);
+}
+
+TEST(BookmarkTreeTest, ChildIndexes)
+{
+	BookmarkTree bookmarkTree;
+	BookmarkItem *parentFolder = bookmarkTree.GetBookmarksToolbarFolder();
+
+	std::vector<BookmarkItem *> rawBookmarks;
+
+	for (int i = 0; i < 5; i++)
+	{
+		auto bookmark = std::make_unique<BookmarkItem>(std::nullopt,
+			L"Test bookmark " + std::to_wstring(i), L"C:\\");
+		rawBookmarks.push_back(bookmarkTree.AddBookmarkItem(parentFolder, std::move(bookmark), i));
+	}
+
+	auto checkIndexes = [parentFolder]()
+	{
+		const auto &children = parentFolder->GetChildren();
+
+		for (size_t i = 0; i < children.size(); i++)
+		{
+			EXPECT_EQ(parentFolder->GetChildIndex(children[i].get()), i);
+		}
+	};
+
+	checkIndexes();
+
+	// Inserting an item at the start should shift the indexes of all existing items.
+	auto bookmark = std::make_unique<BookmarkItem>(std::nullopt, L"First bookmark", L"C:\\");
+	auto rawBookmark = bookmarkTree.AddBookmarkItem(parentFolder, std::move(bookmark), 0);
+	EXPECT_EQ(parentFolder->GetChildIndex(rawBookmark), 0);
+	EXPECT_EQ(parentFolder->GetChildIndex(rawBookmarks[0]), 1);
+	checkIndexes();
+
+	size_t numChildren = parentFolder->GetChildren().size();
+	bookmarkTree.MoveBookmarkItem(rawBookmarks[0], parentFolder, numChildren);
+	EXPECT_EQ(parentFolder->GetChildIndex(rawBookmarks[0]), numChildren - 1);
+	checkIndexes();
+
+	bookmarkTree.MoveBookmarkItem(rawBookmarks[2], bookmarkTree.GetOtherBookmarksFolder(), 0);
+	EXPECT_EQ(bookmarkTree.GetOtherBookmarksFolder()->GetChildIndex(rawBookmarks[2]), 0);
+	EXPECT_THROW(parentFolder->GetChildIndex(rawBookmarks[2]), std::invalid_argument);
+	checkIndexes();
+
+	bookmarkTree.RemoveBookmarkItem(rawBookmark);
+	checkIndexes();
+	EXPECT_EQ(parentFolder->GetChildIndex(rawBookmarks[1]), 0);
+}
+
+TEST(BookmarkTreeTest, DuplicateGuids)
+{
+	BookmarkTree bookmarkTree;
+	BookmarkItem *parentFolder = bookmarkTree.GetBookmarksMenuFolder();
+
+	auto rawBookmark1 = bookmarkTree.AddBookmarkItem(parentFolder,
+		std::make_unique<BookmarkItem>(L"duplicate", L"Bookmark 1", L"C:\\"), 0);
+	auto rawBookmark2 = bookmarkTree.AddBookmarkItem(parentFolder,
+		std::make_unique<BookmarkItem>(L"duplicate", L"Bookmark 2", L"C:\\"), 1);
+	auto rawBookmark3 = bookmarkTree.AddBookmarkItem(parentFolder,
+		std::make_unique<BookmarkItem>(L"", L"Bookmark 3", L"C:\\"), 2);
+
+	// The first item keeps its GUID, while the others are given new ones.
+	EXPECT_EQ(rawBookmark1->GetGUID(), L"duplicate");
+	EXPECT_NE(rawBookmark2->GetGUID(), L"duplicate");
+	EXPECT_FALSE(rawBookmark3->GetGUID().empty());
+
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(rawBookmark1->GetGUID()), rawBookmark1);
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(rawBookmark2->GetGUID()), rawBookmark2);
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(rawBookmark3->GetGUID()), rawBookmark3);
+}
+
+// Builds, reorganizes and then removes a large set of bookmarks, with each bookmark being looked
+// up by its GUID before it's moved or removed. The time taken by each stage is recorded in the
+// test output.
+TEST(BookmarkTreeTest, Performance)
+{
+	const size_t NUM_FOLDERS = 100;
+	const size_t NUM_BOOKMARKS = 100000;
+
+	BookmarkTree bookmarkTree;
+	std::vector<BookmarkItem *> rawFolders;
+	std::vector<std::wstring> bookmarkGuids;
+
+	auto recordDuration = [](const std::string &name, auto startTime)
+	{
+		RecordProperty(name,
+			static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::steady_clock::now() - startTime)
+					.count()));
+	};
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < NUM_FOLDERS; i++)
+	{
+		rawFolders.push_back(bookmarkTree.AddBookmarkItem(bookmarkTree.GetBookmarksMenuFolder(),
+			std::make_unique<BookmarkItem>(std::nullopt, L"Folder " + std::to_wstring(i),
+				std::nullopt),
+			i));
+	}
+
+	// Each bookmark is inserted at the start of its folder, which means the index of every
+	// existing item in the folder changes.
+	for (size_t i = 0; i < NUM_BOOKMARKS; i++)
+	{
+		auto rawBookmark = bookmarkTree.AddBookmarkItem(rawFolders[i % NUM_FOLDERS],
+			std::make_unique<BookmarkItem>(std::nullopt, L"Bookmark " + std::to_wstring(i),
+				L"C:\\"),
+			0);
+		bookmarkGuids.push_back(rawBookmark->GetGUID());
+	}
+
+	recordDuration("BuildMilliseconds", startTime);
+
+	startTime = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < NUM_BOOKMARKS; i++)
+	{
+		auto rawBookmark = bookmarkTree.GetBookmarkItemById(bookmarkGuids[i]);
+		ASSERT_NE(rawBookmark, nullptr);
+		bookmarkTree.MoveBookmarkItem(rawBookmark, rawFolders[(i + 1) % NUM_FOLDERS], 0);
+	}
+
+	recordDuration("MoveMilliseconds", startTime);
+
+	startTime = std::chrono::steady_clock::now();
+
+	for (const auto &guid : bookmarkGuids)
+	{
+		auto rawBookmark = bookmarkTree.GetBookmarkItemById(guid);
+		ASSERT_NE(rawBookmark, nullptr);
+		bookmarkTree.RemoveBookmarkItem(rawBookmark);
+	}
+
+	recordDuration("RemoveMilliseconds", startTime);
+
+	for (auto rawFolder : rawFolders)
+	{
+		EXPECT_TRUE(rawFolder->GetChildren().empty());
+	}
+}
+
 TEST_F(BookmarkTreeObserverTest, Add)
 {
 	m_bookmarkTree.bookmarkItemAddedSignal.AddObserver(
@@ -8,8 +8,11 @@
 #include "Bookmarks/BookmarkTree.h"
 #include "ResourceHelper.h"
 #include "XmlStorageHelper.h"
-#include "../Helper/XMLSettings.h"
+#include "../Helper/MappedXmlFile.h"
+#include "../Helper/StringHelper.h"
 #include <gtest/gtest.h>
+#include <chrono>
+#include <set>
 
 using namespace testing;
 
@@ -20,11 +23,11 @@ protected:
 		bool compareGuids)
 	{
 		std::wstring xmlFilePath = GetResourcePath(filename);
-		auto xmlDocument = LoadXmlDocument(xmlFilePath);
-		ASSERT_TRUE(xmlDocument);
+		auto xmlFile = MappedXmlFile::Open(xmlFilePath);
+		ASSERT_TRUE(xmlFile);
 
 		BookmarkTree loadedBookmarkTree;
-		BookmarkXmlStorage::Load(xmlDocument.get(), &loadedBookmarkTree);
+		BookmarkXmlStorage::Load(xmlFile->GetData(), &loadedBookmarkTree);
 
 		CompareBookmarkTrees(&loadedBookmarkTree, referenceBookmarkTree, compareGuids);
 	}
@@ -49,12 +52,104 @@ TEST_F(BookmarkXmlStorageTest, V2Save)
 	BookmarkXmlStorage::Save(xmlDocumentData->xmlDocument.get(), xmlDocumentData->root.get(),
 		&referenceBookmarkTree, 1);
 
+	std::string xmlData = SerializeXmlDocument(xmlDocumentData->xmlDocument.get());
+	ASSERT_FALSE(xmlData.empty());
+
 	BookmarkTree loadedBookmarkTree;
-	BookmarkXmlStorage::Load(xmlDocumentData->xmlDocument.get(), &loadedBookmarkTree);
+	BookmarkXmlStorage::Load(xmlData, &loadedBookmarkTree);
 
 	CompareBookmarkTrees(&loadedBookmarkTree, &referenceBookmarkTree, true);
 }
 
+TEST_F(BookmarkXmlStorageTest, DuplicateGuidsLoad)
+{
+	// The folder shares its GUID with both of the bookmarks inside it, one bookmark uses the GUID
+	// of a permanent folder and two others have no GUID at all.
+	std::string xmlData = "<?xml version=\"1.0\"?>"
+						  "<ExplorerPlusPlus><Bookmarksv2><PermanentItem name=\"BookmarksMenu\">"
+						  "<Bookmark Type=\"0\" GUID=\"duplicate\" ItemName=\"Folder\">"
+						  "<Bookmark Type=\"1\" GUID=\"duplicate\" ItemName=\"Bookmark 1\" "
+						  "Location=\"C:\\\"></Bookmark>"
+						  "<Bookmark Type=\"1\" GUID=\"duplicate\" ItemName=\"Bookmark 2\" "
+						  "Location=\"D:\\\"></Bookmark>"
+						  "</Bookmark>"
+						  "<Bookmark Type=\"1\" GUID=\"00000000-0000-0000-0000-000000000002\" "
+						  "ItemName=\"Bookmark 3\" Location=\"E:\\\"></Bookmark>"
+						  "<Bookmark Type=\"1\" ItemName=\"Bookmark 4\" Location=\"F:\\\">"
+						  "</Bookmark>"
+						  "<Bookmark Type=\"1\" ItemName=\"Bookmark 5\" Location=\"G:\\\">"
+						  "</Bookmark>"
+						  "</PermanentItem></Bookmarksv2></ExplorerPlusPlus>";
+
+	BookmarkTree bookmarkTree;
+	std::wstring toolbarFolderGuid = bookmarkTree.GetBookmarksToolbarFolder()->GetGUID();
+
+	BookmarkXmlStorage::Load(xmlData, &bookmarkTree);
+
+	const auto &menuChildren = bookmarkTree.GetBookmarksMenuFolder()->GetChildren();
+	ASSERT_EQ(menuChildren.size(), 4U);
+	EXPECT_EQ(menuChildren[0]->GetChildren().size(), 2U);
+
+	// Every item should still be loaded, with each one having a unique GUID that can be used to
+	// look it up.
+	std::set<std::wstring> guids;
+	size_t numItems = 0;
+
+	bookmarkTree.GetRoot()->VisitRecursively(
+		[&bookmarkTree, &guids, &numItems](BookmarkItem *bookmarkItem)
+		{
+			EXPECT_FALSE(bookmarkItem->GetGUID().empty());
+			EXPECT_EQ(bookmarkTree.GetBookmarkItemById(bookmarkItem->GetGUID()), bookmarkItem);
+			guids.insert(bookmarkItem->GetGUID());
+			numItems++;
+		});
+
+	EXPECT_EQ(guids.size(), numItems);
+	EXPECT_EQ(bookmarkTree.GetBookmarkItemById(toolbarFolderGuid),
+		bookmarkTree.GetBookmarksToolbarFolder());
+}
+
+// Building the settings document and converting it to text are the parts of a settings save that
+// still run on the UI thread. This measures that cost for a large set of bookmarks, which typically
+// make up most of the document. The time is recorded in the test output.
+TEST_F(BookmarkXmlStorageTest, SavePerformance)
+{
+	const size_t NUM_BOOKMARKS = 10000;
+
+	BookmarkTree bookmarkTree;
+
+	for (size_t i = 0; i < NUM_BOOKMARKS; i++)
+	{
+		bookmarkTree.AddBookmarkItem(bookmarkTree.GetBookmarksMenuFolder(),
+			std::make_unique<BookmarkItem>(std::nullopt, L"Bookmark " + std::to_wstring(i),
+				L"C:\\Folder\\" + std::to_wstring(i)),
+			i);
+	}
+
+	auto xmlDocumentData = CreateXmlDocument();
+	ASSERT_TRUE(xmlDocumentData);
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	BookmarkXmlStorage::Save(xmlDocumentData->xmlDocument.get(), xmlDocumentData->root.get(),
+		&bookmarkTree, 1);
+
+	wil::unique_bstr xml;
+	HRESULT hr = xmlDocumentData->xmlDocument->get_xml(&xml);
+
+	auto endTime = std::chrono::steady_clock::now();
+
+	ASSERT_HRESULT_SUCCEEDED(hr);
+
+	RecordProperty("UiThreadMilliseconds",
+		static_cast<int>(
+			std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count()));
+
+	BookmarkTree loadedBookmarkTree;
+	BookmarkXmlStorage::Load(wstrToUtf8Str(xml.get()), &loadedBookmarkTree);
+	EXPECT_EQ(loadedBookmarkTree.GetBookmarksMenuFolder()->GetChildren().size(), NUM_BOOKMARKS);
+}
+
 TEST_F(BookmarkXmlStorageTest, V1BasicLoad)
 {
 	BookmarkTree referenceBookmarkTree;
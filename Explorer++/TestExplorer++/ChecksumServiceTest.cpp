@@ -0,0 +1,339 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/ChecksumService.h"
+#include "../Helper/Crc32cHasher.h"
+#include "../Helper/Sha256Hasher.h"
+#include "../Helper/XxHash64Hasher.h"
+#include "TempDirectoryHelper.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <future>
+#include <latch>
+#include <map>
+
+using namespace testing;
+
+namespace
+{
+
+std::vector<BYTE> ToBytes(const std::string &text)
+{
+	return { text.begin(), text.end() };
+}
+
+template <typename Hasher>
+auto HashInChunks(const std::vector<BYTE> &data, size_t chunkSize)
+{
+	Hasher hasher;
+
+	for (size_t offset = 0; offset < data.size(); offset += chunkSize)
+	{
+		hasher.Update(data.data() + offset, std::min<size_t>(chunkSize, data.size() - offset));
+	}
+
+	return hasher.Finish();
+}
+
+std::string HashBytes(ChecksumAlgorithm algorithm, const std::vector<BYTE> &data)
+{
+	switch (algorithm)
+	{
+	case ChecksumAlgorithm::Crc32c:
+		return HashInChunks<Crc32cHasher>(data, data.size() + 1);
+
+	case ChecksumAlgorithm::XxHash64:
+		return HashInChunks<XxHash64Hasher>(data, data.size() + 1);
+
+	case ChecksumAlgorithm::Sha256:
+		return HashInChunks<Sha256Hasher>(data, data.size() + 1).value();
+	}
+
+	return {};
+}
+
+}
+
+TEST(Crc32cHasherTest, KnownValues)
+{
+	EXPECT_EQ(HashInChunks<Crc32cHasher>({}, 1), "00000000");
+	EXPECT_EQ(HashInChunks<Crc32cHasher>(ToBytes("123456789"), 9), "e3069283");
+	EXPECT_EQ(HashInChunks<Crc32cHasher>(std::vector<BYTE>(32, 0), 32), "8a9136aa");
+}
+
+TEST(XxHash64HasherTest, KnownValues)
+{
+	EXPECT_EQ(HashInChunks<XxHash64Hasher>({}, 1), "ef46db3751d8e999");
+	EXPECT_EQ(HashInChunks<XxHash64Hasher>(ToBytes("abc"), 3), "44bc2cf5ad770999");
+	EXPECT_EQ(HashInChunks<XxHash64Hasher>(
+				  ToBytes("Nobody inspects the spammish repetition"), 39),
+		"fbcea83c8a378bf1");
+}
+
+// The result shouldn't depend on how the data is split up when it's passed to the hasher.
+TEST(ChecksumHasherTest, Chunking)
+{
+	auto data = GenerateTestData(100003);
+	auto crc = HashInChunks<Crc32cHasher>(data, data.size());
+	auto xxHash = HashInChunks<XxHash64Hasher>(data, data.size());
+
+	for (size_t chunkSize : { 1, 3, 7, 8, 31, 32, 33, 4096 })
+	{
+		EXPECT_EQ(HashInChunks<Crc32cHasher>(data, chunkSize), crc);
+		EXPECT_EQ(HashInChunks<XxHash64Hasher>(data, chunkSize), xxHash);
+	}
+}
+
+TEST(ChecksumHasherTest, Reuse)
+{
+	Crc32cHasher crcHasher;
+	XxHash64Hasher xxHasher;
+	auto data = ToBytes("abc");
+
+	crcHasher.Update(data.data(), data.size());
+	xxHasher.Update(data.data(), data.size());
+	crcHasher.Finish();
+	xxHasher.Finish();
+
+	EXPECT_EQ(crcHasher.Finish(), "00000000");
+	EXPECT_EQ(xxHasher.Finish(), "ef46db3751d8e999");
+}
+
+class ChecksumServiceTest : public TempDirectoryTest
+{
+protected:
+	ChecksumService::File CreateFileForHashing(const std::wstring &name,
+		const std::vector<BYTE> &data)
+	{
+		auto path = CreateTestFile(name, data);
+		return { path, data.size(),
+			std::filesystem::last_write_time(path).time_since_epoch().count() };
+	}
+};
+
+TEST_F(ChecksumServiceTest, CalculateFileChecksum)
+{
+	// The file is larger than the read buffer, so it has to be read in several blocks.
+	auto data = GenerateTestData(3 * 1024 * 1024 + 17);
+	auto file = CreateFileForHashing(L"file.bin", data);
+	std::vector<char> buffer;
+
+	for (auto algorithm :
+		{ ChecksumAlgorithm::Crc32c, ChecksumAlgorithm::XxHash64, ChecksumAlgorithm::Sha256 })
+	{
+		EXPECT_EQ(CalculateFileChecksum(file.path, algorithm, buffer), HashBytes(algorithm, data));
+	}
+
+	auto emptyFile = CreateFileForHashing(L"empty.bin", {});
+	EXPECT_EQ(CalculateFileChecksum(emptyFile.path, ChecksumAlgorithm::Sha256, buffer),
+		"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+
+	EXPECT_EQ(CalculateFileChecksum(m_tempDirectory / L"missing.bin", ChecksumAlgorithm::Crc32c,
+				  buffer),
+		std::nullopt);
+}
+
+TEST_F(ChecksumServiceTest, CalculateFileChecksumStopped)
+{
+	auto file = CreateFileForHashing(L"file.bin", GenerateTestData(1000));
+	std::vector<char> buffer;
+
+	std::atomic<bool> stop = false;
+	EXPECT_NE(CalculateFileChecksum(file.path, ChecksumAlgorithm::Crc32c, buffer, &stop),
+		std::nullopt);
+
+	stop = true;
+	EXPECT_EQ(CalculateFileChecksum(file.path, ChecksumAlgorithm::Crc32c, buffer, &stop),
+		std::nullopt);
+}
+
+TEST_F(ChecksumServiceTest, QueueChecksum)
+{
+	auto data = GenerateTestData(1000);
+	auto file = CreateFileForHashing(L"file.bin", data);
+	ChecksumService service(2, 10);
+
+	EXPECT_EQ(service.GetCachedChecksum(file, ChecksumAlgorithm::XxHash64), std::nullopt);
+
+	std::promise<std::optional<std::string>> result;
+	service.QueueChecksum(file, ChecksumAlgorithm::XxHash64, 1,
+		[&result](const std::optional<std::string> &checksum)
+		{
+			result.set_value(checksum);
+		});
+
+	auto expectedChecksum = HashBytes(ChecksumAlgorithm::XxHash64, data);
+	EXPECT_EQ(result.get_future().get(), expectedChecksum);
+	EXPECT_EQ(service.GetCachedChecksum(file, ChecksumAlgorithm::XxHash64), expectedChecksum);
+
+	// The cache is keyed on the algorithm, along with the file's size and modification time.
+	EXPECT_EQ(service.GetCachedChecksum(file, ChecksumAlgorithm::Crc32c), std::nullopt);
+
+	auto modifiedFile = file;
+	modifiedFile.modificationTime++;
+	EXPECT_EQ(service.GetCachedChecksum(modifiedFile, ChecksumAlgorithm::XxHash64), std::nullopt);
+}
+
+TEST_F(ChecksumServiceTest, GetCachedChecksums)
+{
+	auto data = GenerateTestData(1000);
+	auto file = CreateFileForHashing(L"file.bin", data);
+	ChecksumService::File uncachedFile = { m_tempDirectory / L"uncached.bin", 10, 0 };
+	ChecksumService service(1, 10);
+
+	std::promise<void> completed;
+	service.QueueChecksum(file, ChecksumAlgorithm::Crc32c, 1,
+		[&completed](const std::optional<std::string> &checksum)
+		{
+			UNREFERENCED_PARAMETER(checksum);
+
+			completed.set_value();
+		});
+	completed.get_future().wait();
+
+	EXPECT_EQ(service.GetCachedChecksums({ uncachedFile, file, uncachedFile },
+				  ChecksumAlgorithm::Crc32c),
+		(std::vector<std::optional<std::string>>{ std::nullopt,
+			HashBytes(ChecksumAlgorithm::Crc32c, data), std::nullopt }));
+	EXPECT_EQ(service.GetCachedChecksums({ file }, ChecksumAlgorithm::Sha256),
+		(std::vector<std::optional<std::string>>{ std::nullopt }));
+	EXPECT_TRUE(service.GetCachedChecksums({}, ChecksumAlgorithm::Crc32c).empty());
+}
+
+TEST_F(ChecksumServiceTest, MissingFile)
+{
+	ChecksumService service(1, 10);
+	ChecksumService::File file = { m_tempDirectory / L"missing.bin", 10, 0 };
+
+	std::promise<std::optional<std::string>> result;
+	service.QueueChecksum(file, ChecksumAlgorithm::Crc32c, 1,
+		[&result](const std::optional<std::string> &checksum)
+		{
+			result.set_value(checksum);
+		});
+
+	EXPECT_EQ(result.get_future().get(), std::nullopt);
+	EXPECT_EQ(service.GetCachedChecksum(file, ChecksumAlgorithm::Crc32c), std::nullopt);
+}
+
+TEST_F(ChecksumServiceTest, CacheSize)
+{
+	ChecksumService service(1, 2);
+	std::vector<ChecksumService::File> files;
+
+	for (int i = 0; i < 3; i++)
+	{
+		files.push_back(CreateFileForHashing(L"file" + std::to_wstring(i), GenerateTestData(i)));
+
+		std::promise<void> completed;
+		service.QueueChecksum(files[i], ChecksumAlgorithm::Crc32c, 1,
+			[&completed](const std::optional<std::string> &checksum)
+			{
+				UNREFERENCED_PARAMETER(checksum);
+
+				completed.set_value();
+			});
+		completed.get_future().wait();
+
+		if (i == 1)
+		{
+			// Using the first checksum should mean the second is evicted instead.
+			EXPECT_NE(service.GetCachedChecksum(files[0], ChecksumAlgorithm::Crc32c),
+				std::nullopt);
+		}
+	}
+
+	EXPECT_NE(service.GetCachedChecksum(files[0], ChecksumAlgorithm::Crc32c), std::nullopt);
+	EXPECT_EQ(service.GetCachedChecksum(files[1], ChecksumAlgorithm::Crc32c), std::nullopt);
+	EXPECT_NE(service.GetCachedChecksum(files[2], ChecksumAlgorithm::Crc32c), std::nullopt);
+}
+
+// Uses a single thread, which is kept busy while the other requests are queued, so that the
+// order in which those requests are processed can be checked.
+TEST_F(ChecksumServiceTest, Ordering)
+{
+	ChecksumService service(1, 10);
+
+	std::promise<void> blockingStarted;
+	std::promise<void> unblock;
+	auto unblockFuture = unblock.get_future();
+	service.QueueChecksum(CreateFileForHashing(L"blocking", {}), ChecksumAlgorithm::Crc32c, 1,
+		[&blockingStarted, &unblockFuture](const std::optional<std::string> &checksum)
+		{
+			UNREFERENCED_PARAMETER(checksum);
+
+			blockingStarted.set_value();
+			unblockFuture.wait();
+		});
+	blockingStarted.get_future().wait();
+
+	std::mutex mutex;
+	std::vector<std::wstring> completedFiles;
+	std::latch remaining(4);
+
+	std::map<std::wstring, ChecksumService::File> files;
+
+	for (std::wstring name : { L"first", L"second", L"third", L"fourth", L"fifth", L"sixth" })
+	{
+		files.emplace(name, CreateFileForHashing(name, GenerateTestData(name.size())));
+	}
+
+	auto queue = [&](const std::wstring &name, int groupId)
+	{
+		service.QueueChecksum(files.at(name), ChecksumAlgorithm::Crc32c, groupId,
+			[&, name](const std::optional<std::string> &checksum)
+			{
+				EXPECT_NE(checksum, std::nullopt);
+
+				{
+					std::scoped_lock lock(mutex);
+					completedFiles.push_back(name);
+				}
+
+				remaining.count_down();
+			});
+	};
+
+	queue(L"first", 1);
+	queue(L"second", 1);
+	queue(L"third", 2);
+	queue(L"fourth", 2);
+	queue(L"fifth", 2);
+
+	// Requesting the first file again moves it to the front of the queue.
+	queue(L"first", 1);
+
+	service.CancelGroup(2);
+	queue(L"sixth", 3);
+
+	unblock.set_value();
+	remaining.wait();
+
+	// The first file was requested twice, so its callback is invoked twice.
+	EXPECT_EQ(completedFiles,
+		(std::vector<std::wstring>{ L"sixth", L"first", L"first", L"second" }));
+}
+
+// Records the throughput of each algorithm, in megabytes per second, in the test output.
+TEST(ChecksumBenchmarkTest, Throughput)
+{
+	auto data = GenerateTestData(64 * 1024 * 1024);
+
+	for (auto [algorithm, name] :
+		{ std::pair{ ChecksumAlgorithm::Crc32c, "Crc32c" },
+			std::pair{ ChecksumAlgorithm::XxHash64, "XxHash64" },
+			std::pair{ ChecksumAlgorithm::Sha256, "Sha256" } })
+	{
+		auto startTime = std::chrono::steady_clock::now();
+		auto checksum = HashBytes(algorithm, data);
+		auto endTime = std::chrono::steady_clock::now();
+
+		EXPECT_FALSE(checksum.empty());
+
+		auto seconds = std::chrono::duration<double>(endTime - startTime).count();
+		RecordProperty(std::string(name) + "MegabytesPerSecond",
+			static_cast<int>(static_cast<double>(data.size()) / (1024 * 1024) / seconds));
+	}
+}
@@ -0,0 +1,166 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Explorer++/ShellBrowser/DateGroupBuckets.h"
+#include <gtest/gtest.h>
+#include <chrono>
+
+using Bucket = DateGroupBuckets::Bucket;
+
+namespace
+{
+
+SYSTEMTIME MakeSystemTime(WORD year, WORD month, WORD day, WORD hour = 0, WORD minute = 0)
+{
+	SYSTEMTIME systemTime = {};
+	systemTime.wYear = year;
+	systemTime.wMonth = month;
+	systemTime.wDay = day;
+	systemTime.wHour = hour;
+	systemTime.wMinute = minute;
+	return systemTime;
+}
+
+FILETIME MakeFileTime(WORD year, WORD month, WORD day, WORD hour = 0, WORD minute = 0)
+{
+	SYSTEMTIME systemTime = MakeSystemTime(year, month, day, hour, minute);
+
+	FILETIME fileTime;
+	EXPECT_TRUE(SystemTimeToFileTime(&systemTime, &fileTime));
+	return fileTime;
+}
+
+// A fixed time zone without daylight saving time, so that the results don't depend on the time
+// zone of the machine running the tests.
+TIME_ZONE_INFORMATION MakeTimeZone(LONG bias)
+{
+	TIME_ZONE_INFORMATION timeZone = {};
+	timeZone.Bias = bias;
+	return timeZone;
+}
+
+}
+
+TEST(DateGroupBucketsTest, Classify)
+{
+	auto timeZone = MakeTimeZone(0);
+
+	// A Wednesday.
+	auto buckets = DateGroupBuckets::Create(MakeSystemTime(2021, 3, 17, 12), &timeZone);
+	ASSERT_TRUE(buckets);
+
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2022, 1, 1)), Bucket::Future);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 18)), Bucket::Future);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 17, 23, 59)), Bucket::Today);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 17)), Bucket::Today);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 16, 23, 59)), Bucket::Yesterday);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 16)), Bucket::Yesterday);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 15)), Bucket::ThisWeek);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 14)), Bucket::ThisWeek);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 13, 23, 59)), Bucket::LastWeek);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 7)), Bucket::LastWeek);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 6)), Bucket::ThisMonth);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 1)), Bucket::ThisMonth);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 2, 28)), Bucket::LastMonth);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 2, 1)), Bucket::LastMonth);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 1, 31)), Bucket::ThisYear);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 1, 1)), Bucket::ThisYear);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2020, 12, 31)), Bucket::LastYear);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2020, 1, 1)), Bucket::LastYear);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2019, 12, 31, 23, 59)), Bucket::LongAgo);
+	EXPECT_EQ(buckets->Classify(FILETIME{}), Bucket::LongAgo);
+}
+
+TEST(DateGroupBucketsTest, OverlappingRanges)
+{
+	auto timeZone = MakeTimeZone(0);
+
+	// A Tuesday, at the start of a month. Since the current week started in the previous month,
+	// the more specific ranges should take precedence.
+	auto buckets = DateGroupBuckets::Create(MakeSystemTime(2021, 3, 2, 8), &timeZone);
+	ASSERT_TRUE(buckets);
+
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 1)), Bucket::Yesterday);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 2, 28)), Bucket::ThisWeek);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 2, 27)), Bucket::LastWeek);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 2, 20)), Bucket::LastMonth);
+}
+
+TEST(DateGroupBucketsTest, TimeZone)
+{
+	// UTC+1. Local midnight is therefore at 23:00 UTC on the previous day.
+	auto timeZone = MakeTimeZone(-60);
+
+	auto buckets = DateGroupBuckets::Create(MakeSystemTime(2021, 3, 17, 12), &timeZone);
+	ASSERT_TRUE(buckets);
+
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 17, 23)), Bucket::Future);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 17, 22, 59)), Bucket::Today);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 16, 23)), Bucket::Today);
+	EXPECT_EQ(buckets->Classify(MakeFileTime(2021, 3, 16, 22, 59)), Bucket::Yesterday);
+}
+
+TEST(DateGroupBucketsTest, InvalidDate)
+{
+	auto timeZone = MakeTimeZone(0);
+
+	EXPECT_FALSE(DateGroupBuckets::Create(MakeSystemTime(2021, 2, 30), &timeZone));
+	EXPECT_FALSE(DateGroupBuckets::Create(MakeSystemTime(2021, 13, 1), &timeZone));
+}
+
+// Classifies 100,000 times, spread across the three years before the current date, as happens
+// when a large folder is grouped by one of the date columns (the created, modified and accessed
+// columns are all grouped this way). The time taken is recorded in the test output.
+TEST(DateGroupBucketsTest, Performance)
+{
+	const int NUM_ITEMS = 100000;
+
+	auto timeZone = MakeTimeZone(0);
+	auto buckets = DateGroupBuckets::Create(MakeSystemTime(2021, 3, 17, 12), &timeZone);
+	ASSERT_TRUE(buckets);
+
+	FILETIME startFileTime = MakeFileTime(2018, 3, 17);
+	ULARGE_INTEGER start;
+	start.LowPart = startFileTime.dwLowDateTime;
+	start.HighPart = startFileTime.dwHighDateTime;
+
+	FILETIME endFileTime = MakeFileTime(2021, 3, 17, 12);
+	ULARGE_INTEGER end;
+	end.LowPart = endFileTime.dwLowDateTime;
+	end.HighPart = endFileTime.dwHighDateTime;
+
+	ULONGLONG interval = (end.QuadPart - start.QuadPart) / NUM_ITEMS;
+
+	std::vector<FILETIME> times;
+	times.reserve(NUM_ITEMS);
+
+	for (int i = 0; i < NUM_ITEMS; i++)
+	{
+		ULARGE_INTEGER time;
+		time.QuadPart = start.QuadPart + static_cast<ULONGLONG>(i) * interval;
+		times.push_back({ time.LowPart, time.HighPart });
+	}
+
+	std::array<size_t, DateGroupBuckets::NUM_BUCKETS> bucketCounts = {};
+
+	auto classifyStartTime = std::chrono::steady_clock::now();
+
+	for (const auto &time : times)
+	{
+		bucketCounts[static_cast<size_t>(buckets->Classify(time))]++;
+	}
+
+	auto classifyEndTime = std::chrono::steady_clock::now();
+
+	auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+		classifyEndTime - classifyStartTime);
+	RecordProperty("ClassifyMicroseconds", static_cast<int>(duration.count()));
+
+	// The times run from three years ago up to the current time, so the future bucket shouldn't
+	// be used, while both the most recent and least recent buckets should be.
+	EXPECT_EQ(bucketCounts[static_cast<size_t>(Bucket::Future)], 0U);
+	EXPECT_GT(bucketCounts[static_cast<size_t>(Bucket::Today)], 0U);
+	EXPECT_GT(bucketCounts[static_cast<size_t>(Bucket::LongAgo)], 0U);
+}
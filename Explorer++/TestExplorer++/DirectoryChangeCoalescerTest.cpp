@@ -0,0 +1,227 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/DirectoryChangeCoalescer.h"
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+using Event = DirectoryChangeCoalescer::Event;
+using ChangeType = DirectoryChangeCoalescer::ChangeType;
+using Change = DirectoryChangeCoalescer::Change;
+
+namespace
+{
+
+DirectoryChangeCoalescer::Batch Coalesce(
+	const std::vector<std::pair<Event, std::wstring>> &events)
+{
+	DirectoryChangeCoalescer coalescer;
+
+	for (const auto &[event, name] : events)
+	{
+		coalescer.AddEvent(event, name);
+	}
+
+	return coalescer.TakeBatch();
+}
+
+std::vector<Change> CoalesceChanges(const std::vector<std::pair<Event, std::wstring>> &events)
+{
+	auto batch = Coalesce(events);
+	EXPECT_FALSE(batch.rescanRequired);
+	return batch.changes;
+}
+
+}
+
+TEST(DirectoryChangeCoalescerTest, IndependentChanges)
+{
+	auto changes = CoalesceChanges({ { Event::Added, L"a" }, { Event::Removed, L"b" },
+		{ Event::Modified, L"c" }, { Event::RenamedOldName, L"d" },
+		{ Event::RenamedNewName, L"e" } });
+
+	std::vector<Change> expected = { { ChangeType::Added, L"a", {} },
+		{ ChangeType::Removed, L"b", {} }, { ChangeType::Modified, L"c", {} },
+		{ ChangeType::Renamed, L"d", L"e" } };
+	EXPECT_EQ(changes, expected);
+}
+
+TEST(DirectoryChangeCoalescerTest, CreatedAndRemoved)
+{
+	auto changes = CoalesceChanges({ { Event::Added, L"a" }, { Event::Modified, L"a" },
+		{ Event::Modified, L"a" }, { Event::RenamedOldName, L"a" },
+		{ Event::RenamedNewName, L"b" }, { Event::Removed, L"b" } });
+	EXPECT_TRUE(changes.empty());
+}
+
+TEST(DirectoryChangeCoalescerTest, CreatedAndModified)
+{
+	auto changes = CoalesceChanges({ { Event::Added, L"a" }, { Event::Modified, L"a" },
+		{ Event::Modified, L"a" } });
+
+	std::vector<Change> expected = { { ChangeType::Added, L"a", {} } };
+	EXPECT_EQ(changes, expected);
+}
+
+TEST(DirectoryChangeCoalescerTest, RepeatedModifications)
+{
+	std::vector<std::pair<Event, std::wstring>> events;
+
+	for (int i = 0; i < 1000; i++)
+	{
+		events.emplace_back(Event::Modified, L"a");
+		events.emplace_back(Event::Modified, L"b");
+	}
+
+	auto changes = CoalesceChanges(events);
+
+	std::vector<Change> expected = { { ChangeType::Modified, L"a", {} },
+		{ ChangeType::Modified, L"b", {} } };
+	EXPECT_EQ(changes, expected);
+}
+
+TEST(DirectoryChangeCoalescerTest, ModifiedAndRemoved)
+{
+	auto changes = CoalesceChanges({ { Event::Modified, L"a" }, { Event::Removed, L"a" } });
+
+	std::vector<Change> expected = { { ChangeType::Removed, L"a", {} } };
+	EXPECT_EQ(changes, expected);
+}
+
+TEST(DirectoryChangeCoalescerTest, RemovedAndRecreated)
+{
+	// Some applications save a file by removing the original file and creating a new one in its
+	// place.
+	auto changes = CoalesceChanges({ { Event::Removed, L"a" }, { Event::Added, L"a" },
+		{ Event::Modified, L"a" } });
+
+	std::vector<Change> expected = { { ChangeType::Modified, L"a", {} } };
+	EXPECT_EQ(changes, expected);
+}
+
+TEST(DirectoryChangeCoalescerTest, RenameChain)
+{
+	auto changes = CoalesceChanges({ { Event::RenamedOldName, L"a" },
+		{ Event::RenamedNewName, L"b" }, { Event::Modified, L"b" },
+		{ Event::RenamedOldName, L"b" }, { Event::RenamedNewName, L"c" } });
+
+	std::vector<Change> expected = { { ChangeType::Renamed, L"a", L"c" } };
+	EXPECT_EQ(changes, expected);
+}
+
+TEST(DirectoryChangeCoalescerTest, RenamedBack)
+{
+	auto changes = CoalesceChanges({ { Event::RenamedOldName, L"a" },
+		{ Event::RenamedNewName, L"b" }, { Event::RenamedOldName, L"b" },
+		{ Event::RenamedNewName, L"a" } });
+	EXPECT_TRUE(changes.empty());
+
+	changes = CoalesceChanges({ { Event::RenamedOldName, L"a" }, { Event::RenamedNewName, L"b" },
+		{ Event::Modified, L"b" }, { Event::RenamedOldName, L"b" },
+		{ Event::RenamedNewName, L"a" } });
+
+	std::vector<Change> expected = { { ChangeType::Modified, L"a", {} } };
+	EXPECT_EQ(changes, expected);
+}
+
+TEST(DirectoryChangeCoalescerTest, RenameIntoVacatedName)
+{
+	auto changes = CoalesceChanges({ { Event::RenamedOldName, L"a" },
+		{ Event::RenamedNewName, L"b" }, { Event::RenamedOldName, L"c" },
+		{ Event::RenamedNewName, L"a" }, { Event::Added, L"c" } });
+
+	std::vector<Change> expected = { { ChangeType::Renamed, L"a", L"b" },
+		{ ChangeType::Renamed, L"c", L"a" }, { ChangeType::Added, L"c", {} } };
+	EXPECT_EQ(changes, expected);
+
+	changes = CoalesceChanges({ { Event::Removed, L"a" }, { Event::RenamedOldName, L"b" },
+		{ Event::RenamedNewName, L"a" } });
+
+	expected = { { ChangeType::Removed, L"a", {} }, { ChangeType::Renamed, L"b", L"a" } };
+	EXPECT_EQ(changes, expected);
+}
+
+TEST(DirectoryChangeCoalescerTest, MovedIntoAndOutOfDirectory)
+{
+	// When an item is moved out of the directory, only the old name will be reported. Similarly,
+	// when an item is moved in, only the new name will be reported.
+	auto changes = CoalesceChanges({ { Event::RenamedOldName, L"a" }, { Event::Modified, L"b" },
+		{ Event::RenamedNewName, L"c" }, { Event::RenamedOldName, L"d" } });
+
+	std::vector<Change> expected = { { ChangeType::Removed, L"a", {} },
+		{ ChangeType::Modified, L"b", {} }, { ChangeType::Added, L"c", {} },
+		{ ChangeType::Removed, L"d", {} } };
+	EXPECT_EQ(changes, expected);
+}
+
+TEST(DirectoryChangeCoalescerTest, ReorderedChangesRequireRescan)
+{
+	// Applying the rename first would result in the renamed item being removed.
+	auto batch = Coalesce({ { Event::Modified, L"a" }, { Event::Removed, L"b" },
+		{ Event::RenamedOldName, L"a" }, { Event::RenamedNewName, L"b" } });
+	EXPECT_TRUE(batch.rescanRequired);
+	EXPECT_TRUE(batch.changes.empty());
+
+	// Swapping the names of two items.
+	batch = Coalesce({ { Event::RenamedOldName, L"a" }, { Event::RenamedNewName, L"temp" },
+		{ Event::RenamedOldName, L"b" }, { Event::RenamedNewName, L"a" },
+		{ Event::RenamedOldName, L"temp" }, { Event::RenamedNewName, L"b" } });
+	EXPECT_TRUE(batch.rescanRequired);
+}
+
+TEST(DirectoryChangeCoalescerTest, InconsistentEventsRequireRescan)
+{
+	auto batch = Coalesce({ { Event::Removed, L"a" }, { Event::Removed, L"a" } });
+	EXPECT_TRUE(batch.rescanRequired);
+
+	batch = Coalesce({ { Event::Added, L"a" }, { Event::RenamedOldName, L"b" },
+		{ Event::RenamedNewName, L"a" } });
+	EXPECT_TRUE(batch.rescanRequired);
+}
+
+TEST(DirectoryChangeCoalescerTest, Overflow)
+{
+	DirectoryChangeCoalescer coalescer;
+	EXPECT_FALSE(coalescer.HasPendingChanges());
+
+	coalescer.AddEvent(Event::Added, L"a");
+	coalescer.OnOverflow();
+	coalescer.AddEvent(Event::Added, L"b");
+	EXPECT_TRUE(coalescer.HasPendingChanges());
+
+	auto batch = coalescer.TakeBatch();
+	EXPECT_TRUE(batch.rescanRequired);
+	EXPECT_TRUE(batch.changes.empty());
+
+	// Each batch should start from a clean state.
+	EXPECT_FALSE(coalescer.HasPendingChanges());
+
+	coalescer.AddEvent(Event::Added, L"c");
+	batch = coalescer.TakeBatch();
+	EXPECT_FALSE(batch.rescanRequired);
+
+	std::vector<Change> expected = { { ChangeType::Added, L"c", {} } };
+	EXPECT_EQ(batch.changes, expected);
+}
+
+TEST(DirectoryChangeCoalescerTest, SeparateBatches)
+{
+	DirectoryChangeCoalescer coalescer;
+
+	coalescer.AddEvent(Event::Added, L"a");
+	auto batch = coalescer.TakeBatch();
+
+	std::vector<Change> expected = { { ChangeType::Added, L"a", {} } };
+	EXPECT_EQ(batch.changes, expected);
+
+	// Since the first batch has already been taken, the removal here should be reported, rather
+	// than cancelling out the addition.
+	coalescer.AddEvent(Event::Removed, L"a");
+	batch = coalescer.TakeBatch();
+
+	expected = { { ChangeType::Removed, L"a", {} } };
+	EXPECT_EQ(batch.changes, expected);
+}
@@ -0,0 +1,184 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/DirectoryListingExporter.h"
+#include "TempDirectoryHelper.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+
+class DirectoryListingExporterTest : public TempDirectoryTest
+{
+protected:
+	void SetUp() override
+	{
+		TempDirectoryTest::SetUp();
+
+		m_directory = m_tempDirectory / L"Listed";
+		ASSERT_TRUE(std::filesystem::create_directory(m_directory));
+
+		m_outputPath = m_tempDirectory / L"listing";
+	}
+
+	void CreateListedFile(const std::wstring &relativePath, size_t size)
+	{
+		CreateTestFile(L"Listed\\" + relativePath, GenerateTestData(size));
+	}
+
+	std::string Export(const DirectoryListingExporter::Options &options)
+	{
+		DirectoryListingExporter exporter(m_directory, options);
+		EXPECT_TRUE(exporter.Export(m_outputPath));
+		m_statistics = exporter.GetStatistics();
+
+		auto contents = ReadFileContents(m_outputPath);
+		return std::string(contents.begin(), contents.end());
+	}
+
+	std::filesystem::path m_directory;
+	std::filesystem::path m_outputPath;
+	DirectoryListingExporter::Statistics m_statistics;
+};
+
+TEST_F(DirectoryListingExporterTest, Text)
+{
+	CreateListedFile(L"file1.txt", 100);
+	CreateListedFile(L"file2.txt", 200);
+	CreateListedFile(L"Folder\\nested.txt", 300);
+
+	DirectoryListingExporter::Options options;
+	options.format = DirectoryListingExporter::Format::Text;
+	std::string contents = Export(options);
+
+	EXPECT_TRUE(contents.starts_with("\xEF\xBB\xBF"));
+	EXPECT_NE(contents.find("file1.txt\r\n"), std::string::npos);
+	EXPECT_NE(contents.find("file2.txt\r\n"), std::string::npos);
+	EXPECT_NE(contents.find("<DIR>  Folder\r\n"), std::string::npos);
+	EXPECT_EQ(contents.find("nested.txt"), std::string::npos);
+	EXPECT_NE(contents.find("Number of folders: 1\r\n"), std::string::npos);
+	EXPECT_NE(contents.find("Number of files: 2\r\n"), std::string::npos);
+
+	EXPECT_EQ(m_statistics.numFolders, 1U);
+	EXPECT_EQ(m_statistics.numFiles, 2U);
+	EXPECT_EQ(m_statistics.totalSize, 300U);
+}
+
+TEST_F(DirectoryListingExporterTest, Recursive)
+{
+	CreateListedFile(L"file.txt", 10);
+	CreateListedFile(L"Folder1\\nested1.txt", 20);
+	CreateListedFile(L"Folder1\\Folder2\\nested2.txt", 30);
+	ASSERT_TRUE(std::filesystem::create_directory(m_directory / L"Empty"));
+
+	DirectoryListingExporter::Options options;
+	options.format = DirectoryListingExporter::Format::Text;
+	options.recursive = true;
+	std::string contents = Export(options);
+
+	EXPECT_NE(contents.find("Folder1\\nested1.txt\r\n"), std::string::npos);
+	EXPECT_NE(contents.find("Folder1\\Folder2\\nested2.txt\r\n"), std::string::npos);
+
+	// Each subfolder should be listed before its contents.
+	EXPECT_LT(contents.find("Folder1\\Folder2\r\n"),
+		contents.find("Folder1\\Folder2\\nested2.txt"));
+
+	EXPECT_EQ(m_statistics.numFolders, 3U);
+	EXPECT_EQ(m_statistics.numFiles, 3U);
+	EXPECT_EQ(m_statistics.totalSize, 60U);
+}
+
+TEST_F(DirectoryListingExporterTest, Csv)
+{
+	CreateListedFile(L"plain.txt", 1234);
+	CreateListedFile(L"with,comma.txt", 5);
+	ASSERT_TRUE(std::filesystem::create_directory(m_directory / L"Folder"));
+
+	DirectoryListingExporter::Options options;
+	options.format = DirectoryListingExporter::Format::Csv;
+	std::string contents = Export(options);
+
+	EXPECT_TRUE(contents.starts_with("\xEF\xBB\xBFPath,Type,Size,Date Modified,Attributes\r\n"));
+	EXPECT_NE(contents.find("\r\nplain.txt,File,1234,"), std::string::npos);
+	EXPECT_NE(contents.find("\r\n\"with,comma.txt\",File,5,"), std::string::npos);
+	EXPECT_NE(contents.find("\r\nFolder,Folder,,"), std::string::npos);
+}
+
+TEST_F(DirectoryListingExporterTest, Json)
+{
+	CreateListedFile(L"Folder\\file.txt", 42);
+
+	DirectoryListingExporter::Options options;
+	options.format = DirectoryListingExporter::Format::Json;
+	options.recursive = true;
+	std::string contents = Export(options);
+
+	EXPECT_TRUE(contents.starts_with("{"));
+	EXPECT_NE(contents.find("{\"path\": \"Folder\", \"type\": \"folder\", \"modified\": "),
+		std::string::npos);
+	EXPECT_NE(contents.find("{\"path\": \"Folder\\\\file.txt\", \"type\": \"file\", \"size\": 42"),
+		std::string::npos);
+	EXPECT_NE(contents.find("\"statistics\": {\"folders\": 1, \"files\": 1, \"totalSize\": 42}"),
+		std::string::npos);
+}
+
+TEST_F(DirectoryListingExporterTest, JsonEmptyDirectory)
+{
+	DirectoryListingExporter::Options options;
+	options.format = DirectoryListingExporter::Format::Json;
+	std::string contents = Export(options);
+
+	EXPECT_NE(contents.find("\"entries\": [],"), std::string::npos);
+	EXPECT_NE(contents.find("\"statistics\": {\"folders\": 0, \"files\": 0, \"totalSize\": 0}"),
+		std::string::npos);
+}
+
+TEST_F(DirectoryListingExporterTest, Utf8)
+{
+	CreateListedFile(L"\u00E9\u4E2D.txt", 1);
+
+	DirectoryListingExporter::Options options;
+	options.format = DirectoryListingExporter::Format::Csv;
+	std::string contents = Export(options);
+
+	EXPECT_NE(contents.find("\xC3\xA9\xE4\xB8\xAD.txt,File,1,"), std::string::npos);
+}
+
+TEST_F(DirectoryListingExporterTest, LargeDirectory)
+{
+	// Enough entries that the output is larger than the writer's internal buffer.
+	const int NUM_FILES = 2000;
+
+	for (int i = 0; i < NUM_FILES; i++)
+	{
+		CreateListedFile(L"file_with_a_reasonably_long_name_" + std::to_wstring(i) + L".txt", 0);
+	}
+
+	DirectoryListingExporter::Options options;
+	options.format = DirectoryListingExporter::Format::Csv;
+	std::string contents = Export(options);
+
+	EXPECT_EQ(m_statistics.numFiles, static_cast<ULONGLONG>(NUM_FILES));
+	EXPECT_EQ(std::count(contents.begin(), contents.end(), '\n'), NUM_FILES + 1);
+	EXPECT_NE(contents.find("\r\nfile_with_a_reasonably_long_name_1999.txt,File,0,"),
+		std::string::npos);
+}
+
+TEST_F(DirectoryListingExporterTest, MissingDirectory)
+{
+	DirectoryListingExporter exporter(m_tempDirectory / L"Missing", {});
+	EXPECT_FALSE(exporter.Export(m_outputPath));
+	EXPECT_FALSE(std::filesystem::exists(m_outputPath));
+}
+
+TEST_F(DirectoryListingExporterTest, Cancel)
+{
+	CreateListedFile(L"file.txt", 10);
+
+	DirectoryListingExporter exporter(m_directory, {});
+	exporter.Cancel();
+
+	// The partially written listing shouldn't be left behind.
+	EXPECT_FALSE(exporter.Export(m_outputPath));
+	EXPECT_FALSE(std::filesystem::exists(m_outputPath));
+}
@@ -0,0 +1,141 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/DirectorySnapshot.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+using namespace testing;
+
+namespace
+{
+
+std::vector<DirectorySnapshotEntry> BuildLargeSnapshot(size_t numEntries)
+{
+	std::vector<DirectorySnapshotEntry> snapshot;
+	snapshot.reserve(numEntries);
+
+	for (size_t i = 0; i < numEntries; i++)
+	{
+		snapshot.push_back(
+			{ L"File " + std::to_wstring(i) + L".txt", i * 100, 132000000000000000 + i, 0x20 });
+	}
+
+	return snapshot;
+}
+
+}
+
+TEST(DirectorySnapshotTest, Identical)
+{
+	std::vector<DirectorySnapshotEntry> snapshot = { { L"a", 1, 2, 3 }, { L"b", 4, 5, 6 } };
+
+	auto diff = DiffDirectorySnapshots(snapshot, snapshot);
+	EXPECT_TRUE(diff.IsEmpty());
+
+	diff = DiffDirectorySnapshots({}, {});
+	EXPECT_TRUE(diff.IsEmpty());
+}
+
+TEST(DirectorySnapshotTest, AddedAndRemoved)
+{
+	auto diff = DiffDirectorySnapshots({}, { { L"a", 1, 2, 3 }, { L"b", 4, 5, 6 } });
+	EXPECT_EQ(diff.added, (std::vector<std::wstring>{ L"a", L"b" }));
+	EXPECT_TRUE(diff.removed.empty());
+	EXPECT_TRUE(diff.modified.empty());
+
+	diff = DiffDirectorySnapshots({ { L"a", 1, 2, 3 }, { L"b", 4, 5, 6 } }, {});
+	EXPECT_EQ(diff.removed, (std::vector<std::wstring>{ L"a", L"b" }));
+	EXPECT_TRUE(diff.added.empty());
+	EXPECT_TRUE(diff.modified.empty());
+
+	diff = DiffDirectorySnapshots({ { L"a", 1, 2, 3 }, { L"b", 4, 5, 6 }, { L"c", 7, 8, 9 } },
+		{ { L"a", 1, 2, 3 }, { L"c", 7, 8, 9 }, { L"d", 10, 11, 12 } });
+	EXPECT_EQ(diff.removed, (std::vector<std::wstring>{ L"b" }));
+	EXPECT_EQ(diff.added, (std::vector<std::wstring>{ L"d" }));
+	EXPECT_TRUE(diff.modified.empty());
+}
+
+TEST(DirectorySnapshotTest, Modified)
+{
+	std::vector<DirectorySnapshotEntry> previous = { { L"size", 1, 2, 3 }, { L"time", 1, 2, 3 },
+		{ L"attributes", 1, 2, 3 }, { L"unchanged", 1, 2, 3 } };
+	std::vector<DirectorySnapshotEntry> current = { { L"size", 10, 2, 3 }, { L"time", 1, 20, 3 },
+		{ L"attributes", 1, 2, 30 }, { L"unchanged", 1, 2, 3 } };
+
+	auto diff = DiffDirectorySnapshots(previous, current);
+	EXPECT_EQ(diff.modified, (std::vector<std::wstring>{ L"size", L"time", L"attributes" }));
+	EXPECT_TRUE(diff.added.empty());
+	EXPECT_TRUE(diff.removed.empty());
+}
+
+TEST(DirectorySnapshotTest, Reordered)
+{
+	// The order in which items are enumerated isn't significant.
+	std::vector<DirectorySnapshotEntry> previous = { { L"a", 1, 2, 3 }, { L"b", 4, 5, 6 },
+		{ L"c", 7, 8, 9 } };
+	std::vector<DirectorySnapshotEntry> current = { { L"c", 7, 8, 9 }, { L"a", 1, 2, 3 },
+		{ L"b", 40, 5, 6 } };
+
+	auto diff = DiffDirectorySnapshots(previous, current);
+	EXPECT_EQ(diff.modified, (std::vector<std::wstring>{ L"b" }));
+	EXPECT_TRUE(diff.added.empty());
+	EXPECT_TRUE(diff.removed.empty());
+}
+
+TEST(DirectorySnapshotTest, CaseSensitive)
+{
+	auto diff = DiffDirectorySnapshots({ { L"file", 1, 2, 3 } }, { { L"FILE", 1, 2, 3 } });
+	EXPECT_EQ(diff.removed, (std::vector<std::wstring>{ L"file" }));
+	EXPECT_EQ(diff.added, (std::vector<std::wstring>{ L"FILE" }));
+	EXPECT_TRUE(diff.modified.empty());
+}
+
+// Compares two snapshots of a large directory in which only a few items have changed. The time
+// taken for each comparison is recorded in the test output.
+TEST(DirectorySnapshotTest, LargeDirectory)
+{
+	const size_t numEntries = 100000;
+
+	auto previous = BuildLargeSnapshot(numEntries);
+	auto current = previous;
+
+	current[10].size++;
+	current[numEntries / 2].lastWriteTime++;
+	current[numEntries - 1].attributes |= 0x2;
+
+	auto startTime = std::chrono::steady_clock::now();
+	auto diff = DiffDirectorySnapshots(previous, current);
+	auto endTime = std::chrono::steady_clock::now();
+	RecordProperty("SameOrderMicroseconds",
+		static_cast<int>(
+			std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()));
+
+	std::vector<std::wstring> expectedModified = { current[10].name, current[numEntries / 2].name,
+		current[numEntries - 1].name };
+	EXPECT_EQ(diff.modified, expectedModified);
+	EXPECT_TRUE(diff.added.empty());
+	EXPECT_TRUE(diff.removed.empty());
+
+	// Removing an item near the start means that almost every item has to be looked up by name.
+	current.erase(current.begin() + 1);
+	current.push_back({ L"New file.txt", 0, 0, 0x20 });
+	std::shuffle(current.begin() + 1, current.end(), std::mt19937(1));
+
+	startTime = std::chrono::steady_clock::now();
+	diff = DiffDirectorySnapshots(previous, current);
+	endTime = std::chrono::steady_clock::now();
+	RecordProperty("ShuffledMicroseconds",
+		static_cast<int>(
+			std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()));
+
+	std::sort(diff.modified.begin(), diff.modified.end());
+	std::sort(expectedModified.begin(), expectedModified.end());
+	EXPECT_EQ(diff.modified, expectedModified);
+	EXPECT_EQ(diff.added, (std::vector<std::wstring>{ L"New file.txt" }));
+	EXPECT_EQ(diff.removed, (std::vector<std::wstring>{ previous[1].name }));
+}
@@ -0,0 +1,156 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/DirectoryWatchRegistry.h"
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+namespace
+{
+
+void NoOpCallback(const std::wstring &, uint32_t)
+{
+}
+
+}
+
+class DirectoryWatchRegistryTest : public Test
+{
+protected:
+	struct StartedWatch
+	{
+		int watchId;
+		std::wstring path;
+		uint32_t watchFlags;
+		bool watchSubtree;
+	};
+
+	DirectoryWatchRegistryTest() :
+		m_registry(
+			[this](int watchId, const std::wstring &path, uint32_t watchFlags, bool watchSubtree)
+				-> std::optional<int>
+			{
+				if (m_failWatches)
+				{
+					return std::nullopt;
+				}
+
+				m_startedWatches.push_back({ watchId, path, watchFlags, watchSubtree });
+				return m_nextMonitorId++;
+			},
+			[this](int monitorId)
+			{
+				m_stoppedMonitorIds.push_back(monitorId);
+			})
+	{
+	}
+
+	std::vector<StartedWatch> m_startedWatches;
+	std::vector<int> m_stoppedMonitorIds;
+	bool m_failWatches = false;
+	int m_nextMonitorId = 100;
+
+	DirectoryWatchRegistry m_registry;
+};
+
+TEST_F(DirectoryWatchRegistryTest, SharedWatch)
+{
+	std::vector<std::wstring> firstNotifications;
+	std::vector<std::wstring> secondNotifications;
+
+	auto first = m_registry.Subscribe(L"C:\\Folder", 1, false,
+		[&firstNotifications](const std::wstring &fileName, uint32_t)
+		{
+			firstNotifications.push_back(fileName);
+		});
+	ASSERT_TRUE(first);
+
+	// The same directory, referred to slightly differently.
+	auto second = m_registry.Subscribe(L"c:\\folder\\", 1, false,
+		[&secondNotifications](const std::wstring &fileName, uint32_t)
+		{
+			secondNotifications.push_back(fileName);
+		});
+	ASSERT_TRUE(second);
+
+	ASSERT_EQ(m_startedWatches.size(), 1u);
+	EXPECT_EQ(m_startedWatches[0].path, L"C:\\Folder");
+	EXPECT_EQ(m_registry.GetNumWatches(), 1u);
+
+	m_registry.OnNotification(m_startedWatches[0].watchId, L"file.txt", 1);
+	EXPECT_EQ(firstNotifications, (std::vector<std::wstring>{ L"file.txt" }));
+	EXPECT_EQ(secondNotifications, (std::vector<std::wstring>{ L"file.txt" }));
+
+	// The watch should only be stopped once there are no subscribers left.
+	m_registry.Unsubscribe(*first);
+	EXPECT_TRUE(m_stoppedMonitorIds.empty());
+
+	m_registry.OnNotification(m_startedWatches[0].watchId, L"other.txt", 1);
+	EXPECT_EQ(firstNotifications, (std::vector<std::wstring>{ L"file.txt" }));
+	EXPECT_EQ(secondNotifications, (std::vector<std::wstring>{ L"file.txt", L"other.txt" }));
+
+	m_registry.Unsubscribe(*second);
+	EXPECT_EQ(m_stoppedMonitorIds, (std::vector<int>{ 100 }));
+	EXPECT_EQ(m_registry.GetNumWatches(), 0u);
+
+	// Notifications that arrive after the watch has been stopped should be ignored.
+	m_registry.OnNotification(m_startedWatches[0].watchId, L"late.txt", 1);
+	EXPECT_EQ(secondNotifications.size(), 2u);
+}
+
+TEST_F(DirectoryWatchRegistryTest, SeparateWatches)
+{
+	EXPECT_TRUE(m_registry.Subscribe(L"C:\\First", 1, false, NoOpCallback));
+	EXPECT_TRUE(m_registry.Subscribe(L"C:\\Second", 1, false, NoOpCallback));
+
+	// Watches that differ in their flags or subtree setting can't be shared.
+	EXPECT_TRUE(m_registry.Subscribe(L"C:\\First", 2, false, NoOpCallback));
+	EXPECT_TRUE(m_registry.Subscribe(L"C:\\First", 1, true, NoOpCallback));
+
+	// Root directories should keep their trailing separator.
+	EXPECT_TRUE(m_registry.Subscribe(L"C:\\", 1, true, NoOpCallback));
+
+	ASSERT_EQ(m_startedWatches.size(), 5u);
+	EXPECT_EQ(m_registry.GetNumWatches(), 5u);
+	EXPECT_EQ(m_startedWatches[3].watchSubtree, true);
+	EXPECT_EQ(m_startedWatches[4].path, L"C:\\");
+}
+
+TEST_F(DirectoryWatchRegistryTest, WatchFailure)
+{
+	m_failWatches = true;
+	EXPECT_FALSE(m_registry.Subscribe(L"C:\\Folder", 1, false, NoOpCallback));
+	EXPECT_EQ(m_registry.GetNumWatches(), 0u);
+
+	// A failed watch shouldn't prevent the directory from being watched later.
+	m_failWatches = false;
+	auto subscriptionId = m_registry.Subscribe(L"C:\\Folder", 1, false, NoOpCallback);
+	ASSERT_TRUE(subscriptionId);
+	EXPECT_EQ(m_registry.GetNumWatches(), 1u);
+
+	// Unknown subscriptions should be ignored.
+	m_registry.Unsubscribe(*subscriptionId + 1);
+	EXPECT_EQ(m_registry.GetNumWatches(), 1u);
+}
+
+TEST_F(DirectoryWatchRegistryTest, UnsubscribeFromCallback)
+{
+	std::optional<int> subscriptionId;
+	int numNotifications = 0;
+
+	subscriptionId = m_registry.Subscribe(L"C:\\Folder", 1, false,
+		[this, &subscriptionId, &numNotifications](const std::wstring &, uint32_t)
+		{
+			numNotifications++;
+			m_registry.Unsubscribe(*subscriptionId);
+		});
+	ASSERT_TRUE(subscriptionId);
+
+	m_registry.OnNotification(m_startedWatches[0].watchId, L"file.txt", 1);
+	m_registry.OnNotification(m_startedWatches[0].watchId, L"file.txt", 1);
+	EXPECT_EQ(numNotifications, 1);
+	EXPECT_EQ(m_registry.GetNumWatches(), 0u);
+}
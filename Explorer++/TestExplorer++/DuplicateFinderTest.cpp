@@ -0,0 +1,230 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/DuplicateFinder.h"
+#include "TempDirectoryHelper.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+
+using namespace testing;
+
+class DuplicateFinderTest : public TempDirectoryTest
+{
+protected:
+	using PathGroups = std::vector<std::vector<std::filesystem::path>>;
+
+	DuplicateFinder::Options BuildOptions()
+	{
+		DuplicateFinder::Options options;
+
+		// A small sample means that files only need to be a few KB in size to go through each of
+		// the hashing stages.
+		options.sampleSize = 1024;
+
+		return options;
+	}
+
+	static PathGroups GetPathGroups(const DuplicateFinder &finder,
+		const std::vector<DuplicateFinder::Group> &groups)
+	{
+		PathGroups pathGroups;
+
+		for (const auto &group : groups)
+		{
+			auto &paths = pathGroups.emplace_back();
+
+			for (auto file : group.files)
+			{
+				EXPECT_EQ(finder.GetSize(file), group.size);
+				paths.push_back(finder.GetPath(file));
+			}
+		}
+
+		return pathGroups;
+	}
+
+	// Creates a tree that contains several sets of duplicates, along with files that are
+	// eliminated at each stage.
+	void CreateTree()
+	{
+		// Only compared by size.
+		CreateTestFile(L"root/unique1.bin", GenerateTestData(100));
+		CreateTestFile(L"root/unique2.bin", GenerateTestData(101));
+
+		// Eliminated by the sample hash. These files are covered entirely by their samples, so
+		// they're not hashed again.
+		auto data = GenerateTestData(1500);
+		CreateTestFile(L"root/small1.bin", data);
+		CreateTestFile(L"root/a/small2.bin", data);
+		data[700]++;
+		CreateTestFile(L"root/b/small3.bin", data);
+
+		// These files only differ in the middle, so they have the same sample hash and are
+		// eliminated by the full hash.
+		data = GenerateTestData(10000);
+		CreateTestFile(L"root/a/large1.bin", data);
+		CreateTestFile(L"root/b/large2.bin", data);
+		CreateTestFile(L"root/b/c/large3.bin", data);
+		data[5000]++;
+		CreateTestFile(L"root/b/c/large4.bin", data);
+
+		// Empty files are ignored by default.
+		CreateTestFile(L"root/empty1.txt", {});
+		CreateTestFile(L"root/a/empty2.txt", {});
+	}
+
+	PathGroups GetExpectedGroups()
+	{
+		auto root = m_tempDirectory / L"root";
+
+		return { { root / L"a" / L"large1.bin", root / L"b" / L"c" / L"large3.bin",
+					 root / L"b" / L"large2.bin" },
+			{ root / L"a" / L"small2.bin", root / L"small1.bin" } };
+	}
+};
+
+TEST_F(DuplicateFinderTest, Find)
+{
+	CreateTree();
+
+	DuplicateFinder finder(BuildOptions());
+	auto groups = finder.Find({ m_tempDirectory / L"root" });
+	EXPECT_EQ(GetPathGroups(finder, groups), GetExpectedGroups());
+
+	auto progress = finder.GetProgress();
+	EXPECT_EQ(progress.stage, DuplicateFinder::Stage::Complete);
+	EXPECT_EQ(progress.filesFound, 11U);
+
+	// Only the four large files need to be hashed in full.
+	EXPECT_EQ(progress.filesHashed, 4U);
+	EXPECT_EQ(progress.filesToHash, 4U);
+
+	EXPECT_EQ(finder.GetNumErrors(), 0U);
+}
+
+TEST_F(DuplicateFinderTest, MultipleDirectories)
+{
+	CreateTree();
+	CreateTestFile(L"other/small4.bin", GenerateTestData(1500));
+
+	auto root = m_tempDirectory / L"root";
+	auto expectedGroups = GetExpectedGroups();
+	expectedGroups[1].insert(expectedGroups[1].begin(),
+		m_tempDirectory / L"other" / L"small4.bin");
+
+	// The nested directory (and the repeated root) should only be searched once.
+	DuplicateFinder finder(BuildOptions());
+	auto groups = finder.Find({ root / L"b", root, m_tempDirectory / L"other", root });
+	EXPECT_EQ(GetPathGroups(finder, groups), expectedGroups);
+	EXPECT_EQ(finder.GetProgress().filesFound, 12U);
+}
+
+TEST_F(DuplicateFinderTest, MinimumSize)
+{
+	CreateTree();
+
+	auto options = BuildOptions();
+	options.minimumSize = 0;
+
+	DuplicateFinder finder(options);
+	auto groups = finder.Find({ m_tempDirectory / L"root" });
+
+	auto root = m_tempDirectory / L"root";
+	auto expectedGroups = GetExpectedGroups();
+	expectedGroups.push_back({ root / L"a" / L"empty2.txt", root / L"empty1.txt" });
+	EXPECT_EQ(GetPathGroups(finder, groups), expectedGroups);
+
+	options.minimumSize = 2000;
+
+	DuplicateFinder largeFileFinder(options);
+	groups = largeFileFinder.Find({ m_tempDirectory / L"root" });
+	EXPECT_EQ(GetPathGroups(largeFileFinder, groups), PathGroups{ GetExpectedGroups()[0] });
+}
+
+TEST_F(DuplicateFinderTest, HardLinks)
+{
+	CreateTree();
+
+	auto root = m_tempDirectory / L"root";
+	std::error_code error;
+	std::filesystem::create_hard_link(root / L"unique1.bin", root / L"unique1_link.bin", error);
+
+	if (error)
+	{
+		GTEST_SKIP() << "Hard links can't be created";
+	}
+
+	std::filesystem::create_hard_link(root / L"a" / L"large1.bin", root / L"large1_link.bin",
+		error);
+	ASSERT_FALSE(error);
+
+	// A file shouldn't be reported as a duplicate of itself. Only the link to large1.bin with the
+	// lowest path should be included in its group.
+	DuplicateFinder finder(BuildOptions());
+	auto groups = finder.Find({ root });
+	EXPECT_EQ(GetPathGroups(finder, groups), GetExpectedGroups());
+}
+
+TEST_F(DuplicateFinderTest, MissingDirectory)
+{
+	DuplicateFinder finder(BuildOptions());
+	auto groups = finder.Find({ m_tempDirectory / L"missing" });
+	EXPECT_TRUE(groups.empty());
+	EXPECT_EQ(finder.GetNumErrors(), 1U);
+}
+
+TEST_F(DuplicateFinderTest, Cancel)
+{
+	CreateTree();
+
+	DuplicateFinder finder(BuildOptions());
+	finder.Cancel();
+	EXPECT_TRUE(finder.Find({ m_tempDirectory / L"root" }).empty());
+}
+
+// Runs the finder over progressively larger trees, in which one in every ten files has a
+// duplicate. The time taken for each tree is recorded in the test output.
+TEST_F(DuplicateFinderTest, Scaling)
+{
+	size_t numFiles = 0;
+
+	for (size_t targetNumFiles : { 1000, 4000, 16000 })
+	{
+		for (; numFiles < targetNumFiles; numFiles++)
+		{
+			auto directory = L"dir" + std::to_wstring(numFiles % 40) + L"/sub"
+				+ std::to_wstring(numFiles % 7);
+
+			// Every tenth file is given the same contents as the file before it. Otherwise, the
+			// files are split between a small number of sizes, so that they need to be hashed to
+			// be told apart.
+			auto id = static_cast<std::uint32_t>(numFiles % 10 == 1 ? numFiles - 1 : numFiles);
+			auto data = GenerateTestData(512 + id % 16);
+			std::memcpy(data.data(), &id, sizeof(id));
+
+			CreateTestFile(directory + L"/file" + std::to_wstring(numFiles), data);
+		}
+
+		DuplicateFinder finder(DuplicateFinder::Options{});
+
+		auto startTime = std::chrono::steady_clock::now();
+		auto groups = finder.Find({ m_tempDirectory });
+		auto endTime = std::chrono::steady_clock::now();
+
+		RecordProperty("Files" + std::to_string(numFiles) + "Milliseconds",
+			static_cast<int>(
+				std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime)
+					.count()));
+
+		EXPECT_EQ(finder.GetProgress().filesFound, numFiles);
+		EXPECT_EQ(groups.size(), numFiles / 10);
+
+		for (const auto &group : groups)
+		{
+			EXPECT_EQ(group.files.size(), 2U);
+		}
+	}
+}
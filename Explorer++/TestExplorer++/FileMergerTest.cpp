@@ -0,0 +1,342 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/FileMerger.h"
+#include "../Helper/ChecksumManifest.h"
+#include "../Helper/FileSplitter.h"
+#include "TempDirectoryHelper.h"
+#include <gtest/gtest.h>
+#include <wil/resource.h>
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+
+struct DataRegion
+{
+	ULONGLONG offset;
+	std::vector<BYTE> data;
+};
+
+// Creates a sparse file of the specified size. Only the specified regions are actually written,
+// so the file takes up very little space on disk, regardless of its logical size.
+void CreateSparseFile(const std::filesystem::path &path, ULONGLONG size,
+	const std::vector<DataRegion> &regions)
+{
+	wil::unique_hfile file(CreateFile(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+		CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr));
+	ASSERT_TRUE(file);
+
+	DWORD bytesReturned;
+	ASSERT_TRUE(DeviceIoControl(file.get(), FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0,
+		&bytesReturned, nullptr));
+
+	LARGE_INTEGER fileSize;
+	fileSize.QuadPart = size;
+	ASSERT_TRUE(SetFilePointerEx(file.get(), fileSize, nullptr, FILE_BEGIN));
+	ASSERT_TRUE(SetEndOfFile(file.get()));
+
+	for (const auto &region : regions)
+	{
+		LARGE_INTEGER offset;
+		offset.QuadPart = region.offset;
+		ASSERT_TRUE(SetFilePointerEx(file.get(), offset, nullptr, FILE_BEGIN));
+
+		DWORD numBytesWritten;
+		ASSERT_TRUE(WriteFile(file.get(), region.data.data(),
+			static_cast<DWORD>(region.data.size()), &numBytesWritten, nullptr));
+	}
+}
+
+std::vector<BYTE> ReadFileRegion(const std::filesystem::path &path, ULONGLONG offset, DWORD size)
+{
+	wil::unique_hfile file(CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+
+	if (!file)
+	{
+		return {};
+	}
+
+	LARGE_INTEGER position;
+	position.QuadPart = offset;
+
+	if (!SetFilePointerEx(file.get(), position, nullptr, FILE_BEGIN))
+	{
+		return {};
+	}
+
+	std::vector<BYTE> data(size);
+	DWORD numBytesRead;
+
+	if (!ReadFile(file.get(), data.data(), size, &numBytesRead, nullptr))
+	{
+		return {};
+	}
+
+	data.resize(numBytesRead);
+
+	return data;
+}
+
+}
+
+class FileMergerTest : public TempDirectoryTest
+{
+protected:
+	FileMerger::Options BuildOptions()
+	{
+		FileMerger::Options options;
+
+		// A small block size ensures that each file is read across multiple blocks.
+		options.blockSize = 1000;
+		options.numBuffers = 3;
+
+		return options;
+	}
+
+	std::vector<std::wstring> CreateParts(const std::vector<std::vector<BYTE>> &partData)
+	{
+		std::vector<std::wstring> paths;
+
+		for (size_t i = 0; i < partData.size(); i++)
+		{
+			paths.push_back(
+				CreateTestFile(L"file.bin.part" + std::to_wstring(i + 1), partData[i]).wstring());
+		}
+
+		return paths;
+	}
+
+	std::filesystem::path GetOutputPath()
+	{
+		return m_tempDirectory / L"file.bin";
+	}
+};
+
+TEST_F(FileMergerTest, Merge)
+{
+	auto part1 = GenerateTestData(4096);
+	auto part2 = GenerateTestData(0);
+	auto part3 = GenerateTestData(2500);
+	auto inputPaths = CreateParts({ part1, part2, part3 });
+
+	FileMerger merger(inputPaths, GetOutputPath(), BuildOptions());
+	EXPECT_EQ(merger.Merge(nullptr), FileMerger::Result::Succeeded);
+
+	std::vector<BYTE> expectedData = part1;
+	expectedData.insert(expectedData.end(), part3.begin(), part3.end());
+	EXPECT_EQ(ReadFileContents(GetOutputPath()), expectedData);
+}
+
+TEST_F(FileMergerTest, MergeWithoutPreallocation)
+{
+	auto part1 = GenerateTestData(3000);
+	auto part2 = GenerateTestData(10);
+	auto inputPaths = CreateParts({ part1, part2 });
+
+	auto options = BuildOptions();
+	options.preallocate = false;
+
+	FileMerger merger(inputPaths, GetOutputPath(), options);
+	EXPECT_EQ(merger.Merge(nullptr), FileMerger::Result::Succeeded);
+
+	std::vector<BYTE> expectedData = part1;
+	expectedData.insert(expectedData.end(), part2.begin(), part2.end());
+	EXPECT_EQ(ReadFileContents(GetOutputPath()), expectedData);
+}
+
+TEST_F(FileMergerTest, Progress)
+{
+	auto inputPaths = CreateParts({ GenerateTestData(2000), GenerateTestData(3000) });
+
+	std::vector<FileMerger::Progress> progressUpdates;
+
+	FileMerger merger(inputPaths, GetOutputPath(), BuildOptions());
+	auto result = merger.Merge(
+		[&progressUpdates](const FileMerger::Progress &progress)
+		{
+			progressUpdates.push_back(progress);
+		});
+	EXPECT_EQ(result, FileMerger::Result::Succeeded);
+
+	// An update is always sent once each file has been completed.
+	ASSERT_GE(progressUpdates.size(), 2U);
+
+	const auto &finalProgress = progressUpdates.back();
+	EXPECT_EQ(finalProgress.bytesProcessed, 5000U);
+	EXPECT_EQ(finalProgress.totalBytes, 5000U);
+	EXPECT_EQ(finalProgress.filesCompleted, 2U);
+	EXPECT_EQ(finalProgress.totalFiles, 2U);
+}
+
+TEST_F(FileMergerTest, SplitAndVerifiedMerge)
+{
+	auto data = GenerateTestData(10000);
+	auto originalPath = CreateTestFile(L"original.bin", data);
+	auto manifestPath = m_tempDirectory / L"original.bin.sha256";
+
+	FileSplitter::Options splitOptions;
+	splitOptions.partSize = 3000;
+	splitOptions.manifestPath = manifestPath.wstring();
+
+	std::vector<std::wstring> partPaths;
+
+	FileSplitter splitter(
+		originalPath,
+		[this, &partPaths](ULONGLONG partNumber)
+		{
+			auto path = m_tempDirectory / (L"original.bin.part" + std::to_wstring(partNumber));
+			partPaths.push_back(path.wstring());
+			return path.wstring();
+		},
+		splitOptions);
+	ASSERT_EQ(splitter.Split(nullptr), FileSplitter::Result::Succeeded);
+	ASSERT_EQ(partPaths.size(), 4U);
+
+	auto options = BuildOptions();
+	options.manifestPath = manifestPath.wstring();
+
+	FileMerger merger(partPaths, GetOutputPath(), options);
+	EXPECT_EQ(merger.Merge(nullptr), FileMerger::Result::Succeeded);
+	EXPECT_EQ(ReadFileContents(GetOutputPath()), data);
+}
+
+TEST_F(FileMergerTest, VerificationFailure)
+{
+	auto part1 = GenerateTestData(2000);
+	auto part2 = GenerateTestData(1500);
+	auto inputPaths = CreateParts({ part1, part2 });
+
+	std::string incorrectChecksum(64, '0');
+	auto manifestPath = m_tempDirectory / L"file.bin.sha256";
+	ASSERT_TRUE(ChecksumManifest::Write(manifestPath,
+		{ { L"file.bin.part1", incorrectChecksum }, { L"file.bin.part2", incorrectChecksum } }));
+
+	auto options = BuildOptions();
+	options.manifestPath = manifestPath.wstring();
+
+	FileMerger merger(inputPaths, GetOutputPath(), options);
+	EXPECT_EQ(merger.Merge(nullptr), FileMerger::Result::VerificationFailed);
+	EXPECT_EQ(merger.GetFailedFileIndex(), 0U);
+
+	// The output file shouldn't be left behind if it doesn't match the manifest.
+	EXPECT_FALSE(std::filesystem::exists(GetOutputPath()));
+}
+
+TEST_F(FileMergerTest, FileMissingFromManifest)
+{
+	auto inputPaths = CreateParts({ GenerateTestData(100), GenerateTestData(200) });
+
+	// Only the first file is listed in the manifest.
+	auto manifestPath = m_tempDirectory / L"file.bin.sha256";
+	ASSERT_TRUE(ChecksumManifest::Write(manifestPath,
+		{ { L"file.bin.part1", std::string(64, '0') } }));
+
+	auto options = BuildOptions();
+	options.manifestPath = manifestPath.wstring();
+
+	FileMerger merger(inputPaths, GetOutputPath(), options);
+	EXPECT_EQ(merger.Merge(nullptr), FileMerger::Result::VerificationFailed);
+	EXPECT_EQ(merger.GetFailedFileIndex(), 1U);
+	EXPECT_FALSE(std::filesystem::exists(GetOutputPath()));
+}
+
+TEST_F(FileMergerTest, MissingInputFile)
+{
+	auto inputPaths = CreateParts({ GenerateTestData(100) });
+	inputPaths.push_back((m_tempDirectory / L"missing.bin").wstring());
+
+	FileMerger merger(inputPaths, GetOutputPath(), BuildOptions());
+	EXPECT_EQ(merger.Merge(nullptr), FileMerger::Result::InputFileError);
+	EXPECT_EQ(merger.GetFailedFileIndex(), 1U);
+	EXPECT_FALSE(std::filesystem::exists(GetOutputPath()));
+}
+
+TEST_F(FileMergerTest, ExistingOutputFileNotOverwritten)
+{
+	auto inputPaths = CreateParts({ GenerateTestData(100) });
+	auto existingData = GenerateTestData(20);
+	CreateTestFile(L"file.bin", existingData);
+
+	FileMerger merger(inputPaths, GetOutputPath(), BuildOptions());
+	EXPECT_EQ(merger.Merge(nullptr), FileMerger::Result::OutputFileError);
+	EXPECT_EQ(ReadFileContents(GetOutputPath()), existingData);
+}
+
+TEST_F(FileMergerTest, Cancel)
+{
+	auto inputPaths = CreateParts({ GenerateTestData(5000) });
+
+	FileMerger merger(inputPaths, GetOutputPath(), BuildOptions());
+	merger.Cancel();
+
+	EXPECT_EQ(merger.Merge(nullptr), FileMerger::Result::Cancelled);
+	EXPECT_FALSE(std::filesystem::exists(GetOutputPath()));
+}
+
+// Merges a set of parts using the default options. The throughput is recorded in the test output.
+TEST_F(FileMergerTest, MergeThroughput)
+{
+	const size_t NUM_PARTS = 8;
+	const size_t PART_SIZE = 16 * 1024 * 1024;
+
+	std::vector<std::vector<BYTE>> partData(NUM_PARTS, GenerateTestData(PART_SIZE));
+	auto inputPaths = CreateParts(partData);
+
+	FileMerger merger(inputPaths, GetOutputPath(), FileMerger::Options());
+
+	auto startTime = std::chrono::steady_clock::now();
+	ASSERT_EQ(merger.Merge(nullptr), FileMerger::Result::Succeeded);
+	auto endTime = std::chrono::steady_clock::now();
+
+	auto milliseconds = std::max<long long>(
+		std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count(), 1);
+	RecordProperty("MegabytesPerSecond",
+		static_cast<int>((NUM_PARTS * PART_SIZE / (1024 * 1024)) * 1000 / milliseconds));
+
+	EXPECT_EQ(std::filesystem::file_size(GetOutputPath()), NUM_PARTS * PART_SIZE);
+}
+
+// The input here is sparse, so takes up very little space. The output isn't, however, so this
+// test needs a little over 4GB of free space.
+TEST_F(FileMergerTest, MergeLargerThan4GB)
+{
+	const ULONGLONG fourGB = 4ULL * 1024 * 1024 * 1024;
+	const ULONGLONG part1Size = fourGB + 4096;
+
+	ULARGE_INTEGER freeBytes;
+	ASSERT_TRUE(GetDiskFreeSpaceEx(m_tempDirectory.c_str(), &freeBytes, nullptr, nullptr));
+
+	if (freeBytes.QuadPart < part1Size + (512 * 1024 * 1024))
+	{
+		GTEST_SKIP() << "Not enough free space for the merged output file";
+	}
+
+	auto startMarker = GenerateTestData(100);
+	auto boundaryMarker = GenerateTestData(200);
+	auto endMarker = GenerateTestData(300);
+
+	// The boundary marker straddles the 4GB mark, which is where truncation would previously have
+	// occurred.
+	auto part1Path = m_tempDirectory / L"file.bin.part1";
+	CreateSparseFile(part1Path, part1Size,
+		{ { 0, startMarker }, { fourGB - 100, boundaryMarker },
+			{ part1Size - endMarker.size(), endMarker } });
+
+	auto part2Data = GenerateTestData(5000);
+	auto part2Path = CreateTestFile(L"file.bin.part2", part2Data);
+
+	FileMerger::Options options;
+	FileMerger merger({ part1Path.wstring(), part2Path.wstring() }, GetOutputPath(), options);
+	ASSERT_EQ(merger.Merge(nullptr), FileMerger::Result::Succeeded);
+
+	EXPECT_EQ(std::filesystem::file_size(GetOutputPath()), part1Size + part2Data.size());
+	EXPECT_EQ(ReadFileRegion(GetOutputPath(), 0, 100), startMarker);
+	EXPECT_EQ(ReadFileRegion(GetOutputPath(), fourGB - 100, 200), boundaryMarker);
+	EXPECT_EQ(ReadFileRegion(GetOutputPath(), part1Size - endMarker.size(), 300), endMarker);
+	EXPECT_EQ(ReadFileRegion(GetOutputPath(), part1Size, 5000), part2Data);
+}
@@ -0,0 +1,216 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/FileShredder.h"
+#include "TempDirectoryHelper.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+class FileShredderTest : public TempDirectoryTest
+{
+protected:
+	FileShredder::Options BuildOptions(NFileOperations::OverwriteMethod overwriteMethod,
+		bool unbuffered)
+	{
+		FileShredder::Options options;
+		options.overwriteMethod = overwriteMethod;
+		options.unbuffered = unbuffered;
+
+		// A small block size ensures that files are written across multiple blocks.
+		options.blockSize = 4096;
+
+		return options;
+	}
+};
+
+TEST_F(FileShredderTest, OnePassOverwritesEveryByte)
+{
+	for (bool unbuffered : { false, true })
+	{
+		auto originalData = GenerateTestData(100 * 1024 + 123);
+		auto path = CreateTestFile(L"file.bin", originalData);
+
+		FileShredder shredder(BuildOptions(NFileOperations::OverwriteMethod::OnePass, unbuffered));
+		ASSERT_TRUE(shredder.OverwriteFile(path));
+
+		auto overwrittenData = ReadFileContents(path);
+
+		// The file will have been extended to the end of its final cluster.
+		ASSERT_GE(overwrittenData.size(), originalData.size());
+		EXPECT_TRUE(std::all_of(overwrittenData.begin(), overwrittenData.end(),
+			[](BYTE byte)
+			{
+				return byte == 0x00;
+			}));
+	}
+}
+
+TEST_F(FileShredderTest, ThreePassOverwritesEveryByte)
+{
+	auto originalData = GenerateTestData(64 * 1024);
+	auto path = CreateTestFile(L"file.bin", originalData);
+
+	FileShredder shredder(BuildOptions(NFileOperations::OverwriteMethod::ThreePass, true));
+	ASSERT_TRUE(shredder.OverwriteFile(path));
+
+	auto overwrittenData = ReadFileContents(path);
+	ASSERT_GE(overwrittenData.size(), originalData.size());
+
+	// The final pass writes random data, so the contents can't be predicted. However, the original
+	// data shouldn't remain in any meaningful amount and the data shouldn't be all 0x00 or all 0xFF
+	// (which would indicate the random pass was skipped).
+	size_t numMatchingBytes = 0;
+
+	for (size_t i = 0; i < originalData.size(); i++)
+	{
+		if (overwrittenData[i] == originalData[i])
+		{
+			numMatchingBytes++;
+		}
+	}
+
+	// Roughly 1 in 256 bytes would be expected to match by chance.
+	EXPECT_LT(numMatchingBytes, originalData.size() / 64);
+	EXPECT_FALSE(std::all_of(overwrittenData.begin(), overwrittenData.end(),
+		[](BYTE byte)
+		{
+			return byte == 0x00;
+		}));
+	EXPECT_FALSE(std::all_of(overwrittenData.begin(), overwrittenData.end(),
+		[](BYTE byte)
+		{
+			return byte == 0xFF;
+		}));
+}
+
+TEST_F(FileShredderTest, ShredFile)
+{
+	auto path = CreateTestFile(L"file.bin", GenerateTestData(10000));
+
+	FileShredder shredder(BuildOptions(NFileOperations::OverwriteMethod::OnePass, true));
+	EXPECT_TRUE(shredder.ShredFile(path));
+	EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST_F(FileShredderTest, ShredEmptyFile)
+{
+	auto path = CreateTestFile(L"empty.bin", {});
+
+	FileShredder shredder(BuildOptions(NFileOperations::OverwriteMethod::OnePass, true));
+	EXPECT_TRUE(shredder.ShredFile(path));
+	EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST_F(FileShredderTest, ShredFolderRecursively)
+{
+	CreateTestFile(L"folder\\file1.bin", GenerateTestData(5000));
+	CreateTestFile(L"folder\\file2.bin", GenerateTestData(70000));
+	CreateTestFile(L"folder\\sub1\\file3.bin", GenerateTestData(1));
+	CreateTestFile(L"folder\\sub1\\sub2\\file4.bin", GenerateTestData(300000));
+	std::filesystem::create_directories(m_tempDirectory / L"folder\\empty");
+	auto separateFile = CreateTestFile(L"separate.bin", GenerateTestData(1234));
+
+	auto options = BuildOptions(NFileOperations::OverwriteMethod::ThreePass, true);
+	options.maxParallelFiles = 3;
+	FileShredder shredder(options);
+
+	std::vector<FileShredder::Progress> progressUpdates;
+	std::mutex mutex;
+
+	bool res = shredder.ShredItems({ m_tempDirectory / L"folder", separateFile },
+		[&progressUpdates, &mutex](const FileShredder::Progress &progress)
+		{
+			std::scoped_lock lock(mutex);
+			progressUpdates.push_back(progress);
+		});
+	EXPECT_TRUE(res);
+
+	EXPECT_FALSE(std::filesystem::exists(m_tempDirectory / L"folder"));
+	EXPECT_FALSE(std::filesystem::exists(separateFile));
+
+	ASSERT_FALSE(progressUpdates.empty());
+
+	auto maxProgress = std::max_element(progressUpdates.begin(), progressUpdates.end(),
+		[](const auto &first, const auto &second)
+		{
+			return first.bytesWritten < second.bytesWritten;
+		});
+	EXPECT_EQ(maxProgress->totalFiles, 5);
+	EXPECT_EQ(maxProgress->bytesWritten, maxProgress->totalBytes);
+}
+
+TEST_F(FileShredderTest, LinksNotFollowed)
+{
+	auto targetFile = CreateTestFile(L"target.bin", GenerateTestData(5000));
+	std::filesystem::create_directories(m_tempDirectory / L"folder");
+	auto link = m_tempDirectory / L"folder\\link.bin";
+
+	// Creating a symbolic link requires either developer mode or an elevated process.
+	std::error_code error;
+	std::filesystem::create_symlink(targetFile, link, error);
+
+	if (error)
+	{
+		GTEST_SKIP() << "Symbolic links can't be created";
+	}
+
+	FileShredder shredder(BuildOptions(NFileOperations::OverwriteMethod::OnePass, true));
+	EXPECT_TRUE(shredder.ShredItems({ m_tempDirectory / L"folder" }, nullptr));
+
+	// The link should be removed, but the file it points to should be left untouched.
+	EXPECT_FALSE(std::filesystem::exists(m_tempDirectory / L"folder"));
+	EXPECT_EQ(ReadFileContents(targetFile), GenerateTestData(5000));
+
+	std::filesystem::create_directories(m_tempDirectory / L"folder");
+	std::filesystem::create_symlink(targetFile, link, error);
+	ASSERT_FALSE(error);
+
+	EXPECT_FALSE(shredder.OverwriteFile(link));
+	EXPECT_TRUE(shredder.ShredFile(link));
+	EXPECT_FALSE(std::filesystem::exists(std::filesystem::symlink_status(link)));
+	EXPECT_EQ(ReadFileContents(targetFile), GenerateTestData(5000));
+}
+
+TEST_F(FileShredderTest, Cancel)
+{
+	auto path = CreateTestFile(L"file.bin", GenerateTestData(200000));
+
+	FileShredder shredder(BuildOptions(NFileOperations::OverwriteMethod::OnePass, true));
+	shredder.Cancel();
+
+	EXPECT_FALSE(shredder.ShredItems({ path }, nullptr));
+
+	// The file shouldn't be touched if the operation was cancelled before it started.
+	EXPECT_TRUE(std::filesystem::exists(path));
+	EXPECT_EQ(ReadFileContents(path), GenerateTestData(200000));
+}
+
+// Overwrites a large file using the default block size, both with and without the system cache.
+// The throughput of each is recorded in the test output.
+TEST_F(FileShredderTest, OverwriteThroughput)
+{
+	const size_t FILE_SIZE = 64 * 1024 * 1024;
+
+	auto path = CreateTestFile(L"file.bin", GenerateTestData(FILE_SIZE));
+
+	for (bool unbuffered : { false, true })
+	{
+		FileShredder::Options options;
+		options.overwriteMethod = NFileOperations::OverwriteMethod::OnePass;
+		options.unbuffered = unbuffered;
+		FileShredder shredder(options);
+
+		auto startTime = std::chrono::steady_clock::now();
+		ASSERT_TRUE(shredder.OverwriteFile(path));
+		auto endTime = std::chrono::steady_clock::now();
+
+		auto milliseconds = std::max<long long>(
+			std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count(), 1);
+		RecordProperty(unbuffered ? "UnbufferedMegabytesPerSecond" : "BufferedMegabytesPerSecond",
+			static_cast<int>((FILE_SIZE / (1024 * 1024)) * 1000 / milliseconds));
+	}
+}
@@ -0,0 +1,203 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/FileSplitter.h"
+#include "../Helper/ChecksumManifest.h"
+#include "../Helper/Sha256Hasher.h"
+#include "TempDirectoryHelper.h"
+#include <gtest/gtest.h>
+
+class FileSplitterTest : public TempDirectoryTest
+{
+protected:
+	FileSplitter::PartPathGenerator BuildPartPathGenerator()
+	{
+		return [this](ULONGLONG partNumber)
+		{
+			return (m_tempDirectory / (L"file.bin.part" + std::to_wstring(partNumber))).wstring();
+		};
+	}
+
+	FileSplitter::Options BuildOptions(ULONGLONG partSize)
+	{
+		FileSplitter::Options options;
+		options.partSize = partSize;
+
+		// Using a block size that doesn't evenly divide the part size ensures that blocks will
+		// need to be split across parts.
+		options.blockSize = 1000;
+		options.numBuffers = 3;
+
+		return options;
+	}
+
+	std::vector<BYTE> ReadPart(ULONGLONG partNumber)
+	{
+		return ReadFileContents(BuildPartPathGenerator()(partNumber));
+	}
+};
+
+TEST_F(FileSplitterTest, Split)
+{
+	auto data = GenerateTestData(10 * 4096 + 17);
+	auto inputPath = CreateTestFile(L"file.bin", data);
+
+	FileSplitter splitter(inputPath, BuildPartPathGenerator(), BuildOptions(4096));
+	EXPECT_EQ(splitter.Split(nullptr), FileSplitter::Result::Succeeded);
+
+	std::vector<BYTE> combinedData;
+
+	for (ULONGLONG i = 1; i <= 11; i++)
+	{
+		auto part = ReadPart(i);
+		EXPECT_EQ(part.size(), (i == 11) ? 17U : 4096U);
+		combinedData.insert(combinedData.end(), part.begin(), part.end());
+	}
+
+	EXPECT_FALSE(std::filesystem::exists(BuildPartPathGenerator()(12)));
+	EXPECT_EQ(combinedData, data);
+}
+
+TEST_F(FileSplitterTest, PartSizeLargerThanFile)
+{
+	auto data = GenerateTestData(5000);
+	auto inputPath = CreateTestFile(L"file.bin", data);
+
+	FileSplitter splitter(inputPath, BuildPartPathGenerator(), BuildOptions(1024 * 1024));
+	EXPECT_EQ(splitter.Split(nullptr), FileSplitter::Result::Succeeded);
+
+	EXPECT_EQ(ReadPart(1), data);
+	EXPECT_FALSE(std::filesystem::exists(BuildPartPathGenerator()(2)));
+}
+
+TEST_F(FileSplitterTest, Progress)
+{
+	auto inputPath = CreateTestFile(L"file.bin", GenerateTestData(3 * 2000));
+
+	std::vector<FileSplitter::Progress> progressUpdates;
+
+	FileSplitter splitter(inputPath, BuildPartPathGenerator(), BuildOptions(2000));
+	auto result = splitter.Split(
+		[&progressUpdates](const FileSplitter::Progress &progress)
+		{
+			progressUpdates.push_back(progress);
+		});
+	EXPECT_EQ(result, FileSplitter::Result::Succeeded);
+
+	// An update is always sent once each part is completed, as well as once the split has
+	// finished.
+	ASSERT_GE(progressUpdates.size(), 4U);
+
+	const auto &finalProgress = progressUpdates.back();
+	EXPECT_EQ(finalProgress.bytesProcessed, 6000U);
+	EXPECT_EQ(finalProgress.totalBytes, 6000U);
+	EXPECT_EQ(finalProgress.partsCompleted, 3U);
+	EXPECT_EQ(finalProgress.totalParts, 3U);
+}
+
+TEST_F(FileSplitterTest, Manifest)
+{
+	auto data = GenerateTestData(2500);
+	auto inputPath = CreateTestFile(L"file.bin", data);
+	auto manifestPath =
+		m_tempDirectory / (L"file.bin" + std::wstring(ChecksumManifest::FILE_EXTENSION));
+
+	auto options = BuildOptions(1024);
+	options.manifestPath = manifestPath.wstring();
+
+	FileSplitter splitter(inputPath, BuildPartPathGenerator(), options);
+	EXPECT_EQ(splitter.Split(nullptr), FileSplitter::Result::Succeeded);
+
+	auto entries = ChecksumManifest::Read(manifestPath);
+	ASSERT_TRUE(entries.has_value());
+	ASSERT_EQ(entries->size(), 3U);
+
+	Sha256Hasher hasher;
+
+	for (size_t i = 0; i < entries->size(); i++)
+	{
+		EXPECT_EQ((*entries)[i].filename, L"file.bin.part" + std::to_wstring(i + 1));
+
+		auto part = ReadPart(i + 1);
+		ASSERT_TRUE(hasher.Update(part.data(), part.size()));
+		EXPECT_EQ((*entries)[i].checksum, hasher.Finish());
+	}
+}
+
+TEST_F(FileSplitterTest, ExistingPartNotOverwritten)
+{
+	auto inputPath = CreateTestFile(L"file.bin", GenerateTestData(3000));
+	auto existingData = GenerateTestData(10);
+	CreateTestFile(L"file.bin.part2", existingData);
+
+	FileSplitter splitter(inputPath, BuildPartPathGenerator(), BuildOptions(1024));
+	EXPECT_EQ(splitter.Split(nullptr), FileSplitter::Result::OutputFileError);
+
+	// The part that was created should have been removed, while the existing part should have
+	// been left untouched.
+	EXPECT_FALSE(std::filesystem::exists(BuildPartPathGenerator()(1)));
+	EXPECT_EQ(ReadPart(2), existingData);
+}
+
+TEST_F(FileSplitterTest, MissingInputFile)
+{
+	FileSplitter splitter(m_tempDirectory / L"missing.bin", BuildPartPathGenerator(),
+		BuildOptions(1024));
+	EXPECT_EQ(splitter.Split(nullptr), FileSplitter::Result::InputFileError);
+}
+
+TEST_F(FileSplitterTest, EmptyInputFile)
+{
+	auto inputPath = CreateTestFile(L"file.bin", {});
+
+	FileSplitter splitter(inputPath, BuildPartPathGenerator(), BuildOptions(1024));
+	EXPECT_EQ(splitter.Split(nullptr), FileSplitter::Result::InputFileEmpty);
+	EXPECT_FALSE(std::filesystem::exists(BuildPartPathGenerator()(1)));
+}
+
+TEST_F(FileSplitterTest, Cancel)
+{
+	auto inputPath = CreateTestFile(L"file.bin", GenerateTestData(10000));
+
+	FileSplitter splitter(inputPath, BuildPartPathGenerator(), BuildOptions(1024));
+	splitter.Cancel();
+
+	EXPECT_EQ(splitter.Split(nullptr), FileSplitter::Result::Cancelled);
+	EXPECT_FALSE(std::filesystem::exists(BuildPartPathGenerator()(1)));
+}
+
+TEST_F(FileSplitterTest, CancelAfterFirstPart)
+{
+	auto inputPath = CreateTestFile(L"file.bin", GenerateTestData(10000));
+
+	FileSplitter splitter(inputPath, BuildPartPathGenerator(), BuildOptions(1024));
+	auto result = splitter.Split(
+		[&splitter](const FileSplitter::Progress &progress)
+		{
+			if (progress.partsCompleted == 1)
+			{
+				splitter.Cancel();
+			}
+		});
+	EXPECT_EQ(result, FileSplitter::Result::Cancelled);
+
+	// Any parts that had been written should have been removed.
+	for (ULONGLONG i = 1; i <= 3; i++)
+	{
+		EXPECT_FALSE(std::filesystem::exists(BuildPartPathGenerator()(i)));
+	}
+}
+
+TEST(FileSplitterNumPartsTest, CalculateNumParts)
+{
+	EXPECT_EQ(FileSplitter::CalculateNumParts(0, 100), 0U);
+	EXPECT_EQ(FileSplitter::CalculateNumParts(1, 100), 1U);
+	EXPECT_EQ(FileSplitter::CalculateNumParts(100, 100), 1U);
+	EXPECT_EQ(FileSplitter::CalculateNumParts(101, 100), 2U);
+
+	// Part sizes of 4GB and above should be supported.
+	ULONGLONG fourGB = 4ULL * 1024 * 1024 * 1024;
+	EXPECT_EQ(FileSplitter::CalculateNumParts(10 * fourGB + 1, fourGB), 11U);
+}
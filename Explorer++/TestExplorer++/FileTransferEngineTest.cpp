@@ -0,0 +1,481 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/FileTransferEngine.h"
+#include "TempDirectoryHelper.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <fstream>
+#include <map>
+
+using namespace testing;
+
+class FileTransferEngineTest : public TempDirectoryTest
+{
+protected:
+	// Maps each item's path (relative to the root) to its contents. Directories have no contents.
+	using TreeContents = std::map<std::filesystem::path, std::optional<std::vector<std::uint8_t>>>;
+
+	FileTransferEngine::Options BuildOptions(FileTransferEngine::Operation operation)
+	{
+		FileTransferEngine::Options options;
+		options.operation = operation;
+
+		// Small values ensure that large files are streamed across several blocks, with the final
+		// block being partially filled.
+		options.largeFileThreshold = 64 * 1024;
+		options.largeFileBlockSize = 10000;
+
+		return options;
+	}
+
+	// Creates a tree containing nested directories, an empty directory, an empty file and files
+	// on either side of the large file threshold.
+	std::filesystem::path CreateTree(const std::wstring &name)
+	{
+		std::filesystem::path root(name);
+
+		CreateTestFile((root / L"empty.txt").wstring(), {});
+		CreateTestFile((root / L"small.bin").wstring(), GenerateTestData(1000));
+		CreateTestFile((root / L"large.bin").wstring(), GenerateTestData(300 * 1024 + 7));
+
+		for (int i = 0; i < 5; i++)
+		{
+			auto directory = root / (L"dir" + std::to_wstring(i));
+
+			for (int j = 0; j < 10; j++)
+			{
+				CreateTestFile((directory / (L"file" + std::to_wstring(j))).wstring(),
+					GenerateTestData(i * 100 + j));
+			}
+
+			CreateTestFile((directory / L"nested" / L"large.bin").wstring(),
+				GenerateTestData(128 * 1024 + i));
+		}
+
+		std::filesystem::create_directories(m_tempDirectory / root / L"emptyDirectory");
+
+		return m_tempDirectory / root;
+	}
+
+	static TreeContents ReadTree(const std::filesystem::path &root)
+	{
+		TreeContents contents;
+
+		for (const auto &entry : std::filesystem::recursive_directory_iterator(root))
+		{
+			auto relativePath = entry.path().lexically_relative(root);
+
+			if (entry.is_directory())
+			{
+				contents[relativePath] = std::nullopt;
+			}
+			else
+			{
+				contents[relativePath] = ReadFileContents(entry.path());
+			}
+		}
+
+		return contents;
+	}
+
+	std::filesystem::path CreateDestination()
+	{
+		auto destination = m_tempDirectory / L"destination";
+		std::filesystem::create_directory(destination);
+		return destination;
+	}
+
+	static void ExpectComplete(const FileTransferEngine &engine)
+	{
+		auto progress = engine.GetProgress();
+		EXPECT_EQ(progress.transferredBytes, progress.totalBytes);
+		EXPECT_EQ(progress.completedFiles, progress.totalFiles);
+		EXPECT_EQ(progress.estimatedTimeRemaining.value_or(std::chrono::seconds(0)),
+			std::chrono::seconds(0));
+		EXPECT_TRUE(engine.GetErrors().empty());
+	}
+};
+
+TEST_F(FileTransferEngineTest, Copy)
+{
+	auto source = CreateTree(L"source");
+	auto destination = CreateDestination();
+
+	FileTransferEngine engine(BuildOptions(FileTransferEngine::Operation::Copy));
+	auto plan = engine.BuildPlan({ source }, destination);
+	ASSERT_TRUE(plan);
+	EXPECT_TRUE(plan->errors.empty());
+	EXPECT_EQ(plan->files.size(), 58U);
+
+	EXPECT_TRUE(engine.Run(*plan));
+	ExpectComplete(engine);
+
+	EXPECT_EQ(ReadTree(destination / L"source"), ReadTree(source));
+
+	// The modification times are copied as well.
+	EXPECT_EQ(std::filesystem::last_write_time(destination / L"source" / L"large.bin"),
+		std::filesystem::last_write_time(source / L"large.bin"));
+}
+
+TEST_F(FileTransferEngineTest, CopyFiles)
+{
+	auto smallFile = CreateTestFile(L"small.bin", GenerateTestData(10));
+	auto largeFile = CreateTestFile(L"large.bin", GenerateTestData(100 * 1024));
+	auto destination = CreateDestination();
+
+	FileTransferEngine engine(BuildOptions(FileTransferEngine::Operation::Copy));
+	auto plan = engine.BuildPlan({ smallFile, largeFile }, destination);
+	ASSERT_TRUE(plan);
+	EXPECT_TRUE(engine.Run(*plan));
+	ExpectComplete(engine);
+
+	EXPECT_EQ(ReadFileContents(destination / L"small.bin"), GenerateTestData(10));
+	EXPECT_EQ(ReadFileContents(destination / L"large.bin"), GenerateTestData(100 * 1024));
+}
+
+TEST_F(FileTransferEngineTest, Move)
+{
+	auto source = CreateTree(L"source");
+	auto originalContents = ReadTree(source);
+	auto destination = CreateDestination();
+
+	FileTransferEngine engine(BuildOptions(FileTransferEngine::Operation::Move));
+	auto plan = engine.BuildPlan({ source }, destination);
+	ASSERT_TRUE(plan);
+	EXPECT_TRUE(engine.Run(*plan));
+	ExpectComplete(engine);
+
+	EXPECT_EQ(ReadTree(destination / L"source"), originalContents);
+	EXPECT_FALSE(std::filesystem::exists(source));
+}
+
+TEST_F(FileTransferEngineTest, MoveIntoExistingDirectory)
+{
+	auto source = CreateTree(L"source");
+	auto originalContents = ReadTree(source);
+	auto destination = CreateDestination();
+
+	// Since the destination directory already exists, the source directory can't simply be
+	// renamed. Its contents will be merged into the existing directory instead.
+	auto existingFile = CreateTestFile(L"destination/source/existing.txt", GenerateTestData(5));
+
+	FileTransferEngine engine(BuildOptions(FileTransferEngine::Operation::Move));
+	auto plan = engine.BuildPlan({ source }, destination);
+	ASSERT_TRUE(plan);
+	EXPECT_TRUE(engine.Run(*plan));
+	ExpectComplete(engine);
+
+	auto destinationContents = ReadTree(destination / L"source");
+	EXPECT_EQ(destinationContents.erase(L"existing.txt"), 1U);
+	EXPECT_EQ(destinationContents, originalContents);
+	EXPECT_FALSE(std::filesystem::exists(source));
+}
+
+TEST_F(FileTransferEngineTest, ExistingFilesAreNotOverwritten)
+{
+	auto source = CreateTree(L"source");
+	auto destination = CreateDestination();
+	auto existingFile = CreateTestFile(L"destination/source/small.bin", GenerateTestData(5));
+
+	FileTransferEngine engine(BuildOptions(FileTransferEngine::Operation::Copy));
+	auto plan = engine.BuildPlan({ source }, destination);
+	ASSERT_TRUE(plan);
+	EXPECT_FALSE(engine.Run(*plan));
+
+	auto errors = engine.GetErrors();
+	ASSERT_EQ(errors.size(), 1U);
+	EXPECT_EQ(errors[0].path, existingFile);
+	EXPECT_EQ(errors[0].error, std::errc::file_exists);
+
+	EXPECT_EQ(ReadFileContents(existingFile), GenerateTestData(5));
+
+	// The rest of the transfer should still have been performed.
+	EXPECT_EQ(engine.GetProgress().completedFiles, plan->files.size() - 1);
+	EXPECT_EQ(ReadFileContents(destination / L"source" / L"large.bin"),
+		ReadFileContents(source / L"large.bin"));
+}
+
+TEST_F(FileTransferEngineTest, CountConflicts)
+{
+	auto source = CreateTree(L"source");
+	auto destination = CreateDestination();
+
+	FileTransferEngine engine(BuildOptions(FileTransferEngine::Operation::Copy));
+	auto plan = engine.BuildPlan({ source }, destination);
+	ASSERT_TRUE(plan);
+	EXPECT_EQ(engine.CountConflicts(*plan), 0U);
+
+	CreateTestFile(L"destination/source/small.bin", GenerateTestData(5));
+	CreateTestFile(L"destination/source/dir1/file2", GenerateTestData(5));
+	EXPECT_EQ(engine.CountConflicts(*plan), 2U);
+}
+
+TEST_F(FileTransferEngineTest, ExistingFilesSkipped)
+{
+	auto source = CreateTree(L"source");
+	auto destination = CreateDestination();
+	auto existingFile = CreateTestFile(L"destination/source/small.bin", GenerateTestData(5));
+
+	auto options = BuildOptions(FileTransferEngine::Operation::Move);
+	options.conflictAction = FileTransferEngine::ConflictAction::Skip;
+
+	FileTransferEngine engine(options);
+	auto plan = engine.BuildPlan({ source }, destination);
+	ASSERT_TRUE(plan);
+	EXPECT_TRUE(engine.Run(*plan));
+	ExpectComplete(engine);
+
+	// The skipped file should have been left in place at both the source and destination.
+	EXPECT_EQ(ReadFileContents(existingFile), GenerateTestData(5));
+	EXPECT_TRUE(std::filesystem::exists(source / L"small.bin"));
+	EXPECT_FALSE(std::filesystem::exists(source / L"large.bin"));
+}
+
+TEST_F(FileTransferEngineTest, ExistingFilesOverwritten)
+{
+	auto source = CreateTree(L"source");
+	auto destination = CreateDestination();
+	CreateTestFile(L"destination/source/small.bin", GenerateTestData(5));
+	CreateTestFile(L"destination/source/large.bin", GenerateTestData(5));
+
+	auto originalContents = ReadTree(source);
+
+	auto options = BuildOptions(FileTransferEngine::Operation::Copy);
+	options.conflictAction = FileTransferEngine::ConflictAction::Overwrite;
+
+	FileTransferEngine engine(options);
+	auto plan = engine.BuildPlan({ source }, destination);
+	ASSERT_TRUE(plan);
+	EXPECT_TRUE(engine.Run(*plan));
+	ExpectComplete(engine);
+	EXPECT_EQ(ReadTree(destination / L"source"), originalContents);
+}
+
+TEST_F(FileTransferEngineTest, Resume)
+{
+	auto source = CreateTree(L"source");
+	auto destination = CreateDestination();
+
+	{
+		FileTransferEngine engine(BuildOptions(FileTransferEngine::Operation::Copy));
+		auto plan = engine.BuildPlan({ source }, destination);
+		ASSERT_TRUE(plan);
+		ASSERT_TRUE(engine.Run(*plan));
+	}
+
+	auto copiedRoot = destination / L"source";
+
+	// Simulate an interrupted transfer. A preallocated large file will have the correct size,
+	// but not the correct modification time.
+	std::filesystem::resize_file(copiedRoot / L"large.bin", 0);
+	std::filesystem::resize_file(copiedRoot / L"large.bin", 300 * 1024 + 7);
+	std::filesystem::remove(copiedRoot / L"dir3" / L"file5");
+	CreateTestFile(L"destination/source/dir1/file2", GenerateTestData(3));
+
+	// This file has the same size and modification time as its source, so it will be considered
+	// complete, even though its contents differ.
+	auto completeFile = copiedRoot / L"dir4" / L"file9";
+	auto modificationTime = std::filesystem::last_write_time(completeFile);
+	auto completeFileData = GenerateTestData(409);
+	completeFileData[0]++;
+	CreateTestFile(L"destination/source/dir4/file9", completeFileData);
+	std::filesystem::last_write_time(completeFile, modificationTime);
+
+	auto options = BuildOptions(FileTransferEngine::Operation::Copy);
+	options.resume = true;
+
+	FileTransferEngine engine(options);
+	auto plan = engine.BuildPlan({ source }, destination);
+	ASSERT_TRUE(plan);
+	EXPECT_TRUE(engine.Run(*plan));
+	ExpectComplete(engine);
+
+	auto expectedContents = ReadTree(source);
+	expectedContents[std::filesystem::path(L"dir4") / L"file9"] = completeFileData;
+	EXPECT_EQ(ReadTree(copiedRoot), expectedContents);
+}
+
+TEST_F(FileTransferEngineTest, LinksToDirectoriesNotFollowed)
+{
+	auto source = CreateTree(L"source");
+	auto linkTarget = CreateTestFile(L"target/file.bin", GenerateTestData(10)).parent_path();
+	auto link = source / L"link";
+
+	std::error_code error;
+	std::filesystem::create_directory_symlink(linkTarget, link, error);
+
+	if (error)
+	{
+		GTEST_SKIP() << "Symbolic links can't be created";
+	}
+
+	auto destination = CreateDestination();
+
+	// The destination directory already exists, so each item will be moved individually.
+	std::filesystem::create_directory(destination / L"source");
+
+	FileTransferEngine engine(BuildOptions(FileTransferEngine::Operation::Move));
+	auto plan = engine.BuildPlan({ source, link }, destination);
+	ASSERT_TRUE(plan);
+	ASSERT_EQ(plan->errors.size(), 2U);
+	EXPECT_EQ(plan->errors[0].path, link);
+	EXPECT_EQ(plan->errors[0].error, std::errc::operation_not_supported);
+	EXPECT_EQ(plan->errors[1].path, link);
+	EXPECT_EQ(plan->errors[1].error, std::errc::operation_not_supported);
+	EXPECT_EQ(plan->roots.size(), 1U);
+
+	EXPECT_TRUE(engine.Run(*plan));
+
+	// Neither the link nor the directory it points to should have been touched.
+	EXPECT_TRUE(std::filesystem::is_symlink(link));
+	EXPECT_EQ(ReadFileContents(linkTarget / L"file.bin"), GenerateTestData(10));
+	EXPECT_FALSE(std::filesystem::exists(destination / L"source" / L"link"));
+	EXPECT_FALSE(std::filesystem::exists(destination / L"link"));
+}
+
+TEST_F(FileTransferEngineTest, MetadataCopied)
+{
+	auto file = CreateTestFile(L"source/file.bin", GenerateTestData(100));
+	std::filesystem::permissions(file, std::filesystem::perms::owner_write,
+		std::filesystem::perm_options::remove);
+	auto destination = CreateDestination();
+
+	FileTransferEngine engine(BuildOptions(FileTransferEngine::Operation::Copy));
+	auto plan = engine.BuildPlan({ m_tempDirectory / L"source" }, destination);
+	ASSERT_TRUE(plan);
+	EXPECT_TRUE(engine.Run(*plan));
+	ExpectComplete(engine);
+
+	auto copiedFile = destination / L"source" / L"file.bin";
+	EXPECT_EQ(std::filesystem::status(copiedFile).permissions(),
+		std::filesystem::status(file).permissions());
+	EXPECT_EQ(std::filesystem::last_write_time(copiedFile), std::filesystem::last_write_time(file));
+
+	// Allows the files to be removed once the test has finished.
+	std::filesystem::permissions(file, std::filesystem::perms::owner_write,
+		std::filesystem::perm_options::add);
+	std::filesystem::permissions(copiedFile, std::filesystem::perms::owner_write,
+		std::filesystem::perm_options::add);
+}
+
+#ifdef _WIN32
+TEST_F(FileTransferEngineTest, AlternateStreamsCopied)
+{
+	auto file = CreateTestFile(L"file.bin", GenerateTestData(100));
+
+	// This is how a file downloaded from the internet is marked.
+	std::string zoneIdentifier = "[ZoneTransfer]\r\nZoneId=3\r\n";
+	std::ofstream stream(file.native() + L":Zone.Identifier", std::ios::binary);
+	stream << zoneIdentifier;
+	stream.close();
+	ASSERT_TRUE(stream);
+
+	ASSERT_TRUE(SetFileAttributes(file.c_str(), FILE_ATTRIBUTE_HIDDEN));
+
+	auto destination = CreateDestination();
+
+	FileTransferEngine engine(BuildOptions(FileTransferEngine::Operation::Copy));
+	auto plan = engine.BuildPlan({ file }, destination);
+	ASSERT_TRUE(plan);
+	EXPECT_TRUE(engine.Run(*plan));
+	ExpectComplete(engine);
+
+	auto copiedFile = destination / L"file.bin";
+	auto copiedStream = ReadFileContents(copiedFile.native() + L":Zone.Identifier");
+	EXPECT_EQ(std::string(copiedStream.begin(), copiedStream.end()), zoneIdentifier);
+	EXPECT_EQ(GetFileAttributes(copiedFile.c_str()), static_cast<DWORD>(FILE_ATTRIBUTE_HIDDEN));
+}
+#endif
+
+TEST_F(FileTransferEngineTest, DestinationWithinSource)
+{
+	auto source = CreateTree(L"source");
+	FileTransferEngine engine(BuildOptions(FileTransferEngine::Operation::Copy));
+
+	EXPECT_FALSE(engine.BuildPlan({ source }, source));
+	EXPECT_FALSE(engine.BuildPlan({ source }, source / L"dir1"));
+	EXPECT_FALSE(engine.BuildPlan({ source }, source / L"dir1" / L"new"));
+
+	// A directory that merely starts with the same name isn't within the source.
+	EXPECT_TRUE(engine.BuildPlan({ source }, m_tempDirectory / L"source2"));
+}
+
+#ifdef _WIN32
+TEST_F(FileTransferEngineTest, DestinationWithinSourceIgnoresCase)
+{
+	auto source = CreateTree(L"source");
+	FileTransferEngine engine(BuildOptions(FileTransferEngine::Operation::Copy));
+
+	EXPECT_FALSE(engine.BuildPlan({ source }, m_tempDirectory / L"SOURCE" / L"DIR1"));
+}
+#endif
+
+TEST_F(FileTransferEngineTest, Cancel)
+{
+	auto source = CreateTree(L"source");
+	auto destination = CreateDestination();
+
+	FileTransferEngine engine(BuildOptions(FileTransferEngine::Operation::Copy));
+	auto plan = engine.BuildPlan({ source }, destination);
+	ASSERT_TRUE(plan);
+
+	engine.Cancel();
+	EXPECT_FALSE(engine.Run(*plan));
+	EXPECT_EQ(engine.GetProgress().completedFiles, 0U);
+	EXPECT_FALSE(std::filesystem::exists(destination / L"source" / L"small.bin"));
+}
+
+// Compares the engine against a plain, sequential copy of a tree containing many small files and
+// a few large ones. The time taken by each is recorded in the test output.
+TEST_F(FileTransferEngineTest, ManyFiles)
+{
+	for (int i = 0; i < 20; i++)
+	{
+		auto directory = std::filesystem::path(L"source") / (L"dir" + std::to_wstring(i));
+
+		for (int j = 0; j < 100; j++)
+		{
+			CreateTestFile((directory / (L"file" + std::to_wstring(j))).wstring(),
+				GenerateTestData(1024 + (i * 100 + j) % 7000));
+		}
+	}
+
+	for (int i = 0; i < 4; i++)
+	{
+		CreateTestFile(L"source/large" + std::to_wstring(i),
+			GenerateTestData(8 * 1024 * 1024 + i));
+	}
+
+	auto source = m_tempDirectory / L"source";
+	auto sourceContents = ReadTree(source);
+
+	auto naiveDestination = m_tempDirectory / L"naive";
+	auto naiveStartTime = std::chrono::steady_clock::now();
+	std::filesystem::copy(source, naiveDestination, std::filesystem::copy_options::recursive);
+	auto naiveEndTime = std::chrono::steady_clock::now();
+
+	auto destination = CreateDestination();
+	FileTransferEngine engine(FileTransferEngine::Options{});
+
+	auto engineStartTime = std::chrono::steady_clock::now();
+	auto plan = engine.BuildPlan({ source }, destination);
+	ASSERT_TRUE(plan);
+	EXPECT_TRUE(engine.Run(*plan));
+	auto engineEndTime = std::chrono::steady_clock::now();
+
+	RecordProperty("NaiveMilliseconds",
+		static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+			naiveEndTime - naiveStartTime)
+				.count()));
+	RecordProperty("EngineMilliseconds",
+		static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+			engineEndTime - engineStartTime)
+				.count()));
+
+	ExpectComplete(engine);
+	EXPECT_EQ(ReadTree(naiveDestination), sourceContents);
+	EXPECT_EQ(ReadTree(destination / L"source"), sourceContents);
+}
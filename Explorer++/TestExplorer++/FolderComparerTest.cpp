@@ -0,0 +1,278 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/FolderComparer.h"
+#include "TempDirectoryHelper.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <map>
+
+using namespace testing;
+
+class FolderComparerTest : public TempDirectoryTest
+{
+protected:
+	using Differences = std::map<std::filesystem::path, FolderComparer::Difference>;
+
+	// Creates a file on both sides, with the same contents and modification time.
+	void CreateMatchingFiles(const std::wstring &path, const std::vector<BYTE> &data)
+	{
+		auto leftFile = CreateTestFile(L"left/" + path, data);
+		auto rightFile = CreateTestFile(L"right/" + path, data);
+		std::filesystem::last_write_time(rightFile, std::filesystem::last_write_time(leftFile));
+	}
+
+	void SetModificationTime(const std::filesystem::path &file,
+		std::filesystem::file_time_type::duration offset)
+	{
+		std::filesystem::last_write_time(file, std::filesystem::last_write_time(file) + offset);
+	}
+
+	// Creates a pair of trees containing one item of each type of difference, returning the
+	// expected differences.
+	Differences CreateTrees()
+	{
+		Differences differences;
+
+		CreateMatchingFiles(L"same.bin", GenerateTestData(1000));
+		differences[L"same.bin"] = FolderComparer::Difference::Same;
+
+		CreateMatchingFiles(L"dir/nested/same.bin", GenerateTestData(2000));
+		differences[std::filesystem::path(L"dir") / L"nested" / L"same.bin"] =
+			FolderComparer::Difference::Same;
+
+		CreateTestFile(L"left/dir/leftOnly.bin", GenerateTestData(10));
+		differences[std::filesystem::path(L"dir") / L"leftOnly.bin"] =
+			FolderComparer::Difference::LeftOnly;
+
+		CreateTestFile(L"right/rightOnly.bin", GenerateTestData(10));
+		differences[L"rightOnly.bin"] = FolderComparer::Difference::RightOnly;
+
+		// Directories that only exist on one side are reported as a single item.
+		CreateTestFile(L"right/rightOnlyDir/file.bin", GenerateTestData(10));
+		differences[L"rightOnlyDir"] = FolderComparer::Difference::RightOnly;
+
+		CreateMatchingFiles(L"dir/leftNewer.bin", GenerateTestData(100));
+		SetModificationTime(m_tempDirectory / L"left" / L"dir" / L"leftNewer.bin",
+			std::chrono::hours(1));
+		differences[std::filesystem::path(L"dir") / L"leftNewer.bin"] =
+			FolderComparer::Difference::LeftNewer;
+
+		CreateMatchingFiles(L"rightNewer.bin", GenerateTestData(100));
+		SetModificationTime(m_tempDirectory / L"left" / L"rightNewer.bin", -std::chrono::hours(1));
+		differences[L"rightNewer.bin"] = FolderComparer::Difference::RightNewer;
+
+		// A modification time within the tolerance is ignored.
+		CreateMatchingFiles(L"withinTolerance.bin", GenerateTestData(100));
+		SetModificationTime(m_tempDirectory / L"right" / L"withinTolerance.bin",
+			std::chrono::seconds(1));
+		differences[L"withinTolerance.bin"] = FolderComparer::Difference::Same;
+
+		auto leftFile = CreateTestFile(L"left/sizeDiffers.bin", GenerateTestData(100));
+		auto rightFile = CreateTestFile(L"right/sizeDiffers.bin", GenerateTestData(101));
+		std::filesystem::last_write_time(rightFile, std::filesystem::last_write_time(leftFile));
+		differences[L"sizeDiffers.bin"] = FolderComparer::Difference::ContentsDiffer;
+
+		CreateTestFile(L"left/typeDiffers", GenerateTestData(10));
+		CreateTestFile(L"right/typeDiffers/file.bin", GenerateTestData(10));
+		differences[L"typeDiffers"] = FolderComparer::Difference::TypeDiffers;
+
+		// This file has the same size and modification time on both sides, so it will only be
+		// found to differ if the contents are compared.
+		auto data = GenerateTestData(3 * 1024 * 1024 + 5);
+		CreateMatchingFiles(L"dir/contentsDiffer.bin", data);
+		auto contentsFile = m_tempDirectory / L"right" / L"dir" / L"contentsDiffer.bin";
+		auto modificationTime = std::filesystem::last_write_time(contentsFile);
+		data[2 * 1024 * 1024 + 100]++;
+		CreateTestFile(L"right/dir/contentsDiffer.bin", data);
+		std::filesystem::last_write_time(contentsFile, modificationTime);
+		differences[std::filesystem::path(L"dir") / L"contentsDiffer.bin"] =
+			FolderComparer::Difference::Same;
+
+		std::filesystem::create_directories(m_tempDirectory / L"left" / L"emptyDir");
+		std::filesystem::create_directories(m_tempDirectory / L"right" / L"emptyDir");
+
+		return differences;
+	}
+
+	Differences Compare(FolderComparer &comparer, bool expectedResult = true)
+	{
+		Differences differences;
+
+		bool result = comparer.Compare(m_tempDirectory / L"left", m_tempDirectory / L"right",
+			[&differences](std::vector<FolderComparer::Item> &&items)
+			{
+				for (const auto &item : items)
+				{
+					EXPECT_EQ(item.left.has_value(),
+						item.difference != FolderComparer::Difference::RightOnly);
+					EXPECT_EQ(item.right.has_value(),
+						item.difference != FolderComparer::Difference::LeftOnly);
+
+					auto [itr, inserted] = differences.emplace(item.path, item.difference);
+					EXPECT_TRUE(inserted);
+				}
+			});
+		EXPECT_EQ(result, expectedResult);
+
+		return differences;
+	}
+};
+
+TEST_F(FolderComparerTest, Compare)
+{
+	auto expectedDifferences = CreateTrees();
+
+	FolderComparer comparer(FolderComparer::Options{});
+	EXPECT_EQ(Compare(comparer), expectedDifferences);
+	EXPECT_EQ(comparer.GetNumErrors(), 0U);
+
+	auto progress = comparer.GetProgress();
+	EXPECT_EQ(progress.itemsCompared, expectedDifferences.size());
+
+	// The root, dir, dir/nested and emptyDir.
+	EXPECT_EQ(progress.directoriesCompared, 4U);
+}
+
+TEST_F(FolderComparerTest, CompareContents)
+{
+	auto expectedDifferences = CreateTrees();
+	expectedDifferences[std::filesystem::path(L"dir") / L"contentsDiffer.bin"] =
+		FolderComparer::Difference::ContentsDiffer;
+
+	FolderComparer::Options options;
+	options.compareContents = true;
+
+	FolderComparer comparer(options);
+	EXPECT_EQ(Compare(comparer), expectedDifferences);
+	EXPECT_EQ(comparer.GetNumErrors(), 0U);
+}
+
+#ifdef _WIN32
+TEST_F(FolderComparerTest, CompareContentsUnreadable)
+{
+	CreateMatchingFiles(L"file.bin", GenerateTestData(10));
+
+	// Opening the file without any sharing prevents the comparer from reading it.
+	wil::unique_hfile file(CreateFile((m_tempDirectory / L"left" / L"file.bin").c_str(),
+		GENERIC_READ, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+	ASSERT_TRUE(file);
+
+	FolderComparer::Options options;
+	options.compareContents = true;
+
+	FolderComparer comparer(options);
+	Differences expectedDifferences = { { L"file.bin", FolderComparer::Difference::Unknown } };
+	EXPECT_EQ(Compare(comparer), expectedDifferences);
+	EXPECT_EQ(comparer.GetNumErrors(), 1U);
+}
+#endif
+
+TEST_F(FolderComparerTest, NamesIgnoreCase)
+{
+	CreateMatchingFiles(L"file.bin", GenerateTestData(10));
+	CreateTestFile(L"left/b.bin", GenerateTestData(10));
+	CreateTestFile(L"right/A.bin", GenerateTestData(10));
+
+	std::filesystem::rename(m_tempDirectory / L"right" / L"file.bin",
+		m_tempDirectory / L"right" / L"FILE.bin");
+
+	FolderComparer comparer(FolderComparer::Options{});
+	Differences expectedDifferences = { { L"A.bin", FolderComparer::Difference::RightOnly },
+		{ L"b.bin", FolderComparer::Difference::LeftOnly },
+		{ L"file.bin", FolderComparer::Difference::Same } };
+	EXPECT_EQ(Compare(comparer), expectedDifferences);
+}
+
+#ifdef _WIN32
+TEST_F(FolderComparerTest, NonAsciiNamesIgnoreCase)
+{
+	CreateMatchingFiles(L"\u00E9t\u00E9.bin", GenerateTestData(10));
+
+	std::filesystem::rename(m_tempDirectory / L"right" / L"\u00E9t\u00E9.bin",
+		m_tempDirectory / L"right" / L"\u00C9T\u00C9.bin");
+
+	FolderComparer comparer(FolderComparer::Options{});
+	Differences expectedDifferences = { { L"\u00E9t\u00E9.bin",
+		FolderComparer::Difference::Same } };
+	EXPECT_EQ(Compare(comparer), expectedDifferences);
+}
+#endif
+
+TEST_F(FolderComparerTest, MissingRoot)
+{
+	CreateTestFile(L"left/file.bin", GenerateTestData(10));
+
+	FolderComparer comparer(FolderComparer::Options{});
+	EXPECT_TRUE(Compare(comparer, false).empty());
+	EXPECT_EQ(comparer.GetNumErrors(), 1U);
+}
+
+TEST_F(FolderComparerTest, Cancel)
+{
+	CreateTrees();
+
+	FolderComparer comparer(FolderComparer::Options{});
+	comparer.Cancel();
+	EXPECT_TRUE(Compare(comparer, false).empty());
+}
+
+// Compares a pair of generated trees, in which one in every ten files differs. The time taken is
+// recorded in the test output, for both a single thread and the default number of threads.
+TEST_F(FolderComparerTest, Scaling)
+{
+	const int NUM_DIRECTORIES = 100;
+	const int NUM_FILES_PER_DIRECTORY = 100;
+
+	for (int i = 0; i < NUM_DIRECTORIES; i++)
+	{
+		for (int j = 0; j < NUM_FILES_PER_DIRECTORY; j++)
+		{
+			auto path = L"dir" + std::to_wstring(i / 10) + L"/dir" + std::to_wstring(i) + L"/file"
+				+ std::to_wstring(j);
+
+			if (j % 10 == 0)
+			{
+				CreateTestFile(L"left/" + path, GenerateTestData(10));
+				CreateTestFile(L"right/" + path, GenerateTestData(20));
+			}
+			else
+			{
+				CreateMatchingFiles(path, GenerateTestData(10));
+			}
+		}
+	}
+
+	for (int numThreads : { 1, FolderComparer::Options{}.numThreads })
+	{
+		FolderComparer::Options options;
+		options.numThreads = numThreads;
+
+		FolderComparer comparer(options);
+
+		auto startTime = std::chrono::steady_clock::now();
+		auto differences = Compare(comparer);
+		auto endTime = std::chrono::steady_clock::now();
+
+		RecordProperty("Threads" + std::to_string(numThreads) + "Milliseconds",
+			static_cast<int>(
+				std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime)
+					.count()));
+
+		size_t numSame = 0;
+
+		for (const auto &[path, difference] : differences)
+		{
+			if (difference == FolderComparer::Difference::Same)
+			{
+				numSame++;
+			}
+		}
+
+		EXPECT_EQ(differences.size(),
+			static_cast<size_t>(NUM_DIRECTORIES * NUM_FILES_PER_DIRECTORY));
+		EXPECT_EQ(numSame, static_cast<size_t>(NUM_DIRECTORIES * NUM_FILES_PER_DIRECTORY * 9 / 10));
+	}
+}
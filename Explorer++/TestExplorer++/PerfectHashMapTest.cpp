@@ -0,0 +1,90 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/PerfectHashMap.h"
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+namespace
+{
+
+// clang-format off
+constexpr std::pair<std::string_view, int> TEST_ENTRIES[] = {
+	{ "AllowMultipleInstances", 0 },
+	{ "AlwaysOpenInNewTab", 1 },
+	{ "AlwaysShowTabBar", 2 },
+	{ "AutoArrangeGlobal", 3 },
+	{ "CheckBoxSelection", 4 },
+	{ "CloseMainWindowOnTabClose", 5 },
+	{ "ConfirmCloseTabs", 6 },
+	{ "DisplayCentreColor", 7 },
+	{ "DisplayFont", 8 },
+	{ "DisplaySurroundColor", 9 },
+	{ "DisplayTextColor", 10 },
+	{ "DisplayWindowWidth", 11 },
+	{ "DisplayWindowHeight", 12 },
+	{ "DisplayWindowVertical", 13 },
+	{ "Language", 14 },
+	{ "LastSelectedTab", 15 },
+	{ "NextToCurrent", 16 },
+	{ "ShowAddressBar", 17 },
+	{ "ShowBookmarksToolbar", 18 },
+	{ "ShowDrivesToolbar", 19 },
+	{ "", 20 },
+	{ "a", 21 },
+	{ "b", 22 },
+	{ "ab", 23 },
+	{ "ba", 24 }
+};
+// clang-format on
+
+constexpr auto TEST_MAP = MakePerfectHashMap(TEST_ENTRIES);
+
+// Lookups can also be performed at compile time.
+static_assert(TEST_MAP.Find("Language") == 14);
+static_assert(!TEST_MAP.Find("Unknown"));
+
+}
+
+TEST(PerfectHashMapTest, Find)
+{
+	EXPECT_EQ(TEST_MAP.GetSize(), std::size(TEST_ENTRIES));
+
+	for (const auto &[key, value] : TEST_ENTRIES)
+	{
+		EXPECT_EQ(TEST_MAP.Find(key), value) << key;
+	}
+}
+
+TEST(PerfectHashMapTest, MissingKeys)
+{
+	EXPECT_EQ(TEST_MAP.Find("Unknown"), std::nullopt);
+	EXPECT_EQ(TEST_MAP.Find("language"), std::nullopt);
+	EXPECT_EQ(TEST_MAP.Find("Languag"), std::nullopt);
+	EXPECT_EQ(TEST_MAP.Find("Language "), std::nullopt);
+	EXPECT_EQ(TEST_MAP.Find("aa"), std::nullopt);
+
+	// Lookups are performed on the full view, so embedded null characters matter.
+	EXPECT_EQ(TEST_MAP.Find(std::string_view("a\0", 2)), std::nullopt);
+}
+
+TEST(PerfectHashMapTest, SingleEntry)
+{
+	constexpr auto map = MakePerfectHashMap<int>({ { "key", 1 } });
+
+	EXPECT_EQ(map.Find("key"), 1);
+	EXPECT_EQ(map.Find("other"), std::nullopt);
+	EXPECT_EQ(map.Find(""), std::nullopt);
+}
+
+TEST(PerfectHashMapTest, Empty)
+{
+	constexpr PerfectHashMap<int, 0> map(std::array<PerfectHashMap<int, 0>::Entry, 0>{});
+
+	EXPECT_EQ(map.GetSize(), 0u);
+	EXPECT_EQ(map.Find(""), std::nullopt);
+	EXPECT_EQ(map.Find("key"), std::nullopt);
+}
@@ -0,0 +1,176 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/RenameTemplate.h"
+#include <boost/locale.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+
+using namespace testing;
+
+namespace
+{
+
+std::wstring EvaluateTemplate(std::wstring_view pattern, const RenameTemplate::FileInfo &fileInfo)
+{
+	auto renameTemplate =
+		RenameTemplate::Parse(pattern, boost::locale::generator()("en_US.UTF-8"));
+	EXPECT_TRUE(renameTemplate);
+
+	if (!renameTemplate)
+	{
+		return {};
+	}
+
+	std::wstring output;
+	renameTemplate->Evaluate(fileInfo, output);
+	return output;
+}
+
+std::wstring EvaluateTemplate(std::wstring_view pattern, std::wstring_view fileName, int index = 0)
+{
+	return EvaluateTemplate(pattern, { fileName, index });
+}
+
+}
+
+TEST(RenameTemplateTest, FileNameTokens)
+{
+	EXPECT_EQ(EvaluateTemplate(L"/F", L"file.txt"), L"file.txt");
+	EXPECT_EQ(EvaluateTemplate(L"/B", L"file.txt"), L"file");
+	EXPECT_EQ(EvaluateTemplate(L"/E", L"file.txt"), L".txt");
+	EXPECT_EQ(EvaluateTemplate(L"New /B (copy)/E", L"file.tar.gz"), L"New file.tar (copy).gz");
+
+	EXPECT_EQ(EvaluateTemplate(L"/B", L"file"), L"file");
+	EXPECT_EQ(EvaluateTemplate(L"/E", L"file"), L"");
+
+	// The extension rules should match those used by PathFindExtension().
+	EXPECT_EQ(EvaluateTemplate(L"/B|/E", L".hidden"), L"|.hidden");
+	EXPECT_EQ(EvaluateTemplate(L"/B|/E", L"file.part one"), L"file.part one|");
+}
+
+TEST(RenameTemplateTest, Counter)
+{
+	EXPECT_EQ(EvaluateTemplate(L"/N", L"file.txt", 7), L"7");
+	EXPECT_EQ(EvaluateTemplate(L"/0N", L"file.txt", 7), L"07");
+	EXPECT_EQ(EvaluateTemplate(L"/000N", L"file.txt", 7), L"0007");
+	EXPECT_EQ(EvaluateTemplate(L"/0N", L"file.txt", 1234), L"1234");
+	EXPECT_EQ(EvaluateTemplate(L"/B_/00N/E", L"file.txt", 42), L"file_042.txt");
+}
+
+TEST(RenameTemplateTest, CaseConversion)
+{
+	EXPECT_EQ(EvaluateTemplate(L"/L", L"File.TXT"), L"file.txt");
+	EXPECT_EQ(EvaluateTemplate(L"/U", L"File.txt"), L"FILE.TXT");
+
+	// The conversion applies to the whole name, not just the inserted filename.
+	EXPECT_EQ(EvaluateTemplate(L"Prefix /L", L"File.TXT"), L"prefix file.txt");
+
+	// Uppercase conversion takes precedence.
+	EXPECT_EQ(EvaluateTemplate(L"/U/L", L"File.txt"), L"FILE.TXTFILE.TXT");
+	EXPECT_EQ(EvaluateTemplate(L"/L/U", L"File.txt"), L"FILE.TXTFILE.TXT");
+
+	EXPECT_EQ(EvaluateTemplate(L"/L", L"\u00C4\u00D6\u00DC.txt"), L"\u00E4\u00F6\u00FC.txt");
+}
+
+TEST(RenameTemplateTest, Date)
+{
+	RenameTemplate::FileInfo fileInfo = { L"file.txt", 0, { { 2021, 3, 4, 5, 6, 7 } } };
+
+	EXPECT_EQ(EvaluateTemplate(L"/D /B", fileInfo), L"2021-03-04 file");
+	EXPECT_EQ(EvaluateTemplate(L"/D{%d.%m.%Y %H%M%S}", fileInfo), L"04.03.2021 050607");
+	EXPECT_EQ(EvaluateTemplate(L"/D{100%%}", fileInfo), L"100%");
+	EXPECT_EQ(EvaluateTemplate(L"/D{}/B", fileInfo), L"file");
+
+	// If the date isn't available, the entire date should be omitted.
+	EXPECT_EQ(EvaluateTemplate(L"[/D{%Y (%m)}]/B", L"file.txt"), L"[]file");
+
+	EXPECT_TRUE(RenameTemplate::Parse(L"/D")->UsesDate());
+	EXPECT_FALSE(RenameTemplate::Parse(L"/F")->UsesDate());
+}
+
+TEST(RenameTemplateTest, RegexCaptureGroups)
+{
+	EXPECT_EQ(EvaluateTemplate(L"/R{^IMG_(\\d+)_(\\w+)}/2 /1/E", L"img_0042_beach.jpg"),
+		L"beach 0042.jpg");
+
+	// Nested braces shouldn't end the expression.
+	EXPECT_EQ(EvaluateTemplate(L"/R{(\\d{4})-(\\d{2})}/2-/1", L"2021-03.log"), L"03-2021");
+
+	// Escaped braces shouldn't either.
+	EXPECT_EQ(EvaluateTemplate(L"/R{\\}(.)}/1", L"a}b"), L"b");
+
+	// Capture groups are empty if the expression doesn't match.
+	EXPECT_EQ(EvaluateTemplate(L"/R{^(\\d+)}[/1]/F", L"file.txt"), L"[]file.txt");
+}
+
+TEST(RenameTemplateTest, Literals)
+{
+	EXPECT_EQ(EvaluateTemplate(L"", L"file.txt"), L"");
+	EXPECT_EQ(EvaluateTemplate(L"name", L"file.txt"), L"name");
+
+	// Unrecognized tokens should be left as-is.
+	EXPECT_EQ(EvaluateTemplate(L"/X/00/R/", L"file.txt", 3), L"/X/00/R/");
+	EXPECT_EQ(EvaluateTemplate(L"//N", L"file.txt", 3), L"/3");
+	EXPECT_EQ(EvaluateTemplate(L"/0/F", L"file.txt"), L"/0file.txt");
+}
+
+TEST(RenameTemplateTest, Invalid)
+{
+	// Unterminated braces.
+	EXPECT_FALSE(RenameTemplate::Parse(L"/R{abc"));
+	EXPECT_FALSE(RenameTemplate::Parse(L"/D{%Y"));
+
+	// Invalid regular expression.
+	EXPECT_FALSE(RenameTemplate::Parse(L"/R{(abc}"));
+
+	// Only a single expression is allowed.
+	EXPECT_FALSE(RenameTemplate::Parse(L"/R{a}/R{b}"));
+
+	// Capture groups need to exist.
+	EXPECT_FALSE(RenameTemplate::Parse(L"/1"));
+	EXPECT_FALSE(RenameTemplate::Parse(L"/R{(a)}/2"));
+
+	// Invalid date format.
+	EXPECT_FALSE(RenameTemplate::Parse(L"/D{%Q}"));
+	EXPECT_FALSE(RenameTemplate::Parse(L"/D{%}"));
+}
+
+// Evaluates a template for a large number of files, as happens when previewing or performing a
+// rename. The time taken is recorded in the test output.
+TEST(RenameTemplateTest, ManyFiles)
+{
+	const int numFiles = 100000;
+
+	std::vector<std::wstring> fileNames;
+	fileNames.reserve(numFiles);
+
+	for (int i = 0; i < numFiles; i++)
+	{
+		fileNames.push_back(L"IMG_" + std::to_wstring(i) + L"_holiday.jpg");
+	}
+
+	auto renameTemplate = RenameTemplate::Parse(L"/R{^img_(\\d+)_(\\w+)}/2 /00000N (/1)/E");
+	ASSERT_TRUE(renameTemplate);
+
+	std::wstring output;
+	size_t totalLength = 0;
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < numFiles; i++)
+	{
+		renameTemplate->Evaluate({ fileNames[i], i }, output);
+		totalLength += output.size();
+	}
+
+	auto endTime = std::chrono::steady_clock::now();
+	RecordProperty("Microseconds",
+		static_cast<int>(
+			std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()));
+
+	EXPECT_EQ(output, L"holiday 099999 (99999).jpg");
+	EXPECT_GT(totalLength, 0u);
+}
@@ -0,0 +1,135 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/SerialTaskRunner.h"
+#include <gtest/gtest.h>
+#include <future>
+#include <memory>
+
+using namespace testing;
+
+TEST(SerialTaskRunnerTest, Order)
+{
+	SerialTaskRunner runner(std::chrono::seconds(10));
+	std::vector<int> values;
+
+	for (int i = 0; i < 100; i++)
+	{
+		runner.Post("task",
+			[&values, i]
+			{
+				values.push_back(i);
+			});
+	}
+
+	runner.Flush();
+
+	ASSERT_EQ(values.size(), 100U);
+
+	for (int i = 0; i < 100; i++)
+	{
+		EXPECT_EQ(values[i], i);
+	}
+
+	auto statistics = runner.GetStatistics();
+	EXPECT_EQ(statistics.tasksRun, 100U);
+	EXPECT_EQ(statistics.tasksOverBudget, 0U);
+	EXPECT_LE(statistics.maxTime, statistics.totalTime);
+}
+
+TEST(SerialTaskRunnerTest, RunnerThread)
+{
+	SerialTaskRunner runner(std::chrono::seconds(10));
+	EXPECT_FALSE(runner.IsRunnerThread());
+
+	std::promise<bool> isRunnerThread;
+	runner.Post("task",
+		[&runner, &isRunnerThread]
+		{
+			isRunnerThread.set_value(runner.IsRunnerThread());
+		});
+
+	EXPECT_TRUE(isRunnerThread.get_future().get());
+}
+
+TEST(SerialTaskRunnerTest, OverBudget)
+{
+	std::vector<std::string> slowTasks;
+
+	SerialTaskRunner runner(std::chrono::milliseconds(20),
+		[&slowTasks](const std::string &label, std::chrono::microseconds duration)
+		{
+			EXPECT_GE(duration, std::chrono::milliseconds(20));
+			slowTasks.push_back(label);
+		});
+
+	runner.Post("fast",
+		[]
+		{
+		});
+	runner.Post("slow",
+		[]
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		});
+	runner.Post("fast",
+		[]
+		{
+		});
+	runner.Flush();
+
+	EXPECT_EQ(slowTasks, std::vector<std::string>{ "slow" });
+
+	auto statistics = runner.GetStatistics();
+	EXPECT_EQ(statistics.tasksRun, 3U);
+	EXPECT_EQ(statistics.tasksOverBudget, 1U);
+	EXPECT_GE(statistics.maxTime, std::chrono::milliseconds(50));
+	EXPECT_GE(statistics.totalTime, statistics.maxTime);
+}
+
+TEST(SerialTaskRunnerTest, PendingTasksDiscarded)
+{
+	std::promise<void> taskStarted;
+	std::promise<void> releaseTask;
+	auto releaseTaskFuture = releaseTask.get_future();
+	bool secondTaskRun = false;
+
+	// The second task captures this, so that it can be checked that the task was destroyed.
+	auto sentinel = std::make_shared<int>(0);
+	std::weak_ptr<int> weakSentinel = sentinel;
+
+	std::thread releaseThread;
+
+	{
+		SerialTaskRunner runner(std::chrono::seconds(10));
+		runner.Post("first",
+			[&taskStarted, &releaseTaskFuture]
+			{
+				taskStarted.set_value();
+				releaseTaskFuture.wait();
+			});
+		runner.Post("second",
+			[&secondTaskRun, sentinel = std::move(sentinel)]
+			{
+				secondTaskRun = true;
+			});
+
+		taskStarted.get_future().wait();
+
+		// The runner is destroyed while the first task is still running. It should wait for that
+		// task, but the second task should never run.
+		releaseThread = std::thread(
+			[&releaseTask]
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+				releaseTask.set_value();
+			});
+	}
+
+	releaseThread.join();
+
+	EXPECT_FALSE(secondTaskRun);
+	EXPECT_TRUE(weakSentinel.expired());
+}
@@ -0,0 +1,62 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "TempDirectoryHelper.h"
+#include <fstream>
+#include <random>
+
+void TempDirectoryTest::SetUp()
+{
+	// Only standard library facilities are used here, so that the tests that rely on this
+	// fixture can also be run on other platforms.
+	std::random_device randomDevice;
+	std::uniform_int_distribution<std::uint64_t> distribution;
+	auto name = std::to_wstring(distribution(randomDevice));
+
+	m_tempDirectory = std::filesystem::temp_directory_path() / (L"ExplorerTest" + name);
+	ASSERT_TRUE(std::filesystem::create_directory(m_tempDirectory));
+}
+
+void TempDirectoryTest::TearDown()
+{
+	std::error_code error;
+	std::filesystem::remove_all(m_tempDirectory, error);
+}
+
+std::filesystem::path TempDirectoryTest::CreateTestFile(const std::wstring &name,
+	const std::vector<std::uint8_t> &data)
+{
+	auto path = m_tempDirectory / name;
+	std::filesystem::create_directories(path.parent_path());
+
+	std::ofstream stream(path, std::ios::binary);
+	stream.write(reinterpret_cast<const char *>(data.data()), data.size());
+
+	return path;
+}
+
+std::vector<std::uint8_t> GenerateTestData(size_t size)
+{
+	std::vector<std::uint8_t> data(size);
+
+	// A simple linear congruential generator is enough here. The data just needs to be
+	// deterministic and non-uniform.
+	std::uint32_t state = static_cast<std::uint32_t>(size);
+
+	for (auto &byte : data)
+	{
+		state = state * 1664525 + 1013904223;
+		byte = static_cast<std::uint8_t>(state >> 24);
+	}
+
+	return data;
+}
+
+std::vector<std::uint8_t> ReadFileContents(const std::filesystem::path &path)
+{
+	std::ifstream stream(path, std::ios::binary);
+	return std::vector<std::uint8_t>(std::istreambuf_iterator<char>(stream),
+		std::istreambuf_iterator<char>());
+}
@@ -0,0 +1,28 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Creates a uniquely named directory within the system temporary directory for the duration of
+// each test. The directory (and anything left in it) is removed once the test finishes.
+class TempDirectoryTest : public testing::Test
+{
+protected:
+	void SetUp() override;
+	void TearDown() override;
+
+	std::filesystem::path CreateTestFile(const std::wstring &name,
+		const std::vector<std::uint8_t> &data);
+
+	std::filesystem::path m_tempDirectory;
+};
+
+std::vector<std::uint8_t> GenerateTestData(size_t size);
+std::vector<std::uint8_t> ReadFileContents(const std::filesystem::path &path);
@@ -0,0 +1,101 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/TraceRecorder.h"
+#include <gtest/gtest.h>
+#include <format>
+#include <thread>
+
+using namespace testing;
+
+TEST(TraceRecorderTest, Disabled)
+{
+	TraceRecorder recorder;
+	EXPECT_FALSE(recorder.IsEnabled());
+
+	{
+		ScopedTraceSpan span(recorder, "Span");
+	}
+
+	EXPECT_TRUE(recorder.GetEvents().empty());
+}
+
+TEST(TraceRecorderTest, NestedSpans)
+{
+	TraceRecorder recorder;
+	recorder.SetEnabled(true);
+
+	{
+		ScopedTraceSpan outerSpan(recorder, "Outer");
+
+		{
+			ScopedTraceSpan innerSpan(recorder, "Inner");
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+	}
+
+	auto events = recorder.GetEvents();
+	ASSERT_EQ(events.size(), 2u);
+
+	// Events are recorded when each span ends, so the inner span will be first.
+	const auto &inner = events[0];
+	const auto &outer = events[1];
+	EXPECT_EQ(inner.name, "Inner");
+	EXPECT_EQ(outer.name, "Outer");
+
+	EXPECT_EQ(inner.threadId, GetCurrentThreadId());
+	EXPECT_EQ(outer.threadId, GetCurrentThreadId());
+
+	EXPECT_GE(inner.duration, std::chrono::milliseconds(2));
+	EXPECT_GE(inner.start, outer.start);
+	EXPECT_LE(inner.start + inner.duration, outer.start + outer.duration);
+}
+
+TEST(TraceRecorderTest, MultipleThreads)
+{
+	TraceRecorder recorder;
+	recorder.SetEnabled(true);
+
+	DWORD threadId = 0;
+
+	std::thread thread(
+		[&recorder, &threadId]
+		{
+			threadId = GetCurrentThreadId();
+			ScopedTraceSpan span(recorder, "Background");
+		});
+	thread.join();
+
+	{
+		ScopedTraceSpan span(recorder, "Main");
+	}
+
+	auto events = recorder.GetEvents();
+	ASSERT_EQ(events.size(), 2u);
+	EXPECT_EQ(events[0].name, "Background");
+	EXPECT_EQ(events[0].threadId, threadId);
+	EXPECT_EQ(events[1].name, "Main");
+	EXPECT_EQ(events[1].threadId, GetCurrentThreadId());
+	EXPECT_NE(events[0].threadId, events[1].threadId);
+}
+
+TEST(TraceRecorderTest, ExportChromeTrace)
+{
+	TraceRecorder recorder;
+	recorder.SetEnabled(true);
+
+	auto start = TraceRecorder::Clock::now();
+	recorder.AddEvent("Name \"quoted\"\\\n", start, start + std::chrono::microseconds(1500));
+
+	auto trace = recorder.ExportChromeTrace();
+	EXPECT_TRUE(trace.starts_with(R"({"displayTimeUnit":"ms","traceEvents":[)"));
+	EXPECT_NE(trace.find(R"("name":"Name \"quoted\"\\\u000a")"), std::string::npos);
+	EXPECT_NE(trace.find(R"("ph":"X")"), std::string::npos);
+	EXPECT_NE(trace.find(R"("dur":1500)"), std::string::npos);
+	EXPECT_NE(trace.find(std::format(R"("pid":{},"tid":{}}})", GetCurrentProcessId(),
+				  GetCurrentThreadId())),
+		std::string::npos);
+	EXPECT_TRUE(trace.ends_with("]}\n"));
+}
@@ -0,0 +1,110 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "XMLSettings.h"
+#include <gtest/gtest.h>
+#include <chrono>
+
+namespace
+{
+
+const char *const COLUMN_SET_NAMES[] = { "Generic", "MyComputer", "ControlPanel", "RecycleBin",
+	"Printers", "Network", "NetworkPlaces" };
+
+// Builds a configuration file containing the specified number of tabs, in the same format that's
+// used when the settings are saved. Each tab has a full set of columns.
+std::string BuildTabsXml(int numTabs)
+{
+	std::string data = "<?xml version=\"1.0\"?>\r\n<ExplorerPlusPlus>\r\n\t<Settings>\r\n"
+					   "\t\t<Setting name=\"ShowStatusBar\">yes</Setting>\r\n\t</Settings>\r\n"
+					   "\t<Tabs>\r\n";
+
+	for (int i = 0; i < numTabs; i++)
+	{
+		data += "\t\t<Tab name=\"" + std::to_string(i) + "\" Directory=\"C:\\Folder "
+			+ std::to_string(i) + "\" ShowHidden=\"yes\" ViewMode=\"4\" CustomName=\"Tab "
+			+ std::to_string(i) + "\" Locked=\"no\">\r\n\t\t\t<Columns>\r\n";
+
+		for (const char *columnSetName : COLUMN_SET_NAMES)
+		{
+			data += "\t\t\t\t<Column name=\"" + std::string(columnSetName)
+				+ "\" Name=\"yes\" Name_Width=\"150\" Type=\"no\" Type_Width=\"120\" />\r\n";
+		}
+
+		data += "\t\t\t</Columns>\r\n\t\t</Tab>\r\n";
+	}
+
+	data += "\t</Tabs>\r\n</ExplorerPlusPlus>\r\n";
+
+	return data;
+}
+
+void CheckColumns(const std::vector<Column_t> &columns)
+{
+	ASSERT_EQ(columns.size(), 2u);
+
+	EXPECT_EQ(columns[0].type, ColumnType::Name);
+	EXPECT_TRUE(columns[0].bChecked);
+	EXPECT_EQ(columns[0].iWidth, 150);
+
+	EXPECT_EQ(columns[1].type, ColumnType::Type);
+	EXPECT_FALSE(columns[1].bChecked);
+	EXPECT_EQ(columns[1].iWidth, 120);
+}
+
+}
+
+TEST(XMLSettingsTest, ReadTabSettings)
+{
+	auto tabs = ReadTabSettingsFromXML(BuildTabsXml(3));
+	ASSERT_EQ(tabs.size(), 3u);
+
+	for (size_t i = 0; i < tabs.size(); i++)
+	{
+		const auto &tab = tabs[i];
+
+		EXPECT_EQ(tab.directory, L"C:\\Folder " + std::to_wstring(i));
+		EXPECT_EQ(tab.tabSettings.name, L"Tab " + std::to_wstring(i));
+		EXPECT_FALSE(tab.tabSettings.lockState);
+		EXPECT_TRUE(tab.folderSettings.showHidden);
+		EXPECT_TRUE(tab.folderSettings.viewMode == +ViewMode::Details);
+
+		CheckColumns(tab.initialColumns.realFolderColumns);
+		CheckColumns(tab.initialColumns.myComputerColumns);
+		CheckColumns(tab.initialColumns.controlPanelColumns);
+		CheckColumns(tab.initialColumns.recycleBinColumns);
+		CheckColumns(tab.initialColumns.printersColumns);
+		CheckColumns(tab.initialColumns.networkConnectionsColumns);
+		CheckColumns(tab.initialColumns.myNetworkPlacesColumns);
+	}
+}
+
+TEST(XMLSettingsTest, NoTabs)
+{
+	auto tabs = ReadTabSettingsFromXML("<?xml version=\"1.0\"?>\r\n<ExplorerPlusPlus>\r\n"
+									   "\t<Settings>\r\n\t</Settings>\r\n</ExplorerPlusPlus>\r\n");
+	EXPECT_TRUE(tabs.empty());
+}
+
+// Reads the settings for 200 tabs (each with a full set of columns), in the same way they're read
+// when the application starts. The time taken is recorded in the test output.
+TEST(XMLSettingsTest, ManyTabs)
+{
+	const int numTabs = 200;
+
+	std::string data = BuildTabsXml(numTabs);
+
+	auto startTime = std::chrono::steady_clock::now();
+	auto tabs = ReadTabSettingsFromXML(data);
+	auto endTime = std::chrono::steady_clock::now();
+
+	RecordProperty("LoadMicroseconds",
+		static_cast<int>(
+			std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count()));
+
+	ASSERT_EQ(tabs.size(), static_cast<size_t>(numTabs));
+	EXPECT_EQ(tabs.back().directory, L"C:\\Folder " + std::to_wstring(numTabs - 1));
+	CheckColumns(tabs.back().initialColumns.myNetworkPlacesColumns);
+}
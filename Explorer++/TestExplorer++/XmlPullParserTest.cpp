@@ -0,0 +1,278 @@
+// Copyright (C) Explorer++ Project
+// SPDX-License-Identifier: GPL-3.0-only
+// See LICENSE in the top level directory
+
+#include "pch.h"
+#include "../Helper/XmlPullParser.h"
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+using Event = XmlPullParser::Event;
+
+TEST(XmlPullParserTest, Events)
+{
+	XmlPullParser parser(R"(<?xml version="1.0"?>
+<!-- Comment -->
+<Root>
+	<Child name="first" value='second'>Text</Child>
+	<Empty />
+</Root>
+)");
+
+	EXPECT_EQ(parser.Next(), Event::StartElement);
+	EXPECT_EQ(parser.GetName(), "Root");
+	EXPECT_EQ(parser.GetDepth(), 1u);
+	EXPECT_TRUE(parser.GetAttributes().empty());
+
+	EXPECT_EQ(parser.Next(), Event::Text);
+	EXPECT_EQ(parser.GetRawText(), "\n\t");
+
+	EXPECT_EQ(parser.Next(), Event::StartElement);
+	EXPECT_EQ(parser.GetName(), "Child");
+	EXPECT_EQ(parser.GetDepth(), 2u);
+	ASSERT_EQ(parser.GetAttributes().size(), 2u);
+	EXPECT_EQ(parser.GetAttributes()[0].name, "name");
+	EXPECT_EQ(parser.GetAttributes()[0].rawValue, "first");
+	EXPECT_EQ(parser.GetRawAttribute("value"), "second");
+	EXPECT_EQ(parser.GetRawAttribute("missing"), std::nullopt);
+
+	EXPECT_EQ(parser.Next(), Event::Text);
+	EXPECT_EQ(parser.GetRawText(), "Text");
+	EXPECT_FALSE(parser.IsCData());
+
+	EXPECT_EQ(parser.Next(), Event::EndElement);
+	EXPECT_EQ(parser.GetName(), "Child");
+	EXPECT_EQ(parser.GetDepth(), 1u);
+
+	EXPECT_EQ(parser.Next(), Event::Text);
+
+	// Empty-element tags should result in both a start and end event.
+	EXPECT_EQ(parser.Next(), Event::StartElement);
+	EXPECT_EQ(parser.GetName(), "Empty");
+	EXPECT_EQ(parser.GetDepth(), 2u);
+	EXPECT_EQ(parser.Next(), Event::EndElement);
+	EXPECT_EQ(parser.GetName(), "Empty");
+	EXPECT_EQ(parser.GetDepth(), 1u);
+
+	EXPECT_EQ(parser.Next(), Event::Text);
+	EXPECT_EQ(parser.Next(), Event::EndElement);
+	EXPECT_EQ(parser.GetName(), "Root");
+	EXPECT_EQ(parser.GetDepth(), 0u);
+
+	EXPECT_EQ(parser.Next(), Event::EndDocument);
+	EXPECT_EQ(parser.Next(), Event::EndDocument);
+}
+
+TEST(XmlPullParserTest, SkippedMarkup)
+{
+	XmlPullParser parser("\xEF\xBB\xBF<!DOCTYPE Root [ <!ENTITY test \"a > b\"> ]>"
+						 "<Root><!-- <Child> --><?instruction <Child>?><![CDATA[<Child>]]></Root>");
+
+	EXPECT_EQ(parser.Next(), Event::StartElement);
+	EXPECT_EQ(parser.GetName(), "Root");
+
+	EXPECT_EQ(parser.Next(), Event::Text);
+	EXPECT_EQ(parser.GetRawText(), "<Child>");
+	EXPECT_TRUE(parser.IsCData());
+
+	EXPECT_EQ(parser.Next(), Event::EndElement);
+	EXPECT_EQ(parser.Next(), Event::EndDocument);
+}
+
+TEST(XmlPullParserTest, Decoding)
+{
+	EXPECT_EQ(DecodeXmlText("a &lt;b&gt; &amp; &quot;c&quot; &apos;d&apos;"),
+		L"a <b> & \"c\" 'd'");
+	EXPECT_EQ(DecodeXmlText("&#65;&#x42;&#x43;"), L"ABC");
+
+	// Unrecognized or malformed references are left as-is.
+	EXPECT_EQ(DecodeXmlText("&unknown; &#xZZ; &amp"), L"&unknown; &#xZZ; &amp");
+
+	// Multi-byte UTF-8 sequences.
+	EXPECT_EQ(DecodeXmlText("\xC3\xA9\xE2\x82\xAC"), L"\u00E9\u20AC");
+	EXPECT_EQ(DecodeXmlText("\xF0\x9F\x98\x80"), L"\U0001F600");
+	EXPECT_EQ(DecodeXmlText("&#x1F600;"), L"\U0001F600");
+
+	// Invalid sequences are replaced.
+	EXPECT_EQ(DecodeXmlText("a\xFF" "b"), L"a\uFFFDb");
+	EXPECT_EQ(DecodeXmlText("a\xE2\x82"), L"a\uFFFD\uFFFD");
+	EXPECT_EQ(DecodeXmlText("\xC0\x80"), L"\uFFFD");
+
+	// Line breaks are normalized and, within attribute values, replaced with spaces.
+	EXPECT_EQ(DecodeXmlText("a\r\nb\rc\td"), L"a\nb\nc\td");
+	EXPECT_EQ(DecodeXmlAttributeValue("a\r\nb\tc&#10;d"), L"a b c\nd");
+
+	// References aren't decoded within CDATA sections.
+	EXPECT_EQ(DecodeXmlText("&amp;", true), L"&amp;");
+
+	XmlPullParser parser(R"(<Root value="C:\Folder &amp; &quot;name&quot;" />)");
+	ASSERT_EQ(parser.Next(), Event::StartElement);
+	EXPECT_EQ(parser.GetAttribute("value"), L"C:\\Folder & \"name\"");
+	EXPECT_EQ(parser.GetAttribute("missing"), std::nullopt);
+}
+
+TEST(XmlPullParserTest, ChildElements)
+{
+	XmlPullParser parser(R"(<Root>
+	<Item id="1"><Item id="nested" /></Item>
+	<Other />
+	<Item id="2">Text</Item>
+</Root>)");
+
+	ASSERT_TRUE(parser.NextChildElement(0));
+	EXPECT_EQ(parser.GetName(), "Root");
+
+	// Elements nested within each child should be skipped.
+	ASSERT_TRUE(parser.NextChildElement(1));
+	EXPECT_EQ(parser.GetRawAttribute("id"), "1");
+
+	ASSERT_TRUE(parser.NextChildElement(1));
+	EXPECT_EQ(parser.GetName(), "Other");
+
+	ASSERT_TRUE(parser.NextChildElement(1));
+	EXPECT_EQ(parser.GetRawAttribute("id"), "2");
+
+	EXPECT_FALSE(parser.NextChildElement(1));
+	EXPECT_EQ(parser.GetEvent(), Event::EndElement);
+	EXPECT_EQ(parser.GetDepth(), 0u);
+
+	XmlPullParser findParser(R"(<Root><Other><Item id="nested" /></Other><Item id="1" /></Root>)");
+	ASSERT_TRUE(findParser.NextChildElement(0));
+	ASSERT_TRUE(findParser.FindChildElement(1, "Item"));
+	EXPECT_EQ(findParser.GetRawAttribute("id"), "1");
+	EXPECT_FALSE(findParser.FindChildElement(1, "Item"));
+}
+
+TEST(XmlPullParserTest, ReadElementText)
+{
+	XmlPullParser parser(R"(<Root><First>a &amp; <![CDATA[&amp;]]><Nested>b</Nested></First>)"
+						 R"(<Second /><Third>c</Third></Root>)");
+
+	ASSERT_TRUE(parser.NextChildElement(0));
+
+	ASSERT_TRUE(parser.NextChildElement(1));
+	EXPECT_EQ(parser.ReadElementText(), L"a & &amp;b");
+
+	ASSERT_TRUE(parser.NextChildElement(1));
+	EXPECT_EQ(parser.ReadElementText(), L"");
+
+	ASSERT_TRUE(parser.NextChildElement(1));
+	EXPECT_TRUE(parser.SkipElement());
+
+	EXPECT_FALSE(parser.NextChildElement(1));
+}
+
+TEST(XmlPullParserTest, OpenTopLevelElement)
+{
+	std::string_view data = R"(<Root><Nested><Settings id="nested" /></Nested>)"
+							R"(<Settings id="top" /></Root>)";
+
+	auto parser = XmlPullParser::OpenTopLevelElement(data, "Settings");
+	ASSERT_TRUE(parser);
+	EXPECT_EQ(parser->GetRawAttribute("id"), "top");
+	EXPECT_EQ(parser->GetDepth(), 2u);
+
+	EXPECT_FALSE(XmlPullParser::OpenTopLevelElement(data, "Missing"));
+	EXPECT_FALSE(XmlPullParser::OpenTopLevelElement("", "Settings"));
+}
+
+TEST(XmlPullParserTest, InvalidDocuments)
+{
+	auto expectError = [](std::string_view data)
+	{
+		XmlPullParser parser(data);
+		Event event;
+
+		do
+		{
+			event = parser.Next();
+		} while (event != Event::EndDocument && event != Event::Error);
+
+		EXPECT_EQ(event, Event::Error) << data;
+	};
+
+	expectError("");
+	expectError("   ");
+	expectError("<Root>");
+	expectError("<Root></Other>");
+	expectError("<Root></Root><Second />");
+	expectError("text<Root />");
+	expectError("<Root attribute=value />");
+	expectError("<Root attribute=\"value />");
+	expectError("<Root attribute=\"<\" />");
+	expectError("<Root first=\"1\"second=\"2\" />");
+	expectError("<Root / >");
+	expectError("<Root><!-- comment</Root>");
+	expectError("<Root><![CDATA[text</Root>");
+	expectError("<Root></Root");
+	expectError("<Root><!DOCTYPE Root></Root>");
+
+	// Every truncated version of a valid document should be rejected, without any reads past the
+	// end of the data.
+	std::string data = R"(<?xml version="1.0"?><Root a="1"><Child b='2'>Text</Child>)"
+					   R"(<![CDATA[x]]><!-- c --><Empty/></Root>)";
+
+	for (size_t i = 0; i < data.size(); i++)
+	{
+		expectError(std::string_view(data.data(), i));
+	}
+}
+
+// Parses a configuration file containing a large number of tabs, in the same format as the
+// configuration file.
+TEST(XmlPullParserTest, ManyTabs)
+{
+	const int numTabs = 200;
+
+	std::string data = "<?xml version=\"1.0\"?>\r\n<ExplorerPlusPlus>\r\n\t<Settings>\r\n"
+					   "\t\t<Setting name=\"ShowStatusBar\">yes</Setting>\r\n\t</Settings>\r\n"
+					   "\t<Tabs>\r\n";
+
+	for (int i = 0; i < numTabs; i++)
+	{
+		data += "\t\t<Tab name=\"" + std::to_string(i) + "\" Directory=\"C:\\Folder "
+			+ std::to_string(i) + "\" ShowHidden=\"no\" ViewMode=\"1\">\r\n\t\t\t<Columns>\r\n";
+
+		for (int j = 0; j < 7; j++)
+		{
+			data += "\t\t\t\t<Column name=\"Set" + std::to_string(j)
+				+ "\" Name=\"yes\" Name_Width=\"150\" Type=\"yes\" Type_Width=\"150\" />\r\n";
+		}
+
+		data += "\t\t\t</Columns>\r\n\t\t</Tab>\r\n";
+	}
+
+	data += "\t</Tabs>\r\n</ExplorerPlusPlus>\r\n";
+
+	auto parser = XmlPullParser::OpenTopLevelElement(data, "Tabs");
+	ASSERT_TRUE(parser);
+
+	size_t tabsDepth = parser->GetDepth();
+	int tabIndex = 0;
+
+	while (parser->NextChildElement(tabsDepth))
+	{
+		EXPECT_EQ(parser->GetName(), "Tab");
+		EXPECT_EQ(parser->GetAttribute("Directory"), L"C:\\Folder " + std::to_wstring(tabIndex));
+
+		size_t tabDepth = parser->GetDepth();
+		ASSERT_TRUE(parser->FindChildElement(tabDepth, "Columns"));
+
+		size_t columnsDepth = parser->GetDepth();
+		int numColumnSets = 0;
+
+		while (parser->NextChildElement(columnsDepth))
+		{
+			EXPECT_EQ(parser->GetAttributes().size(), 5u);
+			numColumnSets++;
+		}
+
+		EXPECT_EQ(numColumnSets, 7);
+
+		tabIndex++;
+	}
+
+	EXPECT_EQ(tabIndex, numTabs);
+	EXPECT_EQ(parser->GetEvent(), Event::EndElement);
+}
@@ -4,6 +4,7 @@
 
 #include "pch.h"
 #include "XmlStorageHelper.h"
+#include "../Helper/StringHelper.h"
 #include "../Helper/XMLSettings.h"
 #include <objbase.h>
 
@@ -62,3 +63,16 @@ std::optional<XmlDocumentData> CreateXmlDocument()
 
 	return XmlDocumentData{ std::move(xmlDocument), std::move(root) };
 }
+
+std::string SerializeXmlDocument(IXMLDOMDocument *xmlDocument)
+{
+	wil::unique_bstr xml;
+	HRESULT hr = xmlDocument->get_xml(&xml);
+
+	if (FAILED(hr))
+	{
+		return {};
+	}
+
+	return wstrToUtf8Str(xml.get());
+}
@@ -25,3 +25,6 @@ struct XmlDocumentData
 
 wil::com_ptr_nothrow<IXMLDOMDocument> LoadXmlDocument(const std::wstring &filePath);
 std::optional<XmlDocumentData> CreateXmlDocument();
+
+// Returns the document serialized as UTF-8, in the form that can be read by XmlPullParser.
+std::string SerializeXmlDocument(IXMLDOMDocument *xmlDocument);